@@ -0,0 +1,212 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the testing routine to evaluate the performance of the
+ * SPGMR, SPFGMR, SPBCGS, SPTFQMR, and PCG SUNLINSOL module
+ * implementations. The operator is a symmetric positive definite
+ * band matrix applied with SUNMatMatvec. The number of rows and the
+ * bandwidth are doubled from the minimum to the maximum value. When
+ * the OpenMP NVECTOR is available the number of threads used by the
+ * vector operations is doubled from one to the maximum value.
+ * -----------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+#include <sunlinsol/sunlinsol_pcg.h>
+#include <sunlinsol/sunlinsol_spbcgs.h>
+#include <sunlinsol/sunlinsol_spfgmr.h>
+#include <sunlinsol/sunlinsol_spgmr.h>
+#include <sunlinsol/sunlinsol_sptfqmr.h>
+#include <sunmatrix/sunmatrix_band.h>
+
+#if defined(BENCHMARK_OPENMP)
+#include <nvector/nvector_openmp.h>
+#else
+#include <nvector/nvector_serial.h>
+#endif
+
+#include "test_sunlinsol_performance.h"
+
+#define MAXL 50                 /* max Krylov subspace dimension */
+#define TOL  SUN_RCONST(1.0e-8) /* solve tolerance               */
+
+/* private functions */
+static int ATimes(void* A_data, N_Vector v, N_Vector z);
+static SUNLinearSolver CreateSolver(const char* name, N_Vector x,
+                                    SUNContext ctx);
+
+/* ----------------------------------------------------------------------
+ * Main SUNLinearSolver Testing Routine
+ * --------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  SUNContext ctx = NULL; /* SUNDIALS context  */
+  SUNLinearSolver LS;    /* linear solver     */
+  SUNMatrix A;           /* operator          */
+  N_Vector x, b;         /* test vectors      */
+  const char* solver;    /* solver name       */
+  sunindextype n;        /* matrix rows       */
+  sunindextype nmin;     /* minimum rows      */
+  sunindextype nmax;     /* maximum rows      */
+  sunindextype bw;       /* bandwidth         */
+  sunindextype bwmax;    /* maximum bandwidth */
+  int nthreads;          /* number of threads */
+  int maxthreads;        /* maximum threads   */
+  int ntests;            /* number of tests   */
+  int flag;              /* return flag       */
+
+  /* check inputs */
+  if (argc < 7)
+  {
+    fprintf(stderr, "ERROR: SIX (6) arguments required: ");
+    fprintf(stderr, "<solver (spgmr, spfgmr, spbcgs, sptfqmr, pcg)> "
+                    "<min rows> <max rows> <max bandwidth> <max threads> "
+                    "<number of tests>\n");
+    return (-1);
+  }
+
+  solver = argv[1];
+
+  nmin = (sunindextype)atol(argv[2]);
+  nmax = (sunindextype)atol(argv[3]);
+  if (nmin <= 1 || nmax < nmin)
+  {
+    fprintf(stderr, "ERROR: matrix rows must be greater than one and "
+                    "min <= max\n");
+    return (-1);
+  }
+
+  bwmax = (sunindextype)atol(argv[4]);
+  if (bwmax <= 0)
+  {
+    fprintf(stderr, "ERROR: bandwidth must be a positive integer\n");
+    return (-1);
+  }
+
+  maxthreads = atoi(argv[5]);
+  if (maxthreads <= 0)
+  {
+    fprintf(stderr, "ERROR: number of threads must be a positive integer\n");
+    return (-1);
+  }
+#if !defined(BENCHMARK_OPENMP)
+  if (maxthreads > 1)
+  {
+    fprintf(stderr, "WARNING: the OpenMP NVECTOR is not available, running "
+                    "with one thread\n");
+    maxthreads = 1;
+  }
+#endif
+
+  ntests = atoi(argv[6]);
+  if (ntests <= 0)
+  {
+    fprintf(stderr, "ERROR: number of tests must be a positive integer\n");
+    return (-1);
+  }
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &ctx);
+  if (flag) { return flag; }
+
+  InitializeTimer();
+  PrintCSVHeader();
+
+  for (n = nmin; n <= nmax; n *= 2)
+  {
+    for (bw = 1; bw <= SUNMIN(bwmax, n - 1); bw *= 2)
+    {
+      A = SUNBandMatrix(n, bw, bw, ctx);
+      if (!A)
+      {
+        fprintf(stderr, "ERROR: unable to allocate a band matrix\n");
+        return (-1);
+      }
+      FillBandMatrix(A, 1);
+
+      for (nthreads = 1; nthreads <= maxthreads; nthreads *= 2)
+      {
+#if defined(BENCHMARK_OPENMP)
+        x = N_VNew_OpenMP(n, nthreads, ctx);
+        b = N_VNew_OpenMP(n, nthreads, ctx);
+#else
+        x = N_VNew_Serial(n, ctx);
+        b = N_VNew_Serial(n, ctx);
+#endif
+        if (!x || !b) { return (-1); }
+
+        LS = CreateSolver(solver, x, ctx);
+        if (!LS)
+        {
+          fprintf(stderr, "ERROR: unknown solver %s\n", solver);
+          return (-1);
+        }
+        if (SUNLinSolSetATimes(LS, A, ATimes)) { return (-1); }
+        if (SUNLinSolInitialize(LS)) { return (-1); }
+
+        SetBenchmarkCase(solver, n, bw, 1.0, n * (2 * bw + 1), nthreads);
+        flag = Test_SUNLinSolSetup(LS, NULL, NULL, ntests);
+        if (!flag)
+        {
+          flag = Test_SUNLinSolSolve(LS, NULL, x, b, TOL, ntests);
+        }
+
+        SUNLinSolFree(LS);
+        N_VDestroy(x);
+        N_VDestroy(b);
+      }
+
+      SUNMatDestroy(A);
+    }
+  }
+
+  flag = SUNContext_Free(&ctx);
+
+  return (flag);
+}
+
+/* ----------------------------------------------------------------------
+ * Private functions
+ * --------------------------------------------------------------------*/
+
+/* z = A v */
+static int ATimes(void* A_data, N_Vector v, N_Vector z)
+{
+  return SUNMatMatvec((SUNMatrix)A_data, v, z);
+}
+
+static SUNLinearSolver CreateSolver(const char* name, N_Vector x,
+                                    SUNContext ctx)
+{
+  if (!strcmp(name, "spgmr"))
+  {
+    return SUNLinSol_SPGMR(x, SUN_PREC_NONE, MAXL, ctx);
+  }
+  if (!strcmp(name, "spfgmr"))
+  {
+    return SUNLinSol_SPFGMR(x, SUN_PREC_NONE, MAXL, ctx);
+  }
+  if (!strcmp(name, "spbcgs"))
+  {
+    return SUNLinSol_SPBCGS(x, SUN_PREC_NONE, MAXL, ctx);
+  }
+  if (!strcmp(name, "sptfqmr"))
+  {
+    return SUNLinSol_SPTFQMR(x, SUN_PREC_NONE, MAXL, ctx);
+  }
+  if (!strcmp(name, "pcg"))
+  {
+    return SUNLinSol_PCG(x, SUN_PREC_NONE, MAXL, ctx);
+  }
+  return NULL;
+}
@@ -0,0 +1,156 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the testing routine to evaluate the performance of the
+ * SuperLU_MT SUNLINSOL module implementation with CSC or CSR matrices.
+ * The number of rows is doubled from the minimum to the maximum value
+ * and the density is divided by ten from the maximum value for the
+ * requested number of densities. The number of threads is doubled
+ * from one to the maximum value.
+ * -----------------------------------------------------------------*/
+
+#include <nvector/nvector_serial.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_types.h>
+#include <sunlinsol/sunlinsol_superlumt.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+
+#include "test_sunlinsol_performance.h"
+
+/* ----------------------------------------------------------------------
+ * Main SUNLinearSolver Testing Routine
+ * --------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  SUNContext ctx = NULL; /* SUNDIALS context        */
+  SUNLinearSolver LS;    /* linear solver           */
+  SUNMatrix A, A0;       /* test matrices           */
+  N_Vector x, b;         /* test vectors            */
+  sunindextype n;        /* matrix rows             */
+  sunindextype nmin;     /* minimum rows            */
+  sunindextype nmax;     /* maximum rows            */
+  int sparsetype;        /* CSC_MAT or CSR_MAT      */
+  double density;        /* matrix density          */
+  double dmax;           /* maximum density         */
+  int ndensities;        /* number of densities     */
+  int nthreads;          /* number of threads       */
+  int maxthreads;        /* maximum threads         */
+  int ntests;            /* number of tests         */
+  int k;                 /* density index           */
+  int flag;              /* return flag             */
+
+  /* check inputs */
+  if (argc < 8)
+  {
+    fprintf(stderr, "ERROR: SEVEN (7) arguments required: ");
+    fprintf(stderr, "<matrix type (0 = CSC, 1 = CSR)> <min rows> <max rows> "
+                    "<max density> <number of densities> "
+                    "<max threads> <number of tests>\n");
+    return (-1);
+  }
+
+  sparsetype = atoi(argv[1]);
+  if (sparsetype != CSC_MAT && sparsetype != CSR_MAT)
+  {
+    fprintf(stderr, "ERROR: matrix type must be 0 (CSC) or 1 (CSR)\n");
+    return (-1);
+  }
+
+  nmin = (sunindextype)atol(argv[2]);
+  nmax = (sunindextype)atol(argv[3]);
+  if (nmin <= 0 || nmax < nmin)
+  {
+    fprintf(stderr, "ERROR: matrix rows must be positive and min <= max\n");
+    return (-1);
+  }
+
+  dmax = atof(argv[4]);
+  if (dmax <= 0.0 || dmax > 1.0)
+  {
+    fprintf(stderr, "ERROR: density must be in (0, 1]\n");
+    return (-1);
+  }
+
+  ndensities = atoi(argv[5]);
+  if (ndensities <= 0)
+  {
+    fprintf(stderr, "ERROR: number of densities must be a positive integer\n");
+    return (-1);
+  }
+
+  maxthreads = atoi(argv[6]);
+  if (maxthreads <= 0)
+  {
+    fprintf(stderr, "ERROR: number of threads must be a positive integer\n");
+    return (-1);
+  }
+
+  ntests = atoi(argv[7]);
+  if (ntests <= 0)
+  {
+    fprintf(stderr, "ERROR: number of tests must be a positive integer\n");
+    return (-1);
+  }
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &ctx);
+  if (flag) { return flag; }
+
+  InitializeTimer();
+  PrintCSVHeader();
+
+  for (n = nmin; n <= nmax; n *= 2)
+  {
+    x = N_VNew_Serial(n, ctx);
+    b = N_VNew_Serial(n, ctx);
+    if (!x || !b) { return (-1); }
+
+    density = dmax;
+    for (k = 0; k < ndensities; k++, density /= 10.0)
+    {
+      A0 = CreateSparseMatrix(n, density, sparsetype, 1, ctx);
+      if (!A0)
+      {
+        fprintf(stderr, "ERROR: unable to allocate a sparse matrix\n");
+        return (-1);
+      }
+
+      A = SUNMatClone(A0);
+      if (!A) { return (-1); }
+      SUNMatCopy(A0, A);
+
+      for (nthreads = 1; nthreads <= maxthreads; nthreads *= 2)
+      {
+        LS = SUNLinSol_SuperLUMT(x, A, nthreads, ctx);
+        if (!LS) { return (-1); }
+        if (SUNLinSolInitialize(LS)) { return (-1); }
+
+        SetBenchmarkCase((sparsetype == CSC_MAT) ? "superlumt_csc"
+                                                 : "superlumt_csr",
+                         n, 0, density, SUNSparseMatrix_NNZ(A0), nthreads);
+        flag = Test_SUNLinSolSetup(LS, A, A0, ntests);
+        if (!flag) { flag = Test_SUNLinSolSolve(LS, A, x, b, ZERO, ntests); }
+
+        SUNLinSolFree(LS);
+      }
+
+      SUNMatDestroy(A);
+      SUNMatDestroy(A0);
+    }
+
+    N_VDestroy(x);
+    N_VDestroy(b);
+  }
+
+  flag = SUNContext_Free(&ctx);
+
+  return (flag);
+}
@@ -0,0 +1,103 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * These test functions are designed to evaluate the performance of
+ * a SUNLinearSolver module implementation. Each test prints one row
+ * of comma-separated values with the benchmark parameters and timing
+ * statistics to stdout.
+ * -----------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_types.h>
+
+#include "test_sunlinsol_performance.h"
+
+/* -----------------------------------------------------------------------------
+ * SUNLinSolSetup Tests
+ * ---------------------------------------------------------------------------*/
+int Test_SUNLinSolSetup(SUNLinearSolver S, SUNMatrix A, SUNMatrix A0,
+                        int ntests)
+{
+  double start_time, stop_time;
+  double* times;
+  int i, nruns, flag;
+
+  nruns = ntests + GetNumWarmups();
+  times = (double*)malloc(nruns * sizeof(double));
+  if (!times) { return 1; }
+
+  for (i = 0; i < nruns; i++)
+  {
+    /* direct solvers factor A in place */
+    if (A) { SUNMatCopy(A0, A); }
+
+    start_time = GetTime();
+    flag       = SUNLinSolSetup(S, A);
+    stop_time  = GetTime();
+
+    if (flag)
+    {
+      fprintf(stderr, "ERROR: SUNLinSolSetup returned %d\n", flag);
+      free(times);
+      return 1;
+    }
+
+    times[i] = stop_time - start_time;
+  }
+
+  PrintCSVRow("SUNLinSolSetup", times, ntests);
+
+  free(times);
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * SUNLinSolSolve Tests
+ * ---------------------------------------------------------------------------*/
+int Test_SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x,
+                        N_Vector b, sunrealtype tol, int ntests)
+{
+  double start_time, stop_time;
+  double* times;
+  int i, nruns, flag;
+
+  nruns = ntests + GetNumWarmups();
+  times = (double*)malloc(nruns * sizeof(double));
+  if (!times) { return 1; }
+
+  FillVector(b, 3);
+
+  for (i = 0; i < nruns; i++)
+  {
+    N_VConst(ZERO, x);
+
+    start_time = GetTime();
+    flag       = SUNLinSolSolve(S, A, x, b, tol);
+    stop_time  = GetTime();
+
+    /* recoverable failures, e.g., not reaching the tolerance, still give a
+       meaningful time */
+    if (flag < 0)
+    {
+      fprintf(stderr, "ERROR: SUNLinSolSolve returned %d\n", flag);
+      free(times);
+      return 1;
+    }
+
+    times[i] = stop_time - start_time;
+  }
+
+  PrintCSVRow("SUNLinSolSolve", times, ntests);
+
+  free(times);
+  return 0;
+}
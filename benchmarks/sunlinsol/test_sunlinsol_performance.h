@@ -0,0 +1,36 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the header file contains the prototypes for functions to
+ * evaluate the performance of a SUNLINSOL module implementation.
+ * -----------------------------------------------------------------*/
+
+#include <sundials/sundials_linearsolver.h>
+
+#include "test_sunmatrix_performance.h"
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* Time SUNLinSolSetup, A is restored from A0 before every run when the
+   solver is matrix-based */
+int Test_SUNLinSolSetup(SUNLinearSolver S, SUNMatrix A, SUNMatrix A0,
+                        int ntests);
+
+/* Time SUNLinSolSolve with a zero initial guess, SUNLinSolSetup must have
+   been called */
+int Test_SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x,
+                        N_Vector b, sunrealtype tol, int ntests);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the testing routine to evaluate the performance of the
+ * dense SUNMATRIX module implementation. The number of rows is
+ * doubled from the minimum to the maximum value.
+ * -----------------------------------------------------------------*/
+
+#include <nvector/nvector_serial.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_types.h>
+#include <sunmatrix/sunmatrix_dense.h>
+
+#include "test_sunmatrix_performance.h"
+
+/* ----------------------------------------------------------------------
+ * Main SUNMatrix Testing Routine
+ * --------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  SUNContext ctx = NULL; /* SUNDIALS context */
+  SUNMatrix A, B;        /* test matrices    */
+  N_Vector x, y;         /* test vectors     */
+  sunindextype n;        /* matrix rows      */
+  sunindextype nmin;     /* minimum rows     */
+  sunindextype nmax;     /* maximum rows     */
+  int ntests;            /* number of tests  */
+  int flag;              /* return flag      */
+
+  /* check inputs */
+  if (argc < 4)
+  {
+    fprintf(stderr, "ERROR: THREE (3) arguments required: ");
+    fprintf(stderr, "<min rows> <max rows> <number of tests>\n");
+    return (-1);
+  }
+
+  nmin = (sunindextype)atol(argv[1]);
+  nmax = (sunindextype)atol(argv[2]);
+  if (nmin <= 0 || nmax < nmin)
+  {
+    fprintf(stderr, "ERROR: matrix rows must be positive and min <= max\n");
+    return (-1);
+  }
+
+  ntests = atoi(argv[3]);
+  if (ntests <= 0)
+  {
+    fprintf(stderr, "ERROR: number of tests must be a positive integer\n");
+    return (-1);
+  }
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &ctx);
+  if (flag) { return flag; }
+
+  InitializeTimer();
+  PrintCSVHeader();
+
+  for (n = nmin; n <= nmax; n *= 2)
+  {
+    A = SUNDenseMatrix(n, n, ctx);
+    B = SUNDenseMatrix(n, n, ctx);
+    x = N_VNew_Serial(n, ctx);
+    y = N_VNew_Serial(n, ctx);
+    if (!A || !B || !x || !y)
+    {
+      fprintf(stderr, "ERROR: unable to allocate a %ld x %ld matrix\n",
+              (long int)n, (long int)n);
+      return (-1);
+    }
+
+    FillDenseMatrix(A, 1);
+    FillDenseMatrix(B, 2);
+
+    SetBenchmarkCase("dense", n, n, 1.0, n * n, 1);
+    flag = Test_SUNMatMatvec(A, x, y, ntests);
+    flag = Test_SUNMatScaleAddI(A, ntests);
+    flag = Test_SUNMatScaleAdd(A, B, ntests);
+
+    SUNMatDestroy(A);
+    SUNMatDestroy(B);
+    N_VDestroy(x);
+    N_VDestroy(y);
+  }
+
+  flag = SUNContext_Free(&ctx);
+
+  return (flag);
+}
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+# -----------------------------------------------------------------------------
+# SUNDIALS Copyright Start
+# Copyright (c) 2002-2024, Lawrence Livermore National Security
+# and Southern Methodist University.
+# All rights reserved.
+#
+# See the top-level LICENSE and NOTICE files for details.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+# SUNDIALS Copyright End
+# -----------------------------------------------------------------------------
+# This script plots the CSV output from the sunmatrix_*_benchmark and
+# sunlinsol_*_benchmark programs. Each file starts with the header
+#
+#   operation,implementation,rows,bandwidth,density,nnz,threads,avg,sdev,min,max
+#
+# and every row holds the timing statistics for one operation and one set of
+# parameters. One plot of time vs number of rows is made for the requested
+# operation with a line for every implementation, bandwidth, density, and
+# thread count found in the files. With --speedup the time with one thread is
+# divided by the time with more threads instead.
+# -----------------------------------------------------------------------------
+
+
+def main():
+
+    import argparse
+    import csv
+    import os, sys
+
+    import numpy as np
+    import scipy.stats as st
+
+    import matplotlib.pyplot as plt
+
+    parser = argparse.ArgumentParser(
+        description="Plot data from SUNMatrix and SUNLinearSolver performance tests"
+    )
+
+    parser.add_argument(
+        "op", type=str, help="Which operation to plot e.g., SUNMatMatvec"
+    )
+
+    parser.add_argument("files", type=str, nargs="+", help="CSV output files")
+
+    parser.add_argument(
+        "--speedup",
+        dest="speedup",
+        action="store_true",
+        help="Plot the speedup relative to one thread",
+    )
+
+    parser.add_argument(
+        "--ntests",
+        dest="ntests",
+        type=int,
+        default=0,
+        help="Number of tests used to plot 99 percent confidence intervals",
+    )
+
+    parser.add_argument(
+        "--loglog",
+        dest="loglog",
+        action="store_true",
+        help="Generate loglog plots",
+    )
+
+    parser.add_argument(
+        "--show",
+        dest="show",
+        action="store_true",
+        help="Display plots rather than saving to file",
+    )
+
+    parser.add_argument(
+        "--debug", dest="debug", action="store_true", help="Turn on debugging output"
+    )
+
+    # parse command line args
+    args = parser.parse_args()
+
+    if args.debug:
+        print(args)
+
+    # read the rows for the requested operation, the key identifies a line in
+    # the plot and maps to a dictionary of rows -> (avg, sdev)
+    data = {}
+    for fname in args.files:
+        if not os.path.isfile(fname):
+            print("ERROR:", fname, "does not exist")
+            sys.exit()
+        with open(fname, newline="") as fin:
+            for row in csv.DictReader(fin):
+                if row["operation"] != args.op:
+                    continue
+                key = (
+                    row["implementation"],
+                    int(row["bandwidth"]),
+                    float(row["density"]),
+                    int(row["threads"]),
+                )
+                data.setdefault(key, {})[int(row["rows"])] = (
+                    float(row["avg"]),
+                    float(row["sdev"]),
+                )
+
+    if not data:
+        print("ERROR: no data found for", args.op)
+        sys.exit()
+
+    if args.debug:
+        print(data)
+
+    # critical value for 99% confidence interval
+    cv = 0.0
+    if args.ntests > 1:
+        if args.ntests < 30:
+            # student's t distribution
+            cv = st.t.interval(0.99, args.ntests - 1)[1]
+        else:
+            # normal distribution
+            cv = st.norm.ppf(0.995)
+
+    fig, ax = plt.subplots()
+
+    for key in sorted(data):
+        impl, bw, density, threads = key
+        rows = np.array(sorted(data[key]))
+        avg = np.array([data[key][n][0] for n in rows])
+        sdev = np.array([data[key][n][1] for n in rows])
+
+        if args.speedup:
+            base = data.get((impl, bw, density, 1))
+            if threads == 1 or base is None:
+                continue
+            keep = [i for i, n in enumerate(rows) if n in base]
+            rows = rows[keep]
+            avg = np.array([base[n][0] for n in rows]) / avg[keep]
+            sdev = np.zeros(len(rows))
+
+        label = impl
+        if bw > 0:
+            label += " bw=" + str(bw)
+        if density < 1.0:
+            label += " density=" + str(density)
+        label += " threads=" + str(threads)
+
+        cdev = cv * sdev / np.sqrt(max(args.ntests, 1))
+        if args.loglog:
+            ax.loglog(rows, avg, "-o", label=label)
+        else:
+            ax.plot(rows, avg, "-o", label=label)
+        if cv > 0.0:
+            ax.fill_between(rows, avg - cdev, avg + cdev, alpha=0.2)
+
+    ax.legend(loc="best", fontsize="small")
+    ax.set_title(args.op)
+    ax.set_xlabel("rows")
+    if args.speedup:
+        ax.set_ylabel("speedup")
+    else:
+        ax.set_ylabel("time (s)")
+
+    if args.show:
+        plt.show()
+    else:
+        fname = args.op
+        if args.speedup:
+            fname += "-speedup"
+        if args.loglog:
+            fname += "-loglog"
+        plt.savefig(fname + ".pdf")
+    plt.close()
+
+
+# ===============================================================================
+
+if __name__ == "__main__":
+    main()
+
+# EOF
@@ -0,0 +1,134 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the testing routine to evaluate the performance of the
+ * sparse SUNMATRIX module implementation in CSC or CSR format. The
+ * number of rows is doubled from the minimum to the maximum value
+ * and the density is divided by ten from the maximum value for the
+ * requested number of densities.
+ * -----------------------------------------------------------------*/
+
+#include <nvector/nvector_serial.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_types.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+
+#include "test_sunmatrix_performance.h"
+
+/* ----------------------------------------------------------------------
+ * Main SUNMatrix Testing Routine
+ * --------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+  SUNContext ctx = NULL; /* SUNDIALS context        */
+  SUNMatrix A, B;        /* test matrices           */
+  N_Vector x, y;         /* test vectors            */
+  sunindextype n;        /* matrix rows             */
+  sunindextype nmin;     /* minimum rows            */
+  sunindextype nmax;     /* maximum rows            */
+  int sparsetype;        /* CSC_MAT or CSR_MAT      */
+  double density;        /* matrix density          */
+  double dmax;           /* maximum density         */
+  int ndensities;        /* number of densities     */
+  int ntests;            /* number of tests         */
+  int k;                 /* density index           */
+  int flag;              /* return flag             */
+
+  /* check inputs */
+  if (argc < 7)
+  {
+    fprintf(stderr, "ERROR: SIX (6) arguments required: ");
+    fprintf(stderr, "<matrix type (0 = CSC, 1 = CSR)> <min rows> <max rows> "
+                    "<max density> <number of densities> "
+                    "<number of tests>\n");
+    return (-1);
+  }
+
+  sparsetype = atoi(argv[1]);
+  if (sparsetype != CSC_MAT && sparsetype != CSR_MAT)
+  {
+    fprintf(stderr, "ERROR: matrix type must be 0 (CSC) or 1 (CSR)\n");
+    return (-1);
+  }
+
+  nmin = (sunindextype)atol(argv[2]);
+  nmax = (sunindextype)atol(argv[3]);
+  if (nmin <= 0 || nmax < nmin)
+  {
+    fprintf(stderr, "ERROR: matrix rows must be positive and min <= max\n");
+    return (-1);
+  }
+
+  dmax = atof(argv[4]);
+  if (dmax <= 0.0 || dmax > 1.0)
+  {
+    fprintf(stderr, "ERROR: density must be in (0, 1]\n");
+    return (-1);
+  }
+
+  ndensities = atoi(argv[5]);
+  if (ndensities <= 0)
+  {
+    fprintf(stderr, "ERROR: number of densities must be a positive integer\n");
+    return (-1);
+  }
+
+  ntests = atoi(argv[6]);
+  if (ntests <= 0)
+  {
+    fprintf(stderr, "ERROR: number of tests must be a positive integer\n");
+    return (-1);
+  }
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &ctx);
+  if (flag) { return flag; }
+
+  InitializeTimer();
+  PrintCSVHeader();
+
+  for (n = nmin; n <= nmax; n *= 2)
+  {
+    x = N_VNew_Serial(n, ctx);
+    y = N_VNew_Serial(n, ctx);
+    if (!x || !y) { return (-1); }
+
+    density = dmax;
+    for (k = 0; k < ndensities; k++, density /= 10.0)
+    {
+      /* A and B have different sparsity patterns so SUNMatScaleAdd has to
+         merge them */
+      A = CreateSparseMatrix(n, density, sparsetype, 1, ctx);
+      B = CreateSparseMatrix(n, density / 2.0, sparsetype, 2, ctx);
+      if (!A || !B)
+      {
+        fprintf(stderr, "ERROR: unable to allocate a sparse matrix\n");
+        return (-1);
+      }
+
+      SetBenchmarkCase((sparsetype == CSC_MAT) ? "csc" : "csr", n, 0, density,
+                       SUNSparseMatrix_NNZ(A), 1);
+      flag = Test_SUNMatMatvec(A, x, y, ntests);
+      flag = Test_SUNMatScaleAddI(A, ntests);
+      flag = Test_SUNMatScaleAdd(A, B, ntests);
+
+      SUNMatDestroy(A);
+      SUNMatDestroy(B);
+    }
+
+    N_VDestroy(x);
+    N_VDestroy(y);
+  }
+
+  flag = SUNContext_Free(&ctx);
+
+  return (flag);
+}
@@ -0,0 +1,375 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * These test functions are designed to evaluate the performance of
+ * a SUNMatrix module implementation. Each test prints one row of
+ * comma-separated values with the benchmark parameters and timing
+ * statistics to stdout.
+ * -----------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+#include <time.h>
+
+#include "test_sunmatrix_performance.h"
+
+/* private functions */
+static sunrealtype hash_value(sunindextype i, sunindextype j, int seed);
+static void time_stats(double* times, int num_warmups, int ntests,
+                       double* avg, double* sdev, double* min, double* max);
+
+static int nwarmups = 1; /* number of extra tests to perform and ignore */
+
+/* parameters of the current benchmark case */
+static const char* case_impl       = "";
+static sunindextype case_rows      = 0;
+static sunindextype case_bandwidth = 0;
+static double case_density         = 0.0;
+static sunindextype case_nnz       = 0;
+static int case_nthreads           = 1;
+
+#if defined(SUNDIALS_HAVE_POSIX_TIMERS)
+static time_t base_time_tv_sec = 0; /* Base time; makes time values returned
+                                       by GetTime easier to read when
+                                       printed since they will be zero
+                                       based. */
+#endif
+
+/* -----------------------------------------------------------------------------
+ * SUNMatMatvec Tests
+ * ---------------------------------------------------------------------------*/
+int Test_SUNMatMatvec(SUNMatrix A, N_Vector x, N_Vector y, int ntests)
+{
+  double start_time, stop_time;
+  double* times;
+  int i;
+
+  times = (double*)malloc((ntests + nwarmups) * sizeof(double));
+  if (!times) { return 1; }
+
+  FillVector(x, 1);
+
+  for (i = 0; i < ntests + nwarmups; i++)
+  {
+    start_time = GetTime();
+    SUNMatMatvec(A, x, y);
+    stop_time = GetTime();
+
+    times[i] = stop_time - start_time;
+  }
+
+  PrintCSVRow("SUNMatMatvec", times, ntests);
+
+  free(times);
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * SUNMatScaleAddI Tests
+ * ---------------------------------------------------------------------------*/
+int Test_SUNMatScaleAddI(SUNMatrix A, int ntests)
+{
+  double start_time, stop_time;
+  double* times;
+  int i;
+  SUNMatrix A0;
+
+  times = (double*)malloc((ntests + nwarmups) * sizeof(double));
+  if (!times) { return 1; }
+
+  /* keep a copy of A to restore it before every run */
+  A0 = SUNMatClone(A);
+  SUNMatCopy(A, A0);
+
+  for (i = 0; i < ntests + nwarmups; i++)
+  {
+    SUNMatCopy(A0, A);
+
+    start_time = GetTime();
+    SUNMatScaleAddI(TWO, A);
+    stop_time = GetTime();
+
+    times[i] = stop_time - start_time;
+  }
+
+  PrintCSVRow("SUNMatScaleAddI", times, ntests);
+
+  SUNMatCopy(A0, A);
+  SUNMatDestroy(A0);
+  free(times);
+  return 0;
+}
+
+/* -----------------------------------------------------------------------------
+ * SUNMatScaleAdd Tests
+ * ---------------------------------------------------------------------------*/
+int Test_SUNMatScaleAdd(SUNMatrix A, SUNMatrix B, int ntests)
+{
+  double start_time, stop_time;
+  double* times;
+  int i;
+  SUNMatrix A0;
+
+  times = (double*)malloc((ntests + nwarmups) * sizeof(double));
+  if (!times) { return 1; }
+
+  /* keep a copy of A to restore it before every run */
+  A0 = SUNMatClone(A);
+  SUNMatCopy(A, A0);
+
+  for (i = 0; i < ntests + nwarmups; i++)
+  {
+    SUNMatCopy(A0, A);
+
+    start_time = GetTime();
+    SUNMatScaleAdd(TWO, A, B);
+    stop_time = GetTime();
+
+    times[i] = stop_time - start_time;
+  }
+
+  PrintCSVRow("SUNMatScaleAdd", times, ntests);
+
+  SUNMatCopy(A0, A);
+  SUNMatDestroy(A0);
+  free(times);
+  return 0;
+}
+
+/* ======================================================================
+ * Exported utility functions
+ * ====================================================================*/
+
+/* ----------------------------------------------------------------------
+ * Benchmark parameters and CSV output
+ * --------------------------------------------------------------------*/
+void SetBenchmarkCase(const char* impl, sunindextype rows,
+                      sunindextype bandwidth, double density,
+                      sunindextype nnz, int nthreads)
+{
+  case_impl      = impl;
+  case_rows      = rows;
+  case_bandwidth = bandwidth;
+  case_density   = density;
+  case_nnz       = nnz;
+  case_nthreads  = nthreads;
+}
+
+void PrintCSVHeader(void)
+{
+  printf("operation,implementation,rows,bandwidth,density,nnz,threads,"
+         "avg,sdev,min,max\n");
+}
+
+void PrintCSVRow(const char* op, double* times, int ntests)
+{
+  double avg, sdev, min, max;
+
+  time_stats(times, nwarmups, ntests, &avg, &sdev, &min, &max);
+
+  printf("%s,%s,%ld,%ld,%g,%ld,%d,%.15e,%.15e,%.15e,%.15e\n", op, case_impl,
+         (long int)case_rows, (long int)case_bandwidth, case_density,
+         (long int)case_nnz, case_nthreads, avg, sdev, min, max);
+  fflush(stdout);
+}
+
+void SetNumWarmups(int num_warmups) { nwarmups = num_warmups; }
+
+int GetNumWarmups(void) { return nwarmups; }
+
+/* ----------------------------------------------------------------------
+ * Timer
+ * --------------------------------------------------------------------*/
+void InitializeTimer(void)
+{
+#if defined(SUNDIALS_HAVE_POSIX_TIMERS)
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  base_time_tv_sec = spec.tv_sec;
+#else
+  fprintf(stderr, "WARNING: POSIX timers are not available, all times will "
+                  "be zero\n");
+#endif
+}
+
+double GetTime(void)
+{
+  double time;
+#if defined(SUNDIALS_HAVE_POSIX_TIMERS)
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  time = (double)(spec.tv_sec - base_time_tv_sec) +
+         ((double)(spec.tv_nsec) / 1E9);
+#else
+  time = 0;
+#endif
+  return time;
+}
+
+/* ----------------------------------------------------------------------
+ * Matrix and vector data
+ * --------------------------------------------------------------------*/
+void FillDenseMatrix(SUNMatrix A, int seed)
+{
+  sunindextype i, j;
+  sunindextype M = SUNDenseMatrix_Rows(A);
+  sunindextype N = SUNDenseMatrix_Columns(A);
+
+  for (j = 0; j < N; j++)
+  {
+    sunrealtype* col = SUNDenseMatrix_Column(A, j);
+    for (i = 0; i < M; i++)
+    {
+      col[i] = (i == j) ? (sunrealtype)N : -hash_value(i, j, seed);
+    }
+  }
+}
+
+void FillBandMatrix(SUNMatrix A, int seed)
+{
+  sunindextype i, j;
+  sunindextype N  = SUNBandMatrix_Columns(A);
+  sunindextype mu = SUNBandMatrix_UpperBandwidth(A);
+  sunindextype ml = SUNBandMatrix_LowerBandwidth(A);
+
+  SUNMatZero(A);
+
+  for (j = 0; j < N; j++)
+  {
+    sunrealtype* col = SUNBandMatrix_Column(A, j);
+    for (i = SUNMAX(0, j - mu); i <= SUNMIN(N - 1, j + ml); i++)
+    {
+      /* the value only depends on the unordered pair (i,j) */
+      SM_COLUMN_ELEMENT_B(col, i, j) =
+        (i == j) ? (sunrealtype)(mu + ml + 1)
+                 : -hash_value(SUNMIN(i, j), SUNMAX(i, j), seed);
+    }
+  }
+}
+
+SUNMatrix CreateSparseMatrix(sunindextype n, double density, int sparsetype,
+                             int seed, SUNContext sunctx)
+{
+  sunindextype i, k, m, stride, nper;
+  sunindextype *ptrs, *idx;
+  sunrealtype* data;
+  SUNMatrix A;
+
+  /* entries per row (CSR) or column (CSC) */
+  nper = (sunindextype)(density * (double)n);
+  nper = SUNMAX(1, SUNMIN(n, nper));
+
+  A = SUNSparseMatrix(n, n, n * nper, sparsetype, sunctx);
+  if (!A) { return NULL; }
+
+  ptrs = SUNSparseMatrix_IndexPointers(A);
+  idx  = SUNSparseMatrix_IndexValues(A);
+  data = SUNSparseMatrix_Data(A);
+
+  /* entries are spread evenly starting from the diagonal */
+  stride = n / nper;
+
+  for (i = 0; i < n; i++)
+  {
+    sunindextype* iidx  = idx + i * nper;
+    sunrealtype* idata  = data + i * nper;
+    ptrs[i]             = i * nper;
+
+    for (m = 0; m < nper; m++)
+    {
+      sunindextype col = (i + m * stride) % n;
+      sunrealtype val  = (m == 0) ? (sunrealtype)nper
+                                  : -hash_value(i, col, seed) / (sunrealtype)n;
+
+      /* insertion sort by index */
+      for (k = m; k > 0 && iidx[k - 1] > col; k--)
+      {
+        iidx[k]  = iidx[k - 1];
+        idata[k] = idata[k - 1];
+      }
+      iidx[k]  = col;
+      idata[k] = val;
+    }
+  }
+  ptrs[n] = n * nper;
+
+  return A;
+}
+
+void FillVector(N_Vector x, int seed)
+{
+  sunindextype i;
+  sunindextype n  = N_VGetLength(x);
+  sunrealtype* xd = N_VGetArrayPointer(x);
+
+  for (i = 0; i < n; i++)
+  {
+    xd[i] = TWO * hash_value(i, 0, seed) - ONE;
+  }
+}
+
+/* ======================================================================
+ * Private functions
+ * ====================================================================*/
+
+/* ----------------------------------------------------------------------
+ * Reproducible value in (0,1) for the entry (i,j)
+ * --------------------------------------------------------------------*/
+static sunrealtype hash_value(sunindextype i, sunindextype j, int seed)
+{
+  unsigned long h;
+
+  h = (unsigned long)i * 73856093UL ^ (unsigned long)j * 19349663UL ^
+      (unsigned long)seed * 83492791UL;
+  h = (1103515245UL * h + 12345UL) & 0x7fffffffUL;
+
+  return ((sunrealtype)(h % 100000UL) + ONE) / SUN_RCONST(100001.0);
+}
+
+/* ----------------------------------------------------------------------
+ * compute average, standard deviation, max, and min
+ * --------------------------------------------------------------------*/
+static void time_stats(double* times, int num_warmups, int ntests,
+                       double* avg, double* sdev, double* min, double* max)
+{
+  int i, ntotal;
+
+  /* total number of times collected */
+  ntotal = num_warmups + ntests;
+
+  /* compute timing stats */
+  *avg = 0.0;
+  *min = times[num_warmups];
+  *max = times[num_warmups];
+
+  for (i = num_warmups; i < ntotal; i++)
+  {
+    *avg += times[i];
+    if (times[i] < *min) { *min = times[i]; }
+    if (times[i] > *max) { *max = times[i]; }
+  }
+  *avg /= ntests;
+
+  *sdev = 0.0;
+  if (ntests > 1)
+  {
+    for (i = num_warmups; i < ntotal; i++)
+    {
+      *sdev += (times[i] - *avg) * (times[i] - *avg);
+    }
+    *sdev = sqrt(*sdev / (ntests - 1));
+  }
+}
@@ -0,0 +1,73 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the header file contains the prototypes for functions to
+ * evaluate the performance of a SUNMATRIX module implementation and
+ * the utilities shared with the SUNLINSOL benchmarks.
+ * -----------------------------------------------------------------*/
+
+#include <math.h>
+#include <sundials/sundials_matrix.h>
+#include <sundials/sundials_nvector.h>
+
+/* define constants */
+#define NEG_ONE SUN_RCONST(-1.0)
+#define ZERO    SUN_RCONST(0.0)
+#define ONE     SUN_RCONST(1.0)
+#define TWO     SUN_RCONST(2.0)
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* Set the parameters reported with every CSV row */
+void SetBenchmarkCase(const char* impl, sunindextype rows,
+                      sunindextype bandwidth, double density,
+                      sunindextype nnz, int nthreads);
+
+/* Print the CSV header, must be called once before any test */
+void PrintCSVHeader(void);
+
+/* Compute timing statistics ignoring the warmup runs and print a CSV row */
+void PrintCSVRow(const char* op, double* times, int ntests);
+
+/* Set the number of warmup runs (1 by default) */
+void SetNumWarmups(int num_warmups);
+int GetNumWarmups(void);
+
+/* Start the timer, must be called once before any test */
+void InitializeTimer(void);
+
+/* Current wall clock time in seconds */
+double GetTime(void);
+
+/* Fill matrices with reproducible diagonally dominant values, band matrices
+   with equal upper and lower bandwidths are symmetric positive definite */
+void FillDenseMatrix(SUNMatrix A, int seed);
+void FillBandMatrix(SUNMatrix A, int seed);
+
+/* Create an n x n sparse matrix of type CSC_MAT or CSR_MAT with about
+   density * n entries per row or column including the diagonal */
+SUNMatrix CreateSparseMatrix(sunindextype n, double density, int sparsetype,
+                             int seed, SUNContext sunctx);
+
+/* Fill a vector with random values between -1 and 1 */
+void FillVector(N_Vector x, int seed);
+
+/* SUNMatrix operation tests, ntests timed runs are performed after the
+   warmup runs */
+int Test_SUNMatMatvec(SUNMatrix A, N_Vector x, N_Vector y, int ntests);
+int Test_SUNMatScaleAddI(SUNMatrix A, int ntests);
+int Test_SUNMatScaleAdd(SUNMatrix A, SUNMatrix B, int ntests);
+
+#ifdef __cplusplus
+}
+#endif
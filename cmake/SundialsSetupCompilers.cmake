@@ -291,6 +291,24 @@ if(SUNDIALS_POSIX_TIMERS AND POSIX_TIMERS_NEED_POSIX_C_SOURCE)
       "${CMAKE_C_FLAGS} -D_POSIX_C_SOURCE=${SUNDIALS_POSIX_C_SOURCE}")
 endif()
 
+# ---------------------------------------------------------------
+# Check for mmap (used for file backed buffers e.g., SUNStepTrace)
+# ---------------------------------------------------------------
+check_c_source_compiles(
+  "
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+  int main(void) {
+    int fd = open(\"f\", O_RDWR | O_CREAT, 0644);
+    void* p = mmap(0, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void) ftruncate(fd, 64);
+    (void) msync(p, 64, MS_SYNC);
+    return munmap(p, 64) + close(fd);
+  }
+"
+  SUNDIALS_HAVE_MMAP)
+
 # ---------------------------------------------------------------
 # Check for deprecated attribute with message
 # ---------------------------------------------------------------
@@ -39,3 +39,65 @@ macro(sundials_add_nvector_benchmark NAME)
           DESTINATION "${BENCHMARKS_INSTALL_PATH}/${arg_INSTALL_SUBDIR}")
 
 endmacro(sundials_add_nvector_benchmark)
+
+macro(sundials_add_sunmatrix_benchmark NAME)
+
+  set(options)
+  set(singleValueArgs)
+  set(multiValueArgs SOURCES SUNDIALS_TARGETS LINK_LIBRARIES INSTALL_SUBDIR)
+
+  cmake_parse_arguments(arg "${options}" "${singleValueArgs}"
+                        "${multiValueArgs}" ${ARGN})
+
+  set(BENCHMARKS_DIR ${PROJECT_SOURCE_DIR}/benchmarks)
+
+  add_executable(
+    ${NAME} ${BENCHMARKS_DIR}/sunmatrix/test_sunmatrix_performance.c
+            ${arg_SOURCES})
+
+  set_target_properties(${NAME} PROPERTIES FOLDER "Benchmarks")
+
+  target_include_directories(${NAME} PRIVATE ${BENCHMARKS_DIR}/sunmatrix)
+
+  target_link_libraries(
+    ${NAME} PRIVATE sundials_sunmatrixdense sundials_sunmatrixband
+                    sundials_sunmatrixsparse ${arg_SUNDIALS_TARGETS}
+                    ${arg_LINK_LIBRARIES} -lm)
+
+  install(TARGETS ${NAME}
+          DESTINATION "${BENCHMARKS_INSTALL_PATH}/${arg_INSTALL_SUBDIR}")
+
+endmacro(sundials_add_sunmatrix_benchmark)
+
+macro(sundials_add_sunlinsol_benchmark NAME)
+
+  set(options)
+  set(singleValueArgs)
+  set(multiValueArgs SOURCES SUNDIALS_TARGETS LINK_LIBRARIES INSTALL_SUBDIR)
+
+  cmake_parse_arguments(arg "${options}" "${singleValueArgs}"
+                        "${multiValueArgs}" ${ARGN})
+
+  set(BENCHMARKS_DIR ${PROJECT_SOURCE_DIR}/benchmarks)
+
+  # the linear solver benchmarks reuse the matrix generators and timers from
+  # the SUNMatrix benchmarks
+  add_executable(
+    ${NAME}
+    ${BENCHMARKS_DIR}/sunmatrix/test_sunmatrix_performance.c
+    ${BENCHMARKS_DIR}/sunlinsol/test_sunlinsol_performance.c ${arg_SOURCES})
+
+  set_target_properties(${NAME} PROPERTIES FOLDER "Benchmarks")
+
+  target_include_directories(${NAME} PRIVATE ${BENCHMARKS_DIR}/sunmatrix
+                                             ${BENCHMARKS_DIR}/sunlinsol)
+
+  target_link_libraries(
+    ${NAME} PRIVATE sundials_sunmatrixdense sundials_sunmatrixband
+                    sundials_sunmatrixsparse ${arg_SUNDIALS_TARGETS}
+                    ${arg_LINK_LIBRARIES} -lm)
+
+  install(TARGETS ${NAME}
+          DESTINATION "${BENCHMARKS_INSTALL_PATH}/${arg_INSTALL_SUBDIR}")
+
+endmacro(sundials_add_sunlinsol_benchmark)
@@ -41,6 +41,9 @@
 #define FIVE     SUN_RCONST(5.0)
 #define THOUSAND SUN_RCONST(1000.0)
 
+/* number of right-hand sides for the distinct block solve */
+#define NRHS_DISTINCT 4
+
 /* user data structure */
 typedef struct
 {
@@ -57,6 +60,9 @@ int ATimes(void* ProbData, N_Vector v, N_Vector z);
 int PSetup(void* ProbData);
 /*    preconditioner solve */
 int PSolve(void* ProbData, N_Vector r, N_Vector z, sunrealtype tol, int lr);
+/*    block solve with distinct right-hand sides */
+static int SolveMultiDistinct(SUNLinearSolver LS, UserData* ProbData,
+                              N_Vector x, sunrealtype tol);
 /*    checks function return values  */
 static int check_flag(void* flagvalue, const char* funcname, int opt);
 /*    uniform random number generator in [0,1] */
@@ -229,6 +235,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -263,6 +271,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -298,6 +308,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -333,6 +345,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -368,6 +382,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -403,6 +419,8 @@ int main(int argc, char* argv[])
   fails += Test_SUNLinSolSetup(LS, NULL, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNTRUE, 0);
   fails += Test_SUNLinSolSolve(LS, NULL, x, b, tol, SUNFALSE, 0);
+  fails += Test_SUNLinSolSolveMulti(LS, NULL, x, b, tol, 0);
+  fails += SolveMultiDistinct(LS, &ProbData, x, tol);
   fails += Test_SUNLinSolLastFlag(LS, 0);
   fails += Test_SUNLinSolNumIters(LS, 0);
   fails += Test_SUNLinSolResNorm(LS, 0);
@@ -500,6 +518,58 @@ int PSolve(void* Data, N_Vector r_vec, N_Vector z_vec, sunrealtype tol, int lr)
   return 0;
 }
 
+/* solve in place for several random solutions x_k = S2_inv xhat_k at once */
+static int SolveMultiDistinct(SUNLinearSolver LS, UserData* ProbData,
+                              N_Vector x, sunrealtype tol)
+{
+  int failure, k;
+  sunindextype i;
+  sunrealtype* xdata;
+  N_Vector *X, *B;
+
+  X = N_VCloneVectorArray(NRHS_DISTINCT, x);
+  B = N_VCloneVectorArray(NRHS_DISTINCT, x);
+  if (check_flag(X, "N_VCloneVectorArray", 0)) { return 1; }
+  if (check_flag(B, "N_VCloneVectorArray", 0)) { return 1; }
+
+  for (k = 0; k < NRHS_DISTINCT; k++)
+  {
+    xdata = N_VGetArrayPointer(X[k]);
+    for (i = 0; i < ProbData->N; i++) { xdata[i] = ONE + urand(); }
+    N_VDiv(X[k], ProbData->s2, X[k]);
+    ATimes(ProbData, X[k], B[k]);
+  }
+
+  failure = SUNLinSolSetZeroGuess(LS, SUNTRUE);
+  if (!failure)
+  {
+    failure = SUNLinSolSolveMulti(LS, NULL, NRHS_DISTINCT, B, B, tol);
+  }
+  if (failure)
+  {
+    printf(">>> FAILED test -- SUNLinSolSolveMulti (distinct) returned %d\n",
+           failure);
+  }
+
+  for (k = 0; (k < NRHS_DISTINCT) && !failure; k++)
+  {
+    failure = check_vector(X[k], B[k], 10.0 * tol);
+    if (failure)
+    {
+      printf(">>> FAILED test -- SUNLinSolSolveMulti (distinct) check\n");
+    }
+  }
+  if (!failure)
+  {
+    printf("    PASSED test -- SUNLinSolSolveMulti (distinct), %d iters\n",
+           SUNLinSolNumIters(LS));
+  }
+
+  N_VDestroyVectorArray(X, NRHS_DISTINCT);
+  N_VDestroyVectorArray(B, NRHS_DISTINCT);
+  return (failure ? 1 : 0);
+}
+
 /* uniform random number generator */
 static sunrealtype urand(void)
 {
@@ -515,6 +515,87 @@ int Test_SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
   return (0);
 }
 
+/* ----------------------------------------------------------------------
+ * SUNLinSolSolveMulti Test: solves for scaled copies of b, which must
+ * give the same scaling of x. Direct solvers also solve in place.
+ * --------------------------------------------------------------------*/
+#define NRHS 20
+
+int Test_SUNLinSolSolveMulti(SUNLinearSolver S, SUNMatrix A, N_Vector x,
+                             N_Vector b, sunrealtype tol, int myid)
+{
+  int failure, k;
+  double start_time, stop_time;
+  N_Vector *X, *B, y;
+
+  /* clone to create right-hand sides and solution vectors */
+  X = N_VCloneVectorArray(NRHS, x);
+  B = N_VCloneVectorArray(NRHS, x);
+  y = N_VClone(x);
+  for (k = 0; k < NRHS; k++)
+  {
+    N_VScale(ONE + (sunrealtype)k / NRHS, b, B[k]);
+    N_VConst(ZERO, X[k]);
+  }
+
+  sync_device();
+
+  /* perform solve */
+  start_time = get_time();
+  failure    = SUNLinSolSolveMulti(S, A, NRHS, X, B, tol);
+  sync_device();
+  stop_time = get_time();
+  if (failure)
+  {
+    printf(">>> FAILED test -- SUNLinSolSolveMulti returned %d on Proc %d \n",
+           failure, myid);
+    N_VDestroyVectorArray(X, NRHS);
+    N_VDestroyVectorArray(B, NRHS);
+    N_VDestroy(y);
+    return (1);
+  }
+
+  /* direct solvers may overwrite the right-hand sides with the solutions */
+  if (SUNLinSolGetType(S) == SUNLINEARSOLVER_DIRECT)
+  {
+    failure = SUNLinSolSolveMulti(S, A, NRHS, B, B, tol);
+    sync_device();
+  }
+  else
+  {
+    for (k = 0; k < NRHS; k++) { N_VScale(ONE, X[k], B[k]); }
+  }
+
+  /* Check solutions */
+  for (k = 0; (k < NRHS) && !failure; k++)
+  {
+    N_VScale(ONE + (sunrealtype)k / NRHS, x, y);
+    failure = check_vector(y, X[k], 10.0 * tol) ||
+              check_vector(y, B[k], 10.0 * tol);
+  }
+  if (failure)
+  {
+    printf(">>> FAILED test -- SUNLinSolSolveMulti check, Proc %d \n", myid);
+    PRINT_TIME("    SUNLinSolSolveMulti Time: %22.15e \n \n",
+               stop_time - start_time);
+    N_VDestroyVectorArray(X, NRHS);
+    N_VDestroyVectorArray(B, NRHS);
+    N_VDestroy(y);
+    return (1);
+  }
+  else if (myid == 0)
+  {
+    printf("    PASSED test -- SUNLinSolSolveMulti \n");
+    PRINT_TIME("    SUNLinSolSolveMulti Time: %22.15e \n \n",
+               stop_time - start_time);
+  }
+
+  N_VDestroyVectorArray(X, NRHS);
+  N_VDestroyVectorArray(B, NRHS);
+  N_VDestroy(y);
+  return (0);
+}
+
 /* ======================================================================
  * Private functions
  * ====================================================================*/
@@ -52,6 +52,8 @@ int Test_SUNLinSolInitialize(SUNLinearSolver S, int myid);
 int Test_SUNLinSolSetup(SUNLinearSolver S, SUNMatrix A, int myid);
 int Test_SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
                         sunrealtype tol, sunbooleantype zeroguess, int myid);
+int Test_SUNLinSolSolveMulti(SUNLinearSolver S, SUNMatrix A, N_Vector x,
+                             N_Vector b, sunrealtype tol, int myid);
 
 /* Timing function */
 void SetTiming(int onoff);
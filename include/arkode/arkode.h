@@ -148,6 +148,9 @@ extern "C" {
 
 #define ARK_STEP_DIRECTION_ERR -52
 
+#define ARK_ADJ_CHECKPOINT_FAIL -53
+#define ARK_ADJ_MEM_NULL        -54
+
 #define ARK_UNRECOGNIZED_ERROR -99
 
 /* ------------------------------
@@ -160,6 +163,10 @@ typedef int (*ARKRhsFn)(sunrealtype t, N_Vector y, N_Vector ydot,
 typedef int (*ARKRootFn)(sunrealtype t, N_Vector y, sunrealtype* gout,
                          void* user_data);
 
+typedef int (*ARKRootSubsetFn)(sunrealtype t, N_Vector y, int nsub,
+                               const int* isub, sunrealtype* gout,
+                               void* user_data);
+
 typedef int (*ARKEwtFn)(N_Vector y, N_Vector ewt, void* user_data);
 
 typedef int (*ARKRwtFn)(N_Vector y, N_Vector rwt, void* user_data);
@@ -182,6 +189,9 @@ typedef int (*ARKRelaxFn)(N_Vector y, sunrealtype* r, void* user_data);
 
 typedef int (*ARKRelaxJacFn)(N_Vector y, N_Vector J, void* user_data);
 
+typedef int (*ARKVecJacFn)(sunrealtype t, N_Vector y, N_Vector v, N_Vector Jv,
+                           void* user_data);
+
 /* ------------------------------------------------
  * MRIStep Inner Stepper Type (forward declaration)
  * ------------------------------------------------ */
@@ -240,6 +250,10 @@ SUNDIALS_EXPORT int ARKodeResFtolerance(void* arkode_mem, ARKRwtFn rfun);
 SUNDIALS_EXPORT int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g);
 SUNDIALS_EXPORT int ARKodeSetRootDirection(void* arkode_mem, int* rootdir);
 SUNDIALS_EXPORT int ARKodeSetNoInactiveRootWarn(void* arkode_mem);
+SUNDIALS_EXPORT int ARKodeSetScalableRootfinding(void* arkode_mem,
+                                                 sunbooleantype onoff);
+SUNDIALS_EXPORT int ARKodeSetRootSubsetFn(void* arkode_mem,
+                                          ARKRootSubsetFn gsub);
 
 /* Optional input functions (general) */
 SUNDIALS_EXPORT int ARKodeSetDefaults(void* arkode_mem);
@@ -449,6 +463,25 @@ SUNDIALS_EXPORT int ARKodeGetNumRelaxSolveIters(void* arkode_mem,
 /* SUNStepper functions */
 SUNDIALS_EXPORT int ARKodeCreateSUNStepper(void* arkode_mem, SUNStepper* stepper);
 
+/* Discrete adjoint functions */
+SUNDIALS_EXPORT int ARKodeSetAdjointCheckpointing(void* arkode_mem,
+                                                  long int interval,
+                                                  sunbooleantype save_stages);
+SUNDIALS_EXPORT int ARKodeSetAdjointVecJacFn(void* arkode_mem,
+                                             ARKVecJacFn fy_vjp,
+                                             ARKVecJacFn fp_vjp);
+SUNDIALS_EXPORT int ARKodeSetAdjointLinSolTol(void* arkode_mem, sunrealtype tol);
+SUNDIALS_EXPORT int ARKodeCreateAdjointSUNStepper(void* arkode_mem, N_Vector mu,
+                                                  SUNStepper* adj_stepper);
+SUNDIALS_EXPORT int ARKodeGetNumAdjointCheckpoints(void* arkode_mem,
+                                                   long int* nck);
+SUNDIALS_EXPORT int ARKodeGetNumAdjointRecomputedSteps(void* arkode_mem,
+                                                       long int* nrecomp);
+SUNDIALS_EXPORT int ARKodeGetNumAdjointVecJacEvals(void* arkode_mem,
+                                                   long int* nvjp);
+SUNDIALS_EXPORT int ARKodeGetNumAdjointLinIters(void* arkode_mem,
+                                                long int* nliters);
+
 #ifdef __cplusplus
 }
 #endif
@@ -84,6 +84,10 @@ SUNDIALS_EXPORT int ARKStepSetTableNum(void* arkode_mem,
                                        ARKODE_ERKTableID etable);
 SUNDIALS_EXPORT int ARKStepSetTableName(void* arkode_mem, const char* itable,
                                         const char* etable);
+SUNDIALS_EXPORT int ARKStepSetStiffnessSwitching(void* arkode_mem,
+                                                 sunbooleantype onoff);
+SUNDIALS_EXPORT int ARKStepSetStiffnessSwitchingTable(void* arkode_mem,
+                                                      ARKodeButcherTable Bsw);
 
 /* Optional output functions */
 SUNDIALS_EXPORT int ARKStepGetCurrentButcherTables(void* arkode_mem,
@@ -93,6 +97,12 @@ SUNDIALS_EXPORT int ARKStepGetTimestepperStats(
   void* arkode_mem, long int* expsteps, long int* accsteps,
   long int* step_attempts, long int* nfe_evals, long int* nfi_evals,
   long int* nlinsetups, long int* netfails);
+SUNDIALS_EXPORT int ARKStepGetStiffnessSwitchingStats(
+  void* arkode_mem, long int* nswitches, long int* nsteps_explicit,
+  long int* nsteps_implicit);
+SUNDIALS_EXPORT int ARKStepGetStiffnessEstimate(void* arkode_mem,
+                                                sunrealtype* rho,
+                                                sunbooleantype* explicit_phase);
 
 /* --------------------------------------------------------------------------
  * Deprecated Functions -- all are superseded by shared ARKODE-level routines
@@ -42,6 +42,18 @@ static const int ERKSTEP_DEFAULT_7 = ARKODE_VERNER_10_6_7;
 static const int ERKSTEP_DEFAULT_8 = ARKODE_FEHLBERG_13_7_8;
 static const int ERKSTEP_DEFAULT_9 = ARKODE_VERNER_16_8_9;
 
+/* Built-in low-storage methods */
+
+typedef enum
+{
+  ARKODE_LSERK_NONE                        = -1, /* ensure enum is signed int */
+  ARKODE_MIN_LSERK_NUM                     = 0,
+  ARKODE_CARPENTER_KENNEDY_2N_5_4          = ARKODE_MIN_LSERK_NUM,
+  ARKODE_KENNEDY_CARPENTER_LEWIS_2R_4_2_3,
+  ARKODE_KENNEDY_CARPENTER_LEWIS_2R_5_3_4,
+  ARKODE_MAX_LSERK_NUM = ARKODE_KENNEDY_CARPENTER_LEWIS_2R_5_3_4
+} ARKODE_LSERKTableID;
+
 /* -------------------
  * Exported Functions
  * ------------------- */
@@ -57,6 +69,8 @@ SUNDIALS_EXPORT int ERKStepSetTable(void* arkode_mem, ARKodeButcherTable B);
 SUNDIALS_EXPORT int ERKStepSetTableNum(void* arkode_mem,
                                        ARKODE_ERKTableID etable);
 SUNDIALS_EXPORT int ERKStepSetTableName(void* arkode_mem, const char* etable);
+SUNDIALS_EXPORT int ERKStepSetLowStorageTableNum(void* arkode_mem,
+                                                 ARKODE_LSERKTableID ltable);
 
 /* Optional output functions */
 SUNDIALS_EXPORT int ERKStepGetCurrentButcherTable(void* arkode_mem,
@@ -0,0 +1,72 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the header file for the ARKODE EXPStep module.
+ * -----------------------------------------------------------------*/
+
+#ifndef _EXPSTEP_H
+#define _EXPSTEP_H
+
+#include <arkode/arkode.h>
+#include <arkode/arkode_ls.h>
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* -----------------
+ * EXPStep Constants
+ * ----------------- */
+
+/* Built-in exponential Rosenbrock methods */
+
+typedef enum
+{
+  ARKODE_EXP_NONE      = -1, /* ensure enum is signed int */
+  ARKODE_MIN_EXP_NUM   = 0,
+  ARKODE_EXPRB_EULER_2 = ARKODE_MIN_EXP_NUM,
+  ARKODE_EXPRB32_3_2,
+  ARKODE_MAX_EXP_NUM = ARKODE_EXPRB32_3_2
+} ARKODE_EXPMethodID;
+
+/* Default methods for each order */
+
+static const int EXPSTEP_DEFAULT_2 = ARKODE_EXPRB_EULER_2;
+static const int EXPSTEP_DEFAULT_3 = ARKODE_EXPRB32_3_2;
+
+/* -------------------
+ * Exported Functions
+ * ------------------- */
+
+/* Creation and Reinitialization functions */
+SUNDIALS_EXPORT void* EXPStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0,
+                                    SUNContext sunctx);
+SUNDIALS_EXPORT int EXPStepReInit(void* arkode_mem, ARKRhsFn f, sunrealtype t0,
+                                  N_Vector y0);
+
+/* Optional input functions -- must be called AFTER EXPStepCreate */
+SUNDIALS_EXPORT int EXPStepSetMethod(void* arkode_mem,
+                                     ARKODE_EXPMethodID method);
+SUNDIALS_EXPORT int EXPStepSetMaxKrylovDim(void* arkode_mem, int maxkrylov);
+
+/* Optional output functions */
+SUNDIALS_EXPORT int EXPStepGetNumKrylovIters(void* arkode_mem,
+                                             long int* nkrylov);
+SUNDIALS_EXPORT int EXPStepGetNumKrylovFails(void* arkode_mem,
+                                             long int* nkryfails);
+SUNDIALS_EXPORT int EXPStepGetMaxKrylovDimUsed(void* arkode_mem,
+                                               int* maxdimused);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the header file for the ARKODE EXTRAPStep module.
+ * -----------------------------------------------------------------*/
+
+#ifndef _EXTRAPSTEP_H
+#define _EXTRAPSTEP_H
+
+#include <arkode/arkode.h>
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* --------------------
+ * EXTRAPStep Constants
+ * -------------------- */
+
+/* Base methods for extrapolation */
+
+typedef enum
+{
+  ARKODE_EXTRAP_NONE    = -1, /* ensure enum is signed int */
+  ARKODE_MIN_EXTRAP_NUM = 0,
+  ARKODE_EXTRAP_EULER   = ARKODE_MIN_EXTRAP_NUM,
+  ARKODE_EXTRAP_MIDPOINT,
+  ARKODE_MAX_EXTRAP_NUM = ARKODE_EXTRAP_MIDPOINT
+} ARKODE_ExtrapBaseID;
+
+/* -------------------
+ * Exported Functions
+ * ------------------- */
+
+/* Creation and Reinitialization functions */
+SUNDIALS_EXPORT void* EXTRAPStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0,
+                                       SUNContext sunctx);
+SUNDIALS_EXPORT int EXTRAPStepReInit(void* arkode_mem, ARKRhsFn f,
+                                     sunrealtype t0, N_Vector y0);
+
+/* Optional input functions -- must be called AFTER EXTRAPStepCreate */
+SUNDIALS_EXPORT int EXTRAPStepSetBaseMethod(void* arkode_mem,
+                                            ARKODE_ExtrapBaseID base);
+SUNDIALS_EXPORT int EXTRAPStepSetMaxColumns(void* arkode_mem, int kmax);
+SUNDIALS_EXPORT int EXTRAPStepSetNumThreads(void* arkode_mem, int nthreads);
+
+/* Optional output functions */
+SUNDIALS_EXPORT int EXTRAPStepGetCurrentColumns(void* arkode_mem, int* kcur);
+SUNDIALS_EXPORT int EXTRAPStepGetNumColumnChanges(void* arkode_mem,
+                                                  long int* nkchanges);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
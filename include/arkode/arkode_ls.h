@@ -77,6 +77,9 @@ typedef int (*ARKLsLinSysFn)(sunrealtype t, N_Vector y, N_Vector fy,
                              void* user_data, N_Vector tmp1, N_Vector tmp2,
                              N_Vector tmp3);
 
+typedef int (*ARKLsBatchRhsFn)(sunrealtype t, int nstates, N_Vector* y,
+                               N_Vector* ydot, void* user_data);
+
 typedef int (*ARKLsMassTimesSetupFn)(sunrealtype t, void* mtimes_data);
 
 typedef int (*ARKLsMassTimesVecFn)(N_Vector v, N_Vector Mv, sunrealtype t,
@@ -97,6 +100,9 @@ SUNDIALS_EXPORT int ARKodeSetMassLinearSolver(void* arkode_mem,
 /* Linear solver interface optional input functions -- must be called
    AFTER ARKodeSetLinearSolver and/or ARKodeSetMassLinearSolver */
 SUNDIALS_EXPORT int ARKodeSetJacFn(void* arkode_mem, ARKLsJacFn jac);
+SUNDIALS_EXPORT int ARKodeSetBatchRhsFn(void* arkode_mem, ARKLsBatchRhsFn fb,
+                                        int max_batch);
+SUNDIALS_EXPORT int ARKodeSetDQJacNumThreads(void* arkode_mem, int nthreads);
 SUNDIALS_EXPORT int ARKodeSetMassFn(void* arkode_mem, ARKLsMassFn mass);
 SUNDIALS_EXPORT int ARKodeSetJacEvalFrequency(void* arkode_mem, long int msbj);
 SUNDIALS_EXPORT int ARKodeSetLinearSolutionScaling(void* arkode_mem,
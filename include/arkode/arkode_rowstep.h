@@ -0,0 +1,75 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the header file for the ARKODE ROWStep module.
+ * -----------------------------------------------------------------*/
+
+#ifndef _ROWSTEP_H
+#define _ROWSTEP_H
+
+#include <arkode/arkode.h>
+#include <arkode/arkode_butcher.h>
+#include <arkode/arkode_ls.h>
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* -----------------
+ * ROWStep Constants
+ * ----------------- */
+
+/* Built-in Rosenbrock and Rosenbrock-W methods */
+
+typedef enum
+{
+  ARKODE_ROW_NONE       = -1, /* ensure enum is signed int */
+  ARKODE_MIN_ROW_NUM    = 0,
+  ARKODE_ROS2_2_1_2     = ARKODE_MIN_ROW_NUM,
+  ARKODE_ROS3P_3_2_3,
+  ARKODE_ROS34PW2_4_2_3,
+  ARKODE_MAX_ROW_NUM = ARKODE_ROS34PW2_4_2_3
+} ARKODE_ROWTableID;
+
+/* Default methods for each order */
+
+static const int ROWSTEP_DEFAULT_2 = ARKODE_ROS2_2_1_2;
+static const int ROWSTEP_DEFAULT_3 = ARKODE_ROS34PW2_4_2_3;
+
+/* -------------------
+ * Exported Functions
+ * ------------------- */
+
+/* Creation and Reinitialization functions */
+SUNDIALS_EXPORT void* ROWStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0,
+                                    SUNContext sunctx);
+SUNDIALS_EXPORT int ROWStepReInit(void* arkode_mem, ARKRhsFn f, sunrealtype t0,
+                                  N_Vector y0);
+
+/* Optional input functions -- must be called AFTER ROWStepCreate */
+SUNDIALS_EXPORT int ROWStepSetTables(void* arkode_mem, ARKodeButcherTable A,
+                                     ARKodeButcherTable G,
+                                     sunbooleantype wmethod);
+SUNDIALS_EXPORT int ROWStepSetTableNum(void* arkode_mem,
+                                       ARKODE_ROWTableID rtable);
+
+/* Optional output functions */
+SUNDIALS_EXPORT int ROWStepGetCurrentTables(void* arkode_mem,
+                                            ARKodeButcherTable* A,
+                                            ARKodeButcherTable* G);
+SUNDIALS_EXPORT int ROWStepGetIsWMethod(void* arkode_mem,
+                                        sunbooleantype* wmethod);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -105,6 +105,9 @@ SUNDIALS_EXPORT int SplittingStepReInit(void* arkode_mem, SUNStepper* steppers,
 SUNDIALS_EXPORT int SplittingStepSetCoefficients(
   void* arkode_mem, SplittingStepCoefficients coefficients);
 
+SUNDIALS_EXPORT int SplittingStepSetNumThreads(void* arkode_mem, int nthreads,
+                                               SUNStepper* steppers);
+
 SUNDIALS_EXPORT int SplittingStepGetNumEvolves(void* arkode_mem, int partition,
                                                long int* evolves);
 
@@ -39,6 +39,10 @@ extern "C" {
 #define CV_NORMAL   1
 #define CV_ONE_STEP 2
 
+/* linear solver setup policy */
+#define CV_LSETUP_HEURISTIC  0
+#define CV_LSETUP_COST_MODEL 1
+
 /* return values */
 
 #define CV_SUCCESS      0
@@ -92,6 +96,10 @@ typedef int (*CVRhsFn)(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data
 typedef int (*CVRootFn)(sunrealtype t, N_Vector y, sunrealtype* gout,
                         void* user_data);
 
+typedef int (*CVRootSubsetFn)(sunrealtype t, N_Vector y, int nsub,
+                              const int* isub, sunrealtype* gout,
+                              void* user_data);
+
 typedef int (*CVEwtFn)(N_Vector y, N_Vector ewt, void* user_data);
 
 typedef int (*CVMonitorFn)(void* cvode_mem, void* user_data);
@@ -121,6 +129,7 @@ SUNDIALS_EXPORT int CVodeSetDeltaGammaMaxLSetup(void* cvode_mem,
                                                 sunrealtype dgmax_lsetup);
 SUNDIALS_EXPORT int CVodeSetInitStep(void* cvode_mem, sunrealtype hin);
 SUNDIALS_EXPORT int CVodeSetLSetupFrequency(void* cvode_mem, long int msbp);
+SUNDIALS_EXPORT int CVodeSetLSetupPolicy(void* cvode_mem, int policy);
 SUNDIALS_EXPORT int CVodeSetMaxConvFails(void* cvode_mem, int maxncf);
 SUNDIALS_EXPORT int CVodeSetMaxErrTestFails(void* cvode_mem, int maxnef);
 SUNDIALS_EXPORT int CVodeSetMaxHnilWarns(void* cvode_mem, int mxhnil);
@@ -128,6 +137,8 @@ SUNDIALS_EXPORT int CVodeSetMaxNonlinIters(void* cvode_mem, int maxcor);
 SUNDIALS_EXPORT int CVodeSetMaxNumSteps(void* cvode_mem, long int mxsteps);
 SUNDIALS_EXPORT int CVodeSetMaxOrd(void* cvode_mem, int maxord);
 SUNDIALS_EXPORT int CVodeSetMaxStep(void* cvode_mem, sunrealtype hmax);
+SUNDIALS_EXPORT int CVodeSetMethodSwitching(void* cvode_mem,
+                                            sunbooleantype onoff);
 SUNDIALS_EXPORT int CVodeSetMinStep(void* cvode_mem, sunrealtype hmin);
 SUNDIALS_EXPORT int CVodeSetMonitorFn(void* cvode_mem, CVMonitorFn fn);
 SUNDIALS_EXPORT int CVodeSetMonitorFrequency(void* cvode_mem, long int nst);
@@ -173,6 +184,9 @@ SUNDIALS_EXPORT int CVodeRootInit(void* cvode_mem, int nrtfn, CVRootFn g);
 /* Rootfinding optional input functions */
 SUNDIALS_EXPORT int CVodeSetRootDirection(void* cvode_mem, int* rootdir);
 SUNDIALS_EXPORT int CVodeSetNoInactiveRootWarn(void* cvode_mem);
+SUNDIALS_EXPORT int CVodeSetScalableRootfinding(void* cvode_mem,
+                                                sunbooleantype onoff);
+SUNDIALS_EXPORT int CVodeSetRootSubsetFn(void* cvode_mem, CVRootSubsetFn gsub);
 
 /* Solver function */
 SUNDIALS_EXPORT int CVode(void* cvode_mem, sunrealtype tout, N_Vector yout,
@@ -188,6 +202,8 @@ SUNDIALS_EXPORT int CVodeGetDky(void* cvode_mem, sunrealtype t, int k,
 /* Optional output functions */
 SUNDIALS_EXPORT int CVodeGetWorkSpace(void* cvode_mem, long int* lenrw,
                                       long int* leniw);
+SUNDIALS_EXPORT int CVodeGetScratchSpace(void* cvode_mem, long int* lenrw,
+                                         long int* leniw);
 SUNDIALS_EXPORT int CVodeGetNumSteps(void* cvode_mem, long int* nsteps);
 SUNDIALS_EXPORT int CVodeGetNumRhsEvals(void* cvode_mem, long int* nfevals);
 SUNDIALS_EXPORT int CVodeGetNumLinSolvSetups(void* cvode_mem,
@@ -195,6 +211,7 @@ SUNDIALS_EXPORT int CVodeGetNumLinSolvSetups(void* cvode_mem,
 SUNDIALS_EXPORT int CVodeGetNumErrTestFails(void* cvode_mem, long int* netfails);
 SUNDIALS_EXPORT int CVodeGetLastOrder(void* cvode_mem, int* qlast);
 SUNDIALS_EXPORT int CVodeGetCurrentOrder(void* cvode_mem, int* qcur);
+SUNDIALS_EXPORT int CVodeGetCurrentMethod(void* cvode_mem, int* lmm);
 SUNDIALS_EXPORT int CVodeGetCurrentGamma(void* cvode_mem, sunrealtype* gamma);
 SUNDIALS_EXPORT int CVodeGetNumStabLimOrderReds(void* cvode_mem,
                                                 long int* nslred);
@@ -226,6 +243,15 @@ SUNDIALS_EXPORT int CVodeGetNonlinSolvStats(void* cvode_mem, long int* nniters,
                                             long int* nnfails);
 SUNDIALS_EXPORT int CVodeGetNumStepSolveFails(void* cvode_mem,
                                               long int* nncfails);
+SUNDIALS_EXPORT int CVodeGetLSetupPolicyStats(void* cvode_mem,
+                                              long int* nsetups_model,
+                                              long int* njevals_model,
+                                              double* jac_time,
+                                              double* setup_time,
+                                              double* nls_time);
+SUNDIALS_EXPORT int CVodeGetMethodSwitchingStats(
+  void* cvode_mem, long int* nswitches, long int* nsteps_adams,
+  long int* nsteps_bdf, sunrealtype* time_adams, sunrealtype* time_bdf);
 SUNDIALS_EXPORT int CVodeGetUserData(void* cvode_mem, void** user_data);
 SUNDIALS_EXPORT int CVodePrintAllStats(void* cvode_mem, FILE* outfile,
                                        SUNOutputFormat fmt);
@@ -52,6 +52,9 @@ typedef int (*CVLsJacFn)(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
                          void* user_data, N_Vector tmp1, N_Vector tmp2,
                          N_Vector tmp3);
 
+typedef int (*CVLsBatchRhsFn)(sunrealtype t, int nstates, N_Vector* y,
+                              N_Vector* ydot, void* user_data);
+
 typedef int (*CVLsPrecSetupFn)(sunrealtype t, N_Vector y, N_Vector fy,
                                sunbooleantype jok, sunbooleantype* jcurPtr,
                                sunrealtype gamma, void* user_data);
@@ -84,6 +87,9 @@ SUNDIALS_EXPORT int CVodeSetLinearSolver(void* cvode_mem, SUNLinearSolver LS,
   -----------------------------------------------------------------*/
 
 SUNDIALS_EXPORT int CVodeSetJacFn(void* cvode_mem, CVLsJacFn jac);
+SUNDIALS_EXPORT int CVodeSetBatchRhsFn(void* cvode_mem, CVLsBatchRhsFn fb,
+                                       int max_batch);
+SUNDIALS_EXPORT int CVodeSetDQJacNumThreads(void* cvode_mem, int nthreads);
 SUNDIALS_EXPORT int CVodeSetJacEvalFrequency(void* cvode_mem, long int msbj);
 SUNDIALS_EXPORT int CVodeSetLinearSolutionScaling(void* cvode_mem,
                                                   sunbooleantype onoff);
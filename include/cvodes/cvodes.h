@@ -261,6 +261,8 @@ SUNDIALS_EXPORT int CVodeGetDky(void* cvode_mem, sunrealtype t, int k,
 /* Optional output functions */
 SUNDIALS_EXPORT int CVodeGetWorkSpace(void* cvode_mem, long int* lenrw,
                                       long int* leniw);
+SUNDIALS_EXPORT int CVodeGetScratchSpace(void* cvode_mem, long int* lenrw,
+                                         long int* leniw);
 SUNDIALS_EXPORT int CVodeGetNumSteps(void* cvode_mem, long int* nsteps);
 SUNDIALS_EXPORT int CVodeGetNumRhsEvals(void* cvode_mem, long int* nfevals);
 SUNDIALS_EXPORT int CVodeGetNumLinSolvSetups(void* cvode_mem,
@@ -372,6 +374,11 @@ SUNDIALS_EXPORT int CVodeSetSensDQMethod(void* cvode_mem, int DQtype,
                                          sunrealtype DQrhomax);
 SUNDIALS_EXPORT int CVodeSetSensErrCon(void* cvode_mem, sunbooleantype errconS);
 SUNDIALS_EXPORT int CVodeSetSensMaxNonlinIters(void* cvode_mem, int maxcorS);
+SUNDIALS_EXPORT int CVodeSetSensNumThreads(void* cvode_mem, int nthreads);
+SUNDIALS_EXPORT int CVodeSetSensDQThreadData(void* cvode_mem, void** user_data,
+                                             sunrealtype** p);
+SUNDIALS_EXPORT int CVodeSetSensContiguous(void* cvode_mem,
+                                           sunbooleantype contiguous);
 SUNDIALS_EXPORT int CVodeSetSensParams(void* cvode_mem, sunrealtype* p,
                                        sunrealtype* pbar, int* plist);
 
@@ -529,6 +536,8 @@ SUNDIALS_EXPORT int CVodeB(void* cvode_mem, sunrealtype tBout, int itaskB);
 /* Optional Input Functions For Adjoint Problems */
 
 SUNDIALS_EXPORT int CVodeSetAdjNoSensi(void* cvode_mem);
+SUNDIALS_EXPORT int CVodeSetAdjMaxCheckpoints(void* cvode_mem, int maxck);
+SUNDIALS_EXPORT int CVodeSetAdjNumThreads(void* cvode_mem, int nthreads);
 
 SUNDIALS_EXPORT int CVodeSetUserDataB(void* cvode_mem, int which,
                                       void* user_dataB);
@@ -69,6 +69,9 @@ typedef int (*IDALsJacTimesVecFn)(sunrealtype tt, N_Vector yy, N_Vector yp,
                                   sunrealtype c_j, void* user_data,
                                   N_Vector tmp1, N_Vector tmp2);
 
+typedef int (*IDALsBatchResFn)(sunrealtype tt, int nstates, N_Vector* yy,
+                               N_Vector* yp, N_Vector* rr, void* user_data);
+
 /*=================================================================
   IDALS Exported functions
   =================================================================*/
@@ -81,6 +84,9 @@ SUNDIALS_EXPORT int IDASetLinearSolver(void* ida_mem, SUNLinearSolver LS,
   -----------------------------------------------------------------*/
 
 SUNDIALS_EXPORT int IDASetJacFn(void* ida_mem, IDALsJacFn jac);
+SUNDIALS_EXPORT int IDASetBatchResFn(void* ida_mem, IDALsBatchResFn fb,
+                                     int max_batch);
+SUNDIALS_EXPORT int IDASetDQJacNumThreads(void* ida_mem, int nthreads);
 SUNDIALS_EXPORT int IDASetPreconditioner(void* ida_mem, IDALsPrecSetupFn pset,
                                          IDALsPrecSolveFn psolve);
 SUNDIALS_EXPORT int IDASetJacTimes(void* ida_mem, IDALsJacTimesSetupFn jtsetup,
@@ -360,6 +360,8 @@ SUNDIALS_EXPORT int IDASetSensDQMethod(void* ida_mem, int DQtype,
                                        sunrealtype DQrhomax);
 SUNDIALS_EXPORT int IDASetSensErrCon(void* ida_mem, sunbooleantype errconS);
 SUNDIALS_EXPORT int IDASetSensMaxNonlinIters(void* ida_mem, int maxcorS);
+SUNDIALS_EXPORT int IDASetSensContiguous(void* ida_mem,
+                                         sunbooleantype contiguous);
 SUNDIALS_EXPORT int IDASetSensParams(void* ida_mem, sunrealtype* p,
                                      sunrealtype* pbar, int* plist);
 
@@ -512,6 +514,10 @@ SUNDIALS_EXPORT int IDASolveB(void* ida_mem, sunrealtype tBout, int itaskB);
 /* Optional Input Functions For Adjoint Problems */
 
 SUNDIALS_EXPORT int IDAAdjSetNoSensi(void* ida_mem);
+SUNDIALS_EXPORT int IDAAdjSetStorageDirectory(void* ida_mem, const char* dir);
+SUNDIALS_EXPORT int IDAAdjSetStorageCompression(void* ida_mem,
+                                                sunbooleantype compress);
+SUNDIALS_EXPORT int IDAAdjSetStorageCacheSize(void* ida_mem, long int ncache);
 
 SUNDIALS_EXPORT int IDASetUserDataB(void* ida_mem, int which, void* user_dataB);
 SUNDIALS_EXPORT int IDASetMaxOrdB(void* ida_mem, int which, int maxordB);
@@ -60,6 +60,9 @@ typedef int (*KINLsPrecSolveFn)(N_Vector uu, N_Vector uscale, N_Vector fval,
 typedef int (*KINLsJacTimesVecFn)(N_Vector v, N_Vector Jv, N_Vector uu,
                                   sunbooleantype* new_uu, void* J_data);
 
+typedef int (*KINLsBatchSysFn)(int nstates, N_Vector* uu, N_Vector* fval,
+                               void* user_data);
+
 /*==================================================================
   KINLS Exported functions
   ==================================================================*/
@@ -72,6 +75,8 @@ SUNDIALS_EXPORT int KINSetLinearSolver(void* kinmem, SUNLinearSolver LS,
   -----------------------------------------------------------------*/
 
 SUNDIALS_EXPORT int KINSetJacFn(void* kinmem, KINLsJacFn jac);
+SUNDIALS_EXPORT int KINSetBatchSysFn(void* kinmem, KINLsBatchSysFn fb,
+                                     int max_batch);
 SUNDIALS_EXPORT int KINSetPreconditioner(void* kinmem, KINLsPrecSetupFn psetup,
                                          KINLsPrecSolveFn psolve);
 SUNDIALS_EXPORT int KINSetJacTimesVecFn(void* kinmem, KINLsJacTimesVecFn jtv);
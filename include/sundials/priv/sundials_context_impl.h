@@ -22,6 +22,7 @@
 #ifndef _SUNDIALS_CONTEXT_IMPL_H
 #define _SUNDIALS_CONTEXT_IMPL_H
 
+#include <stddef.h>
 #include <sundials/sundials_types.h>
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
@@ -34,11 +35,67 @@ struct SUNContext_
   sunbooleantype own_profiler;
   SUNLogger logger;
   sunbooleantype own_logger;
+  SUNStepTrace steptrace;
+  struct _generic_N_Vector** scratch; /* scratch vectors owned by the context */
+  sunbooleantype* scratch_in_use;     /* scratch vectors currently borrowed   */
+  int nscratch;                       /* number of scratch vectors            */
+  int scratch_capacity;               /* allocated length of scratch arrays   */
+  sunbooleantype scratch_sharing;     /* objects should borrow scratch space  */
+  /* memory accounting, bytes in use and high-water mark per subsystem */
+  size_t mem_current[SUN_MEMSUBSYSTEM_TOTAL + 1];
+  size_t mem_peak[SUN_MEMSUBSYSTEM_TOTAL + 1];
   SUNErrCode last_err;
   SUNErrHandler err_handler;
   SUNComm comm;
 };
 
+/* Record an allocation of bytes by a subsystem in the context memory
+   accounting and update the high-water marks */
+static inline void sunMemAccountAlloc(SUNContext sunctx,
+                                      SUNMemorySubsystem subsystem,
+                                      size_t bytes)
+{
+  if (!sunctx) { return; }
+
+  sunctx->mem_current[subsystem] += bytes;
+  if (sunctx->mem_current[subsystem] > sunctx->mem_peak[subsystem])
+  {
+    sunctx->mem_peak[subsystem] = sunctx->mem_current[subsystem];
+  }
+
+  sunctx->mem_current[SUN_MEMSUBSYSTEM_TOTAL] += bytes;
+  if (sunctx->mem_current[SUN_MEMSUBSYSTEM_TOTAL] >
+      sunctx->mem_peak[SUN_MEMSUBSYSTEM_TOTAL])
+  {
+    sunctx->mem_peak[SUN_MEMSUBSYSTEM_TOTAL] =
+      sunctx->mem_current[SUN_MEMSUBSYSTEM_TOTAL];
+  }
+}
+
+/* Report the release of more bytes than recorded for a subsystem */
+SUNDIALS_EXPORT
+void sunMemAccountMismatch(SUNContext sunctx, SUNMemorySubsystem subsystem,
+                           size_t bytes);
+
+/* Record the release of bytes previously recorded with sunMemAccountAlloc.
+   Unbalanced releases are reported in debug builds and clamped so the
+   counts cannot wrap around. */
+static inline void sunMemAccountFree(SUNContext sunctx,
+                                     SUNMemorySubsystem subsystem, size_t bytes)
+{
+  if (!sunctx) { return; }
+
+  if (bytes > sunctx->mem_current[subsystem])
+  {
+#if defined(SUNDIALS_DEBUG)
+    sunMemAccountMismatch(sunctx, subsystem, bytes);
+#endif
+    bytes = sunctx->mem_current[subsystem];
+  }
+  sunctx->mem_current[subsystem] -= bytes;
+  sunctx->mem_current[SUN_MEMSUBSYSTEM_TOTAL] -= bytes;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -99,6 +99,11 @@ sunindextype SUNDlsMat_bandGBTRF(sunrealtype** a, sunindextype n,
  * SUNDlsMat_BandGBTRS is only a wrapper around SUNDlsMat_bandGBTRS
  * which does all the work directly on the data in the DlsMat A (i.e.
  * in A->cols).
+ *
+ * SUNDlsMat_bandGBTRSMulti solves the system for each of the nrhs
+ * right-hand sides b[j], applying each column of the factors to all
+ * of them in turn. The results are identical to those of
+ * SUNDlsMat_bandGBTRS.
  * -----------------------------------------------------------------
  */
 
@@ -109,6 +114,11 @@ SUNDIALS_EXPORT
 void SUNDlsMat_bandGBTRS(sunrealtype** a, sunindextype n, sunindextype smu,
                          sunindextype ml, sunindextype* p, sunrealtype* b);
 
+SUNDIALS_EXPORT
+void SUNDlsMat_bandGBTRSMulti(sunrealtype** a, sunindextype n, sunindextype smu,
+                              sunindextype ml, sunindextype* p, int nrhs,
+                              sunrealtype** b);
+
 /*
  * -----------------------------------------------------------------
  * Function: SUNDlsMat_BandCopy
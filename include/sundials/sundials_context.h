@@ -19,6 +19,7 @@
 #ifndef _SUNDIALS_CONTEXT_H
 #define _SUNDIALS_CONTEXT_H
 
+#include <stdio.h>
 #include <sundials/priv/sundials_context_impl.h>
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
@@ -56,6 +57,39 @@ SUNErrCode SUNContext_GetLogger(SUNContext sunctx, SUNLogger* logger);
 SUNDIALS_EXPORT
 SUNErrCode SUNContext_SetLogger(SUNContext sunctx, SUNLogger logger);
 
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_GetStepTrace(SUNContext sunctx, SUNStepTrace* trace);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_SetStepTrace(SUNContext sunctx, SUNStepTrace trace);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_SetScratchSharing(SUNContext sunctx,
+                                        sunbooleantype onoff);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_GetScratchSharing(SUNContext sunctx,
+                                        sunbooleantype* onoff);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_GetScratchSpace(SUNContext sunctx, long int* nvectors,
+                                      long int* lenrw, long int* leniw);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_FreeScratchVectors(SUNContext sunctx);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_GetMemoryUsage(SUNContext sunctx,
+                                     SUNMemorySubsystem subsystem,
+                                     size_t* current, size_t* peak);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_ResetMemoryPeaks(SUNContext sunctx);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNContext_PrintMemoryUsage(SUNContext sunctx, FILE* outfile,
+                                       SUNOutputFormat fmt);
+
 SUNDIALS_EXPORT
 SUNErrCode SUNContext_Free(SUNContext* ctx);
 
@@ -28,6 +28,7 @@
 #include <sundials/sundials_nonlinearsolver.h>
 #include <sundials/sundials_nvector.h>
 #include <sundials/sundials_profiler.h>
+#include <sundials/sundials_steptrace.h>
 #include <sundials/sundials_types.h>
 #include <sundials/sundials_version.h>
 
@@ -62,6 +62,10 @@ extern "C" {
  * if the corresponding call to SUNDlsMat_DenseGETRF did not fail.
  * SUNDlsMat_DenseGETRS does NOT check for a square matrix!
  *
+ * SUNDlsMat_denseGETRSMulti solves the system for each of the nrhs
+ * right-hand sides b[j], applying each column of the factors to all of them
+ * in turn. The results are identical to those of SUNDlsMat_denseGETRS.
+ *
  * ----------------------------------------------------------------------------
  * SUNDlsMat_DenseGETRF and SUNDlsMat_DenseGETRS are simply wrappers around
  * SUNDlsMat_denseGETRF and SUNDlsMat_denseGETRS, respectively, which perform all the
@@ -83,6 +87,10 @@ SUNDIALS_EXPORT
 void SUNDlsMat_denseGETRS(sunrealtype** a, sunindextype n, sunindextype* p,
                           sunrealtype* b);
 
+SUNDIALS_EXPORT
+void SUNDlsMat_denseGETRSMulti(sunrealtype** a, sunindextype n, sunindextype* p,
+                               int nrhs, sunrealtype** b);
+
 /*
  * ----------------------------------------------------------------------------
  * Functions : SUNDlsMat_DensePOTRF and SUNDlsMat_DensePOTRS
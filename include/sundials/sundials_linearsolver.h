@@ -128,6 +128,9 @@ struct _generic_SUNLinearSolver_Ops
   SUNErrCode (*space)(SUNLinearSolver, long int*, long int*);
   N_Vector (*resid)(SUNLinearSolver);
   SUNErrCode (*free)(SUNLinearSolver);
+  SUNErrCode (*scratchspace)(SUNLinearSolver, long int*, long int*);
+  int (*solvemulti)(SUNLinearSolver, SUNMatrix, int, N_Vector*, N_Vector*,
+                    sunrealtype);
 };
 
 /* A linear solver is a structure with an implementation-dependent
@@ -181,6 +184,10 @@ SUNDIALS_EXPORT
 int SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
                    sunrealtype tol);
 
+SUNDIALS_EXPORT
+int SUNLinSolSolveMulti(SUNLinearSolver S, SUNMatrix A, int nrhs, N_Vector* X,
+                        N_Vector* B, sunrealtype tol);
+
 /* TODO(CJB): We should consider changing the return type to long int since
  batched solvers could in theory return a very large number here. */
 SUNDIALS_EXPORT
@@ -201,6 +208,10 @@ SUNDIALS_EXPORT
 SUNErrCode SUNLinSolSpace(SUNLinearSolver S, long int* lenrwLS,
                           long int* leniwLS);
 
+SUNDIALS_EXPORT
+SUNErrCode SUNLinSolScratchSpace(SUNLinearSolver S, long int* lenrwLS,
+                                 long int* leniwLS);
+
 SUNDIALS_EXPORT
 SUNErrCode SUNLinSolFree(SUNLinearSolver S);
 
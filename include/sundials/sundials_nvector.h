@@ -329,6 +329,11 @@ SUNDIALS_EXPORT N_Vector* N_VCloneEmptyVectorArray(int count, N_Vector w);
 SUNDIALS_EXPORT N_Vector* N_VCloneVectorArray(int count, N_Vector w);
 SUNDIALS_EXPORT void N_VDestroyVectorArray(N_Vector* vs, int count);
 
+/* Borrow and return vectors from the scratch pool of the SUNContext */
+SUNDIALS_EXPORT SUNErrCode N_VBorrowScratchVectorArray(int count, N_Vector w,
+                                                       N_Vector* vs);
+SUNDIALS_EXPORT SUNErrCode N_VReturnScratchVectorArray(int count, N_Vector* vs);
+
 /* These function are really only for users of the Fortran interface */
 SUNDIALS_EXPORT N_Vector N_VGetVecAtIndexVectorArray(N_Vector* vs, int index);
 SUNDIALS_EXPORT void N_VSetVecAtIndexVectorArray(N_Vector* vs, int index,
@@ -42,6 +42,7 @@ struct _N_VectorContent_SensWrapper
   N_Vector* vecs;          /* array of wrapped vectors                */
   int nvecs;               /* number of wrapped vectors               */
   sunbooleantype own_vecs; /* flag indicating if wrapper owns vectors */
+  sunrealtype* cvals;      /* nvecs scalars for fused vector ops      */
 };
 
 typedef struct _N_VectorContent_SensWrapper* N_VectorContent_SensWrapper;
@@ -55,6 +56,7 @@ typedef struct _N_VectorContent_SensWrapper* N_VectorContent_SensWrapper;
 #define NV_NVECS_SW(v)    (NV_CONTENT_SW(v)->nvecs)
 #define NV_OWN_VECS_SW(v) (NV_CONTENT_SW(v)->own_vecs)
 #define NV_VEC_SW(v, i)   (NV_VECS_SW(v)[i])
+#define NV_CVALS_SW(v)    (NV_CONTENT_SW(v)->cvals)
 
 /*==============================================================================
   PART III: Exported functions
@@ -0,0 +1,70 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * SUNDIALS Parareal class. A Parareal object integrates an IVP over
+ * a time interval split into slices with a sequential coarse
+ * SUNStepper and concurrent fine SUNStepper solves distributed over
+ * OpenMP threads and, optionally, the ranks of an MPI communicator.
+ * ----------------------------------------------------------------*/
+
+#ifndef _SUNDIALS_PARAREAL_H
+#define _SUNDIALS_PARAREAL_H
+
+#include <sundials/sundials_core.h>
+#include <sundials/sundials_stepper.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef _SUNDIALS_STRUCT_ SUNParareal_* SUNParareal;
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_Create(SUNStepper coarse, SUNStepper* fine, int nfine,
+                              SUNContext sunctx, SUNParareal* pr_out);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_SetNumSlices(SUNParareal pr, int nslices);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_SetMaxIters(SUNParareal pr, int maxiters);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_SetTolerances(SUNParareal pr, sunrealtype rtol,
+                                     sunrealtype atol);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_SetTimeComm(SUNParareal pr, SUNComm comm);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_Evolve(SUNParareal pr, sunrealtype t0, N_Vector y0,
+                              sunrealtype tf, N_Vector yf);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_GetNumIters(SUNParareal pr, int* niters);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_GetNumFineSolves(SUNParareal pr, long int* nfine);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_GetNumCoarseSolves(SUNParareal pr, long int* ncoarse);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_GetMaxChange(SUNParareal pr, sunrealtype* change);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNParareal_Destroy(SUNParareal* pr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SUNDIALS_PARAREAL_H */
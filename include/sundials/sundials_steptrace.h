@@ -0,0 +1,83 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * SUNDIALS step trace class. A step trace records one fixed-size
+ * binary record per internal step (or nonlinear iteration) taken by
+ * the SUNDIALS packages into a ring buffer backed by a file.
+ * ----------------------------------------------------------------*/
+
+#ifndef _SUNDIALS_STEPTRACE_H
+#define _SUNDIALS_STEPTRACE_H
+
+#include <stdint.h>
+#include <sundials/sundials_config.h>
+#include <sundials/sundials_types.h>
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/* Version of the binary trace file layout */
+#define SUN_STEPTRACE_VERSION 1
+
+/* Packages that write step trace records */
+typedef enum
+{
+  SUN_STEPTRACE_ARKODE,
+  SUN_STEPTRACE_CVODE,
+  SUN_STEPTRACE_CVODES,
+  SUN_STEPTRACE_IDA,
+  SUN_STEPTRACE_IDAS,
+  SUN_STEPTRACE_KINSOL
+} SUNStepTraceSolverID;
+
+/* A single step trace record. The layout uses fixed-width types so that the
+   trace file does not depend on the precision or index size SUNDIALS was built
+   with. All counters hold the number of events during the recorded step. */
+typedef struct
+{
+  double t;          /* time reached by the step (KINSOL: scaled fnorm)   */
+  double h;          /* step size used (KINSOL: scaled Newton step norm)  */
+  int64_t step;      /* step (KINSOL: nonlinear iteration) number         */
+  int32_t solver;    /* SUNStepTraceSolverID of the writer                */
+  int32_t flag;      /* return flag of the step                           */
+  int32_t order;     /* method order used for the step (0 if not defined) */
+  int32_t netf;      /* error test failures                               */
+  int32_t ncfn;      /* nonlinear solver convergence failures             */
+  int32_t nni;       /* nonlinear solver iterations                       */
+  int32_t nli;       /* linear solver iterations                          */
+  int32_t nsetups;   /* linear solver setup calls                         */
+  int32_t njevals;   /* Jacobian evaluations                              */
+  int32_t reserved;  /* padding, always zero                              */
+} SUNStepTraceRecord;
+
+SUNDIALS_EXPORT
+SUNErrCode SUNStepTrace_Create(const char* filename, int64_t capacity,
+                               SUNStepTrace* trace_out);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNStepTrace_Record(SUNStepTrace trace,
+                               const SUNStepTraceRecord* record);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNStepTrace_GetNumRecords(SUNStepTrace trace, int64_t* nrecords);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNStepTrace_Flush(SUNStepTrace trace);
+
+SUNDIALS_EXPORT
+SUNErrCode SUNStepTrace_Destroy(SUNStepTrace* trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SUNDIALS_STEPTRACE_H */
@@ -166,6 +166,24 @@ typedef enum
   SUN_OUTPUTFORMAT_CSV
 } SUNOutputFormat;
 
+/*
+ *------------------------------------------------------------------
+ * Type : SUNMemorySubsystem
+ *------------------------------------------------------------------
+ * Categories for the memory accounting in a SUNContext
+ *------------------------------------------------------------------
+ */
+
+typedef enum
+{
+  SUN_MEMSUBSYSTEM_NVECTOR,
+  SUN_MEMSUBSYSTEM_MATRIX,
+  SUN_MEMSUBSYSTEM_LINEARSOLVER,
+  SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+  SUN_MEMSUBSYSTEM_INTEGRATOR,
+  SUN_MEMSUBSYSTEM_TOTAL
+} SUNMemorySubsystem;
+
 /*
  *------------------------------------------------------------------
  * Type : SUNErrCode
@@ -192,6 +210,9 @@ typedef struct SUNProfiler_* SUNProfiler;
 /* SUNDIALS logger */
 typedef struct SUNLogger_* SUNLogger;
 
+/* SUNDIALS step trace */
+typedef struct SUNStepTrace_* SUNStepTrace;
+
 /* -----------------------------------------------------------------------------
  * SUNDIALS function types
  * ---------------------------------------------------------------------------*/
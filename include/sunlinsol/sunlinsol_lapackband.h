@@ -42,6 +42,8 @@ struct _SUNLinearSolverContent_LapackBand
   sunindextype N;
   sunindextype* pivots;
   sunindextype last_flag;
+  sunrealtype* rhs; /* contiguous right-hand sides for SolveMulti */
+  int nrhs;         /* number of columns allocated in rhs        */
 };
 
 typedef struct _SUNLinearSolverContent_LapackBand* SUNLinearSolverContent_LapackBand;
@@ -59,6 +61,10 @@ SUNDIALS_EXPORT int SUNLinSolSetup_LapackBand(SUNLinearSolver S, SUNMatrix A);
 SUNDIALS_EXPORT int SUNLinSolSolve_LapackBand(SUNLinearSolver S, SUNMatrix A,
                                               N_Vector x, N_Vector b,
                                               sunrealtype tol);
+SUNDIALS_EXPORT int SUNLinSolSolveMulti_LapackBand(SUNLinearSolver S,
+                                                   SUNMatrix A, int nrhs,
+                                                   N_Vector* X, N_Vector* B,
+                                                   sunrealtype tol);
 SUNDIALS_EXPORT sunindextype SUNLinSolLastFlag_LapackBand(SUNLinearSolver S);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolSpace_LapackBand(SUNLinearSolver S,
                                                      long int* lenrwLS,
@@ -42,6 +42,8 @@ struct _SUNLinearSolverContent_LapackDense
   sunindextype N;
   sunindextype* pivots;
   sunindextype last_flag;
+  sunrealtype* rhs; /* contiguous right-hand sides for SolveMulti */
+  int nrhs;         /* number of columns allocated in rhs        */
 };
 
 typedef struct _SUNLinearSolverContent_LapackDense* SUNLinearSolverContent_LapackDense;
@@ -59,6 +61,10 @@ SUNDIALS_EXPORT int SUNLinSolSetup_LapackDense(SUNLinearSolver S, SUNMatrix A);
 SUNDIALS_EXPORT int SUNLinSolSolve_LapackDense(SUNLinearSolver S, SUNMatrix A,
                                                N_Vector x, N_Vector b,
                                                sunrealtype tol);
+SUNDIALS_EXPORT int SUNLinSolSolveMulti_LapackDense(SUNLinearSolver S,
+                                                    SUNMatrix A, int nrhs,
+                                                    N_Vector* X, N_Vector* B,
+                                                    sunrealtype tol);
 SUNDIALS_EXPORT sunindextype SUNLinSolLastFlag_LapackDense(SUNLinearSolver S);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolSpace_LapackDense(SUNLinearSolver S,
                                                       long int* lenrwLS,
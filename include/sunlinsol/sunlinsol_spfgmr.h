@@ -74,6 +74,8 @@ struct _SUNLinearSolverContent_SPFGMR
 
   sunrealtype* cv;
   N_Vector* Xv;
+
+  sunbooleantype scratch_V; /* borrow V and Z from the SUNContext in solves */
 };
 
 typedef struct _SUNLinearSolverContent_SPFGMR* SUNLinearSolverContent_SPFGMR;
@@ -116,6 +118,9 @@ SUNDIALS_EXPORT sunindextype SUNLinSolLastFlag_SPFGMR(SUNLinearSolver S);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolSpace_SPFGMR(SUNLinearSolver S,
                                                  long int* lenrwLS,
                                                  long int* leniwLS);
+SUNDIALS_EXPORT SUNErrCode SUNLinSolScratchSpace_SPFGMR(SUNLinearSolver S,
+                                                        long int* lenrwLS,
+                                                        long int* leniwLS);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolFree_SPFGMR(SUNLinearSolver S);
 
 #ifdef __cplusplus
@@ -74,6 +74,16 @@ struct _SUNLinearSolverContent_SPGMR
 
   sunrealtype* cv;
   N_Vector* Xv;
+
+  sunbooleantype scratch_V; /* borrow V from the SUNContext during solves */
+
+  /* block GMRES workspace for SUNLinSolSolveMulti, grown as needed */
+  int nrhs;         /* right-hand sides supported by V_b, Xv_b, w_b   */
+  N_Vector* V_b;    /* block Krylov basis followed by the residuals   */
+  N_Vector* Xv_b;   /* vectors for fused vector ops in block solves   */
+  sunrealtype* w_b; /* residual coefficients and fused op scalars     */
+  long int lh_b;    /* length of h_b                                  */
+  sunrealtype* h_b; /* block Hessenberg matrices and Givens rotations */
 };
 
 typedef struct _SUNLinearSolverContent_SPGMR* SUNLinearSolverContent_SPGMR;
@@ -108,6 +118,9 @@ SUNDIALS_EXPORT SUNErrCode SUNLinSolSetZeroGuess_SPGMR(SUNLinearSolver S,
 SUNDIALS_EXPORT int SUNLinSolSetup_SPGMR(SUNLinearSolver S, SUNMatrix A);
 SUNDIALS_EXPORT int SUNLinSolSolve_SPGMR(SUNLinearSolver S, SUNMatrix A,
                                          N_Vector x, N_Vector b, sunrealtype tol);
+SUNDIALS_EXPORT int SUNLinSolSolveMulti_SPGMR(SUNLinearSolver S, SUNMatrix A,
+                                              int nrhs, N_Vector* X,
+                                              N_Vector* B, sunrealtype tol);
 SUNDIALS_EXPORT int SUNLinSolNumIters_SPGMR(SUNLinearSolver S);
 SUNDIALS_EXPORT sunrealtype SUNLinSolResNorm_SPGMR(SUNLinearSolver S);
 SUNDIALS_EXPORT N_Vector SUNLinSolResid_SPGMR(SUNLinearSolver S);
@@ -115,6 +128,9 @@ SUNDIALS_EXPORT sunindextype SUNLinSolLastFlag_SPGMR(SUNLinearSolver S);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolSpace_SPGMR(SUNLinearSolver S,
                                                 long int* lenrwLS,
                                                 long int* leniwLS);
+SUNDIALS_EXPORT SUNErrCode SUNLinSolScratchSpace_SPGMR(SUNLinearSolver S,
+                                                       long int* lenrwLS,
+                                                       long int* leniwLS);
 SUNDIALS_EXPORT SUNErrCode SUNLinSolFree_SPGMR(SUNLinearSolver S);
 
 #ifdef __cplusplus
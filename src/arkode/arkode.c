@@ -30,6 +30,7 @@
 
 #include "arkode_impl.h"
 #include "arkode_interp_impl.h"
+#include "arkode_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
 #include "sundials/sundials_context.h"
 #include "sundials/sundials_logger.h"
@@ -644,6 +645,8 @@ int ARKodeEvolve(void* arkode_mem, sunrealtype tout, N_Vector yout,
   sunrealtype dsm;
   int nflag, ncf, nef, constrfails;
   int relax_fails;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
   ARKodeMem ark_mem;
 
   /* used only with debugging logging */
@@ -867,6 +870,10 @@ int ARKodeEvolve(void* arkode_mem, sunrealtype tout, N_Vector yout,
       }
     }
 
+    /* Sample counters for the step trace (if enabled) */
+    trace = ARK_STEPTRACE;
+    if (trace) { arkStepTraceCounters(ark_mem, trace_start); }
+
     /* Looping point for step attempts */
     dsm      = ZERO;
     kflag    = ARK_SUCCESS;
@@ -977,6 +984,10 @@ int ARKodeEvolve(void* arkode_mem, sunrealtype tout, N_Vector yout,
       /* unsuccessful step, if |h| = hmin, return ARK_ERR_FAILURE */
       if (SUNRabs(ark_mem->h) <= ark_mem->hmin * ONEPSM)
       {
+        if (trace)
+        {
+          arkStepTraceRecord(ark_mem, trace, ARK_ERR_FAILURE, trace_start);
+        }
         SUNDIALS_MARK_FUNCTION_END(ARK_PROFILER);
         return (ARK_ERR_FAILURE);
       }
@@ -992,6 +1003,9 @@ int ARKodeEvolve(void* arkode_mem, sunrealtype tout, N_Vector yout,
        (added stuff from arkStep_PrepareNextStep -- revisit) */
     if (kflag == ARK_SUCCESS) { kflag = arkCompleteStep(ark_mem, dsm); }
 
+    /* Record the step in the step trace (if enabled) */
+    if (trace) { arkStepTraceRecord(ark_mem, trace, kflag, trace_start); }
+
     /* If step attempt loop failed, process flag and return to user */
     if (kflag != ARK_SUCCESS)
     {
@@ -1258,6 +1272,11 @@ void ARKodeFree(void** arkode_mem)
     ark_mem->relax_mem = NULL;
   }
 
+  /* free the discrete adjoint data */
+  if (ark_mem->adj_mem) { arkAdjFree(&ark_mem->adj_mem); }
+
+  sunMemAccountFree(ark_mem->sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct ARKodeMemRec));
   free(*arkode_mem);
   *arkode_mem = NULL;
 }
@@ -1484,6 +1503,8 @@ ARKodeMem arkCreate(SUNContext sunctx)
 
   /* Set the context */
   ark_mem->sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct ARKodeMemRec));
 
   /* Set uround */
   ark_mem->uround = SUN_UNIT_ROUNDOFF;
@@ -1495,6 +1516,7 @@ ARKodeMem arkCreate(SUNContext sunctx)
   ark_mem->step_disablemsetup             = NULL;
   ark_mem->step_getlinmem                 = NULL;
   ark_mem->step_getmassmem                = NULL;
+  ark_mem->step_getadjointdata            = NULL;
   ark_mem->step_getimplicitrhs            = NULL;
   ark_mem->step_mmult                     = NULL;
   ark_mem->step_getgammas                 = NULL;
@@ -1554,6 +1576,9 @@ ARKodeMem arkCreate(SUNContext sunctx)
   ark_mem->relax_enabled = SUNFALSE;
   ark_mem->relax_mem     = NULL;
 
+  /* Initialize discrete adjoint variables */
+  ark_mem->adj_mem = NULL;
+
   /* Initialize lrw and liw */
   ark_mem->lrw = 18;
   ark_mem->liw = 53; /* fcn/data ptr, int, long int, sunindextype, sunbooleantype */
@@ -1822,6 +1847,9 @@ int arkInit(ARKodeMem ark_mem, sunrealtype t0, N_Vector y0, int init_type)
     ark_mem->initialized = SUNFALSE;
   }
 
+  /* Discard recorded steps of a previous integration */
+  if (ark_mem->adj_mem) { arkAdjClearHistory(ark_mem->adj_mem); }
+
   /* Indicate initialization is needed */
   ark_mem->initsetup  = SUNTRUE;
   ark_mem->init_type  = init_type;
@@ -2649,6 +2677,16 @@ int arkCompleteStep(ARKodeMem ark_mem, sunrealtype dsm)
     if (retval != ARK_SUCCESS) { return (retval); }
   }
 
+  /* record the step for the discrete adjoint
+
+     NOTE: This must be called before updating yn with ycur as the checkpoint
+     holds the solution from the start of this step */
+  if (ark_mem->adj_mem != NULL)
+  {
+    retval = arkAdjRecordStep(ark_mem);
+    if (retval != ARK_SUCCESS) { return (retval); }
+  }
+
   /* update yn to current solution */
   N_VScale(ONE, ark_mem->ycur, ark_mem->yn);
   ark_mem->fn_is_current = SUNFALSE;
@@ -2805,6 +2843,10 @@ int arkHandleFailure(ARKodeMem ark_mem, int flag)
     arkProcessError(ark_mem, ARK_SUNSTEPPER_ERR, __LINE__, __func__, __FILE__,
                     "An inner SUNStepper error occurred");
     break;
+  case ARK_ADJ_CHECKPOINT_FAIL:
+    arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                    __FILE__, "Recording the step for the adjoint failed");
+    break;
   default:
     /* This return should never happen */
     arkProcessError(ark_mem, ARK_UNRECOGNIZED_ERROR, __LINE__, __func__, __FILE__,
@@ -2817,6 +2859,87 @@ int arkHandleFailure(ARKodeMem ark_mem, int flag)
   return (flag);
 }
 
+/*---------------------------------------------------------------
+  arkStepTraceCounters
+
+  This routine samples the cumulative integrator, nonlinear solver
+  and linear solver counters that are differenced to form a step
+  trace record. Counters that are not supported by the time
+  stepper module are set to zero.
+  ---------------------------------------------------------------*/
+void arkStepTraceCounters(ARKodeMem ark_mem, long int counters[])
+{
+  ARKLsMem arkls_mem = NULL;
+  long int count     = 0;
+
+  counters[SUN_STEPTRACE_NETF]    = ark_mem->netf;
+  counters[SUN_STEPTRACE_NCFN]    = ark_mem->ncfn;
+  counters[SUN_STEPTRACE_NNI]     = 0;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NSETUPS] = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  if (ark_mem->step_getnumnonlinsolviters)
+  {
+    if (!ark_mem->step_getnumnonlinsolviters(ark_mem, &count))
+    {
+      counters[SUN_STEPTRACE_NNI] = count;
+    }
+  }
+
+  if (ark_mem->step_getnumlinsolvsetups)
+  {
+    if (!ark_mem->step_getnumlinsolvsetups(ark_mem, &count))
+    {
+      counters[SUN_STEPTRACE_NSETUPS] = count;
+    }
+  }
+
+  if (ark_mem->step_getlinmem)
+  {
+    arkls_mem = (ARKLsMem)ark_mem->step_getlinmem(ark_mem);
+    if (arkls_mem)
+    {
+      counters[SUN_STEPTRACE_NLI]     = arkls_mem->nli;
+      counters[SUN_STEPTRACE_NJEVALS] = arkls_mem->nje;
+    }
+  }
+}
+
+/*---------------------------------------------------------------
+  arkStepTraceRecord
+
+  This routine writes a record for the step just attempted to
+  trace, the step trace that was attached to the SUNContext when
+  the counters in start were sampled. On failure the record holds
+  the step size of the last attempt.
+  ---------------------------------------------------------------*/
+void arkStepTraceRecord(ARKodeMem ark_mem, SUNStepTrace trace, int kflag,
+                        const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  arkStepTraceCounters(ark_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_ARKODE, start, end);
+
+  record.t     = (double)ark_mem->tcur;
+  record.flag  = kflag;
+  record.order = (ark_mem->hadapt_mem) ? ark_mem->hadapt_mem->q : 0;
+  if (kflag == ARK_SUCCESS)
+  {
+    record.h    = (double)ark_mem->hold;
+    record.step = ark_mem->nst;
+  }
+  else
+  {
+    record.h    = (double)ark_mem->h;
+    record.step = ark_mem->nst + 1;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
 /*---------------------------------------------------------------
   arkEwtSetSS
 
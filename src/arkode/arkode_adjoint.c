@@ -0,0 +1,949 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * This is the implementation file for ARKODE's discrete adjoint functionality
+ * for explicit and diagonally implicit Runge--Kutta methods.
+ *
+ * For a step y_{n+1} = y_n + h sum_i b_i k_i with stages
+ * k_i = f(t_n + c_i h, Y_i) and Y_i = y_n + h sum_j a_ij k_j, the adjoint step
+ * computes, for i = s, ..., 1,
+ *
+ *   (I - h a_ii J_i^T) kappa_i = h b_i lambda_{n+1} + h sum_{j>i} a_ji theta_j
+ *   theta_i = J_i^T kappa_i
+ *
+ * and sets lambda_n = lambda_{n+1} + sum_i theta_i and
+ * mu_n = mu_{n+1} + sum_i (df/dp)_i^T kappa_i, where J_i = df/dy(t_i, Y_i).
+ * For explicit methods a_ii = 0 and no linear systems are solved.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sunlinsol/sunlinsol_spgmr.h>
+
+#include "arkode_impl.h"
+#include "arkode_adjoint_impl.h"
+
+/* =============================================================================
+ * Private Functions
+ * ===========================================================================*/
+
+/* Access the ARKODE and discrete adjoint memory structures */
+static int arkAdjAccessMem(void* arkode_mem, const char* fname,
+                           ARKodeMem* ark_mem, ARKodeAdjMem* adj_mem)
+{
+  if (!arkode_mem)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return ARK_MEM_NULL;
+  }
+  *ark_mem = (ARKodeMem)arkode_mem;
+
+  if (!((*ark_mem)->adj_mem))
+  {
+    arkProcessError(*ark_mem, ARK_ADJ_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ADJ_MEM_NULL);
+    return ARK_ADJ_MEM_NULL;
+  }
+  *adj_mem = (*ark_mem)->adj_mem;
+
+  return ARK_SUCCESS;
+}
+
+/* Copy a vector into a new clone */
+static N_Vector arkAdjCopy(N_Vector y)
+{
+  N_Vector x = N_VClone(y);
+  if (x) { N_VScale(ONE, y, x); }
+  return x;
+}
+
+/* Grow the step and checkpoint arrays to hold nsteps + 1 steps */
+static int arkAdjGrow(ARKodeAdjMem adj_mem)
+{
+  long int n, i;
+  sunrealtype* rtmp;
+  N_Vector* vtmp;
+  N_Vector** atmp;
+
+  if (adj_mem->nsteps + 2 > adj_mem->nalloc)
+  {
+    n    = SUNMAX(2 * adj_mem->nalloc, 64);
+    rtmp = (sunrealtype*)realloc(adj_mem->t, n * sizeof(sunrealtype));
+    if (rtmp == NULL) { return ARK_MEM_FAIL; }
+    adj_mem->t = rtmp;
+    rtmp       = (sunrealtype*)realloc(adj_mem->h, n * sizeof(sunrealtype));
+    if (rtmp == NULL) { return ARK_MEM_FAIL; }
+    adj_mem->h      = rtmp;
+    adj_mem->nalloc = n;
+  }
+
+  if (adj_mem->nck + 1 > adj_mem->ckalloc)
+  {
+    n    = SUNMAX(2 * adj_mem->ckalloc, 16);
+    vtmp = (N_Vector*)realloc(adj_mem->ckY, n * sizeof(N_Vector));
+    if (vtmp == NULL) { return ARK_MEM_FAIL; }
+    adj_mem->ckY = vtmp;
+    atmp         = (N_Vector**)realloc(adj_mem->ckF, n * sizeof(N_Vector*));
+    if (atmp == NULL) { return ARK_MEM_FAIL; }
+    adj_mem->ckF = atmp;
+    for (i = adj_mem->ckalloc; i < n; i++)
+    {
+      adj_mem->ckY[i] = NULL;
+      adj_mem->ckF[i] = NULL;
+    }
+    adj_mem->ckalloc = n;
+  }
+
+  return ARK_SUCCESS;
+}
+
+/* Free the work vectors that depend on the number of stages */
+static void arkAdjFreeWork(ARKodeAdjMem adj_mem)
+{
+  long int i;
+
+  if (adj_mem->cacheY)
+  {
+    for (i = 0; i < adj_mem->interval; i++)
+    {
+      N_VDestroy(adj_mem->cacheY[i]);
+      N_VDestroyVectorArray(adj_mem->cacheF[i], adj_mem->stages);
+    }
+    free(adj_mem->cacheY);
+    free(adj_mem->cacheF);
+    adj_mem->cacheY = NULL;
+    adj_mem->cacheF = NULL;
+  }
+  adj_mem->cache_ck = -1;
+
+  if (adj_mem->theta)
+  {
+    N_VDestroyVectorArray(adj_mem->theta, adj_mem->stages);
+    adj_mem->theta = NULL;
+  }
+  free(adj_mem->cvals);
+  free(adj_mem->Xvecs);
+  adj_mem->cvals = NULL;
+  adj_mem->Xvecs = NULL;
+}
+
+/* Allocate the backward integration work space */
+static int arkAdjAllocWork(ARKodeMem ark_mem)
+{
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+  int s                = adj_mem->stages;
+  long int i;
+
+  if (adj_mem->theta == NULL)
+  {
+    adj_mem->theta = N_VCloneVectorArray(s, ark_mem->yn);
+    adj_mem->cvals = (sunrealtype*)malloc((s + 1) * sizeof(sunrealtype));
+    adj_mem->Xvecs = (N_Vector*)malloc((s + 1) * sizeof(N_Vector));
+    if (!adj_mem->theta || !adj_mem->cvals || !adj_mem->Xvecs)
+    {
+      return ARK_MEM_FAIL;
+    }
+  }
+
+  if (adj_mem->kappa == NULL)
+  {
+    adj_mem->kappa  = N_VClone(ark_mem->yn);
+    adj_mem->rhs    = N_VClone(ark_mem->yn);
+    adj_mem->ystage = N_VClone(ark_mem->yn);
+    adj_mem->lambda = N_VClone(ark_mem->yn);
+    if (!adj_mem->kappa || !adj_mem->rhs || !adj_mem->ystage ||
+        !adj_mem->lambda)
+    {
+      return ARK_MEM_FAIL;
+    }
+  }
+
+  if (adj_mem->mu && adj_mem->fp_vjp && adj_mem->mutmp == NULL)
+  {
+    adj_mem->mutmp = N_VClone(adj_mem->mu);
+    if (!adj_mem->mutmp) { return ARK_MEM_FAIL; }
+  }
+
+  if (!adj_mem->save_stages && adj_mem->cacheY == NULL)
+  {
+    adj_mem->cacheY = (N_Vector*)calloc(adj_mem->interval, sizeof(N_Vector));
+    adj_mem->cacheF = (N_Vector**)calloc(adj_mem->interval, sizeof(N_Vector*));
+    if (!adj_mem->cacheY || !adj_mem->cacheF) { return ARK_MEM_FAIL; }
+    for (i = 0; i < adj_mem->interval; i++)
+    {
+      adj_mem->cacheY[i] = N_VClone(ark_mem->yn);
+      adj_mem->cacheF[i] = N_VCloneVectorArray(s, ark_mem->yn);
+      if (!adj_mem->cacheY[i] || !adj_mem->cacheF[i]) { return ARK_MEM_FAIL; }
+    }
+    adj_mem->ysave    = N_VClone(ark_mem->yn);
+    adj_mem->ycursave = N_VClone(ark_mem->yn);
+    if (!adj_mem->ysave || !adj_mem->ycursave) { return ARK_MEM_FAIL; }
+  }
+
+  return ARK_SUCCESS;
+}
+
+/* Operator of the DIRK stage adjoint systems, z = v - h a_ii J^T v */
+static int arkAdjATimes(void* A_data, N_Vector v, N_Vector z)
+{
+  int retval;
+  ARKodeMem ark_mem    = (ARKodeMem)A_data;
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+
+  retval = adj_mem->fy_vjp(adj_mem->tstage, adj_mem->ystage, v, z,
+                           ark_mem->user_data);
+  adj_mem->nvjp++;
+  if (retval != 0) { return retval; }
+
+  N_VLinearSum(ONE, v, -adj_mem->gamma, z, z);
+
+  return 0;
+}
+
+/* Recompute the forward steps from checkpoint ck, storing the solution at the
+   start of each step and the stage right-hand sides in the cache. The forward
+   solution and the user output vector are restored afterwards. */
+static int arkAdjRecompute(ARKodeMem ark_mem, long int ck)
+{
+  int retval, nflag, i;
+  long int first, last, j;
+  sunrealtype dsm, tn, tcur, h;
+  sunbooleantype initsetup, firststage;
+  ARKodeButcherTable B;
+  N_Vector* F;
+  sunbooleantype implicit;
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+
+  first = ck * adj_mem->interval;
+  last  = SUNMIN(first + adj_mem->interval, adj_mem->nsteps);
+
+  /* save the forward state */
+  tn         = ark_mem->tn;
+  tcur       = ark_mem->tcur;
+  h          = ark_mem->h;
+  initsetup  = ark_mem->initsetup;
+  firststage = ark_mem->firststage;
+  N_VScale(ONE, ark_mem->yn, adj_mem->ysave);
+  N_VScale(ONE, ark_mem->ycur, adj_mem->ycursave);
+
+  N_VScale(ONE, adj_mem->ckY[ck], ark_mem->yn);
+  adj_mem->cache_ck = -1;
+
+  retval = ARK_SUCCESS;
+  for (j = first; j < last; j++)
+  {
+    /* take the recorded step with a fresh start (trivial predictor, new
+       right-hand side at the start of the step, fresh linear solver setup
+       for the first step) */
+    ark_mem->tn            = adj_mem->t[j];
+    ark_mem->tcur          = adj_mem->t[j];
+    ark_mem->h             = adj_mem->h[j];
+    ark_mem->initsetup     = SUNTRUE;
+    ark_mem->firststage    = (j == first);
+    ark_mem->fn_is_current = SUNFALSE;
+    (void)ark_mem->efun(ark_mem->yn, ark_mem->ewt, ark_mem->e_data);
+
+    N_VScale(ONE, ark_mem->yn, adj_mem->cacheY[j - first]);
+
+    nflag  = ARK_SUCCESS;
+    retval = ark_mem->step(ark_mem, &dsm, &nflag);
+    if (retval == ARK_SUCCESS && nflag != ARK_SUCCESS) { retval = nflag; }
+    if (retval != ARK_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                      __FILE__,
+                      "Recomputing the step at " MSG_TIME_H " failed (%i)",
+                      adj_mem->t[j], adj_mem->h[j], retval);
+      retval = ARK_ADJ_CHECKPOINT_FAIL;
+      break;
+    }
+
+    retval = ark_mem->step_getadjointdata(ark_mem, &B, &F, &implicit);
+    if (retval != ARK_SUCCESS) { break; }
+    for (i = 0; i < adj_mem->stages; i++)
+    {
+      N_VScale(ONE, F[i], adj_mem->cacheF[j - first][i]);
+    }
+
+    N_VScale(ONE, ark_mem->ycur, ark_mem->yn);
+    adj_mem->nrecomp++;
+  }
+
+  /* restore the forward state */
+  ark_mem->tn            = tn;
+  ark_mem->tcur          = tcur;
+  ark_mem->h             = h;
+  ark_mem->initsetup     = initsetup;
+  ark_mem->firststage    = firststage;
+  ark_mem->fn_is_current = SUNFALSE;
+  N_VScale(ONE, adj_mem->ysave, ark_mem->yn);
+  N_VScale(ONE, adj_mem->ycursave, ark_mem->ycur);
+  (void)ark_mem->efun(ark_mem->yn, ark_mem->ewt, ark_mem->e_data);
+
+  if (retval == ARK_SUCCESS) { adj_mem->cache_ck = ck; }
+
+  return retval;
+}
+
+/* Take one adjoint step over the recorded forward step n */
+static int arkAdjStep(ARKodeMem ark_mem, long int n)
+{
+  int retval, i, j, nvec;
+  long int ck;
+  sunrealtype h, tol;
+  sunbooleantype implicit;
+  ARKodeButcherTable B;
+  N_Vector yn;
+  N_Vector* F;
+  N_Vector* Fst;
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+  sunrealtype* cvals   = adj_mem->cvals;
+  N_Vector* Xvecs      = adj_mem->Xvecs;
+
+  retval = ark_mem->step_getadjointdata(ark_mem, &B, &Fst, &implicit);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  /* solution and stage right-hand sides at step n */
+  if (adj_mem->save_stages)
+  {
+    yn = adj_mem->ckY[n];
+    F  = adj_mem->ckF[n];
+  }
+  else
+  {
+    ck = n / adj_mem->interval;
+    if (adj_mem->cache_ck != ck)
+    {
+      retval = arkAdjRecompute(ark_mem, ck);
+      if (retval != ARK_SUCCESS) { return retval; }
+    }
+    yn = adj_mem->cacheY[n - ck * adj_mem->interval];
+    F  = adj_mem->cacheF[n - ck * adj_mem->interval];
+  }
+
+  h = adj_mem->h[n];
+
+  for (i = adj_mem->stages - 1; i >= 0; i--)
+  {
+    /* rhs = h b_i lambda + h sum_{j>i} a_ji theta_j */
+    nvec = 0;
+    if (B->b[i] != ZERO)
+    {
+      cvals[nvec] = h * B->b[i];
+      Xvecs[nvec] = adj_mem->lambda;
+      nvec++;
+    }
+    for (j = i + 1; j < adj_mem->stages; j++)
+    {
+      if (B->A[j][i] != ZERO)
+      {
+        cvals[nvec] = h * B->A[j][i];
+        Xvecs[nvec] = adj_mem->theta[j];
+        nvec++;
+      }
+    }
+
+    /* stages that do not influence the step have no adjoint */
+    if (nvec == 0)
+    {
+      N_VConst(ZERO, adj_mem->theta[i]);
+      continue;
+    }
+
+    retval = N_VLinearCombination(nvec, cvals, Xvecs, adj_mem->rhs);
+    if (retval != 0) { return ARK_VECTOROP_ERR; }
+
+    /* stage solution Y_i = y_n + h sum_j a_ij k_j */
+    nvec        = 0;
+    cvals[nvec] = ONE;
+    Xvecs[nvec] = yn;
+    nvec++;
+    for (j = 0; j <= i; j++)
+    {
+      if (B->A[i][j] != ZERO)
+      {
+        cvals[nvec] = h * B->A[i][j];
+        Xvecs[nvec] = F[j];
+        nvec++;
+      }
+    }
+    retval = N_VLinearCombination(nvec, cvals, Xvecs, adj_mem->ystage);
+    if (retval != 0) { return ARK_VECTOROP_ERR; }
+    adj_mem->tstage = adj_mem->t[n] + B->c[i] * h;
+
+    /* stage adjoint */
+    if (implicit && B->A[i][i] != ZERO)
+    {
+      adj_mem->gamma = h * B->A[i][i];
+      tol = adj_mem->lintol * SUNRsqrt(N_VDotProd(adj_mem->rhs, adj_mem->rhs));
+      if (tol > ZERO)
+      {
+        (void)SUNLinSolSetZeroGuess(adj_mem->LS, SUNTRUE);
+        retval = SUNLinSolSolve(adj_mem->LS, NULL, adj_mem->kappa,
+                                adj_mem->rhs, tol);
+        adj_mem->nliters += SUNLinSolNumIters(adj_mem->LS);
+        if (retval != SUN_SUCCESS)
+        {
+          arkProcessError(ark_mem, ARK_LSOLVE_FAIL, __LINE__, __func__,
+                          __FILE__,
+                          "The adjoint stage solve at " MSG_TIME " failed",
+                          adj_mem->tstage);
+          return ARK_LSOLVE_FAIL;
+        }
+      }
+      else { N_VConst(ZERO, adj_mem->kappa); }
+    }
+    else { N_VScale(ONE, adj_mem->rhs, adj_mem->kappa); }
+
+    /* theta_i = J_i^T kappa_i */
+    retval = adj_mem->fy_vjp(adj_mem->tstage, adj_mem->ystage, adj_mem->kappa,
+                             adj_mem->theta[i], ark_mem->user_data);
+    adj_mem->nvjp++;
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                      "The vector-Jacobian product at " MSG_TIME " failed",
+                      adj_mem->tstage);
+      return ARK_RHSFUNC_FAIL;
+    }
+
+    /* mu += (df/dp)_i^T kappa_i */
+    if (adj_mem->mutmp)
+    {
+      retval = adj_mem->fp_vjp(adj_mem->tstage, adj_mem->ystage,
+                               adj_mem->kappa, adj_mem->mutmp,
+                               ark_mem->user_data);
+      if (retval != 0)
+      {
+        arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__,
+                        __FILE__,
+                        "The parameter vector-Jacobian product at " MSG_TIME
+                        " failed",
+                        adj_mem->tstage);
+        return ARK_RHSFUNC_FAIL;
+      }
+      N_VLinearSum(ONE, adj_mem->mu, ONE, adj_mem->mutmp, adj_mem->mu);
+    }
+  }
+
+  /* lambda_n = lambda_{n+1} + sum_i theta_i */
+  cvals[0] = ONE;
+  Xvecs[0] = adj_mem->lambda;
+  for (i = 0; i < adj_mem->stages; i++)
+  {
+    cvals[i + 1] = ONE;
+    Xvecs[i + 1] = adj_mem->theta[i];
+  }
+  retval = N_VLinearCombination(adj_mem->stages + 1, cvals, Xvecs,
+                                adj_mem->lambda);
+  if (retval != 0) { return ARK_VECTOROP_ERR; }
+
+  adj_mem->cur = n;
+
+  return ARK_SUCCESS;
+}
+
+/* Integrate the adjoint backward over the recorded steps that start at or
+   after tout, or over a single step */
+static int arkAdjEvolve(ARKodeMem ark_mem, sunrealtype tout, N_Vector vret,
+                        sunrealtype* tret, sunbooleantype onestep)
+{
+  int retval;
+  sunrealtype troundoff, dir;
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+
+  if (!adj_mem->started)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The adjoint stepper must be reset with the final "
+                    "condition first");
+    return ARK_ILL_INPUT;
+  }
+
+  if (adj_mem->fy_vjp == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "No vector-Jacobian product function was supplied");
+    return ARK_ILL_INPUT;
+  }
+
+  if (adj_mem->implicit && adj_mem->LS == NULL)
+  {
+    adj_mem->LS = SUNLinSol_SPGMR(ark_mem->yn, SUN_PREC_NONE, ARK_ADJ_MAXL,
+                                  ark_mem->sunctx);
+    if (adj_mem->LS == NULL) { return ARK_MEM_FAIL; }
+    if (SUNLinSolSetATimes(adj_mem->LS, ark_mem, arkAdjATimes) ||
+        SUNLinSol_SPGMRSetMaxRestarts(adj_mem->LS, ARK_ADJ_MAXRS) ||
+        SUNLinSolInitialize(adj_mem->LS) || SUNLinSolSetup(adj_mem->LS, NULL))
+    {
+      return ARK_LINIT_FAIL;
+    }
+  }
+
+  dir = (adj_mem->nsteps > 0 && adj_mem->h[0] < ZERO) ? -ONE : ONE;
+
+  while (adj_mem->cur > 0)
+  {
+    /* stop at the first step that starts before tout */
+    troundoff = FUZZ_FACTOR * ark_mem->uround *
+                (SUNRabs(adj_mem->t[adj_mem->cur - 1]) +
+                 SUNRabs(adj_mem->h[adj_mem->cur - 1]));
+    if (!onestep && dir * (adj_mem->t[adj_mem->cur - 1] - tout) < -troundoff)
+    {
+      break;
+    }
+
+    retval = arkAdjStep(ark_mem, adj_mem->cur - 1);
+    if (retval != ARK_SUCCESS) { return retval; }
+
+    if (onestep) { break; }
+  }
+
+  N_VScale(ONE, adj_mem->lambda, vret);
+  *tret = adj_mem->t[adj_mem->cur];
+
+  return ARK_SUCCESS;
+}
+
+/* =============================================================================
+ * SUNStepper Interface
+ * ===========================================================================*/
+
+static SUNErrCode arkAdjSUNStepperEvolve(SUNStepper stepper, sunrealtype tout,
+                                         N_Vector vret, sunrealtype* tret)
+{
+  SUNFunctionBegin(stepper->sunctx);
+  void* arkode_mem;
+  SUNCheckCall(SUNStepper_GetContent(stepper, &arkode_mem));
+
+  stepper->last_flag = arkAdjEvolve((ARKodeMem)arkode_mem, tout, vret, tret,
+                                    SUNFALSE);
+  if (stepper->last_flag != ARK_SUCCESS) { return SUN_ERR_OP_FAIL; }
+
+  return SUN_SUCCESS;
+}
+
+static SUNErrCode arkAdjSUNStepperOneStep(SUNStepper stepper, sunrealtype tout,
+                                          N_Vector vret, sunrealtype* tret)
+{
+  SUNFunctionBegin(stepper->sunctx);
+  void* arkode_mem;
+  SUNCheckCall(SUNStepper_GetContent(stepper, &arkode_mem));
+
+  stepper->last_flag = arkAdjEvolve((ARKodeMem)arkode_mem, tout, vret, tret,
+                                    SUNTRUE);
+  if (stepper->last_flag != ARK_SUCCESS) { return SUN_ERR_OP_FAIL; }
+
+  return SUN_SUCCESS;
+}
+
+/* Set the adjoint solution at a recorded step time, usually the final time of
+   the forward integration */
+static SUNErrCode arkAdjSUNStepperReset(SUNStepper stepper, sunrealtype tR,
+                                        N_Vector vR)
+{
+  SUNFunctionBegin(stepper->sunctx);
+  void* arkode_mem;
+  long int n;
+  sunrealtype troundoff, hn;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  SUNCheckCall(SUNStepper_GetContent(stepper, &arkode_mem));
+  ark_mem = (ARKodeMem)arkode_mem;
+  adj_mem = ark_mem->adj_mem;
+
+  if (adj_mem->nsteps == 0)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "No forward steps have been recorded");
+    stepper->last_flag = ARK_ILL_INPUT;
+    return SUN_ERR_OP_FAIL;
+  }
+
+  for (n = adj_mem->nsteps; n >= 0; n--)
+  {
+    hn        = adj_mem->h[SUNMAX(n, 1) - 1];
+    troundoff = FUZZ_FACTOR * ark_mem->uround *
+                (SUNRabs(adj_mem->t[n]) + SUNRabs(hn));
+    if (SUNRabs(adj_mem->t[n] - tR) <= troundoff) { break; }
+  }
+  if (n < 0)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "tR = %" RSYM " is not a recorded step time", tR);
+    stepper->last_flag = ARK_ILL_INPUT;
+    return SUN_ERR_OP_FAIL;
+  }
+
+  stepper->last_flag = arkAdjAllocWork(ark_mem);
+  if (stepper->last_flag != ARK_SUCCESS) { return SUN_ERR_MEM_FAIL; }
+
+  N_VScale(ONE, vR, adj_mem->lambda);
+  adj_mem->cur     = n;
+  adj_mem->started = SUNTRUE;
+
+  return SUN_SUCCESS;
+}
+
+/* =============================================================================
+ * Driver and Stepper Functions
+ * ===========================================================================*/
+
+/* Record the step that is being completed */
+int arkAdjRecordStep(ARKodeMem ark_mem)
+{
+  int retval, i;
+  long int n;
+  ARKodeButcherTable B;
+  N_Vector* F;
+  sunbooleantype implicit;
+  ARKodeAdjMem adj_mem = ark_mem->adj_mem;
+
+  if (ark_mem->step_getadjointdata == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                    __FILE__,
+                    "time-stepping module does not support discrete adjoints");
+    return ARK_ADJ_CHECKPOINT_FAIL;
+  }
+
+  if (ark_mem->relax_enabled || ark_mem->ProcessStep || ark_mem->ProcessStage)
+  {
+    arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                    __FILE__,
+                    "Discrete adjoints do not support relaxation or step and "
+                    "stage postprocessing");
+    return ARK_ADJ_CHECKPOINT_FAIL;
+  }
+
+  retval = ark_mem->step_getadjointdata(ark_mem, &B, &F, &implicit);
+  if (retval != ARK_SUCCESS) { return ARK_ADJ_CHECKPOINT_FAIL; }
+
+  /* the method may not change between steps */
+  if (adj_mem->nsteps == 0)
+  {
+    arkAdjFreeWork(adj_mem);
+    adj_mem->stages   = B->stages;
+    adj_mem->implicit = implicit;
+  }
+  else if (B->stages != adj_mem->stages || implicit != adj_mem->implicit)
+  {
+    arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                    __FILE__,
+                    "The method changed during the recorded integration");
+    return ARK_ADJ_CHECKPOINT_FAIL;
+  }
+
+  if (arkAdjGrow(adj_mem) != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                    __FILE__, MSG_ARK_MEM_FAIL);
+    return ARK_ADJ_CHECKPOINT_FAIL;
+  }
+
+  n = adj_mem->nsteps;
+  if (n == 0) { adj_mem->t[0] = ark_mem->tn; }
+  adj_mem->h[n]     = ark_mem->h;
+  adj_mem->t[n + 1] = ark_mem->tcur;
+
+  if (adj_mem->save_stages || n % adj_mem->interval == 0)
+  {
+    adj_mem->ckY[adj_mem->nck] = arkAdjCopy(ark_mem->yn);
+    if (adj_mem->ckY[adj_mem->nck] == NULL)
+    {
+      arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                      __FILE__, MSG_ARK_MEM_FAIL);
+      return ARK_ADJ_CHECKPOINT_FAIL;
+    }
+    if (adj_mem->save_stages)
+    {
+      adj_mem->ckF[adj_mem->nck] = N_VCloneVectorArray(adj_mem->stages,
+                                                       ark_mem->yn);
+      if (adj_mem->ckF[adj_mem->nck] == NULL)
+      {
+        arkProcessError(ark_mem, ARK_ADJ_CHECKPOINT_FAIL, __LINE__, __func__,
+                        __FILE__, MSG_ARK_MEM_FAIL);
+        return ARK_ADJ_CHECKPOINT_FAIL;
+      }
+      for (i = 0; i < adj_mem->stages; i++)
+      {
+        N_VScale(ONE, F[i], adj_mem->ckF[adj_mem->nck][i]);
+      }
+    }
+    adj_mem->nck++;
+  }
+
+  adj_mem->nsteps++;
+
+  return ARK_SUCCESS;
+}
+
+/* Discard the recorded steps and checkpoints */
+void arkAdjClearHistory(ARKodeAdjMem adj_mem)
+{
+  long int i;
+
+  for (i = 0; i < adj_mem->nck; i++)
+  {
+    N_VDestroy(adj_mem->ckY[i]);
+    if (adj_mem->ckF[i])
+    {
+      N_VDestroyVectorArray(adj_mem->ckF[i], adj_mem->stages);
+    }
+    adj_mem->ckY[i] = NULL;
+    adj_mem->ckF[i] = NULL;
+  }
+  adj_mem->nck      = 0;
+  adj_mem->nsteps   = 0;
+  adj_mem->cache_ck = -1;
+  adj_mem->cur      = 0;
+  adj_mem->started  = SUNFALSE;
+}
+
+/* Free the discrete adjoint memory */
+void arkAdjFree(ARKodeAdjMem* adj_mem)
+{
+  ARKodeAdjMem mem;
+
+  if (adj_mem == NULL || *adj_mem == NULL) { return; }
+  mem = *adj_mem;
+
+  arkAdjClearHistory(mem);
+  arkAdjFreeWork(mem);
+
+  if (mem->kappa) { N_VDestroy(mem->kappa); }
+  if (mem->rhs) { N_VDestroy(mem->rhs); }
+  if (mem->ystage) { N_VDestroy(mem->ystage); }
+  if (mem->lambda) { N_VDestroy(mem->lambda); }
+  if (mem->mutmp) { N_VDestroy(mem->mutmp); }
+  if (mem->ysave) { N_VDestroy(mem->ysave); }
+  if (mem->ycursave) { N_VDestroy(mem->ycursave); }
+  if (mem->LS) { (void)SUNLinSolFree(mem->LS); }
+
+  free(mem->t);
+  free(mem->h);
+  free(mem->ckY);
+  free(mem->ckF);
+  free(mem);
+  *adj_mem = NULL;
+}
+
+/* =============================================================================
+ * User Functions
+ * ===========================================================================*/
+
+int ARKodeSetAdjointCheckpointing(void* arkode_mem, long int interval,
+                                  sunbooleantype save_stages)
+{
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return ARK_MEM_NULL;
+  }
+  ark_mem = (ARKodeMem)arkode_mem;
+
+  if (ark_mem->step_getadjointdata == NULL)
+  {
+    arkProcessError(ark_mem, ARK_STEPPER_UNSUPPORTED, __LINE__, __func__,
+                    __FILE__,
+                    "time-stepping module does not support discrete adjoints");
+    return ARK_STEPPER_UNSUPPORTED;
+  }
+
+  if (interval <= 0) { interval = ARK_ADJ_DEFAULT_INTERVAL; }
+
+  /* Discard previous data, keeping the user-supplied functions */
+  adj_mem = ark_mem->adj_mem;
+  if (adj_mem != NULL)
+  {
+    arkAdjClearHistory(adj_mem);
+    arkAdjFreeWork(adj_mem);
+  }
+  else
+  {
+    adj_mem = (ARKodeAdjMem)calloc(1, sizeof(*adj_mem));
+    if (adj_mem == NULL)
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_MEM_FAIL);
+      return ARK_MEM_FAIL;
+    }
+    adj_mem->lintol   = ARK_ADJ_DEFAULT_LINTOL;
+    adj_mem->cache_ck = -1;
+    ark_mem->adj_mem  = adj_mem;
+  }
+
+  adj_mem->interval    = save_stages ? 1 : interval;
+  adj_mem->save_stages = save_stages;
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeSetAdjointVecJacFn(void* arkode_mem, ARKVecJacFn fy_vjp,
+                             ARKVecJacFn fp_vjp)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  if (fy_vjp == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The vector-Jacobian product function must be non-NULL");
+    return ARK_ILL_INPUT;
+  }
+
+  adj_mem->fy_vjp = fy_vjp;
+  adj_mem->fp_vjp = fp_vjp;
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeSetAdjointLinSolTol(void* arkode_mem, sunrealtype tol)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  if (tol > ZERO) { adj_mem->lintol = tol; }
+  else { adj_mem->lintol = ARK_ADJ_DEFAULT_LINTOL; }
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeCreateAdjointSUNStepper(void* arkode_mem, N_Vector mu,
+                                  SUNStepper* adj_stepper)
+{
+  int retval;
+  SUNErrCode err;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  if (adj_stepper == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The SUNStepper pointer must be non-NULL");
+    return ARK_ILL_INPUT;
+  }
+
+  /* parameter gradients accumulate in mu */
+  if (adj_mem->mutmp && mu != adj_mem->mu)
+  {
+    N_VDestroy(adj_mem->mutmp);
+    adj_mem->mutmp = NULL;
+  }
+  adj_mem->mu      = mu;
+  adj_mem->started = SUNFALSE;
+
+  err = SUNStepper_Create(ark_mem->sunctx, adj_stepper);
+  if (err != SUN_SUCCESS)
+  {
+    arkProcessError(ark_mem, ARK_SUNSTEPPER_ERR, __LINE__, __func__, __FILE__,
+                    "Failed to create SUNStepper");
+    return ARK_SUNSTEPPER_ERR;
+  }
+
+  err = SUNStepper_SetContent(*adj_stepper, arkode_mem);
+  if (err == SUN_SUCCESS)
+  {
+    err = SUNStepper_SetEvolveFn(*adj_stepper, arkAdjSUNStepperEvolve);
+  }
+  if (err == SUN_SUCCESS)
+  {
+    err = SUNStepper_SetOneStepFn(*adj_stepper, arkAdjSUNStepperOneStep);
+  }
+  if (err == SUN_SUCCESS)
+  {
+    err = SUNStepper_SetResetFn(*adj_stepper, arkAdjSUNStepperReset);
+  }
+  if (err != SUN_SUCCESS)
+  {
+    arkProcessError(ark_mem, ARK_SUNSTEPPER_ERR, __LINE__, __func__, __FILE__,
+                    "Failed to set SUNStepper functions");
+    (void)SUNStepper_Destroy(adj_stepper);
+    return ARK_SUNSTEPPER_ERR;
+  }
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeGetNumAdjointCheckpoints(void* arkode_mem, long int* nck)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  *nck = adj_mem->nck;
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeGetNumAdjointRecomputedSteps(void* arkode_mem, long int* nrecomp)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  *nrecomp = adj_mem->nrecomp;
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeGetNumAdjointVecJacEvals(void* arkode_mem, long int* nvjp)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  *nvjp = adj_mem->nvjp;
+
+  return ARK_SUCCESS;
+}
+
+int ARKodeGetNumAdjointLinIters(void* arkode_mem, long int* nliters)
+{
+  int retval;
+  ARKodeMem ark_mem;
+  ARKodeAdjMem adj_mem;
+
+  retval = arkAdjAccessMem(arkode_mem, __func__, &ark_mem, &adj_mem);
+  if (retval) { return retval; }
+
+  *nliters = adj_mem->nliters;
+
+  return ARK_SUCCESS;
+}
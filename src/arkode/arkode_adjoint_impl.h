@@ -0,0 +1,120 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Implementation header file for ARKODE's discrete adjoint functionality.
+ * ---------------------------------------------------------------------------*/
+
+#ifndef _ARKODE_ADJOINT_IMPL_H
+#define _ARKODE_ADJOINT_IMPL_H
+
+#include <arkode/arkode.h>
+#include <arkode/arkode_butcher.h>
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+
+#include "arkode_types_impl.h"
+
+/* -----------------------------------------------------------------------------
+ * Discrete Adjoint Constants
+ * ---------------------------------------------------------------------------*/
+
+#define ARK_ADJ_DEFAULT_INTERVAL 1
+#define ARK_ADJ_DEFAULT_LINTOL   (SUN_RCONST(1.0e4) * SUN_UNIT_ROUNDOFF)
+#define ARK_ADJ_MAXL             10
+#define ARK_ADJ_MAXRS            10
+
+/* -----------------------------------------------------------------------------
+ * Stepper Supplied Discrete Adjoint Functions
+ * ---------------------------------------------------------------------------*/
+
+/* Get the Butcher table and the stage right-hand side vectors of the method,
+   and whether the method is diagonally implicit */
+typedef int (*ARKAdjGetStageDataFn)(ARKodeMem ark_mem, ARKodeButcherTable* B,
+                                    N_Vector** F, sunbooleantype* implicit);
+
+/* -----------------------------------------------------------------------------
+ * Discrete Adjoint Data Structure
+ * ---------------------------------------------------------------------------*/
+
+struct ARKodeAdjMemRec
+{
+  /* checkpointing options */
+  long int interval;          /* steps between checkpoints            */
+  sunbooleantype save_stages; /* checkpoint the stages of every step? */
+
+  /* user-supplied vector-Jacobian products and solver options */
+  ARKVecJacFn fy_vjp; /* (df/dy)^T v                          */
+  ARKVecJacFn fp_vjp; /* (df/dp)^T v                          */
+  sunrealtype lintol; /* relative tol for DIRK stage solves   */
+
+  /* recorded forward steps */
+  long int nsteps;         /* number of recorded steps             */
+  long int nalloc;         /* length of the t and h arrays         */
+  sunrealtype* t;          /* step times, nsteps + 1 entries       */
+  sunrealtype* h;          /* step sizes                           */
+  int stages;              /* stages of the recorded method        */
+  sunbooleantype implicit; /* is the recorded method a DIRK?       */
+
+  /* checkpoints: the solution at the start of every interval-th step or,
+     with save_stages, the solution and stage right-hand sides of every step */
+  long int nck;     /* number of checkpoints                */
+  long int ckalloc; /* length of the checkpoint arrays      */
+  N_Vector* ckY;    /* checkpointed solutions               */
+  N_Vector** ckF;   /* checkpointed stage right-hand sides  */
+
+  /* steps recomputed from the last used checkpoint */
+  long int cache_ck; /* checkpoint held in the cache (-1 if none) */
+  N_Vector* cacheY;  /* solutions at the start of each step       */
+  N_Vector** cacheF; /* stage right-hand sides of each step       */
+  N_Vector ysave;    /* forward solution saved while recomputing  */
+  N_Vector ycursave; /* user output vector saved while recomputing */
+
+  /* backward integration */
+  long int cur;           /* step index of the adjoint solution   */
+  sunbooleantype started; /* has the adjoint been reset?          */
+  N_Vector lambda;        /* adjoint solution                     */
+  N_Vector mu;            /* user vector for parameter gradients  */
+  N_Vector* theta;        /* (df/dy)^T of the stage adjoints      */
+  N_Vector kappa;         /* stage adjoint                        */
+  N_Vector rhs;           /* stage adjoint right-hand side        */
+  N_Vector ystage;        /* stage solution                       */
+  N_Vector mutmp;         /* parameter gradient contribution      */
+  sunrealtype* cvals;     /* scalars for fused vector operations  */
+  N_Vector* Xvecs;        /* vectors for fused vector operations  */
+
+  /* DIRK stage solves (I - h a_ii J^T) kappa = rhs */
+  SUNLinearSolver LS; /* matrix-free GMRES                    */
+  sunrealtype gamma;  /* h a_ii of the current stage          */
+  sunrealtype tstage; /* time of the current stage            */
+
+  /* counters */
+  long int nrecomp; /* number of recomputed forward steps   */
+  long int nvjp;    /* number of vector-Jacobian products   */
+  long int nliters; /* number of GMRES iterations           */
+};
+
+/* -----------------------------------------------------------------------------
+ * Discrete Adjoint Functions
+ * ---------------------------------------------------------------------------*/
+
+int arkAdjRecordStep(ARKodeMem ark_mem);
+void arkAdjClearHistory(ARKodeAdjMem adj_mem);
+void arkAdjFree(ARKodeAdjMem* adj_mem);
+
+/* -----------------------------------------------------------------------------
+ * Error Messages
+ * ---------------------------------------------------------------------------*/
+
+#define MSG_ADJ_MEM_NULL \
+  "Discrete adjoint memory is NULL. Call ARKodeSetAdjointCheckpointing first."
+
+#endif
@@ -142,6 +142,7 @@ void* ARKStepCreate(ARKRhsFn fe, ARKRhsFn fi, sunrealtype t0, N_Vector y0,
   ark_mem->step_getnumnonlinsolvconvfails = arkStep_GetNumNonlinSolvConvFails;
   ark_mem->step_getnonlinsolvstats        = arkStep_GetNonlinSolvStats;
   ark_mem->step_setforcing                = arkStep_SetInnerForcing;
+  ark_mem->step_getadjointdata            = arkStep_GetAdjointData;
   ark_mem->step_supports_adaptive         = SUNTRUE;
   ark_mem->step_supports_implicit         = SUNTRUE;
   ark_mem->step_supports_massmatrix       = SUNTRUE;
@@ -504,6 +505,15 @@ void arkStep_Free(ARKodeMem ark_mem)
     step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
 
     /* free the Butcher tables */
+    arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
+    if (step_mem->Bsw != NULL)
+    {
+      ARKodeButcherTable_Space(step_mem->Bsw, &Bliw, &Blrw);
+      ARKodeButcherTable_Free(step_mem->Bsw);
+      step_mem->Bsw = NULL;
+      ark_mem->liw -= Bliw;
+      ark_mem->lrw -= Blrw;
+    }
     if (step_mem->Be != NULL)
     {
       ARKodeButcherTable_Space(step_mem->Be, &Bliw, &Blrw);
@@ -952,6 +962,24 @@ int arkStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
   retval = arkStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return (retval); }
 
+  /* restart method switching (if applicable) with the implicit tables */
+  if (step_mem->sw_enabled || step_mem->sw_explicit)
+  {
+    if (init_type != FIRST_INIT)
+    {
+      step_mem->sw_nsteps[step_mem->sw_explicit ? 0 : 1] +=
+        ark_mem->nst - step_mem->sw_nst_count;
+    }
+    arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
+    step_mem->sw_pending    = SUNFALSE;
+    step_mem->sw_nstiff     = 0;
+    step_mem->sw_nnonstiff  = 0;
+    step_mem->sw_nprobe     = 0;
+    step_mem->sw_nprobe_hit = 0;
+    step_mem->sw_nst_test   = ark_mem->nst;
+    step_mem->sw_nst_count  = ark_mem->nst;
+  }
+
   /* immediately return if reset */
   if (init_type == RESET_INIT) { return (ARK_SUCCESS); }
 
@@ -1035,6 +1063,13 @@ int arkStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
       return ARK_ILL_INPUT;
     }
 
+    /* Prepare stiffness detection and method switching */
+    if (step_mem->sw_enabled)
+    {
+      retval = arkStep_StiffSwitchInit(ark_mem);
+      if (retval != ARK_SUCCESS) { return (retval); }
+    }
+
     /* Allocate ARK RHS vector memory, update storage requirements */
     /*   Allocate Fe[0] ... Fe[stages-1] if needed */
     if (step_mem->explicit)
@@ -1680,6 +1715,13 @@ int arkStep_TakeStep_Z(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
   retval = arkStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return (retval); }
 
+  /* perform a pending method switch (if applicable) */
+  if (step_mem->sw_enabled || step_mem->sw_explicit)
+  {
+    retval = arkStep_StiffSwitchStep(ark_mem);
+    if (retval != ARK_SUCCESS) { return (retval); }
+  }
+
   /* if problem will involve no algebraic solvers, initialize nflagPtr to success */
   if ((!step_mem->implicit) && (step_mem->mass_type == MASS_IDENTITY))
   {
@@ -2117,6 +2159,13 @@ int arkStep_TakeStep_Z(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
   SUNLogExtraDebugVec(ARK_LOGGER, "updated solution", ark_mem->ycur, "ycur(:) =");
   SUNLogInfo(ARK_LOGGER, "end-compute-solution", "status = success");
 
+  /* check the stiffness of the problem (if applicable) */
+  if (step_mem->sw_enabled)
+  {
+    retval = arkStep_StiffSwitchTest(ark_mem, *dsmPtr);
+    if (retval != ARK_SUCCESS) { return (retval); }
+  }
+
   return (ARK_SUCCESS);
 }
 
@@ -3487,6 +3536,577 @@ int arkStep_GetOrder(ARKodeMem ark_mem)
   return step_mem->q;
 }
 
+/*===============================================================
+  Stiffness detection and explicit/implicit method switching
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  arkStep_StiffSwitchInit
+
+  This routine prepares automatic switching between the implicit
+  (or ImEx) method and an explicit table with the same number of
+  stages. Without a user-supplied table the explicit table of an
+  ImEx pair, or else the first built-in ERK table matching the
+  stages and order of the implicit table, is used. The real
+  stability boundary of the explicit table is found by scanning
+  its stability polynomial R(z) = 1 + sum_k b^T A^(k-1) 1 z^k
+  along the negative real axis.
+  ---------------------------------------------------------------*/
+int arkStep_StiffSwitchInit(ARKodeMem ark_mem)
+{
+  ARKodeARKStepMem step_mem;
+  ARKodeButcherTable B;
+  sunindextype Blrw, Bliw;
+  sunrealtype *coef, *v, *w;
+  sunrealtype x, R, dx;
+  int i, j, k, s, id, retval;
+
+  /* access ARKodeARKStepMem structure */
+  retval = arkStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if (!step_mem->implicit)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Method switching requires an implicit or ImEx method");
+    return (ARK_ILL_INPUT);
+  }
+  if (step_mem->mass_type != MASS_IDENTITY || step_mem->expforcing ||
+      step_mem->impforcing)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                    __FILE__, "Method switching is not supported with a mass matrix or inner forcing");
+    return (ARK_ILL_INPUT);
+  }
+  if (ark_mem->relax_enabled)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Relaxation cannot be combined with method switching");
+    return (ARK_ILL_INPUT);
+  }
+
+  s = step_mem->stages;
+
+  /* reselect a default explicit table for the current implicit table */
+  if (step_mem->Bsw != NULL && !step_mem->sw_usertable)
+  {
+    ARKodeButcherTable_Space(step_mem->Bsw, &Bliw, &Blrw);
+    ARKodeButcherTable_Free(step_mem->Bsw);
+    step_mem->Bsw = NULL;
+    ark_mem->liw -= Bliw;
+    ark_mem->lrw -= Blrw;
+  }
+
+  /* select the explicit table (if not supplied) */
+  if (step_mem->Bsw == NULL)
+  {
+    B = NULL;
+    if (step_mem->explicit) { B = ARKodeButcherTable_Copy(step_mem->Be); }
+    else
+    {
+      for (id = ARKODE_MIN_ERK_NUM; id <= ARKODE_MAX_ERK_NUM && !B; id++)
+      {
+        B = ARKodeButcherTable_LoadERK((ARKODE_ERKTableID)id);
+        if (B != NULL &&
+            (B->stages != s || B->q != step_mem->Bi->q || B->d == NULL))
+        {
+          ARKodeButcherTable_Free(B);
+          B = NULL;
+        }
+      }
+    }
+    if (B == NULL)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                      __FILE__, "No explicit table matches the stages and order of the implicit table");
+      return (ARK_ILL_INPUT);
+    }
+    step_mem->Bsw = B;
+    ARKodeButcherTable_Space(B, &Bliw, &Blrw);
+    ark_mem->liw += Bliw;
+    ark_mem->lrw += Blrw;
+  }
+  B = step_mem->Bsw;
+
+  /* check the explicit table */
+  if (B->stages != s || s < 2)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                    __FILE__, "The explicit table must have the same number (at least 2) of stages as the implicit table");
+    return (ARK_ILL_INPUT);
+  }
+  for (i = 0; i < s; i++)
+  {
+    for (j = i; j < s; j++)
+    {
+      if (SUNRabs(B->A[i][j]) > TINY)
+      {
+        arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                        "The method switching table must be explicit");
+        return (ARK_ILL_INPUT);
+      }
+    }
+  }
+  if (!ark_mem->fixedstep && (B->d == NULL || B->p <= 0))
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                    __FILE__, "The method switching table requires an embedding for adaptive steps");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* stability polynomial coefficients coef[k] = b^T A^(k-1) 1 */
+  coef = (sunrealtype*)calloc(3 * s + 1, sizeof(sunrealtype));
+  if (coef == NULL) { return (ARK_MEM_FAIL); }
+  v = coef + s + 1;
+  w = v + s;
+  for (i = 0; i < s; i++) { v[i] = ONE; }
+  for (k = 1; k <= s; k++)
+  {
+    for (i = 0; i < s; i++) { coef[k] += B->b[i] * v[i]; }
+    for (i = 0; i < s; i++)
+    {
+      w[i] = ZERO;
+      for (j = 0; j < i; j++) { w[i] += B->A[i][j] * v[j]; }
+    }
+    for (i = 0; i < s; i++) { v[i] = w[i]; }
+  }
+
+  /* largest x with |R(-y)| <= 1 on [0, x] (|R| <= 1 needs x <= 2 s^2) */
+  dx                 = SUN_RCONST(0.01);
+  step_mem->sw_rstab = ZERO;
+  for (x = dx; x <= TWO * s * s; x += dx)
+  {
+    R = coef[s];
+    for (k = s - 1; k >= 1; k--) { R = coef[k] - x * R; }
+    R = ONE - x * R;
+    if (SUNRabs(R) > ONE + SUN_RCONST(100.0) * ark_mem->uround) { break; }
+    step_mem->sw_rstab = x;
+  }
+  free(coef);
+
+  if (step_mem->sw_rstab <= ZERO)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                    __FILE__, "The method switching table has no real stability interval");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* start with the implicit table */
+  step_mem->sw_explicit   = SUNFALSE;
+  step_mem->sw_pending    = SUNFALSE;
+  step_mem->sw_rho        = ZERO;
+  step_mem->sw_nstiff     = 0;
+  step_mem->sw_nnonstiff  = 0;
+  step_mem->sw_nprobe     = 0;
+  step_mem->sw_nprobe_hit = 0;
+  step_mem->sw_nst_test   = ark_mem->nst;
+  step_mem->sw_nst_count  = ark_mem->nst;
+  step_mem->sw_nswitch    = 0;
+  step_mem->sw_nsteps[0] = step_mem->sw_nsteps[1] = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  arkStep_StiffSwitchTables
+
+  This routine activates the explicit table (explicit_phase =
+  SUNTRUE) or restores the implicit tables. The explicit table
+  replaces Bi (and Be for ImEx methods), so the stages are
+  computed by the usual ARK stage loop without implicit solves,
+  i.e., the explicit method is applied to fe + fi.
+  ---------------------------------------------------------------*/
+void arkStep_StiffSwitchTables(ARKodeMem ark_mem,
+                               sunbooleantype explicit_phase)
+{
+  ARKodeARKStepMem step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
+
+  if (step_mem == NULL || explicit_phase == step_mem->sw_explicit) { return; }
+
+  if (explicit_phase)
+  {
+    step_mem->Bi_sw = step_mem->Bi;
+    step_mem->Be_sw = step_mem->Be;
+    step_mem->Bi    = step_mem->Bsw;
+    if (step_mem->explicit) { step_mem->Be = step_mem->Bsw; }
+  }
+  else
+  {
+    step_mem->Bi    = step_mem->Bi_sw;
+    step_mem->Be    = step_mem->Be_sw;
+    step_mem->Bi_sw = NULL;
+    step_mem->Be_sw = NULL;
+
+    /* the linear solver data is out of date after an explicit phase */
+    step_mem->nstlp = ark_mem->nst - abs(step_mem->msbp);
+  }
+  step_mem->sw_explicit = explicit_phase;
+
+  step_mem->q = ark_mem->hadapt_mem->q = step_mem->Bi->q;
+  step_mem->p = ark_mem->hadapt_mem->p = step_mem->Bi->p;
+}
+
+/*---------------------------------------------------------------
+  arkStep_StiffSwitchStep
+
+  This routine is called at the start of each step attempt. It
+  attributes the steps completed since the last call to the
+  active method and performs a switch decided after the last
+  step (or a return to the implicit tables when switching was
+  disabled). The full RHS at the start of the step is evaluated
+  with the tables of the completed step before the switch.
+  ---------------------------------------------------------------*/
+int arkStep_StiffSwitchStep(ARKodeMem ark_mem)
+{
+  ARKodeARKStepMem step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
+  sunbooleantype explicit_phase;
+  int retval;
+
+  /* prepare switching if enabled after initialization */
+  if (step_mem->sw_enabled && step_mem->sw_rstab <= ZERO)
+  {
+    arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
+    retval = arkStep_StiffSwitchInit(ark_mem);
+    if (retval != ARK_SUCCESS) { return (retval); }
+  }
+
+  step_mem->sw_nsteps[step_mem->sw_explicit ? 0 : 1] +=
+    ark_mem->nst - step_mem->sw_nst_count;
+  step_mem->sw_nst_count = ark_mem->nst;
+
+  explicit_phase = step_mem->sw_explicit;
+  if (!step_mem->sw_enabled) { explicit_phase = SUNFALSE; }
+  else if (step_mem->sw_pending && ark_mem->nst > step_mem->sw_nst_test)
+  {
+    explicit_phase = !explicit_phase;
+  }
+  step_mem->sw_pending = SUNFALSE;
+
+  if (explicit_phase == step_mem->sw_explicit) { return (ARK_SUCCESS); }
+
+  if (!ark_mem->fn_is_current)
+  {
+    retval = ark_mem->step_fullrhs(ark_mem, ark_mem->tn, ark_mem->yn,
+                                   ark_mem->fn, ARK_FULLRHS_END);
+    if (retval) { return (ARK_RHSFUNC_FAIL); }
+    ark_mem->fn_is_current = SUNTRUE;
+  }
+
+  arkStep_StiffSwitchTables(ark_mem, explicit_phase);
+
+  step_mem->sw_nswitch++;
+  step_mem->sw_nstiff     = 0;
+  step_mem->sw_nnonstiff  = 0;
+  step_mem->sw_nprobe     = 0;
+  step_mem->sw_nprobe_hit = 0;
+
+  SUNLogInfo(ARK_LOGGER, "stiffness-switch",
+             "step = %li, tn = %" RSYM ", explicit = %i, rho = %" RSYM,
+             ark_mem->nst, ark_mem->tn, explicit_phase, step_mem->sw_rho);
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  arkStep_StiffSwitchTest
+
+  This routine is called after the stages of each step attempt
+  and decides whether to switch methods before the next step.
+
+  During explicit phases the spectral radius rho of the Jacobian
+  is estimated from the last two stages at no extra cost. An
+  attempt (accepted or rejected) is stiff if h*rho is close to
+  the stability boundary of the explicit table; SW_NSTIFF stiff
+  attempts without SW_NNONSTIFF nonstiff attempts in between
+  trigger a switch to the implicit method.
+
+  The stage data underestimate rho when the stiff components of
+  the solution are not excited (e.g., on a slow manifold or with
+  an implicit method), so in both phases rho is also estimated
+  every SW_PROBE steps with a few power iterations on difference
+  quotients of the RHS. SW_NPROBE consecutive estimates showing
+  that the explicit table is stability limited (explicit phase)
+  or would be stable (implicit phase) with the current step size
+  also trigger a switch.
+  ---------------------------------------------------------------*/
+int arkStep_StiffSwitchTest(ARKodeMem ark_mem, sunrealtype dsm)
+{
+  ARKodeARKStepMem step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
+  N_Vector dz               = ark_mem->tempv2;
+  N_Vector df               = ark_mem->tempv3;
+  sunrealtype dznrm, habs, rho;
+  sunbooleantype probe;
+  int retval;
+
+  habs  = SUNRabs(ark_mem->h);
+  probe = SUNFALSE;
+
+  /* estimate rho periodically after successful steps */
+  if (dsm <= ONE && ++step_mem->sw_nprobe >= SW_PROBE)
+  {
+    step_mem->sw_nprobe = 0;
+    probe               = SUNTRUE;
+  }
+  if (!step_mem->sw_explicit && !probe) { return (ARK_SUCCESS); }
+
+  retval = arkStep_StiffStageDiff(ark_mem, dz, df);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if (step_mem->sw_explicit)
+  {
+    rho   = ZERO;
+    dznrm = N_VWrmsNorm(dz, ark_mem->ewt);
+    if (dznrm > ZERO) { rho = N_VWrmsNorm(df, ark_mem->ewt) / dznrm; }
+    if (rho > ZERO) { step_mem->sw_rho = rho; }
+
+    if (habs * rho > SW_STIFF * step_mem->sw_rstab)
+    {
+      step_mem->sw_nstiff++;
+      step_mem->sw_nnonstiff = 0;
+    }
+    else if (++step_mem->sw_nnonstiff >= SW_NNONSTIFF)
+    {
+      step_mem->sw_nstiff = 0;
+    }
+  }
+
+  if (probe)
+  {
+    rho = arkStep_StiffProbe(ark_mem, dz);
+    if (rho > ZERO)
+    {
+      step_mem->sw_rho = rho;
+
+      if (step_mem->sw_explicit ? habs * rho > SW_STIFF * step_mem->sw_rstab
+                                : habs * rho < SW_NONSTIFF * step_mem->sw_rstab)
+      {
+        step_mem->sw_nprobe_hit++;
+      }
+      else { step_mem->sw_nprobe_hit = 0; }
+    }
+  }
+
+  SUNLogDebug(ARK_LOGGER, "stiffness-test",
+              "explicit = %i, h*rho = %" RSYM ", boundary = %" RSYM,
+              step_mem->sw_explicit, habs * step_mem->sw_rho,
+              step_mem->sw_rstab);
+
+  /* switch before the next step if this attempt is accepted */
+  if (step_mem->sw_nprobe_hit >= SW_NPROBE ||
+      (step_mem->sw_explicit && step_mem->sw_nstiff >= SW_NSTIFF))
+  {
+    step_mem->sw_pending  = SUNTRUE;
+    step_mem->sw_nst_test = ark_mem->nst;
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  arkStep_StiffStageDiff
+
+  This routine computes the difference of the last two stages,
+  dz = z_{s-1} - z_{s-2} = h sum_j (A_{s-1,j} - A_{s-2,j}) F_j,
+  and of their full RHS values, df = F_{s-1} - F_{s-2}, from
+  the stored stage RHS vectors (M = I).
+  ---------------------------------------------------------------*/
+int arkStep_StiffStageDiff(ARKodeMem ark_mem, N_Vector dz, N_Vector df)
+{
+  ARKodeARKStepMem step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
+  sunrealtype* cvals        = step_mem->cvals;
+  N_Vector* Xvecs           = step_mem->Xvecs;
+  sunrealtype c;
+  int a, b, j, nvec, retval;
+
+  a = step_mem->stages - 1;
+  b = step_mem->stages - 2;
+
+  nvec = 0;
+  if (step_mem->explicit)
+  {
+    for (j = 0; j <= a; j++)
+    {
+      c = ark_mem->h * (step_mem->Be->A[a][j] - step_mem->Be->A[b][j]);
+      if (c == ZERO) { continue; }
+      cvals[nvec] = c;
+      Xvecs[nvec] = step_mem->Fe[j];
+      nvec++;
+    }
+  }
+  if (step_mem->implicit)
+  {
+    for (j = 0; j <= a; j++)
+    {
+      c = ark_mem->h * (step_mem->Bi->A[a][j] - step_mem->Bi->A[b][j]);
+      if (c == ZERO) { continue; }
+      cvals[nvec] = c;
+      Xvecs[nvec] = step_mem->Fi[j];
+      nvec++;
+    }
+  }
+  if (nvec == 0) { N_VConst(ZERO, dz); }
+  else
+  {
+    retval = N_VLinearCombination(nvec, cvals, Xvecs, dz);
+    if (retval != 0) { return (ARK_VECTOROP_ERR); }
+  }
+
+  nvec = 0;
+  if (step_mem->explicit)
+  {
+    cvals[nvec]     = ONE;
+    Xvecs[nvec]     = step_mem->Fe[a];
+    cvals[nvec + 1] = -ONE;
+    Xvecs[nvec + 1] = step_mem->Fe[b];
+    nvec += 2;
+  }
+  if (step_mem->implicit)
+  {
+    cvals[nvec]     = ONE;
+    Xvecs[nvec]     = step_mem->Fi[a];
+    cvals[nvec + 1] = -ONE;
+    Xvecs[nvec + 1] = step_mem->Fi[b];
+    nvec += 2;
+  }
+  retval = N_VLinearCombination(nvec, cvals, Xvecs, df);
+  if (retval != 0) { return (ARK_VECTOROP_ERR); }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  arkStep_StiffProbe
+
+  This routine estimates the spectral radius of the Jacobian at
+  the last stage with SW_PROBE_ITERS power iterations on
+  difference quotients of fe + fi, started from the direction v
+  (overwritten). Any failure of the RHS yields the estimate so
+  far (zero if none).
+  ---------------------------------------------------------------*/
+sunrealtype arkStep_StiffProbe(ARKodeMem ark_mem, N_Vector v)
+{
+  ARKodeARKStepMem step_mem = (ARKodeARKStepMem)ark_mem->step_mem;
+  sunrealtype* cvals        = step_mem->cvals;
+  N_Vector* Xvecs           = step_mem->Xvecs;
+  N_Vector zs               = ark_mem->tempv4;
+  N_Vector fs               = ark_mem->tempv3;
+  N_Vector zp               = step_mem->sdata;
+  N_Vector fp               = step_mem->zpred;
+  N_Vector ftmp             = step_mem->zcor;
+  sunrealtype ts, rho, vnrm;
+  int a, i, j, nvec, retval;
+
+  a  = step_mem->stages - 1;
+  ts = ark_mem->tn + step_mem->Bi->c[a] * ark_mem->h;
+
+  /* last stage zs = yn + h sum_j A_{s-1,j} F_j and its RHS fs */
+  nvec     = 1;
+  cvals[0] = ONE;
+  Xvecs[0] = ark_mem->yn;
+  for (j = 0; j <= a; j++)
+  {
+    if (step_mem->explicit)
+    {
+      cvals[nvec] = ark_mem->h * step_mem->Be->A[a][j];
+      Xvecs[nvec] = step_mem->Fe[j];
+      nvec++;
+    }
+    cvals[nvec] = ark_mem->h * step_mem->Bi->A[a][j];
+    Xvecs[nvec] = step_mem->Fi[j];
+    nvec++;
+  }
+  retval = N_VLinearCombination(nvec, cvals, Xvecs, zs);
+  if (retval != 0) { return (ZERO); }
+
+  if (step_mem->explicit)
+  {
+    N_VLinearSum(ONE, step_mem->Fe[a], ONE, step_mem->Fi[a], fs);
+  }
+  else { N_VScale(ONE, step_mem->Fi[a], fs); }
+
+  /* start from v (or fs if v vanishes) with unit norm */
+  vnrm = N_VWrmsNorm(v, ark_mem->ewt);
+  if (vnrm == ZERO)
+  {
+    N_VScale(ONE, fs, v);
+    vnrm = N_VWrmsNorm(v, ark_mem->ewt);
+    if (vnrm == ZERO) { return (ZERO); }
+  }
+  N_VScale(ONE / vnrm, v, v);
+
+  rho = ZERO;
+  for (i = 0; i < SW_PROBE_ITERS; i++)
+  {
+    N_VLinearSum(ONE, zs, ONE, v, zp);
+
+    retval = step_mem->fi(ts, zp, fp, ark_mem->user_data);
+    step_mem->nfi++;
+    if (retval != 0) { break; }
+
+    if (step_mem->explicit)
+    {
+      retval = step_mem->fe(ts, zp, ftmp, ark_mem->user_data);
+      step_mem->nfe++;
+      if (retval != 0) { break; }
+      N_VLinearSum(ONE, fp, ONE, ftmp, fp);
+    }
+
+    N_VLinearSum(ONE, fp, -ONE, fs, v);
+    rho = N_VWrmsNorm(v, ark_mem->ewt);
+    if (rho == ZERO) { break; }
+    N_VScale(ONE / rho, v, v);
+  }
+
+  return (rho);
+}
+
+/*===============================================================
+  Internal utility routines for discrete adjoints
+  ===============================================================*/
+
+/* -----------------------------------------------------------------------------
+ * arkStep_GetAdjointData
+ *
+ * Returns the Butcher table and stage right-hand sides of the last step for
+ * the discrete adjoint. Only purely explicit or purely implicit methods with
+ * an identity mass matrix are supported.
+ * ---------------------------------------------------------------------------*/
+int arkStep_GetAdjointData(ARKodeMem ark_mem, ARKodeButcherTable* B,
+                           N_Vector** F, sunbooleantype* implicit)
+{
+  int retval;
+  ARKodeARKStepMem step_mem;
+
+  retval = arkStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if ((step_mem->explicit && step_mem->implicit) ||
+      step_mem->mass_type != MASS_IDENTITY || step_mem->sw_enabled ||
+      step_mem->nforcing > 0)
+  {
+    arkProcessError(ark_mem, ARK_STEPPER_UNSUPPORTED, __LINE__, __func__,
+                    __FILE__,
+                    "Discrete adjoints are only supported for ERK and DIRK "
+                    "methods with an identity mass matrix and no forcing");
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  if (step_mem->implicit)
+  {
+    *B        = step_mem->Bi;
+    *F        = step_mem->Fi;
+    *implicit = SUNTRUE;
+  }
+  else
+  {
+    *B        = step_mem->Be;
+    *F        = step_mem->Fe;
+    *implicit = SUNFALSE;
+  }
+
+  return (ARK_SUCCESS);
+}
+
 /*===============================================================
   EOF
   ===============================================================*/
@@ -48,6 +48,26 @@ extern "C" {
 /* #define NLSCOEF   SUN_RCONST(0.2)   */ /* CVODE constant */
 #define NLSCOEF SUN_RCONST(0.1)
 
+/* Stiffness detection and explicit/implicit method switching:
+   SW_STIFF        an explicit step is stiff if h * rho exceeds SW_STIFF times
+                   the real stability boundary of the explicit table
+   SW_NONSTIFF     an implicit step is nonstiff if h * rho is below
+                   SW_NONSTIFF times the boundary
+   SW_NSTIFF       consecutive stiff explicit step attempts before switching
+                   to the implicit table
+   SW_NNONSTIFF    consecutive nonstiff explicit attempts resetting the count
+   SW_PROBE        steps between power iteration estimates of rho
+   SW_NPROBE       consecutive estimates favoring the other table before
+                   switching
+   SW_PROBE_ITERS  power iterations per spectral radius estimate */
+#define SW_STIFF       SUN_RCONST(0.75)
+#define SW_NONSTIFF    SUN_RCONST(0.5)
+#define SW_NSTIFF      15
+#define SW_NNONSTIFF   6
+#define SW_PROBE       10
+#define SW_NPROBE      2
+#define SW_PROBE_ITERS 3
+
 /* Mass matrix types */
 #define MASS_IDENTITY 0
 #define MASS_FIXED    1
@@ -163,6 +183,25 @@ typedef struct ARKodeARKStepMemRec
   sunrealtype* stage_times;  /* workspace for applying forcing */
   sunrealtype* stage_coefs;  /* workspace for applying forcing */
 
+  /* Automatic stiffness detection and method switching */
+  sunbooleantype sw_enabled;  /* is method switching enabled?          */
+  sunbooleantype sw_explicit; /* is the explicit table active?         */
+  sunbooleantype sw_pending;  /* switch methods before the next step   */
+  ARKodeButcherTable Bsw;     /* explicit table for nonstiff phases    */
+  sunbooleantype sw_usertable; /* was Bsw supplied by the user?       */
+  ARKodeButcherTable Bi_sw;   /* saved Bi during explicit phases       */
+  ARKodeButcherTable Be_sw;   /* saved Be during explicit phases       */
+  sunrealtype sw_rstab;       /* real stability boundary of Bsw        */
+  sunrealtype sw_rho;         /* last spectral radius estimate         */
+  int sw_nstiff;              /* consecutive stiff explicit attempts   */
+  int sw_nnonstiff;           /* consecutive nonstiff attempts         */
+  int sw_nprobe;              /* steps since the last probe            */
+  int sw_nprobe_hit;          /* consecutive probes favoring a switch  */
+  long int sw_nst_test;       /* step count at the last switch test    */
+  long int sw_nst_count;      /* step count at the last phase update   */
+  long int sw_nswitch;        /* number of method switches             */
+  long int sw_nsteps[2];      /* steps in explicit and implicit phases */
+
 }* ARKodeARKStepMem;
 
 /*===============================================================
@@ -249,6 +288,15 @@ int arkStep_ComputeSolutions_MassFixed(ARKodeMem ark_mem, sunrealtype* dsm);
 void arkStep_ApplyForcing(ARKodeARKStepMem step_mem, sunrealtype* stage_times,
                           sunrealtype* stage_coefs, int jmax, int* nvec);
 
+/* private functions for stiffness detection and method switching */
+int arkStep_StiffSwitchInit(ARKodeMem ark_mem);
+void arkStep_StiffSwitchTables(ARKodeMem ark_mem,
+                               sunbooleantype explicit_phase);
+int arkStep_StiffSwitchStep(ARKodeMem ark_mem);
+int arkStep_StiffSwitchTest(ARKodeMem ark_mem, sunrealtype dsm);
+int arkStep_StiffStageDiff(ARKodeMem ark_mem, N_Vector dz, N_Vector df);
+sunrealtype arkStep_StiffProbe(ARKodeMem ark_mem, N_Vector v);
+
 /* private functions passed to nonlinear solver */
 int arkStep_NlsResidual_MassIdent(N_Vector zcor, N_Vector r, void* arkode_mem);
 int arkStep_NlsResidual_MassIdent_TrivialPredAutonomous(N_Vector zcor, N_Vector r,
@@ -278,6 +326,10 @@ int arkStep_RelaxDeltaE(ARKodeMem ark_mem, ARKRelaxJacFn relax_jac_fn,
                         long int* relax_jac_fn_evals, sunrealtype* delta_e_out);
 int arkStep_GetOrder(ARKodeMem ark_mem);
 
+/* private functions for discrete adjoints */
+int arkStep_GetAdjointData(ARKodeMem ark_mem, ARKodeButcherTable* B,
+                           N_Vector** F, sunbooleantype* implicit);
+
 /*===============================================================
   Reusable ARKStep Error Messages
   ===============================================================*/
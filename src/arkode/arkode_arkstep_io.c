@@ -200,6 +200,7 @@ int ARKStepSetTables(void* arkode_mem, int q, int p, ARKodeButcherTable Bi,
   }
 
   /* clear any existing parameters and Butcher tables */
+  arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
   step_mem->stages = 0;
   step_mem->q      = 0;
   step_mem->p      = 0;
@@ -350,6 +351,7 @@ int ARKStepSetTableNum(void* arkode_mem, ARKODE_DIRKTableID itable,
   if (retval != ARK_SUCCESS) { return (retval); }
 
   /* clear any existing parameters and Butcher tables */
+  arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
   step_mem->stages = 0;
   step_mem->q      = 0;
   step_mem->p      = 0;
@@ -514,6 +516,83 @@ int ARKStepSetTableName(void* arkode_mem, const char* itable, const char* etable
                              arkButcherTableERKNameToID(etable)));
 }
 
+/*---------------------------------------------------------------
+  ARKStepSetStiffnessSwitching:
+
+  Enables or disables automatic stiffness detection and switching
+  between the implicit (or ImEx) method and an explicit method
+  with the same number of stages. The setting takes effect at the
+  next step; when disabled during an explicit phase the implicit
+  method is restored before the next step.
+  ---------------------------------------------------------------*/
+int ARKStepSetStiffnessSwitching(void* arkode_mem, sunbooleantype onoff)
+{
+  ARKodeMem ark_mem;
+  ARKodeARKStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeARKStepMem structures */
+  retval = arkStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* switching is (re-)initialized before the next step */
+  step_mem->sw_enabled = onoff;
+  step_mem->sw_rstab   = ZERO;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ARKStepSetStiffnessSwitchingTable:
+
+  Specifies the explicit Butcher table used in nonstiff phases
+  (a copy is stored). A NULL input restores the default choice.
+  ---------------------------------------------------------------*/
+int ARKStepSetStiffnessSwitchingTable(void* arkode_mem, ARKodeButcherTable Bsw)
+{
+  ARKodeMem ark_mem;
+  ARKodeARKStepMem step_mem;
+  sunindextype Blrw, Bliw;
+  int retval;
+
+  /* access ARKodeMem and ARKodeARKStepMem structures */
+  retval = arkStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* the table cannot be replaced while in use */
+  if (step_mem->sw_explicit)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The method switching table is in use");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* clear any existing table */
+  ARKodeButcherTable_Space(step_mem->Bsw, &Bliw, &Blrw);
+  ARKodeButcherTable_Free(step_mem->Bsw);
+  step_mem->Bsw = NULL;
+  ark_mem->liw -= Bliw;
+  ark_mem->lrw -= Blrw;
+  step_mem->sw_usertable = SUNFALSE;
+
+  if (Bsw == NULL) { return (ARK_SUCCESS); }
+
+  step_mem->Bsw = ARKodeButcherTable_Copy(Bsw);
+  if (step_mem->Bsw == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_FAIL);
+  }
+  ARKodeButcherTable_Space(step_mem->Bsw, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+  step_mem->sw_usertable = SUNTRUE;
+  step_mem->sw_rstab     = ZERO;
+
+  return (ARK_SUCCESS);
+}
+
 /*===============================================================
   Exported optional output functions.
   ===============================================================*/
@@ -624,6 +703,64 @@ int ARKStepGetTimestepperStats(void* arkode_mem, long int* expsteps,
   return (ARK_SUCCESS);
 }
 
+/*---------------------------------------------------------------
+  ARKStepGetStiffnessSwitchingStats:
+
+  Returns the number of method switches and the number of steps
+  taken with the explicit and the implicit method
+  ---------------------------------------------------------------*/
+int ARKStepGetStiffnessSwitchingStats(void* arkode_mem, long int* nswitches,
+                                      long int* nsteps_explicit,
+                                      long int* nsteps_implicit)
+{
+  ARKodeMem ark_mem;
+  ARKodeARKStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeARKStepMem structures */
+  retval = arkStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *nswitches       = step_mem->sw_nswitch;
+  *nsteps_explicit = step_mem->sw_nsteps[0];
+  *nsteps_implicit = step_mem->sw_nsteps[1];
+
+  /* add the steps since the last update to the active method */
+  if (step_mem->sw_enabled || step_mem->sw_explicit)
+  {
+    if (step_mem->sw_explicit)
+    {
+      *nsteps_explicit += ark_mem->nst - step_mem->sw_nst_count;
+    }
+    else { *nsteps_implicit += ark_mem->nst - step_mem->sw_nst_count; }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ARKStepGetStiffnessEstimate:
+
+  Returns the last estimate of the spectral radius of the
+  Jacobian and whether the explicit method is active
+  ---------------------------------------------------------------*/
+int ARKStepGetStiffnessEstimate(void* arkode_mem, sunrealtype* rho,
+                                sunbooleantype* explicit_phase)
+{
+  ARKodeMem ark_mem;
+  ARKodeARKStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeARKStepMem structures */
+  retval = arkStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *rho            = step_mem->sw_rho;
+  *explicit_phase = step_mem->sw_explicit;
+
+  return (ARK_SUCCESS);
+}
+
 /*===============================================================
   Private functions attached to ARKODE
   ===============================================================*/
@@ -712,7 +849,18 @@ int arkStep_SetDefaults(ARKodeMem ark_mem)
   step_mem->convfail = ARK_NO_FAILURES;
   step_mem->stage_predict = NULL; /* no user-supplied stage predictor */
 
-  /* Remove pre-existing Butcher tables */
+  /* Disable method switching and remove pre-existing Butcher tables */
+  arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
+  step_mem->sw_enabled   = SUNFALSE;
+  step_mem->sw_usertable = SUNFALSE;
+  if (step_mem->Bsw)
+  {
+    ARKodeButcherTable_Space(step_mem->Bsw, &Bliw, &Blrw);
+    ark_mem->liw -= Bliw;
+    ark_mem->lrw -= Blrw;
+    ARKodeButcherTable_Free(step_mem->Bsw);
+  }
+  step_mem->Bsw = NULL;
   if (step_mem->Be)
   {
     ARKodeButcherTable_Space(step_mem->Be, &Bliw, &Blrw);
@@ -792,6 +940,7 @@ int arkStep_SetOrder(ARKodeMem ark_mem, int ord)
 
   /* clear Butcher tables, since user is requesting a change in method
      or a reset to defaults.  Tables will be set in ARKInitialSetup. */
+  arkStep_StiffSwitchTables(ark_mem, SUNFALSE);
   step_mem->stages = 0;
   step_mem->istage = 0;
   step_mem->p      = 0;
@@ -1284,12 +1433,18 @@ int arkStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt)
   ARKodeARKStepMem step_mem;
   ARKLsMem arkls_mem;
   ARKLsMassMem arklsm_mem;
+  long int nswitch, nsteps_exp, nsteps_imp;
   int retval;
 
   /* access ARKodeARKStepMem structure */
   retval = arkStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return (retval); }
 
+  /* method switching stats */
+  retval = ARKStepGetStiffnessSwitchingStats(ark_mem, &nswitch, &nsteps_exp,
+                                             &nsteps_imp);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
   switch (fmt)
   {
   case SUN_OUTPUTFORMAT_TABLE:
@@ -1349,6 +1504,14 @@ int arkStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt)
       fprintf(outfile, "Mass-times evals             = %ld\n",
               arklsm_mem->nmtimes);
     }
+
+    /* method switching stats */
+    if (step_mem->sw_enabled || nswitch > 0)
+    {
+      fprintf(outfile, "Stiffness switches           = %ld\n", nswitch);
+      fprintf(outfile, "Explicit phase steps         = %ld\n", nsteps_exp);
+      fprintf(outfile, "Implicit phase steps         = %ld\n", nsteps_imp);
+    }
     break;
 
   case SUN_OUTPUTFORMAT_CSV:
@@ -1409,6 +1572,14 @@ int arkStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt)
       fprintf(outfile, ",Mass-times setups,%ld", arklsm_mem->nmtsetup);
       fprintf(outfile, ",Mass-times evals,%ld", arklsm_mem->nmtimes);
     }
+
+    /* method switching stats */
+    if (step_mem->sw_enabled || nswitch > 0)
+    {
+      fprintf(outfile, ",Stiffness switches,%ld", nswitch);
+      fprintf(outfile, ",Explicit phase steps,%ld", nsteps_exp);
+      fprintf(outfile, ",Implicit phase steps,%ld", nsteps_imp);
+    }
     fprintf(outfile, "\n");
     break;
 
@@ -105,6 +105,7 @@ void* ERKStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0, SUNContext sunctx)
   ark_mem->step_getnumrhsevals      = erkStep_GetNumRhsEvals;
   ark_mem->step_getestlocalerrors   = erkStep_GetEstLocalErrors;
   ark_mem->step_setforcing          = erkStep_SetInnerForcing;
+  ark_mem->step_getadjointdata      = erkStep_GetAdjointData;
   ark_mem->step_supports_adaptive   = SUNTRUE;
   ark_mem->step_supports_relaxation = SUNTRUE;
   ark_mem->step_mem                 = (void*)step_mem;
@@ -290,6 +291,9 @@ void erkStep_Free(ARKodeMem ark_mem)
       ark_mem->lrw -= Blrw;
     }
 
+    /* free the low-storage coefficients */
+    erkStep_FreeLowStorage(ark_mem);
+
     /* free the RHS vectors */
     if (step_mem->F != NULL)
     {
@@ -361,6 +365,7 @@ void erkStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
   fprintf(outfile, "ERKStep: q = %i\n", step_mem->q);
   fprintf(outfile, "ERKStep: p = %i\n", step_mem->p);
   fprintf(outfile, "ERKStep: stages = %i\n", step_mem->stages);
+  fprintf(outfile, "ERKStep: lstype = %i\n", step_mem->lstype);
 
   /* output long integer quantities */
   fprintf(outfile, "ERKStep: nfe = %li\n", step_mem->nfe);
@@ -373,6 +378,7 @@ void erkStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
   /* output vector quantities */
   for (i = 0; i < step_mem->stages; i++)
   {
+    if (step_mem->F[i] == NULL) { continue; }
     fprintf(outfile, "ERKStep: F[%i]:\n", i);
     N_VPrintFile(step_mem->F[i], outfile);
   }
@@ -399,7 +405,7 @@ int erkStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
 {
   ARKodeERKStepMem step_mem;
   sunbooleantype reset_efun;
-  int retval, j;
+  int retval, j, nF;
 
   /* access ARKodeERKStepMem structure */
   retval = erkStep_AccessStepMem(ark_mem, __func__, &step_mem);
@@ -457,14 +463,31 @@ int erkStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
     return (ARK_ILL_INPUT);
   }
 
+  /* Low-storage methods overwrite their registers, so the stage values
+     needed by relaxation are not available */
+  if ((step_mem->lstype != ERK_LS_NONE) && ark_mem->relax_enabled)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Relaxation is not supported with low-storage methods");
+    return (ARK_ILL_INPUT);
+  }
+
   /* Allocate ARK RHS vector memory, update storage requirements */
-  /*   Allocate F[0] ... F[stages-1] if needed */
+  /*   Allocate F[0] ... F[stages-1] if needed, or only F[0] (the RHS at
+       the start of the step) and F[1] (the stage register) when using a
+       low-storage method */
   if (step_mem->F == NULL)
   {
     step_mem->F = (N_Vector*)calloc(step_mem->stages, sizeof(N_Vector));
   }
+  nF = (step_mem->lstype != ERK_LS_NONE) ? 2 : step_mem->stages;
   for (j = 0; j < step_mem->stages; j++)
   {
+    if (j >= nF)
+    {
+      arkFreeVec(ark_mem, &(step_mem->F[j]));
+      continue;
+    }
     if (!arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->F[j])))
     {
       return (ARK_MEM_FAIL);
@@ -641,6 +664,9 @@ int erkStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector f,
       /* First Same As Last methods are not FSAL when relaxation is enabled */
       if (ark_mem->relax_enabled) { recomputeRHS = SUNTRUE; }
 
+      /* Low-storage methods do not retain the last stage RHS */
+      if (step_mem->lstype != ERK_LS_NONE) { recomputeRHS = SUNTRUE; }
+
       /* base RHS call on recomputeRHS argument */
       if (recomputeRHS)
       {
@@ -739,6 +765,12 @@ int erkStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
   retval = erkStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return (retval); }
 
+  /* low-storage methods only keep the stage registers */
+  if (step_mem->lstype != ERK_LS_NONE)
+  {
+    return (erkStep_TakeStepLowStorage(ark_mem, dsmPtr, nflagPtr));
+  }
+
   /* local shortcuts for fused vector operations */
   cvals = step_mem->cvals;
   Xvecs = step_mem->Xvecs;
@@ -1205,6 +1237,397 @@ int erkStep_ComputeSolutions(ARKodeMem ark_mem, sunrealtype* dsmPtr)
   return (ARK_SUCCESS);
 }
 
+/*---------------------------------------------------------------
+  erkStep_TakeStepLowStorage
+
+  This routine performs a single step with a low-storage ERK
+  method.  The stage derivatives K_i = f(tn + c_i h, z_i) are not
+  retained; instead each one is folded into two registers as soon
+  as it is computed:
+
+  2N (Williamson) methods, with A_0 = 0:
+     D   = A_i D + h K_i
+     z   = z + B_i D
+
+  2R (van der Houwen) methods, with x = yn initially:
+     z_{i+1} = x + h a_{i+1,i} K_i
+     x       = x + h b_i K_i
+
+  The solution register (z for 2N, x for 2R) is ark_ycur and the
+  second register is F[1].  F[0] holds f(tn, yn) for the interface
+  with ARKODE.  When an embedding is used, the error
+  h sum_i (b_i - d_i) K_i is accumulated in ark_tempv1 alongside
+  the solution update.
+  ---------------------------------------------------------------*/
+int erkStep_TakeStepLowStorage(ARKodeMem ark_mem, sunrealtype* dsmPtr,
+                               int* nflagPtr)
+{
+  int retval, is, nvec, mode;
+  sunbooleantype estimate;
+  sunrealtype hb, hbd;
+  sunrealtype* cvals;
+  N_Vector* Xvecs;
+  N_Vector K, Z, R, E;
+  ARKodeERKStepMem step_mem;
+
+  /* initialize outputs */
+  *nflagPtr = ARK_SUCCESS;
+  *dsmPtr   = ZERO;
+
+  /* access ARKodeERKStepMem structure */
+  retval = erkStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* local shortcuts for fused vector operations */
+  cvals = step_mem->cvals;
+  Xvecs = step_mem->Xvecs;
+
+  SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = 0, tcur = %" RSYM,
+             ark_mem->tcur);
+  SUNLogExtraDebugVec(ARK_LOGGER, "stage", ark_mem->yn, "z_0(:) =");
+
+  /* The first stage RHS is the full RHS at the start of the step (see
+     erkStep_TakeStep) */
+  if (!(ark_mem->fn_is_current))
+  {
+    mode   = (ark_mem->initsetup) ? ARK_FULLRHS_START : ARK_FULLRHS_END;
+    retval = ark_mem->step_fullrhs(ark_mem, ark_mem->tn, ark_mem->yn,
+                                   ark_mem->fn, mode);
+    if (retval)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      return ARK_RHSFUNC_FAIL;
+    }
+    ark_mem->fn_is_current = SUNTRUE;
+  }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "stage RHS", ark_mem->fn, "F_0(:) =");
+  SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+
+  /* set register shortcuts: Z holds the stage value and R the second
+     register (D for 2N, x for 2R); the step solution ends up in ycur */
+  if (step_mem->lstype == ERK_LS_2N)
+  {
+    Z = ark_mem->ycur;
+    R = step_mem->F[1];
+  }
+  else
+  {
+    Z = step_mem->F[1];
+    R = ark_mem->ycur;
+  }
+  E = ark_mem->tempv1;
+
+  /* error estimation is only performed if requested and possible */
+  estimate = (!ark_mem->fixedstep ||
+              (ark_mem->AccumErrorType != ARK_ACCUMERROR_NONE)) &&
+             (step_mem->B->d != NULL);
+
+  if (step_mem->lstype == ERK_LS_2N) { N_VScale(ONE, ark_mem->yn, Z); }
+  else { N_VScale(ONE, ark_mem->yn, R); }
+  if (estimate) { N_VConst(ZERO, E); }
+
+  for (is = 0; is < step_mem->stages; is++)
+  {
+    /* compute the stage RHS (the first is the full RHS at yn) */
+    if (is == 0) { K = ark_mem->fn; }
+    else
+    {
+      ark_mem->tcur = ark_mem->tn + step_mem->B->c[is] * ark_mem->h;
+
+      SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = %i, tcur = %" RSYM, is,
+                 ark_mem->tcur);
+
+      /* apply user-supplied stage postprocessing function (if supplied) */
+      if (ark_mem->ProcessStage != NULL)
+      {
+        retval = ark_mem->ProcessStage(ark_mem->tcur, Z, ark_mem->user_data);
+        if (retval != 0)
+        {
+          SUNLogInfo(ARK_LOGGER, "end-stage",
+                     "status = failed postprocess stage, retval = %i", retval);
+          return (ARK_POSTPROCESS_STAGE_FAIL);
+        }
+      }
+
+      K      = ark_mem->tempv2;
+      retval = step_mem->f(ark_mem->tcur, Z, K, ark_mem->user_data);
+      step_mem->nfe++;
+
+      SUNLogInfoIf(retval != 0, ARK_LOGGER, "end-stage",
+                   "status = failed rhs eval, retval = %i", retval);
+
+      if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+      if (retval > 0) { return (ARK_UNREC_RHSFUNC_ERR); }
+
+      /* apply external polynomial forcing */
+      if (step_mem->nforcing > 0)
+      {
+        cvals[0] = ONE;
+        Xvecs[0] = K;
+        nvec     = 1;
+        hb       = ONE;
+        erkStep_ApplyForcing(step_mem, &(ark_mem->tcur), &hb, 1, &nvec);
+        retval = N_VLinearCombination(nvec, cvals, Xvecs, K);
+        if (retval != 0) { return (ARK_VECTOROP_ERR); }
+      }
+
+      SUNLogExtraDebugVec(ARK_LOGGER, "stage RHS", K, "F_%i(:) =", is);
+      SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+    }
+
+    /* fold K into the registers */
+    hb  = ark_mem->h * step_mem->B->b[is];
+    hbd = (estimate) ? ark_mem->h * (step_mem->B->b[is] - step_mem->B->d[is])
+                     : ZERO;
+
+    if (step_mem->lstype == ERK_LS_2N)
+    {
+      if (is == 0) { N_VScale(ark_mem->h, K, R); }
+      else { N_VLinearSum(step_mem->lsA[is], R, ark_mem->h, K, R); }
+      N_VLinearSum(ONE, Z, step_mem->lsB[is], R, Z);
+      if (estimate) { N_VLinearSum(ONE, E, hbd, K, E); }
+    }
+    else
+    {
+      /* Z must be formed from x before x is updated */
+      nvec = 0;
+      if (is < step_mem->stages - 1)
+      {
+        cvals[nvec]     = ark_mem->h * step_mem->lsA[is];
+        Xvecs[nvec]     = R;
+        Xvecs[3 + nvec] = Z;
+        nvec++;
+      }
+      cvals[nvec]     = hb;
+      Xvecs[nvec]     = R;
+      Xvecs[3 + nvec] = R;
+      nvec++;
+      if (estimate)
+      {
+        cvals[nvec]     = hbd;
+        Xvecs[nvec]     = E;
+        Xvecs[3 + nvec] = E;
+        nvec++;
+      }
+      retval = N_VScaleAddMulti(nvec, cvals, K, Xvecs, Xvecs + 3);
+      if (retval != 0) { return (ARK_VECTOROP_ERR); }
+    }
+  } /* loop over stages */
+
+  SUNLogInfo(ARK_LOGGER, "begin-compute-solution", "");
+
+  if (estimate) { *dsmPtr = N_VWrmsNorm(E, ark_mem->ewt); }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "updated solution", ark_mem->ycur, "ycur(:) =");
+  SUNLogInfo(ARK_LOGGER, "end-compute-solution", "status = success");
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  erkStep_LoadLowStorageTable
+
+  This routine stores the low-storage coefficients of a built-in
+  method together with the equivalent Butcher table, which is used
+  for the stage times, method orders and embedding.  For a 2N
+  method the Butcher coefficients follow from
+
+     a_{i+1,j} = sum_{m=j}^{i} B_m prod_{l=j+1}^{m} A_l
+
+  and for a 2R method a_{i,j} = b_j for j < i-1.
+  ---------------------------------------------------------------*/
+int erkStep_LoadLowStorageTable(ARKodeMem ark_mem, ARKODE_LSERKTableID ltable)
+{
+  int i, j, m, s, q, p, lstype;
+  sunrealtype aij, prod;
+  sunrealtype A[5], B[5], d[5];
+  ARKodeERKStepMem step_mem;
+  ARKodeButcherTable T;
+  sunindextype Bliw, Blrw;
+
+  /* access ARKodeERKStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ERKSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  step_mem = (ARKodeERKStepMem)ark_mem->step_mem;
+
+  /* fill in the low-storage coefficients (for 2R methods A holds the
+     subdiagonal, B the weights and d the embedding weights) */
+  switch (ltable)
+  {
+  case (ARKODE_CARPENTER_KENNEDY_2N_5_4):
+    lstype = ERK_LS_2N;
+    s      = 5;
+    q      = 4;
+    p      = 0;
+    A[0]   = ZERO;
+    A[1]   = SUN_RCONST(-567301805773.0) / SUN_RCONST(1357537059087.0);
+    A[2]   = SUN_RCONST(-2404267990393.0) / SUN_RCONST(2016746695238.0);
+    A[3]   = SUN_RCONST(-3550918686646.0) / SUN_RCONST(2091501179385.0);
+    A[4]   = SUN_RCONST(-1275806237668.0) / SUN_RCONST(842570457699.0);
+    B[0]   = SUN_RCONST(1432997174477.0) / SUN_RCONST(9575080441755.0);
+    B[1]   = SUN_RCONST(5161836677717.0) / SUN_RCONST(13612068292357.0);
+    B[2]   = SUN_RCONST(1720146321549.0) / SUN_RCONST(2090206949498.0);
+    B[3]   = SUN_RCONST(3134564353537.0) / SUN_RCONST(4481467310338.0);
+    B[4]   = SUN_RCONST(2277821191437.0) / SUN_RCONST(14882151754819.0);
+    break;
+
+  case (ARKODE_KENNEDY_CARPENTER_LEWIS_2R_4_2_3):
+    lstype = ERK_LS_2R;
+    s      = 4;
+    q      = 3;
+    p      = 2;
+    A[0]   = SUN_RCONST(11847461282814.0) / SUN_RCONST(36547543011857.0);
+    A[1]   = SUN_RCONST(3943225443063.0) / SUN_RCONST(7078155732230.0);
+    A[2]   = SUN_RCONST(-346793006927.0) / SUN_RCONST(4029903576067.0);
+    A[3]   = ZERO;
+    B[0]   = SUN_RCONST(1017324711453.0) / SUN_RCONST(9774461848756.0);
+    B[1]   = SUN_RCONST(8237718856693.0) / SUN_RCONST(13685301971492.0);
+    B[2]   = SUN_RCONST(57731312506979.0) / SUN_RCONST(19404895981398.0);
+    B[3]   = SUN_RCONST(-101169746363290.0) / SUN_RCONST(37734290219643.0);
+    d[0]   = SUN_RCONST(15763415370699.0) / SUN_RCONST(46270243929542.0);
+    d[1]   = SUN_RCONST(514528521746.0) / SUN_RCONST(5659431552419.0);
+    d[2]   = SUN_RCONST(27030193851939.0) / SUN_RCONST(9429696342944.0);
+    d[3]   = SUN_RCONST(-69544964788955.0) / SUN_RCONST(30262026368149.0);
+    break;
+
+  case (ARKODE_KENNEDY_CARPENTER_LEWIS_2R_5_3_4):
+    lstype = ERK_LS_2R;
+    s      = 5;
+    q      = 4;
+    p      = 3;
+    A[0]   = SUN_RCONST(970286171893.0) / SUN_RCONST(4311952581923.0);
+    A[1]   = SUN_RCONST(6584761158862.0) / SUN_RCONST(12103376702013.0);
+    A[2]   = SUN_RCONST(2251764453980.0) / SUN_RCONST(15575788980749.0);
+    A[3]   = SUN_RCONST(26877169314380.0) / SUN_RCONST(34165994151039.0);
+    A[4]   = ZERO;
+    B[0]   = SUN_RCONST(1153189308089.0) / SUN_RCONST(22510343858157.0);
+    B[1]   = SUN_RCONST(1772645290293.0) / SUN_RCONST(4653164025191.0);
+    B[2]   = SUN_RCONST(-1672844663538.0) / SUN_RCONST(4480602732383.0);
+    B[3]   = SUN_RCONST(2114624349019.0) / SUN_RCONST(3568978502595.0);
+    B[4]   = SUN_RCONST(5198255086312.0) / SUN_RCONST(14908931495163.0);
+    d[0]   = SUN_RCONST(1016888040809.0) / SUN_RCONST(7410784769900.0);
+    d[1]   = SUN_RCONST(11231460423587.0) / SUN_RCONST(58533540763752.0);
+    d[2]   = SUN_RCONST(-1563879915014.0) / SUN_RCONST(6823010717585.0);
+    d[3]   = SUN_RCONST(606302364029.0) / SUN_RCONST(971179775848.0);
+    d[4]   = SUN_RCONST(1097981568119.0) / SUN_RCONST(3980877426909.0);
+    break;
+
+  default:
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Illegal low-storage table number");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* build the equivalent Butcher table */
+  T = ARKodeButcherTable_Alloc(s, p > 0);
+  if (T == NULL) { return (ARK_MEM_FAIL); }
+  T->q = q;
+  T->p = p;
+
+  if (lstype == ERK_LS_2N)
+  {
+    /* row s of the accumulated coefficients gives the weights b */
+    for (i = 1; i <= s; i++)
+    {
+      for (j = 0; j < i; j++)
+      {
+        aij  = ZERO;
+        prod = ONE;
+        for (m = j; m < i; m++)
+        {
+          if (m > j) { prod *= A[m]; }
+          aij += B[m] * prod;
+        }
+        if (i < s) { T->A[i][j] = aij; }
+        else { T->b[j] = aij; }
+      }
+    }
+  }
+  else
+  {
+    for (i = 1; i < s; i++)
+    {
+      for (j = 0; j < i - 1; j++) { T->A[i][j] = B[j]; }
+      T->A[i][i - 1] = A[i - 1];
+    }
+    for (j = 0; j < s; j++)
+    {
+      T->b[j] = B[j];
+      T->d[j] = d[j];
+    }
+  }
+  for (i = 0; i < s; i++)
+  {
+    T->c[i] = ZERO;
+    for (j = 0; j < i; j++) { T->c[i] += T->A[i][j]; }
+  }
+
+  /* allocate the low-storage coefficient arrays */
+  step_mem->lsA = (sunrealtype*)calloc(s, sizeof(sunrealtype));
+  step_mem->lsB = (sunrealtype*)calloc(s, sizeof(sunrealtype));
+  if ((step_mem->lsA == NULL) || (step_mem->lsB == NULL))
+  {
+    free(step_mem->lsA);
+    free(step_mem->lsB);
+    step_mem->lsA = step_mem->lsB = NULL;
+    ARKodeButcherTable_Free(T);
+    return (ARK_MEM_FAIL);
+  }
+  for (i = 0; i < s; i++)
+  {
+    step_mem->lsA[i] = A[i];
+    step_mem->lsB[i] = B[i];
+  }
+  ark_mem->lrw += 2 * s;
+
+  /* store the table and method parameters */
+  step_mem->B      = T;
+  step_mem->lstype = lstype;
+  step_mem->stages = s;
+  step_mem->q      = q;
+  step_mem->p      = p;
+
+  ARKodeButcherTable_Space(step_mem->B, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  erkStep_FreeLowStorage
+
+  This routine frees the low-storage coefficients (if any) and
+  returns the module to using the full Butcher table.
+  ---------------------------------------------------------------*/
+void erkStep_FreeLowStorage(ARKodeMem ark_mem)
+{
+  ARKodeERKStepMem step_mem;
+
+  if (ark_mem->step_mem == NULL) { return; }
+  step_mem = (ARKodeERKStepMem)ark_mem->step_mem;
+
+  if (step_mem->lsA != NULL)
+  {
+    free(step_mem->lsA);
+    step_mem->lsA = NULL;
+    ark_mem->lrw -= step_mem->stages;
+  }
+  if (step_mem->lsB != NULL)
+  {
+    free(step_mem->lsB);
+    step_mem->lsB = NULL;
+    ark_mem->lrw -= step_mem->stages;
+  }
+  step_mem->lstype = ERK_LS_NONE;
+}
+
 /*===============================================================
   Internal utility routines for relaxation
   ===============================================================*/
@@ -1439,6 +1862,42 @@ int erkStep_SetInnerForcing(ARKodeMem ark_mem, sunrealtype tshift,
   return (ARK_SUCCESS);
 }
 
+/*===============================================================
+  Internal utility routines for discrete adjoints
+  ===============================================================*/
+
+/* -----------------------------------------------------------------------------
+ * erkStep_GetAdjointData
+ *
+ * Returns the Butcher table and stage right-hand sides of the last step for
+ * the discrete adjoint. Low-storage methods do not keep the stages and forcing
+ * terms are not differentiated.
+ * ---------------------------------------------------------------------------*/
+int erkStep_GetAdjointData(ARKodeMem ark_mem, ARKodeButcherTable* B,
+                           N_Vector** F, sunbooleantype* implicit)
+{
+  int retval;
+  ARKodeERKStepMem step_mem;
+
+  retval = erkStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if (step_mem->lstype != ERK_LS_NONE || step_mem->nforcing > 0)
+  {
+    arkProcessError(ark_mem, ARK_STEPPER_UNSUPPORTED, __LINE__, __func__,
+                    __FILE__,
+                    "Discrete adjoints are not supported for low-storage "
+                    "methods or with forcing");
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  *B        = step_mem->B;
+  *F        = step_mem->F;
+  *implicit = SUNFALSE;
+
+  return (ARK_SUCCESS);
+}
+
 /*===============================================================
   EOF
   ===============================================================*/
@@ -31,6 +31,11 @@ extern "C" {
   arkode_impl.h
   ===============================================================*/
 
+/* low-storage register layouts */
+#define ERK_LS_NONE 0 /* full Butcher table storage    */
+#define ERK_LS_2N   1 /* Williamson 2N registers       */
+#define ERK_LS_2R   2 /* van der Houwen 2R registers   */
+
 /*===============================================================
   ERK time step module data structure
   ===============================================================*/
@@ -54,6 +59,14 @@ typedef struct ARKodeERKStepMemRec
   int stages;           /* number of stages           */
   ARKodeButcherTable B; /* ERK Butcher table          */
 
+  /* Low-storage method coefficients (lstype != ERK_LS_NONE).  For
+     2N methods lsA and lsB are the Williamson A_i and B_i, for 2R
+     methods lsA holds the subdiagonal a_{i+1,i} of B->A.  Only F[0]
+     and F[1] are allocated when a low-storage method is used.  */
+  int lstype;       /* low-storage layout (ERK_LS_*)  */
+  sunrealtype* lsA; /* low-storage A coefficients     */
+  sunrealtype* lsB; /* low-storage B coefficients     */
+
   /* Counters */
   long int nfe; /* num fe calls               */
 
@@ -105,6 +118,10 @@ sunbooleantype erkStep_CheckNVector(N_Vector tmpl);
 int erkStep_SetButcherTable(ARKodeMem ark_mem);
 int erkStep_CheckButcherTable(ARKodeMem ark_mem);
 int erkStep_ComputeSolutions(ARKodeMem ark_mem, sunrealtype* dsm);
+int erkStep_TakeStepLowStorage(ARKodeMem ark_mem, sunrealtype* dsmPtr,
+                               int* nflagPtr);
+int erkStep_LoadLowStorageTable(ARKodeMem ark_mem, ARKODE_LSERKTableID ltable);
+void erkStep_FreeLowStorage(ARKodeMem ark_mem);
 void erkStep_ApplyForcing(ARKodeERKStepMem step_mem, sunrealtype* stage_times,
                           sunrealtype* stage_coefs, int jmax, int* nvec);
 
@@ -114,6 +131,10 @@ int erkStep_RelaxDeltaE(ARKodeMem ark_mem, ARKRelaxJacFn relax_jac_fn,
                         long int* relax_jac_fn_evals, sunrealtype* delta_e_out);
 int erkStep_GetOrder(ARKodeMem ark_mem);
 
+/* private functions for discrete adjoints */
+int erkStep_GetAdjointData(ARKodeMem ark_mem, ARKodeButcherTable* B,
+                           N_Vector** F, sunbooleantype* implicit);
+
 /*===============================================================
   Reusable ERKStep Error Messages
   ===============================================================*/
@@ -61,6 +61,7 @@ int ERKStepSetTable(void* arkode_mem, ARKodeButcherTable B)
   }
 
   /* clear any existing parameters and Butcher tables */
+  erkStep_FreeLowStorage(ark_mem);
   step_mem->stages = 0;
   step_mem->q      = 0;
   step_mem->p      = 0;
@@ -119,6 +120,7 @@ int ERKStepSetTableNum(void* arkode_mem, ARKODE_ERKTableID etable)
   }
 
   /* clear any existing parameters and Butcher tables */
+  erkStep_FreeLowStorage(ark_mem);
   step_mem->stages = 0;
   step_mem->q      = 0;
   step_mem->p      = 0;
@@ -160,6 +162,57 @@ int ERKStepSetTableName(void* arkode_mem, const char* etable)
   return ERKStepSetTableNum(arkode_mem, arkButcherTableERKNameToID(etable));
 }
 
+/*---------------------------------------------------------------
+  ERKStepSetLowStorageTableNum:
+
+  Specifies to use a built-in low-storage method.  The step is
+  computed with two stage registers instead of one vector per
+  stage; the equivalent Butcher table is stored for the stage
+  times, orders and embedding.
+  ---------------------------------------------------------------*/
+int ERKStepSetLowStorageTableNum(void* arkode_mem, ARKODE_LSERKTableID ltable)
+{
+  ARKodeMem ark_mem;
+  ARKodeERKStepMem step_mem;
+  sunindextype Blrw, Bliw;
+  int retval;
+
+  /* access ARKodeMem and ARKodeERKStepMem structures */
+  retval = erkStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* check that argument specifies a low-storage table */
+  if (ltable < ARKODE_MIN_LSERK_NUM || ltable > ARKODE_MAX_LSERK_NUM)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Illegal low-storage table number");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* clear any existing parameters and Butcher tables */
+  erkStep_FreeLowStorage(ark_mem);
+  step_mem->stages = 0;
+  step_mem->q      = 0;
+  step_mem->p      = 0;
+
+  ARKodeButcherTable_Space(step_mem->B, &Bliw, &Blrw);
+  ARKodeButcherTable_Free(step_mem->B);
+  step_mem->B = NULL;
+  ark_mem->liw -= Bliw;
+  ark_mem->lrw -= Blrw;
+
+  /* fill in coefficients and table based on argument */
+  retval = erkStep_LoadLowStorageTable(ark_mem, ltable);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Error setting table with that index");
+    return (retval);
+  }
+
+  return (ARK_SUCCESS);
+}
+
 /*===============================================================
   Exported optional output functions.
   ===============================================================*/
@@ -284,6 +337,9 @@ int erkStep_SetDefaults(ARKodeMem ark_mem)
   retval = erkStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return (retval); }
 
+  /* Remove any low-storage method (before the stage count is reset) */
+  erkStep_FreeLowStorage(ark_mem);
+
   /* Set default values for integrator optional inputs */
   step_mem->q      = Q_DEFAULT;                  /* method order */
   step_mem->p      = 0;                          /* embedding order */
@@ -366,6 +422,7 @@ int erkStep_SetOrder(ARKodeMem ark_mem, int ord)
 
   /* clear Butcher tables, since user is requesting a change in method
      or a reset to defaults.  Tables will be set in ARKInitialSetup. */
+  erkStep_FreeLowStorage(ark_mem);
   step_mem->stages = 0;
   step_mem->p      = 0;
 
@@ -450,6 +507,14 @@ int erkStep_WriteParameters(ARKodeMem ark_mem, FILE* fp)
   /* print integrator parameters to file */
   fprintf(fp, "ERKStep time step module parameters:\n");
   fprintf(fp, "  Method order %i\n", step_mem->q);
+  if (step_mem->lstype == ERK_LS_2N)
+  {
+    fprintf(fp, "  Low-storage 2N method with %i stages\n", step_mem->stages);
+  }
+  else if (step_mem->lstype == ERK_LS_2R)
+  {
+    fprintf(fp, "  Low-storage 2R method with %i stages\n", step_mem->stages);
+  }
   fprintf(fp, "\n");
 
   return (ARK_SUCCESS);
@@ -0,0 +1,1326 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for ARKODE's exponential
+ * Rosenbrock (EXP) time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sundials/sundials_context.h>
+#include <sundials/sundials_iterative.h>
+#include <sundials/sundials_math.h>
+
+#include "arkode_expstep_impl.h"
+#include "arkode_impl.h"
+#include "arkode_interp_impl.h"
+
+/*===============================================================
+  Exported functions
+  ===============================================================*/
+
+void* EXPStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0, SUNContext sunctx)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  sunbooleantype nvectorOK;
+  int retval;
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (NULL);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (NULL);
+  }
+
+  if (!sunctx)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_SUNCTX);
+    return (NULL);
+  }
+
+  /* Test if all required vector operations are implemented */
+  nvectorOK = expStep_CheckNVector(y0);
+  if (!nvectorOK)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_BAD_NVECTOR);
+    return (NULL);
+  }
+
+  /* Create ark_mem structure and set default values */
+  ark_mem = arkCreate(sunctx);
+  if (ark_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (NULL);
+  }
+
+  /* Allocate ARKodeEXPStepMem structure, and initialize to zero */
+  step_mem = NULL;
+  step_mem = (ARKodeEXPStepMem)malloc(sizeof(struct ARKodeEXPStepMemRec));
+  if (step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+  memset(step_mem, 0, sizeof(struct ARKodeEXPStepMemRec));
+
+  /* Attach step_mem structure and function pointers to ark_mem */
+  ark_mem->step_attachlinsol      = expStep_AttachLinsol;
+  ark_mem->step_disablelsetup     = expStep_DisableLSetup;
+  ark_mem->step_getlinmem         = expStep_GetLmem;
+  ark_mem->step_getimplicitrhs    = expStep_GetImplicitRHS;
+  ark_mem->step_getgammas         = expStep_GetGammas;
+  ark_mem->step_init              = expStep_Init;
+  ark_mem->step_fullrhs           = expStep_FullRHS;
+  ark_mem->step                   = expStep_TakeStep;
+  ark_mem->step_printallstats     = expStep_PrintAllStats;
+  ark_mem->step_writeparameters   = expStep_WriteParameters;
+  ark_mem->step_resize            = expStep_Resize;
+  ark_mem->step_free              = expStep_Free;
+  ark_mem->step_printmem          = expStep_PrintMem;
+  ark_mem->step_setdefaults       = expStep_SetDefaults;
+  ark_mem->step_setorder          = expStep_SetOrder;
+  ark_mem->step_setautonomous     = expStep_SetAutonomous;
+  ark_mem->step_getnumrhsevals    = expStep_GetNumRhsEvals;
+  ark_mem->step_getestlocalerrors = expStep_GetEstLocalErrors;
+  ark_mem->step_supports_adaptive = SUNTRUE;
+  ark_mem->step_supports_implicit = SUNTRUE;
+  ark_mem->step_mem               = (void*)step_mem;
+
+  /* Set default values for optional inputs */
+  retval = expStep_SetDefaults((void*)ark_mem);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Error setting default solver options");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  /* Allocate the time derivative vector using y0 as a template */
+  /* NOTE: the Krylov workspace will be allocated later on
+     (based on the maximum Krylov dimension) */
+  if (!arkAllocVec(ark_mem, y0, &(step_mem->fdt)))
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Update the ARKODE workspace requirements */
+  ark_mem->liw += 20; /* fcn/data ptr, int, long int, sunindextype, sunbooleantype */
+  ark_mem->lrw += 2;
+
+  /* Set the linear solver addresses to NULL (we check != NULL later) */
+  step_mem->linit = NULL;
+  step_mem->lfree = NULL;
+  step_mem->lmem  = NULL;
+
+  /* Initialize all the counters */
+  step_mem->nfe        = 0;
+  step_mem->nkrylov    = 0;
+  step_mem->nkryfails  = 0;
+  step_mem->maxdimused = 0;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(ark_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  return ((void*)ark_mem);
+}
+
+/*---------------------------------------------------------------
+  EXPStepReInit:
+
+  This routine re-initializes the EXPStep module to solve a new
+  problem of the same size as was previously solved. This routine
+  should also be called when the problem dynamics or desired solvers
+  have changed dramatically, so that the problem integration should
+  resume as if started from scratch.
+
+  Note all internal counters are set to 0 on re-initialization.
+  ---------------------------------------------------------------*/
+int EXPStepReInit(void* arkode_mem, ARKRhsFn f, sunrealtype t0, N_Vector y0)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Check if ark_mem was allocated */
+  if (ark_mem->MallocDone == SUNFALSE)
+  {
+    arkProcessError(ark_mem, ARK_NO_MALLOC, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MALLOC);
+    return (ARK_NO_MALLOC);
+  }
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(arkode_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    return (retval);
+  }
+
+  /* Initialize all the counters */
+  step_mem->nfe        = 0;
+  step_mem->nkrylov    = 0;
+  step_mem->nkryfails  = 0;
+  step_mem->maxdimused = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Interface routines supplied to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  expStep_Resize:
+
+  This routine resizes the memory within the EXPStep module.
+  ---------------------------------------------------------------*/
+int expStep_Resize(ARKodeMem ark_mem, N_Vector y0,
+                   SUNDIALS_MAYBE_UNUSED sunrealtype hscale,
+                   SUNDIALS_MAYBE_UNUSED sunrealtype t0, ARKVecResizeFn resize,
+                   void* resize_data)
+{
+  ARKodeEXPStepMem step_mem;
+  sunindextype lrw1, liw1, lrw_diff, liw_diff;
+  int i, retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Determine change in vector sizes */
+  lrw1 = liw1 = 0;
+  if (y0->ops->nvspace != NULL) { N_VSpace(y0, &lrw1, &liw1); }
+  lrw_diff      = lrw1 - ark_mem->lrw1;
+  liw_diff      = liw1 - ark_mem->liw1;
+  ark_mem->lrw1 = lrw1;
+  ark_mem->liw1 = liw1;
+
+  /* Resize the time derivative vector */
+  if (!arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                    &step_mem->fdt))
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    "Unable to resize vector");
+    return (ARK_MEM_FAIL);
+  }
+  step_mem->fdt_current = SUNFALSE;
+
+  /* Resize the Krylov basis vectors */
+  if (step_mem->V != NULL)
+  {
+    for (i = 0; i <= step_mem->kry_alloc; i++)
+    {
+      if (!arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                        &step_mem->V[i]))
+      {
+        arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                        "Unable to resize vector");
+        return (ARK_MEM_FAIL);
+      }
+    }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_Free frees all EXPStep memory.
+  ---------------------------------------------------------------*/
+void expStep_Free(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+
+  /* nothing to do if ark_mem is already NULL */
+  if (ark_mem == NULL) { return; }
+
+  /* conditional frees on non-NULL EXPStep module */
+  if (ark_mem->step_mem != NULL)
+  {
+    step_mem = (ARKodeEXPStepMem)ark_mem->step_mem;
+
+    /* free the Krylov workspace */
+    expStep_FreeKrylov(ark_mem);
+
+    /* free the linear solver memory */
+    if (step_mem->lfree != NULL)
+    {
+      step_mem->lfree((void*)ark_mem);
+      step_mem->lmem = NULL;
+    }
+
+    /* free the time derivative vector */
+    arkFreeVec(ark_mem, &step_mem->fdt);
+
+    /* free the time stepper module itself */
+    free(ark_mem->step_mem);
+    ark_mem->step_mem = NULL;
+  }
+}
+
+/*---------------------------------------------------------------
+  expStep_PrintMem:
+
+  This routine outputs the memory from the EXPStep structure to
+  a specified file pointer (useful when debugging).
+  ---------------------------------------------------------------*/
+void expStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return; }
+
+  /* output integer quantities */
+  fprintf(outfile, "EXPStep: method = %i\n", step_mem->method);
+  fprintf(outfile, "EXPStep: q = %i\n", step_mem->q);
+  fprintf(outfile, "EXPStep: p = %i\n", step_mem->p);
+  fprintf(outfile, "EXPStep: autonomous = %i\n", step_mem->autonomous);
+  fprintf(outfile, "EXPStep: maxkrylov = %i\n", step_mem->maxkrylov);
+  fprintf(outfile, "EXPStep: maxdimused = %i\n", step_mem->maxdimused);
+
+  /* output long integer quantities */
+  fprintf(outfile, "EXPStep: nfe = %li\n", step_mem->nfe);
+  fprintf(outfile, "EXPStep: nkrylov = %li\n", step_mem->nkrylov);
+  fprintf(outfile, "EXPStep: nkryfails = %li\n", step_mem->nkryfails);
+
+#ifdef SUNDIALS_DEBUG_PRINTVEC
+  /* output vector quantities */
+  fprintf(outfile, "EXPStep: fdt:\n");
+  N_VPrintFile(step_mem->fdt, outfile);
+#endif
+}
+
+/*---------------------------------------------------------------
+  expStep_AttachLinsol:
+
+  This routine attaches the linear solver interface to the
+  EXPStep module.  Only the Jacobian-vector product routines of
+  the interface are used, so the setup and solve routines are
+  ignored.
+  ---------------------------------------------------------------*/
+int expStep_AttachLinsol(ARKodeMem ark_mem, ARKLinsolInitFn linit,
+                         SUNDIALS_MAYBE_UNUSED ARKLinsolSetupFn lsetup,
+                         SUNDIALS_MAYBE_UNUSED ARKLinsolSolveFn lsolve,
+                         ARKLinsolFreeFn lfree,
+                         SUNDIALS_MAYBE_UNUSED SUNLinearSolver_Type lsolve_type,
+                         void* lmem)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* free any existing system solver */
+  if (step_mem->lfree != NULL) { step_mem->lfree(ark_mem); }
+
+  /* Attach the provided routines and data structure */
+  step_mem->linit = linit;
+  step_mem->lfree = lfree;
+  step_mem->lmem  = lmem;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_DisableLSetup:
+
+  The linear solver setup routine is never called by EXPStep, so
+  there is nothing to disable.
+  ---------------------------------------------------------------*/
+void expStep_DisableLSetup(SUNDIALS_MAYBE_UNUSED ARKodeMem ark_mem) {}
+
+/*---------------------------------------------------------------
+  expStep_GetLmem:
+
+  This routine returns the system linear solver interface memory
+  structure, lmem.
+  ---------------------------------------------------------------*/
+void* expStep_GetLmem(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure, and return lmem */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (NULL); }
+  return (step_mem->lmem);
+}
+
+/*---------------------------------------------------------------
+  expStep_GetImplicitRHS:
+
+  This routine returns the RHS function pointer, f, used for
+  difference quotient Jacobian-vector products.
+  ---------------------------------------------------------------*/
+ARKRhsFn expStep_GetImplicitRHS(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure, and return f */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (NULL); }
+  return (step_mem->f);
+}
+
+/*---------------------------------------------------------------
+  expStep_GetGammas:
+
+  No linear systems are solved by EXPStep, so gamma is zero and
+  the gamma ratio is one.
+  ---------------------------------------------------------------*/
+int expStep_GetGammas(ARKodeMem ark_mem, sunrealtype* gamma, sunrealtype* gamrat,
+                      sunbooleantype** jcur, sunbooleantype* dgamma_fail)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* set outputs */
+  *gamma       = ZERO;
+  *gamrat      = ONE;
+  *jcur        = &step_mem->jcur;
+  *dgamma_fail = SUNFALSE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_Init:
+
+  This routine is called just prior to performing internal time
+  steps (after all user "set" routines have been called) from
+  within arkInitialSetup.
+
+  With initialization type FIRST_INIT this routine:
+  - sets the method to be used
+  - allocates the Krylov workspace
+  - checks that the linear solver interface has been attached
+  - sets the call_fullrhs flag
+
+  With initialization types FIRST_INIT or RESIZE_INIT, this
+  routine also initializes the linear solver interface.
+
+  With all initialization types, the time derivative of f is
+  marked as out of date.
+  ---------------------------------------------------------------*/
+int expStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
+                 int init_type)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* f_t must be recomputed at the new initial condition */
+  step_mem->fdt_current = SUNFALSE;
+
+  /* immediately return if reset */
+  if (init_type == RESET_INIT) { return (ARK_SUCCESS); }
+
+  /* initializations/checks for (re-)initialization call */
+  if (init_type == FIRST_INIT)
+  {
+    /* Select the method based on the order (if not already set) */
+    if (step_mem->method == ARKODE_EXP_NONE)
+    {
+      switch (step_mem->q)
+      {
+      case (1):
+      case (2): step_mem->method = EXPSTEP_DEFAULT_2; break;
+      case (3): step_mem->method = EXPSTEP_DEFAULT_3; break;
+      default: /* no available method, set default */
+        arkProcessError(ark_mem, ARK_WARNING, __LINE__, __func__, __FILE__,
+                        "No exponential method at requested order, using q=3.");
+        step_mem->method = EXPSTEP_DEFAULT_3;
+        break;
+      }
+    }
+
+    /* Retrieve/store method and embedding orders */
+    if (step_mem->method == ARKODE_EXPRB_EULER_2)
+    {
+      step_mem->q = 2;
+      step_mem->p = 0;
+    }
+    else
+    {
+      step_mem->q = 3;
+      step_mem->p = 2;
+    }
+    ark_mem->hadapt_mem->q = step_mem->q;
+    ark_mem->hadapt_mem->p = step_mem->p;
+
+    /* Ensure that if adaptivity or error accumulation is enabled, then
+       method includes an error estimate */
+    if ((!ark_mem->fixedstep ||
+         (ark_mem->AccumErrorType != ARK_ACCUMERROR_NONE)) &&
+        (step_mem->p == 0))
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "Temporal error estimation cannot be performed without "
+                      "an embedded method");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Allocate the Krylov workspace */
+    retval = expStep_AllocKrylov(ark_mem);
+    if (retval != ARK_SUCCESS) { return (retval); }
+
+    /* Limit interpolant degree based on method order (use negative
+       argument to specify update instead of overwrite) */
+    if (ark_mem->interp_degree > (step_mem->q - 1))
+    {
+      ark_mem->interp_degree = step_mem->q - 1;
+    }
+
+    /* Jacobian-vector products are provided by the linear solver
+       interface */
+    if (step_mem->lmem == NULL)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "EXPStep requires a linear solver interface for "
+                      "Jacobian-vector products, see ARKodeSetLinearSolver");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Signal to shared arkode module that full RHS evaluations are required */
+    ark_mem->call_fullrhs = SUNTRUE;
+  }
+
+  /* Call linit (if it exists) */
+  if (step_mem->linit)
+  {
+    retval = step_mem->linit(ark_mem);
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_LINIT_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_LINIT_FAIL);
+      return (ARK_LINIT_FAIL);
+    }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*------------------------------------------------------------------------------
+  expStep_FullRHS:
+
+  This is just a wrapper to call the user-supplied RHS function, f(t,y).
+
+  This will be called in one of three 'modes':
+
+     ARK_FULLRHS_START -> called at the beginning of a simulation i.e., at
+                          (tn, yn) = (t0, y0) or (tR, yR), or by EXPStep at
+                          the start of the first internal step.
+
+     ARK_FULLRHS_END   -> called in-between steps t_{n-1} \to t_{n} to fill
+                          f_{n} for root-finding or dense output, or by
+                          EXPStep when starting a time step t_{n} \to t_{n+1}.
+
+                          In both cases the output vector is ark_mem->fn and we
+                          may check the fn_is_current flag to know whether the
+                          values stored there are up-to-date.  Otherwise the
+                          RHS is recomputed and the time derivative of f at
+                          (tn, yn) is marked as out of date.
+
+     ARK_FULLRHS_OTHER -> called when estimating the initial time step size,
+                          for high-order dense output with the Hermite
+                          interpolation module, or by an "outer" stepper.  The
+                          (t,y) input does not correspond to an "official" time
+                          step, thus the RHS is always evaluated.
+  ----------------------------------------------------------------------------*/
+int expStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector f,
+                    int mode)
+{
+  int retval;
+  ARKodeEXPStepMem step_mem;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* perform RHS functions contingent on 'mode' argument */
+  switch (mode)
+  {
+  case ARK_FULLRHS_START:
+  case ARK_FULLRHS_END:
+
+    /* compute the RHS if needed */
+    if (!(ark_mem->fn_is_current))
+    {
+      retval = step_mem->f(t, y, f, ark_mem->user_data);
+      step_mem->nfe++;
+      if (retval != 0)
+      {
+        arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                        MSG_ARK_RHSFUNC_FAILED, t);
+        return (ARK_RHSFUNC_FAIL);
+      }
+      step_mem->fdt_current = SUNFALSE;
+    }
+
+    break;
+
+  case ARK_FULLRHS_OTHER:
+
+    /* call f */
+    retval = step_mem->f(t, y, f, ark_mem->user_data);
+    step_mem->nfe++;
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_RHSFUNC_FAILED, t);
+      return (ARK_RHSFUNC_FAIL);
+    }
+
+    break;
+
+  default:
+    /* return with RHS failure if unknown mode is passed */
+    arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                    "Unknown full RHS mode");
+    return (ARK_RHSFUNC_FAIL);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_TakeStep:
+
+  This routine serves the primary purpose of the EXPStep module:
+  it performs a single exponential Rosenbrock step (with error
+  estimate, if available).  The products of phi functions of hJ
+  with vectors are computed with adaptive Krylov approximations,
+  so that only Jacobian-vector products are required.
+
+  The output variable dsmPtr should contain estimate of the
+  weighted local error if an embedding is present; otherwise it
+  should be 0.
+
+  The input/output variable nflagPtr is set on output to 0
+  (success), CONV_FAIL (a Krylov approximation did not converge
+  or a Jacobian-vector routine failed recoverably), RHSFUNC_RECVR
+  (recoverable RHS failure), or ARK_LSETUP_FAIL or
+  ARK_LSOLVE_FAIL (unrecoverable Jacobian-vector failures).
+
+  The return value from this routine is:
+            0 => step completed successfully
+           >0 => step encountered recoverable failure;
+                 reduce step and retry (if possible)
+           <0 => step encountered unrecoverable failure
+  ---------------------------------------------------------------*/
+int expStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
+{
+  int retval, nvec, mode;
+  sunbooleantype use_fdt;
+  sunrealtype cvals[4];
+  N_Vector Xvecs[4];
+  ARKodeEXPStepMem step_mem;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* initialize output flags */
+  *nflagPtr = ARK_SUCCESS;
+  *dsmPtr   = ZERO;
+
+  SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = 0, tcur = %" RSYM,
+             ark_mem->tcur);
+
+  /* Call the full RHS if needed. If this is the first step then we may need to
+     evaluate the RHS values from an earlier evaluation (e.g., to compute h0).
+     For subsequent steps treat this RHS evaluation as an evaluation at the end
+     of the just completed step. */
+  if (!(ark_mem->fn_is_current))
+  {
+    mode   = (ark_mem->initsetup) ? ARK_FULLRHS_START : ARK_FULLRHS_END;
+    retval = ark_mem->step_fullrhs(ark_mem, ark_mem->tn, ark_mem->yn,
+                                   ark_mem->fn, mode);
+    if (retval)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      return ARK_RHSFUNC_FAIL;
+    }
+    ark_mem->fn_is_current = SUNTRUE;
+  }
+
+  /* Compute the time derivative of f for non-autonomous problems */
+  use_fdt = !step_mem->autonomous;
+  if (use_fdt && !step_mem->fdt_current)
+  {
+    retval = expStep_ComputeFdt(ark_mem);
+    if (retval != ARK_SUCCESS)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      if (retval > 0)
+      {
+        *nflagPtr = RHSFUNC_RECVR;
+        return (TRY_AGAIN);
+      }
+      return (retval);
+    }
+  }
+
+  /* Linearize at (tn, yn) */
+  retval = arkLsJtimesSetup(ark_mem, ark_mem->tn, ark_mem->yn, ark_mem->fn);
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-stage",
+               "status = failed J-times setup, retval = %i", retval);
+    *nflagPtr = (retval < 0) ? ARK_LSETUP_FAIL : CONV_FAIL;
+    return (TRY_AGAIN);
+  }
+
+  /* U = yn + h phi_1(hJ) fn + h^2 phi_2(hJ) ft, stored in ycur */
+  ark_mem->tcur = ark_mem->tn + ark_mem->h;
+  retval = expStep_PhiKrylov(ark_mem, 1, ark_mem->h, ark_mem->fn,
+                             ark_mem->tempv1);
+  if (retval == 0)
+  {
+    N_VLinearSum(ONE, ark_mem->yn, ONE, ark_mem->tempv1, ark_mem->ycur);
+    if (use_fdt)
+    {
+      retval = expStep_PhiKrylov(ark_mem, 2, ark_mem->h * ark_mem->h,
+                                 step_mem->fdt, ark_mem->tempv1);
+      if (retval == 0)
+      {
+        N_VLinearSum(ONE, ark_mem->ycur, ONE, ark_mem->tempv1, ark_mem->ycur);
+      }
+    }
+  }
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-stage",
+               "status = failed Krylov approximation, retval = %i", retval);
+    *nflagPtr = (retval < 0) ? ARK_LSOLVE_FAIL : CONV_FAIL;
+    return (TRY_AGAIN);
+  }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "stage", ark_mem->ycur, "U(:) =");
+  SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+
+  /* exponential Euler has no second stage */
+  if (step_mem->method == ARKODE_EXPRB_EULER_2) { return (ARK_SUCCESS); }
+
+  SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = 1, tcur = %" RSYM,
+             ark_mem->tcur);
+
+  /* apply user-supplied stage postprocessing function (if supplied) */
+  if (ark_mem->ProcessStage != NULL)
+  {
+    retval = ark_mem->ProcessStage(ark_mem->tcur, ark_mem->ycur,
+                                   ark_mem->user_data);
+    if (retval != 0)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed postprocess stage, retval = %i", retval);
+      return (ARK_POSTPROCESS_STAGE_FAIL);
+    }
+  }
+
+  /* D = f(tn + h, U) - fn - J (U - yn) - h ft, stored in tempv2 */
+  retval = step_mem->f(ark_mem->tcur, ark_mem->ycur, ark_mem->tempv2,
+                       ark_mem->user_data);
+  step_mem->nfe++;
+  SUNLogInfoIf(retval != 0, ARK_LOGGER, "end-stage",
+               "status = failed rhs eval, retval = %i", retval);
+  if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+  if (retval > 0)
+  {
+    *nflagPtr = RHSFUNC_RECVR;
+    return (TRY_AGAIN);
+  }
+
+  N_VLinearSum(ONE, ark_mem->ycur, -ONE, ark_mem->yn, ark_mem->tempv3);
+  retval = arkLsJtimes(ark_mem, ark_mem->tempv3, ark_mem->tempv4, ark_mem->tn,
+                       ark_mem->yn, ark_mem->fn);
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-stage",
+               "status = failed J-times, retval = %i", retval);
+    *nflagPtr = (retval < 0) ? ARK_LSOLVE_FAIL : CONV_FAIL;
+    return (TRY_AGAIN);
+  }
+
+  nvec        = 0;
+  cvals[nvec] = ONE;
+  Xvecs[nvec] = ark_mem->tempv2;
+  nvec += 1;
+  cvals[nvec] = -ONE;
+  Xvecs[nvec] = ark_mem->fn;
+  nvec += 1;
+  cvals[nvec] = -ONE;
+  Xvecs[nvec] = ark_mem->tempv4;
+  nvec += 1;
+  if (use_fdt)
+  {
+    cvals[nvec] = -ark_mem->h;
+    Xvecs[nvec] = step_mem->fdt;
+    nvec += 1;
+  }
+  retval = N_VLinearCombination(nvec, cvals, Xvecs, ark_mem->tempv2);
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-stage",
+               "status = failed vector op, retval = %i", retval);
+    return (ARK_VECTOROP_ERR);
+  }
+
+  /* error estimate 2 h phi_3(hJ) D, stored in tempv1 */
+  retval = expStep_PhiKrylov(ark_mem, 3, TWO * ark_mem->h, ark_mem->tempv2,
+                             ark_mem->tempv1);
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-stage",
+               "status = failed Krylov approximation, retval = %i", retval);
+    *nflagPtr = (retval < 0) ? ARK_LSOLVE_FAIL : CONV_FAIL;
+    return (TRY_AGAIN);
+  }
+
+  SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+
+  /* the third order solution, and the error estimate against U */
+  N_VLinearSum(ONE, ark_mem->ycur, ONE, ark_mem->tempv1, ark_mem->ycur);
+  *dsmPtr = N_VWrmsNorm(ark_mem->tempv1, ark_mem->ewt);
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "updated solution", ark_mem->ycur, "ycur(:) =");
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Internal utility routines
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  expStep_AccessARKODEStepMem:
+
+  Shortcut routine to unpack both ark_mem and step_mem structures
+  from void* pointer.  If either is missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int expStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                ARKodeMem* ark_mem, ARKodeEXPStepMem* step_mem)
+{
+  /* access ARKodeMem structure */
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *ark_mem = (ARKodeMem)arkode_mem;
+
+  /* access ARKodeEXPStepMem structure */
+  if ((*ark_mem)->step_mem == NULL)
+  {
+    arkProcessError(*ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_EXPSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeEXPStepMem)(*ark_mem)->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_AccessStepMem:
+
+  Shortcut routine to unpack the step_mem structure from
+  ark_mem.  If missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int expStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                          ARKodeEXPStepMem* step_mem)
+{
+  /* access ARKodeEXPStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_EXPSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeEXPStepMem)ark_mem->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_CheckNVector:
+
+  This routine checks if all required vector operations are
+  present.  If any of them is missing it returns SUNFALSE.
+  ---------------------------------------------------------------*/
+sunbooleantype expStep_CheckNVector(N_Vector tmpl)
+{
+  if ((tmpl->ops->nvclone == NULL) || (tmpl->ops->nvdestroy == NULL) ||
+      (tmpl->ops->nvlinearsum == NULL) || (tmpl->ops->nvconst == NULL) ||
+      (tmpl->ops->nvscale == NULL) || (tmpl->ops->nvwrmsnorm == NULL) ||
+      (tmpl->ops->nvdotprod == NULL))
+  {
+    return (SUNFALSE);
+  }
+  return (SUNTRUE);
+}
+
+/*---------------------------------------------------------------
+  expStep_AllocKrylov:
+
+  Allocates the Krylov basis, the Hessenberg matrix and the
+  arrays for the phi functions of the small projected matrix,
+  reallocating them if the maximum Krylov dimension changed.
+  ---------------------------------------------------------------*/
+int expStep_AllocKrylov(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+  int i, m, naug;
+
+  step_mem = (ARKodeEXPStepMem)ark_mem->step_mem;
+
+  /* nothing to do if the workspace has the right size */
+  if ((step_mem->V != NULL) && (step_mem->kry_alloc == step_mem->maxkrylov))
+  {
+    return (ARK_SUCCESS);
+  }
+  expStep_FreeKrylov(ark_mem);
+
+  m    = step_mem->maxkrylov;
+  naug = m + EXP_MAXPHI + 1;
+
+  /* Krylov basis vectors */
+  step_mem->V = (N_Vector*)calloc(m + 1, sizeof(N_Vector));
+  if (step_mem->V == NULL) { return (ARK_MEM_FAIL); }
+  step_mem->kry_alloc = m;
+  ark_mem->liw += m + 1; /* pointers */
+  for (i = 0; i <= m; i++)
+  {
+    if (!arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->V[i])))
+    {
+      return (ARK_MEM_FAIL);
+    }
+  }
+
+  /* Hessenberg matrix, zero below the subdiagonal */
+  step_mem->Hes = (sunrealtype**)calloc(m + 1, sizeof(sunrealtype*));
+  if (step_mem->Hes == NULL) { return (ARK_MEM_FAIL); }
+  for (i = 0; i <= m; i++)
+  {
+    step_mem->Hes[i] = (sunrealtype*)calloc(m, sizeof(sunrealtype));
+    if (step_mem->Hes[i] == NULL) { return (ARK_MEM_FAIL); }
+  }
+
+  /* augmented matrix, its exponential and work space */
+  step_mem->Aaug = (sunrealtype*)calloc(naug * naug, sizeof(sunrealtype));
+  step_mem->Eaug = (sunrealtype*)calloc(naug * naug, sizeof(sunrealtype));
+  step_mem->Waug = (sunrealtype*)calloc(2 * naug * naug, sizeof(sunrealtype));
+  step_mem->cvals = (sunrealtype*)calloc(2 * (m + 1), sizeof(sunrealtype));
+  if ((step_mem->Aaug == NULL) || (step_mem->Eaug == NULL) ||
+      (step_mem->Waug == NULL) || (step_mem->cvals == NULL))
+  {
+    return (ARK_MEM_FAIL);
+  }
+  ark_mem->lrw += (m + 1) * m + 4 * naug * naug + 2 * (m + 1);
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_FreeKrylov:
+
+  Frees the Krylov workspace.
+  ---------------------------------------------------------------*/
+void expStep_FreeKrylov(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+  int i, m, naug;
+
+  step_mem = (ARKodeEXPStepMem)ark_mem->step_mem;
+  m        = step_mem->kry_alloc;
+  naug     = m + EXP_MAXPHI + 1;
+
+  if (step_mem->V != NULL)
+  {
+    for (i = 0; i <= m; i++) { arkFreeVec(ark_mem, &step_mem->V[i]); }
+    free(step_mem->V);
+    step_mem->V = NULL;
+    ark_mem->liw -= m + 1;
+  }
+
+  if (step_mem->Hes != NULL)
+  {
+    for (i = 0; i <= m; i++) { free(step_mem->Hes[i]); }
+    free(step_mem->Hes);
+    step_mem->Hes = NULL;
+    ark_mem->lrw -= (m + 1) * m + 4 * naug * naug + 2 * (m + 1);
+  }
+
+  free(step_mem->Aaug);
+  free(step_mem->Eaug);
+  free(step_mem->Waug);
+  free(step_mem->cvals);
+  step_mem->Aaug      = NULL;
+  step_mem->Eaug      = NULL;
+  step_mem->Waug      = NULL;
+  step_mem->cvals     = NULL;
+  step_mem->kry_alloc = 0;
+}
+
+/*---------------------------------------------------------------
+  expStep_ComputeFdt:
+
+  Approximates the time derivative of f at (tn, yn) with a
+  forward difference in the direction of integration.
+  ---------------------------------------------------------------*/
+int expStep_ComputeFdt(ARKodeMem ark_mem)
+{
+  int retval;
+  sunrealtype delta;
+  ARKodeEXPStepMem step_mem;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* increment in t with the direction of integration */
+  delta = SUNRsqrt(ark_mem->uround) *
+          SUNMAX(SUNRabs(ark_mem->tn), SUNRabs(ark_mem->h));
+  if (ark_mem->h < ZERO) { delta = -delta; }
+
+  retval = step_mem->f(ark_mem->tn + delta, ark_mem->yn, step_mem->fdt,
+                       ark_mem->user_data);
+  step_mem->nfe++;
+  if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+  if (retval > 0) { return (RHSFUNC_RECVR); }
+
+  N_VLinearSum(ONE / delta, step_mem->fdt, -ONE / delta, ark_mem->fn,
+               step_mem->fdt);
+  step_mem->fdt_current = SUNTRUE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_PhiKrylov:
+
+  Computes x = scale * phi_k(hJ) b with J = df/dy(tn, yn).  The
+  Arnoldi process builds an orthonormal basis V_m of the Krylov
+  space K_m(J, b) and the Hessenberg matrix H_m = V_m^T J V_m, so
+  that phi_k(hJ) b ~ beta V_m phi_k(h H_m) e_1 with beta = ||b||_2.
+  The dimension m is increased until the estimate
+
+    err = |scale| beta h_{m+1,m} |h e_m^T phi_{k+1}(h H_m) e_1|
+          ||v_{m+1}||_WRMS
+
+  of the error (Saad, SIAM J. Numer. Anal. 29, 1992) is below the
+  linear solver tolerance factor (see ARKodeSetEpsLin), or the
+  Arnoldi process breaks down in which case the approximation is
+  exact.
+
+  Returns 0 on success, > 0 if the approximation did not converge
+  within the maximum Krylov dimension or a Jacobian-vector product
+  failed recoverably, and < 0 otherwise.
+  ---------------------------------------------------------------*/
+int expStep_PhiKrylov(ARKodeMem ark_mem, int k, sunrealtype scale, N_Vector b,
+                      N_Vector x)
+{
+  ARKodeEXPStepMem step_mem;
+  ARKLsMem arkls_mem;
+  sunrealtype beta, hnext, hmax, err, tol;
+  sunrealtype* phi;
+  sunbooleantype converged, breakdown;
+  int i, j, m, mcheck, retval;
+
+  step_mem  = (ARKodeEXPStepMem)ark_mem->step_mem;
+  arkls_mem = (ARKLsMem)step_mem->lmem;
+  tol       = arkls_mem->eplifac;
+  phi       = step_mem->cvals;
+
+  /* the product with a zero vector is zero */
+  beta = SUNRsqrt(N_VDotProd(b, b));
+  if (beta == ZERO)
+  {
+    N_VConst(ZERO, x);
+    return (0);
+  }
+  N_VScale(ONE / beta, b, step_mem->V[0]);
+
+  /* Arnoldi process with modified Gram-Schmidt, the error is only checked
+     at geometrically increasing dimensions since every check requires the
+     exponential of a small dense matrix */
+  converged = SUNFALSE;
+  m         = 0;
+  mcheck    = 1;
+  for (j = 0; j < step_mem->maxkrylov; j++)
+  {
+    retval = arkLsJtimes(ark_mem, step_mem->V[j], step_mem->V[j + 1],
+                         ark_mem->tn, ark_mem->yn, ark_mem->fn);
+    step_mem->nkrylov++;
+    if (retval != 0) { return (retval); }
+
+    retval = SUNModifiedGS(step_mem->V, step_mem->Hes, j + 1,
+                           step_mem->maxkrylov, &(step_mem->Hes[j + 1][j]));
+    if (retval != 0) { return (-1); }
+    m = j + 1;
+
+    /* happy breakdown, the Krylov space is invariant */
+    hnext = step_mem->Hes[m][m - 1];
+    hmax  = ZERO;
+    for (i = 0; i < m; i++)
+    {
+      hmax = SUNMAX(hmax, SUNRabs(step_mem->Hes[i][m - 1]));
+    }
+    breakdown = (hnext <= ark_mem->uround * hmax);
+
+    /* normalize the next basis vector */
+    if (!breakdown) { N_VScale(ONE / hnext, step_mem->V[m], step_mem->V[m]); }
+
+    /* skip the error check until the next checkpoint */
+    if (!breakdown && (m < mcheck) && (m < step_mem->maxkrylov)) { continue; }
+    mcheck = m + SUNMAX(1, m / 4);
+
+    /* phi_k(h H_m) e_1 and phi_{k+1}(h H_m) e_1 */
+    retval = expStep_PhiDense(step_mem, m, k, ark_mem->h, phi);
+    if (retval != 0) { return (retval); }
+
+    if (breakdown)
+    {
+      converged = SUNTRUE;
+      break;
+    }
+
+    /* estimate the error */
+    err = SUNRabs(scale) * beta * hnext *
+          SUNRabs(ark_mem->h * phi[m + m - 1]) *
+          N_VWrmsNorm(step_mem->V[m], ark_mem->ewt);
+    if (err <= tol)
+    {
+      converged = SUNTRUE;
+      break;
+    }
+  }
+
+  step_mem->maxdimused = SUNMAX(step_mem->maxdimused, m);
+
+  if (!converged)
+  {
+    step_mem->nkryfails++;
+    return (1);
+  }
+
+  /* x = scale beta V_m phi_k(h H_m) e_1 */
+  for (i = 0; i < m; i++) { phi[i] *= scale * beta; }
+  retval = N_VLinearCombination(m, phi, step_mem->V, x);
+  if (retval != 0) { return (-1); }
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  expStep_PhiDense:
+
+  Computes phi_k(h H_m) e_1 and phi_{k+1}(h H_m) e_1 for the m x m
+  Hessenberg matrix H_m, storing them in phi[0:m-1] and
+  phi[m:2m-1].  Both are read from the exponential of the
+  augmented matrix (Sidje, ACM TOMS 24, 1998)
+
+         [ h H_m  e_1  0 ]
+    A =  [   0     0   I ]   of size m + k + 1,
+         [   0     0   0 ]
+
+  whose column m + j - 1 holds phi_j(h H_m) e_1 in its first m
+  rows.
+  ---------------------------------------------------------------*/
+int expStep_PhiDense(ARKodeEXPStepMem step_mem, int m, int k, sunrealtype h,
+                     sunrealtype* phi)
+{
+  sunrealtype *A, *E;
+  int i, j, n;
+
+  A = step_mem->Aaug;
+  E = step_mem->Eaug;
+  n = m + k + 1;
+
+  for (i = 0; i < n * n; i++) { A[i] = ZERO; }
+  for (i = 0; i < m; i++)
+  {
+    for (j = 0; j < m; j++) { A[i * n + j] = h * step_mem->Hes[i][j]; }
+  }
+  A[m] = ONE;
+  for (j = m; j < n - 1; j++) { A[j * n + j + 1] = ONE; }
+
+  expStep_DenseExp(n, A, E, step_mem->Waug);
+
+  for (i = 0; i < m; i++)
+  {
+    phi[i]     = E[i * n + m + k - 1];
+    phi[m + i] = E[i * n + m + k];
+  }
+
+  /* check for overflow or NaN */
+  for (i = 0; i < 2 * m; i++)
+  {
+    if (!(SUNRabs(phi[i]) < SUN_BIG_REAL)) { return (1); }
+  }
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  expStep_DenseExp:
+
+  Computes E = exp(A) for a small dense n x n matrix A (row-major,
+  overwritten) by scaling and squaring with a truncated Taylor
+  series.  W must hold at least 2 n^2 entries.
+  ---------------------------------------------------------------*/
+void expStep_DenseExp(int n, sunrealtype* A, sunrealtype* E, sunrealtype* W)
+{
+  sunrealtype *T, *P;
+  sunrealtype nrm, rowsum, tnrm, enrm, sum;
+  int i, j, l, s, iter;
+
+  T = W;
+  P = W + n * n;
+
+  /* scale A so that its infinity norm is at most 1/2 */
+  nrm = ZERO;
+  for (i = 0; i < n; i++)
+  {
+    rowsum = ZERO;
+    for (j = 0; j < n; j++) { rowsum += SUNRabs(A[i * n + j]); }
+    nrm = SUNMAX(nrm, rowsum);
+  }
+  s = 0;
+  while ((nrm > HALF) && (s < 1000))
+  {
+    nrm *= HALF;
+    s++;
+  }
+  for (i = 0; i < n * n; i++) { A[i] = SUNRpowerI(HALF, s) * A[i]; }
+
+  /* Taylor series E = sum_l A^l / l! with T the current term */
+  for (i = 0; i < n * n; i++)
+  {
+    E[i] = ZERO;
+    T[i] = ZERO;
+  }
+  for (i = 0; i < n; i++)
+  {
+    E[i * n + i] = ONE;
+    T[i * n + i] = ONE;
+  }
+  for (iter = 1; iter <= EXP_MAXTAYLOR; iter++)
+  {
+    tnrm = ZERO;
+    enrm = ZERO;
+    for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < n; j++)
+      {
+        sum = ZERO;
+        for (l = 0; l < n; l++) { sum += T[i * n + l] * A[l * n + j]; }
+        P[i * n + j] = sum / iter;
+      }
+    }
+    for (i = 0; i < n * n; i++)
+    {
+      T[i] = P[i];
+      E[i] += T[i];
+      tnrm = SUNMAX(tnrm, SUNRabs(T[i]));
+      enrm = SUNMAX(enrm, SUNRabs(E[i]));
+    }
+    if (tnrm <= SUN_UNIT_ROUNDOFF * enrm) { break; }
+  }
+
+  /* undo the scaling by repeated squaring */
+  for (iter = 0; iter < s; iter++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < n; j++)
+      {
+        sum = ZERO;
+        for (l = 0; l < n; l++) { sum += E[i * n + l] * E[l * n + j]; }
+        P[i * n + j] = sum;
+      }
+    }
+    for (i = 0; i < n * n; i++) { E[i] = P[i]; }
+  }
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
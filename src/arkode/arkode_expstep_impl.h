@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * Implementation header file for ARKODE's exponential Rosenbrock
+ * time stepper module.
+ *--------------------------------------------------------------*/
+
+#ifndef _ARKODE_EXPSTEP_IMPL_H
+#define _ARKODE_EXPSTEP_IMPL_H
+
+#include <arkode/arkode_expstep.h>
+
+#include "arkode_impl.h"
+#include "arkode_ls_impl.h"
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/*===============================================================
+  EXP time step module constants
+  ===============================================================*/
+
+#define EXP_Q_DEFAULT  3  /* default method order                */
+#define EXP_MAXKRYLOV  30 /* default maximum Krylov dimension    */
+#define EXP_MAXPHI     3  /* highest phi function used by methods */
+#define EXP_MAXTAYLOR  30 /* max Taylor terms in small exponential */
+
+/*===============================================================
+  EXP time step module data structure
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  Types : struct ARKodeEXPStepMemRec, ARKodeEXPStepMem
+  ---------------------------------------------------------------
+  The type ARKodeEXPStepMem is type pointer to struct
+  ARKodeEXPStepMemRec.  This structure contains fields to
+  perform an exponential Rosenbrock time step.
+
+  With J = df/dy(tn, yn), fn = f(tn, yn) and ft = df/dt(tn, yn)
+  the methods compute
+
+    U    = yn + h phi_1(hJ) fn + h^2 phi_2(hJ) ft
+    D    = f(tn + h, U) - fn - J (U - yn) - h ft
+    yn+1 = U + 2 h phi_3(hJ) D
+
+  where exponential Euler stops after U (order 2) and exprb32
+  (order 3) uses 2 h phi_3(hJ) D as its error estimate.  The
+  products phi_k(hJ) v are approximated in the Krylov space
+  spanned by v, Jv, ..., J^{m-1} v, where m grows until an a
+  posteriori estimate of the error is below the tolerance.
+  ---------------------------------------------------------------*/
+typedef struct ARKodeEXPStepMemRec
+{
+  /* EXP problem specification */
+  ARKRhsFn f;                /* y' = f(t,y)                      */
+  sunbooleantype autonomous; /* f does not depend on t           */
+
+  /* EXP method storage and parameters */
+  N_Vector fdt;               /* df/dt(tn, yn)                    */
+  sunbooleantype fdt_current; /* is fdt up to date?               */
+  ARKODE_EXPMethodID method;  /* method in use                    */
+  int q;                      /* method order                     */
+  int p;                      /* embedding order                  */
+
+  /* Krylov approximation of phi functions */
+  int maxkrylov;      /* maximum Krylov subspace dimension      */
+  int kry_alloc;      /* dimension of the allocated workspace   */
+  N_Vector* V;        /* Krylov basis vectors (maxkrylov+1)     */
+  sunrealtype** Hes;  /* Hessenberg matrix (maxkrylov+1 rows)   */
+  sunrealtype* Aaug;  /* augmented matrix for phi functions     */
+  sunrealtype* Eaug;  /* exponential of the augmented matrix    */
+  sunrealtype* Waug;  /* work array for the small exponential   */
+  sunrealtype* cvals; /* reusable array for fused vector ops    */
+
+  /* Linear solver interface (Jacobian-vector products only) */
+  ARKLinsolInitFn linit;
+  ARKLinsolFreeFn lfree;
+  void* lmem;
+  sunbooleantype jcur; /* required by the ARKLS interface       */
+
+  /* Counters */
+  long int nfe;       /* num f calls                            */
+  long int nkrylov;   /* num Arnoldi iterations                 */
+  long int nkryfails; /* num Krylov convergence failures        */
+  int maxdimused;     /* largest Krylov dimension used          */
+
+}* ARKodeEXPStepMem;
+
+/*===============================================================
+  EXP time step module private function prototypes
+  ===============================================================*/
+
+/* Interface routines supplied to ARKODE */
+int expStep_AttachLinsol(ARKodeMem ark_mem, ARKLinsolInitFn linit,
+                         ARKLinsolSetupFn lsetup, ARKLinsolSolveFn lsolve,
+                         ARKLinsolFreeFn lfree,
+                         SUNLinearSolver_Type lsolve_type, void* lmem);
+void expStep_DisableLSetup(ARKodeMem ark_mem);
+int expStep_Init(ARKodeMem ark_mem, sunrealtype tout, int init_type);
+void* expStep_GetLmem(ARKodeMem ark_mem);
+ARKRhsFn expStep_GetImplicitRHS(ARKodeMem ark_mem);
+int expStep_GetGammas(ARKodeMem ark_mem, sunrealtype* gamma, sunrealtype* gamrat,
+                      sunbooleantype** jcur, sunbooleantype* dgamma_fail);
+int expStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector f,
+                    int mode);
+int expStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr);
+int expStep_SetDefaults(ARKodeMem ark_mem);
+int expStep_SetOrder(ARKodeMem ark_mem, int ord);
+int expStep_SetAutonomous(ARKodeMem ark_mem, sunbooleantype autonomous);
+int expStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt);
+int expStep_WriteParameters(ARKodeMem ark_mem, FILE* fp);
+int expStep_Resize(ARKodeMem ark_mem, N_Vector y0, sunrealtype hscale,
+                   sunrealtype t0, ARKVecResizeFn resize, void* resize_data);
+void expStep_Free(ARKodeMem ark_mem);
+void expStep_PrintMem(ARKodeMem ark_mem, FILE* outfile);
+int expStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                           long int* rhs_evals);
+int expStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele);
+
+/* Internal utility routines */
+int expStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                ARKodeMem* ark_mem, ARKodeEXPStepMem* step_mem);
+int expStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                          ARKodeEXPStepMem* step_mem);
+sunbooleantype expStep_CheckNVector(N_Vector tmpl);
+int expStep_AllocKrylov(ARKodeMem ark_mem);
+void expStep_FreeKrylov(ARKodeMem ark_mem);
+int expStep_ComputeFdt(ARKodeMem ark_mem);
+int expStep_PhiKrylov(ARKodeMem ark_mem, int k, sunrealtype scale, N_Vector b,
+                      N_Vector x);
+int expStep_PhiDense(ARKodeEXPStepMem step_mem, int m, int k, sunrealtype h,
+                     sunrealtype* phi);
+void expStep_DenseExp(int n, sunrealtype* A, sunrealtype* E, sunrealtype* W);
+
+/*===============================================================
+  Reusable EXPStep Error Messages
+  ===============================================================*/
+
+/* Initialization and I/O error messages */
+#define MSG_EXPSTEP_NO_MEM "Time step module memory is NULL."
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,410 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for the optional input and
+ * output functions for the ARKODE EXPStep time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+
+#include "arkode_expstep_impl.h"
+
+/*===============================================================
+  Exported optional input functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  EXPStepSetMethod:
+
+  Specifies to use a built-in exponential Rosenbrock method.
+  Methods without an embedding (exponential Euler) require a
+  fixed step size, see ARKodeSetFixedStep.
+  ---------------------------------------------------------------*/
+int EXPStepSetMethod(void* arkode_mem, ARKODE_EXPMethodID method)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXPStepMem structures */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* check that argument specifies an exponential method */
+  if (method < ARKODE_MIN_EXP_NUM || method > ARKODE_MAX_EXP_NUM)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Illegal exponential method number");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* orders are set in expStep_Init */
+  step_mem->method = method;
+  step_mem->q      = 0;
+  step_mem->p      = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXPStepSetMaxKrylovDim:
+
+  Specifies the maximum dimension of the Krylov subspaces used to
+  approximate the phi functions.  A non-positive input resets the
+  default.
+  ---------------------------------------------------------------*/
+int EXPStepSetMaxKrylovDim(void* arkode_mem, int maxkrylov)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXPStepMem structures */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* the workspace is (re)allocated in expStep_Init */
+  if (maxkrylov <= 0) { step_mem->maxkrylov = EXP_MAXKRYLOV; }
+  else { step_mem->maxkrylov = maxkrylov; }
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Exported optional output functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  EXPStepGetNumKrylovIters:
+
+  Returns the number of Arnoldi iterations, i.e., the number of
+  Jacobian-vector products used to build the Krylov bases.
+  ---------------------------------------------------------------*/
+int EXPStepGetNumKrylovIters(void* arkode_mem, long int* nkrylov)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXPStepMem structures */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *nkrylov = step_mem->nkrylov;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXPStepGetNumKrylovFails:
+
+  Returns the number of Krylov approximations that did not
+  converge within the maximum Krylov dimension.
+  ---------------------------------------------------------------*/
+int EXPStepGetNumKrylovFails(void* arkode_mem, long int* nkryfails)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXPStepMem structures */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *nkryfails = step_mem->nkryfails;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXPStepGetMaxKrylovDimUsed:
+
+  Returns the largest Krylov dimension used so far.
+  ---------------------------------------------------------------*/
+int EXPStepGetMaxKrylovDimUsed(void* arkode_mem, int* maxdimused)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXPStepMem structures */
+  retval = expStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *maxdimused = step_mem->maxdimused;
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Private functions attached to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  expStep_SetDefaults:
+
+  Resets all EXPStep optional inputs to their default values.
+  Does not change problem-defining function pointers or
+  user_data pointer.  Also leaves alone any data
+  structures/options related to the ARKODE infrastructure itself
+  (e.g., root-finding and post-process step).
+  ---------------------------------------------------------------*/
+int expStep_SetDefaults(ARKodeMem ark_mem)
+{
+  ARKodeEXPStepMem step_mem;
+  long int lenrw, leniw;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Set default values for integrator optional inputs */
+  step_mem->q          = EXP_Q_DEFAULT;   /* method order */
+  step_mem->p          = 0;               /* embedding order */
+  step_mem->method     = ARKODE_EXP_NONE; /* set from the order */
+  step_mem->autonomous = SUNFALSE;        /* non-autonomous problem */
+  step_mem->maxkrylov  = EXP_MAXKRYLOV;   /* max Krylov dimension */
+  step_mem->jcur       = SUNFALSE;
+
+  /* Remove pre-existing SUNAdaptController object, and replace with "PID" */
+  if (ark_mem->hadapt_mem->owncontroller)
+  {
+    retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                      &leniw);
+    if (retval == SUN_SUCCESS)
+    {
+      ark_mem->liw -= leniw;
+      ark_mem->lrw -= lenrw;
+    }
+    retval = SUNAdaptController_Destroy(ark_mem->hadapt_mem->hcontroller);
+    ark_mem->hadapt_mem->owncontroller = SUNFALSE;
+    if (retval != SUN_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      "SUNAdaptController_Destroy failure");
+      return (ARK_MEM_FAIL);
+    }
+  }
+  ark_mem->hadapt_mem->hcontroller = SUNAdaptController_PID(ark_mem->sunctx);
+  if (ark_mem->hadapt_mem->hcontroller == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    "SUNAdaptController_PID allocation failure");
+    return (ARK_MEM_FAIL);
+  }
+  ark_mem->hadapt_mem->owncontroller = SUNTRUE;
+  retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                    &leniw);
+  if (retval == SUN_SUCCESS)
+  {
+    ark_mem->liw += leniw;
+    ark_mem->lrw += lenrw;
+  }
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_SetOrder:
+
+  Specifies the method order
+  ---------------------------------------------------------------*/
+int expStep_SetOrder(ARKodeMem ark_mem, int ord)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* clear the method, since user is requesting a change in method
+     or a reset to defaults.  The method will be set in expStep_Init. */
+  step_mem->method = ARKODE_EXP_NONE;
+  step_mem->p      = 0;
+
+  /* set user-provided value, or default, depending on argument */
+  if (ord <= 0) { step_mem->q = EXP_Q_DEFAULT; }
+  else { step_mem->q = ord; }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_SetAutonomous:
+
+  Indicates if the problem is autonomous (True) or non-autonomous
+  (False).  For autonomous problems the time derivative of f is
+  not computed.
+  ---------------------------------------------------------------*/
+int expStep_SetAutonomous(ARKodeMem ark_mem, sunbooleantype autonomous)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  step_mem->autonomous  = autonomous;
+  step_mem->fdt_current = SUNFALSE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_GetNumRhsEvals:
+
+  Returns the current number of RHS calls
+  ---------------------------------------------------------------*/
+int expStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                           long int* rhs_evals)
+{
+  ARKodeEXPStepMem step_mem = NULL;
+
+  /* access ARKodeEXPStepMem structure */
+  int retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  if (rhs_evals == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "rhs_evals is NULL");
+    return ARK_ILL_INPUT;
+  }
+
+  if (partition_index > 0)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid partition index");
+    return ARK_ILL_INPUT;
+  }
+
+  *rhs_evals = step_mem->nfe;
+
+  return ARK_SUCCESS;
+}
+
+/*---------------------------------------------------------------
+  expStep_GetEstLocalErrors: Returns the current local truncation
+  error estimate vector
+  ---------------------------------------------------------------*/
+int expStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele)
+{
+  int retval;
+  ARKodeEXPStepMem step_mem;
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* return an error if local truncation error is not computed */
+  if ((ark_mem->fixedstep && (ark_mem->AccumErrorType == ARK_ACCUMERROR_NONE)) ||
+      (step_mem->p <= 0))
+  {
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  /* otherwise, copy local truncation error vector to output */
+  N_VScale(ONE, ark_mem->tempv1, ele);
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_PrintAllStats:
+
+  Prints integrator statistics
+  ---------------------------------------------------------------*/
+int expStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt)
+{
+  ARKodeEXPStepMem step_mem;
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  switch (fmt)
+  {
+  case SUN_OUTPUTFORMAT_TABLE:
+    /* function evaluations */
+    fprintf(outfile, "RHS fn evals                 = %ld\n", step_mem->nfe);
+
+    /* Krylov approximation stats */
+    fprintf(outfile, "Krylov iters                 = %ld\n", step_mem->nkrylov);
+    fprintf(outfile, "Krylov fails                 = %ld\n",
+            step_mem->nkryfails);
+    fprintf(outfile, "Max Krylov dim used          = %d\n",
+            step_mem->maxdimused);
+    if (ark_mem->step_getlinmem(ark_mem))
+    {
+      arkls_mem = (ARKLsMem)(ark_mem->step_getlinmem(ark_mem));
+      fprintf(outfile, "LS RHS fn evals              = %ld\n", arkls_mem->nfeDQ);
+      fprintf(outfile, "Jac-times setups             = %ld\n",
+              arkls_mem->njtsetup);
+      fprintf(outfile, "Jac-times evals              = %ld\n",
+              arkls_mem->njtimes);
+    }
+    break;
+
+  case SUN_OUTPUTFORMAT_CSV:
+    /* function evaluations */
+    fprintf(outfile, ",RHS fn evals,%ld", step_mem->nfe);
+
+    /* Krylov approximation stats */
+    fprintf(outfile, ",Krylov iters,%ld", step_mem->nkrylov);
+    fprintf(outfile, ",Krylov fails,%ld", step_mem->nkryfails);
+    fprintf(outfile, ",Max Krylov dim used,%d", step_mem->maxdimused);
+    if (ark_mem->step_getlinmem(ark_mem))
+    {
+      arkls_mem = (ARKLsMem)(ark_mem->step_getlinmem(ark_mem));
+      fprintf(outfile, ",LS RHS fn evals,%ld", arkls_mem->nfeDQ);
+      fprintf(outfile, ",Jac-times setups,%ld", arkls_mem->njtsetup);
+      fprintf(outfile, ",Jac-times evals,%ld", arkls_mem->njtimes);
+    }
+    fprintf(outfile, "\n");
+    break;
+
+  default:
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid formatting option.");
+    return (ARK_ILL_INPUT);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  expStep_WriteParameters:
+
+  Outputs all solver parameters to the provided file pointer.
+  ---------------------------------------------------------------*/
+int expStep_WriteParameters(ARKodeMem ark_mem, FILE* fp)
+{
+  ARKodeEXPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXPStepMem structure */
+  retval = expStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* print integrator parameters to file */
+  fprintf(fp, "EXPStep time step module parameters:\n");
+  fprintf(fp, "  Method %i\n", step_mem->method);
+  fprintf(fp, "  Method order %i\n", step_mem->q);
+  fprintf(fp, "  Maximum Krylov dimension %i\n", step_mem->maxkrylov);
+  fprintf(fp, "\n");
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
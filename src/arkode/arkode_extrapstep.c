@@ -0,0 +1,989 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for ARKODE's extrapolation
+ * (EXTRAP) time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sundials/sundials_context.h>
+#include <sundials/sundials_math.h>
+
+#include "arkode_extrapstep_impl.h"
+#include "arkode_impl.h"
+#include "arkode_interp_impl.h"
+
+/*===============================================================
+  Exported functions
+  ===============================================================*/
+
+void* EXTRAPStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0,
+                       SUNContext sunctx)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  sunbooleantype nvectorOK;
+  int retval;
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (NULL);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (NULL);
+  }
+
+  if (!sunctx)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_SUNCTX);
+    return (NULL);
+  }
+
+  /* Test if all required vector operations are implemented */
+  nvectorOK = extrapStep_CheckNVector(y0);
+  if (!nvectorOK)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_BAD_NVECTOR);
+    return (NULL);
+  }
+
+  /* Create ark_mem structure and set default values */
+  ark_mem = arkCreate(sunctx);
+  if (ark_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (NULL);
+  }
+
+  /* Allocate ARKodeEXTRAPStepMem structure, and initialize to zero */
+  step_mem = NULL;
+  step_mem = (ARKodeEXTRAPStepMem)malloc(sizeof(struct ARKodeEXTRAPStepMemRec));
+  if (step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+  memset(step_mem, 0, sizeof(struct ARKodeEXTRAPStepMemRec));
+
+  /* Attach step_mem structure and function pointers to ark_mem */
+  ark_mem->step_init              = extrapStep_Init;
+  ark_mem->step_fullrhs           = extrapStep_FullRHS;
+  ark_mem->step                   = extrapStep_TakeStep;
+  ark_mem->step_printallstats     = extrapStep_PrintAllStats;
+  ark_mem->step_writeparameters   = extrapStep_WriteParameters;
+  ark_mem->step_resize            = extrapStep_Resize;
+  ark_mem->step_free              = extrapStep_Free;
+  ark_mem->step_printmem          = extrapStep_PrintMem;
+  ark_mem->step_setdefaults       = extrapStep_SetDefaults;
+  ark_mem->step_setorder          = extrapStep_SetOrder;
+  ark_mem->step_getnumrhsevals    = extrapStep_GetNumRhsEvals;
+  ark_mem->step_getestlocalerrors = extrapStep_GetEstLocalErrors;
+  ark_mem->step_supports_adaptive = SUNTRUE;
+  ark_mem->step_mem               = (void*)step_mem;
+
+  /* Set default values for optional inputs */
+  retval = extrapStep_SetDefaults((void*)ark_mem);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Error setting default solver options");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  /* NOTE: the sequence vectors will be allocated later on (based on
+     the maximum number of columns) */
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Update the ARKODE workspace requirements */
+  ark_mem->liw += 20; /* fcn/data ptr, int, long int, sunindextype, sunbooleantype */
+  ark_mem->lrw += 0;
+
+  /* Initialize all the counters */
+  step_mem->nfe       = 0;
+  step_mem->nkchanges = 0;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(ark_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  return ((void*)ark_mem);
+}
+
+/*---------------------------------------------------------------
+  EXTRAPStepReInit:
+
+  This routine re-initializes the EXTRAPStep module to solve a new
+  problem of the same size as was previously solved. This routine
+  should also be called when the problem dynamics or desired solvers
+  have changed dramatically, so that the problem integration should
+  resume as if started from scratch.
+
+  Note all internal counters are set to 0 on re-initialization.
+  ---------------------------------------------------------------*/
+int EXTRAPStepReInit(void* arkode_mem, ARKRhsFn f, sunrealtype t0, N_Vector y0)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Check if ark_mem was allocated */
+  if (ark_mem->MallocDone == SUNFALSE)
+  {
+    arkProcessError(ark_mem, ARK_NO_MALLOC, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MALLOC);
+    return (ARK_NO_MALLOC);
+  }
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(arkode_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    return (retval);
+  }
+
+  /* Initialize all the counters */
+  step_mem->nfe       = 0;
+  step_mem->nkchanges = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Interface routines supplied to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  extrapStep_Resize:
+
+  This routine resizes the memory within the EXTRAPStep module.
+  ---------------------------------------------------------------*/
+int extrapStep_Resize(ARKodeMem ark_mem, N_Vector y0,
+                      SUNDIALS_MAYBE_UNUSED sunrealtype hscale,
+                      SUNDIALS_MAYBE_UNUSED sunrealtype t0,
+                      ARKVecResizeFn resize, void* resize_data)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  sunindextype lrw1, liw1, lrw_diff, liw_diff;
+  int j, retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Determine change in vector sizes */
+  lrw1 = liw1 = 0;
+  if (y0->ops->nvspace != NULL) { N_VSpace(y0, &lrw1, &liw1); }
+  lrw_diff      = lrw1 - ark_mem->lrw1;
+  liw_diff      = liw1 - ark_mem->liw1;
+  ark_mem->lrw1 = lrw1;
+  ark_mem->liw1 = liw1;
+
+  /* Resize the sequence vectors */
+  for (j = 0; j < step_mem->kalloc; j++)
+  {
+    if (!arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                      &step_mem->T[j]) ||
+        !arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                      &step_mem->Z[j]) ||
+        !arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                      &step_mem->F[j]))
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      "Unable to resize vector");
+      return (ARK_MEM_FAIL);
+    }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_Free frees all EXTRAPStep memory.
+  ---------------------------------------------------------------*/
+void extrapStep_Free(ARKodeMem ark_mem)
+{
+  /* nothing to do if ark_mem is already NULL */
+  if (ark_mem == NULL) { return; }
+
+  /* conditional frees on non-NULL EXTRAPStep module */
+  if (ark_mem->step_mem != NULL)
+  {
+    /* free the sequence workspace */
+    extrapStep_FreeSequences(ark_mem);
+
+    /* free the time stepper module itself */
+    free(ark_mem->step_mem);
+    ark_mem->step_mem = NULL;
+  }
+}
+
+/*---------------------------------------------------------------
+  extrapStep_PrintMem:
+
+  This routine outputs the memory from the EXTRAPStep structure to
+  a specified file pointer (useful when debugging).
+  ---------------------------------------------------------------*/
+void extrapStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return; }
+
+  /* output integer quantities */
+  fprintf(outfile, "EXTRAPStep: base = %i\n", step_mem->base);
+  fprintf(outfile, "EXTRAPStep: q = %i\n", step_mem->q);
+  fprintf(outfile, "EXTRAPStep: p = %i\n", step_mem->p);
+  fprintf(outfile, "EXTRAPStep: kmax = %i\n", step_mem->kmax);
+  fprintf(outfile, "EXTRAPStep: kfixed = %i\n", step_mem->kfixed);
+  fprintf(outfile, "EXTRAPStep: kcur = %i\n", step_mem->kcur);
+  fprintf(outfile, "EXTRAPStep: knext = %i\n", step_mem->knext);
+  fprintf(outfile, "EXTRAPStep: nthreads = %i\n", step_mem->nthreads);
+
+  /* output long integer quantities */
+  fprintf(outfile, "EXTRAPStep: nfe = %li\n", step_mem->nfe);
+  fprintf(outfile, "EXTRAPStep: nkchanges = %li\n", step_mem->nkchanges);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_Init:
+
+  This routine is called just prior to performing internal time
+  steps (after all user "set" routines have been called) from
+  within arkInitialSetup.
+
+  With initialization type FIRST_INIT this routine:
+  - sets the initial number of columns and the method orders
+  - allocates the sequence workspace
+  - sets the call_fullrhs flag
+
+  With other initialization types, this routine does nothing.
+  ---------------------------------------------------------------*/
+int extrapStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
+                    int init_type)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  sunrealtype tol;
+  int retval, k, ndigits;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* immediately return if resize or reset */
+  if (init_type == RESIZE_INIT || init_type == RESET_INIT)
+  {
+    return (ARK_SUCCESS);
+  }
+
+  /* Select the initial number of columns, either from the requested
+     order or from the number of digits requested by the tolerance
+     (as in ODEX, Hairer, Norsett and Wanner) */
+  if (step_mem->kfixed > 0) { k = step_mem->kfixed; }
+  else
+  {
+    ndigits = 0;
+    for (tol = ark_mem->reltol; (tol < ONE) && (ndigits < 40); tol *= SUN_RCONST(10.0))
+    {
+      ndigits++;
+    }
+    if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+    {
+      k = (int)(SUN_RCONST(0.6) * ndigits + SUN_RCONST(1.5));
+    }
+    else { k = ndigits + 1; }
+    k = SUNMAX(EXTRAP_KMIN, SUNMIN(k, step_mem->kmax - 1));
+  }
+  if (k > step_mem->kmax)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The requested order needs more than the maximum number "
+                    "of columns");
+    return (ARK_ILL_INPUT);
+  }
+  step_mem->kcur = step_mem->knext = k;
+  extrapStep_SetOrders(ark_mem, k);
+
+  /* Ensure that if adaptivity or error accumulation is enabled, then
+     there are at least two columns for an error estimate */
+  if ((!ark_mem->fixedstep || (ark_mem->AccumErrorType != ARK_ACCUMERROR_NONE)) &&
+      (step_mem->p == 0))
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Temporal error estimation cannot be performed with a "
+                    "single column");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Allocate the sequence workspace and compute the step costs */
+  retval = extrapStep_AllocSequences(ark_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+  extrapStep_ComputeCosts(step_mem);
+
+  /* Limit interpolant degree based on the smallest method order */
+  if (ark_mem->interp_degree > (step_mem->q - 1))
+  {
+    ark_mem->interp_degree = step_mem->q - 1;
+  }
+
+  /* Signal to shared arkode module that full RHS evaluations are required */
+  ark_mem->call_fullrhs = SUNTRUE;
+
+  return (ARK_SUCCESS);
+}
+
+/*------------------------------------------------------------------------------
+  extrapStep_FullRHS:
+
+  This is just a wrapper to call the user-supplied RHS function, f(t,y).
+
+  This will be called in one of three 'modes':
+
+     ARK_FULLRHS_START -> called at the beginning of a simulation i.e., at
+                          (tn, yn) = (t0, y0) or (tR, yR), or by EXTRAPStep
+                          at the start of the first internal step.
+
+     ARK_FULLRHS_END   -> called in-between steps t_{n-1} \to t_{n} to fill
+                          f_{n} for root-finding or dense output, or by
+                          EXTRAPStep when starting a time step t_{n} \to
+                          t_{n+1}.
+
+                          In both cases the output vector is ark_mem->fn and we
+                          may check the fn_is_current flag to know whether the
+                          values stored there are up-to-date.
+
+     ARK_FULLRHS_OTHER -> called when estimating the initial time step size,
+                          for high-order dense output with the Hermite
+                          interpolation module, or by an "outer" stepper.  The
+                          (t,y) input does not correspond to an "official" time
+                          step, thus the RHS is always evaluated.
+  ----------------------------------------------------------------------------*/
+int extrapStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y,
+                       N_Vector f, int mode)
+{
+  int retval;
+  ARKodeEXTRAPStepMem step_mem;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* perform RHS functions contingent on 'mode' argument */
+  switch (mode)
+  {
+  case ARK_FULLRHS_START:
+  case ARK_FULLRHS_END:
+
+    /* compute the RHS if needed */
+    if (!(ark_mem->fn_is_current))
+    {
+      retval = step_mem->f(t, y, f, ark_mem->user_data);
+      step_mem->nfe++;
+      if (retval != 0)
+      {
+        arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                        MSG_ARK_RHSFUNC_FAILED, t);
+        return (ARK_RHSFUNC_FAIL);
+      }
+    }
+
+    break;
+
+  case ARK_FULLRHS_OTHER:
+
+    /* call f */
+    retval = step_mem->f(t, y, f, ark_mem->user_data);
+    step_mem->nfe++;
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_RHSFUNC_FAILED, t);
+      return (ARK_RHSFUNC_FAIL);
+    }
+
+    break;
+
+  default:
+    /* return with RHS failure if unknown mode is passed */
+    arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                    "Unknown full RHS mode");
+    return (ARK_RHSFUNC_FAIL);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_TakeStep:
+
+  This routine serves the primary purpose of the EXTRAPStep
+  module: it performs a single extrapolation step with the
+  current number of columns k.  The k base method sequences are
+  independent; they are run longest first on up to nthreads
+  OpenMP threads and then combined with the Aitken-Neville
+  recursion.  When the order is adaptive the number of columns
+  for the next step is selected afterwards.
+
+  The output variable dsmPtr should contain estimate of the
+  weighted local error if an embedding is present; otherwise it
+  should be 0.
+
+  The input/output variable nflagPtr is set on output to 0
+  (success) or RHSFUNC_RECVR (recoverable RHS failure).
+
+  The return value from this routine is:
+            0 => step completed successfully
+           >0 => step encountered recoverable failure;
+                 reduce step and retry (if possible)
+           <0 => step encountered unrecoverable failure
+  ---------------------------------------------------------------*/
+int extrapStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
+{
+  int retval, mode, i, j, k, knew;
+  sunrealtype ratio, fac;
+  N_Vector* T;
+  ARKodeEXTRAPStepMem step_mem;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* initialize output flags */
+  *nflagPtr = ARK_SUCCESS;
+  *dsmPtr   = ZERO;
+
+  SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = 0, tcur = %" RSYM,
+             ark_mem->tcur);
+
+  /* Call the full RHS if needed. If this is the first step then we may need to
+     evaluate the RHS values from an earlier evaluation (e.g., to compute h0).
+     For subsequent steps treat this RHS evaluation as an evaluation at the end
+     of the just completed step. */
+  if (!(ark_mem->fn_is_current))
+  {
+    mode   = (ark_mem->initsetup) ? ARK_FULLRHS_START : ARK_FULLRHS_END;
+    retval = ark_mem->step_fullrhs(ark_mem, ark_mem->tn, ark_mem->yn,
+                                   ark_mem->fn, mode);
+    if (retval)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      return ARK_RHSFUNC_FAIL;
+    }
+    ark_mem->fn_is_current = SUNTRUE;
+  }
+
+  /* set the orders for the columns used in this step */
+  k              = step_mem->knext;
+  step_mem->kcur = k;
+  extrapStep_SetOrders(ark_mem, k);
+
+  SUNLogInfo(ARK_LOGGER, "end-stage", "status = success, columns = %i", k);
+  SUNLogInfo(ARK_LOGGER, "begin-sequences", "columns = %i", k);
+
+  /* run the base method sequences, longest first */
+  for (j = 0; j < k; j++)
+  {
+    step_mem->seqret[j] = 0;
+    step_mem->seqnfe[j] = 0;
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (step_mem->nthreads > 1)
+  {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(step_mem->nthreads)
+    for (i = 0; i < k; i++)
+    {
+      step_mem->seqret[k - 1 - i] = extrapStep_Sequence(ark_mem, k - 1 - i);
+    }
+  }
+  else
+#endif
+  {
+    for (j = k - 1; j >= 0; j--)
+    {
+      step_mem->seqret[j] = extrapStep_Sequence(ark_mem, j);
+      if (step_mem->seqret[j] != 0) { break; }
+    }
+  }
+
+  /* accumulate the RHS evaluations and report the first failure */
+  retval = 0;
+  for (j = k - 1; j >= 0; j--)
+  {
+    step_mem->nfe += step_mem->seqnfe[j];
+    if (retval == 0) { retval = step_mem->seqret[j]; }
+  }
+
+  SUNLogInfoIf(retval != 0, ARK_LOGGER, "end-sequences",
+               "status = failed rhs eval, retval = %i", retval);
+
+  if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+  if (retval > 0)
+  {
+    *nflagPtr = RHSFUNC_RECVR;
+    return (TRY_AGAIN);
+  }
+
+  SUNLogInfo(ARK_LOGGER, "end-sequences", "status = success");
+
+  /* Aitken-Neville extrapolation, column by column in place.  The
+     difference T_{i+1,i+1} - T_{i+1,i} of each diagonal entry is kept
+     in tempv1 for the error estimate with i+1 columns. */
+  T             = step_mem->T;
+  ark_mem->tcur = ark_mem->tn + ark_mem->h;
+  for (i = 1; i < k; i++)
+  {
+    for (j = k - 1; j >= i; j--)
+    {
+      ratio = (sunrealtype)extrapStep_NumSubsteps(step_mem, j) /
+              (sunrealtype)extrapStep_NumSubsteps(step_mem, j - i);
+      if (step_mem->base == ARKODE_EXTRAP_MIDPOINT) { ratio *= ratio; }
+      fac = ONE / (ratio - ONE);
+
+      if (j == i)
+      {
+        N_VLinearSum(fac, T[j], -fac, T[j - 1], ark_mem->tempv1);
+        step_mem->errk[i + 1] = N_VWrmsNorm(ark_mem->tempv1, ark_mem->ewt);
+        N_VLinearSum(ONE, T[j], ONE, ark_mem->tempv1, T[j]);
+      }
+      else { N_VLinearSum(ONE + fac, T[j], -fac, T[j - 1], T[j]); }
+    }
+  }
+
+  /* the solution is the last diagonal entry */
+  N_VScale(ONE, T[k - 1], ark_mem->ycur);
+  if (k >= EXTRAP_KMIN) { *dsmPtr = step_mem->errk[k]; }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "updated solution", ark_mem->ycur, "ycur(:) =");
+
+  /* select the number of columns for the next step */
+  if (step_mem->kfixed == 0 && !ark_mem->fixedstep)
+  {
+    knew = extrapStep_SelectColumns(ark_mem, *dsmPtr);
+    if (knew != k) { step_mem->nkchanges++; }
+    step_mem->knext = knew;
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Internal utility routines
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  extrapStep_AccessARKODEStepMem:
+
+  Shortcut routine to unpack both ark_mem and step_mem structures
+  from void* pointer.  If either is missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int extrapStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                   ARKodeMem* ark_mem,
+                                   ARKodeEXTRAPStepMem* step_mem)
+{
+  /* access ARKodeMem structure */
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *ark_mem = (ARKodeMem)arkode_mem;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  if ((*ark_mem)->step_mem == NULL)
+  {
+    arkProcessError(*ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_EXTRAPSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeEXTRAPStepMem)(*ark_mem)->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_AccessStepMem:
+
+  Shortcut routine to unpack the step_mem structure from
+  ark_mem.  If missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int extrapStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                             ARKodeEXTRAPStepMem* step_mem)
+{
+  /* access ARKodeEXTRAPStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_EXTRAPSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_CheckNVector:
+
+  This routine checks if all required vector operations are
+  present.  If any of them is missing it returns SUNFALSE.
+  ---------------------------------------------------------------*/
+sunbooleantype extrapStep_CheckNVector(N_Vector tmpl)
+{
+  if ((tmpl->ops->nvclone == NULL) || (tmpl->ops->nvdestroy == NULL) ||
+      (tmpl->ops->nvlinearsum == NULL) || (tmpl->ops->nvconst == NULL) ||
+      (tmpl->ops->nvscale == NULL) || (tmpl->ops->nvwrmsnorm == NULL))
+  {
+    return (SUNFALSE);
+  }
+  return (SUNTRUE);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_AllocSequences:
+
+  Allocates the vectors and arrays for kmax sequences,
+  reallocating them if the maximum number of columns changed.
+  The midpoint vectors Z are only allocated for the midpoint
+  base method.
+  ---------------------------------------------------------------*/
+int extrapStep_AllocSequences(ARKodeMem ark_mem)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int j, kmax;
+
+  step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+  kmax     = step_mem->kmax;
+
+  /* release a workspace of a different size */
+  if ((step_mem->T != NULL) && (step_mem->kalloc != kmax))
+  {
+    extrapStep_FreeSequences(ark_mem);
+  }
+
+  if (step_mem->T == NULL)
+  {
+    step_mem->T      = (N_Vector*)calloc(kmax, sizeof(N_Vector));
+    step_mem->Z      = (N_Vector*)calloc(kmax, sizeof(N_Vector));
+    step_mem->F      = (N_Vector*)calloc(kmax, sizeof(N_Vector));
+    step_mem->seqret = (int*)calloc(kmax, sizeof(int));
+    step_mem->seqnfe = (long int*)calloc(kmax, sizeof(long int));
+    step_mem->cost   = (sunrealtype*)calloc(kmax + 1, sizeof(sunrealtype));
+    step_mem->errk   = (sunrealtype*)calloc(kmax + 1, sizeof(sunrealtype));
+    step_mem->kalloc = kmax;
+    if ((step_mem->T == NULL) || (step_mem->Z == NULL) ||
+        (step_mem->F == NULL) || (step_mem->seqret == NULL) ||
+        (step_mem->seqnfe == NULL) || (step_mem->cost == NULL) ||
+        (step_mem->errk == NULL))
+    {
+      extrapStep_FreeSequences(ark_mem);
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_MEM_FAIL);
+      return (ARK_MEM_FAIL);
+    }
+    ark_mem->liw += 5 * kmax;
+    ark_mem->lrw += 2 * (kmax + 1);
+  }
+
+  /* allocate (or release) the sequence vectors */
+  for (j = 0; j < kmax; j++)
+  {
+    if (!arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->T[j])) ||
+        !arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->F[j])))
+    {
+      return (ARK_MEM_FAIL);
+    }
+    if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+    {
+      if (!arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->Z[j])))
+      {
+        return (ARK_MEM_FAIL);
+      }
+    }
+    else { arkFreeVec(ark_mem, &(step_mem->Z[j])); }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_FreeSequences:
+
+  Frees the sequence vectors and arrays.
+  ---------------------------------------------------------------*/
+void extrapStep_FreeSequences(ARKodeMem ark_mem)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int j, kalloc;
+
+  step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+  kalloc   = step_mem->kalloc;
+
+  for (j = 0; j < kalloc; j++)
+  {
+    if (step_mem->T != NULL) { arkFreeVec(ark_mem, &(step_mem->T[j])); }
+    if (step_mem->Z != NULL) { arkFreeVec(ark_mem, &(step_mem->Z[j])); }
+    if (step_mem->F != NULL) { arkFreeVec(ark_mem, &(step_mem->F[j])); }
+  }
+  if (step_mem->T != NULL)
+  {
+    ark_mem->liw -= 5 * kalloc;
+    ark_mem->lrw -= 2 * (kalloc + 1);
+  }
+
+  free(step_mem->T);
+  free(step_mem->Z);
+  free(step_mem->F);
+  free(step_mem->seqret);
+  free(step_mem->seqnfe);
+  free(step_mem->cost);
+  free(step_mem->errk);
+  step_mem->T      = NULL;
+  step_mem->Z      = NULL;
+  step_mem->F      = NULL;
+  step_mem->seqret = NULL;
+  step_mem->seqnfe = NULL;
+  step_mem->cost   = NULL;
+  step_mem->errk   = NULL;
+  step_mem->kalloc = 0;
+}
+
+/*---------------------------------------------------------------
+  extrapStep_NumSubsteps:
+
+  Returns the number of substeps n_j of sequence j (zero-based),
+  the harmonic sequence n_j = j+1 for explicit Euler and the
+  Bulirsch-Stoer-Deuflhard sequence n_j = 2(j+1) for the midpoint
+  rule.
+  ---------------------------------------------------------------*/
+int extrapStep_NumSubsteps(ARKodeEXTRAPStepMem step_mem, int j)
+{
+  if (step_mem->base == ARKODE_EXTRAP_MIDPOINT) { return (2 * (j + 1)); }
+  return (j + 1);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_SetOrders:
+
+  Sets the method and embedding orders for k columns, T_{k,k} and
+  T_{k,k-1}, in the step and adaptivity memory.
+  ---------------------------------------------------------------*/
+void extrapStep_SetOrders(ARKodeMem ark_mem, int k)
+{
+  ARKodeEXTRAPStepMem step_mem;
+
+  step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+
+  if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+  {
+    step_mem->q = 2 * k;
+    step_mem->p = 2 * k - 2;
+  }
+  else
+  {
+    step_mem->q = k;
+    step_mem->p = k - 1;
+  }
+  ark_mem->hadapt_mem->q = step_mem->q;
+  ark_mem->hadapt_mem->p = step_mem->p;
+}
+
+/*---------------------------------------------------------------
+  extrapStep_ComputeCosts:
+
+  Computes the cost of a step with k columns in units of RHS
+  evaluations on the critical path: the shared evaluation
+  f(tn, yn) plus the largest load of any thread when the
+  sequences are handed out longest first to the least loaded of
+  nthreads threads.  With a single thread this is the total
+  number of evaluations.
+  ---------------------------------------------------------------*/
+void extrapStep_ComputeCosts(ARKodeEXTRAPStepMem step_mem)
+{
+  sunrealtype load[EXTRAP_KMAX_LIMIT];
+  sunrealtype makespan;
+  int i, j, k, nthr, imin;
+
+  for (k = 1; k <= step_mem->kmax; k++)
+  {
+    nthr = SUNMAX(1, SUNMIN(step_mem->nthreads, k));
+    for (i = 0; i < nthr; i++) { load[i] = ZERO; }
+
+    for (j = k - 1; j >= 0; j--)
+    {
+      imin = 0;
+      for (i = 1; i < nthr; i++)
+      {
+        if (load[i] < load[imin]) { imin = i; }
+      }
+      load[imin] += (sunrealtype)(extrapStep_NumSubsteps(step_mem, j) - 1);
+    }
+
+    makespan = ZERO;
+    for (i = 0; i < nthr; i++) { makespan = SUNMAX(makespan, load[i]); }
+    step_mem->cost[k] = ONE + makespan;
+  }
+}
+
+/*---------------------------------------------------------------
+  extrapStep_Sequence:
+
+  Computes T_{j+1,1} by taking n_j substeps of size h/n_j with the
+  base method from (tn, yn), reusing fn for the first substep.
+  Only the vectors of sequence j are written, so sequences may be
+  run concurrently.  Returns the value of the first failed RHS
+  call, or 0.
+  ---------------------------------------------------------------*/
+int extrapStep_Sequence(ARKodeMem ark_mem, int j)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  N_Vector Tj, Zj, Fj, swap;
+  sunrealtype hs;
+  int m, n, retval;
+
+  step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+
+  n  = extrapStep_NumSubsteps(step_mem, j);
+  hs = ark_mem->h / n;
+  Tj = step_mem->T[j];
+  Zj = step_mem->Z[j];
+  Fj = step_mem->F[j];
+
+  /* the first substep is an Euler step for both base methods */
+  N_VLinearSum(ONE, ark_mem->yn, hs, ark_mem->fn, Tj);
+  if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+  {
+    N_VScale(ONE, ark_mem->yn, Zj);
+  }
+
+  for (m = 1; m < n; m++)
+  {
+    retval = step_mem->f(ark_mem->tn + m * hs, Tj, Fj, ark_mem->user_data);
+    step_mem->seqnfe[j]++;
+    if (retval != 0) { return (retval); }
+
+    if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+    {
+      /* z_{m+1} = z_{m-1} + 2 hs f(z_m), then shift the pair */
+      N_VLinearSum(ONE, Zj, TWO * hs, Fj, Zj);
+      swap = Tj;
+      Tj   = Zj;
+      Zj   = swap;
+    }
+    else { N_VLinearSum(ONE, Tj, hs, Fj, Tj); }
+  }
+
+  /* keep the final value in T[j] */
+  step_mem->T[j] = Tj;
+  step_mem->Z[j] = Zj;
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_SelectColumns:
+
+  Selects the number of columns for the next step by comparing
+  the work per unit step W_j = cost_j / H_j, where H_j is the
+  step size predicted by the error estimate with j columns
+  (Hairer, Norsett and Wanner, Sec. II.9).  The number of columns
+  is decreased if W_{k-1} < 0.8 W_k, and increased if
+  W_k < 0.9 W_{k-1} and the step was accepted.
+  ---------------------------------------------------------------*/
+int extrapStep_SelectColumns(ARKodeMem ark_mem, sunrealtype dsm)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  sunrealtype work[EXTRAP_KMAX_LIMIT + 1];
+  sunrealtype err;
+  int j, k, pe, knew;
+
+  step_mem = (ARKodeEXTRAPStepMem)ark_mem->step_mem;
+  k        = step_mem->kcur;
+
+  /* work per unit step for k-1 and k columns */
+  for (j = SUNMAX(EXTRAP_KMIN, k - 1); j <= k; j++)
+  {
+    err     = SUNMAX(step_mem->errk[j], SUN_RCONST(1.0e-10));
+    pe      = (step_mem->base == ARKODE_EXTRAP_MIDPOINT) ? 2 * j - 2 : j - 1;
+    work[j] = step_mem->cost[j] *
+              SUNRpowerR(err, ONE / (sunrealtype)(pe + 1)) /
+              SUNRabs(ark_mem->h);
+  }
+
+  knew = k;
+  if ((k > EXTRAP_KMIN) && (work[k - 1] < EXTRAP_DECREASE * work[k]))
+  {
+    knew = k - 1;
+  }
+  else if ((dsm <= ONE) &&
+           ((k == EXTRAP_KMIN) || (work[k] < EXTRAP_INCREASE * work[k - 1])))
+  {
+    knew = k + 1;
+  }
+
+  return (SUNMAX(EXTRAP_KMIN, SUNMIN(knew, step_mem->kmax)));
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
@@ -0,0 +1,141 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * Implementation header file for ARKODE's extrapolation time
+ * stepper module.
+ *--------------------------------------------------------------*/
+
+#ifndef _ARKODE_EXTRAPSTEP_IMPL_H
+#define _ARKODE_EXTRAPSTEP_IMPL_H
+
+#include <arkode/arkode_extrapstep.h>
+
+#include "arkode_impl.h"
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/*===============================================================
+  EXTRAP time step module constants
+  ===============================================================*/
+
+#define EXTRAP_KMAX_DEFAULT 8  /* default maximum number of columns  */
+#define EXTRAP_KMAX_LIMIT   12 /* largest allowed number of columns  */
+#define EXTRAP_KMIN         2  /* columns needed for an estimate     */
+
+/* order selection thresholds on the work per unit step */
+#define EXTRAP_DECREASE SUN_RCONST(0.8)
+#define EXTRAP_INCREASE SUN_RCONST(0.9)
+
+/*===============================================================
+  EXTRAP time step module data structure
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  Types : struct ARKodeEXTRAPStepMemRec, ARKodeEXTRAPStepMem
+  ---------------------------------------------------------------
+  The type ARKodeEXTRAPStepMem is type pointer to struct
+  ARKodeEXTRAPStepMemRec.  This structure contains fields to
+  perform an extrapolation time step.
+
+  Each step with k columns computes T_{j,1}, j = 1, ..., k, by
+  taking n_j substeps of size h/n_j with the base method, where
+  n_j = j for explicit Euler and n_j = 2j for the Gragg midpoint
+  rule.  The sequences are independent and are run concurrently
+  when more than one thread is requested.  The Aitken-Neville
+  recursion
+
+    T_{j,i+1} = T_{j,i} + (T_{j,i} - T_{j-1,i}) / ((n_j/n_{j-i})^g - 1)
+
+  with g = 1 (Euler) or g = 2 (midpoint) gives the solution
+  T_{k,k} and the error estimate T_{k,k} - T_{k,k-1}.
+  ---------------------------------------------------------------*/
+typedef struct ARKodeEXTRAPStepMemRec
+{
+  /* EXTRAP problem specification */
+  ARKRhsFn f; /* y' = f(t,y)                      */
+
+  /* EXTRAP method parameters */
+  ARKODE_ExtrapBaseID base; /* base method                     */
+  int kmax;                 /* maximum number of columns       */
+  int kfixed;               /* columns set by order (0: adapt) */
+  int kcur;                 /* columns in the current step     */
+  int knext;                /* columns for the next step       */
+  int q;                    /* method order                    */
+  int p;                    /* embedding order                 */
+  int nthreads;             /* threads for the sequences       */
+
+  /* Sequence storage (kalloc sequences) */
+  int kalloc;        /* number of allocated sequences           */
+  N_Vector* T;       /* extrapolation tableau row for each n_j  */
+  N_Vector* Z;       /* previous midpoint value for each n_j    */
+  N_Vector* F;       /* RHS work vector for each n_j            */
+  int* seqret;       /* return flag of each sequence            */
+  long int* seqnfe;  /* RHS evaluations of each sequence        */
+  sunrealtype* cost; /* cost of a step with k columns           */
+  sunrealtype* errk; /* error estimate with k columns           */
+
+  /* Counters */
+  long int nfe;       /* num f calls                            */
+  long int nkchanges; /* num changes in the number of columns   */
+
+}* ARKodeEXTRAPStepMem;
+
+/*===============================================================
+  EXTRAP time step module private function prototypes
+  ===============================================================*/
+
+/* Interface routines supplied to ARKODE */
+int extrapStep_Init(ARKodeMem ark_mem, sunrealtype tout, int init_type);
+int extrapStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y,
+                       N_Vector f, int mode);
+int extrapStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr);
+int extrapStep_SetDefaults(ARKodeMem ark_mem);
+int extrapStep_SetOrder(ARKodeMem ark_mem, int ord);
+int extrapStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile,
+                             SUNOutputFormat fmt);
+int extrapStep_WriteParameters(ARKodeMem ark_mem, FILE* fp);
+int extrapStep_Resize(ARKodeMem ark_mem, N_Vector y0, sunrealtype hscale,
+                      sunrealtype t0, ARKVecResizeFn resize, void* resize_data);
+void extrapStep_Free(ARKodeMem ark_mem);
+void extrapStep_PrintMem(ARKodeMem ark_mem, FILE* outfile);
+int extrapStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                              long int* rhs_evals);
+int extrapStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele);
+
+/* Internal utility routines */
+int extrapStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                   ARKodeMem* ark_mem,
+                                   ARKodeEXTRAPStepMem* step_mem);
+int extrapStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                             ARKodeEXTRAPStepMem* step_mem);
+sunbooleantype extrapStep_CheckNVector(N_Vector tmpl);
+int extrapStep_AllocSequences(ARKodeMem ark_mem);
+void extrapStep_FreeSequences(ARKodeMem ark_mem);
+int extrapStep_NumSubsteps(ARKodeEXTRAPStepMem step_mem, int j);
+void extrapStep_SetOrders(ARKodeMem ark_mem, int k);
+void extrapStep_ComputeCosts(ARKodeEXTRAPStepMem step_mem);
+int extrapStep_Sequence(ARKodeMem ark_mem, int j);
+int extrapStep_SelectColumns(ARKodeMem ark_mem, sunrealtype dsm);
+
+/*===============================================================
+  Reusable EXTRAPStep Error Messages
+  ===============================================================*/
+
+/* Initialization and I/O error messages */
+#define MSG_EXTRAPSTEP_NO_MEM "Time step module memory is NULL."
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
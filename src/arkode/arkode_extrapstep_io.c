@@ -0,0 +1,393 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for the optional input and
+ * output functions for the ARKODE EXTRAPStep time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+
+#include "arkode_extrapstep_impl.h"
+
+/*===============================================================
+  Exported optional input functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  EXTRAPStepSetBaseMethod:
+
+  Specifies the base method for the extrapolation sequences,
+  explicit Euler or the Gragg midpoint rule.
+  ---------------------------------------------------------------*/
+int EXTRAPStepSetBaseMethod(void* arkode_mem, ARKODE_ExtrapBaseID base)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXTRAPStepMem structures */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* check that argument specifies a base method */
+  if (base < ARKODE_MIN_EXTRAP_NUM || base > ARKODE_MAX_EXTRAP_NUM)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Illegal extrapolation base method");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* the workspace and orders are set in extrapStep_Init */
+  step_mem->base = base;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXTRAPStepSetMaxColumns:
+
+  Specifies the maximum number of columns (base method sequences)
+  in the extrapolation tableau.  A non-positive input resets the
+  default.
+  ---------------------------------------------------------------*/
+int EXTRAPStepSetMaxColumns(void* arkode_mem, int kmax)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXTRAPStepMem structures */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if (kmax <= 0) { kmax = EXTRAP_KMAX_DEFAULT; }
+  if (kmax < EXTRAP_KMIN || kmax > EXTRAP_KMAX_LIMIT)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The maximum number of columns must be between %i and %i",
+                    EXTRAP_KMIN, EXTRAP_KMAX_LIMIT);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* the workspace is (re)allocated in extrapStep_Init */
+  step_mem->kmax = kmax;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXTRAPStepSetNumThreads:
+
+  Specifies the number of OpenMP threads used to run the base
+  method sequences concurrently.  A non-positive input resets the
+  default of one thread.
+  ---------------------------------------------------------------*/
+int EXTRAPStepSetNumThreads(void* arkode_mem, int nthreads)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXTRAPStepMem structures */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  if (nthreads <= 0) { nthreads = 1; }
+
+#if !defined(SUNDIALS_OPENMP_ENABLED)
+  if (nthreads > 1)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "SUNDIALS was not built with OpenMP enabled");
+    return (ARK_ILL_INPUT);
+  }
+#endif
+
+  /* the step costs are updated in extrapStep_Init */
+  step_mem->nthreads = nthreads;
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Exported optional output functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  EXTRAPStepGetCurrentColumns:
+
+  Returns the number of columns used in the last step.
+  ---------------------------------------------------------------*/
+int EXTRAPStepGetCurrentColumns(void* arkode_mem, int* kcur)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXTRAPStepMem structures */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *kcur = step_mem->kcur;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  EXTRAPStepGetNumColumnChanges:
+
+  Returns the number of times the order selection changed the
+  number of columns.
+  ---------------------------------------------------------------*/
+int EXTRAPStepGetNumColumnChanges(void* arkode_mem, long int* nkchanges)
+{
+  ARKodeMem ark_mem;
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeEXTRAPStepMem structures */
+  retval = extrapStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                          &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *nkchanges = step_mem->nkchanges;
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Private functions attached to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  extrapStep_SetDefaults:
+
+  Resets all EXTRAPStep optional inputs to their default values.
+  Does not change problem-defining function pointers or
+  user_data pointer.  Also leaves alone any data
+  structures/options related to the ARKODE infrastructure itself
+  (e.g., root-finding and post-process step).
+  ---------------------------------------------------------------*/
+int extrapStep_SetDefaults(ARKodeMem ark_mem)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  long int lenrw, leniw;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Set default values for integrator optional inputs */
+  step_mem->base     = ARKODE_EXTRAP_MIDPOINT; /* Gragg midpoint rule */
+  step_mem->kmax     = EXTRAP_KMAX_DEFAULT;    /* max number of columns */
+  step_mem->kfixed   = 0;                      /* adaptive order */
+  step_mem->q        = 0;                      /* set in extrapStep_Init */
+  step_mem->p        = 0;
+  step_mem->nthreads = 1; /* run the sequences serially */
+
+  /* Remove pre-existing SUNAdaptController object, and replace with "I";
+     the order changes from step to step, so the controller history of
+     the PID controller is not meaningful */
+  if (ark_mem->hadapt_mem->owncontroller)
+  {
+    retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                      &leniw);
+    if (retval == SUN_SUCCESS)
+    {
+      ark_mem->liw -= leniw;
+      ark_mem->lrw -= lenrw;
+    }
+    retval = SUNAdaptController_Destroy(ark_mem->hadapt_mem->hcontroller);
+    ark_mem->hadapt_mem->owncontroller = SUNFALSE;
+    if (retval != SUN_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      "SUNAdaptController_Destroy failure");
+      return (ARK_MEM_FAIL);
+    }
+  }
+  ark_mem->hadapt_mem->hcontroller = SUNAdaptController_I(ark_mem->sunctx);
+  if (ark_mem->hadapt_mem->hcontroller == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    "SUNAdaptController_I allocation failure");
+    return (ARK_MEM_FAIL);
+  }
+  ark_mem->hadapt_mem->owncontroller = SUNTRUE;
+  retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                    &leniw);
+  if (retval == SUN_SUCCESS)
+  {
+    ark_mem->liw += leniw;
+    ark_mem->lrw += lenrw;
+  }
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_SetOrder:
+
+  Specifies a fixed method order, i.e., a fixed number of
+  columns.  A non-positive input restores the adaptive order.
+  ---------------------------------------------------------------*/
+int extrapStep_SetOrder(ARKodeMem ark_mem, int ord)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* the midpoint rule gains two orders per column, round odd orders up */
+  if (ord <= 0) { step_mem->kfixed = 0; }
+  else if (step_mem->base == ARKODE_EXTRAP_MIDPOINT)
+  {
+    step_mem->kfixed = (ord + 1) / 2;
+  }
+  else { step_mem->kfixed = ord; }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_GetNumRhsEvals:
+
+  Returns the current number of RHS calls
+  ---------------------------------------------------------------*/
+int extrapStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                              long int* rhs_evals)
+{
+  ARKodeEXTRAPStepMem step_mem = NULL;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  int retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  if (rhs_evals == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "rhs_evals is NULL");
+    return ARK_ILL_INPUT;
+  }
+
+  if (partition_index > 0)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid partition index");
+    return ARK_ILL_INPUT;
+  }
+
+  *rhs_evals = step_mem->nfe;
+
+  return ARK_SUCCESS;
+}
+
+/*---------------------------------------------------------------
+  extrapStep_GetEstLocalErrors: Returns the current local truncation
+  error estimate vector
+  ---------------------------------------------------------------*/
+int extrapStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele)
+{
+  int retval;
+  ARKodeEXTRAPStepMem step_mem;
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* return an error if local truncation error is not computed */
+  if ((ark_mem->fixedstep && (ark_mem->AccumErrorType == ARK_ACCUMERROR_NONE)) ||
+      (step_mem->kcur < EXTRAP_KMIN))
+  {
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  /* otherwise, copy local truncation error vector to output */
+  N_VScale(ONE, ark_mem->tempv1, ele);
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_PrintAllStats:
+
+  Prints integrator statistics
+  ---------------------------------------------------------------*/
+int extrapStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile,
+                             SUNOutputFormat fmt)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  switch (fmt)
+  {
+  case SUN_OUTPUTFORMAT_TABLE:
+    fprintf(outfile, "RHS fn evals                 = %ld\n", step_mem->nfe);
+    fprintf(outfile, "Current columns              = %d\n", step_mem->kcur);
+    fprintf(outfile, "Column changes               = %ld\n",
+            step_mem->nkchanges);
+    break;
+
+  case SUN_OUTPUTFORMAT_CSV:
+    fprintf(outfile, ",RHS fn evals,%ld", step_mem->nfe);
+    fprintf(outfile, ",Current columns,%d", step_mem->kcur);
+    fprintf(outfile, ",Column changes,%ld", step_mem->nkchanges);
+    fprintf(outfile, "\n");
+    break;
+
+  default:
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid formatting option.");
+    return (ARK_ILL_INPUT);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  extrapStep_WriteParameters:
+
+  Outputs all solver parameters to the provided file pointer.
+  ---------------------------------------------------------------*/
+int extrapStep_WriteParameters(ARKodeMem ark_mem, FILE* fp)
+{
+  ARKodeEXTRAPStepMem step_mem;
+  int retval;
+
+  /* access ARKodeEXTRAPStepMem structure */
+  retval = extrapStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* print integrator parameters to file */
+  fprintf(fp, "EXTRAPStep time step module parameters:\n");
+  fprintf(fp, "  Base method %i\n", step_mem->base);
+  if (step_mem->kfixed > 0)
+  {
+    fprintf(fp, "  Fixed number of columns %i\n", step_mem->kfixed);
+  }
+  else { fprintf(fp, "  Maximum number of columns %i\n", step_mem->kmax); }
+  fprintf(fp, "  Number of threads %i\n", step_mem->nthreads);
+  fprintf(fp, "\n");
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
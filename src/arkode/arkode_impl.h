@@ -31,11 +31,13 @@
 #include <sundials/sundials_linearsolver.h>
 
 #include "arkode_adapt_impl.h"
+#include "arkode_adjoint_impl.h"
 #include "arkode_relaxation_impl.h"
 #include "arkode_root_impl.h"
 #include "arkode_types_impl.h"
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 #include "sundials_stepper_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
@@ -54,8 +56,9 @@ extern "C" {
   SHORTCUTS
   ===============================================================*/
 
-#define ARK_PROFILER ark_mem->sunctx->profiler
-#define ARK_LOGGER   ark_mem->sunctx->logger
+#define ARK_PROFILER  ark_mem->sunctx->profiler
+#define ARK_LOGGER    ark_mem->sunctx->logger
+#define ARK_STEPTRACE ark_mem->sunctx->steptrace
 
 /*===============================================================
   MACROS
@@ -466,6 +469,9 @@ struct ARKodeMemRec
   ARKTimestepAttachMasssolFn step_attachmasssol;
   ARKTimestepDisableMSetup step_disablemsetup;
   ARKTimestepGetMassMemFn step_getmassmem;
+
+  /* Time stepper module -- discrete adjoints */
+  ARKAdjGetStageDataFn step_getadjointdata;
   ARKMassMultFn step_mmult;
 
   /* Time stepper module -- forcing */
@@ -563,6 +569,9 @@ struct ARKodeMemRec
   sunbooleantype relax_enabled; /* is relaxation enabled?    */
   ARKodeRelaxMem relax_mem;     /* relaxation data structure */
 
+  /* Discrete Adjoint Data */
+  ARKodeAdjMem adj_mem; /* recorded steps and adjoint data */
+
   /* User-supplied step solution post-processing function */
   ARKPostProcessFn ProcessStep;
   void* ps_data; /* pointer to user_data */
@@ -640,6 +649,10 @@ int arkYddNorm(ARKodeMem ark_mem, sunrealtype hg, sunrealtype* yddnrm);
 int arkCompleteStep(ARKodeMem ark_mem, sunrealtype dsm);
 int arkHandleFailure(ARKodeMem ark_mem, int flag);
 
+void arkStepTraceCounters(ARKodeMem ark_mem, long int counters[]);
+void arkStepTraceRecord(ARKodeMem ark_mem, SUNStepTrace trace, int kflag,
+                        const long int start[]);
+
 int arkEwtSetSS(N_Vector ycur, N_Vector weight, void* arkode_mem);
 int arkEwtSetSV(N_Vector ycur, N_Vector weight, void* arkode_mem);
 int arkEwtSetSmallReal(N_Vector ycur, N_Vector weight, void* arkode_mem);
@@ -1400,6 +1400,66 @@ int ARKodeSetNoInactiveRootWarn(void* arkode_mem)
   return (ARK_SUCCESS);
 }
 
+/*---------------------------------------------------------------
+  ARKodeSetScalableRootfinding:
+
+  Specifies whether the root search within a step is restricted
+  to the root functions that change sign over the step (and the
+  function subset to these candidates, see ARKodeSetRootSubsetFn).
+  The default is to search all root functions.
+  ---------------------------------------------------------------*/
+int ARKodeSetScalableRootfinding(void* arkode_mem, sunbooleantype onoff)
+{
+  ARKodeMem ark_mem;
+  ARKodeRootMem ark_root_mem;
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_mem = (ARKodeMem)arkode_mem;
+  if (ark_mem->root_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_root_mem           = (ARKodeRootMem)ark_mem->root_mem;
+  ark_root_mem->scalable = onoff;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ARKodeSetRootSubsetFn:
+
+  Specifies a user-provided function that evaluates only a subset
+  of the root functions.  It is used in place of the full root
+  function by the scalable root search.  A NULL input function
+  disables it.
+  ---------------------------------------------------------------*/
+int ARKodeSetRootSubsetFn(void* arkode_mem, ARKRootSubsetFn gsub)
+{
+  ARKodeMem ark_mem;
+  ARKodeRootMem ark_root_mem;
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_mem = (ARKodeMem)arkode_mem;
+  if (ark_mem->root_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_root_mem       = (ARKodeRootMem)ark_mem->root_mem;
+  ark_root_mem->gsub = gsub;
+  return (ARK_SUCCESS);
+}
+
 /*---------------------------------------------------------------
   ARKodeSetPostprocessStepFn:
 
@@ -3074,6 +3134,8 @@ char* ARKodeGetReturnFlagName(long int flag)
     break;
   case ARK_SUNSTEPPER_ERR: sprintf(name, "ARK_SUNSTEPPER_ERR"); break;
   case ARK_STEP_DIRECTION_ERR: sprintf(name, "ARK_STEP_DIRECTION_ERR"); break;
+  case ARK_ADJ_CHECKPOINT_FAIL: sprintf(name, "ARK_ADJ_CHECKPOINT_FAIL"); break;
+  case ARK_ADJ_MEM_NULL: sprintf(name, "ARK_ADJ_MEM_NULL"); break;
   case ARK_UNRECOGNIZED_ERROR: sprintf(name, "ARK_UNRECOGNIZED_ERROR"); break;
   default: sprintf(name, "NONE");
   }
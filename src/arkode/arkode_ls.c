@@ -14,6 +14,7 @@
  * Implementation file for ARKODE's linear solver interface.
  *---------------------------------------------------------------*/
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,6 +26,10 @@
 #include "arkode_impl.h"
 #include "arkode_ls_impl.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /* constants */
 #define MIN_INC_MULT SUN_RCONST(1000.0)
 #define MAX_DQITERS  3 /* max. # of attempts to recover in DQ J*v */
@@ -37,6 +42,29 @@ static int arkLsLinSys(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix A,
                        SUNMatrix M, sunbooleantype jok, sunbooleantype* jcur,
                        sunrealtype gamma, void* arkode_mem, N_Vector tmp1,
                        N_Vector tmp2, N_Vector tmp3);
+static sunrealtype arkLsDQInc(ARKodeMem ark_mem, sunindextype j,
+                              sunrealtype* y_data, sunrealtype* ewt_data,
+                              sunrealtype* cns_data, sunrealtype srur,
+                              sunrealtype minInc);
+static int arkLsBatchAlloc(ARKLsMem arkls_mem, N_Vector tmpl, int nvecs);
+static void arkLsBatchFree(ARKLsMem arkls_mem);
+static int arkLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                                SUNMatrix Jac, ARKodeMem ark_mem,
+                                ARKLsMem arkls_mem, N_Vector tmp1);
+static int arkLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, ARKodeMem ark_mem,
+                               ARKLsMem arkls_mem);
+static void arkLsThreadFree(ARKLsMem arkls_mem);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+static int arkLsThreadAlloc(ARKLsMem arkls_mem, N_Vector tmpl);
+static int arkLsThreadRetval(ARKLsMem arkls_mem, long int* nfeDQ);
+static int arkLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, ARKodeMem ark_mem,
+                              ARKLsMem arkls_mem, ARKRhsFn fi);
+static int arkLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, ARKodeMem ark_mem,
+                             ARKLsMem arkls_mem, ARKRhsFn fi);
+#endif
 
 /*===============================================================
   Exported routines
@@ -596,6 +624,104 @@ int ARKodeSetJacFn(void* arkode_mem, ARKLsJacFn jac)
   return (ARKLS_SUCCESS);
 }
 
+/*---------------------------------------------------------------
+  ARKodeSetBatchRhsFn specifies a function evaluating the implicit
+  RHS at several states in one call. When set, it is used by the
+  internal dense and band DQ Jacobian approximations with at most
+  max_batch states per call (ARKLS_MAX_BATCH if max_batch = 0, all
+  columns or column groups at once if max_batch < 0).
+  ---------------------------------------------------------------*/
+int ARKodeSetBatchRhsFn(void* arkode_mem, ARKLsBatchRhsFn fb, int max_batch)
+{
+  ARKodeMem ark_mem;
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* Return immediately if arkode_mem is NULL */
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_mem = (ARKodeMem)arkode_mem;
+
+  /* Guard against use for time steppers that do not need an algebraic solver */
+  if (!ark_mem->step_supports_implicit)
+  {
+    arkProcessError(ark_mem, ARK_STEPPER_UNSUPPORTED, __LINE__, __func__,
+                    __FILE__, "time-stepping module does not require an algebraic solver");
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  /* access ARKLsMem structure */
+  retval = arkLs_AccessLMem(ark_mem, __func__, &arkls_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* release batch vectors sized for a previous setting */
+  arkLsBatchFree(arkls_mem);
+
+  arkls_mem->fbatch    = fb;
+  /* max_batch = 0 selects the default bound, max_batch < 0 all columns */
+  if (max_batch == 0) { arkls_mem->max_batch = ARKLS_MAX_BATCH; }
+  else if (max_batch < 0) { arkls_mem->max_batch = INT_MAX; }
+  else { arkls_mem->max_batch = max_batch; }
+
+  return (ARKLS_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ARKodeSetDQJacNumThreads specifies the number of OpenMP threads
+  used to evaluate the columns (or column groups) of the internal
+  dense and band DQ Jacobian approximations concurrently. The
+  implicit RHS function must be thread-safe when nthreads > 1.
+  ---------------------------------------------------------------*/
+int ARKodeSetDQJacNumThreads(void* arkode_mem, int nthreads)
+{
+  ARKodeMem ark_mem;
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* Return immediately if arkode_mem is NULL */
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  ark_mem = (ARKodeMem)arkode_mem;
+
+  /* Guard against use for time steppers that do not need an algebraic solver */
+  if (!ark_mem->step_supports_implicit)
+  {
+    arkProcessError(ark_mem, ARK_STEPPER_UNSUPPORTED, __LINE__, __func__,
+                    __FILE__, "time-stepping module does not require an algebraic solver");
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  /* access ARKLsMem structure */
+  retval = arkLs_AccessLMem(ark_mem, __func__, &arkls_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* release work vectors sized for a previous setting */
+  arkLsThreadFree(arkls_mem);
+
+  arkls_mem->dqnthreads = (nthreads > 1) ? nthreads : 0;
+
+  return (ARKLS_SUCCESS);
+#else
+  if (nthreads > 1)
+  {
+    arkProcessError(ark_mem, ARKLS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "SUNDIALS was not built with OpenMP enabled");
+    return (ARKLS_ILL_INPUT);
+  }
+
+  return (ARKLS_SUCCESS);
+#endif
+}
+
 /*---------------------------------------------------------------
   ARKodeSetMassFn specifies the mass matrix function.
   ---------------------------------------------------------------*/
@@ -2348,6 +2474,69 @@ int arkLsATimes(void* arkode_mem, N_Vector v, N_Vector z)
   return (0);
 }
 
+/*---------------------------------------------------------------
+  arkLsJtimesSetup and arkLsJtimes:
+
+  These routines give time steppers that only require products
+  with the Jacobian J = df/dy (e.g., exponential integrators)
+  access to the Jacobian-vector product routine attached to the
+  linear solver interface, either user-supplied or the internal
+  DQ approximation.  arkLsJtimesSetup calls the user's jtsetup
+  routine (if any) at (t, y, fy) and arkLsJtimes computes Jv.
+  Both update the ARKLS counters and return the value returned by
+  the user routine (0 if successful, > 0 for a recoverable
+  failure, < 0 otherwise).
+  ---------------------------------------------------------------*/
+int arkLsJtimesSetup(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector fy)
+{
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* access ARKLsMem structure */
+  retval = arkLs_AccessLMem(ark_mem, __func__, &arkls_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* store the linearization point */
+  arkls_mem->tcur = t;
+  arkls_mem->ycur = y;
+  arkls_mem->fcur = fy;
+
+  if (arkls_mem->jtsetup == NULL) { return (0); }
+
+  retval = arkls_mem->jtsetup(t, y, fy, arkls_mem->Jt_data);
+  arkls_mem->njtsetup++;
+  if (retval < 0)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    MSG_LS_JTSETUP_FAILED);
+  }
+  arkls_mem->last_flag = retval;
+  return (retval);
+}
+
+int arkLsJtimes(ARKodeMem ark_mem, N_Vector v, N_Vector Jv, sunrealtype t,
+                N_Vector y, N_Vector fy)
+{
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* access ARKLsMem structure */
+  retval = arkLs_AccessLMem(ark_mem, __func__, &arkls_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* call Jacobian-times-vector product routine
+     (either user-supplied or internal DQ) */
+  retval = arkls_mem->jtimes(v, Jv, t, y, fy, arkls_mem->Jt_data,
+                             arkls_mem->ytemp);
+  arkls_mem->njtimes++;
+  if (retval < 0)
+  {
+    arkProcessError(ark_mem, ARKLS_JACFUNC_UNRECVR, __LINE__, __func__,
+                    __FILE__, MSG_LS_JTIMES_FAILED);
+  }
+  return (retval);
+}
+
 /*---------------------------------------------------------------
   arkLsPSetup:
 
@@ -2631,6 +2820,20 @@ int arkLsDenseDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   sunindextype j, N;
   int retval = 0;
 
+  /* evaluate all perturbed states with the batched RHS if provided */
+  if (arkls_mem->fbatch)
+  {
+    return (arkLsDenseDQJacBatch(t, y, fy, Jac, ark_mem, arkls_mem, tmp1));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the columns concurrently if requested */
+  if (arkls_mem->dqnthreads > 1)
+  {
+    return (arkLsDenseDQJacOMP(t, y, fy, Jac, ark_mem, arkls_mem, fi));
+  }
+#endif
+
   /* access matrix dimension */
   N = SUNDenseMatrix_Columns(Jac);
 
@@ -2717,6 +2920,20 @@ int arkLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   sunindextype N, mupper, mlower;
   int retval = 0;
 
+  /* evaluate all column groups with the batched RHS if provided */
+  if (arkls_mem->fbatch)
+  {
+    return (arkLsBandDQJacBatch(t, y, fy, Jac, ark_mem, arkls_mem));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the column groups concurrently if requested */
+  if (arkls_mem->dqnthreads > 1)
+  {
+    return (arkLsBandDQJacOMP(t, y, fy, Jac, ark_mem, arkls_mem, fi));
+  }
+#endif
+
   /* access matrix dimensions */
   N      = SUNBandMatrix_Columns(Jac);
   mupper = SUNBandMatrix_UpperBandwidth(Jac);
@@ -2813,6 +3030,593 @@ int arkLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   return (retval);
 }
 
+/*---------------------------------------------------------------
+  arkLsDenseDQJacBatch
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of fi(t,y) using the batched implicit RHS function. The
+  perturbed states y + inc_j e_j for up to max_batch columns are
+  evaluated in one call and the columns of J are then formed as in
+  arkLsDenseDQJac.
+  ---------------------------------------------------------------*/
+static int arkLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                                SUNMatrix Jac, ARKodeMem ark_mem,
+                                ARKLsMem arkls_mem, N_Vector tmp1)
+{
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  N_Vector jthCol;
+  sunindextype j, j0, N;
+  int k, nb, nstates;
+  int retval = 0;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (arkls_mem->max_batch < N) ? arkls_mem->max_batch : (int)N;
+  if (arkLsBatchAlloc(arkls_mem, tmp1, nb))
+  {
+    arkProcessError(ark_mem, ARKLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (ARKLS_MEM_FAIL);
+  }
+
+  /* Create an empty vector for matrix column calculations */
+  jthCol = N_VCloneEmpty(tmp1);
+
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(ark_mem->ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (ark_mem->constraintsSet) ? N_VGetArrayPointer(ark_mem->constraints)
+                                       : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(ark_mem->uround);
+  fnorm  = N_VWrmsNorm(fy, ark_mem->rwt);
+  minInc = (fnorm != ZERO)
+             ? (MIN_INC_MULT * SUNRabs(ark_mem->h) * ark_mem->uround * N * fnorm)
+             : ONE;
+
+  for (j0 = 0; j0 < N; j0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, N - j0);
+
+    /* Load the perturbed states */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      N_VScale(ONE, y, arkls_mem->ybatch[k]);
+      N_VGetArrayPointer(arkls_mem->ybatch[k])[j] += inc;
+    }
+
+    retval = arkls_mem->fbatch(t, nstates, arkls_mem->ybatch,
+                               arkls_mem->fybatch, ark_mem->user_data);
+    arkls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Form the difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, arkls_mem->fybatch[k], -inc_inv, fy, jthCol);
+    }
+  }
+
+  /* Destroy jthCol vector */
+  N_VSetArrayPointer(NULL, jthCol);
+  N_VDestroy(jthCol);
+
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  arkLsBandDQJacBatch
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of fi(t,y) using the batched implicit RHS function. The
+  perturbed states for up to max_batch column groups are evaluated
+  in one call and the columns of J are then formed as in
+  arkLsBandDQJac.
+  ---------------------------------------------------------------*/
+static int arkLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, ARKodeMem ark_mem,
+                               ARKLsMem arkls_mem)
+{
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *col_j, *ewt_data, *fy_data, *ftemp_data;
+  sunrealtype *y_data, *ytemp_data, *cns_data;
+  sunindextype group, g0, i, j, width, ngroups, i1, i2;
+  sunindextype N, mupper, mlower;
+  int k, nb, nstates;
+  int retval = 0;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (arkls_mem->max_batch < ngroups) ? arkls_mem->max_batch : (int)ngroups;
+  if (arkLsBatchAlloc(arkls_mem, y, nb))
+  {
+    arkProcessError(ark_mem, ARKLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (ARKLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(ark_mem->ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (ark_mem->constraintsSet) ? N_VGetArrayPointer(ark_mem->constraints)
+                                       : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(ark_mem->uround);
+  fnorm  = N_VWrmsNorm(fy, ark_mem->rwt);
+  minInc = (fnorm != ZERO)
+             ? (MIN_INC_MULT * SUNRabs(ark_mem->h) * ark_mem->uround * N * fnorm)
+             : ONE;
+
+  for (g0 = 0; g0 < ngroups; g0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, ngroups - g0);
+
+    /* Load the states with all y_j in each group incremented */
+    for (k = 0; k < nstates; k++)
+    {
+      group = g0 + k;
+      N_VScale(ONE, y, arkls_mem->ybatch[k]);
+      ytemp_data = N_VGetArrayPointer(arkls_mem->ybatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        ytemp_data[j] += arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data,
+                                    srur, minInc);
+      }
+    }
+
+    retval = arkls_mem->fbatch(t, nstates, arkls_mem->ybatch,
+                               arkls_mem->fybatch, ark_mem->user_data);
+    arkls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Form and load difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      group      = g0 + k;
+      ftemp_data = N_VGetArrayPointer(arkls_mem->fybatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc = arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur,
+                         minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv *
+                                             (ftemp_data[i] - fy_data[i]);
+        }
+      }
+    }
+  }
+
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  arkLsDQInc
+
+  This routine returns the increment used for the jth column in the
+  DQ Jacobian approximations, with its sign adjusted if y_j has an
+  inequality constraint.
+  ---------------------------------------------------------------*/
+static sunrealtype arkLsDQInc(ARKodeMem ark_mem, sunindextype j,
+                              sunrealtype* y_data, sunrealtype* ewt_data,
+                              sunrealtype* cns_data, sunrealtype srur,
+                              sunrealtype minInc)
+{
+  sunrealtype inc, conj;
+
+  inc = SUNMAX(srur * SUNRabs(y_data[j]), minInc / ewt_data[j]);
+
+  if (ark_mem->constraintsSet)
+  {
+    conj = cns_data[j];
+    if (SUNRabs(conj) == ONE)
+    {
+      if ((y_data[j] + inc) * conj < ZERO) { inc = -inc; }
+    }
+    else if (SUNRabs(conj) == TWO)
+    {
+      if ((y_data[j] + inc) * conj <= ZERO) { inc = -inc; }
+    }
+  }
+
+  return (inc);
+}
+
+/*---------------------------------------------------------------
+  arkLsBatchAlloc and arkLsBatchFree
+
+  These routines allocate (at least nvecs) and free the vectors
+  passed to the batched implicit RHS function.
+  ---------------------------------------------------------------*/
+static int arkLsBatchAlloc(ARKLsMem arkls_mem, N_Vector tmpl, int nvecs)
+{
+  if (arkls_mem->nbatch >= nvecs) { return (0); }
+
+  arkLsBatchFree(arkls_mem);
+
+  arkls_mem->ybatch  = N_VCloneVectorArray(nvecs, tmpl);
+  arkls_mem->fybatch = N_VCloneVectorArray(nvecs, tmpl);
+  if (arkls_mem->ybatch == NULL || arkls_mem->fybatch == NULL)
+  {
+    arkLsBatchFree(arkls_mem);
+    return (-1);
+  }
+  arkls_mem->nbatch = nvecs;
+
+  return (0);
+}
+
+static void arkLsBatchFree(ARKLsMem arkls_mem)
+{
+  if (arkls_mem->ybatch)
+  {
+    N_VDestroyVectorArray(arkls_mem->ybatch, arkls_mem->nbatch);
+  }
+  if (arkls_mem->fybatch)
+  {
+    N_VDestroyVectorArray(arkls_mem->fybatch, arkls_mem->nbatch);
+  }
+  arkls_mem->ybatch  = NULL;
+  arkls_mem->fybatch = NULL;
+  arkls_mem->nbatch  = 0;
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+
+/*---------------------------------------------------------------
+  arkLsDenseDQJacOMP
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of fi(t,y) with the columns distributed across
+  dqnthreads OpenMP threads. Each thread perturbs its own copy of y
+  and the columns are formed exactly as in arkLsDenseDQJac, so the
+  result does not depend on the number of threads. If the RHS
+  function fails, the value returned for the first failed column is
+  returned.
+  ---------------------------------------------------------------*/
+static int arkLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, ARKodeMem ark_mem,
+                              ARKLsMem arkls_mem, ARKRhsFn fi)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  sunindextype N;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* per-thread work vectors */
+  if (arkLsThreadAlloc(arkls_mem, y))
+  {
+    arkProcessError(ark_mem, ARKLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (ARKLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(ark_mem->ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (ark_mem->constraintsSet) ? N_VGetArrayPointer(ark_mem->constraints)
+                                       : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(ark_mem->uround);
+  fnorm  = N_VWrmsNorm(fy, ark_mem->rwt);
+  minInc = (fnorm != ZERO)
+             ? (MIN_INC_MULT * SUNRabs(ark_mem->h) * ark_mem->uround * N * fnorm)
+             : ONE;
+
+#pragma omp parallel num_threads(arkls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = arkls_mem->ythr[tid];
+    N_Vector ftemp   = arkls_mem->fythr[tid];
+    N_Vector jthCol  = arkls_mem->colthr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype inc, inc_inv;
+    sunindextype j;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (j = 0; j < N; j++)
+    {
+      /* skip the remaining columns of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = j; }
+
+      inc = arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+
+      ytd[j] += inc;
+      ier = fi(t, ytemp, ftemp, ark_mem->user_data);
+      nfe++;
+      ytd[j] = y_data[j];
+      if (ier != 0)
+      {
+        jfail = j;
+        ret   = ier;
+        continue;
+      }
+
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, ftemp, -inc_inv, fy, jthCol);
+    }
+
+    N_VSetArrayPointer(NULL, jthCol);
+
+    arkls_mem->thrfirst[tid] = jfirst;
+    arkls_mem->thrfail[tid]  = jfail;
+    arkls_mem->thrret[tid]   = ret;
+    arkls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (arkLsThreadRetval(arkls_mem, &arkls_mem->nfeDQ));
+}
+
+/*---------------------------------------------------------------
+  arkLsBandDQJacOMP
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of fi(t,y) with the column groups distributed
+  across dqnthreads OpenMP threads. Each thread perturbs its own
+  copy of y and the columns are formed exactly as in arkLsBandDQJac.
+  ---------------------------------------------------------------*/
+static int arkLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, ARKodeMem ark_mem,
+                             ARKLsMem arkls_mem, ARKRhsFn fi)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *ewt_data, *fy_data, *y_data, *cns_data;
+  sunindextype width, ngroups, N, mupper, mlower;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* per-thread work vectors */
+  if (arkLsThreadAlloc(arkls_mem, y))
+  {
+    arkProcessError(ark_mem, ARKLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (ARKLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(ark_mem->ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (ark_mem->constraintsSet) ? N_VGetArrayPointer(ark_mem->constraints)
+                                       : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(ark_mem->uround);
+  fnorm  = N_VWrmsNorm(fy, ark_mem->rwt);
+  minInc = (fnorm != ZERO)
+             ? (MIN_INC_MULT * SUNRabs(ark_mem->h) * ark_mem->uround * N * fnorm)
+             : ONE;
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+#pragma omp parallel num_threads(arkls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = arkls_mem->ythr[tid];
+    N_Vector ftemp   = arkls_mem->fythr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype* ftd = N_VGetArrayPointer(ftemp);
+    sunrealtype *col_j, inc, inc_inv;
+    sunindextype group, i, j, i1, i2;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (group = 0; group < ngroups; group++)
+    {
+      /* skip the remaining groups of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = group; }
+
+      /* Increment all y_j in group */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] += arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur,
+                             minInc);
+      }
+
+      ier = fi(t, ytemp, ftemp, ark_mem->user_data);
+      nfe++;
+      if (ier != 0)
+      {
+        jfail = group;
+        ret   = ier;
+        continue;
+      }
+
+      /* Restore ytemp, then form and load difference quotients */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] = y_data[j];
+        col_j  = SUNBandMatrix_Column(Jac, j);
+        inc = arkLsDQInc(ark_mem, j, y_data, ewt_data, cns_data, srur,
+                         minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv * (ftd[i] - fy_data[i]);
+        }
+      }
+    }
+
+    arkls_mem->thrfirst[tid] = jfirst;
+    arkls_mem->thrfail[tid]  = jfail;
+    arkls_mem->thrret[tid]   = ret;
+    arkls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (arkLsThreadRetval(arkls_mem, &arkls_mem->nfeDQ));
+}
+
+/*---------------------------------------------------------------
+  arkLsThreadAlloc
+
+  This routine allocates the per-thread work vectors (if needed)
+  and resets the per-thread failure flags and counters.
+  ---------------------------------------------------------------*/
+static int arkLsThreadAlloc(ARKLsMem arkls_mem, N_Vector tmpl)
+{
+  int nt = arkls_mem->dqnthreads;
+  int k;
+
+  if (arkls_mem->nthrvecs < nt)
+  {
+    arkLsThreadFree(arkls_mem);
+
+    arkls_mem->ythr     = N_VCloneVectorArray(nt, tmpl);
+    arkls_mem->fythr    = N_VCloneVectorArray(nt, tmpl);
+    arkls_mem->colthr   = N_VCloneEmptyVectorArray(nt, tmpl);
+    arkls_mem->thrfirst = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    arkls_mem->thrfail  = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    arkls_mem->thrret   = (int*)malloc(nt * sizeof(int));
+    arkls_mem->thrnfe   = (long int*)malloc(nt * sizeof(long int));
+    arkls_mem->nthrvecs = nt;
+    if (arkls_mem->ythr == NULL || arkls_mem->fythr == NULL ||
+        arkls_mem->colthr == NULL || arkls_mem->thrfail == NULL ||
+        arkls_mem->thrret == NULL || arkls_mem->thrnfe == NULL || arkls_mem->thrfirst == NULL)
+    {
+      arkLsThreadFree(arkls_mem);
+      return (-1);
+    }
+  }
+
+  for (k = 0; k < nt; k++)
+  {
+    arkls_mem->thrfirst[k] = -1;
+    arkls_mem->thrfail[k]  = -1;
+    arkls_mem->thrret[k]   = 0;
+    arkls_mem->thrnfe[k]   = 0;
+  }
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  arkLsThreadRetval
+
+  This routine adds the per-thread RHS evaluations to nfeDQ and
+  returns the RHS return value for the first failed column (or
+  group), i.e., the value the serial loop would return.
+  ---------------------------------------------------------------*/
+static int arkLsThreadRetval(ARKLsMem arkls_mem, long int* nfeDQ)
+{
+  sunindextype jfail = -1;
+  int k, retval      = 0;
+
+  /* first failed column (or group) over all threads */
+  for (k = 0; k < arkls_mem->dqnthreads; k++)
+  {
+    if (arkls_mem->thrfail[k] >= 0 &&
+        (jfail < 0 || arkls_mem->thrfail[k] < jfail))
+    {
+      jfail  = arkls_mem->thrfail[k];
+      retval = arkls_mem->thrret[k];
+    }
+  }
+
+  /* the serial loop stops after the failed evaluation, so only the
+     threads whose block starts at or before it are counted */
+  for (k = 0; k < arkls_mem->dqnthreads; k++)
+  {
+    if (arkls_mem->thrfirst[k] >= 0 &&
+        (jfail < 0 || arkls_mem->thrfirst[k] <= jfail))
+    {
+      *nfeDQ += arkls_mem->thrnfe[k];
+    }
+  }
+
+  return (retval);
+}
+
+#endif
+
+/*---------------------------------------------------------------
+  arkLsThreadFree
+
+  This routine frees the per-thread work vectors.
+  ---------------------------------------------------------------*/
+static void arkLsThreadFree(ARKLsMem arkls_mem)
+{
+  if (arkls_mem->ythr)
+  {
+    N_VDestroyVectorArray(arkls_mem->ythr, arkls_mem->nthrvecs);
+  }
+  if (arkls_mem->fythr)
+  {
+    N_VDestroyVectorArray(arkls_mem->fythr, arkls_mem->nthrvecs);
+  }
+  if (arkls_mem->colthr)
+  {
+    N_VDestroyVectorArray(arkls_mem->colthr, arkls_mem->nthrvecs);
+  }
+  free(arkls_mem->thrfirst);
+  free(arkls_mem->thrfail);
+  free(arkls_mem->thrret);
+  free(arkls_mem->thrnfe);
+  arkls_mem->ythr     = NULL;
+  arkls_mem->fythr    = NULL;
+  arkls_mem->colthr   = NULL;
+  arkls_mem->thrfirst = NULL;
+  arkls_mem->thrfail  = NULL;
+  arkls_mem->thrret   = NULL;
+  arkls_mem->thrnfe   = NULL;
+  arkls_mem->nthrvecs = 0;
+}
+
 /*---------------------------------------------------------------
   arkLsDQJtimes:
 
@@ -3534,6 +4338,10 @@ int arkLsFree(ARKodeMem ark_mem)
     arkls_mem->savedJ = NULL;
   }
 
+  /* Free batched RHS and per-thread vectors */
+  arkLsBatchFree(arkls_mem);
+  arkLsThreadFree(arkls_mem);
+
   /* Nullify other N_Vector pointers */
   arkls_mem->ycur = NULL;
   arkls_mem->fcur = NULL;
@@ -35,9 +35,13 @@ extern "C" {
   ARKLS_EPLIN  default value for factor by which the tolerance
                on the nonlinear iteration is multiplied to get
                a tolerance on the linear iteration
+
+  ARKLS_MAX_BATCH  default maximum number of states passed to the
+               batched RHS function in one call
   ---------------------------------------------------------------*/
-#define ARKLS_MSBJ  51
-#define ARKLS_EPLIN SUN_RCONST(0.05)
+#define ARKLS_MSBJ      51
+#define ARKLS_EPLIN     SUN_RCONST(0.05)
+#define ARKLS_MAX_BATCH 32
 
 /*---------------------------------------------------------------
   Types: ARKLsMemRec, ARKLsMem
@@ -123,6 +127,24 @@ typedef struct ARKLsMemRec
   ARKLsLinSysFn linsys;
   void* A_data;
 
+  /* Batched implicit RHS used by the DQ Jacobian approximations */
+  ARKLsBatchRhsFn fbatch;
+  int max_batch;     /* max states per call, INT_MAX for all columns   */
+  int nbatch;        /* number of allocated batch vectors              */
+  N_Vector* ybatch;  /* perturbed states                               */
+  N_Vector* fybatch; /* RHS values at the perturbed states             */
+
+  /* Thread-parallel DQ Jacobian approximations (OpenMP builds only) */
+  int dqnthreads;         /* number of threads, <= 1 for the serial loop      */
+  int nthrvecs;           /* number of allocated per-thread work vectors      */
+  N_Vector* ythr;         /* per-thread perturbed states                      */
+  N_Vector* fythr;        /* per-thread RHS values                            */
+  N_Vector* colthr;       /* per-thread (empty) dense matrix columns          */
+  sunindextype* thrfirst; /* per-thread first column (or group)               */
+  sunindextype* thrfail;  /* per-thread failed column (or group)              */
+  int* thrret;            /* per-thread RHS return value at that column       */
+  long int* thrnfe;       /* per-thread number of RHS evaluations             */
+
   int last_flag; /* last error flag returned by any function */
 
 }* ARKLsMem;
@@ -203,6 +225,12 @@ int arkLsMPSetup(void* arkode_mem);
 int arkLsMPSolve(void* arkode_mem, N_Vector r, N_Vector z, sunrealtype tol,
                  int lr);
 
+/* Jacobian-vector products for time steppers that do not solve
+   linear systems with J (e.g., exponential integrators) */
+int arkLsJtimesSetup(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector fy);
+int arkLsJtimes(ARKodeMem ark_mem, N_Vector v, N_Vector Jv, sunrealtype t,
+                N_Vector y, N_Vector fy);
+
 /* Difference quotient approximation for Jac times vector */
 int arkLsDQJtimes(N_Vector v, N_Vector Jv, sunrealtype t, N_Vector y,
                   N_Vector fy, void* data, N_Vector work);
@@ -24,6 +24,9 @@
 
 #include "arkode_impl.h"
 
+static int arkRootEvalCand(ARKodeMem ark_mem, sunrealtype t, sunrealtype* gout);
+static int arkRootfindCand(ARKodeMem ark_mem);
+
 /*===============================================================
   Exported functions
   ===============================================================*/
@@ -91,6 +94,10 @@ int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g)
     ark_mem->root_mem->irfnd     = 0;
     ark_mem->root_mem->gactive   = NULL;
     ark_mem->root_mem->mxgnull   = 1;
+    ark_mem->root_mem->scalable  = SUNFALSE;
+    ark_mem->root_mem->gsub      = NULL;
+    ark_mem->root_mem->ncand     = 0;
+    ark_mem->root_mem->icand     = NULL;
     ark_mem->root_mem->root_data = ark_mem->user_data;
 
     ark_mem->lrw += ARK_ROOT_LRW;
@@ -114,9 +121,11 @@ int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g)
     ark_mem->root_mem->rootdir = NULL;
     free(ark_mem->root_mem->gactive);
     ark_mem->root_mem->gactive = NULL;
+    free(ark_mem->root_mem->icand);
+    ark_mem->root_mem->icand = NULL;
 
     ark_mem->lrw -= 3 * (ark_mem->root_mem->nrtfn);
-    ark_mem->liw -= 3 * (ark_mem->root_mem->nrtfn);
+    ark_mem->liw -= 4 * (ark_mem->root_mem->nrtfn);
   }
 
   /* If ARKodeRootInit() was called with nrtfn == 0, then set
@@ -151,9 +160,11 @@ int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g)
         ark_mem->root_mem->rootdir = NULL;
         free(ark_mem->root_mem->gactive);
         ark_mem->root_mem->gactive = NULL;
+        free(ark_mem->root_mem->icand);
+        ark_mem->root_mem->icand = NULL;
 
         ark_mem->lrw -= 3 * nrt;
-        ark_mem->liw -= 3 * nrt;
+        ark_mem->liw -= 4 * nrt;
 
         arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
                         MSG_ARK_NULL_G);
@@ -258,6 +269,26 @@ int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g)
                     MSG_ARK_MEM_FAIL);
     return (ARK_MEM_FAIL);
   }
+  ark_mem->root_mem->icand = NULL;
+  ark_mem->root_mem->icand = (int*)malloc(nrt * sizeof(int));
+  if (ark_mem->root_mem->icand == NULL)
+  {
+    free(ark_mem->root_mem->glo);
+    ark_mem->root_mem->glo = NULL;
+    free(ark_mem->root_mem->ghi);
+    ark_mem->root_mem->ghi = NULL;
+    free(ark_mem->root_mem->grout);
+    ark_mem->root_mem->grout = NULL;
+    free(ark_mem->root_mem->iroots);
+    ark_mem->root_mem->iroots = NULL;
+    free(ark_mem->root_mem->rootdir);
+    ark_mem->root_mem->rootdir = NULL;
+    free(ark_mem->root_mem->gactive);
+    ark_mem->root_mem->gactive = NULL;
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_MEM_FAIL);
+    return (ARK_MEM_FAIL);
+  }
 
   /* Set default values for rootdir (both directions) */
   for (i = 0; i < nrt; i++) { ark_mem->root_mem->rootdir[i] = 0; }
@@ -266,7 +297,7 @@ int ARKodeRootInit(void* arkode_mem, int nrtfn, ARKRootFn g)
   for (i = 0; i < nrt; i++) { ark_mem->root_mem->gactive[i] = SUNTRUE; }
 
   ark_mem->lrw += 3 * nrt;
-  ark_mem->liw += 3 * nrt;
+  ark_mem->liw += 4 * nrt;
 
   return (ARK_SUCCESS);
 }
@@ -307,8 +338,10 @@ int arkRootFree(void* arkode_mem)
       ark_mem->root_mem->rootdir = NULL;
       free(ark_mem->root_mem->gactive);
       ark_mem->root_mem->gactive = NULL;
+      free(ark_mem->root_mem->icand);
+      ark_mem->root_mem->icand = NULL;
       ark_mem->lrw -= 3 * ark_mem->root_mem->nrtfn;
-      ark_mem->liw -= 3 * ark_mem->root_mem->nrtfn;
+      ark_mem->liw -= 4 * ark_mem->root_mem->nrtfn;
     }
     free(ark_mem->root_mem);
     ark_mem->lrw -= ARK_ROOT_LRW;
@@ -357,6 +390,8 @@ int arkPrintRootMem(void* arkode_mem, FILE* outfile)
     fprintf(outfile, "ark_taskc = %i\n", ark_mem->root_mem->taskc);
     fprintf(outfile, "ark_irfnd = %i\n", ark_mem->root_mem->irfnd);
     fprintf(outfile, "ark_mxgnull = %i\n", ark_mem->root_mem->mxgnull);
+    fprintf(outfile, "ark_scalable = %i\n", ark_mem->root_mem->scalable);
+    fprintf(outfile, "ark_ncand = %i\n", ark_mem->root_mem->ncand);
     if (ark_mem->root_mem->gactive != NULL)
     {
       for (i = 0; i < ark_mem->root_mem->nrtfn; i++)
@@ -471,8 +506,22 @@ int arkRootCheck1(void* arkode_mem)
   smallh = hratio * ark_mem->h;
   tplus  = rootmem->tlo + smallh;
   N_VLinearSum(ONE, ark_mem->yn, smallh, ark_mem->fn, ark_mem->ycur);
-  retval = rootmem->gfun(tplus, ark_mem->ycur, rootmem->ghi, rootmem->root_data);
-  rootmem->nge++;
+  if (rootmem->scalable)
+  {
+    /* only the components that are zero at t0 are needed at tplus */
+    rootmem->ncand = 0;
+    for (i = 0; i < rootmem->nrtfn; i++)
+    {
+      if (!rootmem->gactive[i]) { rootmem->icand[rootmem->ncand++] = i; }
+    }
+    retval = arkRootEvalCand(ark_mem, tplus, rootmem->ghi);
+  }
+  else
+  {
+    retval = rootmem->gfun(tplus, ark_mem->ycur, rootmem->ghi,
+                           rootmem->root_data);
+    rootmem->nge++;
+  }
   if (retval != 0)
   {
     arkProcessError(ark_mem, ARK_RTFUNC_FAIL, __LINE__, __func__, __FILE__,
@@ -515,7 +564,7 @@ int arkRootCheck1(void* arkode_mem)
   ---------------------------------------------------------------*/
 int arkRootCheck2(void* arkode_mem)
 {
-  int i, retval;
+  int i, k, retval;
   sunrealtype smallh, tplus;
   sunbooleantype zroot;
   ARKodeMem ark_mem;
@@ -576,6 +625,27 @@ int arkRootCheck2(void* arkode_mem)
     (void)ARKodeGetDky(ark_mem, tplus, 0, ark_mem->ycur);
   }
   /*     set ghi = g(tplus,y(tplus)) */
+  if (rootmem->scalable)
+  {
+    /* Only the components that are zero at tlo are evaluated at tplus, so
+       only a close pair of zeros can be detected here.  A new zero in
+       (tlo,tplus] is found by the search in arkRootCheck3. */
+    rootmem->ncand = 0;
+    for (i = 0; i < rootmem->nrtfn; i++)
+    {
+      if (rootmem->iroots[i] == 1) { rootmem->icand[rootmem->ncand++] = i; }
+    }
+    retval = arkRootEvalCand(ark_mem, tplus, rootmem->ghi);
+    if (retval != 0) { return (ARK_RTFUNC_FAIL); }
+
+    for (k = 0; k < rootmem->ncand; k++)
+    {
+      i = rootmem->icand[k];
+      if (SUNRabs(rootmem->ghi[i]) == ZERO) { return (CLOSERT); }
+      rootmem->glo[i] = rootmem->ghi[i];
+    }
+    return (ARK_SUCCESS);
+  }
   retval = rootmem->gfun(tplus, ark_mem->ycur, rootmem->ghi, rootmem->root_data);
   rootmem->nge++;
   if (retval != 0) { return (ARK_RTFUNC_FAIL); }
@@ -657,6 +727,22 @@ int arkRootCheck3(void* arkode_mem)
                   ark_mem->uround * HUND;
   ier = arkRootfind(ark_mem);
   if (ier == ARK_RTFUNC_FAIL) { return (ARK_RTFUNC_FAIL); }
+  /* In scalable mode grout is only current for the candidates when a root
+     was found, so the inactive components are evaluated at trout first */
+  if (rootmem->scalable && ier == RTFOUND)
+  {
+    rootmem->ncand = 0;
+    for (i = 0; i < rootmem->nrtfn; i++)
+    {
+      if (!rootmem->gactive[i]) { rootmem->icand[rootmem->ncand++] = i; }
+    }
+    if (rootmem->ncand > 0)
+    {
+      (void)ARKodeGetDky(ark_mem, rootmem->trout, 0, ark_mem->ycur);
+      retval = arkRootEvalCand(ark_mem, rootmem->trout, rootmem->grout);
+      if (retval != 0) { return (ARK_RTFUNC_FAIL); }
+    }
+  }
   for (i = 0; i < rootmem->nrtfn; i++)
   {
     if (!rootmem->gactive[i] && rootmem->grout[i] != ZERO)
@@ -767,6 +853,8 @@ int arkRootfind(void* arkode_mem)
   ark_mem = (ARKodeMem)arkode_mem;
   rootmem = ark_mem->root_mem;
 
+  if (rootmem->scalable) { return (arkRootfindCand(ark_mem)); }
+
   imax = 0;
 
   /* First check for change in sign in ghi or for a zero in ghi. */
@@ -954,6 +1042,235 @@ int arkRootfind(void* arkode_mem)
   return (RTFOUND);
 }
 
+/*---------------------------------------------------------------
+  arkRootEvalCand
+
+  This routine evaluates the candidate root functions
+  icand[0], ..., icand[ncand-1] at (t, ycur) into gout, with the
+  user-supplied subset function if one was provided or with the
+  full root function otherwise.  Only the candidate entries of
+  gout are defined on return.
+  ---------------------------------------------------------------*/
+static int arkRootEvalCand(ARKodeMem ark_mem, sunrealtype t, sunrealtype* gout)
+{
+  int retval;
+  ARKodeRootMem rootmem = ark_mem->root_mem;
+
+  if (rootmem->gsub != NULL)
+  {
+    retval = rootmem->gsub(t, ark_mem->ycur, rootmem->ncand, rootmem->icand,
+                           gout, rootmem->root_data);
+  }
+  else { retval = rootmem->gfun(t, ark_mem->ycur, gout, rootmem->root_data); }
+  rootmem->nge++;
+
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  arkRootfindCand
+
+  This routine is the scalable variant of arkRootfind.  The active
+  components of g that change sign in (tlo,thi], or vanish at thi,
+  in the monitored direction are first collected in the candidate
+  set icand.  The Illinois iterations then only evaluate, scan and
+  update the candidates, and whenever thi is moved to tmid the
+  candidates without a sign change or zero in (tlo,tmid] are
+  dropped, as their roots lie beyond the nearest one.  The cost of
+  the search therefore grows with the number of events in the
+  step rather than with nrtfn.
+
+  On return, grout = ghi for all components, which is only g(trout)
+  for the candidates if a root was found.  arkRootCheck3 then
+  evaluates the inactive components at trout, and the remaining
+  components are refreshed by arkRootCheck2 on the next call, as a
+  root return always sets irfnd.
+
+  The return values are those of arkRootfind.
+  ---------------------------------------------------------------*/
+static int arkRootfindCand(ARKodeMem ark_mem)
+{
+  sunrealtype alpha, tmid, gfrac, maxfrac, fracint, fracsub;
+  int i, k, nc, retval, imax, side, sideprev;
+  sunbooleantype zroot, sgnchg;
+  ARKodeRootMem rootmem = ark_mem->root_mem;
+
+  imax = 0;
+
+  /* Collect the candidates from the signs of g at both endpoints. */
+  rootmem->ncand = 0;
+  for (i = 0; i < rootmem->nrtfn; i++)
+  {
+    if (!rootmem->gactive[i]) { continue; }
+    if (rootmem->rootdir[i] * rootmem->glo[i] > ZERO) { continue; }
+    if ((SUNRabs(rootmem->ghi[i]) == ZERO) ||
+        DIFFERENT_SIGN(rootmem->glo[i], rootmem->ghi[i]))
+    {
+      rootmem->icand[rootmem->ncand++] = i;
+    }
+  }
+
+  /* Check the candidates for a change in sign or a zero in ghi. */
+  maxfrac = ZERO;
+  zroot   = SUNFALSE;
+  sgnchg  = SUNFALSE;
+  for (k = 0; k < rootmem->ncand; k++)
+  {
+    i = rootmem->icand[k];
+    if (SUNRabs(rootmem->ghi[i]) == ZERO) { zroot = SUNTRUE; }
+    else
+    {
+      gfrac = SUNRabs(rootmem->ghi[i] / (rootmem->ghi[i] - rootmem->glo[i]));
+      if (gfrac > maxfrac)
+      {
+        sgnchg  = SUNTRUE;
+        maxfrac = gfrac;
+        imax    = i;
+      }
+    }
+  }
+
+  /* If no sign change was found, reset trout and grout.  Then return
+     ARK_SUCCESS if no zero was found, or set iroots and return RTFOUND.  */
+  if (!sgnchg)
+  {
+    rootmem->trout = rootmem->thi;
+    for (i = 0; i < rootmem->nrtfn; i++)
+    {
+      rootmem->grout[i] = rootmem->ghi[i];
+    }
+    if (!zroot) { return (ARK_SUCCESS); }
+    for (i = 0; i < rootmem->nrtfn; i++) { rootmem->iroots[i] = 0; }
+    for (k = 0; k < rootmem->ncand; k++)
+    {
+      i                  = rootmem->icand[k];
+      rootmem->iroots[i] = rootmem->glo[i] > 0 ? -1 : 1;
+    }
+    return (RTFOUND);
+  }
+
+  /* Initialize alpha to avoid compiler warning */
+  alpha = ONE;
+
+  /* A sign change was found.  Loop to locate nearest root. */
+  side     = 0;
+  sideprev = -1;
+  for (;;)
+  { /* Looping point */
+
+    /* If interval size is already less than tolerance ttol, break. */
+    if (SUNRabs(rootmem->thi - rootmem->tlo) <= rootmem->ttol) { break; }
+
+    /* Set weight alpha as in arkRootfind. */
+    if (sideprev == side) { alpha = (side == 2) ? alpha * TWO : alpha * HALF; }
+    else { alpha = ONE; }
+
+    /* Set next root approximation tmid and get g(tmid) for the candidates.
+       If tmid is too close to tlo or thi, adjust it inward,
+       by a fractional distance that is between 0.1 and 0.5.  */
+    tmid = rootmem->thi - (rootmem->thi - rootmem->tlo) * rootmem->ghi[imax] /
+                            (rootmem->ghi[imax] - alpha * rootmem->glo[imax]);
+    if (SUNRabs(tmid - rootmem->tlo) < HALF * rootmem->ttol)
+    {
+      fracint = SUNRabs(rootmem->thi - rootmem->tlo) / rootmem->ttol;
+      fracsub = (fracint > FIVE) ? TENTH : HALF / fracint;
+      tmid    = rootmem->tlo + fracsub * (rootmem->thi - rootmem->tlo);
+    }
+    if (SUNRabs(rootmem->thi - tmid) < HALF * rootmem->ttol)
+    {
+      fracint = SUNRabs(rootmem->thi - rootmem->tlo) / rootmem->ttol;
+      fracsub = (fracint > FIVE) ? TENTH : HALF / fracint;
+      tmid    = rootmem->thi - fracsub * (rootmem->thi - rootmem->tlo);
+    }
+
+    (void)ARKodeGetDky(ark_mem, tmid, 0, ark_mem->ycur);
+    retval = arkRootEvalCand(ark_mem, tmid, rootmem->grout);
+    if (retval != 0) { return (ARK_RTFUNC_FAIL); }
+
+    /* Check to see in which subinterval g changes sign, and reset imax.
+       Set side = 1 if sign change is on low side, or 2 if on high side.  */
+    maxfrac  = ZERO;
+    zroot    = SUNFALSE;
+    sgnchg   = SUNFALSE;
+    sideprev = side;
+    for (k = 0; k < rootmem->ncand; k++)
+    {
+      i = rootmem->icand[k];
+      if (SUNRabs(rootmem->grout[i]) == ZERO) { zroot = SUNTRUE; }
+      else if (DIFFERENT_SIGN(rootmem->glo[i], rootmem->grout[i]))
+      {
+        gfrac =
+          SUNRabs(rootmem->grout[i] / (rootmem->grout[i] - rootmem->glo[i]));
+        if (gfrac > maxfrac)
+        {
+          sgnchg  = SUNTRUE;
+          maxfrac = gfrac;
+          imax    = i;
+        }
+      }
+    }
+
+    if (sgnchg || zroot)
+    {
+      /* Sign change in (tlo,tmid) or g = 0 at tmid; replace thi with tmid
+         and keep only the candidates with a root in (tlo,tmid]. */
+      rootmem->thi = tmid;
+      nc           = 0;
+      for (k = 0; k < rootmem->ncand; k++)
+      {
+        i               = rootmem->icand[k];
+        rootmem->ghi[i] = rootmem->grout[i];
+        if ((SUNRabs(rootmem->grout[i]) == ZERO) ||
+            DIFFERENT_SIGN(rootmem->glo[i], rootmem->grout[i]))
+        {
+          rootmem->icand[nc++] = i;
+        }
+      }
+      rootmem->ncand = nc;
+
+      /* Without a sign change, return root tmid. */
+      if (!sgnchg) { break; }
+
+      side = 1;
+      /* Stop at root thi if converged; otherwise loop. */
+      if (SUNRabs(rootmem->thi - rootmem->tlo) <= rootmem->ttol) { break; }
+      continue; /* Return to looping point. */
+    }
+
+    /* No sign change in (tlo,tmid), and no zero at tmid.
+       Sign change must be in (tmid,thi).  Replace tlo with tmid. */
+    rootmem->tlo = tmid;
+    for (k = 0; k < rootmem->ncand; k++)
+    {
+      i               = rootmem->icand[k];
+      rootmem->glo[i] = rootmem->grout[i];
+    }
+    side = 2;
+    /* Stop at root thi if converged; otherwise loop back. */
+    if (SUNRabs(rootmem->thi - rootmem->tlo) <= rootmem->ttol) { break; }
+
+  } /* End of root-search loop */
+
+  /* Reset trout and grout, set iroots for the candidates, and return
+     RTFOUND. */
+  rootmem->trout = rootmem->thi;
+  for (i = 0; i < rootmem->nrtfn; i++)
+  {
+    rootmem->grout[i]  = rootmem->ghi[i];
+    rootmem->iroots[i] = 0;
+  }
+  for (k = 0; k < rootmem->ncand; k++)
+  {
+    i = rootmem->icand[k];
+    if ((SUNRabs(rootmem->ghi[i]) == ZERO) ||
+        DIFFERENT_SIGN(rootmem->glo[i], rootmem->ghi[i]))
+    {
+      rootmem->iroots[i] = rootmem->glo[i] > 0 ? -1 : 1;
+    }
+  }
+  return (RTFOUND);
+}
+
 /*===============================================================
   EOF
   ===============================================================*/
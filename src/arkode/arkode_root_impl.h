@@ -30,7 +30,7 @@ extern "C" {
   ===============================================================*/
 
 #define ARK_ROOT_LRW 5
-#define ARK_ROOT_LIW 12
+#define ARK_ROOT_LIW 14
 
 /* Numeric constants */
 #define HUND SUN_RCONST(100.0)
@@ -65,6 +65,10 @@ typedef struct ARKodeRootMemRec
   long int nge;            /* counter for g evaluations                    */
   sunbooleantype* gactive; /* array with active/inactive event functions   */
   int mxgnull;             /* num. warning messages about possible g==0    */
+  sunbooleantype scalable; /* restrict root search to candidate functions  */
+  ARKRootSubsetFn gsub;    /* function evaluating a subset of g            */
+  int ncand;               /* number of candidate root functions           */
+  int* icand;              /* indices of candidate root functions          */
   void* root_data;         /* pointer to user_data                         */
 
 }* ARKodeRootMem;
@@ -0,0 +1,1679 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for ARKODE's Rosenbrock (ROW)
+ * time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sundials/sundials_context.h>
+#include <sundials/sundials_math.h>
+
+#include "arkode/arkode_butcher.h"
+#include "arkode_impl.h"
+#include "arkode_interp_impl.h"
+#include "arkode_rowstep_impl.h"
+
+/*===============================================================
+  Exported functions
+  ===============================================================*/
+
+void* ROWStepCreate(ARKRhsFn f, sunrealtype t0, N_Vector y0, SUNContext sunctx)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  sunbooleantype nvectorOK;
+  int retval;
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (NULL);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (NULL);
+  }
+
+  if (!sunctx)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_SUNCTX);
+    return (NULL);
+  }
+
+  /* Test if all required vector operations are implemented */
+  nvectorOK = rowStep_CheckNVector(y0);
+  if (!nvectorOK)
+  {
+    arkProcessError(NULL, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_BAD_NVECTOR);
+    return (NULL);
+  }
+
+  /* Create ark_mem structure and set default values */
+  ark_mem = arkCreate(sunctx);
+  if (ark_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (NULL);
+  }
+
+  /* Allocate ARKodeROWStepMem structure, and initialize to zero */
+  step_mem = NULL;
+  step_mem = (ARKodeROWStepMem)malloc(sizeof(struct ARKodeROWStepMemRec));
+  if (step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+  memset(step_mem, 0, sizeof(struct ARKodeROWStepMemRec));
+
+  /* Attach step_mem structure and function pointers to ark_mem */
+  ark_mem->step_attachlinsol        = rowStep_AttachLinsol;
+  ark_mem->step_disablelsetup       = rowStep_DisableLSetup;
+  ark_mem->step_getlinmem           = rowStep_GetLmem;
+  ark_mem->step_getimplicitrhs      = rowStep_GetImplicitRHS;
+  ark_mem->step_getgammas           = rowStep_GetGammas;
+  ark_mem->step_init                = rowStep_Init;
+  ark_mem->step_fullrhs             = rowStep_FullRHS;
+  ark_mem->step                     = rowStep_TakeStep;
+  ark_mem->step_printallstats       = rowStep_PrintAllStats;
+  ark_mem->step_writeparameters     = rowStep_WriteParameters;
+  ark_mem->step_resize              = rowStep_Resize;
+  ark_mem->step_free                = rowStep_Free;
+  ark_mem->step_printmem            = rowStep_PrintMem;
+  ark_mem->step_setdefaults         = rowStep_SetDefaults;
+  ark_mem->step_setorder            = rowStep_SetOrder;
+  ark_mem->step_setautonomous       = rowStep_SetAutonomous;
+  ark_mem->step_setlsetupfrequency  = rowStep_SetLSetupFrequency;
+  ark_mem->step_getnumrhsevals      = rowStep_GetNumRhsEvals;
+  ark_mem->step_getnumlinsolvsetups = rowStep_GetNumLinSolvSetups;
+  ark_mem->step_getcurrentgamma     = rowStep_GetCurrentGamma;
+  ark_mem->step_getestlocalerrors   = rowStep_GetEstLocalErrors;
+  ark_mem->step_supports_adaptive   = SUNTRUE;
+  ark_mem->step_supports_implicit   = SUNTRUE;
+  ark_mem->step_mem                 = (void*)step_mem;
+
+  /* Set default values for optional inputs */
+  retval = rowStep_SetDefaults((void*)ark_mem);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Error setting default solver options");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  /* Allocate the time derivative vector using y0 as a template */
+  /* NOTE: U, cvals and Xvecs will be allocated later on
+     (based on the number of ROW stages) */
+  if (!arkAllocVec(ark_mem, y0, &(step_mem->fdt)))
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Update the ARKODE workspace requirements */
+  ark_mem->liw += 42; /* fcn/data ptr, int, long int, sunindextype, sunbooleantype */
+  ark_mem->lrw += 10;
+
+  /* Set the linear solver addresses to NULL (we check != NULL later) */
+  step_mem->linit       = NULL;
+  step_mem->lsetup      = NULL;
+  step_mem->lsolve      = NULL;
+  step_mem->lfree       = NULL;
+  step_mem->lmem        = NULL;
+  step_mem->lsolve_type = -1;
+
+  /* Initialize all the counters */
+  step_mem->nfe     = 0;
+  step_mem->nsetups = 0;
+  step_mem->nstlp   = 0;
+
+  /* Initialize fused op work space */
+  step_mem->cvals        = NULL;
+  step_mem->Xvecs        = NULL;
+  step_mem->nfusedopvecs = 0;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(ark_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    ARKodeFree((void**)&ark_mem);
+    return (NULL);
+  }
+
+  return ((void*)ark_mem);
+}
+
+/*---------------------------------------------------------------
+  ROWStepReInit:
+
+  This routine re-initializes the ROWStep module to solve a new
+  problem of the same size as was previously solved. This routine
+  should also be called when the problem dynamics or desired solvers
+  have changed dramatically, so that the problem integration should
+  resume as if started from scratch.
+
+  Note all internal counters are set to 0 on re-initialization.
+  ---------------------------------------------------------------*/
+int ROWStepReInit(void* arkode_mem, ARKRhsFn f, sunrealtype t0, N_Vector y0)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Check if ark_mem was allocated */
+  if (ark_mem->MallocDone == SUNFALSE)
+  {
+    arkProcessError(ark_mem, ARK_NO_MALLOC, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MALLOC);
+    return (ARK_NO_MALLOC);
+  }
+
+  /* Check that f is supplied */
+  if (f == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_F);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Check for legal input parameters */
+  if (y0 == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NULL_Y0);
+    return (ARK_ILL_INPUT);
+  }
+
+  /* Copy the input parameters into ARKODE state */
+  step_mem->f = f;
+
+  /* Initialize main ARKODE infrastructure */
+  retval = arkInit(arkode_mem, t0, y0, FIRST_INIT);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, retval, __LINE__, __func__, __FILE__,
+                    "Unable to initialize main ARKODE infrastructure");
+    return (retval);
+  }
+
+  /* Initialize all the counters */
+  step_mem->nfe     = 0;
+  step_mem->nsetups = 0;
+  step_mem->nstlp   = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Interface routines supplied to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  rowStep_Resize:
+
+  This routine resizes the memory within the ROWStep module.
+  ---------------------------------------------------------------*/
+int rowStep_Resize(ARKodeMem ark_mem, N_Vector y0,
+                   SUNDIALS_MAYBE_UNUSED sunrealtype hscale,
+                   SUNDIALS_MAYBE_UNUSED sunrealtype t0, ARKVecResizeFn resize,
+                   void* resize_data)
+{
+  ARKodeROWStepMem step_mem;
+  sunindextype lrw1, liw1, lrw_diff, liw_diff;
+  int i, retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Determine change in vector sizes */
+  lrw1 = liw1 = 0;
+  if (y0->ops->nvspace != NULL) { N_VSpace(y0, &lrw1, &liw1); }
+  lrw_diff      = lrw1 - ark_mem->lrw1;
+  liw_diff      = liw1 - ark_mem->liw1;
+  ark_mem->lrw1 = lrw1;
+  ark_mem->liw1 = liw1;
+
+  /* Resize the time derivative vector */
+  if (!arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                    &step_mem->fdt))
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    "Unable to resize vector");
+    return (ARK_MEM_FAIL);
+  }
+  step_mem->fdt_current = SUNFALSE;
+
+  /* Resize the stage vectors */
+  if (step_mem->U != NULL)
+  {
+    for (i = 0; i < step_mem->stages; i++)
+    {
+      if (!arkResizeVec(ark_mem, resize, resize_data, lrw_diff, liw_diff, y0,
+                        &step_mem->U[i]))
+      {
+        arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                        "Unable to resize vector");
+        return (ARK_MEM_FAIL);
+      }
+    }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_Free frees all ROWStep memory.
+  ---------------------------------------------------------------*/
+void rowStep_Free(ARKodeMem ark_mem)
+{
+  ARKodeROWStepMem step_mem;
+
+  /* nothing to do if ark_mem is already NULL */
+  if (ark_mem == NULL) { return; }
+
+  /* conditional frees on non-NULL ROWStep module */
+  if (ark_mem->step_mem != NULL)
+  {
+    step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+
+    /* free the tables, coefficients and stage vectors */
+    rowStep_FreeTables(ark_mem);
+
+    /* free the linear solver memory */
+    if (step_mem->lfree != NULL)
+    {
+      step_mem->lfree((void*)ark_mem);
+      step_mem->lmem = NULL;
+    }
+
+    /* free the time derivative vector */
+    arkFreeVec(ark_mem, &step_mem->fdt);
+
+    /* free the time stepper module itself */
+    free(ark_mem->step_mem);
+    ark_mem->step_mem = NULL;
+  }
+}
+
+/*---------------------------------------------------------------
+  rowStep_PrintMem:
+
+  This routine outputs the memory from the ROWStep structure to
+  a specified file pointer (useful when debugging).
+  ---------------------------------------------------------------*/
+void rowStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+#ifdef SUNDIALS_DEBUG_PRINTVEC
+  int i;
+#endif
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return; }
+
+  /* output integer quantities */
+  fprintf(outfile, "ROWStep: q = %i\n", step_mem->q);
+  fprintf(outfile, "ROWStep: p = %i\n", step_mem->p);
+  fprintf(outfile, "ROWStep: stages = %i\n", step_mem->stages);
+  fprintf(outfile, "ROWStep: wmethod = %i\n", step_mem->wmethod);
+  fprintf(outfile, "ROWStep: autonomous = %i\n", step_mem->autonomous);
+  fprintf(outfile, "ROWStep: msbp = %i\n", step_mem->msbp);
+
+  /* output long integer quantities */
+  fprintf(outfile, "ROWStep: nfe = %li\n", step_mem->nfe);
+  fprintf(outfile, "ROWStep: nsetups = %li\n", step_mem->nsetups);
+  fprintf(outfile, "ROWStep: nstlp = %li\n", step_mem->nstlp);
+
+  /* output sunrealtype quantities */
+  fprintf(outfile, "ROWStep: gamma = %" RSYM "\n", step_mem->gamma);
+  fprintf(outfile, "ROWStep: gammap = %" RSYM "\n", step_mem->gammap);
+  if (step_mem->A != NULL)
+  {
+    fprintf(outfile, "ROWStep: alpha table:\n");
+    ARKodeButcherTable_Write(step_mem->A, outfile);
+  }
+  if (step_mem->G != NULL)
+  {
+    fprintf(outfile, "ROWStep: gamma table:\n");
+    ARKodeButcherTable_Write(step_mem->G, outfile);
+  }
+
+#ifdef SUNDIALS_DEBUG_PRINTVEC
+  /* output vector quantities */
+  if (step_mem->U != NULL)
+  {
+    for (i = 0; i < step_mem->stages; i++)
+    {
+      fprintf(outfile, "ROWStep: U[%i]:\n", i);
+      N_VPrintFile(step_mem->U[i], outfile);
+    }
+  }
+  fprintf(outfile, "ROWStep: fdt:\n");
+  N_VPrintFile(step_mem->fdt, outfile);
+#endif
+}
+
+/*---------------------------------------------------------------
+  rowStep_AttachLinsol:
+
+  This routine attaches the various set of system linear solver
+  interface routines, data structure, and solver type to the
+  ROWStep module.
+  ---------------------------------------------------------------*/
+int rowStep_AttachLinsol(ARKodeMem ark_mem, ARKLinsolInitFn linit,
+                         ARKLinsolSetupFn lsetup, ARKLinsolSolveFn lsolve,
+                         ARKLinsolFreeFn lfree,
+                         SUNLinearSolver_Type lsolve_type, void* lmem)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* free any existing system solver */
+  if (step_mem->lfree != NULL) { step_mem->lfree(ark_mem); }
+
+  /* Attach the provided routines, data structure and solve type */
+  step_mem->linit       = linit;
+  step_mem->lsetup      = lsetup;
+  step_mem->lsolve      = lsolve;
+  step_mem->lfree       = lfree;
+  step_mem->lmem        = lmem;
+  step_mem->lsolve_type = lsolve_type;
+
+  /* Reset all linear solver counters */
+  step_mem->nsetups = 0;
+  step_mem->nstlp   = 0;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_DisableLSetup:
+
+  This routine NULLifies the lsetup function pointer in the
+  ROWStep module.
+  ---------------------------------------------------------------*/
+void rowStep_DisableLSetup(ARKodeMem ark_mem)
+{
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL) { return; }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+
+  /* nullify the lsetup function pointer */
+  step_mem->lsetup = NULL;
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetLmem:
+
+  This routine returns the system linear solver interface memory
+  structure, lmem.
+  ---------------------------------------------------------------*/
+void* rowStep_GetLmem(ARKodeMem ark_mem)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure, and return lmem */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (NULL); }
+  return (step_mem->lmem);
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetImplicitRHS:
+
+  This routine returns the RHS function pointer, f, since the
+  full right-hand side is treated linearly implicitly.
+  ---------------------------------------------------------------*/
+ARKRhsFn rowStep_GetImplicitRHS(ARKodeMem ark_mem)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure, and return f */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (NULL); }
+  return (step_mem->f);
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetGammas:
+
+  This routine fills the current value of gamma.  The linear
+  system is always set up with the current gamma, so the gamma
+  ratio is one and never fails the dgmax criteria.
+  ---------------------------------------------------------------*/
+int rowStep_GetGammas(ARKodeMem ark_mem, sunrealtype* gamma, sunrealtype* gamrat,
+                      sunbooleantype** jcur, sunbooleantype* dgamma_fail)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* set outputs */
+  *gamma       = step_mem->gamma;
+  *gamrat      = step_mem->gamrat;
+  *jcur        = &step_mem->jcur;
+  *dgamma_fail = SUNFALSE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_Init:
+
+  This routine is called just prior to performing internal time
+  steps (after all user "set" routines have been called) from
+  within arkInitialSetup.
+
+  With initialization type FIRST_INIT this routine:
+  - sets/checks the Rosenbrock tables to be used
+  - computes the transformed method coefficients
+  - allocates any memory that depends on the number of stages,
+    method order, or solver options
+  - checks that a linear solver has been attached
+  - sets the call_fullrhs flag
+
+  With initialization types FIRST_INIT or RESIZE_INIT, this
+  routine also initializes the linear solver.
+
+  With all initialization types, the time derivative of f is
+  marked as out of date.
+  ---------------------------------------------------------------*/
+int rowStep_Init(ARKodeMem ark_mem, SUNDIALS_MAYBE_UNUSED sunrealtype tout,
+                 int init_type)
+{
+  ARKodeROWStepMem step_mem;
+  int retval, j;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* f_t must be recomputed at the new initial condition */
+  step_mem->fdt_current = SUNFALSE;
+
+  /* immediately return if reset */
+  if (init_type == RESET_INIT) { return (ARK_SUCCESS); }
+
+  /* initializations/checks for (re-)initialization call */
+  if (init_type == FIRST_INIT)
+  {
+    /* Create Rosenbrock tables (if not already set) */
+    retval = rowStep_SetTables(ark_mem);
+    if (retval != ARK_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "Could not create Rosenbrock tables");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Check that the tables are OK */
+    retval = rowStep_CheckTables(ark_mem);
+    if (retval != ARK_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "Error in Rosenbrock tables");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Retrieve/store method and embedding orders now that tables are final */
+    step_mem->q = ark_mem->hadapt_mem->q = step_mem->A->q;
+    step_mem->p = ark_mem->hadapt_mem->p = step_mem->A->p;
+
+    /* Ensure that if adaptivity or error accumulation is enabled, then
+       method includes embedding coefficients */
+    if ((!ark_mem->fixedstep ||
+         (ark_mem->AccumErrorType != ARK_ACCUMERROR_NONE)) &&
+        (step_mem->p == 0))
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__,
+                      __FILE__, "Temporal error estimation cannot be performed without embedding coefficients");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Compute the transformed coefficients */
+    retval = rowStep_SetCoefficients(ark_mem);
+    if (retval != ARK_SUCCESS) { return (retval); }
+
+    /* Allocate stage vector memory, update storage requirements */
+    if (step_mem->U == NULL)
+    {
+      step_mem->U = (N_Vector*)calloc(step_mem->stages, sizeof(N_Vector));
+      if (step_mem->U == NULL) { return (ARK_MEM_FAIL); }
+      ark_mem->liw += step_mem->stages; /* pointers */
+    }
+    for (j = 0; j < step_mem->stages; j++)
+    {
+      if (!arkAllocVec(ark_mem, ark_mem->ewt, &(step_mem->U[j])))
+      {
+        return (ARK_MEM_FAIL);
+      }
+    }
+
+    /* Allocate reusable arrays for fused vector interface */
+    step_mem->nfusedopvecs = step_mem->stages + 2;
+    if (step_mem->cvals == NULL)
+    {
+      step_mem->cvals = (sunrealtype*)calloc(step_mem->nfusedopvecs,
+                                             sizeof(sunrealtype));
+      if (step_mem->cvals == NULL) { return (ARK_MEM_FAIL); }
+      ark_mem->lrw += step_mem->nfusedopvecs;
+    }
+    if (step_mem->Xvecs == NULL)
+    {
+      step_mem->Xvecs = (N_Vector*)calloc(step_mem->nfusedopvecs,
+                                          sizeof(N_Vector));
+      if (step_mem->Xvecs == NULL) { return (ARK_MEM_FAIL); }
+      ark_mem->liw += step_mem->nfusedopvecs; /* pointers */
+    }
+
+    /* Override the interpolant degree (if needed), used in arkInitialSetup */
+    if (step_mem->q > 1 && ark_mem->interp_degree > (step_mem->q - 1))
+    {
+      /* Limit max degree to at most one less than the method global order */
+      ark_mem->interp_degree = step_mem->q - 1;
+    }
+    else if (step_mem->q == 1 && ark_mem->interp_degree > 1)
+    {
+      /* Allow for linear interpolant with first order methods to ensure
+         solution values are returned at the time interval end points */
+      ark_mem->interp_degree = 1;
+    }
+
+    /* Every stage requires a linear solve */
+    if (step_mem->lsolve == NULL)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "ROWStep requires a linear solver, see ARKodeSetLinearSolver");
+      return (ARK_ILL_INPUT);
+    }
+
+    /* Signal to shared arkode module that full RHS evaluations are required */
+    ark_mem->call_fullrhs = SUNTRUE;
+  }
+
+  /* Call linit (if it exists) */
+  if (step_mem->linit)
+  {
+    retval = step_mem->linit(ark_mem);
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_LINIT_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_LINIT_FAIL);
+      return (ARK_LINIT_FAIL);
+    }
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*------------------------------------------------------------------------------
+  rowStep_FullRHS:
+
+  This is just a wrapper to call the user-supplied RHS function, f(t,y).
+
+  This will be called in one of three 'modes':
+
+     ARK_FULLRHS_START -> called at the beginning of a simulation i.e., at
+                          (tn, yn) = (t0, y0) or (tR, yR), or by ROWStep at
+                          the start of the first internal step.
+
+     ARK_FULLRHS_END   -> called in-between steps t_{n-1} \to t_{n} to fill
+                          f_{n} for root-finding or dense output, or by
+                          ROWStep when starting a time step t_{n} \to t_{n+1}.
+
+                          In both cases the output vector is ark_mem->fn and we
+                          may check the fn_is_current flag to know whether the
+                          values stored there are up-to-date.  Since the stages
+                          of a Rosenbrock method do not provide f_{n}, the RHS
+                          is recomputed otherwise and the time derivative of f
+                          at (tn, yn) is marked as out of date.
+
+     ARK_FULLRHS_OTHER -> called when estimating the initial time step size,
+                          for high-order dense output with the Hermite
+                          interpolation module, or by an "outer" stepper.  The
+                          (t,y) input does not correspond to an "official" time
+                          step, thus the RHS is always evaluated.
+  ----------------------------------------------------------------------------*/
+int rowStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector f,
+                    int mode)
+{
+  int retval;
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* perform RHS functions contingent on 'mode' argument */
+  switch (mode)
+  {
+  case ARK_FULLRHS_START:
+  case ARK_FULLRHS_END:
+
+    /* compute the RHS if needed */
+    if (!(ark_mem->fn_is_current))
+    {
+      retval = step_mem->f(t, y, f, ark_mem->user_data);
+      step_mem->nfe++;
+      if (retval != 0)
+      {
+        arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                        MSG_ARK_RHSFUNC_FAILED, t);
+        return (ARK_RHSFUNC_FAIL);
+      }
+      step_mem->fdt_current = SUNFALSE;
+    }
+
+    break;
+
+  case ARK_FULLRHS_OTHER:
+
+    /* call f */
+    retval = step_mem->f(t, y, f, ark_mem->user_data);
+    step_mem->nfe++;
+    if (retval != 0)
+    {
+      arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_RHSFUNC_FAILED, t);
+      return (ARK_RHSFUNC_FAIL);
+    }
+
+    break;
+
+  default:
+    /* return with RHS failure if unknown mode is passed */
+    arkProcessError(ark_mem, ARK_RHSFUNC_FAIL, __LINE__, __func__, __FILE__,
+                    "Unknown full RHS mode");
+    return (ARK_RHSFUNC_FAIL);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_TakeStep:
+
+  This routine serves the primary purpose of the ROWStep module:
+  it performs a single Rosenbrock step (with embedding, if
+  possible).  Each stage requires one RHS evaluation and one
+  linear solve with the matrix I - h*gamma*J, which is set up
+  once per step.  For W-methods the Jacobian information held
+  by the linear solver interface is reused across steps.
+
+  The output variable dsmPtr should contain estimate of the
+  weighted local error if an embedding is present; otherwise it
+  should be 0.
+
+  The input/output variable nflagPtr is used to gauge convergence
+  of the linear solves within the step.  On input it indicates
+  whether the previous attempt failed, and on output it is set
+  to 0 (success), CONV_FAIL or RHSFUNC_RECVR (recoverable
+  failures), or ARK_LSETUP_FAIL or ARK_LSOLVE_FAIL (fatal).
+
+  The return value from this routine is:
+            0 => step completed successfully
+           >0 => step encountered recoverable failure;
+                 reduce step and retry (if possible)
+           <0 => step encountered unrecoverable failure
+  ---------------------------------------------------------------*/
+int rowStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr)
+{
+  int retval, is, js, nvec, mode, convfail;
+  sunbooleantype callSetup, use_fdt;
+  sunrealtype* cvals;
+  N_Vector* Xvecs;
+  N_Vector fstage;
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* local shortcuts for fused vector operations */
+  cvals = step_mem->cvals;
+  Xvecs = step_mem->Xvecs;
+
+  /* a failed linear solve in the previous attempt requires fresh
+     Jacobian information, otherwise W-methods may reuse it */
+  convfail = ((*nflagPtr == PREV_CONV_FAIL) || !step_mem->wmethod)
+               ? ARK_FAIL_OTHER
+               : ARK_NO_FAILURES;
+
+  /* initialize linear solver convergence flag to success */
+  *nflagPtr = ARK_SUCCESS;
+
+  SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = 0, tcur = %" RSYM,
+             ark_mem->tcur);
+  SUNLogExtraDebugVec(ARK_LOGGER, "stage", ark_mem->yn, "z_0(:) =");
+
+  /* Call the full RHS if needed. If this is the first step then we may need to
+     evaluate the RHS values from an earlier evaluation (e.g., to compute h0).
+     For subsequent steps treat this RHS evaluation as an evaluation at the end
+     of the just completed step. */
+  if (!(ark_mem->fn_is_current))
+  {
+    mode   = (ark_mem->initsetup) ? ARK_FULLRHS_START : ARK_FULLRHS_END;
+    retval = ark_mem->step_fullrhs(ark_mem, ark_mem->tn, ark_mem->yn,
+                                   ark_mem->fn, mode);
+    if (retval)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      return ARK_RHSFUNC_FAIL;
+    }
+    ark_mem->fn_is_current = SUNTRUE;
+  }
+
+  /* Compute the time derivative of f for non-autonomous problems */
+  use_fdt = SUNFALSE;
+  if (!step_mem->autonomous)
+  {
+    for (is = 0; is < step_mem->stages; is++)
+    {
+      if (step_mem->gsum[is] != ZERO) { use_fdt = SUNTRUE; }
+    }
+  }
+  if (use_fdt && !step_mem->fdt_current)
+  {
+    retval = rowStep_ComputeFdt(ark_mem);
+    if (retval != ARK_SUCCESS)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed rhs eval, retval = %i", retval);
+      if (retval > 0)
+      {
+        *nflagPtr = RHSFUNC_RECVR;
+        return (TRY_AGAIN);
+      }
+      return (retval);
+    }
+  }
+
+  /* Set up the linear system I - gamma J with gamma = h * gdiag */
+  step_mem->gamma = ark_mem->h * step_mem->gdiag;
+  if (ark_mem->firststage) { step_mem->gammap = step_mem->gamma; }
+  step_mem->gamrat = (ark_mem->firststage) ? ONE
+                                           : step_mem->gamma / step_mem->gammap;
+
+  callSetup = ark_mem->initsetup || (convfail == ARK_FAIL_OTHER) ||
+              (step_mem->gamma != step_mem->gammap) ||
+              (ark_mem->nst >= step_mem->nstlp + step_mem->msbp);
+
+  if (step_mem->lsetup && callSetup)
+  {
+    step_mem->nsetups++;
+    retval = step_mem->lsetup(ark_mem, convfail, ark_mem->tn, ark_mem->yn,
+                              ark_mem->fn, &(step_mem->jcur), ark_mem->tempv1,
+                              ark_mem->tempv2, ark_mem->tempv3);
+
+    /* update flags and 'gamma' values for last lsetup call */
+    ark_mem->firststage = SUNFALSE;
+    step_mem->gammap    = step_mem->gamma;
+    step_mem->gamrat    = ONE;
+    step_mem->nstlp     = ark_mem->nst;
+
+    if (retval != 0)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed linear solver setup, retval = %i", retval);
+      *nflagPtr = (retval < 0) ? ARK_LSETUP_FAIL : CONV_FAIL;
+      return (TRY_AGAIN);
+    }
+  }
+
+  SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+
+  /* Loop over internal stages to the step */
+  for (is = 0; is < step_mem->stages; is++)
+  {
+    /* Set current stage time */
+    ark_mem->tcur = ark_mem->tn + step_mem->A->c[is] * ark_mem->h;
+
+    SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = %i, tcur = %" RSYM, is,
+               ark_mem->tcur);
+
+    /* The first stage RHS is the full RHS from the start of the step,
+       otherwise set ycur to the stage solution and evaluate f */
+    if ((is == 0) && (step_mem->A->c[0] == ZERO)) { fstage = ark_mem->fn; }
+    else
+    {
+      nvec = 0;
+      for (js = 0; js < is; js++)
+      {
+        cvals[nvec] = step_mem->a[is * step_mem->stages + js];
+        Xvecs[nvec] = step_mem->U[js];
+        nvec += 1;
+      }
+      cvals[nvec] = ONE;
+      Xvecs[nvec] = ark_mem->yn;
+      nvec += 1;
+
+      /*   call fused vector operation to do the work */
+      retval = N_VLinearCombination(nvec, cvals, Xvecs, ark_mem->ycur);
+      if (retval != 0)
+      {
+        SUNLogInfo(ARK_LOGGER, "end-stage",
+                   "status = failed vector op, retval = %i", retval);
+        return (ARK_VECTOROP_ERR);
+      }
+
+      /* apply user-supplied stage postprocessing function (if supplied) */
+      if (ark_mem->ProcessStage != NULL)
+      {
+        retval = ark_mem->ProcessStage(ark_mem->tcur, ark_mem->ycur,
+                                       ark_mem->user_data);
+        if (retval != 0)
+        {
+          SUNLogInfo(ARK_LOGGER, "end-stage",
+                     "status = failed postprocess stage, retval = %i", retval);
+          return (ARK_POSTPROCESS_STAGE_FAIL);
+        }
+      }
+
+      /* compute updated RHS */
+      fstage = ark_mem->tempv2;
+      retval = step_mem->f(ark_mem->tcur, ark_mem->ycur, fstage,
+                           ark_mem->user_data);
+      step_mem->nfe++;
+
+      SUNLogExtraDebugVec(ARK_LOGGER, "stage RHS", fstage, "F_%i(:) =", is);
+      SUNLogInfoIf(retval != 0, ARK_LOGGER, "end-stage",
+                   "status = failed rhs eval, retval = %i", retval);
+
+      if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+      if (retval > 0)
+      {
+        *nflagPtr = RHSFUNC_RECVR;
+        return (TRY_AGAIN);
+      }
+    }
+
+    /* Set up the stage right-hand side
+         gamma f_i + gdiag sum_j c_ij u_j + h gamma gamma_i f_t */
+    nvec        = 0;
+    cvals[nvec] = step_mem->gamma;
+    Xvecs[nvec] = fstage;
+    nvec += 1;
+    for (js = 0; js < is; js++)
+    {
+      cvals[nvec] = step_mem->gdiag * step_mem->c[is * step_mem->stages + js];
+      Xvecs[nvec] = step_mem->U[js];
+      nvec += 1;
+    }
+    if (use_fdt)
+    {
+      cvals[nvec] = ark_mem->h * step_mem->gamma * step_mem->gsum[is];
+      Xvecs[nvec] = step_mem->fdt;
+      nvec += 1;
+    }
+
+    retval = N_VLinearCombination(nvec, cvals, Xvecs, step_mem->U[is]);
+    if (retval != 0)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed vector op, retval = %i", retval);
+      return (ARK_VECTOROP_ERR);
+    }
+
+    /* Solve (I - gamma J) u_i = rhs in place */
+    retval = step_mem->lsolve(ark_mem, step_mem->U[is], ark_mem->tn,
+                              ark_mem->yn, ark_mem->fn, ROW_EPSLIN, 0);
+    if (retval != 0)
+    {
+      SUNLogInfo(ARK_LOGGER, "end-stage",
+                 "status = failed linear solve, retval = %i", retval);
+      *nflagPtr = (retval < 0) ? ARK_LSOLVE_FAIL : CONV_FAIL;
+      return (TRY_AGAIN);
+    }
+
+    SUNLogExtraDebugVec(ARK_LOGGER, "stage increment", step_mem->U[is],
+                        "U_%i(:) =", is);
+    SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+
+  } /* loop over stages */
+
+  SUNLogInfo(ARK_LOGGER, "begin-compute-solution", "");
+
+  /* compute time-evolved solution (in ark_ycur), error estimate (in dsm) */
+  retval = rowStep_ComputeSolutions(ark_mem, dsmPtr);
+  if (retval < 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-compute-solution",
+               "status = failed compute solution, retval = %i", retval);
+    return (retval);
+  }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "updated solution", ark_mem->ycur, "ycur(:) =");
+  SUNLogInfo(ARK_LOGGER, "end-compute-solution", "status = success");
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Internal utility routines
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  rowStep_AccessARKODEStepMem:
+
+  Shortcut routine to unpack both ark_mem and step_mem structures
+  from void* pointer.  If either is missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int rowStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                ARKodeMem* ark_mem, ARKodeROWStepMem* step_mem)
+{
+  /* access ARKodeMem structure */
+  if (arkode_mem == NULL)
+  {
+    arkProcessError(NULL, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *ark_mem = (ARKodeMem)arkode_mem;
+
+  /* access ARKodeROWStepMem structure */
+  if ((*ark_mem)->step_mem == NULL)
+  {
+    arkProcessError(*ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeROWStepMem)(*ark_mem)->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_AccessStepMem:
+
+  Shortcut routine to unpack the step_mem structure from
+  ark_mem.  If missing it returns ARK_MEM_NULL.
+  ---------------------------------------------------------------*/
+int rowStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                          ARKodeROWStepMem* step_mem)
+{
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, fname, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  *step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_CheckNVector:
+
+  This routine checks if all required vector operations are
+  present.  If any of them is missing it returns SUNFALSE.
+  ---------------------------------------------------------------*/
+sunbooleantype rowStep_CheckNVector(N_Vector tmpl)
+{
+  if ((tmpl->ops->nvclone == NULL) || (tmpl->ops->nvdestroy == NULL) ||
+      (tmpl->ops->nvlinearsum == NULL) || (tmpl->ops->nvconst == NULL) ||
+      (tmpl->ops->nvscale == NULL) || (tmpl->ops->nvwrmsnorm == NULL))
+  {
+    return (SUNFALSE);
+  }
+  return (SUNTRUE);
+}
+
+/*---------------------------------------------------------------
+  rowStep_LoadTables:
+
+  Creates the pair of tables for a built-in Rosenbrock method.
+  The table A holds the coefficients alpha_ij, the stage times
+  alpha_i = sum_j alpha_ij and the weights b and bhat, while the
+  table G holds the coefficients gamma_ij in its A array.
+  ---------------------------------------------------------------*/
+int rowStep_LoadTables(ARKODE_ROWTableID rtable, ARKodeButcherTable* A,
+                       ARKodeButcherTable* G, sunbooleantype* wmethod)
+{
+  int s, q, p;
+  sunrealtype g;
+  sunrealtype alpha[16], gam[16], c[4], b[4], d[4], zero[4];
+
+  memset(alpha, 0, sizeof(alpha));
+  memset(gam, 0, sizeof(gam));
+  memset(zero, 0, sizeof(zero));
+
+  switch (rtable)
+  {
+  case (ARKODE_ROS2_2_1_2):
+    /* 2-stage, second order W-method with a first order embedding,
+       see Verwer et al., SIAM J. Sci. Comput. 20 (1999) */
+    s = 2;
+    q = 2;
+    p = 1;
+    g = ONE + ONE / SUNRsqrt(TWO);
+
+    alpha[1 * s + 0] = ONE;
+
+    gam[0 * s + 0] = g;
+    gam[1 * s + 0] = -TWO * g;
+    gam[1 * s + 1] = g;
+
+    c[0] = ZERO;
+    c[1] = ONE;
+
+    b[0] = HALF;
+    b[1] = HALF;
+
+    d[0] = ONE;
+    d[1] = ZERO;
+
+    *wmethod = SUNTRUE;
+    break;
+
+  case (ARKODE_ROS3P_3_2_3):
+    /* 3-stage, third order Rosenbrock method with a second order
+       embedding, see Lang & Verwer, BIT 41 (2001) */
+    s = 3;
+    q = 3;
+    p = 2;
+    g = (SUN_RCONST(3.0) + SUNRsqrt(SUN_RCONST(3.0))) / SUN_RCONST(6.0);
+
+    alpha[1 * s + 0] = ONE;
+    alpha[2 * s + 0] = ONE;
+
+    gam[0 * s + 0] = g;
+    gam[1 * s + 0] = -ONE;
+    gam[1 * s + 1] = g;
+    gam[2 * s + 0] = -g;
+    gam[2 * s + 1] = HALF - TWO * g;
+    gam[2 * s + 2] = g;
+
+    c[0] = ZERO;
+    c[1] = ONE;
+    c[2] = ONE;
+
+    b[0] = TWO / SUN_RCONST(3.0);
+    b[1] = ZERO;
+    b[2] = ONE / SUN_RCONST(3.0);
+
+    d[0] = ONE / SUN_RCONST(3.0);
+    d[1] = ONE / SUN_RCONST(3.0);
+    d[2] = ONE / SUN_RCONST(3.0);
+
+    *wmethod = SUNFALSE;
+    break;
+
+  case (ARKODE_ROS34PW2_4_2_3):
+    /* 4-stage, third order W-method with a second order embedding,
+       see Rang & Angermann, BIT 45 (2005) */
+    s = 4;
+    q = 3;
+    p = 2;
+    g = SUN_RCONST(0.4358665215084590);
+
+    alpha[1 * s + 0] = SUN_RCONST(0.87173304301691801);
+    alpha[2 * s + 0] = SUN_RCONST(0.84457060015369423);
+    alpha[2 * s + 1] = SUN_RCONST(-0.11299064236484185);
+    alpha[3 * s + 2] = ONE;
+
+    gam[0 * s + 0] = g;
+    gam[1 * s + 0] = SUN_RCONST(-0.87173304301691801);
+    gam[1 * s + 1] = g;
+    gam[2 * s + 0] = SUN_RCONST(-0.90338057013044082);
+    gam[2 * s + 1] = SUN_RCONST(0.054180672388095326);
+    gam[2 * s + 2] = g;
+    gam[3 * s + 0] = SUN_RCONST(0.24212380706095346);
+    gam[3 * s + 1] = SUN_RCONST(-1.2232505839045147);
+    gam[3 * s + 2] = SUN_RCONST(0.54526025533510214);
+    gam[3 * s + 3] = g;
+
+    c[0] = ZERO;
+    c[1] = SUN_RCONST(0.87173304301691801);
+    c[2] = SUN_RCONST(0.73157995778885238);
+    c[3] = ONE;
+
+    b[0] = SUN_RCONST(0.24212380706095346);
+    b[1] = SUN_RCONST(-1.2232505839045147);
+    b[2] = SUN_RCONST(1.5452602553351020);
+    b[3] = SUN_RCONST(0.4358665215084590);
+
+    d[0] = SUN_RCONST(0.37810903145819369);
+    d[1] = SUN_RCONST(-0.096042292212423178);
+    d[2] = HALF;
+    d[3] = SUN_RCONST(0.2179332607542295);
+
+    *wmethod = SUNTRUE;
+    break;
+
+  default: return (ARK_ILL_INPUT);
+  }
+
+  *A = ARKodeButcherTable_Create(s, q, p, c, alpha, b, d);
+  *G = ARKodeButcherTable_Create(s, q, 0, zero, gam, zero, NULL);
+  if (*A == NULL || *G == NULL)
+  {
+    ARKodeButcherTable_Free(*A);
+    ARKodeButcherTable_Free(*G);
+    *A = *G = NULL;
+    return (ARK_MEM_FAIL);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_FreeTables:
+
+  Frees the Rosenbrock tables along with all data that depends
+  on the number of stages (transformed coefficients, stage
+  vectors and fused operation arrays).
+  ---------------------------------------------------------------*/
+void rowStep_FreeTables(ARKodeMem ark_mem)
+{
+  int j, s;
+  sunindextype Bliw, Blrw;
+  ARKodeROWStepMem step_mem;
+
+  if (ark_mem->step_mem == NULL) { return; }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+  s        = step_mem->stages;
+
+  /* free the tables */
+  if (step_mem->A != NULL)
+  {
+    ARKodeButcherTable_Space(step_mem->A, &Bliw, &Blrw);
+    ARKodeButcherTable_Free(step_mem->A);
+    step_mem->A = NULL;
+    ark_mem->liw -= Bliw;
+    ark_mem->lrw -= Blrw;
+  }
+  if (step_mem->G != NULL)
+  {
+    ARKodeButcherTable_Space(step_mem->G, &Bliw, &Blrw);
+    ARKodeButcherTable_Free(step_mem->G);
+    step_mem->G = NULL;
+    ark_mem->liw -= Bliw;
+    ark_mem->lrw -= Blrw;
+  }
+
+  /* free the transformed coefficients */
+  if (step_mem->a != NULL)
+  {
+    free(step_mem->a);
+    free(step_mem->c);
+    free(step_mem->m);
+    free(step_mem->mhat);
+    free(step_mem->gsum);
+    step_mem->a    = NULL;
+    step_mem->c    = NULL;
+    step_mem->m    = NULL;
+    step_mem->mhat = NULL;
+    step_mem->gsum = NULL;
+    ark_mem->lrw -= 2 * s * s + 3 * s;
+  }
+
+  /* free the stage vectors */
+  if (step_mem->U != NULL)
+  {
+    for (j = 0; j < s; j++) { arkFreeVec(ark_mem, &step_mem->U[j]); }
+    free(step_mem->U);
+    step_mem->U = NULL;
+    ark_mem->liw -= s;
+  }
+
+  /* free the reusable arrays for fused vector interface */
+  if (step_mem->cvals != NULL)
+  {
+    free(step_mem->cvals);
+    step_mem->cvals = NULL;
+    ark_mem->lrw -= step_mem->nfusedopvecs;
+  }
+  if (step_mem->Xvecs != NULL)
+  {
+    free(step_mem->Xvecs);
+    step_mem->Xvecs = NULL;
+    ark_mem->liw -= step_mem->nfusedopvecs;
+  }
+  step_mem->nfusedopvecs = 0;
+
+  /* clear the method parameters */
+  step_mem->stages = 0;
+  step_mem->p      = 0;
+  step_mem->gdiag  = ZERO;
+}
+
+/*---------------------------------------------------------------
+  rowStep_SetTables
+
+  This routine determines the Rosenbrock method to use, based on
+  the desired accuracy.
+  ---------------------------------------------------------------*/
+int rowStep_SetTables(ARKodeMem ark_mem)
+{
+  int rtable;
+  ARKodeROWStepMem step_mem;
+  sunindextype Bliw, Blrw;
+
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+
+  /* if tables have already been specified, just return */
+  if (step_mem->A != NULL && step_mem->G != NULL) { return (ARK_SUCCESS); }
+
+  /* select method based on order */
+  switch (step_mem->q)
+  {
+  case (1):
+  case (2): rtable = ROWSTEP_DEFAULT_2; break;
+  case (3): rtable = ROWSTEP_DEFAULT_3; break;
+  default: /* no available method, set default */
+    arkProcessError(ark_mem, ARK_WARNING, __LINE__, __func__, __FILE__,
+                    "No Rosenbrock method at requested order, using q=3.");
+    rtable = ROWSTEP_DEFAULT_3;
+    break;
+  }
+
+  if (rowStep_LoadTables(rtable, &step_mem->A, &step_mem->G,
+                         &step_mem->wmethod) != ARK_SUCCESS)
+  {
+    return (ARK_ILL_INPUT);
+  }
+
+  /* note table space requirements */
+  ARKodeButcherTable_Space(step_mem->A, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+  ARKodeButcherTable_Space(step_mem->G, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+
+  /* set [redundant] stored values for stage numbers and method orders */
+  step_mem->stages = step_mem->A->stages;
+  step_mem->q      = step_mem->A->q;
+  step_mem->p      = step_mem->A->p;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_CheckTables
+
+  This routine runs through the Rosenbrock tables to ensure that
+  they meet all necessary requirements, including:
+    stages > 0 and equal in both tables
+    method order q > 0
+    embedding order p > 0 (if adaptive time-stepping enabled)
+    alpha strictly lower-triangular
+    gamma lower-triangular with a constant, nonzero diagonal
+
+  Returns ARK_SUCCESS if tables pass, ARK_INVALID_TABLE otherwise.
+  ---------------------------------------------------------------*/
+int rowStep_CheckTables(ARKodeMem ark_mem)
+{
+  int i, j;
+  sunbooleantype okay;
+  ARKodeROWStepMem step_mem;
+  sunrealtype tol = SUN_RCONST(1.0e-12);
+
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+
+  /* check that stages > 0 */
+  if (step_mem->stages < 1)
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "stages < 1!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  /* check that both tables have the same number of stages */
+  if (step_mem->G->stages != step_mem->stages)
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "alpha and gamma tables have different numbers of stages!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  /* check that method order q > 0 */
+  if (step_mem->q < 1)
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "method order < 1!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  /* check that embedding order p > 0 */
+  if ((step_mem->p < 1) && (!ark_mem->fixedstep))
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "embedding order < 1!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  /* check that embedding exists */
+  if ((step_mem->p > 0) && (!ark_mem->fixedstep))
+  {
+    if (step_mem->A->d == NULL)
+    {
+      arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                      "no embedding!");
+      return (ARK_INVALID_TABLE);
+    }
+  }
+
+  /* check that alpha table is strictly lower triangular */
+  okay = SUNTRUE;
+  for (i = 0; i < step_mem->stages; i++)
+  {
+    for (j = i; j < step_mem->stages; j++)
+    {
+      if (SUNRabs(step_mem->A->A[i][j]) > tol) { okay = SUNFALSE; }
+    }
+  }
+  if (!okay)
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "alpha table is implicit!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  /* check that gamma table is lower triangular with a constant diagonal */
+  okay = (SUNRabs(step_mem->G->A[0][0]) > tol);
+  for (i = 0; i < step_mem->stages; i++)
+  {
+    if (SUNRabs(step_mem->G->A[i][i] - step_mem->G->A[0][0]) > tol)
+    {
+      okay = SUNFALSE;
+    }
+    for (j = i + 1; j < step_mem->stages; j++)
+    {
+      if (SUNRabs(step_mem->G->A[i][j]) > tol) { okay = SUNFALSE; }
+    }
+  }
+  if (!okay)
+  {
+    arkProcessError(ark_mem, ARK_INVALID_TABLE, __LINE__, __func__, __FILE__,
+                    "gamma table must be lower triangular with a constant, nonzero diagonal!");
+    return (ARK_INVALID_TABLE);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_SetCoefficients
+
+  This routine computes the coefficients of the transformed
+  Rosenbrock formulation from the alpha and gamma tables,
+    a    = alpha Gamma^{-1},
+    c    = diag(1/gamma) - Gamma^{-1},
+    m    = b Gamma^{-1},
+    mhat = bhat Gamma^{-1},
+  along with the row sums gamma_i of Gamma, so that no matrix
+  products with the stage vectors are needed within a step.
+  ---------------------------------------------------------------*/
+int rowStep_SetCoefficients(ARKodeMem ark_mem)
+{
+  int i, j, k, s;
+  sunrealtype sum;
+  sunrealtype* Ginv;
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+  s        = step_mem->stages;
+
+  /* allocate the coefficient arrays (if needed) */
+  if (step_mem->a == NULL)
+  {
+    step_mem->a    = (sunrealtype*)calloc(s * s, sizeof(sunrealtype));
+    step_mem->c    = (sunrealtype*)calloc(s * s, sizeof(sunrealtype));
+    step_mem->m    = (sunrealtype*)calloc(s, sizeof(sunrealtype));
+    step_mem->mhat = (sunrealtype*)calloc(s, sizeof(sunrealtype));
+    step_mem->gsum = (sunrealtype*)calloc(s, sizeof(sunrealtype));
+    if (step_mem->a == NULL || step_mem->c == NULL || step_mem->m == NULL ||
+        step_mem->mhat == NULL || step_mem->gsum == NULL)
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_MEM_FAIL);
+      return (ARK_MEM_FAIL);
+    }
+    ark_mem->lrw += 2 * s * s + 3 * s;
+  }
+
+  /* store the inverse of the lower triangular Gamma in c */
+  Ginv            = step_mem->c;
+  step_mem->gdiag = step_mem->G->A[0][0];
+  for (j = 0; j < s; j++)
+  {
+    for (i = 0; i < s; i++) { Ginv[i * s + j] = ZERO; }
+    Ginv[j * s + j] = ONE / step_mem->G->A[j][j];
+    for (i = j + 1; i < s; i++)
+    {
+      sum = ZERO;
+      for (k = j; k < i; k++) { sum += step_mem->G->A[i][k] * Ginv[k * s + j]; }
+      Ginv[i * s + j] = -sum / step_mem->G->A[i][i];
+    }
+  }
+
+  /* a = alpha Gamma^{-1}, gamma_i = sum_j gamma_ij */
+  for (i = 0; i < s; i++)
+  {
+    step_mem->gsum[i] = ZERO;
+    for (j = 0; j <= i; j++) { step_mem->gsum[i] += step_mem->G->A[i][j]; }
+    for (j = 0; j < s; j++)
+    {
+      sum = ZERO;
+      for (k = 0; k < s; k++) { sum += step_mem->A->A[i][k] * Ginv[k * s + j]; }
+      step_mem->a[i * s + j] = sum;
+    }
+  }
+
+  /* m = b Gamma^{-1}, mhat = bhat Gamma^{-1} */
+  for (j = 0; j < s; j++)
+  {
+    step_mem->m[j]    = ZERO;
+    step_mem->mhat[j] = ZERO;
+    for (k = 0; k < s; k++)
+    {
+      step_mem->m[j] += step_mem->A->b[k] * Ginv[k * s + j];
+      if (step_mem->A->d != NULL)
+      {
+        step_mem->mhat[j] += step_mem->A->d[k] * Ginv[k * s + j];
+      }
+    }
+  }
+
+  /* c = diag(1/gamma) - Gamma^{-1} */
+  for (i = 0; i < s; i++)
+  {
+    for (j = 0; j < s; j++) { step_mem->c[i * s + j] = -Ginv[i * s + j]; }
+    step_mem->c[i * s + i] += ONE / step_mem->gdiag;
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_ComputeFdt
+
+  This routine approximates the time derivative of f at (tn, yn)
+  with a forward difference, storing the result in fdt.
+
+  Returns ARK_SUCCESS, ARK_RHSFUNC_FAIL (unrecoverable) or
+  RHSFUNC_RECVR (recoverable).
+  ---------------------------------------------------------------*/
+int rowStep_ComputeFdt(ARKodeMem ark_mem)
+{
+  int retval;
+  sunrealtype delta;
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* increment in t with the direction of integration */
+  delta = SUNRsqrt(ark_mem->uround) *
+          SUNMAX(SUNRabs(ark_mem->tn), SUNRabs(ark_mem->h));
+  if (ark_mem->h < ZERO) { delta = -delta; }
+
+  retval = step_mem->f(ark_mem->tn + delta, ark_mem->yn, step_mem->fdt,
+                       ark_mem->user_data);
+  step_mem->nfe++;
+  if (retval < 0) { return (ARK_RHSFUNC_FAIL); }
+  if (retval > 0) { return (RHSFUNC_RECVR); }
+
+  N_VLinearSum(ONE / delta, step_mem->fdt, -ONE / delta, ark_mem->fn,
+               step_mem->fdt);
+  step_mem->fdt_current = SUNTRUE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_ComputeSolutions
+
+  This routine calculates the final Rosenbrock solution using the
+  existing data.  This solution is placed directly in ark_ycur.
+  This routine also computes the error estimate ||y-ytilde||_WRMS,
+  where ytilde is the embedded solution, and the norm weights come
+  from ark_ewt.  This norm value is returned.  The vector form of
+  this estimated error (y-ytilde) is stored in ark_tempv1, in case
+  the calling routine wishes to examine the error locations.
+  ---------------------------------------------------------------*/
+int rowStep_ComputeSolutions(ARKodeMem ark_mem, sunrealtype* dsmPtr)
+{
+  /* local data */
+  int retval, j, nvec;
+  N_Vector y, yerr;
+  sunrealtype* cvals;
+  N_Vector* Xvecs;
+  ARKodeROWStepMem step_mem;
+
+  /* access ARKodeROWStepMem structure */
+  if (ark_mem->step_mem == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ROWSTEP_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+  step_mem = (ARKodeROWStepMem)ark_mem->step_mem;
+
+  /* set N_Vector shortcuts */
+  y    = ark_mem->ycur;
+  yerr = ark_mem->tempv1;
+
+  /* local shortcuts for fused vector operations */
+  cvals = step_mem->cvals;
+  Xvecs = step_mem->Xvecs;
+
+  /* initialize output */
+  *dsmPtr = ZERO;
+
+  /* Compute time step solution */
+  /*   set arrays for fused vector operation */
+  nvec = 0;
+  for (j = 0; j < step_mem->stages; j++)
+  {
+    cvals[nvec] = step_mem->m[j];
+    Xvecs[nvec] = step_mem->U[j];
+    nvec += 1;
+  }
+  cvals[nvec] = ONE;
+  Xvecs[nvec] = ark_mem->yn;
+  nvec += 1;
+
+  /*   call fused vector operation to do the work */
+  retval = N_VLinearCombination(nvec, cvals, Xvecs, y);
+  if (retval != 0) { return (ARK_VECTOROP_ERR); }
+
+  /* Compute yerr (if step adaptivity or error accumulation enabled) */
+  if (!ark_mem->fixedstep || (ark_mem->AccumErrorType != ARK_ACCUMERROR_NONE))
+  {
+    /* set arrays for fused vector operation */
+    nvec = 0;
+    for (j = 0; j < step_mem->stages; j++)
+    {
+      cvals[nvec] = step_mem->m[j] - step_mem->mhat[j];
+      Xvecs[nvec] = step_mem->U[j];
+      nvec += 1;
+    }
+
+    /* call fused vector operation to do the work */
+    retval = N_VLinearCombination(nvec, cvals, Xvecs, yerr);
+    if (retval != 0) { return (ARK_VECTOROP_ERR); }
+
+    /* fill error norm */
+    *dsmPtr = N_VWrmsNorm(yerr, ark_mem->ewt);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
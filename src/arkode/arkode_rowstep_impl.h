@@ -0,0 +1,170 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * Implementation header file for ARKODE's Rosenbrock (ROW) time
+ * stepper module.
+ *--------------------------------------------------------------*/
+
+#ifndef _ARKODE_ROWSTEP_IMPL_H
+#define _ARKODE_ROWSTEP_IMPL_H
+
+#include <arkode/arkode_rowstep.h>
+
+#include "arkode_impl.h"
+#include "arkode_ls_impl.h"
+
+#ifdef __cplusplus /* wrapper to enable C++ usage */
+extern "C" {
+#endif
+
+/*===============================================================
+  ROW time step module constants
+  ===============================================================*/
+
+#define ROW_Q_DEFAULT 3                /* default method order          */
+#define ROW_MSBP      20               /* max steps between lsetup      */
+#define ROW_EPSLIN    SUN_RCONST(0.1)  /* stage linear solve tolerance  */
+
+/*===============================================================
+  ROW time step module data structure
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  Types : struct ARKodeROWStepMemRec, ARKodeROWStepMem
+  ---------------------------------------------------------------
+  The type ARKodeROWStepMem is type pointer to struct
+  ARKodeROWStepMemRec.  This structure contains fields to
+  perform a linearly-implicit Rosenbrock or Rosenbrock-W time
+  step.
+
+  A method is given by two Butcher tables, A holding the stage
+  coefficients alpha_ij, the stage times alpha_i and the weights
+  b and bhat, and G holding the lower-triangular coefficients
+  gamma_ij with a constant diagonal gamma.  The step is computed
+  in the transformed variables of Hairer & Wanner (IV.7.25)
+
+    (I - h gamma J) u_i = h gamma ( f(tn + alpha_i h, yn + sum_j a_ij u_j)
+                                    + sum_j c_ij/h u_j + gamma_i h f_t )
+
+  with a = alpha G^{-1}, c = diag(1/gamma) - G^{-1}, m = b G^{-1}
+  and mhat = bhat G^{-1}, so that y_{n+1} = yn + sum_i m_i u_i.
+  ---------------------------------------------------------------*/
+typedef struct ARKodeROWStepMemRec
+{
+  /* ROW problem specification */
+  ARKRhsFn f;                /* y' = f(t,y)                      */
+  sunbooleantype autonomous; /* f does not depend on t           */
+
+  /* ROW method storage and parameters */
+  N_Vector* U;                /* transformed stage solutions u_i  */
+  N_Vector fdt;               /* df/dt(tn, yn)                    */
+  sunbooleantype fdt_current; /* is fdt up to date?               */
+  int q;                      /* method order                     */
+  int p;                      /* embedding order                  */
+  int stages;                 /* number of stages                 */
+  sunbooleantype wmethod;     /* W-method (any J approximation)   */
+  ARKodeButcherTable A;       /* alpha, b and bhat coefficients   */
+  ARKodeButcherTable G;       /* gamma coefficients               */
+  sunrealtype gdiag;          /* diagonal coefficient gamma       */
+  sunrealtype* a;             /* transformed coefficients (s x s) */
+  sunrealtype* c;             /* transformed coefficients (s x s) */
+  sunrealtype* m;             /* transformed weights              */
+  sunrealtype* mhat;          /* transformed embedding weights    */
+  sunrealtype* gsum;          /* gamma_i = sum_j gamma_ij         */
+
+  /* Linear Solver Data */
+  ARKLinsolInitFn linit;
+  ARKLinsolSetupFn lsetup;
+  ARKLinsolSolveFn lsolve;
+  ARKLinsolFreeFn lfree;
+  void* lmem;
+  SUNLinearSolver_Type lsolve_type;
+
+  /* Linear solver setup data */
+  sunrealtype gamma;   /* gamma = h * gdiag                     */
+  sunrealtype gammap;  /* gamma at the last setup call          */
+  sunrealtype gamrat;  /* gamma / gammap, always 1 after setup  */
+  sunbooleantype jcur; /* is Jacobian info. for lin solver current? */
+  int msbp;            /* positive => max # steps between lsetup */
+  long int nstlp;      /* step number of last setup call         */
+
+  /* Counters */
+  long int nfe;     /* num f calls                             */
+  long int nsetups; /* num linear solver setup calls           */
+
+  /* Reusable arrays for fused vector operations */
+  sunrealtype* cvals;
+  N_Vector* Xvecs;
+  int nfusedopvecs; /* length of cvals and Xvecs arrays */
+
+}* ARKodeROWStepMem;
+
+/*===============================================================
+  ROW time step module private function prototypes
+  ===============================================================*/
+
+/* Interface routines supplied to ARKODE */
+int rowStep_AttachLinsol(ARKodeMem ark_mem, ARKLinsolInitFn linit,
+                         ARKLinsolSetupFn lsetup, ARKLinsolSolveFn lsolve,
+                         ARKLinsolFreeFn lfree,
+                         SUNLinearSolver_Type lsolve_type, void* lmem);
+void rowStep_DisableLSetup(ARKodeMem ark_mem);
+int rowStep_Init(ARKodeMem ark_mem, sunrealtype tout, int init_type);
+void* rowStep_GetLmem(ARKodeMem ark_mem);
+ARKRhsFn rowStep_GetImplicitRHS(ARKodeMem ark_mem);
+int rowStep_GetGammas(ARKodeMem ark_mem, sunrealtype* gamma, sunrealtype* gamrat,
+                      sunbooleantype** jcur, sunbooleantype* dgamma_fail);
+int rowStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y, N_Vector f,
+                    int mode);
+int rowStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr, int* nflagPtr);
+int rowStep_SetDefaults(ARKodeMem ark_mem);
+int rowStep_SetOrder(ARKodeMem ark_mem, int ord);
+int rowStep_SetAutonomous(ARKodeMem ark_mem, sunbooleantype autonomous);
+int rowStep_SetLSetupFrequency(ARKodeMem ark_mem, int msbp);
+int rowStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt);
+int rowStep_WriteParameters(ARKodeMem ark_mem, FILE* fp);
+int rowStep_Resize(ARKodeMem ark_mem, N_Vector y0, sunrealtype hscale,
+                   sunrealtype t0, ARKVecResizeFn resize, void* resize_data);
+void rowStep_Free(ARKodeMem ark_mem);
+void rowStep_PrintMem(ARKodeMem ark_mem, FILE* outfile);
+int rowStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                           long int* rhs_evals);
+int rowStep_GetNumLinSolvSetups(ARKodeMem ark_mem, long int* nlinsetups);
+int rowStep_GetCurrentGamma(ARKodeMem ark_mem, sunrealtype* gamma);
+int rowStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele);
+
+/* Internal utility routines */
+int rowStep_AccessARKODEStepMem(void* arkode_mem, const char* fname,
+                                ARKodeMem* ark_mem, ARKodeROWStepMem* step_mem);
+int rowStep_AccessStepMem(ARKodeMem ark_mem, const char* fname,
+                          ARKodeROWStepMem* step_mem);
+sunbooleantype rowStep_CheckNVector(N_Vector tmpl);
+int rowStep_LoadTables(ARKODE_ROWTableID rtable, ARKodeButcherTable* A,
+                       ARKodeButcherTable* G, sunbooleantype* wmethod);
+void rowStep_FreeTables(ARKodeMem ark_mem);
+int rowStep_SetTables(ARKodeMem ark_mem);
+int rowStep_CheckTables(ARKodeMem ark_mem);
+int rowStep_SetCoefficients(ARKodeMem ark_mem);
+int rowStep_ComputeFdt(ARKodeMem ark_mem);
+int rowStep_ComputeSolutions(ARKodeMem ark_mem, sunrealtype* dsm);
+
+/*===============================================================
+  Reusable ROWStep Error Messages
+  ===============================================================*/
+
+/* Initialization and I/O error messages */
+#define MSG_ROWSTEP_NO_MEM "Time step module memory is NULL."
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
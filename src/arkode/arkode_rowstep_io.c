@@ -0,0 +1,537 @@
+/*---------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *---------------------------------------------------------------
+ * This is the implementation file for the optional input and
+ * output functions for the ARKODE ROWStep time stepper module.
+ *--------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_types.h>
+
+#include "arkode_rowstep_impl.h"
+
+/*===============================================================
+  Exported optional input functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  ROWStepSetTables:
+
+  Specifies to use a customized Rosenbrock method.  The table A
+  holds the coefficients alpha_ij (strictly lower triangular),
+  the stage times c, the weights b and the embedding weights d,
+  while the A array of the table G holds the lower triangular
+  coefficients gamma_ij with a constant diagonal.  All other
+  fields of G are ignored.  The flag wmethod indicates if the
+  method retains its order with an approximate Jacobian, in
+  which case Jacobian information is reused across steps.
+
+  If A->d==NULL, then the method is automatically flagged as a
+  fixed-step method; a user MUST also call either
+  ARKodeSetFixedStep or ARKodeSetInitStep to set the desired
+  time step size.
+  ---------------------------------------------------------------*/
+int ROWStepSetTables(void* arkode_mem, ARKodeButcherTable A,
+                     ARKodeButcherTable G, sunbooleantype wmethod)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  sunindextype Blrw, Bliw;
+  int retval;
+
+  /* access ARKodeMem and ARKodeROWStepMem structures */
+  retval = rowStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* check for legal inputs */
+  if (A == NULL || G == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+
+  /* clear any existing parameters and tables */
+  rowStep_FreeTables(ark_mem);
+  step_mem->q = 0;
+
+  /* copy the tables into step memory */
+  step_mem->A = ARKodeButcherTable_Copy(A);
+  step_mem->G = ARKodeButcherTable_Copy(G);
+  if (step_mem->A == NULL || step_mem->G == NULL)
+  {
+    ARKodeButcherTable_Free(step_mem->A);
+    ARKodeButcherTable_Free(step_mem->G);
+    step_mem->A = step_mem->G = NULL;
+    arkProcessError(ark_mem, ARK_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_NO_MEM);
+    return (ARK_MEM_NULL);
+  }
+
+  ARKodeButcherTable_Space(step_mem->A, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+  ARKodeButcherTable_Space(step_mem->G, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+
+  /* set the relevant parameters */
+  step_mem->stages  = A->stages;
+  step_mem->q       = A->q;
+  step_mem->p       = A->p;
+  step_mem->wmethod = wmethod;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ROWStepSetTableNum:
+
+  Specifies to use a built-in Rosenbrock method, based on the
+  integer flag passed to rowStep_LoadTables().
+  ---------------------------------------------------------------*/
+int ROWStepSetTableNum(void* arkode_mem, ARKODE_ROWTableID rtable)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  sunindextype Blrw, Bliw;
+  int retval;
+
+  /* access ARKodeMem and ARKodeROWStepMem structures */
+  retval = rowStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* check that argument specifies a Rosenbrock method */
+  if (rtable < ARKODE_MIN_ROW_NUM || rtable > ARKODE_MAX_ROW_NUM)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Illegal Rosenbrock table number");
+    return (ARK_ILL_INPUT);
+  }
+
+  /* clear any existing parameters and tables */
+  rowStep_FreeTables(ark_mem);
+  step_mem->q = 0;
+
+  /* fill in tables based on argument */
+  retval = rowStep_LoadTables(rtable, &step_mem->A, &step_mem->G,
+                              &step_mem->wmethod);
+  if (retval != ARK_SUCCESS)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Error setting table with that index");
+    return (ARK_ILL_INPUT);
+  }
+
+  ARKodeButcherTable_Space(step_mem->A, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+  ARKodeButcherTable_Space(step_mem->G, &Bliw, &Blrw);
+  ark_mem->liw += Bliw;
+  ark_mem->lrw += Blrw;
+
+  step_mem->stages = step_mem->A->stages;
+  step_mem->q      = step_mem->A->q;
+  step_mem->p      = step_mem->A->p;
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Exported optional output functions.
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  ROWStepGetCurrentTables:
+
+  Sets pointers to the Rosenbrock tables currently in use.
+  ---------------------------------------------------------------*/
+int ROWStepGetCurrentTables(void* arkode_mem, ARKodeButcherTable* A,
+                            ARKodeButcherTable* G)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeROWStepMem structures */
+  retval = rowStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* get tables from step_mem */
+  *A = step_mem->A;
+  *G = step_mem->G;
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  ROWStepGetIsWMethod:
+
+  Indicates if the current method is a W-method, i.e., if
+  Jacobian information is reused across time steps.
+  ---------------------------------------------------------------*/
+int ROWStepGetIsWMethod(void* arkode_mem, sunbooleantype* wmethod)
+{
+  ARKodeMem ark_mem;
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeMem and ARKodeROWStepMem structures */
+  retval = rowStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  *wmethod = step_mem->wmethod;
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  Private functions attached to ARKODE
+  ===============================================================*/
+
+/*---------------------------------------------------------------
+  rowStep_SetDefaults:
+
+  Resets all ROWStep optional inputs to their default values.
+  Does not change problem-defining function pointers or
+  user_data pointer.  Also leaves alone any data
+  structures/options related to the ARKODE infrastructure itself
+  (e.g., root-finding and post-process step).
+  ---------------------------------------------------------------*/
+int rowStep_SetDefaults(ARKodeMem ark_mem)
+{
+  ARKodeROWStepMem step_mem;
+  long int lenrw, leniw;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* Remove pre-existing tables */
+  rowStep_FreeTables(ark_mem);
+
+  /* Set default values for integrator optional inputs */
+  step_mem->q          = ROW_Q_DEFAULT; /* method order */
+  step_mem->p          = 0;             /* embedding order */
+  step_mem->stages     = 0;             /* no stages */
+  step_mem->wmethod    = SUNFALSE;      /* set with the tables */
+  step_mem->autonomous = SUNFALSE;      /* non-autonomous problem */
+  step_mem->msbp       = ROW_MSBP;      /* max steps between updates to J or P */
+  step_mem->jcur       = SUNFALSE;
+  step_mem->gamrat     = ONE;
+
+  /* Remove pre-existing SUNAdaptController object, and replace with "PID" */
+  if (ark_mem->hadapt_mem->owncontroller)
+  {
+    retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                      &leniw);
+    if (retval == SUN_SUCCESS)
+    {
+      ark_mem->liw -= leniw;
+      ark_mem->lrw -= lenrw;
+    }
+    retval = SUNAdaptController_Destroy(ark_mem->hadapt_mem->hcontroller);
+    ark_mem->hadapt_mem->owncontroller = SUNFALSE;
+    if (retval != SUN_SUCCESS)
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      "SUNAdaptController_Destroy failure");
+      return (ARK_MEM_FAIL);
+    }
+  }
+  ark_mem->hadapt_mem->hcontroller = SUNAdaptController_PID(ark_mem->sunctx);
+  if (ark_mem->hadapt_mem->hcontroller == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    "SUNAdaptController_PID allocation failure");
+    return (ARK_MEM_FAIL);
+  }
+  ark_mem->hadapt_mem->owncontroller = SUNTRUE;
+  retval = SUNAdaptController_Space(ark_mem->hadapt_mem->hcontroller, &lenrw,
+                                    &leniw);
+  if (retval == SUN_SUCCESS)
+  {
+    ark_mem->liw += leniw;
+    ark_mem->lrw += lenrw;
+  }
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_SetOrder:
+
+  Specifies the method order
+  ---------------------------------------------------------------*/
+int rowStep_SetOrder(ARKodeMem ark_mem, int ord)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* clear tables, since user is requesting a change in method
+     or a reset to defaults.  Tables will be set in ARKInitialSetup. */
+  rowStep_FreeTables(ark_mem);
+
+  /* set user-provided value, or default, depending on argument */
+  if (ord <= 0) { step_mem->q = ROW_Q_DEFAULT; }
+  else { step_mem->q = ord; }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_SetAutonomous:
+
+  Indicates if the problem is autonomous (True) or non-autonomous
+  (False).  For autonomous problems the time derivative of f is
+  not computed.
+  ---------------------------------------------------------------*/
+int rowStep_SetAutonomous(ARKodeMem ark_mem, sunbooleantype autonomous)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  step_mem->autonomous  = autonomous;
+  step_mem->fdt_current = SUNFALSE;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_SetLSetupFrequency:
+
+  Specifies the user-provided linear setup decision constant
+  msbp.  Positive values give the maximum number of steps
+  between calls to lsetup; negative values imply recomputation
+  of lsetup at each step; a zero value implies a reset to the
+  default.  The linear system is always set up again when the
+  step size changes.
+  ---------------------------------------------------------------*/
+int rowStep_SetLSetupFrequency(ARKodeMem ark_mem, int msbp)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* if argument legal set it, otherwise set default */
+  if (msbp == 0) { step_mem->msbp = ROW_MSBP; }
+  else { step_mem->msbp = msbp; }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetNumRhsEvals:
+
+  Returns the current number of RHS calls
+  ---------------------------------------------------------------*/
+int rowStep_GetNumRhsEvals(ARKodeMem ark_mem, int partition_index,
+                           long int* rhs_evals)
+{
+  ARKodeROWStepMem step_mem = NULL;
+
+  /* access ARKodeROWStepMem structure */
+  int retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  if (rhs_evals == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "rhs_evals is NULL");
+    return ARK_ILL_INPUT;
+  }
+
+  if (partition_index > 0)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid partition index");
+    return ARK_ILL_INPUT;
+  }
+
+  *rhs_evals = step_mem->nfe;
+
+  return ARK_SUCCESS;
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetNumLinSolvSetups:
+
+  Returns the current number of calls to the lsetup routine
+  ---------------------------------------------------------------*/
+int rowStep_GetNumLinSolvSetups(ARKodeMem ark_mem, long int* nlinsetups)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* get value from step_mem */
+  *nlinsetups = step_mem->nsetups;
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetCurrentGamma: Returns the current value of gamma
+  ---------------------------------------------------------------*/
+int rowStep_GetCurrentGamma(ARKodeMem ark_mem, sunrealtype* gamma)
+{
+  int retval;
+  ARKodeROWStepMem step_mem;
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+  *gamma = step_mem->gamma;
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  rowStep_GetEstLocalErrors: Returns the current local truncation
+  error estimate vector
+  ---------------------------------------------------------------*/
+int rowStep_GetEstLocalErrors(ARKodeMem ark_mem, N_Vector ele)
+{
+  int retval;
+  ARKodeROWStepMem step_mem;
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* return an error if local truncation error is not computed */
+  if ((ark_mem->fixedstep && (ark_mem->AccumErrorType == ARK_ACCUMERROR_NONE)) ||
+      (step_mem->p <= 0))
+  {
+    return (ARK_STEPPER_UNSUPPORTED);
+  }
+
+  /* otherwise, copy local truncation error vector to output */
+  N_VScale(ONE, ark_mem->tempv1, ele);
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_PrintAllStats:
+
+  Prints integrator statistics
+  ---------------------------------------------------------------*/
+int rowStep_PrintAllStats(ARKodeMem ark_mem, FILE* outfile, SUNOutputFormat fmt)
+{
+  ARKodeROWStepMem step_mem;
+  ARKLsMem arkls_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  switch (fmt)
+  {
+  case SUN_OUTPUTFORMAT_TABLE:
+    /* function evaluations */
+    fprintf(outfile, "RHS fn evals                 = %ld\n", step_mem->nfe);
+
+    /* linear solver stats */
+    fprintf(outfile, "LS setups                    = %ld\n", step_mem->nsetups);
+    if (ark_mem->step_getlinmem(ark_mem))
+    {
+      arkls_mem = (ARKLsMem)(ark_mem->step_getlinmem(ark_mem));
+      fprintf(outfile, "Jac fn evals                 = %ld\n", arkls_mem->nje);
+      fprintf(outfile, "LS RHS fn evals              = %ld\n", arkls_mem->nfeDQ);
+      fprintf(outfile, "Prec setup evals             = %ld\n", arkls_mem->npe);
+      fprintf(outfile, "Prec solves                  = %ld\n", arkls_mem->nps);
+      fprintf(outfile, "LS iters                     = %ld\n", arkls_mem->nli);
+      fprintf(outfile, "LS fails                     = %ld\n", arkls_mem->ncfl);
+      fprintf(outfile, "Jac-times setups             = %ld\n",
+              arkls_mem->njtsetup);
+      fprintf(outfile, "Jac-times evals              = %ld\n",
+              arkls_mem->njtimes);
+      if (ark_mem->nst > 0)
+      {
+        fprintf(outfile, "Jac evals per step           = %" RSYM "\n",
+                (sunrealtype)arkls_mem->nje / (sunrealtype)ark_mem->nst);
+      }
+    }
+    break;
+
+  case SUN_OUTPUTFORMAT_CSV:
+    /* function evaluations */
+    fprintf(outfile, ",RHS fn evals,%ld", step_mem->nfe);
+
+    /* linear solver stats */
+    fprintf(outfile, ",LS setups,%ld", step_mem->nsetups);
+    if (ark_mem->step_getlinmem(ark_mem))
+    {
+      arkls_mem = (ARKLsMem)(ark_mem->step_getlinmem(ark_mem));
+      fprintf(outfile, ",Jac fn evals,%ld", arkls_mem->nje);
+      fprintf(outfile, ",LS RHS fn evals,%ld", arkls_mem->nfeDQ);
+      fprintf(outfile, ",Prec setup evals,%ld", arkls_mem->npe);
+      fprintf(outfile, ",Prec solves,%ld", arkls_mem->nps);
+      fprintf(outfile, ",LS iters,%ld", arkls_mem->nli);
+      fprintf(outfile, ",LS fails,%ld", arkls_mem->ncfl);
+      fprintf(outfile, ",Jac-times setups,%ld", arkls_mem->njtsetup);
+      fprintf(outfile, ",Jac-times evals,%ld", arkls_mem->njtimes);
+      if (ark_mem->nst > 0)
+      {
+        fprintf(outfile, ",Jac evals per step,%" RSYM,
+                (sunrealtype)arkls_mem->nje / (sunrealtype)ark_mem->nst);
+      }
+      else { fprintf(outfile, ",Jac evals per step,0"); }
+    }
+    fprintf(outfile, "\n");
+    break;
+
+  default:
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "Invalid formatting option.");
+    return (ARK_ILL_INPUT);
+  }
+
+  return (ARK_SUCCESS);
+}
+
+/*---------------------------------------------------------------
+  rowStep_WriteParameters:
+
+  Outputs all solver parameters to the provided file pointer.
+  ---------------------------------------------------------------*/
+int rowStep_WriteParameters(ARKodeMem ark_mem, FILE* fp)
+{
+  ARKodeROWStepMem step_mem;
+  int retval;
+
+  /* access ARKodeROWStepMem structure */
+  retval = rowStep_AccessStepMem(ark_mem, __func__, &step_mem);
+  if (retval != ARK_SUCCESS) { return (retval); }
+
+  /* print integrator parameters to file */
+  fprintf(fp, "ROWStep time step module parameters:\n");
+  fprintf(fp, "  Method order %i\n", step_mem->q);
+  fprintf(fp, "  W-method %i\n", step_mem->wmethod);
+  fprintf(fp, "  Linear solver setup frequency %i\n", step_mem->msbp);
+  fprintf(fp, "\n");
+
+  return (ARK_SUCCESS);
+}
+
+/*===============================================================
+  EOF
+  ===============================================================*/
@@ -20,6 +20,10 @@
 #include "arkode_impl.h"
 #include "arkode_splittingstep_impl.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /*------------------------------------------------------------------------------
   Shortcut routine to unpack step_mem structure from ark_mem. If missing it
   returns ARK_MEM_NULL.
@@ -135,6 +139,15 @@ static int splittingStep_Init(ARKodeMem ark_mem,
     }
   }
 
+  /* the states for concurrent sequential methods are recreated at the next
+     step with the new vector size */
+  if (init_type == RESIZE_INIT)
+  {
+    arkFreeVecArray(step_mem->nstates, &step_mem->states, ark_mem->lrw1,
+                    &ark_mem->lrw, ark_mem->liw1, &ark_mem->liw);
+    step_mem->nstates = 0;
+  }
+
   /* immediately return if resize or reset */
   if (init_type == RESIZE_INIT || init_type == RESET_INIT)
   {
@@ -204,17 +217,19 @@ static int splittingStep_FullRHS(ARKodeMem ark_mem, sunrealtype t, N_Vector y,
 }
 
 /*------------------------------------------------------------------------------
-  This routine performs a sequential operator splitting method
+  This routine performs a sequential operator splitting method with the given
+  steppers for the partitions. The stages and partitions are only logged if
+  logging is true, as the logger is not thread safe.
   ----------------------------------------------------------------------------*/
-static int splittingStep_SequentialMethod(ARKodeMem ark_mem,
-                                          ARKodeSplittingStepMem step_mem,
-                                          int i, N_Vector y)
+static int splittingStep_SequentialMethod(
+  ARKodeMem ark_mem, ARKodeSplittingStepMem step_mem, int i, N_Vector y,
+  SUNStepper* steppers, SUNDIALS_MAYBE_UNUSED sunbooleantype logging)
 {
   SplittingStepCoefficients coefficients = step_mem->coefficients;
 
   for (int j = 0; j < coefficients->stages; j++)
   {
-    SUNLogInfo(ARK_LOGGER, "begin-stage", "stage = %i", j);
+    SUNLogInfoIf(logging, ARK_LOGGER, "begin-stage", "stage = %i", j);
 
     for (int k = 0; k < coefficients->partitions; k++)
     {
@@ -226,11 +241,11 @@ static int splittingStep_SequentialMethod(ARKodeMem ark_mem,
       sunrealtype t_start = ark_mem->tn + beta_start * ark_mem->h;
       sunrealtype t_end   = ark_mem->tn + beta_end * ark_mem->h;
 
-      SUNLogInfo(ARK_LOGGER, "begin-partition",
-                 "partition = %i, t_start = %" RSYM ", t_end = %" RSYM, k,
-                 t_start, t_end);
+      SUNLogInfoIf(logging, ARK_LOGGER, "begin-partition",
+                   "partition = %i, t_start = %" RSYM ", t_end = %" RSYM, k,
+                   t_start, t_end);
 
-      SUNStepper stepper = step_mem->steppers[k];
+      SUNStepper stepper = steppers[k];
       /* TODO(SBR): A potential future optimization is removing this reset and
        * a call to SUNStepper_SetStopTime later for methods that start a step
        * evolving the same partition the last step ended with (essentially a
@@ -239,54 +254,140 @@ static int splittingStep_SequentialMethod(ARKodeMem ark_mem,
       SUNErrCode err = SUNStepper_Reset(stepper, t_start, y);
       if (err != SUN_SUCCESS)
       {
-        SUNLogInfo(ARK_LOGGER, "end-partition",
-                   "status = failed stepper reset, err = %i", err);
-        SUNLogInfo(ARK_LOGGER, "end-stage",
-                   "status = failed partition, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-partition",
+                     "status = failed stepper reset, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-stage",
+                     "status = failed partition, err = %i", err);
         return ARK_SUNSTEPPER_ERR;
       }
 
       err = SUNStepper_SetStepDirection(stepper, t_end - t_start);
       if (err != SUN_SUCCESS)
       {
-        SUNLogInfo(ARK_LOGGER, "end-partition",
-                   "status = failed set direction, err = %i", err);
-        SUNLogInfo(ARK_LOGGER, "end-stage",
-                   "status = failed partition, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-partition",
+                     "status = failed set direction, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-stage",
+                     "status = failed partition, err = %i", err);
         return ARK_SUNSTEPPER_ERR;
       }
 
       err = SUNStepper_SetStopTime(stepper, t_end);
       if (err != SUN_SUCCESS)
       {
-        SUNLogInfo(ARK_LOGGER, "end-partition",
-                   "status = failed set stop time, err = %i", err);
-        SUNLogInfo(ARK_LOGGER, "end-stage",
-                   "status = failed partition, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-partition",
+                     "status = failed set stop time, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-stage",
+                     "status = failed partition, err = %i", err);
         return ARK_SUNSTEPPER_ERR;
       }
 
       sunrealtype tret = ZERO;
       err              = SUNStepper_Evolve(stepper, t_end, y, &tret);
-      SUNLogExtraDebugVec(ARK_LOGGER, "partition state", y, "y_par(:) =");
+      SUNLogExtraDebugVecIf(logging, ARK_LOGGER, "partition state", y,
+                            "y_par(:) =");
       if (err != SUN_SUCCESS)
       {
-        SUNLogInfo(ARK_LOGGER, "end-partition",
-                   "status = failed evolve, err = %i", err);
-        SUNLogInfo(ARK_LOGGER, "end-stage",
-                   "status = failed partition, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-partition",
+                     "status = failed evolve, err = %i", err);
+        SUNLogInfoIf(logging, ARK_LOGGER, "end-stage",
+                     "status = failed partition, err = %i", err);
         return ARK_SUNSTEPPER_ERR;
       }
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#pragma omp atomic
+#endif
       step_mem->n_stepper_evolves[k]++;
 
-      SUNLogInfo(ARK_LOGGER, "end-partition", "status = success");
+      SUNLogInfoIf(logging, ARK_LOGGER, "end-partition", "status = success");
     }
-    SUNLogInfo(ARK_LOGGER, "end-stage", "status = success");
+    SUNLogInfoIf(logging, ARK_LOGGER, "end-stage", "status = success");
   }
 
   return ARK_SUCCESS;
 }
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+/*------------------------------------------------------------------------------
+  This routine performs the independent sequential methods of a step
+  concurrently. Each method starts from a copy of yn in its own state vector
+  and uses the steppers of the executing thread. The results are combined with
+  a single linear combination.
+  ----------------------------------------------------------------------------*/
+static int splittingStep_ConcurrentMethods(ARKodeMem ark_mem,
+                                           ARKodeSplittingStepMem step_mem)
+{
+  SplittingStepCoefficients coefficients = step_mem->coefficients;
+  int nmethods                           = coefficients->sequential_methods;
+  int retval                             = ARK_SUCCESS;
+
+  /* (re)allocate the states if the number of methods increased */
+  if (step_mem->nstates < nmethods)
+  {
+    arkFreeVecArray(step_mem->nstates, &step_mem->states, ark_mem->lrw1,
+                    &ark_mem->lrw, ark_mem->liw1, &ark_mem->liw);
+    step_mem->nstates = 0;
+    if (!arkAllocVecArray(nmethods, ark_mem->yn, &step_mem->states,
+                          ark_mem->lrw1, &ark_mem->lrw, ark_mem->liw1,
+                          &ark_mem->liw))
+    {
+      arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_ARK_MEM_FAIL);
+      return ARK_MEM_FAIL;
+    }
+    step_mem->nstates = nmethods;
+  }
+
+  SUNLogInfo(ARK_LOGGER, "begin-sequential-methods",
+             "sequential methods = %i, threads = %i", nmethods,
+             step_mem->nthreads);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(step_mem->nthreads)
+  for (int i = 0; i < nmethods; i++)
+  {
+    SUNStepper* steppers = step_mem->thread_steppers +
+                           omp_get_thread_num() * step_mem->partitions;
+
+    N_VScale(ONE, ark_mem->yn, step_mem->states[i]);
+    int ret = splittingStep_SequentialMethod(ark_mem, step_mem, i,
+                                             step_mem->states[i], steppers,
+                                             SUNFALSE);
+    if (ret != ARK_SUCCESS)
+    {
+#pragma omp atomic write
+      retval = ret;
+    }
+  }
+
+  if (retval != ARK_SUCCESS)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-sequential-methods",
+               "status = failed sequential method, retval = %i", retval);
+    return retval;
+  }
+
+  /* the partitions are not logged by the threads, log the method results */
+  for (int i = 0; i < nmethods; i++)
+  {
+    SUNLogExtraDebugVec(ARK_LOGGER, "sequential state", step_mem->states[i],
+                        "sequential method = %i, y_seq(:) =", i);
+  }
+
+  retval = N_VLinearCombination(nmethods, coefficients->alpha,
+                                step_mem->states, ark_mem->ycur);
+  if (retval != 0)
+  {
+    SUNLogInfo(ARK_LOGGER, "end-sequential-methods",
+               "status = failed vector operation, retval = %i", retval);
+    return ARK_VECTOROP_ERR;
+  }
+
+  SUNLogExtraDebugVec(ARK_LOGGER, "current state", ark_mem->ycur, "y_cur(:) =");
+  SUNLogInfo(ARK_LOGGER, "end-sequential-methods", "status = success");
+
+  return ARK_SUCCESS;
+}
+#endif
+
 /*------------------------------------------------------------------------------
   This routine performs a single step of the splitting method.
   ----------------------------------------------------------------------------*/
@@ -302,10 +403,18 @@ static int splittingStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr,
 
   SplittingStepCoefficients coefficients = step_mem->coefficients;
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (step_mem->nthreads > 1 && coefficients->sequential_methods > 1)
+  {
+    return splittingStep_ConcurrentMethods(ark_mem, step_mem);
+  }
+#endif
+
   SUNLogInfo(ARK_LOGGER, "begin-sequential-method", "sequential method = 0");
 
   N_VScale(ONE, ark_mem->yn, ark_mem->ycur);
-  retval = splittingStep_SequentialMethod(ark_mem, step_mem, 0, ark_mem->ycur);
+  retval = splittingStep_SequentialMethod(ark_mem, step_mem, 0, ark_mem->ycur,
+                                          step_mem->steppers, SUNTRUE);
   SUNLogExtraDebugVec(ARK_LOGGER, "sequential state", ark_mem->ycur,
                       "y_seq(:) =");
   if (retval != ARK_SUCCESS)
@@ -329,7 +438,8 @@ static int splittingStep_TakeStep(ARKodeMem ark_mem, sunrealtype* dsmPtr,
 
     N_VScale(ONE, ark_mem->yn, ark_mem->tempv1);
     retval = splittingStep_SequentialMethod(ark_mem, step_mem, i,
-                                            ark_mem->tempv1);
+                                            ark_mem->tempv1, step_mem->steppers,
+                                            SUNTRUE);
     SUNLogExtraDebugVec(ARK_LOGGER, "sequential state", ark_mem->tempv1,
                         "y_seq(:) =");
     if (retval != ARK_SUCCESS)
@@ -395,8 +505,9 @@ static int splittingStep_WriteParameters(ARKodeMem ark_mem, FILE* fp)
   int retval = splittingStep_AccessStepMem(ark_mem, __func__, &step_mem);
   if (retval != ARK_SUCCESS) { return retval; }
 
-  fprintf(fp, "SplittingStep time step module parameters:\n  Method order %i\n\n",
+  fprintf(fp, "SplittingStep time step module parameters:\n  Method order %i\n",
           step_mem->order);
+  fprintf(fp, "  Number of threads %i\n\n", step_mem->nthreads);
 
   return ARK_SUCCESS;
 }
@@ -414,6 +525,9 @@ static void splittingStep_Free(ARKodeMem ark_mem)
     {
       free(step_mem->n_stepper_evolves);
     }
+    if (step_mem->thread_steppers != NULL) { free(step_mem->thread_steppers); }
+    arkFreeVecArray(step_mem->nstates, &step_mem->states, ark_mem->lrw1,
+                    &ark_mem->lrw, ark_mem->liw1, &ark_mem->liw);
     SplittingStepCoefficients_Destroy(&step_mem->coefficients);
     free(step_mem);
   }
@@ -433,6 +547,7 @@ static void splittingStep_PrintMem(ARKodeMem ark_mem, FILE* outfile)
   /* output integer quantities */
   fprintf(outfile, "SplittingStep: partitions = %i\n", step_mem->partitions);
   fprintf(outfile, "SplittingStep: order = %i\n", step_mem->order);
+  fprintf(outfile, "SplittingStep: nthreads = %i\n", step_mem->nthreads);
 
   /* output long integer quantities */
   for (int k = 0; k < step_mem->partitions; k++)
@@ -579,10 +694,18 @@ static int splittingStep_InitStepMem(ARKodeMem ark_mem,
 
   /* If the number of partitions changed, the coefficients are no longer
    * compatible and must be cleared. If a user previously called ARKodeSetOrder
-   * that will still be respected at the next call to ARKodeEvolve */
+   * that will still be respected at the next call to ARKodeEvolve. The same
+   * holds for the steppers of the threads, the methods are run serially until
+   * SplittingStepSetNumThreads is called again. */
   if (step_mem->partitions != partitions)
   {
     SplittingStepCoefficients_Destroy(&step_mem->coefficients);
+    if (step_mem->thread_steppers != NULL)
+    {
+      free(step_mem->thread_steppers);
+      step_mem->thread_steppers = NULL;
+    }
+    step_mem->nthreads = 1;
   }
   step_mem->partitions = partitions;
 
@@ -629,6 +752,10 @@ void* SplittingStepCreate(SUNStepper* steppers, int partitions, sunrealtype t0,
   step_mem->steppers          = NULL;
   step_mem->n_stepper_evolves = NULL;
   step_mem->coefficients      = NULL;
+  step_mem->nthreads          = 1;
+  step_mem->thread_steppers   = NULL;
+  step_mem->states            = NULL;
+  step_mem->nstates           = 0;
   retval = splittingStep_InitStepMem(ark_mem, step_mem, steppers, partitions);
   if (retval != ARK_SUCCESS)
   {
@@ -755,6 +882,80 @@ int SplittingStepSetCoefficients(void* arkode_mem,
   return ARK_SUCCESS;
 }
 
+/*------------------------------------------------------------------------------
+  Sets the number of threads to run the sequential methods of a step
+  concurrently. Each thread needs its own steppers for all partitions, thread i
+  uses steppers[i * partitions + k] for partition k. A value of one or less
+  runs the methods serially with the steppers given at creation.
+  ----------------------------------------------------------------------------*/
+int SplittingStepSetNumThreads(void* arkode_mem, int nthreads,
+                               SUNStepper* steppers)
+{
+  ARKodeMem ark_mem               = NULL;
+  ARKodeSplittingStepMem step_mem = NULL;
+  int retval = splittingStep_AccessARKODEStepMem(arkode_mem, __func__, &ark_mem,
+                                                 &step_mem);
+  if (retval != ARK_SUCCESS) { return retval; }
+
+  if (nthreads <= 1)
+  {
+    if (step_mem->thread_steppers != NULL)
+    {
+      free(step_mem->thread_steppers);
+      step_mem->thread_steppers = NULL;
+    }
+    step_mem->nthreads = 1;
+    return ARK_SUCCESS;
+  }
+
+#if !defined(SUNDIALS_OPENMP_ENABLED)
+  arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                  "SUNDIALS was not built with OpenMP enabled");
+  return ARK_ILL_INPUT;
+#else
+  if (steppers == NULL)
+  {
+    arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "steppers = NULL illegal.");
+    return ARK_ILL_INPUT;
+  }
+
+  int nsteppers = nthreads * step_mem->partitions;
+  for (int i = 0; i < nsteppers; i++)
+  {
+    if (steppers[i] == NULL)
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "steppers[%d] = NULL illegal.", i);
+      return ARK_ILL_INPUT;
+    }
+
+    if (!splittingStep_CheckSUNStepper(steppers[i]))
+    {
+      arkProcessError(ark_mem, ARK_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      "stepper[%d] does not implement the required operations.",
+                      i);
+      return ARK_ILL_INPUT;
+    }
+  }
+
+  SUNStepper* thread_steppers = malloc(nsteppers * sizeof(*steppers));
+  if (thread_steppers == NULL)
+  {
+    arkProcessError(ark_mem, ARK_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_ARK_ARKMEM_FAIL);
+    return ARK_MEM_FAIL;
+  }
+  memcpy(thread_steppers, steppers, nsteppers * sizeof(*steppers));
+
+  if (step_mem->thread_steppers != NULL) { free(step_mem->thread_steppers); }
+  step_mem->thread_steppers = thread_steppers;
+  step_mem->nthreads        = nthreads;
+
+  return ARK_SUCCESS;
+#endif
+}
+
 /*------------------------------------------------------------------------------
   Accesses the number of times a given partition was evolved
   ----------------------------------------------------------------------------*/
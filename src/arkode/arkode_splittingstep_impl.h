@@ -27,6 +27,13 @@ typedef struct ARKodeSplittingStepMemRec
 
   int partitions;
   int order;
+
+  /* concurrent sequential methods, thread i uses the steppers
+     thread_steppers[i * partitions + k] and the methods use the states */
+  int nthreads;
+  SUNStepper* thread_steppers;
+  N_Vector* states;
+  int nstates;
 }* ARKodeSplittingStepMem;
 
 #endif
@@ -19,5 +19,6 @@
 
 typedef struct ARKodeMemRec* ARKodeMem;
 typedef struct ARKodeRelaxMemRec* ARKodeRelaxMem;
+typedef struct ARKodeAdjMemRec* ARKodeAdjMem;
 
 #endif
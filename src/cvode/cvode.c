@@ -29,7 +29,9 @@
 #include <sunnonlinsol/sunnonlinsol_newton.h>
 
 #include "cvode_impl.h"
+#include "cvode_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
+#include "sundials_utils.h"
 
 /*=================================================================*/
 /* CVODE Private Constants                                         */
@@ -185,6 +187,9 @@ static int cvDoErrorTest(CVodeMem cv_mem, int* nflagPtr, sunrealtype saved_t,
 /* Function called after a successful step */
 
 static void cvCompleteStep(CVodeMem cv_mem);
+static void cvLSetupPolicyStep(CVodeMem cv_mem);
+static int cvLmmSwitchStep(CVodeMem cv_mem, sunrealtype dsm);
+static sunrealtype cvLmmLipschitz(CVodeMem cv_mem);
 static void cvPrepareNextStep(CVodeMem cv_mem, sunrealtype dsm);
 static void cvSetEta(CVodeMem cv_mem);
 static sunrealtype cvComputeEtaqm1(CVodeMem cv_mem);
@@ -206,6 +211,19 @@ static int cvRcheck1(CVodeMem cv_mem);
 static int cvRcheck2(CVodeMem cv_mem);
 static int cvRcheck3(CVodeMem cv_mem);
 static int cvRootfind(CVodeMem cv_mem);
+static int cvRootEvalCand(CVodeMem cv_mem, sunrealtype t, sunrealtype* gout);
+static int cvRootfindCand(CVodeMem cv_mem);
+
+/* Scratch vector functions */
+
+static int cvBorrowScratch(CVodeMem cv_mem);
+static void cvReturnScratch(CVodeMem cv_mem);
+
+/* Step trace functions */
+
+static void cvStepTraceCounters(CVodeMem cv_mem, long int counters[]);
+static void cvStepTraceRecord(CVodeMem cv_mem, SUNStepTrace trace,
+                              int kflag, const long int start[]);
 
 /*
  * =================================================================
@@ -264,6 +282,8 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
 
   /* Copy input parameters into cv_mem */
   cv_mem->cv_sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct CVodeMemRec));
   cv_mem->cv_lmm    = lmm;
 
   /* Set uround */
@@ -304,6 +324,7 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
   cv_mem->cv_nlscoef          = CORTES;
   cv_mem->cv_msbp             = MSBP_DEFAULT;
   cv_mem->cv_dgmax_lsetup     = DGMAX_LSETUP_DEFAULT;
+  cv_mem->cv_lsetup_policy    = CV_LSETUP_HEURISTIC;
   cv_mem->convfail            = CV_NO_FAILURES;
   cv_mem->cv_constraints      = NULL;
   cv_mem->cv_constraintsSet   = SUNFALSE;
@@ -320,6 +341,11 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
   cv_mem->cv_gactive = NULL;
   cv_mem->cv_mxgnull = 1;
 
+  cv_mem->cv_rootscalable = SUNFALSE;
+  cv_mem->cv_gsub         = NULL;
+  cv_mem->cv_ncand        = 0;
+  cv_mem->cv_icand        = NULL;
+
   /* Initialize projection variables */
   cv_mem->proj_mem     = NULL;
   cv_mem->proj_enabled = SUNFALSE;
@@ -344,6 +370,13 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
   cv_mem->NLS    = NULL;
   cv_mem->ownNLS = SUNFALSE;
 
+  /* Initialize method switching variables */
+  cv_mem->cv_lmm_switch = SUNFALSE;
+  cv_mem->cv_lmm_start  = lmm;
+  cv_mem->cv_lmm_qmax   = maxord;
+  cv_mem->NLSsw         = NULL;
+  cv_mem->ownNLSsw      = SUNFALSE;
+
   /* Initialize fused operations variable */
   cv_mem->cv_usefused = SUNFALSE;
 
@@ -510,6 +543,24 @@ int CVodeInit(void* cvode_mem, CVRhsFn f, sunrealtype t0, N_Vector y0)
 
   cv_mem->cv_irfnd = 0;
 
+  /* Initialize the setup policy cost model and statistics */
+
+  cv_mem->cv_lsp_setup   = SUNFALSE;
+  cv_mem->cv_lsp_jac     = SUNFALSE;
+  cv_mem->cv_lsp_wsolve  = 0.0;
+  cv_mem->cv_lsp_wstep   = 0.0;
+  cv_mem->cv_lsp_scost   = 0.0;
+  cv_mem->cv_lsp_snls    = 0.0;
+  cv_mem->cv_lsp_jcost   = 0.0;
+  cv_mem->cv_lsp_jeval   = 0.0;
+  cv_mem->cv_lsp_stime   = ZERO;
+  cv_mem->cv_lsp_jtime   = ZERO;
+  cv_mem->cv_lsp_nsetups = 0;
+  cv_mem->cv_lsp_njevals = 0;
+  cv_mem->cv_lsp_tjac    = 0.0;
+  cv_mem->cv_lsp_tsetup  = 0.0;
+  cv_mem->cv_lsp_tnls    = 0.0;
+
   /* Initialize other integrator optional outputs */
 
   cv_mem->cv_h0u    = ZERO;
@@ -620,6 +671,42 @@ int CVodeReInit(void* cvode_mem, sunrealtype t0, N_Vector y0)
 
   cv_mem->cv_irfnd = 0;
 
+  /* Initialize the setup policy cost model and statistics */
+
+  cv_mem->cv_lsp_setup   = SUNFALSE;
+  cv_mem->cv_lsp_jac     = SUNFALSE;
+  cv_mem->cv_lsp_wsolve  = 0.0;
+  cv_mem->cv_lsp_wstep   = 0.0;
+  cv_mem->cv_lsp_scost   = 0.0;
+  cv_mem->cv_lsp_snls    = 0.0;
+  cv_mem->cv_lsp_jcost   = 0.0;
+  cv_mem->cv_lsp_jeval   = 0.0;
+  cv_mem->cv_lsp_stime   = ZERO;
+  cv_mem->cv_lsp_jtime   = ZERO;
+  cv_mem->cv_lsp_nsetups = 0;
+  cv_mem->cv_lsp_njevals = 0;
+  cv_mem->cv_lsp_tjac    = 0.0;
+  cv_mem->cv_lsp_tsetup  = 0.0;
+  cv_mem->cv_lsp_tnls    = 0.0;
+
+  /* Restart method switching with the method selected at creation */
+
+  if (cv_mem->cv_lmm_switch)
+  {
+    if (cvNlsSwitchMethod(cv_mem, cv_mem->cv_lmm_start) != CV_SUCCESS)
+    {
+      cvProcessError(cv_mem, CV_NLS_INIT_FAIL, __LINE__, __func__, __FILE__,
+                     MSGCV_NLS_INIT_FAIL);
+      SUNDIALS_MARK_FUNCTION_END(CV_PROFILER);
+      return (CV_NLS_INIT_FAIL);
+    }
+    cv_mem->cv_lmm_lip     = ZERO;
+    cv_mem->cv_lmm_nstsw   = 0;
+    cv_mem->cv_lmm_nswitch = 0;
+    cv_mem->cv_lmm_nst[0] = cv_mem->cv_lmm_nst[1] = 0;
+    cv_mem->cv_lmm_time[0] = cv_mem->cv_lmm_time[1] = ZERO;
+  }
+
   /* Initialize other integrator optional outputs */
 
   cv_mem->cv_h0u    = ZERO;
@@ -843,9 +930,11 @@ int CVodeRootInit(void* cvode_mem, int nrtfn, CVRootFn g)
     cv_mem->cv_rootdir = NULL;
     free(cv_mem->cv_gactive);
     cv_mem->cv_gactive = NULL;
+    free(cv_mem->cv_icand);
+    cv_mem->cv_icand = NULL;
 
     cv_mem->cv_lrw -= 3 * (cv_mem->cv_nrtfn);
-    cv_mem->cv_liw -= 3 * (cv_mem->cv_nrtfn);
+    cv_mem->cv_liw -= 4 * (cv_mem->cv_nrtfn);
   }
 
   /* If CVodeRootInit() was called with nrtfn == 0, then set cv_nrtfn to
@@ -880,9 +969,11 @@ int CVodeRootInit(void* cvode_mem, int nrtfn, CVRootFn g)
         cv_mem->cv_rootdir = NULL;
         free(cv_mem->cv_gactive);
         cv_mem->cv_gactive = NULL;
+        free(cv_mem->cv_icand);
+        cv_mem->cv_icand = NULL;
 
         cv_mem->cv_lrw -= 3 * nrt;
-        cv_mem->cv_liw -= 3 * nrt;
+        cv_mem->cv_liw -= 4 * nrt;
 
         cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
                        MSGCV_NULL_G);
@@ -992,6 +1083,27 @@ int CVodeRootInit(void* cvode_mem, int nrtfn, CVRootFn g)
     return (CV_MEM_FAIL);
   }
 
+  cv_mem->cv_icand = NULL;
+  cv_mem->cv_icand = (int*)malloc(nrt * sizeof(int));
+  if (cv_mem->cv_icand == NULL)
+  {
+    free(cv_mem->cv_glo);
+    cv_mem->cv_glo = NULL;
+    free(cv_mem->cv_ghi);
+    cv_mem->cv_ghi = NULL;
+    free(cv_mem->cv_grout);
+    cv_mem->cv_grout = NULL;
+    free(cv_mem->cv_iroots);
+    cv_mem->cv_iroots = NULL;
+    free(cv_mem->cv_rootdir);
+    cv_mem->cv_rootdir = NULL;
+    free(cv_mem->cv_gactive);
+    cv_mem->cv_gactive = NULL;
+    cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSGCV_MEM_FAIL);
+    return (CV_MEM_FAIL);
+  }
+
   /* Set default values for rootdir (both directions) */
   for (i = 0; i < nrt; i++) { cv_mem->cv_rootdir[i] = 0; }
 
@@ -999,7 +1111,7 @@ int CVodeRootInit(void* cvode_mem, int nrtfn, CVRootFn g)
   for (i = 0; i < nrt; i++) { cv_mem->cv_gactive[i] = SUNTRUE; }
 
   cv_mem->cv_lrw += 3 * nrt;
-  cv_mem->cv_liw += 3 * nrt;
+  cv_mem->cv_liw += 4 * nrt;
 
   return (CV_SUCCESS);
 }
@@ -1036,6 +1148,8 @@ int CVode(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
   int ewtsetOK;
   sunrealtype troundoff, tout_hin, rh, nrm;
   sunbooleantype inactive_roots;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   /*
    * -------------------------------------
@@ -1465,8 +1579,25 @@ int CVode(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
     }
 
     /* Call cvStep to take a step */
+    trace = CV_STEPTRACE;
+    if (trace) { cvStepTraceCounters(cv_mem, trace_start); }
+
+    if (cv_mem->cv_scratch_vtemp && cvBorrowScratch(cv_mem))
+    {
+      cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                     MSGCV_MEM_FAIL);
+      istate              = CV_MEM_FAIL;
+      cv_mem->cv_tretlast = *tret = cv_mem->cv_tn;
+      N_VScale(ONE, cv_mem->cv_zn[0], yout);
+      break;
+    }
+
     kflag = cvStep(cv_mem);
 
+    if (cv_mem->cv_scratch_vtemp) { cvReturnScratch(cv_mem); }
+
+    if (trace) { cvStepTraceRecord(cv_mem, trace, kflag, trace_start); }
+
     /* Process failed step cases, and exit loop */
     if (kflag != CV_SUCCESS)
     {
@@ -1749,6 +1880,14 @@ void CVodeFree(void** cvode_mem)
     cv_mem->NLS    = NULL;
   }
 
+  /* free the solver of the inactive method when switching methods */
+  if (cv_mem->ownNLSsw)
+  {
+    SUNNonlinSolFree(cv_mem->NLSsw);
+    cv_mem->ownNLSsw = SUNFALSE;
+    cv_mem->NLSsw    = NULL;
+  }
+
   if (cv_mem->cv_lfree != NULL) { cv_mem->cv_lfree(cv_mem); }
 
   if (cv_mem->cv_nrtfn > 0)
@@ -1765,10 +1904,14 @@ void CVodeFree(void** cvode_mem)
     cv_mem->cv_rootdir = NULL;
     free(cv_mem->cv_gactive);
     cv_mem->cv_gactive = NULL;
+    free(cv_mem->cv_icand);
+    cv_mem->cv_icand = NULL;
   }
 
   if (cv_mem->proj_mem) { cvProjFree(&(cv_mem->proj_mem)); }
 
+  sunMemAccountFree(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct CVodeMemRec));
   free(*cvode_mem);
   *cvode_mem = NULL;
 }
@@ -1819,7 +1962,7 @@ static sunbooleantype cvCheckNvector(N_Vector tmpl)
 
 static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
 {
-  int i, j;
+  int i, j, nvecs;
 
   /* Allocate ewt, acor, tempv, ftemp */
 
@@ -1850,8 +1993,11 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
     return (SUNFALSE);
   }
 
-  cv_mem->cv_vtemp1 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp1 == NULL)
+  /* The vtemp vectors are only used within a step and may be borrowed from
+     the SUNContext scratch pool instead */
+  cv_mem->cv_scratch_vtemp = SUNFALSE;
+  if (SUNContext_GetScratchSharing(cv_mem->cv_sunctx,
+                                   &cv_mem->cv_scratch_vtemp))
   {
     N_VDestroy(cv_mem->cv_ftemp);
     N_VDestroy(cv_mem->cv_tempv);
@@ -1860,27 +2006,46 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
     return (SUNFALSE);
   }
 
-  cv_mem->cv_vtemp2 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp2 == NULL)
+  if (cv_mem->cv_scratch_vtemp)
   {
-    N_VDestroy(cv_mem->cv_vtemp1);
-    N_VDestroy(cv_mem->cv_ftemp);
-    N_VDestroy(cv_mem->cv_tempv);
-    N_VDestroy(cv_mem->cv_ewt);
-    N_VDestroy(cv_mem->cv_acor);
-    return (SUNFALSE);
+    cv_mem->cv_vtemp1 = NULL;
+    cv_mem->cv_vtemp2 = NULL;
+    cv_mem->cv_vtemp3 = NULL;
   }
-
-  cv_mem->cv_vtemp3 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp3 == NULL)
+  else
   {
-    N_VDestroy(cv_mem->cv_vtemp2);
-    N_VDestroy(cv_mem->cv_vtemp1);
-    N_VDestroy(cv_mem->cv_ftemp);
-    N_VDestroy(cv_mem->cv_tempv);
-    N_VDestroy(cv_mem->cv_ewt);
-    N_VDestroy(cv_mem->cv_acor);
-    return (SUNFALSE);
+    cv_mem->cv_vtemp1 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp1 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
+
+    cv_mem->cv_vtemp2 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp2 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_vtemp1);
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
+
+    cv_mem->cv_vtemp3 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp3 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_vtemp2);
+      N_VDestroy(cv_mem->cv_vtemp1);
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
   }
 
   /* Allocate zn[0] ... zn[qmax] */
@@ -1903,8 +2068,9 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
   }
 
   /* Update solver workspace lengths  */
-  cv_mem->cv_lrw += (cv_mem->cv_qmax + 8) * cv_mem->cv_lrw1;
-  cv_mem->cv_liw += (cv_mem->cv_qmax + 8) * cv_mem->cv_liw1;
+  nvecs = cv_mem->cv_scratch_vtemp ? cv_mem->cv_qmax + 5 : cv_mem->cv_qmax + 8;
+  cv_mem->cv_lrw += nvecs * cv_mem->cv_lrw1;
+  cv_mem->cv_liw += nvecs * cv_mem->cv_liw1;
 
   /* Store the value of qmax used here */
   cv_mem->cv_qmax_alloc = cv_mem->cv_qmax;
@@ -1920,9 +2086,10 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
 
 static void cvFreeVectors(CVodeMem cv_mem)
 {
-  int j, maxord;
+  int j, maxord, nvecs;
 
   maxord = cv_mem->cv_qmax_alloc;
+  nvecs  = cv_mem->cv_scratch_vtemp ? maxord + 5 : maxord + 8;
 
   N_VDestroy(cv_mem->cv_ewt);
   N_VDestroy(cv_mem->cv_acor);
@@ -1933,8 +2100,8 @@ static void cvFreeVectors(CVodeMem cv_mem)
   N_VDestroy(cv_mem->cv_vtemp3);
   for (j = 0; j <= maxord; j++) { N_VDestroy(cv_mem->cv_zn[j]); }
 
-  cv_mem->cv_lrw -= (maxord + 8) * cv_mem->cv_lrw1;
-  cv_mem->cv_liw -= (maxord + 8) * cv_mem->cv_liw1;
+  cv_mem->cv_lrw -= nvecs * cv_mem->cv_lrw1;
+  cv_mem->cv_liw -= nvecs * cv_mem->cv_liw1;
 
   if (cv_mem->cv_VabstolMallocDone)
   {
@@ -2022,6 +2189,14 @@ static int cvInitialSetup(CVodeMem cv_mem)
     return (CV_ILL_INPUT);
   }
 
+  /* Method switching uses Newton iteration for BDF steps */
+  if (cv_mem->cv_lmm_switch && cv_mem->cv_lsolve == NULL)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "Method switching requires a linear solver");
+    return (CV_ILL_INPUT);
+  }
+
   /* Call linit function (if it exists) */
   if (cv_mem->cv_linit != NULL)
   {
@@ -2415,12 +2590,25 @@ static int cvStep(CVodeMem cv_mem)
 
   cvCompleteStep(cv_mem);
 
+  if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL && cv_mem->cv_lsetup)
+  {
+    cvLSetupPolicyStep(cv_mem);
+  }
+
   cvPrepareNextStep(cv_mem, dsm);
 
+  /* With method switching, consider a change of method */
+
+  if (cv_mem->cv_lmm_switch)
+  {
+    eflag = cvLmmSwitchStep(cv_mem, dsm);
+    if (eflag != CV_SUCCESS) { return (eflag); }
+  }
+
   /* If Stablilty Limit Detection is turned on, call stability limit
      detection routine for possible order reduction. */
 
-  if (cv_mem->cv_sldeton) { cvBDFStab(cv_mem); }
+  if (cv_mem->cv_sldeton && cv_mem->cv_lmm == CV_BDF) { cvBDFStab(cv_mem); }
 
   cv_mem->cv_etamax = (cv_mem->cv_nst <= cv_mem->cv_small_nst)
                         ? cv_mem->cv_eta_max_es
@@ -3015,10 +3203,14 @@ static int cvNls(CVodeMem cv_mem, int nflag)
   sunbooleantype callSetup;
   long int nni_inc = 0;
   long int nnf_inc = 0;
+  double wstart    = 0.0;
+  double wnls;
 
   /* Decide whether or not to call setup routine (if one exists) and */
   /* set flag convfail (input to lsetup for its evaluation decision) */
-  if (cv_mem->cv_lsetup)
+  /* With method switching Adams steps do not use the linear solver   */
+  if (cv_mem->cv_lsetup &&
+      !(cv_mem->cv_lmm_switch && cv_mem->cv_lmm == CV_ADAMS))
   {
     cv_mem->convfail = ((nflag == FIRST_CALL) || (nflag == PREV_ERR_FAIL))
                          ? CV_NO_FAILURES
@@ -3026,8 +3218,30 @@ static int cvNls(CVodeMem cv_mem, int nflag)
 
     callSetup = (nflag == PREV_CONV_FAIL) || (nflag == PREV_ERR_FAIL) ||
                 (cv_mem->cv_nst == 0) ||
-                (cv_mem->cv_nst >= cv_mem->cv_nstlp + cv_mem->cv_msbp) ||
                 (SUNRabs(cv_mem->cv_gamrat - ONE) > cv_mem->cv_dgmax_lsetup);
+
+    if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+    {
+      /* setup requested by the cost model after the last step */
+      if (!callSetup && cv_mem->cv_lsp_setup)
+      {
+        callSetup = SUNTRUE;
+        cv_mem->cv_lsp_nsetups++;
+      }
+    }
+    else
+    {
+      callSetup = callSetup ||
+                  (cv_mem->cv_nst >= cv_mem->cv_nstlp + cv_mem->cv_msbp);
+    }
+
+    /* update the Jacobian at the start of a BDF phase */
+    if (cv_mem->cv_lmm_jbad)
+    {
+      cv_mem->convfail    = CV_FAIL_OTHER;
+      callSetup           = SUNTRUE;
+      cv_mem->cv_lmm_jbad = SUNFALSE;
+    }
   }
   else
   {
@@ -3038,6 +3252,9 @@ static int cvNls(CVodeMem cv_mem, int nflag)
   /* initial guess for the correction to the predictor */
   N_VConst(ZERO, cv_mem->cv_acor);
 
+  /* reset the Lipschitz estimate from the fixed-point iteration */
+  cv_mem->cv_lmm_liptmp = ZERO;
+
   /* call nonlinear solver setup if it exists */
   if ((cv_mem->NLS)->ops->setup)
   {
@@ -3048,10 +3265,30 @@ static int cvNls(CVodeMem cv_mem, int nflag)
 
   SUNLogInfo(CV_LOGGER, "begin-nonlinear-solve", "tol = %.16g", cv_mem->cv_tq[4]);
 
+  /* start timing the solve for the setup policy cost model */
+  if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+  {
+    cv_mem->cv_lsp_wsolve = 0.0;
+    wstart                = sunWallClockTime();
+  }
+
   /* solve the nonlinear system */
   flag = SUNNonlinSolSolve(cv_mem->NLS, cv_mem->cv_zn[0], cv_mem->cv_acor,
                            cv_mem->cv_ewt, cv_mem->cv_tq[4], callSetup, cv_mem);
 
+  /* charge the Newton iterations (the solve time excluding setups) to the
+     current step and to the setup and Jacobian update cycles */
+  if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+  {
+    wnls = sunWallClockTime() - wstart - cv_mem->cv_lsp_wsolve;
+    if (wnls < 0.0) { wnls = 0.0; }
+    cv_mem->cv_lsp_wstep += wnls;
+    cv_mem->cv_lsp_scost += wnls;
+    cv_mem->cv_lsp_snls += wnls;
+    cv_mem->cv_lsp_jcost += wnls;
+    cv_mem->cv_lsp_tnls += wnls;
+  }
+
   /* increment counters */
   (void)SUNNonlinSolGetNumIters(cv_mem->NLS, &nni_inc);
   cv_mem->cv_nni += nni_inc;
@@ -3458,6 +3695,247 @@ static void cvCompleteStep(CVodeMem cv_mem)
               cv_mem->cv_nscon);
 }
 
+/*
+ * cvLSetupPolicyStep
+ *
+ * This routine updates the setup policy cost model after a successful
+ * step. The cost of a setup is amortized over the steps until the next
+ * setup while the cost of the Newton iterations per unit of simulated
+ * time grows as the linear system goes out of date. The average cost
+ * per unit of simulated time since the last setup is minimized by
+ * requesting a new setup as soon as the cost rate of the last step
+ * (including any failed attempts) exceeds this average.
+ */
+
+static void cvLSetupPolicyStep(CVodeMem cv_mem)
+{
+  sunrealtype habs = SUNRabs(cv_mem->cv_hu);
+
+  cv_mem->cv_lsp_stime += habs;
+  cv_mem->cv_lsp_jtime += habs;
+
+  cv_mem->cv_lsp_setup = (cv_mem->cv_lsp_wstep * cv_mem->cv_lsp_stime >
+                          cv_mem->cv_lsp_scost * habs);
+
+  SUNLogDebug(CV_LOGGER, "lsetup-policy",
+              "step rate = %.16g, setup cycle rate = %.16g, setup = %i",
+              cv_mem->cv_lsp_wstep / habs,
+              cv_mem->cv_lsp_scost / cv_mem->cv_lsp_stime,
+              cv_mem->cv_lsp_setup);
+
+  cv_mem->cv_lsp_wstep = 0.0;
+}
+
+/*
+ * cvLmmSwitchStep
+ *
+ * This routine considers a switch between the Adams and BDF methods
+ * after a successful step, following the approach of LSODA. The
+ * step sizes allowed by the local error test for both methods at the
+ * current order are estimated from dsm and the ratio of the methods'
+ * error constants (for Adams orders above BDF_Q_MAX, the BDF error at
+ * order BDF_Q_MAX is estimated from zn[BDF_Q_MAX + 1]). The Adams
+ * step is further limited by the stability of the fixed-point
+ * corrector, |h| L <= sm[q], where L is an estimate of the Lipschitz
+ * constant of f. A switch to BDF is made when BDF allows a step
+ * LMM_RATIO times larger than Adams, and a switch back to Adams is
+ * made when Adams allows a step at least as large as BDF. The
+ * Nordsieck array zn is the same for both methods and is carried over
+ * (truncated to order BDF_Q_MAX if necessary), and the next order
+ * change is deferred until the new method has a full history.
+ */
+
+static int cvLmmSwitchStep(CVodeMem cv_mem, sunrealtype dsm)
+{
+  /* error constants of the Adams-Moulton and BDF methods and the Adams
+     step size stability bounds (from LSODA) for orders 1 to 5 */
+  static const sunrealtype cadams[BDF_Q_MAX + 1] = {
+    ZERO,
+    SUN_RCONST(0.5),
+    SUN_RCONST(1.0) / SUN_RCONST(12.0),
+    SUN_RCONST(1.0) / SUN_RCONST(24.0),
+    SUN_RCONST(19.0) / SUN_RCONST(720.0),
+    SUN_RCONST(3.0) / SUN_RCONST(160.0)};
+  static const sunrealtype cbdf[BDF_Q_MAX + 1] = {
+    ZERO,
+    SUN_RCONST(0.5),
+    SUN_RCONST(2.0) / SUN_RCONST(9.0),
+    SUN_RCONST(3.0) / SUN_RCONST(22.0),
+    SUN_RCONST(12.0) / SUN_RCONST(125.0),
+    SUN_RCONST(10.0) / SUN_RCONST(137.0)};
+  static const sunrealtype sm[ADAMS_Q_MAX + 1] = {ZERO,
+                                                  SUN_RCONST(0.5),
+                                                  SUN_RCONST(0.575),
+                                                  SUN_RCONST(0.55),
+                                                  SUN_RCONST(0.45),
+                                                  SUN_RCONST(0.35),
+                                                  SUN_RCONST(0.25),
+                                                  SUN_RCONST(0.2),
+                                                  SUN_RCONST(0.15),
+                                                  SUN_RCONST(0.1),
+                                                  SUN_RCONST(0.075),
+                                                  SUN_RCONST(0.05),
+                                                  SUN_RCONST(0.025)};
+  int q, qb, lmm;
+  sunrealtype habs, dsma, dsmb, etaa, etab, etas;
+
+  q    = cv_mem->cv_qu;
+  lmm  = cv_mem->cv_lmm;
+  habs = SUNRabs(cv_mem->cv_hu);
+
+  /* update the statistics */
+  cv_mem->cv_lmm_nst[lmm == CV_BDF]++;
+  cv_mem->cv_lmm_time[lmm == CV_BDF] += habs;
+
+  /* update the Lipschitz estimate from the fixed-point iteration */
+  if (lmm == CV_ADAMS && cv_mem->cv_lmm_liptmp > ZERO)
+  {
+    cv_mem->cv_lmm_lip = cv_mem->cv_lmm_liptmp;
+  }
+
+  /* During BDF steps the Lipschitz estimate is updated with the Jacobian
+     (or periodically if there is no linear solver setup) */
+  if (lmm == CV_BDF &&
+      (cv_mem->cv_lmm_probe ||
+       (!cv_mem->cv_lsetup &&
+        (cv_mem->cv_nst - cv_mem->cv_lmm_nstsw) % LMM_WAIT == 0)))
+  {
+    cv_mem->cv_lmm_lip   = cvLmmLipschitz(cv_mem);
+    cv_mem->cv_lmm_probe = SUNFALSE;
+  }
+
+  if (cv_mem->cv_lmm_lip <= ZERO) { return (CV_SUCCESS); }
+
+  /* step size ratios allowed by the error test and (Adams) stability with
+     BDF steps taken at order qb */
+  qb = SUNMIN(q, BDF_Q_MAX);
+  if (lmm == CV_ADAMS)
+  {
+    dsma = dsm;
+    if (q > qb)
+    {
+      /* 720 = (BDF_Q_MAX + 1)! */
+      dsmb = cbdf[qb] * SUN_RCONST(720.0) *
+             N_VWrmsNorm(cv_mem->cv_zn[qb + 1], cv_mem->cv_ewt);
+    }
+    else { dsmb = dsm * cbdf[q] / cadams[q]; }
+  }
+  else
+  {
+    dsma = dsm * cadams[q] / cbdf[q];
+    dsmb = dsm;
+  }
+  etaa = ONE / (SUNRpowerR(BIAS2 * dsma, ONE / (q + 1)) + ADDON);
+  etab = ONE / (SUNRpowerR(BIAS2 * dsmb, ONE / (qb + 1)) + ADDON);
+  etas = sm[q] / (habs * cv_mem->cv_lmm_lip);
+
+  /* Once Adams steps are limited by stability the error estimate is
+     dominated by the stiff components and understates the BDF step, so
+     consecutive stability limited steps also indicate stiffness */
+  if (lmm == CV_ADAMS)
+  {
+    if (etas < etaa && etas < etab) { cv_mem->cv_lmm_nstab++; }
+    else { cv_mem->cv_lmm_nstab = 0; }
+  }
+  etaa = SUNMIN(etaa, etas);
+
+  SUNLogDebug(CV_LOGGER, "method-switch-test",
+              "lmm = %d, L = %" RSYM ", eta adams = %" RSYM
+              ", eta bdf = %" RSYM,
+              lmm, cv_mem->cv_lmm_lip, etaa, etab);
+
+  /* Switches are separated by LMM_WAIT steps and are not made after a
+     failed attempt in this step */
+  if ((cv_mem->cv_nst < cv_mem->cv_lmm_nstsw + LMM_WAIT) ||
+      (cv_mem->cv_etamax == ONE))
+  {
+    return (CV_SUCCESS);
+  }
+
+  if (lmm == CV_ADAMS && etab < LMM_RATIO * etaa &&
+      cv_mem->cv_lmm_nstab < LMM_WAIT)
+  {
+    return (CV_SUCCESS);
+  }
+  if (lmm == CV_BDF && etaa < etab) { return (CV_SUCCESS); }
+
+  /* switch methods */
+  lmm = (lmm == CV_ADAMS) ? CV_BDF : CV_ADAMS;
+  if (cvNlsSwitchMethod(cv_mem, lmm) != CV_SUCCESS)
+  {
+    return (CV_NLS_INIT_FAIL);
+  }
+
+  cv_mem->cv_lmm_nstsw = cv_mem->cv_nst;
+  cv_mem->cv_lmm_nswitch++;
+
+  /* Keep the order (up to BDF_Q_MAX), take the step size of the new method,
+     and wait for a full history before the next order change */
+  cv_mem->cv_q      = qb;
+  cv_mem->cv_L      = qb + 1;
+  cv_mem->cv_qprime = cv_mem->cv_q;
+  cv_mem->cv_eta    = (lmm == CV_BDF) ? etab : etaa;
+  cvSetEta(cv_mem);
+  cv_mem->cv_qwait = cv_mem->cv_L;
+  cv_mem->cv_nscon = 0;
+
+  SUNLogInfo(CV_LOGGER, "method-switch",
+             "step = %li, t = %" RSYM ", lmm = %d, hprime = %" RSYM,
+             cv_mem->cv_nst, cv_mem->cv_tn, lmm, cv_mem->cv_hprime);
+
+  return (CV_SUCCESS);
+}
+
+/*
+ * cvLmmLipschitz
+ *
+ * This routine estimates the Lipschitz constant of f at the current
+ * solution for the method switching test during BDF steps with a few
+ * power iterations on difference quotients of f, started from the
+ * last correction. Any failure of f yields the estimate so far.
+ */
+
+static sunrealtype cvLmmLipschitz(CVodeMem cv_mem)
+{
+  N_Vector fy = cv_mem->cv_vtemp1;
+  N_Vector v  = cv_mem->cv_vtemp2;
+  N_Vector yp = cv_mem->cv_vtemp3;
+  N_Vector fp = cv_mem->cv_tempv;
+  sunrealtype lip, vnrm;
+  int i, retval;
+
+  retval = cv_mem->cv_f(cv_mem->cv_tn, cv_mem->cv_zn[0], fy,
+                        cv_mem->cv_user_data);
+  cv_mem->cv_nfe++;
+  if (retval != 0) { return (ZERO); }
+
+  /* start from the last correction (or f if it vanishes) with unit norm */
+  vnrm = N_VWrmsNorm(cv_mem->cv_acor, cv_mem->cv_ewt);
+  if (vnrm > ZERO) { N_VScale(ONE / vnrm, cv_mem->cv_acor, v); }
+  else
+  {
+    vnrm = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+    if (vnrm == ZERO) { return (ZERO); }
+    N_VScale(ONE / vnrm, fy, v);
+  }
+
+  lip = ZERO;
+  for (i = 0; i < LMM_PROBE_ITERS; i++)
+  {
+    N_VLinearSum(ONE, cv_mem->cv_zn[0], ONE, v, yp);
+    retval = cv_mem->cv_f(cv_mem->cv_tn, yp, fp, cv_mem->cv_user_data);
+    cv_mem->cv_nfe++;
+    if (retval != 0) { break; }
+
+    N_VLinearSum(ONE, fp, -ONE, fy, v);
+    lip = N_VWrmsNorm(v, cv_mem->cv_ewt);
+    if (lip == ZERO) { break; }
+    N_VScale(ONE / lip, v, v);
+  }
+
+  return (lip);
+}
+
 /*
  * cvPrepareNextStep
  *
@@ -4220,9 +4698,22 @@ static int cvRcheck1(CVodeMem cv_mem)
   smallh = hratio * cv_mem->cv_h;
   tplus  = cv_mem->cv_tlo + smallh;
   N_VLinearSum(ONE, cv_mem->cv_zn[0], hratio, cv_mem->cv_zn[1], cv_mem->cv_y);
-  retval = cv_mem->cv_gfun(tplus, cv_mem->cv_y, cv_mem->cv_ghi,
-                           cv_mem->cv_user_data);
-  cv_mem->cv_nge++;
+  if (cv_mem->cv_rootscalable)
+  {
+    /* only the components that are zero at t0 are needed at tplus */
+    cv_mem->cv_ncand = 0;
+    for (i = 0; i < cv_mem->cv_nrtfn; i++)
+    {
+      if (!cv_mem->cv_gactive[i]) { cv_mem->cv_icand[cv_mem->cv_ncand++] = i; }
+    }
+    retval = cvRootEvalCand(cv_mem, tplus, cv_mem->cv_ghi);
+  }
+  else
+  {
+    retval = cv_mem->cv_gfun(tplus, cv_mem->cv_y, cv_mem->cv_ghi,
+                             cv_mem->cv_user_data);
+    cv_mem->cv_nge++;
+  }
   if (retval != 0) { return (CV_RTFUNC_FAIL); }
 
   /* We check now only the components of g which were exactly 0.0 at t0
@@ -4261,7 +4752,7 @@ static int cvRcheck1(CVodeMem cv_mem)
 
 static int cvRcheck2(CVodeMem cv_mem)
 {
-  int i, retval;
+  int i, k, retval;
   sunrealtype smallh, hratio, tplus;
   sunbooleantype zroot;
 
@@ -4297,6 +4788,30 @@ static int cvRcheck2(CVodeMem cv_mem)
     N_VLinearSum(ONE, cv_mem->cv_y, hratio, cv_mem->cv_zn[1], cv_mem->cv_y);
   }
   else { (void)CVodeGetDky(cv_mem, tplus, 0, cv_mem->cv_y); }
+  if (cv_mem->cv_rootscalable)
+  {
+    /* Only the components that are zero at tlo are evaluated at tplus, so
+       only a close pair of zeros can be detected here.  A new zero in
+       (tlo,tplus] is found by the search in cvRcheck3. */
+    cv_mem->cv_ncand = 0;
+    for (i = 0; i < cv_mem->cv_nrtfn; i++)
+    {
+      if (cv_mem->cv_iroots[i] == 1)
+      {
+        cv_mem->cv_icand[cv_mem->cv_ncand++] = i;
+      }
+    }
+    retval = cvRootEvalCand(cv_mem, tplus, cv_mem->cv_ghi);
+    if (retval != 0) { return (CV_RTFUNC_FAIL); }
+
+    for (k = 0; k < cv_mem->cv_ncand; k++)
+    {
+      i = cv_mem->cv_icand[k];
+      if (SUNRabs(cv_mem->cv_ghi[i]) == ZERO) { return (CLOSERT); }
+      cv_mem->cv_glo[i] = cv_mem->cv_ghi[i];
+    }
+    return (CV_SUCCESS);
+  }
   retval = cv_mem->cv_gfun(tplus, cv_mem->cv_y, cv_mem->cv_ghi,
                            cv_mem->cv_user_data);
   cv_mem->cv_nge++;
@@ -4370,6 +4885,22 @@ static int cvRcheck3(CVodeMem cv_mem)
                     cv_mem->cv_uround * HUNDRED;
   ier = cvRootfind(cv_mem);
   if (ier == CV_RTFUNC_FAIL) { return (CV_RTFUNC_FAIL); }
+  /* In scalable mode grout is only current for the candidates when a root
+     was found, so the inactive components are evaluated at trout first */
+  if (cv_mem->cv_rootscalable && ier == RTFOUND)
+  {
+    cv_mem->cv_ncand = 0;
+    for (i = 0; i < cv_mem->cv_nrtfn; i++)
+    {
+      if (!cv_mem->cv_gactive[i]) { cv_mem->cv_icand[cv_mem->cv_ncand++] = i; }
+    }
+    if (cv_mem->cv_ncand > 0)
+    {
+      (void)CVodeGetDky(cv_mem, cv_mem->cv_trout, 0, cv_mem->cv_y);
+      retval = cvRootEvalCand(cv_mem, cv_mem->cv_trout, cv_mem->cv_grout);
+      if (retval != 0) { return (CV_RTFUNC_FAIL); }
+    }
+  }
   for (i = 0; i < cv_mem->cv_nrtfn; i++)
   {
     if (!cv_mem->cv_gactive[i] && cv_mem->cv_grout[i] != ZERO)
@@ -4476,6 +5007,8 @@ static int cvRootfind(CVodeMem cv_mem)
   int i, retval, imax, side, sideprev;
   sunbooleantype zroot, sgnchg;
 
+  if (cv_mem->cv_rootscalable) { return (cvRootfindCand(cv_mem)); }
+
   imax = 0;
 
   /* First check for change in sign in ghi or for a zero in ghi. */
@@ -4677,6 +5210,356 @@ static int cvRootfind(CVodeMem cv_mem)
   return (RTFOUND);
 }
 
+/*
+ * cvRootEvalCand
+ *
+ * This routine evaluates the candidate root functions
+ * icand[0], ..., icand[ncand-1] at (t, y) into gout, with the
+ * user-supplied subset function if one was provided or with the
+ * full root function otherwise.  Only the candidate entries of
+ * gout are defined on return.
+ */
+
+static int cvRootEvalCand(CVodeMem cv_mem, sunrealtype t, sunrealtype* gout)
+{
+  int retval;
+
+  if (cv_mem->cv_gsub != NULL)
+  {
+    retval = cv_mem->cv_gsub(t, cv_mem->cv_y, cv_mem->cv_ncand,
+                             cv_mem->cv_icand, gout, cv_mem->cv_user_data);
+  }
+  else
+  {
+    retval = cv_mem->cv_gfun(t, cv_mem->cv_y, gout, cv_mem->cv_user_data);
+  }
+  cv_mem->cv_nge++;
+
+  return (retval);
+}
+
+/*
+ * cvRootfindCand
+ *
+ * This routine is the scalable variant of cvRootfind.  The active
+ * components of g that change sign in (tlo,thi], or vanish at thi,
+ * in the monitored direction are first collected in the candidate
+ * set icand.  The Illinois iterations then only evaluate, scan and
+ * update the candidates, and whenever thi is moved to tmid the
+ * candidates without a sign change or zero in (tlo,tmid] are
+ * dropped, as their roots lie beyond the nearest one.  The cost of
+ * the search therefore grows with the number of events in the
+ * step rather than with nrtfn.
+ *
+ * On return, grout = ghi for all components, which is only g(trout)
+ * for the candidates if a root was found.  cvRcheck3 then evaluates
+ * the inactive components at trout, and the remaining components
+ * are refreshed by cvRcheck2 on the next call, as a root return
+ * always sets irfnd.
+ *
+ * The return values are those of cvRootfind.
+ */
+
+static int cvRootfindCand(CVodeMem cv_mem)
+{
+  sunrealtype alph, tmid, gfrac, maxfrac, fracint, fracsub;
+  int i, k, nc, retval, imax, side, sideprev;
+  sunbooleantype zroot, sgnchg;
+
+  imax = 0;
+
+  /* Collect the candidates from the signs of g at both endpoints. */
+  cv_mem->cv_ncand = 0;
+  for (i = 0; i < cv_mem->cv_nrtfn; i++)
+  {
+    if (!cv_mem->cv_gactive[i]) { continue; }
+    if (cv_mem->cv_rootdir[i] * cv_mem->cv_glo[i] > ZERO) { continue; }
+    if ((SUNRabs(cv_mem->cv_ghi[i]) == ZERO) ||
+        DIFFERENT_SIGN(cv_mem->cv_glo[i], cv_mem->cv_ghi[i]))
+    {
+      cv_mem->cv_icand[cv_mem->cv_ncand++] = i;
+    }
+  }
+
+  /* Check the candidates for a change in sign or a zero in ghi. */
+  maxfrac = ZERO;
+  zroot   = SUNFALSE;
+  sgnchg  = SUNFALSE;
+  for (k = 0; k < cv_mem->cv_ncand; k++)
+  {
+    i = cv_mem->cv_icand[k];
+    if (SUNRabs(cv_mem->cv_ghi[i]) == ZERO) { zroot = SUNTRUE; }
+    else
+    {
+      gfrac =
+        SUNRabs(cv_mem->cv_ghi[i] / (cv_mem->cv_ghi[i] - cv_mem->cv_glo[i]));
+      if (gfrac > maxfrac)
+      {
+        sgnchg  = SUNTRUE;
+        maxfrac = gfrac;
+        imax    = i;
+      }
+    }
+  }
+
+  /* If no sign change was found, reset trout and grout.  Then return
+     CV_SUCCESS if no zero was found, or set iroots and return RTFOUND.  */
+  if (!sgnchg)
+  {
+    cv_mem->cv_trout = cv_mem->cv_thi;
+    for (i = 0; i < cv_mem->cv_nrtfn; i++)
+    {
+      cv_mem->cv_grout[i] = cv_mem->cv_ghi[i];
+    }
+    if (!zroot) { return (CV_SUCCESS); }
+    for (i = 0; i < cv_mem->cv_nrtfn; i++) { cv_mem->cv_iroots[i] = 0; }
+    for (k = 0; k < cv_mem->cv_ncand; k++)
+    {
+      i                    = cv_mem->cv_icand[k];
+      cv_mem->cv_iroots[i] = cv_mem->cv_glo[i] > 0 ? -1 : 1;
+    }
+    return (RTFOUND);
+  }
+
+  /* Initialize alph to avoid compiler warning */
+  alph = ONE;
+
+  /* A sign change was found.  Loop to locate nearest root. */
+
+  side     = 0;
+  sideprev = -1;
+  for (;;)
+  { /* Looping point */
+
+    /* If interval size is already less than tolerance ttol, break. */
+    if (SUNRabs(cv_mem->cv_thi - cv_mem->cv_tlo) <= cv_mem->cv_ttol) { break; }
+
+    /* Set weight alph as in cvRootfind. */
+    if (sideprev == side) { alph = (side == 2) ? alph * TWO : alph * HALF; }
+    else { alph = ONE; }
+
+    /* Set next root approximation tmid and get g(tmid) for the candidates.
+       If tmid is too close to tlo or thi, adjust it inward,
+       by a fractional distance that is between 0.1 and 0.5.  */
+    tmid = cv_mem->cv_thi -
+           (cv_mem->cv_thi - cv_mem->cv_tlo) * cv_mem->cv_ghi[imax] /
+             (cv_mem->cv_ghi[imax] - alph * cv_mem->cv_glo[imax]);
+    if (SUNRabs(tmid - cv_mem->cv_tlo) < HALF * cv_mem->cv_ttol)
+    {
+      fracint = SUNRabs(cv_mem->cv_thi - cv_mem->cv_tlo) / cv_mem->cv_ttol;
+      fracsub = (fracint > FIVE) ? PT1 : HALF / fracint;
+      tmid    = cv_mem->cv_tlo + fracsub * (cv_mem->cv_thi - cv_mem->cv_tlo);
+    }
+    if (SUNRabs(cv_mem->cv_thi - tmid) < HALF * cv_mem->cv_ttol)
+    {
+      fracint = SUNRabs(cv_mem->cv_thi - cv_mem->cv_tlo) / cv_mem->cv_ttol;
+      fracsub = (fracint > FIVE) ? PT1 : HALF / fracint;
+      tmid    = cv_mem->cv_thi - fracsub * (cv_mem->cv_thi - cv_mem->cv_tlo);
+    }
+
+    (void)CVodeGetDky(cv_mem, tmid, 0, cv_mem->cv_y);
+    retval = cvRootEvalCand(cv_mem, tmid, cv_mem->cv_grout);
+    if (retval != 0) { return (CV_RTFUNC_FAIL); }
+
+    /* Check to see in which subinterval g changes sign, and reset imax.
+       Set side = 1 if sign change is on low side, or 2 if on high side.  */
+    maxfrac  = ZERO;
+    zroot    = SUNFALSE;
+    sgnchg   = SUNFALSE;
+    sideprev = side;
+    for (k = 0; k < cv_mem->cv_ncand; k++)
+    {
+      i = cv_mem->cv_icand[k];
+      if (SUNRabs(cv_mem->cv_grout[i]) == ZERO) { zroot = SUNTRUE; }
+      else if (DIFFERENT_SIGN(cv_mem->cv_glo[i], cv_mem->cv_grout[i]))
+      {
+        gfrac = SUNRabs(cv_mem->cv_grout[i] /
+                        (cv_mem->cv_grout[i] - cv_mem->cv_glo[i]));
+        if (gfrac > maxfrac)
+        {
+          sgnchg  = SUNTRUE;
+          maxfrac = gfrac;
+          imax    = i;
+        }
+      }
+    }
+
+    if (sgnchg || zroot)
+    {
+      /* Sign change in (tlo,tmid) or g = 0 at tmid; replace thi with tmid
+         and keep only the candidates with a root in (tlo,tmid]. */
+      cv_mem->cv_thi = tmid;
+      nc             = 0;
+      for (k = 0; k < cv_mem->cv_ncand; k++)
+      {
+        i                 = cv_mem->cv_icand[k];
+        cv_mem->cv_ghi[i] = cv_mem->cv_grout[i];
+        if ((SUNRabs(cv_mem->cv_grout[i]) == ZERO) ||
+            DIFFERENT_SIGN(cv_mem->cv_glo[i], cv_mem->cv_grout[i]))
+        {
+          cv_mem->cv_icand[nc++] = i;
+        }
+      }
+      cv_mem->cv_ncand = nc;
+
+      /* Without a sign change, return root tmid. */
+      if (!sgnchg) { break; }
+
+      side = 1;
+      /* Stop at root thi if converged; otherwise loop. */
+      if (SUNRabs(cv_mem->cv_thi - cv_mem->cv_tlo) <= cv_mem->cv_ttol)
+      {
+        break;
+      }
+      continue; /* Return to looping point. */
+    }
+
+    /* No sign change in (tlo,tmid), and no zero at tmid.
+       Sign change must be in (tmid,thi).  Replace tlo with tmid. */
+    cv_mem->cv_tlo = tmid;
+    for (k = 0; k < cv_mem->cv_ncand; k++)
+    {
+      i                 = cv_mem->cv_icand[k];
+      cv_mem->cv_glo[i] = cv_mem->cv_grout[i];
+    }
+    side = 2;
+    /* Stop at root thi if converged; otherwise loop back. */
+    if (SUNRabs(cv_mem->cv_thi - cv_mem->cv_tlo) <= cv_mem->cv_ttol) { break; }
+
+  } /* End of root-search loop */
+
+  /* Reset trout and grout, set iroots for the candidates, and return
+     RTFOUND. */
+  cv_mem->cv_trout = cv_mem->cv_thi;
+  for (i = 0; i < cv_mem->cv_nrtfn; i++)
+  {
+    cv_mem->cv_grout[i]  = cv_mem->cv_ghi[i];
+    cv_mem->cv_iroots[i] = 0;
+  }
+  for (k = 0; k < cv_mem->cv_ncand; k++)
+  {
+    i = cv_mem->cv_icand[k];
+    if ((SUNRabs(cv_mem->cv_ghi[i]) == ZERO) ||
+        DIFFERENT_SIGN(cv_mem->cv_glo[i], cv_mem->cv_ghi[i]))
+    {
+      cv_mem->cv_iroots[i] = cv_mem->cv_glo[i] > 0 ? -1 : 1;
+    }
+  }
+  return (RTFOUND);
+}
+
+/*
+ * =================================================================
+ * Step trace functions
+ * =================================================================
+ */
+
+/*
+ * cvStepTraceCounters
+ *
+ * Samples the cumulative integrator and linear solver counters that
+ * are differenced to form a step trace record.
+ */
+
+static void cvStepTraceCounters(CVodeMem cv_mem, long int counters[])
+{
+  CVLsMem cvls_mem = NULL;
+
+  counters[SUN_STEPTRACE_NETF]    = cv_mem->cv_netf;
+  counters[SUN_STEPTRACE_NCFN]    = cv_mem->cv_ncfn;
+  counters[SUN_STEPTRACE_NNI]     = cv_mem->cv_nni;
+  counters[SUN_STEPTRACE_NSETUPS] = cv_mem->cv_nsetups;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  /* the linear solver counters are only available with CVLS */
+  if (cv_mem->cv_lmem && cv_mem->cv_lsolve == cvLsSolve)
+  {
+    cvls_mem                        = (CVLsMem)cv_mem->cv_lmem;
+    counters[SUN_STEPTRACE_NLI]     = cvls_mem->nli;
+    counters[SUN_STEPTRACE_NJEVALS] = cvls_mem->nje;
+  }
+}
+
+/*
+ * cvStepTraceRecord
+ *
+ * Writes a record for the step just attempted by cvStep to trace, the
+ * step trace that was attached to the SUNContext when the counters in
+ * start were sampled. On failure the record holds the step size and
+ * order of the last attempt.
+ */
+
+static void cvStepTraceRecord(CVodeMem cv_mem, SUNStepTrace trace,
+                              int kflag, const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  cvStepTraceCounters(cv_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_CVODE, start, end);
+
+  record.t    = (double)cv_mem->cv_tn;
+  record.flag = kflag;
+  if (kflag == CV_SUCCESS)
+  {
+    record.h     = (double)cv_mem->cv_hu;
+    record.step  = cv_mem->cv_nst;
+    record.order = cv_mem->cv_qu;
+  }
+  else
+  {
+    record.h     = (double)cv_mem->cv_h;
+    record.step  = cv_mem->cv_nst + 1;
+    record.order = cv_mem->cv_q;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
+/*
+ * cvBorrowScratch
+ *
+ * Borrows the vectors vtemp1, vtemp2, and vtemp3 used within a step
+ * from the SUNContext scratch pool. Returns 0 on success and a
+ * nonzero value if the vectors could not be obtained.
+ */
+
+static int cvBorrowScratch(CVodeMem cv_mem)
+{
+  N_Vector vtemp[3];
+
+  if (N_VBorrowScratchVectorArray(3, cv_mem->cv_ewt, vtemp)) { return (-1); }
+
+  cv_mem->cv_vtemp1 = vtemp[0];
+  cv_mem->cv_vtemp2 = vtemp[1];
+  cv_mem->cv_vtemp3 = vtemp[2];
+
+  return (0);
+}
+
+/*
+ * cvReturnScratch
+ *
+ * Returns the vectors obtained by cvBorrowScratch to the SUNContext
+ * scratch pool so they may be used by other objects sharing it.
+ */
+
+static void cvReturnScratch(CVodeMem cv_mem)
+{
+  N_Vector vtemp[3];
+
+  vtemp[0] = cv_mem->cv_vtemp1;
+  vtemp[1] = cv_mem->cv_vtemp2;
+  vtemp[2] = cv_mem->cv_vtemp3;
+
+  (void)N_VReturnScratchVectorArray(3, vtemp);
+
+  cv_mem->cv_vtemp1 = NULL;
+  cv_mem->cv_vtemp2 = NULL;
+  cv_mem->cv_vtemp3 = NULL;
+}
+
 /*
  * =================================================================
  * Internal EWT function
@@ -27,6 +27,7 @@
 #include "cvode_proj_impl.h"
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
 extern "C" {
@@ -44,8 +45,9 @@ extern "C" {
   SHORTCUTS
   ===============================================================*/
 
-#define CV_PROFILER cv_mem->cv_sunctx->profiler
-#define CV_LOGGER   cv_mem->cv_sunctx->logger
+#define CV_PROFILER  cv_mem->cv_sunctx->profiler
+#define CV_LOGGER    cv_mem->cv_sunctx->logger
+#define CV_STEPTRACE cv_mem->cv_sunctx->steptrace
 
 /*
  * =================================================================
@@ -120,6 +122,19 @@ extern "C" {
 
 #define LONG_WAIT 10
 
+/* Method switching constants
+ * --------------------------
+ * LMM_WAIT        minimum number of steps between method switches
+ * LMM_RATIO       step size ratio BDF must gain over Adams to switch to BDF
+ *                 (or LMM_WAIT consecutive stability limited Adams steps)
+ * LMM_PROBE_ITERS number of power iterations estimating the Lipschitz
+ *                 constant of f during BDF steps
+ */
+
+#define LMM_WAIT        20
+#define LMM_RATIO       SUN_RCONST(5.0)
+#define LMM_PROBE_ITERS 3
+
 /* Failure limits
  * --------------
  * MXNCF   max no. of convergence failures during one step try
@@ -249,6 +264,8 @@ typedef struct CVodeMemRec
   N_Vector cv_vtemp1; /* temporary storage vector                            */
   N_Vector cv_vtemp2; /* temporary storage vector                            */
   N_Vector cv_vtemp3; /* temporary storage vector                            */
+  sunbooleantype cv_scratch_vtemp; /* borrow vtemp1-3 from the SUNContext
+                                      scratch pool for each step          */
 
   N_Vector cv_constraints; /* vector of inequality constraint options         */
 
@@ -366,6 +383,24 @@ typedef struct CVodeMemRec
   int convfail;           /* flag to indicate when a Jacobian update may
                                   be needed */
 
+  /* Automatic Adams/BDF switching: Adams steps use fixed-point iteration and
+     BDF steps use Newton iteration, the solver for the inactive method is
+     held in NLSsw */
+  sunbooleantype cv_lmm_switch; /* is automatic method switching enabled? */
+  int cv_lmm_start;             /* method selected at creation            */
+  int cv_lmm_qmax;              /* maximum order for Adams steps          */
+  SUNNonlinearSolver NLSsw;     /* nonlinear solver of the inactive method */
+  sunbooleantype ownNLSsw;      /* flag indicating NLSsw ownership        */
+  sunbooleantype cv_lmm_jbad;   /* force a Jacobian update (new BDF phase) */
+  sunbooleantype cv_lmm_probe;  /* update the Lipschitz estimate (BDF)    */
+  sunrealtype cv_lmm_lip;       /* estimated Lipschitz constant of f      */
+  sunrealtype cv_lmm_liptmp;    /* estimate from the current Adams solve  */
+  long int cv_lmm_nstsw;        /* step number of the last switch         */
+  long int cv_lmm_nstab;        /* consecutive stability limited Adams steps */
+  long int cv_lmm_nswitch;      /* number of method switches              */
+  long int cv_lmm_nst[2];       /* steps taken with Adams and BDF         */
+  sunrealtype cv_lmm_time[2];   /* time integrated with Adams and BDF     */
+
   /*------------------
     Linear Solver Data
     ------------------*/
@@ -390,6 +425,26 @@ typedef struct CVodeMemRec
   sunrealtype cv_dgmax_lsetup; /* gamma ratio threshold to signal for a linear
                               * solver setup */
 
+  /* Cost-model linear solver setup policy: wall times (seconds) are
+     measured at runtime and the setup and Jacobian update points are
+     chosen to minimize the cost per unit of simulated time */
+  int cv_lsetup_policy;      /* CV_LSETUP_HEURISTIC or CV_LSETUP_COST_MODEL */
+  sunbooleantype cv_lsp_setup; /* cost model requests a setup next step   */
+  sunbooleantype cv_lsp_jac;   /* cost model requests a Jacobian update   */
+  double cv_lsp_wsolve;        /* setup time in the current solve         */
+  double cv_lsp_wstep;         /* Newton time in the current step         */
+  double cv_lsp_scost;         /* time spent since the last setup         */
+  double cv_lsp_snls;          /* Newton time since the last setup        */
+  double cv_lsp_jcost;         /* J and Newton time since the last update */
+  double cv_lsp_jeval;         /* time of the last Jacobian update        */
+  sunrealtype cv_lsp_stime;    /* time integrated since the last setup    */
+  sunrealtype cv_lsp_jtime;    /* time integrated since the last J update */
+  long int cv_lsp_nsetups;     /* setups requested by the cost model      */
+  long int cv_lsp_njevals;     /* J updates requested by the cost model   */
+  double cv_lsp_tjac;          /* total Jacobian evaluation time          */
+  double cv_lsp_tsetup;        /* total setup time (including J updates)  */
+  double cv_lsp_tnls;          /* total Newton time (excluding setups)    */
+
   /*------------
     Saved Values
     ------------*/
@@ -448,6 +503,10 @@ typedef struct CVodeMemRec
   long int cv_nge;       /* counter for g evaluations                       */
   sunbooleantype* cv_gactive; /* array with active/inactive event functions      */
   int cv_mxgnull; /* number of warning messages about possible g==0  */
+  sunbooleantype cv_rootscalable; /* restrict root search to candidates */
+  CVRootSubsetFn cv_gsub;         /* function evaluating a subset of g  */
+  int cv_ncand;                   /* number of candidate root functions */
+  int* cv_icand;                  /* indices of candidate functions     */
 
   /*---------------
     Projection Data
@@ -616,9 +675,10 @@ int cvEwtSet(N_Vector ycur, N_Vector weight, void* data);
 void cvProcessError(CVodeMem cv_mem, int error_code, int line, const char* func,
                     const char* file, const char* msgfmt, ...);
 
-/* Nonlinear solver initialization */
+/* Nonlinear solver initialization and method switching */
 
 int cvNlsInit(CVodeMem cv_mem);
+int cvNlsSwitchMethod(CVodeMem cv_mem, int lmm);
 
 /* Projection functions */
 
@@ -184,6 +184,13 @@ int CVodeSetMaxOrd(void* cvode_mem, int maxord)
     return (CV_ILL_INPUT);
   }
 
+  /* with method switching BDF steps are limited to order BDF_Q_MAX */
+  cv_mem->cv_lmm_qmax = maxord;
+  if (cv_mem->cv_lmm_switch && cv_mem->cv_lmm == CV_BDF)
+  {
+    maxord = SUNMIN(maxord, BDF_Q_MAX);
+  }
+
   cv_mem->cv_qmax = maxord;
 
   return (CV_SUCCESS);
@@ -255,7 +262,7 @@ int CVodeSetStabLimDet(void* cvode_mem, sunbooleantype sldet)
 
   cv_mem = (CVodeMem)cvode_mem;
 
-  if (sldet && (cv_mem->cv_lmm != CV_BDF))
+  if (sldet && (cv_mem->cv_lmm != CV_BDF) && !cv_mem->cv_lmm_switch)
   {
     cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
                    MSGCV_SET_SLDET);
@@ -805,6 +812,12 @@ int CVodeSetMaxNonlinIters(void* cvode_mem, int maxcor)
     return (CV_MEM_FAIL);
   }
 
+  /* the solver of the inactive method uses the same limit */
+  if (cv_mem->NLSsw != NULL)
+  {
+    (void)SUNNonlinSolSetMaxIters(cv_mem->NLSsw, maxcor);
+  }
+
   return (SUNNonlinSolSetMaxIters(cv_mem->NLS, maxcor));
 }
 
@@ -865,6 +878,51 @@ int CVodeSetLSetupFrequency(void* cvode_mem, long int msbp)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeSetLSetupPolicy
+ *
+ * Specifies how the linear solver setup and Jacobian update points are
+ * chosen: with the fixed heuristics (CV_LSETUP_HEURISTIC) or with a cost
+ * model based on measured wall times (CV_LSETUP_COST_MODEL)
+ */
+
+int CVodeSetLSetupPolicy(void* cvode_mem, int policy)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  /* check for a valid input */
+  if ((policy != CV_LSETUP_HEURISTIC) && (policy != CV_LSETUP_COST_MODEL))
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "Illegal value for policy. Legal values are "
+                   "CV_LSETUP_HEURISTIC and CV_LSETUP_COST_MODEL.");
+    return (CV_ILL_INPUT);
+  }
+
+  cv_mem->cv_lsetup_policy = policy;
+
+  /* start new cost model cycles at the next setup */
+  cv_mem->cv_lsp_setup = SUNFALSE;
+  cv_mem->cv_lsp_jac   = SUNFALSE;
+  cv_mem->cv_lsp_wstep = 0.0;
+  cv_mem->cv_lsp_scost = 0.0;
+  cv_mem->cv_lsp_snls  = 0.0;
+  cv_mem->cv_lsp_jcost = 0.0;
+  cv_mem->cv_lsp_jeval = 0.0;
+  cv_mem->cv_lsp_stime = ZERO;
+  cv_mem->cv_lsp_jtime = ZERO;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodeSetRootDirection
  *
@@ -922,6 +980,58 @@ int CVodeSetNoInactiveRootWarn(void* cvode_mem)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeSetScalableRootfinding
+ *
+ * Specifies whether the root search within a step is restricted
+ * to the root functions that change sign over the step (and the
+ * function subset to these candidates, see CVodeSetRootSubsetFn).
+ * The default is to search all root functions.
+ */
+
+int CVodeSetScalableRootfinding(void* cvode_mem, sunbooleantype onoff)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  cv_mem->cv_rootscalable = onoff;
+
+  return (CV_SUCCESS);
+}
+
+/*
+ * CVodeSetRootSubsetFn
+ *
+ * Specifies a user-provided function that evaluates only a subset
+ * of the root functions.  It is used in place of the full root
+ * function by the scalable root search.  A NULL input function
+ * disables it.
+ */
+
+int CVodeSetRootSubsetFn(void* cvode_mem, CVRootSubsetFn gsub)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  cv_mem->cv_gsub = gsub;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodeSetConstraints
  *
@@ -1177,6 +1287,29 @@ int CVodeGetCurrentOrder(void* cvode_mem, int* qcur)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeGetCurrentMethod
+ *
+ * Returns the method (CV_ADAMS or CV_BDF) to be used on the next step
+ */
+
+int CVodeGetCurrentMethod(void* cvode_mem, int* lmm)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  *lmm = cv_mem->cv_lmm;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodeGetCurrentGamma
  *
@@ -1433,6 +1566,31 @@ int CVodeGetWorkSpace(void* cvode_mem, long int* lenrw, long int* leniw)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeGetScratchSpace
+ *
+ * Returns the integrator work space borrowed from the SUNContext
+ * scratch pool during each step
+ */
+
+int CVodeGetScratchSpace(void* cvode_mem, long int* lenrw, long int* leniw)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  *leniw = cv_mem->cv_scratch_vtemp ? 3 * cv_mem->cv_liw1 : 0;
+  *lenrw = cv_mem->cv_scratch_vtemp ? 3 * cv_mem->cv_lrw1 : 0;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodeGetIntegratorStats
  *
@@ -1612,6 +1770,66 @@ int CVodeGetNumStepSolveFails(void* cvode_mem, long int* nncfails)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeGetLSetupPolicyStats
+ *
+ * Returns the number of linear solver setups and Jacobian evaluations
+ * requested by the setup policy cost model and the measured wall times
+ */
+
+int CVodeGetLSetupPolicyStats(void* cvode_mem, long int* nsetups_model,
+                              long int* njevals_model, double* jac_time,
+                              double* setup_time, double* nls_time)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  *nsetups_model = cv_mem->cv_lsp_nsetups;
+  *njevals_model = cv_mem->cv_lsp_njevals;
+  *jac_time      = cv_mem->cv_lsp_tjac;
+  *setup_time    = cv_mem->cv_lsp_tsetup;
+  *nls_time      = cv_mem->cv_lsp_tnls;
+
+  return (CV_SUCCESS);
+}
+
+/*
+ * CVodeGetMethodSwitchingStats
+ *
+ * Returns the number of method switches and the number of steps taken
+ * and the time integrated with the Adams and BDF methods
+ */
+
+int CVodeGetMethodSwitchingStats(void* cvode_mem, long int* nswitches,
+                                 long int* nsteps_adams, long int* nsteps_bdf,
+                                 sunrealtype* time_adams, sunrealtype* time_bdf)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  *nswitches    = cv_mem->cv_lmm_nswitch;
+  *nsteps_adams = cv_mem->cv_lmm_nst[0];
+  *nsteps_bdf   = cv_mem->cv_lmm_nst[1];
+  *time_adams   = cv_mem->cv_lmm_time[0];
+  *time_bdf     = cv_mem->cv_lmm_time[1];
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodePrintAllStats
  *
@@ -1686,6 +1904,36 @@ int CVodePrintAllStats(void* cvode_mem, FILE* outfile, SUNOutputFormat fmt)
       }
     }
 
+    /* setup policy stats */
+    if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+    {
+      fprintf(outfile, "Cost model LS setups         = %ld\n",
+              cv_mem->cv_lsp_nsetups);
+      fprintf(outfile, "Cost model Jac evals         = %ld\n",
+              cv_mem->cv_lsp_njevals);
+      fprintf(outfile, "Jac eval time                = %g\n",
+              cv_mem->cv_lsp_tjac);
+      fprintf(outfile, "LS setup time                = %g\n",
+              cv_mem->cv_lsp_tsetup);
+      fprintf(outfile, "NLS iteration time           = %g\n",
+              cv_mem->cv_lsp_tnls);
+    }
+
+    /* method switching stats */
+    if (cv_mem->cv_lmm_switch)
+    {
+      fprintf(outfile, "Method switches              = %ld\n",
+              cv_mem->cv_lmm_nswitch);
+      fprintf(outfile, "Adams steps                  = %ld\n",
+              cv_mem->cv_lmm_nst[0]);
+      fprintf(outfile, "BDF steps                    = %ld\n",
+              cv_mem->cv_lmm_nst[1]);
+      fprintf(outfile, "Adams time                   = %" RSYM "\n",
+              cv_mem->cv_lmm_time[0]);
+      fprintf(outfile, "BDF time                     = %" RSYM "\n",
+              cv_mem->cv_lmm_time[1]);
+    }
+
     /* rootfinding stats */
     fprintf(outfile, "Root fn evals                = %ld\n", cv_mem->cv_nge);
 
@@ -1755,6 +2003,26 @@ int CVodePrintAllStats(void* cvode_mem, FILE* outfile, SUNOutputFormat fmt)
       }
     }
 
+    /* setup policy stats */
+    if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+    {
+      fprintf(outfile, ",Cost model LS setups,%ld", cv_mem->cv_lsp_nsetups);
+      fprintf(outfile, ",Cost model Jac evals,%ld", cv_mem->cv_lsp_njevals);
+      fprintf(outfile, ",Jac eval time,%g", cv_mem->cv_lsp_tjac);
+      fprintf(outfile, ",LS setup time,%g", cv_mem->cv_lsp_tsetup);
+      fprintf(outfile, ",NLS iteration time,%g", cv_mem->cv_lsp_tnls);
+    }
+
+    /* method switching stats */
+    if (cv_mem->cv_lmm_switch)
+    {
+      fprintf(outfile, ",Method switches,%ld", cv_mem->cv_lmm_nswitch);
+      fprintf(outfile, ",Adams steps,%ld", cv_mem->cv_lmm_nst[0]);
+      fprintf(outfile, ",BDF steps,%ld", cv_mem->cv_lmm_nst[1]);
+      fprintf(outfile, ",Adams time,%" RSYM, cv_mem->cv_lmm_time[0]);
+      fprintf(outfile, ",BDF time,%" RSYM, cv_mem->cv_lmm_time[1]);
+    }
+
     /* rootfinding stats */
     fprintf(outfile, ",Root fn evals,%ld", cv_mem->cv_nge);
 
@@ -15,6 +15,7 @@
  * Implementation file for CVode's linear solver interface.
  * ---------------------------------------------------------------- */
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,6 +26,11 @@
 
 #include "cvode_impl.h"
 #include "cvode_ls_impl.h"
+#include "sundials_utils.h"
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
 
 /* Private constants */
 #define MIN_INC_MULT SUN_RCONST(1000.0)
@@ -43,6 +49,26 @@ static int cvLsLinSys(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix A,
                       sunrealtype gamma, void* user_data, N_Vector tmp1,
                       N_Vector tmp2, N_Vector tmp3);
 
+static sunrealtype cvLsDQInc(CVodeMem cv_mem, sunindextype j,
+                             sunrealtype* y_data, sunrealtype* ewt_data,
+                             sunrealtype* cns_data, sunrealtype srur,
+                             sunrealtype minInc);
+static int cvLsBatchAlloc(CVLsMem cvls_mem, N_Vector tmpl, int nvecs);
+static void cvLsBatchFree(CVLsMem cvls_mem);
+static int cvLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, CVodeMem cv_mem, N_Vector tmp1);
+static int cvLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, CVodeMem cv_mem);
+static void cvLsThreadFree(CVLsMem cvls_mem);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+static int cvLsThreadAlloc(CVLsMem cvls_mem, N_Vector tmpl);
+static int cvLsThreadRetval(CVLsMem cvls_mem, long int* nfeDQ);
+static int cvLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, CVodeMem cv_mem);
+static int cvLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                            SUNMatrix Jac, CVodeMem cv_mem);
+#endif
+
 /*===============================================================
   CVLS Exported functions -- Required
   ===============================================================*/
@@ -320,6 +346,66 @@ int CVodeSetJacFn(void* cvode_mem, CVLsJacFn jac)
   return (CVLS_SUCCESS);
 }
 
+/* CVodeSetBatchRhsFn specifies a function evaluating the RHS at several
+ * states in one call. When set, it is used by the internal dense and band
+ * DQ Jacobian approximations with at most max_batch states per call
+ * (CVLS_MAX_BATCH if max_batch = 0, all columns or column groups at once
+ * if max_batch < 0). */
+int CVodeSetBatchRhsFn(void* cvode_mem, CVLsBatchRhsFn fb, int max_batch)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+  /* release batch vectors sized for a previous setting */
+  cvLsBatchFree(cvls_mem);
+
+  cvls_mem->fbatch    = fb;
+  /* max_batch = 0 selects the default bound, max_batch < 0 all columns */
+  if (max_batch == 0) { cvls_mem->max_batch = CVLS_MAX_BATCH; }
+  else if (max_batch < 0) { cvls_mem->max_batch = INT_MAX; }
+  else { cvls_mem->max_batch = max_batch; }
+
+  return (CVLS_SUCCESS);
+}
+
+/* CVodeSetDQJacNumThreads specifies the number of OpenMP threads used to
+ * evaluate the columns (or column groups) of the internal dense and band DQ
+ * Jacobian approximations concurrently. The RHS function must be thread-safe
+ * when nthreads > 1. */
+int CVodeSetDQJacNumThreads(void* cvode_mem, int nthreads)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* release work vectors sized for a previous setting */
+  cvLsThreadFree(cvls_mem);
+
+  cvls_mem->dqnthreads = (nthreads > 1) ? nthreads : 0;
+
+  return (CVLS_SUCCESS);
+#else
+  if (nthreads > 1)
+  {
+    cvProcessError(cv_mem, CVLS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "SUNDIALS was not built with OpenMP enabled");
+    return (CVLS_ILL_INPUT);
+  }
+
+  return (CVLS_SUCCESS);
+#endif
+}
+
 /* CVodeSetDeltaGammaMaxBadJac specifies the maximum gamma ratio change
  * after a NLS convergence failure with a potentially bad Jacobian. If
  * |gamma/gammap-1| < dgmax_jbad then the Jacobian is marked as bad */
@@ -1060,6 +1146,20 @@ int cvLsDenseDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   /* access LsMem interface structure */
   cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
+  /* evaluate all perturbed states with the batched RHS if provided */
+  if (cvls_mem->fbatch)
+  {
+    return (cvLsDenseDQJacBatch(t, y, fy, Jac, cv_mem, tmp1));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the columns concurrently if requested */
+  if (cvls_mem->dqnthreads > 1)
+  {
+    return (cvLsDenseDQJacOMP(t, y, fy, Jac, cv_mem));
+  }
+#endif
+
   /* access matrix dimension */
   N = SUNDenseMatrix_Columns(Jac);
 
@@ -1154,6 +1254,20 @@ int cvLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   /* access LsMem interface structure */
   cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
+  /* evaluate all column groups with the batched RHS if provided */
+  if (cvls_mem->fbatch)
+  {
+    return (cvLsBandDQJacBatch(t, y, fy, Jac, cv_mem));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the column groups concurrently if requested */
+  if (cvls_mem->dqnthreads > 1)
+  {
+    return (cvLsBandDQJacOMP(t, y, fy, Jac, cv_mem));
+  }
+#endif
+
   /* access matrix dimensions */
   N      = SUNBandMatrix_Columns(Jac);
   mupper = SUNBandMatrix_UpperBandwidth(Jac);
@@ -1252,6 +1366,607 @@ int cvLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   return (retval);
 }
 
+/*-----------------------------------------------------------------
+  cvLsDenseDQJacBatch
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of f(t,y) using the batched RHS function. The
+  perturbed states y + inc_j e_j for up to max_batch columns are
+  evaluated in one call and the columns of J are then formed as in
+  cvLsDenseDQJac.
+  -----------------------------------------------------------------*/
+static int cvLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, CVodeMem cv_mem, N_Vector tmp1)
+{
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  N_Vector jthCol;
+  sunindextype j, j0, N;
+  int k, nb, nstates;
+  CVLsMem cvls_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (cvls_mem->max_batch < N) ? cvls_mem->max_batch : (int)N;
+  if (cvLsBatchAlloc(cvls_mem, tmp1, nb))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Create an empty vector for matrix column calculations */
+  jthCol = N_VCloneEmpty(tmp1);
+
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+  for (j0 = 0; j0 < N; j0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, N - j0);
+
+    /* Load the perturbed states */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      N_VScale(ONE, y, cvls_mem->ybatch[k]);
+      N_VGetArrayPointer(cvls_mem->ybatch[k])[j] += inc;
+    }
+
+    retval = cvls_mem->fbatch(t, nstates, cvls_mem->ybatch, cvls_mem->fybatch,
+                              cv_mem->cv_user_data);
+    cvls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Form the difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, cvls_mem->fybatch[k], -inc_inv, fy, jthCol);
+    }
+  }
+
+  /* Destroy jthCol vector */
+  N_VSetArrayPointer(NULL, jthCol);
+  N_VDestroy(jthCol);
+
+  return (retval);
+}
+
+/*-----------------------------------------------------------------
+  cvLsBandDQJacBatch
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of f(t,y) using the batched RHS function. The
+  perturbed states for up to max_batch column groups are evaluated
+  in one call and the columns of J are then formed as in
+  cvLsBandDQJac.
+  -----------------------------------------------------------------*/
+static int cvLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, CVodeMem cv_mem)
+{
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *col_j, *ewt_data, *fy_data, *ftemp_data;
+  sunrealtype *y_data, *ytemp_data, *cns_data;
+  sunindextype group, g0, i, j, width, ngroups, i1, i2;
+  sunindextype N, mupper, mlower;
+  int k, nb, nstates;
+  CVLsMem cvls_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (cvls_mem->max_batch < ngroups) ? cvls_mem->max_batch : (int)ngroups;
+  if (cvLsBatchAlloc(cvls_mem, y, nb))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+  for (g0 = 0; g0 < ngroups; g0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, ngroups - g0);
+
+    /* Load the states with all y_j in each group incremented */
+    for (k = 0; k < nstates; k++)
+    {
+      group = g0 + k;
+      N_VScale(ONE, y, cvls_mem->ybatch[k]);
+      ytemp_data = N_VGetArrayPointer(cvls_mem->ybatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        ytemp_data[j] += cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data,
+                                   srur, minInc);
+      }
+    }
+
+    retval = cvls_mem->fbatch(t, nstates, cvls_mem->ybatch, cvls_mem->fybatch,
+                              cv_mem->cv_user_data);
+    cvls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Form and load difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      group      = g0 + k;
+      ftemp_data = N_VGetArrayPointer(cvls_mem->fybatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv *
+                                             (ftemp_data[i] - fy_data[i]);
+        }
+      }
+    }
+  }
+
+  return (retval);
+}
+
+/*-----------------------------------------------------------------
+  cvLsDQInc
+
+  This routine returns the increment used for the jth column in the
+  DQ Jacobian approximations, with its sign adjusted if y_j has an
+  inequality constraint.
+  -----------------------------------------------------------------*/
+static sunrealtype cvLsDQInc(CVodeMem cv_mem, sunindextype j,
+                             sunrealtype* y_data, sunrealtype* ewt_data,
+                             sunrealtype* cns_data, sunrealtype srur,
+                             sunrealtype minInc)
+{
+  sunrealtype inc, conj;
+
+  inc = SUNMAX(srur * SUNRabs(y_data[j]), minInc / ewt_data[j]);
+
+  if (cv_mem->cv_constraintsSet)
+  {
+    conj = cns_data[j];
+    if (SUNRabs(conj) == ONE)
+    {
+      if ((y_data[j] + inc) * conj < ZERO) { inc = -inc; }
+    }
+    else if (SUNRabs(conj) == TWO)
+    {
+      if ((y_data[j] + inc) * conj <= ZERO) { inc = -inc; }
+    }
+  }
+
+  return (inc);
+}
+
+/*-----------------------------------------------------------------
+  cvLsBatchAlloc and cvLsBatchFree
+
+  These routines allocate (at least nvecs) and free the vectors
+  passed to the batched RHS function.
+  -----------------------------------------------------------------*/
+static int cvLsBatchAlloc(CVLsMem cvls_mem, N_Vector tmpl, int nvecs)
+{
+  if (cvls_mem->nbatch >= nvecs) { return (0); }
+
+  cvLsBatchFree(cvls_mem);
+
+  cvls_mem->ybatch  = N_VCloneVectorArray(nvecs, tmpl);
+  cvls_mem->fybatch = N_VCloneVectorArray(nvecs, tmpl);
+  if (cvls_mem->ybatch == NULL || cvls_mem->fybatch == NULL)
+  {
+    cvLsBatchFree(cvls_mem);
+    return (-1);
+  }
+  cvls_mem->nbatch = nvecs;
+
+  return (0);
+}
+
+static void cvLsBatchFree(CVLsMem cvls_mem)
+{
+  if (cvls_mem->ybatch)
+  {
+    N_VDestroyVectorArray(cvls_mem->ybatch, cvls_mem->nbatch);
+  }
+  if (cvls_mem->fybatch)
+  {
+    N_VDestroyVectorArray(cvls_mem->fybatch, cvls_mem->nbatch);
+  }
+  cvls_mem->ybatch  = NULL;
+  cvls_mem->fybatch = NULL;
+  cvls_mem->nbatch  = 0;
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+
+/*-----------------------------------------------------------------
+  cvLsDenseDQJacOMP
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of f(t,y) with the columns distributed across
+  dqnthreads OpenMP threads. Each thread perturbs its own copy of y
+  and the columns are formed exactly as in cvLsDenseDQJac, so the
+  result does not depend on the number of threads. If the RHS
+  function fails, the value returned for the first failed column is
+  returned.
+  -----------------------------------------------------------------*/
+static int cvLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, CVodeMem cv_mem)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  sunindextype N;
+  CVLsMem cvls_mem;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* per-thread work vectors */
+  if (cvLsThreadAlloc(cvls_mem, y))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+#pragma omp parallel num_threads(cvls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = cvls_mem->ythr[tid];
+    N_Vector ftemp   = cvls_mem->fythr[tid];
+    N_Vector jthCol  = cvls_mem->colthr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype inc, inc_inv;
+    sunindextype j;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (j = 0; j < N; j++)
+    {
+      /* skip the remaining columns of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = j; }
+
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+
+      ytd[j] += inc;
+      ier = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
+      nfe++;
+      ytd[j] = y_data[j];
+      if (ier != 0)
+      {
+        jfail = j;
+        ret   = ier;
+        continue;
+      }
+
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, ftemp, -inc_inv, fy, jthCol);
+    }
+
+    N_VSetArrayPointer(NULL, jthCol);
+
+    cvls_mem->thrfirst[tid] = jfirst;
+    cvls_mem->thrfail[tid]  = jfail;
+    cvls_mem->thrret[tid]   = ret;
+    cvls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (cvLsThreadRetval(cvls_mem, &cvls_mem->nfeDQ));
+}
+
+/*-----------------------------------------------------------------
+  cvLsBandDQJacOMP
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of f(t,y) with the column groups distributed
+  across dqnthreads OpenMP threads. Each thread perturbs its own
+  copy of y and the columns are formed exactly as in cvLsBandDQJac.
+  -----------------------------------------------------------------*/
+static int cvLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                            SUNMatrix Jac, CVodeMem cv_mem)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *ewt_data, *fy_data, *y_data, *cns_data;
+  sunindextype width, ngroups, N, mupper, mlower;
+  CVLsMem cvls_mem;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* per-thread work vectors */
+  if (cvLsThreadAlloc(cvls_mem, y))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+#pragma omp parallel num_threads(cvls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = cvls_mem->ythr[tid];
+    N_Vector ftemp   = cvls_mem->fythr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype* ftd = N_VGetArrayPointer(ftemp);
+    sunrealtype *col_j, inc, inc_inv;
+    sunindextype group, i, j, i1, i2;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (group = 0; group < ngroups; group++)
+    {
+      /* skip the remaining groups of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = group; }
+
+      /* Increment all y_j in group */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] += cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur,
+                            minInc);
+      }
+
+      ier = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
+      nfe++;
+      if (ier != 0)
+      {
+        jfail = group;
+        ret   = ier;
+        continue;
+      }
+
+      /* Restore ytemp, then form and load difference quotients */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] = y_data[j];
+        col_j  = SUNBandMatrix_Column(Jac, j);
+        inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv * (ftd[i] - fy_data[i]);
+        }
+      }
+    }
+
+    cvls_mem->thrfirst[tid] = jfirst;
+    cvls_mem->thrfail[tid]  = jfail;
+    cvls_mem->thrret[tid]   = ret;
+    cvls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (cvLsThreadRetval(cvls_mem, &cvls_mem->nfeDQ));
+}
+
+/*-----------------------------------------------------------------
+  cvLsThreadAlloc
+
+  This routine allocates the per-thread work vectors (if needed)
+  and resets the per-thread failure flags and counters.
+  -----------------------------------------------------------------*/
+static int cvLsThreadAlloc(CVLsMem cvls_mem, N_Vector tmpl)
+{
+  int nt = cvls_mem->dqnthreads;
+  int k;
+
+  if (cvls_mem->nthrvecs < nt)
+  {
+    cvLsThreadFree(cvls_mem);
+
+    cvls_mem->ythr     = N_VCloneVectorArray(nt, tmpl);
+    cvls_mem->fythr    = N_VCloneVectorArray(nt, tmpl);
+    cvls_mem->colthr   = N_VCloneEmptyVectorArray(nt, tmpl);
+    cvls_mem->thrfirst = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    cvls_mem->thrfail  = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    cvls_mem->thrret   = (int*)malloc(nt * sizeof(int));
+    cvls_mem->thrnfe   = (long int*)malloc(nt * sizeof(long int));
+    cvls_mem->nthrvecs = nt;
+    if (cvls_mem->ythr == NULL || cvls_mem->fythr == NULL ||
+        cvls_mem->colthr == NULL || cvls_mem->thrfail == NULL ||
+        cvls_mem->thrret == NULL || cvls_mem->thrnfe == NULL || cvls_mem->thrfirst == NULL)
+    {
+      cvLsThreadFree(cvls_mem);
+      return (-1);
+    }
+  }
+
+  for (k = 0; k < nt; k++)
+  {
+    cvls_mem->thrfirst[k] = -1;
+    cvls_mem->thrfail[k]  = -1;
+    cvls_mem->thrret[k]   = 0;
+    cvls_mem->thrnfe[k]   = 0;
+  }
+
+  return (0);
+}
+
+/*-----------------------------------------------------------------
+  cvLsThreadRetval
+
+  This routine adds the per-thread RHS evaluations to nfeDQ and
+  returns the RHS return value for the first failed column (or
+  group), i.e., the value the serial loop would return.
+  -----------------------------------------------------------------*/
+static int cvLsThreadRetval(CVLsMem cvls_mem, long int* nfeDQ)
+{
+  sunindextype jfail = -1;
+  int k, retval      = 0;
+
+  /* first failed column (or group) over all threads */
+  for (k = 0; k < cvls_mem->dqnthreads; k++)
+  {
+    if (cvls_mem->thrfail[k] >= 0 &&
+        (jfail < 0 || cvls_mem->thrfail[k] < jfail))
+    {
+      jfail  = cvls_mem->thrfail[k];
+      retval = cvls_mem->thrret[k];
+    }
+  }
+
+  /* the serial loop stops after the failed evaluation, so only the
+     threads whose block starts at or before it are counted */
+  for (k = 0; k < cvls_mem->dqnthreads; k++)
+  {
+    if (cvls_mem->thrfirst[k] >= 0 &&
+        (jfail < 0 || cvls_mem->thrfirst[k] <= jfail))
+    {
+      *nfeDQ += cvls_mem->thrnfe[k];
+    }
+  }
+
+  return (retval);
+}
+
+#endif
+
+/*-----------------------------------------------------------------
+  cvLsThreadFree
+
+  This routine frees the per-thread work vectors.
+  -----------------------------------------------------------------*/
+static void cvLsThreadFree(CVLsMem cvls_mem)
+{
+  if (cvls_mem->ythr)
+  {
+    N_VDestroyVectorArray(cvls_mem->ythr, cvls_mem->nthrvecs);
+  }
+  if (cvls_mem->fythr)
+  {
+    N_VDestroyVectorArray(cvls_mem->fythr, cvls_mem->nthrvecs);
+  }
+  if (cvls_mem->colthr)
+  {
+    N_VDestroyVectorArray(cvls_mem->colthr, cvls_mem->nthrvecs);
+  }
+  free(cvls_mem->thrfirst);
+  free(cvls_mem->thrfail);
+  free(cvls_mem->thrret);
+  free(cvls_mem->thrnfe);
+  cvls_mem->ythr     = NULL;
+  cvls_mem->fythr    = NULL;
+  cvls_mem->colthr   = NULL;
+  cvls_mem->thrfirst = NULL;
+  cvls_mem->thrfail  = NULL;
+  cvls_mem->thrret   = NULL;
+  cvls_mem->thrnfe   = NULL;
+  cvls_mem->nthrvecs = 0;
+}
+
 /*-----------------------------------------------------------------
   cvLsDQJtimes
 
@@ -1536,6 +2251,8 @@ int cvLsSetup(CVodeMem cv_mem, int convfail, N_Vector ypred, N_Vector fpred,
 {
   CVLsMem cvls_mem;
   sunrealtype dgamma;
+  sunbooleantype costmodel;
+  double wstart = 0.0;
   int retval;
 
   /* access CVLsMem structure */
@@ -1559,13 +2276,29 @@ int cvLsSetup(CVodeMem cv_mem, int convfail, N_Vector ypred, N_Vector fpred,
   cvls_mem->fcur = fpred;
 
   /* Use nst, gamma/gammap, and convfail to set J/P eval. flag jok */
+  costmodel      = (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL);
   dgamma         = SUNRabs((cv_mem->cv_gamma / cv_mem->cv_gammap) - ONE);
   cvls_mem->jbad = (cv_mem->cv_nst == 0) ||
-                   (cv_mem->cv_nst >= cvls_mem->nstlj + cvls_mem->msbj) ||
                    ((convfail == CV_FAIL_BAD_J) &&
                     (dgamma < cvls_mem->dgmax_jbad)) ||
                    (convfail == CV_FAIL_OTHER);
 
+  /* With the cost model the update frequency is replaced by its request */
+  if (costmodel)
+  {
+    if (!cvls_mem->jbad && cv_mem->cv_lsp_jac)
+    {
+      cvls_mem->jbad = SUNTRUE;
+      cv_mem->cv_lsp_njevals++;
+    }
+    wstart = sunWallClockTime();
+  }
+  else
+  {
+    cvls_mem->jbad = cvls_mem->jbad ||
+                     (cv_mem->cv_nst >= cvls_mem->nstlj + cvls_mem->msbj);
+  }
+
   /* Setup the linear system if necessary */
   if (cvls_mem->A != NULL)
   {
@@ -1580,6 +2313,7 @@ int cvLsSetup(CVodeMem cv_mem, int convfail, N_Vector ypred, N_Vector fpred,
       cvls_mem->nje++;
       cvls_mem->nstlj = cv_mem->cv_nst;
       cvls_mem->tnlj  = cv_mem->cv_tn;
+      if (costmodel) { cv_mem->cv_lsp_tjac += sunWallClockTime() - wstart; }
     }
 
     /* Check linsys() return value and return if necessary */
@@ -1622,6 +2356,7 @@ int cvLsSetup(CVodeMem cv_mem, int convfail, N_Vector ypred, N_Vector fpred,
       cvls_mem->npe++;
       cvls_mem->nstlj = cv_mem->cv_nst;
       cvls_mem->tnlj  = cv_mem->cv_tn;
+      if (costmodel) { cv_mem->cv_lsp_tjac += sunWallClockTime() - wstart; }
     }
 
     /* Update jcur flag if we suggested an update */
@@ -1880,6 +2615,10 @@ int cvLsFree(CVodeMem cv_mem)
     cvls_mem->savedJ = NULL;
   }
 
+  /* Free batched RHS and per-thread vectors */
+  cvLsBatchFree(cvls_mem);
+  cvLsThreadFree(cvls_mem);
+
   /* Nullify other N_Vector pointers */
   cvls_mem->ycur = NULL;
   cvls_mem->fcur = NULL;
@@ -36,10 +36,13 @@ extern "C" {
   CVLS_EPLIN  default value for factor by which the tolerance on
               the nonlinear iteration is multiplied to get a
               tolerance on the linear iteration
+  CVLS_MAX_BATCH  default maximum number of states passed to the
+              batched RHS function in one call
   -----------------------------------------------------------------*/
-#define CVLS_MSBJ  51
-#define CVLS_DGMAX SUN_RCONST(0.2)
-#define CVLS_EPLIN SUN_RCONST(0.05)
+#define CVLS_MSBJ      51
+#define CVLS_DGMAX     SUN_RCONST(0.2)
+#define CVLS_EPLIN     SUN_RCONST(0.05)
+#define CVLS_MAX_BATCH 32
 
 /*-----------------------------------------------------------------
   Types : CVLsMemRec, CVLsMem
@@ -126,6 +129,24 @@ typedef struct CVLsMemRec
   CVLsLinSysFn linsys;
   void* A_data;
 
+  /* Batched RHS used by the DQ Jacobian approximations (may be NULL) */
+  CVLsBatchRhsFn fbatch;
+  int max_batch;     /* max states per call, INT_MAX for all columns   */
+  int nbatch;        /* number of allocated batch vectors              */
+  N_Vector* ybatch;  /* perturbed states                               */
+  N_Vector* fybatch; /* RHS values at the perturbed states             */
+
+  /* Thread-parallel DQ Jacobian approximations (OpenMP builds only) */
+  int dqnthreads;         /* number of threads, <= 1 for the serial loop      */
+  int nthrvecs;           /* number of allocated per-thread work vectors      */
+  N_Vector* ythr;         /* per-thread perturbed states                      */
+  N_Vector* fythr;        /* per-thread RHS values                            */
+  N_Vector* colthr;       /* per-thread (empty) dense matrix columns          */
+  sunindextype* thrfirst; /* per-thread first column (or group)               */
+  sunindextype* thrfail;  /* per-thread failed column (or group)              */
+  int* thrret;            /* per-thread RHS return value at that column       */
+  long int* thrnfe;       /* per-thread number of RHS evaluations             */
+
   int last_flag; /* last error flag returned by any function */
 
 }* CVLsMem;
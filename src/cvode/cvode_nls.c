@@ -16,19 +16,25 @@
 
 #include "cvode_impl.h"
 #include "sundials/sundials_math.h"
+#include "sundials_utils.h"
+#include "sunnonlinsol/sunnonlinsol_fixedpoint.h"
 
 /* constant macros */
-#define ONE SUN_RCONST(1.0) /* real 1.0 */
+#define ZERO SUN_RCONST(0.0) /* real 0.0 */
+#define ONE  SUN_RCONST(1.0) /* real 1.0 */
 
 /* nonlinear solver constants
      NLS_MAXCOR  maximum no. of corrector iterations for the nonlinear solver
      CRDOWN      constant used in the estimation of the convergence rate (crate)
                  of the iterates for the nonlinear equation
      RDIV        declare divergence if ratio del/delp > RDIV
+     LSP_JAC_RATIO  maximum ratio of the Newton time to the Jacobian update
+                 time between cost model Jacobian updates
  */
-#define NLS_MAXCOR 3
-#define CRDOWN     SUN_RCONST(0.3)
-#define RDIV       SUN_RCONST(2.0)
+#define NLS_MAXCOR    3
+#define CRDOWN        SUN_RCONST(0.3)
+#define RDIV          SUN_RCONST(2.0)
+#define LSP_JAC_RATIO 10.0
 
 /* private functions */
 static int cvNlsResidual(N_Vector ycor, N_Vector res, void* cvode_mem);
@@ -65,6 +71,15 @@ int CVodeSetNonlinearSolver(void* cvode_mem, SUNNonlinearSolver NLS)
     return (CV_ILL_INPUT);
   }
 
+  /* the solvers are managed by CVODE while switching methods */
+  if (cv_mem->cv_lmm_switch)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "The nonlinear solver cannot be changed while method "
+                   "switching is enabled");
+    return (CV_ILL_INPUT);
+  }
+
   /* check for required nonlinear solver functions */
   if (NLS->ops->gettype == NULL || NLS->ops->solve == NULL ||
       NLS->ops->setsysfn == NULL)
@@ -201,10 +216,160 @@ int CVodeGetNonlinearSystemData(void* cvode_mem, sunrealtype* tcur,
   return (CV_SUCCESS);
 }
 
+/*---------------------------------------------------------------
+  CVodeSetMethodSwitching:
+
+  This routine enables or disables automatic switching between
+  Adams steps with fixed-point iteration and BDF steps with Newton
+  iteration. The attached (Newton) nonlinear solver is used for
+  BDF steps and a fixed-point solver is created for Adams steps.
+  ---------------------------------------------------------------*/
+int CVodeSetMethodSwitching(void* cvode_mem, sunbooleantype onoff)
+{
+  CVodeMem cv_mem;
+  SUNNonlinearSolver NLS;
+  int retval;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+  cv_mem = (CVodeMem)cvode_mem;
+
+  if (!cv_mem->cv_MallocDone)
+  {
+    cvProcessError(cv_mem, CV_NO_MALLOC, __LINE__, __func__, __FILE__,
+                   MSGCV_NO_MALLOC);
+    return (CV_NO_MALLOC);
+  }
+
+  if (onoff == cv_mem->cv_lmm_switch) { return (CV_SUCCESS); }
+
+  if (!onoff)
+  {
+    /* make the Newton solver active, free the fixed-point solver, and return
+       to the method selected at creation */
+    if (cv_mem->cv_lmm == CV_ADAMS)
+    {
+      NLS              = cv_mem->NLS;
+      cv_mem->NLS      = cv_mem->NLSsw;
+      cv_mem->NLSsw    = NLS;
+      cv_mem->ownNLS   = cv_mem->ownNLSsw;
+      cv_mem->ownNLSsw = SUNTRUE;
+    }
+    if (cv_mem->ownNLSsw) { SUNNonlinSolFree(cv_mem->NLSsw); }
+    cv_mem->NLSsw    = NULL;
+    cv_mem->ownNLSsw = SUNFALSE;
+
+    cv_mem->cv_lmm        = cv_mem->cv_lmm_start;
+    cv_mem->cv_qmax       = (cv_mem->cv_lmm == CV_BDF)
+                              ? SUNMIN(cv_mem->cv_lmm_qmax, BDF_Q_MAX)
+                              : cv_mem->cv_lmm_qmax;
+    cv_mem->cv_lmm_switch = SUNFALSE;
+
+    return (cvNlsInit(cv_mem));
+  }
+
+  if (SUNNonlinSolGetType(cv_mem->NLS) != SUNNONLINEARSOLVER_ROOTFIND)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "Method switching requires a Newton-type nonlinear solver");
+    return (CV_ILL_INPUT);
+  }
+
+  /* create the fixed-point solver for Adams steps */
+  NLS = SUNNonlinSol_FixedPoint(cv_mem->cv_ewt, 0, cv_mem->cv_sunctx);
+  if (NLS == NULL)
+  {
+    cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSGCV_MEM_FAIL);
+    return (CV_MEM_FAIL);
+  }
+
+  retval = SUNNonlinSolSetSysFn(NLS, cvNlsFPFunction);
+  if (retval == SUN_SUCCESS)
+  {
+    retval = SUNNonlinSolSetConvTestFn(NLS, cvNlsConvTest, cvode_mem);
+  }
+  if (retval == SUN_SUCCESS)
+  {
+    retval = SUNNonlinSolSetMaxIters(NLS, NLS_MAXCOR);
+  }
+  if (retval != SUN_SUCCESS)
+  {
+    SUNNonlinSolFree(NLS);
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "Setting up the fixed-point nonlinear solver failed");
+    return (CV_ILL_INPUT);
+  }
+
+  cv_mem->cv_lmm_switch  = SUNTRUE;
+  cv_mem->cv_lmm_start   = cv_mem->cv_lmm;
+  cv_mem->cv_lmm_qmax    = cv_mem->cv_qmax;
+  cv_mem->cv_lmm_jbad    = SUNFALSE;
+  cv_mem->cv_lmm_probe   = SUNFALSE;
+  cv_mem->cv_lmm_lip     = ZERO;
+  cv_mem->cv_lmm_nstsw   = cv_mem->cv_nst;
+  cv_mem->cv_lmm_nstab   = 0;
+  cv_mem->cv_lmm_nswitch = 0;
+  cv_mem->cv_lmm_nst[0] = cv_mem->cv_lmm_nst[1] = 0;
+  cv_mem->cv_lmm_time[0] = cv_mem->cv_lmm_time[1] = ZERO;
+
+  /* Adams steps use the fixed-point solver */
+  if (cv_mem->cv_lmm == CV_ADAMS)
+  {
+    cv_mem->NLSsw    = cv_mem->NLS;
+    cv_mem->ownNLSsw = cv_mem->ownNLS;
+    cv_mem->NLS      = NLS;
+    cv_mem->ownNLS   = SUNTRUE;
+    return (cvNlsInit(cv_mem));
+  }
+
+  cv_mem->NLSsw    = NLS;
+  cv_mem->ownNLSsw = SUNTRUE;
+
+  return (CV_SUCCESS);
+}
+
 /* -----------------------------------------------------------------------------
  * Private functions
  * ---------------------------------------------------------------------------*/
 
+/* -----------------------------------------------------------------------------
+ * cvNlsSwitchMethod
+ *
+ * Switches to the linear multistep method lmm by exchanging the active and the
+ * inactive nonlinear solvers and resetting the maximum order. The Nordsieck
+ * history array is the same for both methods and is kept unchanged.
+ * ---------------------------------------------------------------------------*/
+
+int cvNlsSwitchMethod(CVodeMem cv_mem, int lmm)
+{
+  SUNNonlinearSolver NLS;
+  sunbooleantype own;
+
+  if (lmm == cv_mem->cv_lmm) { return (CV_SUCCESS); }
+
+  NLS              = cv_mem->NLS;
+  own              = cv_mem->ownNLS;
+  cv_mem->NLS      = cv_mem->NLSsw;
+  cv_mem->ownNLS   = cv_mem->ownNLSsw;
+  cv_mem->NLSsw    = NLS;
+  cv_mem->ownNLSsw = own;
+
+  cv_mem->cv_lmm  = lmm;
+  cv_mem->cv_qmax = (lmm == CV_BDF) ? SUNMIN(cv_mem->cv_lmm_qmax, BDF_Q_MAX)
+                                    : cv_mem->cv_lmm_qmax;
+
+  /* the Jacobian is updated at the start of a BDF phase */
+  cv_mem->cv_lmm_jbad  = (lmm == CV_BDF);
+  cv_mem->cv_lmm_probe = SUNFALSE;
+  cv_mem->cv_lmm_nstab = 0;
+
+  return (cvNlsInit(cv_mem));
+}
+
 int cvNlsInit(CVodeMem cvode_mem)
 {
   int retval;
@@ -254,6 +419,9 @@ static int cvNlsLSetup(sunbooleantype jbad, sunbooleantype* jcur, void* cvode_me
 {
   CVodeMem cv_mem;
   int retval;
+  double wstart = 0.0;
+  double tjac   = 0.0;
+  double wsetup;
 
   if (cvode_mem == NULL)
   {
@@ -265,6 +433,28 @@ static int cvNlsLSetup(sunbooleantype jbad, sunbooleantype* jcur, void* cvode_me
   /* if the nonlinear solver marked the Jacobian as bad update convfail */
   if (jbad) { cv_mem->convfail = CV_FAIL_BAD_J; }
 
+  if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+  {
+    /* Request a Jacobian update if the Newton cost per unit of simulated
+       time in the last setup cycle exceeds the average cost (Jacobian
+       evaluation and Newton iterations) since the last update, i.e.,
+       reusing the Jacobian has become more expensive than updating it. The
+       setups themselves are not charged since they are needed either way. */
+    cv_mem->cv_lsp_jac = (cv_mem->cv_lsp_stime > ZERO) &&
+                         (cv_mem->cv_lsp_jtime > ZERO) &&
+                         (cv_mem->cv_lsp_snls * cv_mem->cv_lsp_jtime >
+                          cv_mem->cv_lsp_jcost * cv_mem->cv_lsp_stime);
+
+    /* An out-of-date Jacobian may also cost smaller steps rather than more
+       iterations, so an update is requested at the latest once the Newton
+       time since the last update is LSP_JAC_RATIO times the update cost */
+    cv_mem->cv_lsp_jac = cv_mem->cv_lsp_jac ||
+                         (cv_mem->cv_lsp_jcost - cv_mem->cv_lsp_jeval >
+                          LSP_JAC_RATIO * cv_mem->cv_lsp_jeval);
+    tjac   = cv_mem->cv_lsp_tjac;
+    wstart = sunWallClockTime();
+  }
+
   /* setup the linear solver */
   retval = cv_mem->cv_lsetup(cv_mem, cv_mem->convfail, cv_mem->cv_y,
                              cv_mem->cv_ftemp, &(cv_mem->cv_jcur),
@@ -272,9 +462,33 @@ static int cvNlsLSetup(sunbooleantype jbad, sunbooleantype* jcur, void* cvode_me
                              cv_mem->cv_vtemp3);
   cv_mem->cv_nsetups++;
 
+  /* start new setup (and Jacobian update) cycles in the cost model */
+  if (cv_mem->cv_lsetup_policy == CV_LSETUP_COST_MODEL)
+  {
+    wsetup = sunWallClockTime() - wstart;
+    cv_mem->cv_lsp_wsolve += wsetup;
+    cv_mem->cv_lsp_tsetup += wsetup;
+    cv_mem->cv_lsp_setup = SUNFALSE;
+    cv_mem->cv_lsp_scost = wsetup;
+    cv_mem->cv_lsp_snls  = 0.0;
+    cv_mem->cv_lsp_stime = ZERO;
+    if (cv_mem->cv_jcur)
+    {
+      cv_mem->cv_lsp_jcost = cv_mem->cv_lsp_tjac - tjac;
+      cv_mem->cv_lsp_jeval = cv_mem->cv_lsp_jcost;
+      cv_mem->cv_lsp_jtime = ZERO;
+    }
+  }
+
   /* update Jacobian status */
   *jcur = cv_mem->cv_jcur;
 
+  /* re-estimate the Lipschitz constant with the new Jacobian */
+  if (cv_mem->cv_lmm_switch && cv_mem->cv_jcur)
+  {
+    cv_mem->cv_lmm_probe = SUNTRUE;
+  }
+
   cv_mem->cv_gamrat = ONE;
   cv_mem->cv_gammap = cv_mem->cv_gamma;
   cv_mem->cv_crate  = ONE;
@@ -334,6 +548,15 @@ static int cvNlsConvTest(SUNNonlinearSolver NLS, N_Vector ycor, N_Vector delta,
   if (m > 0)
   {
     cv_mem->cv_crate = SUNMAX(CRDOWN * cv_mem->cv_crate, del / cv_mem->cv_delp);
+
+    /* the fixed-point iteration contracts at the rate gamma * L where L is
+       the Lipschitz constant of f, keep the largest estimate of L */
+    if (cv_mem->cv_lmm_switch && cv_mem->cv_lmm == CV_ADAMS)
+    {
+      cv_mem->cv_lmm_liptmp =
+        SUNMAX(cv_mem->cv_lmm_liptmp,
+               del / (cv_mem->cv_delp * SUNRabs(cv_mem->cv_gamma)));
+    }
   }
   dcon = del * SUNMIN(ONE, cv_mem->cv_crate) / tol;
 
@@ -29,6 +29,10 @@
 
 #include "cvodes_impl.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /*
  * =================================================================
  * CVODEA PRIVATE CONSTANTS
@@ -55,9 +59,19 @@
 
 static CVckpntMem CVAckpntInit(CVodeMem cv_mem);
 static CVckpntMem CVAckpntNew(CVodeMem cv_mem);
-static void CVAckpntDelete(CVckpntMem* ck_memPtr);
+static void CVAckpntDelete(CVodeMem cv_mem, CVckpntMem* ck_memPtr);
 
 static void CVAbckpbDelete(CVodeBMem* cvB_memPtr);
+static sunbooleantype CVAbckpbIsActive(CVodeBMem cvB_mem, CVckpntMem ck_mem,
+                                       sunrealtype tBout, int itaskB, int sign);
+static int CVAbckpbShadow(CVodeMem cv_mem, CVodeBMem cvB_mem);
+static int CVAbckpbSolveConcurrent(CVodeMem cv_mem, CVckpntMem ck_mem,
+                                   sunrealtype tBout, int itaskB, int sign,
+                                   CVodeBMem* failed);
+
+static void CVAckpntThin(CVodeMem cv_mem, int nkeep, CVckpntMem ck_keep);
+static int CVAckpntRefine(CVodeMem cv_mem, CVckpntMem* ck_memPtr);
+static long int CVArevolveSplit(long int nblocks, long int snaps);
 
 static int CVAdataStore(CVodeMem cv_mem, CVckpntMem ck_mem);
 static int CVAckpntGet(CVodeMem cv_mem, CVckpntMem ck_mem);
@@ -159,6 +173,10 @@ int CVodeAdjInit(void* cvode_mem, long int steps, int interp)
   /* Initialize nckpnts to ZERO */
   ca_mem->ca_nckpnts = 0;
 
+  /* Keep all check points */
+  ca_mem->ca_ckmax    = 0;
+  ca_mem->ca_nstfinal = 0;
+
   /* No interpolation data is available */
   ca_mem->ca_ckpntData = NULL;
 
@@ -214,6 +232,11 @@ int CVodeAdjInit(void* cvode_mem, long int steps, int interp)
     }
   }
 
+  sunMemAccountAlloc(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct CVadjMemRec) +
+                       (steps + 1) * (sizeof(struct CVdtpntMemRec*) +
+                                      sizeof(struct CVdtpntMemRec)));
+
   /* Attach functions for the appropriate interpolation module */
 
   switch (interp)
@@ -258,6 +281,10 @@ int CVodeAdjInit(void* cvode_mem, long int steps, int interp)
   ca_mem->ca_bckpbCrt = NULL;
   ca_mem->ca_nbckpbs  = 0;
 
+  /* Integrate backward problems one after another */
+  ca_mem->ca_nthreads = 1;
+  ca_mem->ca_active   = NULL;
+
   /* --------------------------------
    * CVodeF and CVodeB not called yet
    * -------------------------------- */
@@ -322,7 +349,7 @@ int CVodeAdjReInit(void* cvode_mem)
 
   /* Free current list of Check Points */
 
-  while (ca_mem->ck_mem != NULL) { CVAckpntDelete(&(ca_mem->ck_mem)); }
+  while (ca_mem->ck_mem != NULL) { CVAckpntDelete(cv_mem, &(ca_mem->ck_mem)); }
 
   /* Initialization of check points */
 
@@ -360,7 +387,7 @@ void CVodeAdjFree(void* cvode_mem)
     ca_mem = cv_mem->cv_adj_mem;
 
     /* Delete check points one by one */
-    while (ca_mem->ck_mem != NULL) { CVAckpntDelete(&(ca_mem->ck_mem)); }
+    while (ca_mem->ck_mem != NULL) { CVAckpntDelete(cv_mem, &(ca_mem->ck_mem)); }
 
     /* Free vectors at all data points */
     if (ca_mem->ca_IMmallocDone) { ca_mem->ca_IMfree(cv_mem); }
@@ -374,8 +401,15 @@ void CVodeAdjFree(void* cvode_mem)
 
     /* Delete backward problems one by one */
     while (ca_mem->cvB_mem != NULL) { CVAbckpbDelete(&(ca_mem->cvB_mem)); }
+    free(ca_mem->ca_active);
+    ca_mem->ca_active = NULL;
 
     /* Free CVODEA memory */
+    sunMemAccountFree(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                      sizeof(struct CVadjMemRec) +
+                        (ca_mem->ca_nsteps + 1) *
+                          (sizeof(struct CVdtpntMemRec*) +
+                           sizeof(struct CVdtpntMemRec)));
     free(ca_mem);
     cv_mem->cv_adj_mem = NULL;
   }
@@ -579,7 +613,8 @@ int CVodeF(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
 
     if (cv_mem->cv_nst % ca_mem->ca_nsteps == 0)
     {
-      ca_mem->ck_mem->ck_t1 = cv_mem->cv_tn;
+      ca_mem->ck_mem->ck_t1   = cv_mem->cv_tn;
+      ca_mem->ck_mem->ck_nst1 = cv_mem->cv_nst;
 
       /* Create a new check point, load it, and append it to the list */
       tmp = CVAckpntNew(cv_mem);
@@ -595,6 +630,12 @@ int CVodeF(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
       ca_mem->ca_nckpnts++;
       cv_mem->cv_forceSetup = SUNTRUE;
 
+      /* With a check point budget, release a check point to make room */
+      if (ca_mem->ca_ckmax > 0)
+      {
+        CVAckpntThin(cv_mem, ca_mem->ca_ckmax, ca_mem->ck_mem);
+      }
+
       /* Reset i=0 and load dt_mem[0] */
       dt_mem[0]->t = ca_mem->ck_mem->ck_t0;
       ca_mem->ca_IMstore(cv_mem, dt_mem[0]);
@@ -609,10 +650,12 @@ int CVodeF(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
     /* Set t1 field of the current check point structure
        for the case in which there will be no future
        check points */
-    ca_mem->ck_mem->ck_t1 = cv_mem->cv_tn;
+    ca_mem->ck_mem->ck_t1   = cv_mem->cv_tn;
+    ca_mem->ck_mem->ck_nst1 = cv_mem->cv_nst;
 
     /* tfinal is now set to tn */
-    ca_mem->ca_tfinal = cv_mem->cv_tn;
+    ca_mem->ca_tfinal   = cv_mem->cv_tn;
+    ca_mem->ca_nstfinal = cv_mem->cv_nst;
 
     /* Return if in CV_ONE_STEP mode */
     if (itask == CV_ONE_STEP) { break; }
@@ -668,7 +711,9 @@ int CVodeCreateB(void* cvode_mem, int lmmB, int* which)
   CVodeMem cv_mem;
   CVadjMem ca_mem;
   CVodeBMem new_cvB_mem;
+  CVodeBMem* active;
   void* cvodeB_mem;
+  int i;
 
   /* Check if cvode_mem exists */
   if (cvode_mem == NULL)
@@ -707,12 +752,52 @@ int CVodeCreateB(void* cvode_mem, int lmmB, int* which)
     return (CV_MEM_FAIL);
   }
 
-  CVodeSetUserData(cvodeB_mem, cvode_mem);
-
   CVodeSetMaxHnilWarns(cvodeB_mem, -1);
 
   /* Set/initialize fields in the new CVodeBMem object, new_cvB_mem */
 
+  new_cvB_mem->cv_fwd_mem   = NULL;
+  new_cvB_mem->cv_fwd_adj   = NULL;
+  new_cvB_mem->cv_fwd_cvals = NULL;
+  new_cvB_mem->cv_fwd_ytmp  = NULL;
+  new_cvB_mem->cv_fwd_yStmp = NULL;
+  for (i = 0; i < L_MAX; i++)
+  {
+    new_cvB_mem->cv_fwd_Y[i]  = NULL;
+    new_cvB_mem->cv_fwd_YS[i] = NULL;
+  }
+  new_cvB_mem->cv_fwd_nY = 0;
+  new_cvB_mem->cv_fwd_Ns = 0;
+  new_cvB_mem->cv_flag   = CV_SUCCESS;
+
+  if (ca_mem->ca_nthreads > 1)
+  {
+    /* The wrapper functions of a backward problem integrated concurrently
+     * get private copies of the forward memory as user data */
+    new_cvB_mem->cv_fwd_mem = (CVodeMem)malloc(sizeof(struct CVodeMemRec));
+    new_cvB_mem->cv_fwd_adj = (CVadjMem)malloc(sizeof(struct CVadjMemRec));
+    active = (CVodeBMem*)realloc(ca_mem->ca_active,
+                                 (ca_mem->ca_nbckpbs + 1) * sizeof(CVodeBMem));
+    if (active != NULL) { ca_mem->ca_active = active; }
+    if ((new_cvB_mem->cv_fwd_mem == NULL) ||
+        (new_cvB_mem->cv_fwd_adj == NULL) || (active == NULL))
+    {
+      free(new_cvB_mem->cv_fwd_mem);
+      free(new_cvB_mem->cv_fwd_adj);
+      free(new_cvB_mem);
+      CVodeFree(&cvodeB_mem);
+      cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                     MSGCV_MEM_FAIL);
+      return (CV_MEM_FAIL);
+    }
+    *(new_cvB_mem->cv_fwd_mem)           = *cv_mem;
+    *(new_cvB_mem->cv_fwd_adj)           = *ca_mem;
+    new_cvB_mem->cv_fwd_mem->cv_adj_mem = new_cvB_mem->cv_fwd_adj;
+
+    CVodeSetUserData(cvodeB_mem, new_cvB_mem->cv_fwd_mem);
+  }
+  else { CVodeSetUserData(cvodeB_mem, cvode_mem); }
+
   new_cvB_mem->cv_index = ca_mem->ca_nbckpbs;
 
   new_cvB_mem->cv_mem = (CVodeMem)cvodeB_mem;
@@ -1494,12 +1579,33 @@ int CVodeB(void* cvode_mem, sunrealtype tBout, int itaskB)
     }
   }
 
+  /* With a check point budget, the check points behind the backward
+   * problems were deleted. If a backward problem was reinitialized
+   * past the newest check point, let it cover tfinal again. */
+
+  ck_mem = ca_mem->ck_mem;
+
+  if ((ca_mem->ca_ckmax > 0) &&
+      (sign * (ca_mem->ca_tfinal - ck_mem->ck_t1) > ZERO))
+  {
+    tmp_cvB_mem = cvB_mem;
+    while (tmp_cvB_mem != NULL)
+    {
+      if (sign * (tmp_cvB_mem->cv_mem->cv_tn - ck_mem->ck_t1) > ZERO)
+      {
+        ck_mem->ck_t1   = ca_mem->ca_tfinal;
+        ck_mem->ck_nst1 = ca_mem->ca_nstfinal;
+        if (ca_mem->ca_ckpntData == ck_mem) { ca_mem->ca_ckpntData = NULL; }
+        break;
+      }
+      tmp_cvB_mem = tmp_cvB_mem->cv_next;
+    }
+  }
+
   /* Loop through the check points and stop as soon as a backward
    * problem has its tn value behind the current check point's t0_
    * value (in the backward direction) */
 
-  ck_mem = ca_mem->ck_mem;
-
   gotCheckpoint = SUNFALSE;
 
   for (;;)
@@ -1542,6 +1648,13 @@ int CVodeB(void* cvode_mem, sunrealtype tBout, int itaskB)
 
     if (ck_mem != ca_mem->ca_ckpntData)
     {
+      /* With a check point budget, recompute check points first */
+      if (ca_mem->ca_ckmax > 0)
+      {
+        flag = CVAckpntRefine(cv_mem, &ck_mem);
+        if (flag != CV_SUCCESS) { break; }
+      }
+
       flag = CVAdataStore(cv_mem, ck_mem);
       if (flag != CV_SUCCESS) { break; }
     }
@@ -1549,52 +1662,46 @@ int CVodeB(void* cvode_mem, sunrealtype tBout, int itaskB)
     /* Loop through all backward problems and, if needed,
      * propagate their solution towards tBout */
 
-    tmp_cvB_mem = cvB_mem;
-    while (tmp_cvB_mem != NULL)
+    if (ca_mem->ca_nthreads > 1)
     {
-      /* Decide if current backward problem is "active" in this check point */
-
-      isActive = SUNTRUE;
-
-      tBn = tmp_cvB_mem->cv_mem->cv_tn;
-
-      if ((tBn == ck_mem->ck_t0) && (sign * (tBout - ck_mem->ck_t0) < ZERO))
-      {
-        isActive = SUNFALSE;
-      }
-      if ((tBn == ck_mem->ck_t0) && (itaskB == CV_ONE_STEP))
+      flag = CVAbckpbSolveConcurrent(cv_mem, ck_mem, tBout, itaskB, sign,
+                                     &tmp_cvB_mem);
+    }
+    else
+    {
+      tmp_cvB_mem = cvB_mem;
+      while (tmp_cvB_mem != NULL)
       {
-        isActive = SUNFALSE;
-      }
+        /* Decide if current backward problem is "active" in this check point */
+        isActive = CVAbckpbIsActive(tmp_cvB_mem, ck_mem, tBout, itaskB, sign);
 
-      if (sign * (tBn - ck_mem->ck_t0) < ZERO) { isActive = SUNFALSE; }
-
-      if (isActive)
-      {
-        /* Store the address of current backward problem memory
-         * in ca_mem to be used in the wrapper functions */
-        ca_mem->ca_bckpbCrt = tmp_cvB_mem;
+        if (isActive)
+        {
+          /* Store the address of current backward problem memory
+           * in ca_mem to be used in the wrapper functions */
+          ca_mem->ca_bckpbCrt = tmp_cvB_mem;
 
-        /* Integrate current backward problem */
-        CVodeSetStopTime(tmp_cvB_mem->cv_mem, ck_mem->ck_t0);
-        flag = CVode(tmp_cvB_mem->cv_mem, tBout, tmp_cvB_mem->cv_y, &tBret,
-                     itaskB);
+          /* Integrate current backward problem */
+          CVodeSetStopTime(tmp_cvB_mem->cv_mem, ck_mem->ck_t0);
+          flag = CVode(tmp_cvB_mem->cv_mem, tBout, tmp_cvB_mem->cv_y, &tBret,
+                       itaskB);
 
-        /* Set the time at which we will report solution and/or quadratures */
-        tmp_cvB_mem->cv_tout = tBret;
+          /* Set the time at which we will report solution and/or quadratures */
+          tmp_cvB_mem->cv_tout = tBret;
 
-        /* If an error occurred, exit while loop */
-        if (flag < 0) { break; }
-      }
-      else
-      {
-        flag                 = CV_SUCCESS;
-        tmp_cvB_mem->cv_tout = tBn;
-      }
+          /* If an error occurred, exit while loop */
+          if (flag < 0) { break; }
+        }
+        else
+        {
+          flag                 = CV_SUCCESS;
+          tmp_cvB_mem->cv_tout = tmp_cvB_mem->cv_mem->cv_tn;
+        }
 
-      /* Move to next backward problem */
+        /* Move to next backward problem */
 
-      tmp_cvB_mem = tmp_cvB_mem->cv_next;
+        tmp_cvB_mem = tmp_cvB_mem->cv_next;
+      }
     }
 
     /* If an error occurred, return now */
@@ -1790,10 +1897,12 @@ static CVckpntMem CVAckpntInit(CVodeMem cv_mem)
 
   /* Load ckdata from cv_mem */
   N_VScale(ONE, cv_mem->cv_zn[0], ck_mem->ck_zn[0]);
-  ck_mem->ck_t0  = cv_mem->cv_tn;
-  ck_mem->ck_nst = 0;
-  ck_mem->ck_q   = 1;
-  ck_mem->ck_h   = ZERO;
+  ck_mem->ck_t0   = cv_mem->cv_tn;
+  ck_mem->ck_t1   = cv_mem->cv_tn;
+  ck_mem->ck_nst  = 0;
+  ck_mem->ck_nst1 = 0;
+  ck_mem->ck_q    = 1;
+  ck_mem->ck_h    = ZERO;
 
   /* Do we need to carry quadratures */
   ck_mem->ck_quadr = cv_mem->cv_quadr && cv_mem->cv_errconQ;
@@ -1863,6 +1972,9 @@ static CVckpntMem CVAckpntInit(CVodeMem cv_mem)
   /* Next in list */
   ck_mem->ck_next = NULL;
 
+  sunMemAccountAlloc(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct CVckpntMemRec));
+
   return (ck_mem);
 }
 
@@ -2186,8 +2298,13 @@ static CVckpntMem CVAckpntNew(CVodeMem cv_mem)
   ck_mem->ck_eta       = cv_mem->cv_eta;
   ck_mem->ck_etamax    = cv_mem->cv_etamax;
   ck_mem->ck_t0        = cv_mem->cv_tn;
+  ck_mem->ck_t1        = cv_mem->cv_tn;
+  ck_mem->ck_nst1      = cv_mem->cv_nst;
   ck_mem->ck_saved_tq5 = cv_mem->cv_saved_tq5;
 
+  sunMemAccountAlloc(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct CVckpntMemRec));
+
   return (ck_mem);
 }
 
@@ -2198,7 +2315,7 @@ static CVckpntMem CVAckpntNew(CVodeMem cv_mem)
  * the new list head
  */
 
-static void CVAckpntDelete(CVckpntMem* ck_memPtr)
+static void CVAckpntDelete(CVodeMem cv_mem, CVckpntMem* ck_memPtr)
 {
   CVckpntMem tmp;
   int j;
@@ -2268,6 +2385,220 @@ static void CVAckpntDelete(CVckpntMem* ck_memPtr)
 
   free(tmp);
   tmp = NULL;
+  sunMemAccountFree(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct CVckpntMemRec));
+}
+
+/*
+ * CVAckpntThin
+ *
+ * This routine deletes check points until at most nkeep are left.
+ * The initial check point, ck_keep, and all check points newer than
+ * ck_keep are kept. Of the others, the one leaving the shortest
+ * merged interval is deleted first (the oldest one on ties), which
+ * keeps the remaining check points close to evenly spaced.
+ */
+
+static void CVAckpntThin(CVodeMem cv_mem, int nkeep, CVckpntMem ck_keep)
+{
+  CVadjMem ca_mem;
+  CVckpntMem tmp, older;
+  CVckpntMem *link, *dellink;
+  long int span, minspan;
+  int nck;
+
+  ca_mem = cv_mem->cv_adj_mem;
+
+  nck = 0;
+  for (tmp = ca_mem->ck_mem; tmp != NULL; tmp = tmp->ck_next) { nck++; }
+
+  while (nck > nkeep)
+  {
+    /* Find the check point to delete */
+    dellink = NULL;
+    minspan = 0;
+    link    = &(ck_keep->ck_next);
+    while ((*link != NULL) && ((*link)->ck_next != NULL))
+    {
+      span = (*link)->ck_nst1 - (*link)->ck_next->ck_nst;
+      if ((dellink == NULL) || (span <= minspan))
+      {
+        dellink = link;
+        minspan = span;
+      }
+      link = &((*link)->ck_next);
+    }
+    if (dellink == NULL) { return; }
+
+    /* The older neighbor takes over its interval */
+    tmp            = *dellink;
+    older          = tmp->ck_next;
+    older->ck_t1   = tmp->ck_t1;
+    older->ck_nst1 = tmp->ck_nst1;
+
+    if ((ca_mem->ca_ckpntData == tmp) || (ca_mem->ca_ckpntData == older))
+    {
+      ca_mem->ca_ckpntData = NULL;
+    }
+
+    CVAckpntDelete(cv_mem, dellink);
+    nck--;
+  }
+}
+
+/*
+ * CVAckpntRefine
+ *
+ * With a check point budget, the interval of the check point in
+ * *ck_memPtr may span more than Nd steps. This routine recomputes
+ * the forward solution from that check point and stores new check
+ * points until the interval containing the backward problems is at
+ * most Nd steps long, as needed by CVAdataStore. The check points
+ * behind the backward problems are deleted first and, if the budget
+ * is still used up, an older check point is deleted with
+ * CVAckpntThin. Each new check point is placed with the binomial
+ * (revolve) schedule for the number of free check points, which
+ * minimizes the number of recomputed steps for the remaining
+ * backward integration.
+ *
+ * Return values:
+ * CV_SUCCESS
+ * CV_REIFWD_FAIL
+ * CV_FWD_FAIL
+ * CV_MEM_FAIL
+ */
+
+static int CVAckpntRefine(CVodeMem cv_mem, CVckpntMem* ck_memPtr)
+{
+  CVadjMem ca_mem;
+  CVodeBMem tmp_cvB_mem;
+  CVckpntMem ck_mem, tmp;
+  sunrealtype tBmax, t;
+  long int nblocks, nstnew;
+  int flag, sign, nck;
+
+  ca_mem = cv_mem->cv_adj_mem;
+  ck_mem = *ck_memPtr;
+
+  sign = (ca_mem->ca_tfinal - ca_mem->ca_tinitial > ZERO) ? 1 : -1;
+
+  /* Latest time (in the forward direction) of all backward problems */
+  tBmax       = ca_mem->cvB_mem->cv_mem->cv_tn;
+  tmp_cvB_mem = ca_mem->cvB_mem->cv_next;
+  while (tmp_cvB_mem != NULL)
+  {
+    if (sign * (tmp_cvB_mem->cv_mem->cv_tn - tBmax) > ZERO)
+    {
+      tBmax = tmp_cvB_mem->cv_mem->cv_tn;
+    }
+    tmp_cvB_mem = tmp_cvB_mem->cv_next;
+  }
+
+  while (ck_mem->ck_nst1 - ck_mem->ck_nst > ca_mem->ca_nsteps)
+  {
+    /* Delete the check points behind the backward problems */
+    while (ca_mem->ck_mem != ck_mem)
+    {
+      if (ca_mem->ca_ckpntData == ca_mem->ck_mem)
+      {
+        ca_mem->ca_ckpntData = NULL;
+      }
+      CVAckpntDelete(cv_mem, &(ca_mem->ck_mem));
+    }
+
+    /* Make room for a new check point */
+    CVAckpntThin(cv_mem, ca_mem->ca_ckmax - 1, ck_mem);
+
+    nck = 0;
+    for (tmp = ca_mem->ck_mem; tmp != NULL; tmp = tmp->ck_next) { nck++; }
+
+    /* Step number of the new check point */
+    nblocks = (ck_mem->ck_nst1 - ck_mem->ck_nst + ca_mem->ca_nsteps - 1) /
+              ca_mem->ca_nsteps;
+    nstnew  = CVArevolveSplit(nblocks, (long int)(ca_mem->ca_ckmax - nck + 1));
+    nstnew  = ck_mem->ck_nst + nstnew * ca_mem->ca_nsteps;
+
+    /* Recompute the forward solution up to the new check point */
+    flag = CVAckpntGet(cv_mem, ck_mem);
+    if (flag != CV_SUCCESS) { return (CV_REIFWD_FAIL); }
+
+    if (ca_mem->ca_tstopCVodeFcall)
+    {
+      CVodeSetStopTime(cv_mem, ca_mem->ca_tstopCVodeF);
+    }
+
+    while (cv_mem->cv_nst < nstnew)
+    {
+      flag = CVode(cv_mem, ck_mem->ck_t1, ca_mem->ca_ytmp, &t, CV_ONE_STEP);
+      if (flag < 0) { return (CV_FWD_FAIL); }
+
+      /* CVodeF forced a setup after each check point */
+      if (cv_mem->cv_nst % ca_mem->ca_nsteps == 0)
+      {
+        cv_mem->cv_forceSetup = SUNTRUE;
+      }
+    }
+
+    /* Split the interval at the new check point */
+    tmp = CVAckpntNew(cv_mem);
+    if (tmp == NULL) { return (CV_MEM_FAIL); }
+
+    tmp->ck_t1      = ck_mem->ck_t1;
+    tmp->ck_nst1    = ck_mem->ck_nst1;
+    ck_mem->ck_t1   = tmp->ck_t0;
+    ck_mem->ck_nst1 = tmp->ck_nst;
+
+    tmp->ck_next   = ck_mem;
+    ca_mem->ck_mem = tmp;
+
+    /* Continue with the new interval if it contains backward problems */
+    if (sign * (tBmax - tmp->ck_t0) > ZERO) { ck_mem = tmp; }
+  }
+
+  *ck_memPtr = ck_mem;
+
+  return (CV_SUCCESS);
+}
+
+/*
+ * CVArevolveSplit
+ *
+ * This routine returns the number of intervals of Nd steps to
+ * advance before storing the next check point when reversing
+ * nblocks such intervals with snaps check points (including the one
+ * at the start), following the binomial schedule of revolve.
+ */
+
+static long int CVArevolveSplit(long int nblocks, long int snaps)
+{
+  long int reps, range, bino1, bino2, bino3, bino4, bino5, capo;
+
+  /* With a check point for every interval advance by one */
+  snaps = SUNMIN(snaps, nblocks);
+
+  /* Smallest number of repetitions reps such that the binomial
+     coefficient range = (snaps + reps choose snaps) >= nblocks */
+  reps  = 0;
+  range = 1;
+  while (range < nblocks)
+  {
+    reps++;
+    range = range * (reps + snaps) / reps;
+  }
+
+  bino1 = range * reps / (snaps + reps);
+  bino2 = (snaps > 1) ? bino1 * snaps / (snaps + reps - 1) : 1;
+  if (snaps == 1) { bino3 = 0; }
+  else { bino3 = (snaps > 2) ? bino2 * (snaps - 1) / (snaps + reps - 2) : 1; }
+  bino4 = bino2 * (reps - 1) / snaps;
+  if (snaps < 3) { bino5 = 0; }
+  else { bino5 = (reps > 1) ? bino3 * (snaps - 2) / reps : 1; }
+
+  if (nblocks <= bino1 + bino3) { capo = bino4; }
+  else if (nblocks >= range - bino5) { capo = bino1; }
+  else { capo = nblocks - bino2 - bino3; }
+
+  return (SUNMAX(1, SUNMIN(capo, nblocks - 1)));
 }
 
 /*
@@ -2280,6 +2611,7 @@ static void CVAbckpbDelete(CVodeBMem* cvB_memPtr)
 {
   CVodeBMem tmp;
   void* cvode_mem;
+  int i;
 
   if (*cvB_memPtr != NULL)
   {
@@ -2302,11 +2634,207 @@ static void CVAbckpbDelete(CVodeBMem* cvB_memPtr)
     /* Free workspace Nvector */
     N_VDestroy(tmp->cv_y);
 
+    /* Free the private forward memory of concurrent integration */
+    if (tmp->cv_fwd_ytmp != NULL) { N_VDestroy(tmp->cv_fwd_ytmp); }
+    if (tmp->cv_fwd_yStmp != NULL)
+    {
+      N_VDestroyVectorArray(tmp->cv_fwd_yStmp, tmp->cv_fwd_Ns);
+    }
+    for (i = 0; i < L_MAX; i++)
+    {
+      if (tmp->cv_fwd_Y[i] != NULL) { N_VDestroy(tmp->cv_fwd_Y[i]); }
+      if (tmp->cv_fwd_YS[i] != NULL)
+      {
+        N_VDestroyVectorArray(tmp->cv_fwd_YS[i], tmp->cv_fwd_Ns);
+      }
+    }
+    free(tmp->cv_fwd_cvals);
+    free(tmp->cv_fwd_adj);
+    free(tmp->cv_fwd_mem);
+
     free(tmp);
     tmp = NULL;
   }
 }
 
+/*
+ * CVAbckpbIsActive
+ *
+ * Decides if a backward problem has to be integrated in the check
+ * point ck_mem.
+ */
+
+static sunbooleantype CVAbckpbIsActive(CVodeBMem cvB_mem, CVckpntMem ck_mem,
+                                       sunrealtype tBout, int itaskB, int sign)
+{
+  sunrealtype tBn;
+
+  tBn = cvB_mem->cv_mem->cv_tn;
+
+  if ((tBn == ck_mem->ck_t0) && (sign * (tBout - ck_mem->ck_t0) < ZERO))
+  {
+    return (SUNFALSE);
+  }
+  if ((tBn == ck_mem->ck_t0) && (itaskB == CV_ONE_STEP)) { return (SUNFALSE); }
+
+  if (sign * (tBn - ck_mem->ck_t0) < ZERO) { return (SUNFALSE); }
+
+  return (SUNTRUE);
+}
+
+/*
+ * CVAbckpbShadow
+ *
+ * Refreshes the private copies of the forward CVODES and adjoint
+ * memory passed to the wrapper functions of a backward problem that
+ * is integrated concurrently with others. The copies share the
+ * check point and interpolation data of the forward problem, which
+ * are only read during the backward integration, but have their own
+ * interpolation and wrapper workspace. The workspace is allocated on
+ * first use.
+ */
+
+static int CVAbckpbShadow(CVodeMem cv_mem, CVodeBMem cvB_mem)
+{
+  CVadjMem ca_mem, ca_fwd;
+  CVodeMem cv_fwd;
+  int i, Ns;
+
+  ca_mem = cv_mem->cv_adj_mem;
+
+  if (cvB_mem->cv_fwd_ytmp == NULL)
+  {
+    /* Hermite interpolation uses 2 vectors, polynomial up to qmax+1 */
+    if (ca_mem->ca_IMtype == CV_HERMITE) { cvB_mem->cv_fwd_nY = 2; }
+    else { cvB_mem->cv_fwd_nY = cv_mem->cv_qmax + 1; }
+
+    cvB_mem->cv_fwd_ytmp = N_VClone(cv_mem->cv_tempv);
+    if (cvB_mem->cv_fwd_ytmp == NULL) { return (CV_MEM_FAIL); }
+
+    for (i = 0; i < cvB_mem->cv_fwd_nY; i++)
+    {
+      cvB_mem->cv_fwd_Y[i] = N_VClone(cv_mem->cv_tempv);
+      if (cvB_mem->cv_fwd_Y[i] == NULL) { return (CV_MEM_FAIL); }
+    }
+  }
+
+  if (ca_mem->ca_IMinterpSensi && (cvB_mem->cv_fwd_yStmp == NULL))
+  {
+    cvB_mem->cv_fwd_Ns = cv_mem->cv_Ns;
+
+    cvB_mem->cv_fwd_yStmp = N_VCloneVectorArray(cv_mem->cv_Ns,
+                                                cv_mem->cv_tempv);
+    if (cvB_mem->cv_fwd_yStmp == NULL) { return (CV_MEM_FAIL); }
+
+    for (i = 0; i < cvB_mem->cv_fwd_nY; i++)
+    {
+      cvB_mem->cv_fwd_YS[i] = N_VCloneVectorArray(cv_mem->cv_Ns,
+                                                  cv_mem->cv_tempv);
+      if (cvB_mem->cv_fwd_YS[i] == NULL) { return (CV_MEM_FAIL); }
+    }
+  }
+
+  if (cvB_mem->cv_fwd_cvals == NULL)
+  {
+    Ns                    = SUNMAX(cv_mem->cv_Ns, 1);
+    cvB_mem->cv_fwd_cvals = (sunrealtype*)malloc((Ns * L_MAX) *
+                                                 sizeof(sunrealtype));
+    if (cvB_mem->cv_fwd_cvals == NULL) { return (CV_MEM_FAIL); }
+  }
+
+  cv_fwd = cvB_mem->cv_fwd_mem;
+  ca_fwd = cvB_mem->cv_fwd_adj;
+
+  *cv_fwd            = *cv_mem;
+  *ca_fwd            = *ca_mem;
+  cv_fwd->cv_adj_mem = ca_fwd;
+  cv_fwd->cv_cvals   = cvB_mem->cv_fwd_cvals;
+
+  ca_fwd->ca_bckpbCrt  = cvB_mem;
+  ca_fwd->ca_IMnewData = SUNTRUE;
+  ca_fwd->ca_ytmp      = cvB_mem->cv_fwd_ytmp;
+  ca_fwd->ca_yStmp     = cvB_mem->cv_fwd_yStmp;
+  for (i = 0; i < L_MAX; i++)
+  {
+    ca_fwd->ca_Y[i]  = cvB_mem->cv_fwd_Y[i];
+    ca_fwd->ca_YS[i] = cvB_mem->cv_fwd_YS[i];
+  }
+
+  return (CV_SUCCESS);
+}
+
+/*
+ * CVAbckpbSolveConcurrent
+ *
+ * Integrates the backward problems that are active in the check
+ * point ck_mem concurrently. Returns the flag of the first failed
+ * problem, which is also returned in failed, or the flag the last
+ * problem in the list would return in a sequential integration.
+ */
+
+static int CVAbckpbSolveConcurrent(CVodeMem cv_mem, CVckpntMem ck_mem,
+                                   sunrealtype tBout, int itaskB, int sign,
+                                   CVodeBMem* failed)
+{
+  CVadjMem ca_mem;
+  CVodeBMem tmp_cvB_mem;
+  int i, nactive, flag;
+
+  ca_mem = cv_mem->cv_adj_mem;
+
+  /* Collect the active backward problems and refresh their private
+   * forward memory before any of them is integrated */
+
+  nactive = 0;
+
+  for (tmp_cvB_mem = ca_mem->cvB_mem; tmp_cvB_mem != NULL;
+       tmp_cvB_mem = tmp_cvB_mem->cv_next)
+  {
+    tmp_cvB_mem->cv_flag = CV_SUCCESS;
+
+    if (CVAbckpbIsActive(tmp_cvB_mem, ck_mem, tBout, itaskB, sign))
+    {
+      flag = CVAbckpbShadow(cv_mem, tmp_cvB_mem);
+      if (flag != CV_SUCCESS)
+      {
+        *failed = tmp_cvB_mem;
+        return (flag);
+      }
+      ca_mem->ca_active[nactive++] = tmp_cvB_mem;
+    }
+    else { tmp_cvB_mem->cv_tout = tmp_cvB_mem->cv_mem->cv_tn; }
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#pragma omp parallel for schedule(dynamic, 1) num_threads(ca_mem->ca_nthreads)
+#endif
+  for (i = 0; i < nactive; i++)
+  {
+    CVodeBMem cvB_mem = ca_mem->ca_active[i];
+    sunrealtype tBret = cvB_mem->cv_mem->cv_tn;
+
+    CVodeSetStopTime(cvB_mem->cv_mem, ck_mem->ck_t0);
+    cvB_mem->cv_flag = CVode(cvB_mem->cv_mem, tBout, cvB_mem->cv_y, &tBret,
+                             itaskB);
+    cvB_mem->cv_tout = tBret;
+  }
+
+  flag = CV_SUCCESS;
+
+  for (tmp_cvB_mem = ca_mem->cvB_mem; tmp_cvB_mem != NULL;
+       tmp_cvB_mem = tmp_cvB_mem->cv_next)
+  {
+    flag = tmp_cvB_mem->cv_flag;
+    if (flag < 0)
+    {
+      *failed = tmp_cvB_mem;
+      break;
+    }
+  }
+
+  return (flag);
+}
+
 /*
  * =================================================================
  * PRIVATE FUNCTIONS FOR INTERPOLATION
@@ -78,6 +78,85 @@ int CVodeSetAdjNoSensi(void* cvode_mem)
   return (CV_SUCCESS);
 }
 
+int CVodeSetAdjMaxCheckpoints(void* cvode_mem, int maxck)
+{
+  CVodeMem cv_mem;
+  CVadjMem ca_mem;
+
+  /* Check if cvode_mem exists */
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+  cv_mem = (CVodeMem)cvode_mem;
+
+  /* Was ASA initialized? */
+  if (cv_mem->cv_adjMallocDone == SUNFALSE)
+  {
+    cvProcessError(cv_mem, CV_NO_ADJ, __LINE__, __func__, __FILE__, MSGCV_NO_ADJ);
+    return (CV_NO_ADJ);
+  }
+  ca_mem = cv_mem->cv_adj_mem;
+
+  /* Besides the initial and the newest check point, at least one more is
+     needed to recompute check points in the backward integration */
+  if ((maxck < 0) || (maxck == 1) || (maxck == 2))
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_BAD_CKMAX);
+    return (CV_ILL_INPUT);
+  }
+
+  ca_mem->ca_ckmax = maxck;
+
+  return (CV_SUCCESS);
+}
+
+int CVodeSetAdjNumThreads(void* cvode_mem, int nthreads)
+{
+  CVodeMem cv_mem;
+  CVadjMem ca_mem;
+
+  /* Check if cvode_mem exists */
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+  cv_mem = (CVodeMem)cvode_mem;
+
+  /* Was ASA initialized? */
+  if (cv_mem->cv_adjMallocDone == SUNFALSE)
+  {
+    cvProcessError(cv_mem, CV_NO_ADJ, __LINE__, __func__, __FILE__, MSGCV_NO_ADJ);
+    return (CV_NO_ADJ);
+  }
+  ca_mem = cv_mem->cv_adj_mem;
+
+  /* The wrapper functions of a backward problem get their user data when the
+     problem is created */
+  if (ca_mem->ca_nbckpbs > 0)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_BAD_NTHREADS);
+    return (CV_ILL_INPUT);
+  }
+
+#if !defined(SUNDIALS_OPENMP_ENABLED)
+  if (nthreads > 1)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_NO_OPENMP);
+    return (CV_ILL_INPUT);
+  }
+#endif
+
+  ca_mem->ca_nthreads = (nthreads > 1) ? nthreads : 1;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * -----------------------------------------------------------------
  * Optional input functions for backward integration
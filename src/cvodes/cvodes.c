@@ -193,9 +193,14 @@
 #include <sunnonlinsol/sunnonlinsol_newton.h>
 
 #include "cvodes_impl.h"
+#include "cvodes_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
 #include "sundials/sundials_context.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /*=================================================================*/
 /* CVODE Private Constants                                         */
 /*=================================================================*/
@@ -324,6 +329,9 @@ static void cvQuadFreeVectors(CVodeMem cv_mem);
 
 static sunbooleantype cvSensAllocVectors(CVodeMem cv_mem, N_Vector tmpl);
 static void cvSensFreeVectors(CVodeMem cv_mem);
+static sunbooleantype cvSensContiguous(CVodeMem cv_mem, N_Vector tmpl);
+static N_Vector* cvSensCloneVectorArray(CVodeMem cv_mem, N_Vector tmpl);
+static void cvSensDestroyVectorArray(CVodeMem cv_mem, N_Vector* vs);
 
 static sunbooleantype cvQuadSensAllocVectors(CVodeMem cv_mem, N_Vector tmpl);
 static void cvQuadSensFreeVectors(CVodeMem cv_mem);
@@ -423,6 +431,17 @@ static int cvRcheck2(CVodeMem cv_mem);
 static int cvRcheck3(CVodeMem cv_mem);
 static int cvRootfind(CVodeMem cv_mem);
 
+/* Scratch vector functions */
+
+static int cvBorrowScratch(CVodeMem cv_mem);
+static void cvReturnScratch(CVodeMem cv_mem);
+
+/* Step trace functions */
+
+static void cvStepTraceCounters(CVodeMem cv_mem, long int counters[]);
+static void cvStepTraceRecord(CVodeMem cv_mem, SUNStepTrace trace,
+                              int kflag, const long int start[]);
+
 /* Function for combined norms */
 
 static sunrealtype cvQuadUpdateNorm(CVodeMem cv_mem, sunrealtype old_nrm,
@@ -442,6 +461,19 @@ static int cvQuadSensRhs1InternalDQ(CVodeMem cv_mem, int is, sunrealtype t,
                                     N_Vector y, N_Vector yS, N_Vector yQdot,
                                     N_Vector yQSdot, N_Vector tmp, N_Vector tmpQ);
 
+static int cvSensRhs1DQ(CVodeMem cv_mem, sunrealtype t, N_Vector y,
+                        N_Vector ydot, int is, N_Vector yS, N_Vector ySdot,
+                        sunrealtype* p, void* user_data, N_Vector ytemp,
+                        N_Vector ftemp, int* nfel);
+
+/* Thread-parallel sensitivity RHS evaluations */
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+static int cvSensThreadAlloc(CVodeMem cv_mem);
+static int cvSensRhsOMP(CVodeMem cv_mem, sunrealtype time, N_Vector ycur,
+                        N_Vector fcur, N_Vector* yScur, N_Vector* fScur);
+#endif
+
 /*
  * =================================================================
  * Exported Functions Implementation
@@ -499,6 +531,8 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
 
   /* Copy input parameters into cv_mem */
   cv_mem->cv_sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct CVodeMemRec));
   cv_mem->cv_lmm    = lmm;
 
   /* Set uround */
@@ -588,6 +622,18 @@ void* CVodeCreate(int lmm, SUNContext sunctx)
   cv_mem->cv_nnfS1     = NULL;
   cv_mem->cv_itolS     = CV_NN;
   cv_mem->cv_atolSmin0 = NULL;
+  cv_mem->cv_contigS   = SUNFALSE;
+
+  /* No thread-parallel sensitivity RHS evaluations */
+
+  cv_mem->cv_nthreadsS  = 0;
+  cv_mem->cv_nthrvecsS  = 0;
+  cv_mem->cv_tmp1thrS   = NULL;
+  cv_mem->cv_tmp2thrS   = NULL;
+  cv_mem->cv_thrfailS   = NULL;
+  cv_mem->cv_thrretS    = NULL;
+  cv_mem->cv_user_dataT = NULL;
+  cv_mem->cv_pT         = NULL;
 
   /* Set default values for quad. sensi. optional inputs */
 
@@ -823,6 +869,8 @@ int CVodeInit(void* cvode_mem, CVRhsFn f, sunrealtype t0, N_Vector y0)
   cv_mem->cv_lsetup = NULL;
   cv_mem->cv_lsolve = NULL;
   cv_mem->cv_lfree  = NULL;
+
+  cv_mem->cv_lsolvemulti = NULL;
   cv_mem->cv_lmem   = NULL;
 
   /* Set forceSetup to SUNFALSE */
@@ -2895,6 +2943,8 @@ int CVode(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
   int retval, hflag, kflag, istate, is, ir, ier, irfndp;
   sunrealtype troundoff, tout_hin, rh, nrm;
   sunbooleantype inactive_roots;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   /*
    * -------------------------------------
@@ -3490,8 +3540,25 @@ int CVode(void* cvode_mem, sunrealtype tout, N_Vector yout, sunrealtype* tret,
     }
 
     /* Call cvStep to take a step */
+    trace = CV_STEPTRACE;
+    if (trace) { cvStepTraceCounters(cv_mem, trace_start); }
+
+    if (cv_mem->cv_scratch_vtemp && cvBorrowScratch(cv_mem))
+    {
+      cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                     MSGCV_MEM_FAIL);
+      istate              = CV_MEM_FAIL;
+      cv_mem->cv_tretlast = *tret = cv_mem->cv_tn;
+      N_VScale(ONE, cv_mem->cv_zn[0], yout);
+      break;
+    }
+
     kflag = cvStep(cv_mem);
 
+    if (cv_mem->cv_scratch_vtemp) { cvReturnScratch(cv_mem); }
+
+    if (trace) { cvStepTraceRecord(cv_mem, trace, kflag, trace_start); }
+
     /* Process failed step cases, and exit loop */
     if (kflag != CV_SUCCESS)
     {
@@ -4376,6 +4443,8 @@ void CVodeFree(void** cvode_mem)
 
   CVodeSensFree(cv_mem);
 
+  cvSensThreadFree(cv_mem);
+
   CVodeQuadSensFree(cv_mem);
 
   CVodeAdjFree(cv_mem);
@@ -4407,6 +4476,8 @@ void CVodeFree(void** cvode_mem)
 
   if (cv_mem->proj_mem) { cvProjFree(&(cv_mem->proj_mem)); }
 
+  sunMemAccountFree(cv_mem->cv_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct CVodeMemRec));
   free(*cvode_mem);
   *cvode_mem = NULL;
 }
@@ -4594,7 +4665,7 @@ static sunbooleantype cvCheckNvector(N_Vector tmpl)
 
 static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
 {
-  int i, j;
+  int i, j, nvecs;
 
   /* Allocate ewt, acor, tempv, ftemp */
 
@@ -4625,8 +4696,11 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
     return (SUNFALSE);
   }
 
-  cv_mem->cv_vtemp1 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp1 == NULL)
+  /* The vtemp vectors are only used within a step and may be borrowed from
+     the SUNContext scratch pool instead */
+  cv_mem->cv_scratch_vtemp = SUNFALSE;
+  if (SUNContext_GetScratchSharing(cv_mem->cv_sunctx,
+                                   &cv_mem->cv_scratch_vtemp))
   {
     N_VDestroy(cv_mem->cv_ftemp);
     N_VDestroy(cv_mem->cv_tempv);
@@ -4635,27 +4709,46 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
     return (SUNFALSE);
   }
 
-  cv_mem->cv_vtemp2 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp2 == NULL)
+  if (cv_mem->cv_scratch_vtemp)
   {
-    N_VDestroy(cv_mem->cv_vtemp1);
-    N_VDestroy(cv_mem->cv_ftemp);
-    N_VDestroy(cv_mem->cv_tempv);
-    N_VDestroy(cv_mem->cv_ewt);
-    N_VDestroy(cv_mem->cv_acor);
-    return (SUNFALSE);
+    cv_mem->cv_vtemp1 = NULL;
+    cv_mem->cv_vtemp2 = NULL;
+    cv_mem->cv_vtemp3 = NULL;
   }
-
-  cv_mem->cv_vtemp3 = N_VClone(tmpl);
-  if (cv_mem->cv_vtemp3 == NULL)
+  else
   {
-    N_VDestroy(cv_mem->cv_vtemp2);
-    N_VDestroy(cv_mem->cv_vtemp1);
-    N_VDestroy(cv_mem->cv_ftemp);
-    N_VDestroy(cv_mem->cv_tempv);
-    N_VDestroy(cv_mem->cv_ewt);
-    N_VDestroy(cv_mem->cv_acor);
-    return (SUNFALSE);
+    cv_mem->cv_vtemp1 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp1 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
+
+    cv_mem->cv_vtemp2 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp2 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_vtemp1);
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
+
+    cv_mem->cv_vtemp3 = N_VClone(tmpl);
+    if (cv_mem->cv_vtemp3 == NULL)
+    {
+      N_VDestroy(cv_mem->cv_vtemp2);
+      N_VDestroy(cv_mem->cv_vtemp1);
+      N_VDestroy(cv_mem->cv_ftemp);
+      N_VDestroy(cv_mem->cv_tempv);
+      N_VDestroy(cv_mem->cv_ewt);
+      N_VDestroy(cv_mem->cv_acor);
+      return (SUNFALSE);
+    }
   }
 
   /* Allocate zn[0] ... zn[qmax] */
@@ -4678,8 +4771,9 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
   }
 
   /* Update solver workspace lengths  */
-  cv_mem->cv_lrw += (cv_mem->cv_qmax + 8) * cv_mem->cv_lrw1;
-  cv_mem->cv_liw += (cv_mem->cv_qmax + 8) * cv_mem->cv_liw1;
+  nvecs = cv_mem->cv_scratch_vtemp ? cv_mem->cv_qmax + 5 : cv_mem->cv_qmax + 8;
+  cv_mem->cv_lrw += nvecs * cv_mem->cv_lrw1;
+  cv_mem->cv_liw += nvecs * cv_mem->cv_liw1;
 
   /* Store the value of qmax used here */
   cv_mem->cv_qmax_alloc = cv_mem->cv_qmax;
@@ -4695,9 +4789,10 @@ static sunbooleantype cvAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
 
 static void cvFreeVectors(CVodeMem cv_mem)
 {
-  int j, maxord;
+  int j, maxord, nvecs;
 
   maxord = cv_mem->cv_qmax_alloc;
+  nvecs  = cv_mem->cv_scratch_vtemp ? maxord + 5 : maxord + 8;
 
   N_VDestroy(cv_mem->cv_ewt);
   N_VDestroy(cv_mem->cv_acor);
@@ -4708,8 +4803,8 @@ static void cvFreeVectors(CVodeMem cv_mem)
   N_VDestroy(cv_mem->cv_vtemp3);
   for (j = 0; j <= maxord; j++) { N_VDestroy(cv_mem->cv_zn[j]); }
 
-  cv_mem->cv_lrw -= (maxord + 8) * cv_mem->cv_lrw1;
-  cv_mem->cv_liw -= (maxord + 8) * cv_mem->cv_liw1;
+  cv_mem->cv_lrw -= nvecs * cv_mem->cv_lrw1;
+  cv_mem->cv_liw -= nvecs * cv_mem->cv_liw1;
 
   if (cv_mem->cv_VabstolMallocDone)
   {
@@ -4830,6 +4925,80 @@ static void cvQuadFreeVectors(CVodeMem cv_mem)
   cv_mem->cv_VabstolQMallocDone = SUNFALSE;
 }
 
+/*
+ * cvSensContiguous
+ *
+ * Returns SUNTRUE if the sensitivity vector arrays are stored in one
+ * contiguous block each. This requires the user option and a vector
+ * that provides access to its local data array.
+ */
+
+static sunbooleantype cvSensContiguous(CVodeMem cv_mem, N_Vector tmpl)
+{
+  return (cv_mem->cv_contigS && tmpl->ops->nvcloneempty &&
+          tmpl->ops->nvgetarraypointer && tmpl->ops->nvsetarraypointer &&
+          tmpl->ops->nvgetlocallength);
+}
+
+/*
+ * cvSensCloneVectorArray
+ *
+ * Creates an array of Ns vectors like tmpl. With contiguous storage the
+ * vectors are empty clones attached to consecutive length N pieces of a
+ * single N x Ns block, i.e., vector is starts at entry is*N of the block.
+ */
+
+static N_Vector* cvSensCloneVectorArray(CVodeMem cv_mem, N_Vector tmpl)
+{
+  N_Vector* vs;
+  sunrealtype* data;
+  sunindextype n;
+  int is;
+
+  if (!cvSensContiguous(cv_mem, tmpl))
+  {
+    return (N_VCloneVectorArray(cv_mem->cv_Ns, tmpl));
+  }
+
+  n    = N_VGetLocalLength(tmpl);
+  data = (sunrealtype*)malloc(SUNMAX(1, n * cv_mem->cv_Ns) *
+                              sizeof(sunrealtype));
+  if (data == NULL) { return (NULL); }
+
+  vs = N_VCloneEmptyVectorArray(cv_mem->cv_Ns, tmpl);
+  if (vs == NULL)
+  {
+    free(data);
+    return (NULL);
+  }
+
+  for (is = 0; is < cv_mem->cv_Ns; is++)
+  {
+    N_VSetArrayPointer(data + is * n, vs[is]);
+  }
+
+  return (vs);
+}
+
+/*
+ * cvSensDestroyVectorArray
+ *
+ * Frees an array created by cvSensCloneVectorArray.
+ */
+
+static void cvSensDestroyVectorArray(CVodeMem cv_mem, N_Vector* vs)
+{
+  sunrealtype* data = NULL;
+
+  if (vs == NULL) { return; }
+
+  /* the block starts at the data of the first vector */
+  if (cvSensContiguous(cv_mem, vs[0])) { data = N_VGetArrayPointer(vs[0]); }
+
+  N_VDestroyVectorArray(vs, cv_mem->cv_Ns);
+  free(data);
+}
+
 /*
  * cvSensAllocVectors
  *
@@ -4842,61 +5011,61 @@ static sunbooleantype cvSensAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
   int i, j;
 
   /* Allocate yS */
-  cv_mem->cv_yS = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+  cv_mem->cv_yS = cvSensCloneVectorArray(cv_mem, tmpl);
   if (cv_mem->cv_yS == NULL) { return (SUNFALSE); }
 
   /* Allocate ewtS */
-  cv_mem->cv_ewtS = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+  cv_mem->cv_ewtS = cvSensCloneVectorArray(cv_mem, tmpl);
   if (cv_mem->cv_ewtS == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
     return (SUNFALSE);
   }
 
   /* Allocate acorS */
-  cv_mem->cv_acorS = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+  cv_mem->cv_acorS = cvSensCloneVectorArray(cv_mem, tmpl);
   if (cv_mem->cv_acorS == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
     return (SUNFALSE);
   }
 
   /* Allocate tempvS */
-  cv_mem->cv_tempvS = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+  cv_mem->cv_tempvS = cvSensCloneVectorArray(cv_mem, tmpl);
   if (cv_mem->cv_tempvS == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
     return (SUNFALSE);
   }
 
   /* Allocate ftempS */
-  cv_mem->cv_ftempS = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+  cv_mem->cv_ftempS = cvSensCloneVectorArray(cv_mem, tmpl);
   if (cv_mem->cv_ftempS == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_tempvS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_tempvS);
     return (SUNFALSE);
   }
 
   /* Allocate znS */
   for (j = 0; j <= cv_mem->cv_qmax; j++)
   {
-    cv_mem->cv_znS[j] = N_VCloneVectorArray(cv_mem->cv_Ns, tmpl);
+    cv_mem->cv_znS[j] = cvSensCloneVectorArray(cv_mem, tmpl);
     if (cv_mem->cv_znS[j] == NULL)
     {
-      N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-      N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-      N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
-      N_VDestroyVectorArray(cv_mem->cv_tempvS, cv_mem->cv_Ns);
-      N_VDestroyVectorArray(cv_mem->cv_ftempS, cv_mem->cv_Ns);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_tempvS);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ftempS);
       for (i = 0; i < j; i++)
       {
-        N_VDestroyVectorArray(cv_mem->cv_znS[i], cv_mem->cv_Ns);
+        cvSensDestroyVectorArray(cv_mem, cv_mem->cv_znS[i]);
       }
       return (SUNFALSE);
     }
@@ -4907,14 +5076,14 @@ static sunbooleantype cvSensAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
   cv_mem->cv_pbar = (sunrealtype*)malloc(cv_mem->cv_Ns * sizeof(sunrealtype));
   if (cv_mem->cv_pbar == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_tempvS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ftempS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_tempvS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ftempS);
     for (i = 0; i <= cv_mem->cv_qmax; i++)
     {
-      N_VDestroyVectorArray(cv_mem->cv_znS[i], cv_mem->cv_Ns);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_znS[i]);
     }
     return (SUNFALSE);
   }
@@ -4923,14 +5092,14 @@ static sunbooleantype cvSensAllocVectors(CVodeMem cv_mem, N_Vector tmpl)
   cv_mem->cv_plist = (int*)malloc(cv_mem->cv_Ns * sizeof(int));
   if (cv_mem->cv_plist == NULL)
   {
-    N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_tempvS, cv_mem->cv_Ns);
-    N_VDestroyVectorArray(cv_mem->cv_ftempS, cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_tempvS);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ftempS);
     for (i = 0; i <= cv_mem->cv_qmax; i++)
     {
-      N_VDestroyVectorArray(cv_mem->cv_znS[i], cv_mem->cv_Ns);
+      cvSensDestroyVectorArray(cv_mem, cv_mem->cv_znS[i]);
     }
     free(cv_mem->cv_pbar);
     cv_mem->cv_pbar = NULL;
@@ -4961,15 +5130,15 @@ static void cvSensFreeVectors(CVodeMem cv_mem)
 
   maxord = cv_mem->cv_qmax_allocS;
 
-  N_VDestroyVectorArray(cv_mem->cv_yS, cv_mem->cv_Ns);
-  N_VDestroyVectorArray(cv_mem->cv_ewtS, cv_mem->cv_Ns);
-  N_VDestroyVectorArray(cv_mem->cv_acorS, cv_mem->cv_Ns);
-  N_VDestroyVectorArray(cv_mem->cv_tempvS, cv_mem->cv_Ns);
-  N_VDestroyVectorArray(cv_mem->cv_ftempS, cv_mem->cv_Ns);
+  cvSensDestroyVectorArray(cv_mem, cv_mem->cv_yS);
+  cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ewtS);
+  cvSensDestroyVectorArray(cv_mem, cv_mem->cv_acorS);
+  cvSensDestroyVectorArray(cv_mem, cv_mem->cv_tempvS);
+  cvSensDestroyVectorArray(cv_mem, cv_mem->cv_ftempS);
 
   for (j = 0; j <= maxord; j++)
   {
-    N_VDestroyVectorArray(cv_mem->cv_znS[j], cv_mem->cv_Ns);
+    cvSensDestroyVectorArray(cv_mem, cv_mem->cv_znS[j]);
   }
 
   free(cv_mem->cv_pbar);
@@ -9075,6 +9244,118 @@ static int cvRootfind(CVodeMem cv_mem)
   return (RTFOUND);
 }
 
+/*
+ * =================================================================
+ * Step trace functions
+ * =================================================================
+ */
+
+/*
+ * cvStepTraceCounters
+ *
+ * Samples the cumulative integrator and linear solver counters that
+ * are differenced to form a step trace record.
+ */
+
+static void cvStepTraceCounters(CVodeMem cv_mem, long int counters[])
+{
+  CVLsMem cvls_mem = NULL;
+
+  counters[SUN_STEPTRACE_NETF]    = cv_mem->cv_netf;
+  counters[SUN_STEPTRACE_NCFN]    = cv_mem->cv_ncfn;
+  counters[SUN_STEPTRACE_NNI]     = cv_mem->cv_nni;
+  counters[SUN_STEPTRACE_NSETUPS] = cv_mem->cv_nsetups;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  /* the linear solver counters are only available with CVLS */
+  if (cv_mem->cv_lmem && cv_mem->cv_lsolve == cvLsSolve)
+  {
+    cvls_mem                        = (CVLsMem)cv_mem->cv_lmem;
+    counters[SUN_STEPTRACE_NLI]     = cvls_mem->nli;
+    counters[SUN_STEPTRACE_NJEVALS] = cvls_mem->nje;
+  }
+}
+
+/*
+ * cvStepTraceRecord
+ *
+ * Writes a record for the step just attempted by cvStep to trace, the
+ * step trace that was attached to the SUNContext when the counters in
+ * start were sampled. On failure the record holds the step size and
+ * order of the last attempt.
+ */
+
+static void cvStepTraceRecord(CVodeMem cv_mem, SUNStepTrace trace,
+                              int kflag, const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  cvStepTraceCounters(cv_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_CVODES, start, end);
+
+  record.t    = (double)cv_mem->cv_tn;
+  record.flag = kflag;
+  if (kflag == CV_SUCCESS)
+  {
+    record.h     = (double)cv_mem->cv_hu;
+    record.step  = cv_mem->cv_nst;
+    record.order = cv_mem->cv_qu;
+  }
+  else
+  {
+    record.h     = (double)cv_mem->cv_h;
+    record.step  = cv_mem->cv_nst + 1;
+    record.order = cv_mem->cv_q;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
+/*
+ * cvBorrowScratch
+ *
+ * Borrows the vectors vtemp1, vtemp2, and vtemp3 used within a step
+ * from the SUNContext scratch pool. Returns 0 on success and a
+ * nonzero value if the vectors could not be obtained.
+ */
+
+static int cvBorrowScratch(CVodeMem cv_mem)
+{
+  N_Vector vtemp[3];
+
+  if (N_VBorrowScratchVectorArray(3, cv_mem->cv_ewt, vtemp)) { return (-1); }
+
+  cv_mem->cv_vtemp1 = vtemp[0];
+  cv_mem->cv_vtemp2 = vtemp[1];
+  cv_mem->cv_vtemp3 = vtemp[2];
+
+  return (0);
+}
+
+/*
+ * cvReturnScratch
+ *
+ * Returns the vectors obtained by cvBorrowScratch to the SUNContext
+ * scratch pool so they may be used by other objects sharing it.
+ */
+
+static void cvReturnScratch(CVodeMem cv_mem)
+{
+  N_Vector vtemp[3];
+
+  vtemp[0] = cv_mem->cv_vtemp1;
+  vtemp[1] = cv_mem->cv_vtemp2;
+  vtemp[2] = cv_mem->cv_vtemp3;
+
+  (void)N_VReturnScratchVectorArray(3, vtemp);
+
+  cv_mem->cv_vtemp1 = NULL;
+  cv_mem->cv_vtemp2 = NULL;
+  cv_mem->cv_vtemp3 = NULL;
+}
+
 /*
  * =================================================================
  * Internal EWT function
@@ -9543,6 +9824,17 @@ int cvSensRhsWrapper(CVodeMem cv_mem, sunrealtype time, N_Vector ycur,
 {
   int retval = 0, is;
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* Spread the sensitivities across threads, the internal DQ requires
+     per-thread copies of the user data and parameters */
+  if ((cv_mem->cv_nthreadsS > 1) &&
+      (cv_mem->cv_fSDQ ? (cv_mem->cv_pT != NULL)
+                       : (cv_mem->cv_ifS == CV_ONESENS)))
+  {
+    return (cvSensRhsOMP(cv_mem, time, ycur, fcur, yScur, fScur));
+  }
+#endif
+
   if (cv_mem->cv_ifS == CV_ALLSENS)
   {
     retval = cv_mem->cv_fS(cv_mem->cv_Ns, time, ycur, fcur, yScur, fScur,
@@ -9589,6 +9881,208 @@ int cvSensRhs1Wrapper(CVodeMem cv_mem, sunrealtype time, N_Vector ycur,
   return (retval);
 }
 
+/*
+ * -----------------------------------------------------------------
+ * Thread-parallel sensitivity RHS evaluations
+ * -----------------------------------------------------------------
+ */
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+
+/*
+ * cvSensRhsOMP
+ *
+ * cvSensRhsOMP evaluates the right-hand sides of the sensitivity
+ * equations with the sensitivities distributed across nthreadsS
+ * OpenMP threads. Each thread uses its own temporaries and, with the
+ * internal DQ approximation, its own copies of the user data and the
+ * parameters. The right-hand sides are the same as in the serial
+ * loop. If a right-hand side evaluation fails, the value returned for
+ * the first failed sensitivity is returned.
+ *
+ * Each thread evaluates one contiguous block of sensitivities in
+ * increasing order and counts its DQ evaluations in a local variable.
+ * Only the blocks starting before the first failed sensitivity are
+ * added to nfeS, so the counters match the serial loop, which stops
+ * at the first failure.
+ */
+
+static int cvSensRhsOMP(CVodeMem cv_mem, sunrealtype time, N_Vector ycur,
+                        N_Vector fcur, N_Vector* yScur, N_Vector* fScur)
+{
+  int k, is, which, Ns, isfail, retval;
+  long int nfeS;
+
+  Ns = cv_mem->cv_Ns;
+
+  /* per-thread work vectors */
+  if (cvSensThreadAlloc(cv_mem))
+  {
+    cvProcessError(cv_mem, CV_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSGCV_MEM_FAIL);
+    return (CV_MEM_FAIL);
+  }
+
+  /* the DQ perturbs the parameters of each thread starting from p */
+  if (cv_mem->cv_fSDQ)
+  {
+    for (k = 0; k < cv_mem->cv_nthreadsS; k++)
+    {
+      for (is = 0; is < Ns; is++)
+      {
+        which                   = cv_mem->cv_plist[is];
+        cv_mem->cv_pT[k][which] = cv_mem->cv_p[which];
+      }
+    }
+  }
+
+  nfeS = 0;
+
+#pragma omp parallel num_threads(cv_mem->cv_nthreadsS) reduction(+ : nfeS)
+  {
+    int tid       = omp_get_thread_num();
+    int nthr      = omp_get_num_threads();
+    N_Vector tmp1 = cv_mem->cv_tmp1thrS[tid];
+    N_Vector tmp2 = cv_mem->cv_tmp2thrS[tid];
+    int js, j, ier, nfel;
+    int jfirst = -1; /* first sensitivity of this thread        */
+    int jfail  = -1; /* failed sensitivity of this thread       */
+    int jmin   = -1; /* first failed sensitivity of all threads */
+    int ret    = 0;  /* return value at the failed sensitivity  */
+
+    long int nfe = 0; /* DQ evaluations of this thread */
+
+#pragma omp for schedule(static) nowait
+    for (js = 0; js < Ns; js++)
+    {
+      /* skip the remaining sensitivities of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = js; }
+
+      if (cv_mem->cv_fSDQ)
+      {
+        ier = cvSensRhs1DQ(cv_mem, time, ycur, fcur, js, yScur[js], fScur[js],
+                           cv_mem->cv_pT[tid], cv_mem->cv_user_dataT[tid],
+                           tmp1, tmp2, &nfel);
+        if (ier == 0) { nfe += nfel; }
+      }
+      else
+      {
+        ier = cv_mem->cv_fS1(Ns, time, ycur, fcur, js, yScur[js], fScur[js],
+                             cv_mem->cv_fS_data, tmp1, tmp2);
+      }
+
+      if (ier != 0)
+      {
+        jfail = js;
+        ret   = ier;
+      }
+    }
+
+    cv_mem->cv_thrfailS[tid] = jfail;
+    cv_mem->cv_thrretS[tid]  = ret;
+
+#pragma omp barrier
+
+    /* count the block only if the serial loop would have reached it */
+    for (j = 0; j < nthr; j++)
+    {
+      if ((cv_mem->cv_thrfailS[j] >= 0) &&
+          ((jmin < 0) || (cv_mem->cv_thrfailS[j] < jmin)))
+      {
+        jmin = cv_mem->cv_thrfailS[j];
+      }
+    }
+    if ((jfirst >= 0) && ((jmin < 0) || (jfirst < jmin))) { nfeS += nfe; }
+  }
+
+  /* combine the per-thread failures */
+  isfail = -1;
+  retval = 0;
+  for (k = 0; k < cv_mem->cv_nthreadsS; k++)
+  {
+    if ((cv_mem->cv_thrfailS[k] >= 0) &&
+        ((isfail < 0) || (cv_mem->cv_thrfailS[k] < isfail)))
+    {
+      isfail = cv_mem->cv_thrfailS[k];
+      retval = cv_mem->cv_thrretS[k];
+    }
+  }
+
+  /* count the evaluations the serial loop would have made */
+  if (cv_mem->cv_ifS == CV_ALLSENS) { cv_mem->cv_nfSe++; }
+  else { cv_mem->cv_nfSe += (isfail < 0) ? Ns : isfail + 1; }
+
+  cv_mem->cv_nfeS += nfeS;
+
+  return (retval);
+}
+
+/*
+ * cvSensThreadAlloc
+ *
+ * cvSensThreadAlloc allocates the per-thread work vectors (if needed)
+ * and resets the per-thread failure flags.
+ */
+
+static int cvSensThreadAlloc(CVodeMem cv_mem)
+{
+  int nt = cv_mem->cv_nthreadsS;
+  int k;
+
+  if (cv_mem->cv_nthrvecsS < nt)
+  {
+    cvSensThreadFree(cv_mem);
+
+    cv_mem->cv_tmp1thrS  = N_VCloneVectorArray(nt, cv_mem->cv_tempv);
+    cv_mem->cv_tmp2thrS  = N_VCloneVectorArray(nt, cv_mem->cv_tempv);
+    cv_mem->cv_thrfailS  = (int*)malloc(nt * sizeof(int));
+    cv_mem->cv_thrretS   = (int*)malloc(nt * sizeof(int));
+    cv_mem->cv_nthrvecsS = nt;
+    if (cv_mem->cv_tmp1thrS == NULL || cv_mem->cv_tmp2thrS == NULL ||
+        cv_mem->cv_thrfailS == NULL || cv_mem->cv_thrretS == NULL)
+    {
+      cvSensThreadFree(cv_mem);
+      return (-1);
+    }
+  }
+
+  for (k = 0; k < nt; k++)
+  {
+    cv_mem->cv_thrfailS[k] = -1;
+    cv_mem->cv_thrretS[k]  = 0;
+  }
+
+  return (0);
+}
+
+#endif
+
+/*
+ * cvSensThreadFree
+ *
+ * cvSensThreadFree frees the per-thread work vectors.
+ */
+
+void cvSensThreadFree(CVodeMem cv_mem)
+{
+  if (cv_mem->cv_tmp1thrS)
+  {
+    N_VDestroyVectorArray(cv_mem->cv_tmp1thrS, cv_mem->cv_nthrvecsS);
+  }
+  if (cv_mem->cv_tmp2thrS)
+  {
+    N_VDestroyVectorArray(cv_mem->cv_tmp2thrS, cv_mem->cv_nthrvecsS);
+  }
+  free(cv_mem->cv_thrfailS);
+  free(cv_mem->cv_thrretS);
+  cv_mem->cv_tmp1thrS  = NULL;
+  cv_mem->cv_tmp2thrS  = NULL;
+  cv_mem->cv_thrfailS  = NULL;
+  cv_mem->cv_thrretS   = NULL;
+  cv_mem->cv_nthrvecsS = 0;
+}
+
 /*
  * -----------------------------------------------------------------
  * Internal DQ approximations for sensitivity RHS
@@ -9637,8 +10131,40 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
                          void* cvode_mem, N_Vector ytemp, N_Vector ftemp)
 {
   CVodeMem cv_mem;
+  int retval, nfel = 0;
+
+  /* cvode_mem is passed here as user data */
+  cv_mem = (CVodeMem)cvode_mem;
+
+  retval = cvSensRhs1DQ(cv_mem, t, y, ydot, is, yS, ySdot, cv_mem->cv_p,
+                        cv_mem->cv_user_data, ytemp, ftemp, &nfel);
+  if (retval != 0) { return (retval); }
+
+  /* Increment counter nfeS */
+  cv_mem->cv_nfeS += nfel;
+
+  return (0);
+}
+
+/*
+ * cvSensRhs1DQ
+ *
+ * cvSensRhs1DQ computes the right hand side of the is-th sensitivity
+ * equation by finite differences, perturbing the parameters p that are
+ * passed to f() through user_data. The number of evaluations of f() is
+ * returned in nfel.
+ *
+ * cvSensRhs1DQ returns 0 if successful. Otherwise it returns the
+ * non-zero return value from f().
+ */
+
+static int cvSensRhs1DQ(CVodeMem cv_mem, sunrealtype t, N_Vector y,
+                        N_Vector ydot, int is, N_Vector yS, N_Vector ySdot,
+                        sunrealtype* p, void* user_data, N_Vector ytemp,
+                        N_Vector ftemp, int* nfel)
+{
   int retval, method;
-  int nfel = 0, which;
+  int which;
   sunrealtype psave, pbari;
   sunrealtype delta, rdelta;
   sunrealtype Deltap, rDeltap, r2Deltap;
@@ -9650,8 +10176,7 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
   sunrealtype cvals[3];
   N_Vector Xvecs[3];
 
-  /* cvode_mem is passed here as user data */
-  cv_mem = (CVodeMem)cvode_mem;
+  *nfel = 0;
 
   delta  = SUNRsqrt(SUNMAX(cv_mem->cv_reltol, cv_mem->cv_uround));
   rdelta = ONE / delta;
@@ -9660,7 +10185,7 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
 
   which = cv_mem->cv_plist[is];
 
-  psave = cv_mem->cv_p[which];
+  psave = p[which];
 
   Deltap  = pbari * delta;
   rDeltap = ONE / Deltap;
@@ -9692,17 +10217,17 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
     r2Delta = HALF / Delta;
 
     N_VLinearSum(ONE, y, Delta, yS, ytemp);
-    cv_mem->cv_p[which] = psave + Delta;
+    p[which] = psave + Delta;
 
-    retval = cv_mem->cv_f(t, ytemp, ySdot, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ySdot, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(ONE, y, -Delta, yS, ytemp);
-    cv_mem->cv_p[which] = psave - Delta;
+    p[which] = psave - Delta;
 
-    retval = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ftemp, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(r2Delta, ySdot, -r2Delta, ftemp, ySdot);
@@ -9716,26 +10241,26 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
 
     N_VLinearSum(ONE, y, Deltay, yS, ytemp);
 
-    retval = cv_mem->cv_f(t, ytemp, ySdot, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ySdot, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(ONE, y, -Deltay, yS, ytemp);
 
-    retval = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ftemp, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(r2Deltay, ySdot, -r2Deltay, ftemp, ySdot);
 
-    cv_mem->cv_p[which] = psave + Deltap;
-    retval              = cv_mem->cv_f(t, y, ytemp, cv_mem->cv_user_data);
-    nfel++;
+    p[which] = psave + Deltap;
+    retval   = cv_mem->cv_f(t, y, ytemp, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
-    cv_mem->cv_p[which] = psave - Deltap;
-    retval              = cv_mem->cv_f(t, y, ftemp, cv_mem->cv_user_data);
-    nfel++;
+    p[which] = psave - Deltap;
+    retval   = cv_mem->cv_f(t, y, ftemp, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     /* ySdot = ySdot + r2Deltap * ytemp - r2Deltap * ftemp */
@@ -9757,10 +10282,10 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
     rDelta = ONE / Delta;
 
     N_VLinearSum(ONE, y, Delta, yS, ytemp);
-    cv_mem->cv_p[which] = psave + Delta;
+    p[which] = psave + Delta;
 
-    retval = cv_mem->cv_f(t, ytemp, ySdot, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ySdot, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(rDelta, ySdot, -rDelta, ydot, ySdot);
@@ -9771,15 +10296,15 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
 
     N_VLinearSum(ONE, y, Deltay, yS, ytemp);
 
-    retval = cv_mem->cv_f(t, ytemp, ySdot, cv_mem->cv_user_data);
-    nfel++;
+    retval = cv_mem->cv_f(t, ytemp, ySdot, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     N_VLinearSum(rDeltay, ySdot, -rDeltay, ydot, ySdot);
 
-    cv_mem->cv_p[which] = psave + Deltap;
-    retval              = cv_mem->cv_f(t, y, ytemp, cv_mem->cv_user_data);
-    nfel++;
+    p[which] = psave + Deltap;
+    retval   = cv_mem->cv_f(t, y, ytemp, user_data);
+    (*nfel)++;
     if (retval != 0) { return (retval); }
 
     /* ySdot = ySdot + rDeltap * ytemp - rDeltap * ydot */
@@ -9796,10 +10321,7 @@ int cvSensRhs1InternalDQ(SUNDIALS_MAYBE_UNUSED int Ns, sunrealtype t, N_Vector y
     break;
   }
 
-  cv_mem->cv_p[which] = psave;
-
-  /* Increment counter nfeS */
-  cv_mem->cv_nfeS += nfel;
+  p[which] = psave;
 
   return (0);
 }
@@ -124,6 +124,9 @@ int CVDiag(void* cvode_mem)
   lsolve = CVDiagSolve;
   lfree  = CVDiagFree;
 
+  /* The diagonal solver uses the error weights, solve one system at a time */
+  cv_mem->cv_lsolvemulti = NULL;
+
   /* Get memory for CVDiagMemRec */
   cvdiag_mem = NULL;
   cvdiag_mem = (CVDiagMem)malloc(sizeof(CVDiagMemRec));
@@ -26,6 +26,7 @@
 #include "cvodes_proj_impl.h"
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
 extern "C" {
@@ -43,8 +44,9 @@ extern "C" {
 /* Shortcuts                                                       */
 /*=================================================================*/
 
-#define CV_PROFILER cv_mem->cv_sunctx->profiler
-#define CV_LOGGER   cv_mem->cv_sunctx->logger
+#define CV_PROFILER  cv_mem->cv_sunctx->profiler
+#define CV_LOGGER    cv_mem->cv_sunctx->logger
+#define CV_STEPTRACE cv_mem->cv_sunctx->steptrace
 
 /*
  * =================================================================
@@ -293,6 +295,19 @@ typedef struct CVodeMemRec
   int cv_DQtype;           /* central/forward finite differences           */
   sunrealtype cv_DQrhomax; /* cut-off value for separate/simultaneous FD   */
 
+  /* Storage of the sensitivity vector arrays */
+  sunbooleantype cv_contigS; /* one contiguous N x Ns block per array?    */
+
+  /* Thread-parallel sensitivity RHS evaluations (OpenMP builds only) */
+  int cv_nthreadsS;      /* number of threads, <= 1 for the serial loop   */
+  int cv_nthrvecsS;      /* number of allocated per-thread work vectors   */
+  N_Vector* cv_tmp1thrS; /* per-thread temporaries                        */
+  N_Vector* cv_tmp2thrS; /* per-thread temporaries                        */
+  int* cv_thrfailS;      /* per-thread first failed sensitivity           */
+  int* cv_thrretS;       /* per-thread RHS return value at that index     */
+  void** cv_user_dataT;  /* per-thread user data for the internal DQ      */
+  sunrealtype** cv_pT;   /* per-thread parameters for the internal DQ     */
+
   sunbooleantype cv_errconS; /* SUNTRUE if yS are considered in err. control */
 
   int cv_itolS;
@@ -344,6 +359,8 @@ typedef struct CVodeMemRec
   N_Vector cv_vtemp1; /* temporary storage vector                            */
   N_Vector cv_vtemp2; /* temporary storage vector                            */
   N_Vector cv_vtemp3; /* temporary storage vector                            */
+  sunbooleantype cv_scratch_vtemp; /* borrow vtemp1-3 from the SUNContext
+                                      scratch pool for each step          */
 
   N_Vector cv_constraints; /* vector of inequality constraint options         */
 
@@ -574,6 +591,9 @@ typedef struct CVodeMemRec
   int (*cv_lsolve)(struct CVodeMemRec* cv_mem, N_Vector b, N_Vector weight,
                    N_Vector ycur, N_Vector fcur);
 
+  int (*cv_lsolvemulti)(struct CVodeMemRec* cv_mem, int nrhs, N_Vector* b,
+                        N_Vector* weight, N_Vector ycur, N_Vector fcur);
+
   int (*cv_lfree)(struct CVodeMemRec* cv_mem);
 
   /* Linear Solver specific memory */
@@ -710,6 +730,9 @@ struct CVckpntMemRec
   sunrealtype ck_t0;
   sunrealtype ck_t1;
 
+  /* Step number at t1 */
+  long int ck_nst1;
+
   /* Nordsieck History Array */
   N_Vector ck_zn[L_MAX];
 
@@ -872,6 +895,22 @@ struct CVodeBMemRec
   /* Workspace Nvector */
   N_Vector cv_y;
 
+  /* Private copies of the forward CVODES and adjoint memory, passed to the
+   * wrapper functions when backward problems are integrated concurrently,
+   * and the interpolation and wrapper workspace they point to */
+  struct CVodeMemRec* cv_fwd_mem;
+  struct CVadjMemRec* cv_fwd_adj;
+  sunrealtype* cv_fwd_cvals;
+  N_Vector cv_fwd_ytmp;
+  N_Vector* cv_fwd_yStmp;
+  N_Vector cv_fwd_Y[L_MAX];
+  N_Vector* cv_fwd_YS[L_MAX];
+  int cv_fwd_nY; /* number of vectors in cv_fwd_Y            */
+  int cv_fwd_Ns; /* number of vectors in cv_fwd_yStmp, YS[i] */
+
+  /* Return flag of the last concurrent integration */
+  int cv_flag;
+
   /* Pointer to next structure in list */
   struct CVodeBMemRec* cv_next;
 };
@@ -923,6 +962,12 @@ struct CVadjMemRec
   /* Flag for first call to CVodeB */
   sunbooleantype ca_firstCVodeBcall;
 
+  /* Number of threads integrating backward problems concurrently */
+  int ca_nthreads;
+
+  /* Backward problems active in the current check point (concurrent mode) */
+  struct CVodeBMemRec** ca_active;
+
   /* ----------------
    * Check point data
    * ---------------- */
@@ -933,6 +978,12 @@ struct CVadjMemRec
   /* Number of check points */
   int ca_nckpnts;
 
+  /* Maximum number of check points kept in memory (0 = no limit) */
+  int ca_ckmax;
+
+  /* Number of forward steps at tfinal */
+  long int ca_nstfinal;
+
   /* address of the check point structure for which data is available */
   struct CVckpntMemRec* ca_ckpntData;
 
@@ -1102,6 +1153,22 @@ struct CVadjMemRec
  * -----------------------------------------------------------------
  */
 
+/*
+ * -----------------------------------------------------------------
+ * int (*cv_lsolvemulti)(CVodeMem cv_mem, int nrhs, N_Vector* b,
+ *                       N_Vector* weight, N_Vector ycur,
+ *                       N_Vector fcur);
+ * -----------------------------------------------------------------
+ * cv_lsolvemulti is optional and solves P x = b[i] for the nrhs
+ * right-hand sides together, returning the solutions in b. The
+ * error weights of b[i] are in weight[i]. It is set for direct
+ * solvers that support several right-hand sides and, when enabled
+ * with CVodeSetSensBlockKrylov, for iterative solvers, so the
+ * sensitivity systems may be solved with the state system.
+ * The return values are the same as for cv_lsolve.
+ * -----------------------------------------------------------------
+ */
+
 /*
  * -----------------------------------------------------------------
  * int (*cv_lfree)(CVodeMem cv_mem);
@@ -1182,6 +1249,10 @@ int cvSensRhs1InternalDQ(int Ns, sunrealtype t, N_Vector y, N_Vector ydot,
                          int is, N_Vector yS, N_Vector ySdot, void* fS_data,
                          N_Vector tempv, N_Vector ftemp);
 
+/* Free the per-thread sensitivity RHS work space */
+
+void cvSensThreadFree(CVodeMem cv_mem);
+
 /*
  * =================================================================
  *    E R R O R    M E S S A G E S
@@ -1277,6 +1348,12 @@ int cvSensRhs1InternalDQ(int Ns, sunrealtype t, N_Vector y, N_Vector ydot,
 #define MSGCV_BAD_DQTYPE \
   "Illegal value for DQtype. Legal values are: CV_CENTERED and CV_FORWARD."
 #define MSGCV_BAD_DQRHO "DQrhomax < 0 illegal."
+#define MSGCV_NO_SENS_THREADS \
+  "The number of threads must be set first with CVodeSetSensNumThreads."
+#define MSGCV_BAD_SENS_THREAD_DATA \
+  "user_data and p must both be NULL or both be non-NULL."
+#define MSGCV_SENS_CONTIG_ALLOC \
+  "The sensitivity storage must be chosen before calling CVodeSensInit."
 
 #define MSGCV_BAD_ITOLQS \
   "Illegal value for itolQS. The legal values are CV_SS, CV_SV, and CV_EE."
@@ -1432,7 +1509,11 @@ int cvSensRhs1InternalDQ(int Ns, sunrealtype t, N_Vector y, N_Vector ydot,
 #define MSGCV_NO_ADJ     "Illegal attempt to call before calling CVodeAdjMalloc."
 #define MSGCV_BAD_STEPS  "Steps nonpositive illegal."
 #define MSGCV_BAD_INTERP "Illegal value for interp."
+#define MSGCV_BAD_CKMAX  "maxck must be zero or at least 3."
 #define MSGCV_BAD_WHICH  "Illegal value for which."
+#define MSGCV_BAD_NTHREADS \
+  "The number of threads must be set before calling CVodeCreateB."
+#define MSGCV_NO_OPENMP "SUNDIALS was not built with OpenMP enabled."
 #define MSGCV_NO_BCK     "No backward problems have been defined yet."
 #define MSGCV_NO_FWD     "Illegal attempt to call before calling CVodeF."
 #define MSGCV_BAD_TB0                                                       \
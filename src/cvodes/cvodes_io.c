@@ -1140,6 +1140,103 @@ int CVodeSetSensMaxNonlinIters(void* cvode_mem, int maxcorS)
 
 /*-----------------------------------------------------------------*/
 
+int CVodeSetSensNumThreads(void* cvode_mem, int nthreads)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* release work space sized for a previous setting */
+  cvSensThreadFree(cv_mem);
+
+  cv_mem->cv_nthreadsS  = (nthreads > 1) ? nthreads : 0;
+  cv_mem->cv_user_dataT = NULL;
+  cv_mem->cv_pT         = NULL;
+
+  return (CV_SUCCESS);
+#else
+  if (nthreads > 1)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_NO_OPENMP);
+    return (CV_ILL_INPUT);
+  }
+
+  return (CV_SUCCESS);
+#endif
+}
+
+/*-----------------------------------------------------------------*/
+
+int CVodeSetSensDQThreadData(void* cvode_mem, void** user_data, sunrealtype** p)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  /* the arrays hold one entry per thread */
+  if (cv_mem->cv_nthreadsS < 2)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_NO_SENS_THREADS);
+    return (CV_ILL_INPUT);
+  }
+
+  if ((user_data == NULL) != (p == NULL))
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_BAD_SENS_THREAD_DATA);
+    return (CV_ILL_INPUT);
+  }
+
+  cv_mem->cv_user_dataT = user_data;
+  cv_mem->cv_pT         = p;
+
+  return (CV_SUCCESS);
+}
+
+/*-----------------------------------------------------------------*/
+
+int CVodeSetSensContiguous(void* cvode_mem, sunbooleantype contiguous)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  /* the storage cannot change once the vectors are allocated */
+  if (cv_mem->cv_SensMallocDone)
+  {
+    cvProcessError(cv_mem, CV_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   MSGCV_SENS_CONTIG_ALLOC);
+    return (CV_ILL_INPUT);
+  }
+
+  cv_mem->cv_contigS = contiguous;
+
+  return (CV_SUCCESS);
+}
+
+/*-----------------------------------------------------------------*/
+
 int CVodeSetSensParams(void* cvode_mem, sunrealtype* p, sunrealtype* pbar,
                        int* plist)
 {
@@ -1695,6 +1792,31 @@ int CVodeGetWorkSpace(void* cvode_mem, long int* lenrw, long int* leniw)
   return (CV_SUCCESS);
 }
 
+/*
+ * CVodeGetScratchSpace
+ *
+ * Returns the integrator work space borrowed from the SUNContext
+ * scratch pool during each step
+ */
+
+int CVodeGetScratchSpace(void* cvode_mem, long int* lenrw, long int* leniw)
+{
+  CVodeMem cv_mem;
+
+  if (cvode_mem == NULL)
+  {
+    cvProcessError(NULL, CV_MEM_NULL, __LINE__, __func__, __FILE__, MSGCV_NO_MEM);
+    return (CV_MEM_NULL);
+  }
+
+  cv_mem = (CVodeMem)cvode_mem;
+
+  *leniw = cv_mem->cv_scratch_vtemp ? 3 * cv_mem->cv_liw1 : 0;
+  *lenrw = cv_mem->cv_scratch_vtemp ? 3 * cv_mem->cv_lrw1 : 0;
+
+  return (CV_SUCCESS);
+}
+
 /*
  * CVodeGetIntegratorStats
  *
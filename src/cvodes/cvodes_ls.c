@@ -20,6 +20,7 @@
  * (backward) problems.
  * ---------------------------------------------------------------- */
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,6 +32,10 @@
 #include "cvodes_impl.h"
 #include "cvodes_ls_impl.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /* Private constants */
 #define MIN_INC_MULT SUN_RCONST(1000.0)
 #define MAX_DQITERS  3 /* max. number of attempts to recover in DQ J*v */
@@ -48,6 +53,28 @@ static int cvLsLinSys(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix A,
                       sunrealtype gamma, void* user_data, N_Vector tmp1,
                       N_Vector tmp2, N_Vector tmp3);
 
+static sunrealtype cvLsDQInc(CVodeMem cv_mem, sunindextype j,
+                             sunrealtype* y_data, sunrealtype* ewt_data,
+                             sunrealtype* cns_data, sunrealtype srur,
+                             sunrealtype minInc);
+static int cvLsBatchAlloc(CVLsMem cvls_mem, N_Vector tmpl, int nvecs);
+static void cvLsBatchFree(CVLsMem cvls_mem);
+static int cvLsMultiAlloc(CVLsMem cvls_mem, int nrhs);
+static void cvLsMultiFree(CVLsMem cvls_mem);
+static int cvLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, CVodeMem cv_mem, N_Vector tmp1);
+static int cvLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, CVodeMem cv_mem);
+static void cvLsThreadFree(CVLsMem cvls_mem);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+static int cvLsThreadAlloc(CVLsMem cvls_mem, N_Vector tmpl);
+static int cvLsThreadRetval(CVLsMem cvls_mem, long int* nfeDQ);
+static int cvLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, CVodeMem cv_mem);
+static int cvLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                            SUNMatrix Jac, CVodeMem cv_mem);
+#endif
+
 /*=================================================================
   PRIVATE FUNCTION PROTOTYPES - backward problems
   =================================================================*/
@@ -223,6 +250,13 @@ int CVodeSetLinearSolver(void* cvode_mem, SUNLinearSolver LS, SUNMatrix A)
   cv_mem->cv_lsolve = cvLsSolve;
   cv_mem->cv_lfree  = cvLsFree;
 
+  /* Solve several systems with one call if the direct solver supports it */
+  cv_mem->cv_lsolvemulti = NULL;
+  if ((LSType == SUNLINEARSOLVER_DIRECT) && (LS->ops->solvemulti != NULL))
+  {
+    cv_mem->cv_lsolvemulti = cvLsSolveMulti;
+  }
+
   /* Allocate memory for CVLsMemRec */
   cvls_mem = NULL;
   cvls_mem = (CVLsMem)malloc(sizeof(struct CVLsMemRec));
@@ -396,6 +430,66 @@ int CVodeSetJacFn(void* cvode_mem, CVLsJacFn jac)
   return (CVLS_SUCCESS);
 }
 
+/* CVodeSetBatchRhsFn specifies a function evaluating the RHS at several
+ * states in one call. When set, it is used by the internal dense and band
+ * DQ Jacobian approximations with at most max_batch states per call
+ * (CVLS_MAX_BATCH if max_batch = 0, all columns or column groups at once
+ * if max_batch < 0). */
+int CVodeSetBatchRhsFn(void* cvode_mem, CVLsBatchRhsFn fb, int max_batch)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+  /* release batch vectors sized for a previous setting */
+  cvLsBatchFree(cvls_mem);
+
+  cvls_mem->fbatch    = fb;
+  /* max_batch = 0 selects the default bound, max_batch < 0 all columns */
+  if (max_batch == 0) { cvls_mem->max_batch = CVLS_MAX_BATCH; }
+  else if (max_batch < 0) { cvls_mem->max_batch = INT_MAX; }
+  else { cvls_mem->max_batch = max_batch; }
+
+  return (CVLS_SUCCESS);
+}
+
+/* CVodeSetDQJacNumThreads specifies the number of OpenMP threads used to
+ * evaluate the columns (or column groups) of the internal dense and band DQ
+ * Jacobian approximations concurrently. The RHS function must be thread-safe
+ * when nthreads > 1. */
+int CVodeSetDQJacNumThreads(void* cvode_mem, int nthreads)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* release work vectors sized for a previous setting */
+  cvLsThreadFree(cvls_mem);
+
+  cvls_mem->dqnthreads = (nthreads > 1) ? nthreads : 0;
+
+  return (CVLS_SUCCESS);
+#else
+  if (nthreads > 1)
+  {
+    cvProcessError(cv_mem, CVLS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "SUNDIALS was not built with OpenMP enabled");
+    return (CVLS_ILL_INPUT);
+  }
+
+  return (CVLS_SUCCESS);
+#endif
+}
+
 /* CVodeSetDeltaGammaMaxBadJac specifies the maximum gamma ratio change
  * after a NLS convergence failure with a potentially bad Jacobian. If
  * |gamma/gammap-1| < dgmax_jbad then the Jacobian is marked as bad */
@@ -521,6 +615,41 @@ int CVodeSetLinearSolutionScaling(void* cvode_mem, sunbooleantype onoff)
   return (CVLS_SUCCESS);
 }
 
+/* CVodeSetSensBlockKrylov enables or disables solving the state and
+   sensitivity systems together with a block Krylov method */
+int CVodeSetSensBlockKrylov(void* cvode_mem, sunbooleantype onoff)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+  /* direct solvers always solve the systems together (if supported) */
+  if (!(cvls_mem->iterative)) { return (CVLS_SUCCESS); }
+
+  if (!onoff)
+  {
+    cv_mem->cv_lsolvemulti = NULL;
+    return (CVLS_SUCCESS);
+  }
+
+  /* the solver must support several right-hand sides and scaling vectors */
+  if ((cvls_mem->LS->ops->solvemulti == NULL) ||
+      (cvls_mem->LS->ops->setscalingvectors == NULL))
+  {
+    cvProcessError(cv_mem, CVLS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                   "The linear solver does not support block Krylov solves.");
+    return (CVLS_ILL_INPUT);
+  }
+
+  cv_mem->cv_lsolvemulti = cvLsSolveMulti;
+
+  return (CVLS_SUCCESS);
+}
+
 /* CVodeSetPreconditioner specifies the user-supplied preconditioner
    setup and solve routines */
 int CVodeSetPreconditioner(void* cvode_mem, CVLsPrecSetupFn psetup,
@@ -1138,6 +1267,20 @@ int cvLsDenseDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   /* access LsMem interface structure */
   cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
+  /* evaluate all perturbed states with the batched RHS if provided */
+  if (cvls_mem->fbatch)
+  {
+    return (cvLsDenseDQJacBatch(t, y, fy, Jac, cv_mem, tmp1));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the columns concurrently if requested */
+  if (cvls_mem->dqnthreads > 1)
+  {
+    return (cvLsDenseDQJacOMP(t, y, fy, Jac, cv_mem));
+  }
+#endif
+
   /* access matrix dimension */
   N = SUNDenseMatrix_Columns(Jac);
 
@@ -1232,6 +1375,20 @@ int cvLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
   /* access LsMem interface structure */
   cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
+  /* evaluate all column groups with the batched RHS if provided */
+  if (cvls_mem->fbatch)
+  {
+    return (cvLsBandDQJacBatch(t, y, fy, Jac, cv_mem));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the column groups concurrently if requested */
+  if (cvls_mem->dqnthreads > 1)
+  {
+    return (cvLsBandDQJacOMP(t, y, fy, Jac, cv_mem));
+  }
+#endif
+
   /* access matrix dimensions */
   N      = SUNBandMatrix_Columns(Jac);
   mupper = SUNBandMatrix_UpperBandwidth(Jac);
@@ -1331,159 +1488,795 @@ int cvLsBandDQJac(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix Jac,
 }
 
 /*-----------------------------------------------------------------
-  cvLsDQJtimes
+  cvLsDenseDQJacBatch
 
-  This routine generates a difference quotient approximation to
-  the Jacobian times vector f_y(t,y) * v. The approximation is
-  Jv = [f(y + v*sig) - f(y)]/sig, where sig = 1 / ||v||_WRMS,
-  i.e. the WRMS norm of v*sig is 1.
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of f(t,y) using the batched RHS function. The
+  perturbed states y + inc_j e_j for up to max_batch columns are
+  evaluated in one call and the columns of J are then formed as in
+  cvLsDenseDQJac.
   -----------------------------------------------------------------*/
-int cvLsDQJtimes(N_Vector v, N_Vector Jv, sunrealtype t, N_Vector y,
-                 N_Vector fy, void* cvode_mem, N_Vector work)
+static int cvLsDenseDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                               SUNMatrix Jac, CVodeMem cv_mem, N_Vector tmp1)
 {
-  CVodeMem cv_mem;
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  N_Vector jthCol;
+  sunindextype j, j0, N;
+  int k, nb, nstates;
   CVLsMem cvls_mem;
-  sunrealtype sig, siginv;
-  int iter, retval;
+  int retval = 0;
 
-  /* access CVLsMem structure */
-  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
-  if (retval != CVLS_SUCCESS) { return (retval); }
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
-  /* Initialize perturbation to 1/||v|| */
-  sig = ONE / N_VWrmsNorm(v, cv_mem->cv_ewt);
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
 
-  for (iter = 0; iter < MAX_DQITERS; iter++)
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (cvls_mem->max_batch < N) ? cvls_mem->max_batch : (int)N;
+  if (cvLsBatchAlloc(cvls_mem, tmp1, nb))
   {
-    /* Set work = y + sig*v */
-    N_VLinearSum(sig, v, ONE, y, work);
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
 
-    /* Set Jv = f(tn, y+sig*v) */
-    retval = cvls_mem->jt_f(t, work, Jv, cv_mem->cv_user_data);
-    cvls_mem->nfeDQ++;
-    if (retval == 0) { break; }
-    if (retval < 0) { return (-1); }
+  /* Create an empty vector for matrix column calculations */
+  jthCol = N_VCloneEmpty(tmp1);
 
-    /* If f failed recoverably, shrink sig and retry */
-    sig *= PT25;
-  }
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
 
-  /* If retval still isn't 0, return with a recoverable failure */
-  if (retval > 0) { return (+1); }
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
 
-  /* Replace Jv by (Jv - fy)/sig */
-  siginv = ONE / sig;
-  N_VLinearSum(siginv, Jv, -siginv, fy, Jv);
+  for (j0 = 0; j0 < N; j0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, N - j0);
 
-  return (0);
+    /* Load the perturbed states */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      N_VScale(ONE, y, cvls_mem->ybatch[k]);
+      N_VGetArrayPointer(cvls_mem->ybatch[k])[j] += inc;
+    }
+
+    retval = cvls_mem->fbatch(t, nstates, cvls_mem->ybatch, cvls_mem->fybatch,
+                              cv_mem->cv_user_data);
+    cvls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Form the difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, cvls_mem->fybatch[k], -inc_inv, fy, jthCol);
+    }
+  }
+
+  /* Destroy jthCol vector */
+  N_VSetArrayPointer(NULL, jthCol);
+  N_VDestroy(jthCol);
+
+  return (retval);
 }
 
 /*-----------------------------------------------------------------
-  cvLsLinSys
+  cvLsBandDQJacBatch
 
-  Setup the linear system A = I - gamma J
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of f(t,y) using the batched RHS function. The
+  perturbed states for up to max_batch column groups are evaluated
+  in one call and the columns of J are then formed as in
+  cvLsBandDQJac.
   -----------------------------------------------------------------*/
-static int cvLsLinSys(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix A,
-                      sunbooleantype jok, sunbooleantype* jcur,
-                      sunrealtype gamma, void* cvode_mem, N_Vector vtemp1,
-                      N_Vector vtemp2, N_Vector vtemp3)
+static int cvLsBandDQJacBatch(sunrealtype t, N_Vector y, N_Vector fy,
+                              SUNMatrix Jac, CVodeMem cv_mem)
 {
-  CVodeMem cv_mem;
+  sunrealtype fnorm, minInc, inc, inc_inv, srur;
+  sunrealtype *col_j, *ewt_data, *fy_data, *ftemp_data;
+  sunrealtype *y_data, *ytemp_data, *cns_data;
+  sunindextype group, g0, i, j, width, ngroups, i1, i2;
+  sunindextype N, mupper, mlower;
+  int k, nb, nstates;
   CVLsMem cvls_mem;
-  int retval;
+  int retval = 0;
 
-  /* access CVLsMem structure */
-  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
-  if (retval != CVLS_SUCCESS) { return (retval); }
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
 
-  /* Check if Jacobian needs to be updated */
-  if (jok)
-  {
-    /* Use saved copy of J */
-    *jcur = SUNFALSE;
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
 
-    /* Overwrite linear system matrix with saved J */
-    retval = SUNMatCopy(cvls_mem->savedJ, A);
-    if (retval)
-    {
-      cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
-                     MSG_LS_SUNMAT_FAILED);
-      cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
-      return (cvls_mem->last_flag);
-    }
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+  /* number of states per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (cvls_mem->max_batch < ngroups) ? cvls_mem->max_batch : (int)ngroups;
+  if (cvLsBatchAlloc(cvls_mem, y, nb))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
   }
-  else
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+  for (g0 = 0; g0 < ngroups; g0 += nb)
   {
-    /* Call jac() routine to update J */
-    *jcur = SUNTRUE;
+    nstates = (int)SUNMIN(nb, ngroups - g0);
 
-    /* Clear the linear system matrix if necessary */
-    if (SUNLinSolGetType(cvls_mem->LS) == SUNLINEARSOLVER_DIRECT)
+    /* Load the states with all y_j in each group incremented */
+    for (k = 0; k < nstates; k++)
     {
-      retval = SUNMatZero(A);
-      if (retval)
+      group = g0 + k;
+      N_VScale(ONE, y, cvls_mem->ybatch[k]);
+      ytemp_data = N_VGetArrayPointer(cvls_mem->ybatch[k]);
+      for (j = group; j < N; j += width)
       {
-        cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
-                       MSG_LS_SUNMAT_FAILED);
-        cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
-        return (cvls_mem->last_flag);
+        ytemp_data[j] += cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data,
+                                   srur, minInc);
       }
     }
 
-    /* Compute new Jacobian matrix */
-    retval = cvls_mem->jac(t, y, fy, A, cvls_mem->J_data, vtemp1, vtemp2, vtemp3);
-    if (retval < 0)
-    {
-      cvProcessError(cv_mem, CVLS_JACFUNC_UNRECVR, __LINE__, __func__, __FILE__,
-                     MSG_LS_JACFUNC_FAILED);
-      cvls_mem->last_flag = CVLS_JACFUNC_UNRECVR;
-      return (-1);
-    }
-    if (retval > 0)
-    {
-      cvls_mem->last_flag = CVLS_JACFUNC_RECVR;
-      return (1);
-    }
+    retval = cvls_mem->fbatch(t, nstates, cvls_mem->ybatch, cvls_mem->fybatch,
+                              cv_mem->cv_user_data);
+    cvls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
 
-    /* Update saved copy of the Jacobian matrix */
-    retval = SUNMatCopy(A, cvls_mem->savedJ);
-    if (retval)
+    /* Form and load difference quotients */
+    for (k = 0; k < nstates; k++)
     {
-      cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
-                     MSG_LS_SUNMAT_FAILED);
-      cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
-      return (cvls_mem->last_flag);
+      group      = g0 + k;
+      ftemp_data = N_VGetArrayPointer(cvls_mem->fybatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv *
+                                             (ftemp_data[i] - fy_data[i]);
+        }
+      }
     }
   }
 
-  /* Perform linear combination A = I - gamma*J */
-  retval = SUNMatScaleAddI(-gamma, A);
-  if (retval)
-  {
-    cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
-                   MSG_LS_SUNMAT_FAILED);
-    cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
-    return (cvls_mem->last_flag);
-  }
-
-  return (CVLS_SUCCESS);
+  return (retval);
 }
 
 /*-----------------------------------------------------------------
-  cvLsInitialize
+  cvLsDQInc
 
-  This routine performs remaining initializations specific
-  to the iterative linear solver interface (and solver itself)
+  This routine returns the increment used for the jth column in the
+  DQ Jacobian approximations, with its sign adjusted if y_j has an
+  inequality constraint.
   -----------------------------------------------------------------*/
-int cvLsInitialize(CVodeMem cv_mem)
+static sunrealtype cvLsDQInc(CVodeMem cv_mem, sunindextype j,
+                             sunrealtype* y_data, sunrealtype* ewt_data,
+                             sunrealtype* cns_data, sunrealtype srur,
+                             sunrealtype minInc)
 {
-  CVLsMem cvls_mem;
-  int retval;
+  sunrealtype inc, conj;
 
-  /* access CVLsMem structure */
-  if (cv_mem->cv_lmem == NULL)
+  inc = SUNMAX(srur * SUNRabs(y_data[j]), minInc / ewt_data[j]);
+
+  if (cv_mem->cv_constraintsSet)
   {
-    cvProcessError(cv_mem, CVLS_LMEM_NULL, __LINE__, __func__, __FILE__,
+    conj = cns_data[j];
+    if (SUNRabs(conj) == ONE)
+    {
+      if ((y_data[j] + inc) * conj < ZERO) { inc = -inc; }
+    }
+    else if (SUNRabs(conj) == TWO)
+    {
+      if ((y_data[j] + inc) * conj <= ZERO) { inc = -inc; }
+    }
+  }
+
+  return (inc);
+}
+
+/*-----------------------------------------------------------------
+  cvLsBatchAlloc and cvLsBatchFree
+
+  These routines allocate (at least nvecs) and free the vectors
+  passed to the batched RHS function.
+  -----------------------------------------------------------------*/
+static int cvLsBatchAlloc(CVLsMem cvls_mem, N_Vector tmpl, int nvecs)
+{
+  if (cvls_mem->nbatch >= nvecs) { return (0); }
+
+  cvLsBatchFree(cvls_mem);
+
+  cvls_mem->ybatch  = N_VCloneVectorArray(nvecs, tmpl);
+  cvls_mem->fybatch = N_VCloneVectorArray(nvecs, tmpl);
+  if (cvls_mem->ybatch == NULL || cvls_mem->fybatch == NULL)
+  {
+    cvLsBatchFree(cvls_mem);
+    return (-1);
+  }
+  cvls_mem->nbatch = nvecs;
+
+  return (0);
+}
+
+/* Grow the workspace for solving nrhs systems together */
+static int cvLsMultiAlloc(CVLsMem cvls_mem, int nrhs)
+{
+  if (nrhs <= cvls_mem->nmulti) { return (0); }
+
+  cvLsMultiFree(cvls_mem);
+
+  cvls_mem->bmulti = (N_Vector*)malloc(nrhs * sizeof(N_Vector));
+  cvls_mem->cmulti = (sunrealtype*)malloc(nrhs * sizeof(sunrealtype));
+  cvls_mem->xmulti = N_VCloneVectorArray(nrhs, cvls_mem->x);
+  if (cvls_mem->bmulti == NULL || cvls_mem->cmulti == NULL ||
+      cvls_mem->xmulti == NULL)
+  {
+    cvLsMultiFree(cvls_mem);
+    return (-1);
+  }
+  cvls_mem->nmulti = nrhs;
+
+  return (0);
+}
+
+static void cvLsMultiFree(CVLsMem cvls_mem)
+{
+  if (cvls_mem->xmulti)
+  {
+    N_VDestroyVectorArray(cvls_mem->xmulti, cvls_mem->nmulti);
+  }
+  free(cvls_mem->bmulti);
+  free(cvls_mem->cmulti);
+  cvls_mem->bmulti = NULL;
+  cvls_mem->cmulti = NULL;
+  cvls_mem->xmulti = NULL;
+  cvls_mem->nmulti = 0;
+}
+
+static void cvLsBatchFree(CVLsMem cvls_mem)
+{
+  if (cvls_mem->ybatch)
+  {
+    N_VDestroyVectorArray(cvls_mem->ybatch, cvls_mem->nbatch);
+  }
+  if (cvls_mem->fybatch)
+  {
+    N_VDestroyVectorArray(cvls_mem->fybatch, cvls_mem->nbatch);
+  }
+  cvls_mem->ybatch  = NULL;
+  cvls_mem->fybatch = NULL;
+  cvls_mem->nbatch  = 0;
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+
+/*-----------------------------------------------------------------
+  cvLsDenseDQJacOMP
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of f(t,y) with the columns distributed across
+  dqnthreads OpenMP threads. Each thread perturbs its own copy of y
+  and the columns are formed exactly as in cvLsDenseDQJac, so the
+  result does not depend on the number of threads. If the RHS
+  function fails, the value returned for the first failed column is
+  returned.
+  -----------------------------------------------------------------*/
+static int cvLsDenseDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                             SUNMatrix Jac, CVodeMem cv_mem)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *y_data, *ewt_data, *cns_data;
+  sunindextype N;
+  CVLsMem cvls_mem;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* per-thread work vectors */
+  if (cvLsThreadAlloc(cvls_mem, y))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+#pragma omp parallel num_threads(cvls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = cvls_mem->ythr[tid];
+    N_Vector ftemp   = cvls_mem->fythr[tid];
+    N_Vector jthCol  = cvls_mem->colthr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype inc, inc_inv;
+    sunindextype j;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (j = 0; j < N; j++)
+    {
+      /* skip the remaining columns of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = j; }
+
+      inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+
+      ytd[j] += inc;
+      ier = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
+      nfe++;
+      ytd[j] = y_data[j];
+      if (ier != 0)
+      {
+        jfail = j;
+        ret   = ier;
+        continue;
+      }
+
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, ftemp, -inc_inv, fy, jthCol);
+    }
+
+    N_VSetArrayPointer(NULL, jthCol);
+
+    cvls_mem->thrfirst[tid] = jfirst;
+    cvls_mem->thrfail[tid]  = jfail;
+    cvls_mem->thrret[tid]   = ret;
+    cvls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (cvLsThreadRetval(cvls_mem, &cvls_mem->nfeDQ));
+}
+
+/*-----------------------------------------------------------------
+  cvLsBandDQJacOMP
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of f(t,y) with the column groups distributed
+  across dqnthreads OpenMP threads. Each thread perturbs its own
+  copy of y and the columns are formed exactly as in cvLsBandDQJac.
+  -----------------------------------------------------------------*/
+static int cvLsBandDQJacOMP(sunrealtype t, N_Vector y, N_Vector fy,
+                            SUNMatrix Jac, CVodeMem cv_mem)
+{
+  sunrealtype fnorm, minInc, srur;
+  sunrealtype *ewt_data, *fy_data, *y_data, *cns_data;
+  sunindextype width, ngroups, N, mupper, mlower;
+  CVLsMem cvls_mem;
+
+  /* access LsMem interface structure */
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* per-thread work vectors */
+  if (cvLsThreadAlloc(cvls_mem, y))
+  {
+    cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_MEM_FAIL);
+    return (CVLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, fy, y, and constraints */
+  ewt_data = N_VGetArrayPointer(cv_mem->cv_ewt);
+  fy_data  = N_VGetArrayPointer(fy);
+  y_data   = N_VGetArrayPointer(y);
+  cns_data = (cv_mem->cv_constraintsSet)
+               ? N_VGetArrayPointer(cv_mem->cv_constraints)
+               : NULL;
+
+  /* Set minimum increment based on uround and norm of f */
+  srur   = SUNRsqrt(cv_mem->cv_uround);
+  fnorm  = N_VWrmsNorm(fy, cv_mem->cv_ewt);
+  minInc = (fnorm != ZERO) ? (MIN_INC_MULT * SUNRabs(cv_mem->cv_h) *
+                              cv_mem->cv_uround * N * fnorm)
+                           : ONE;
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+#pragma omp parallel num_threads(cvls_mem->dqnthreads)
+  {
+    int tid          = omp_get_thread_num();
+    N_Vector ytemp   = cvls_mem->ythr[tid];
+    N_Vector ftemp   = cvls_mem->fythr[tid];
+    sunrealtype* ytd = N_VGetArrayPointer(ytemp);
+    sunrealtype* ftd = N_VGetArrayPointer(ftemp);
+    sunrealtype *col_j, inc, inc_inv;
+    sunindextype group, i, j, i1, i2;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, y, ytemp);
+
+#pragma omp for schedule(static)
+    for (group = 0; group < ngroups; group++)
+    {
+      /* skip the remaining groups of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = group; }
+
+      /* Increment all y_j in group */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] += cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur,
+                            minInc);
+      }
+
+      ier = cv_mem->cv_f(t, ytemp, ftemp, cv_mem->cv_user_data);
+      nfe++;
+      if (ier != 0)
+      {
+        jfail = group;
+        ret   = ier;
+        continue;
+      }
+
+      /* Restore ytemp, then form and load difference quotients */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j] = y_data[j];
+        col_j  = SUNBandMatrix_Column(Jac, j);
+        inc = cvLsDQInc(cv_mem, j, y_data, ewt_data, cns_data, srur, minInc);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv * (ftd[i] - fy_data[i]);
+        }
+      }
+    }
+
+    cvls_mem->thrfirst[tid] = jfirst;
+    cvls_mem->thrfail[tid]  = jfail;
+    cvls_mem->thrret[tid]   = ret;
+    cvls_mem->thrnfe[tid]   = nfe;
+  }
+
+  return (cvLsThreadRetval(cvls_mem, &cvls_mem->nfeDQ));
+}
+
+/*-----------------------------------------------------------------
+  cvLsThreadAlloc
+
+  This routine allocates the per-thread work vectors (if needed)
+  and resets the per-thread failure flags and counters.
+  -----------------------------------------------------------------*/
+static int cvLsThreadAlloc(CVLsMem cvls_mem, N_Vector tmpl)
+{
+  int nt = cvls_mem->dqnthreads;
+  int k;
+
+  if (cvls_mem->nthrvecs < nt)
+  {
+    cvLsThreadFree(cvls_mem);
+
+    cvls_mem->ythr     = N_VCloneVectorArray(nt, tmpl);
+    cvls_mem->fythr    = N_VCloneVectorArray(nt, tmpl);
+    cvls_mem->colthr   = N_VCloneEmptyVectorArray(nt, tmpl);
+    cvls_mem->thrfirst = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    cvls_mem->thrfail  = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    cvls_mem->thrret   = (int*)malloc(nt * sizeof(int));
+    cvls_mem->thrnfe   = (long int*)malloc(nt * sizeof(long int));
+    cvls_mem->nthrvecs = nt;
+    if (cvls_mem->ythr == NULL || cvls_mem->fythr == NULL ||
+        cvls_mem->colthr == NULL || cvls_mem->thrfail == NULL ||
+        cvls_mem->thrret == NULL || cvls_mem->thrnfe == NULL || cvls_mem->thrfirst == NULL)
+    {
+      cvLsThreadFree(cvls_mem);
+      return (-1);
+    }
+  }
+
+  for (k = 0; k < nt; k++)
+  {
+    cvls_mem->thrfirst[k] = -1;
+    cvls_mem->thrfail[k]  = -1;
+    cvls_mem->thrret[k]   = 0;
+    cvls_mem->thrnfe[k]   = 0;
+  }
+
+  return (0);
+}
+
+/*-----------------------------------------------------------------
+  cvLsThreadRetval
+
+  This routine adds the per-thread RHS evaluations to nfeDQ and
+  returns the RHS return value for the first failed column (or
+  group), i.e., the value the serial loop would return.
+  -----------------------------------------------------------------*/
+static int cvLsThreadRetval(CVLsMem cvls_mem, long int* nfeDQ)
+{
+  sunindextype jfail = -1;
+  int k, retval      = 0;
+
+  /* first failed column (or group) over all threads */
+  for (k = 0; k < cvls_mem->dqnthreads; k++)
+  {
+    if (cvls_mem->thrfail[k] >= 0 &&
+        (jfail < 0 || cvls_mem->thrfail[k] < jfail))
+    {
+      jfail  = cvls_mem->thrfail[k];
+      retval = cvls_mem->thrret[k];
+    }
+  }
+
+  /* the serial loop stops after the failed evaluation, so only the
+     threads whose block starts at or before it are counted */
+  for (k = 0; k < cvls_mem->dqnthreads; k++)
+  {
+    if (cvls_mem->thrfirst[k] >= 0 &&
+        (jfail < 0 || cvls_mem->thrfirst[k] <= jfail))
+    {
+      *nfeDQ += cvls_mem->thrnfe[k];
+    }
+  }
+
+  return (retval);
+}
+
+#endif
+
+/*-----------------------------------------------------------------
+  cvLsThreadFree
+
+  This routine frees the per-thread work vectors.
+  -----------------------------------------------------------------*/
+static void cvLsThreadFree(CVLsMem cvls_mem)
+{
+  if (cvls_mem->ythr)
+  {
+    N_VDestroyVectorArray(cvls_mem->ythr, cvls_mem->nthrvecs);
+  }
+  if (cvls_mem->fythr)
+  {
+    N_VDestroyVectorArray(cvls_mem->fythr, cvls_mem->nthrvecs);
+  }
+  if (cvls_mem->colthr)
+  {
+    N_VDestroyVectorArray(cvls_mem->colthr, cvls_mem->nthrvecs);
+  }
+  free(cvls_mem->thrfirst);
+  free(cvls_mem->thrfail);
+  free(cvls_mem->thrret);
+  free(cvls_mem->thrnfe);
+  cvls_mem->ythr     = NULL;
+  cvls_mem->fythr    = NULL;
+  cvls_mem->colthr   = NULL;
+  cvls_mem->thrfirst = NULL;
+  cvls_mem->thrfail  = NULL;
+  cvls_mem->thrret   = NULL;
+  cvls_mem->thrnfe   = NULL;
+  cvls_mem->nthrvecs = 0;
+}
+
+/*-----------------------------------------------------------------
+  cvLsDQJtimes
+
+  This routine generates a difference quotient approximation to
+  the Jacobian times vector f_y(t,y) * v. The approximation is
+  Jv = [f(y + v*sig) - f(y)]/sig, where sig = 1 / ||v||_WRMS,
+  i.e. the WRMS norm of v*sig is 1.
+  -----------------------------------------------------------------*/
+int cvLsDQJtimes(N_Vector v, N_Vector Jv, sunrealtype t, N_Vector y,
+                 N_Vector fy, void* cvode_mem, N_Vector work)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  sunrealtype sig, siginv;
+  int iter, retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+  /* Initialize perturbation to 1/||v|| */
+  sig = ONE / N_VWrmsNorm(v, cv_mem->cv_ewt);
+
+  for (iter = 0; iter < MAX_DQITERS; iter++)
+  {
+    /* Set work = y + sig*v */
+    N_VLinearSum(sig, v, ONE, y, work);
+
+    /* Set Jv = f(tn, y+sig*v) */
+    retval = cvls_mem->jt_f(t, work, Jv, cv_mem->cv_user_data);
+    cvls_mem->nfeDQ++;
+    if (retval == 0) { break; }
+    if (retval < 0) { return (-1); }
+
+    /* If f failed recoverably, shrink sig and retry */
+    sig *= PT25;
+  }
+
+  /* If retval still isn't 0, return with a recoverable failure */
+  if (retval > 0) { return (+1); }
+
+  /* Replace Jv by (Jv - fy)/sig */
+  siginv = ONE / sig;
+  N_VLinearSum(siginv, Jv, -siginv, fy, Jv);
+
+  return (0);
+}
+
+/*-----------------------------------------------------------------
+  cvLsLinSys
+
+  Setup the linear system A = I - gamma J
+  -----------------------------------------------------------------*/
+static int cvLsLinSys(sunrealtype t, N_Vector y, N_Vector fy, SUNMatrix A,
+                      sunbooleantype jok, sunbooleantype* jcur,
+                      sunrealtype gamma, void* cvode_mem, N_Vector vtemp1,
+                      N_Vector vtemp2, N_Vector vtemp3)
+{
+  CVodeMem cv_mem;
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  retval = cvLs_AccessLMem(cvode_mem, __func__, &cv_mem, &cvls_mem);
+  if (retval != CVLS_SUCCESS) { return (retval); }
+
+  /* Check if Jacobian needs to be updated */
+  if (jok)
+  {
+    /* Use saved copy of J */
+    *jcur = SUNFALSE;
+
+    /* Overwrite linear system matrix with saved J */
+    retval = SUNMatCopy(cvls_mem->savedJ, A);
+    if (retval)
+    {
+      cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
+                     MSG_LS_SUNMAT_FAILED);
+      cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
+      return (cvls_mem->last_flag);
+    }
+  }
+  else
+  {
+    /* Call jac() routine to update J */
+    *jcur = SUNTRUE;
+
+    /* Clear the linear system matrix if necessary */
+    if (SUNLinSolGetType(cvls_mem->LS) == SUNLINEARSOLVER_DIRECT)
+    {
+      retval = SUNMatZero(A);
+      if (retval)
+      {
+        cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
+                       MSG_LS_SUNMAT_FAILED);
+        cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
+        return (cvls_mem->last_flag);
+      }
+    }
+
+    /* Compute new Jacobian matrix */
+    retval = cvls_mem->jac(t, y, fy, A, cvls_mem->J_data, vtemp1, vtemp2, vtemp3);
+    if (retval < 0)
+    {
+      cvProcessError(cv_mem, CVLS_JACFUNC_UNRECVR, __LINE__, __func__, __FILE__,
+                     MSG_LS_JACFUNC_FAILED);
+      cvls_mem->last_flag = CVLS_JACFUNC_UNRECVR;
+      return (-1);
+    }
+    if (retval > 0)
+    {
+      cvls_mem->last_flag = CVLS_JACFUNC_RECVR;
+      return (1);
+    }
+
+    /* Update saved copy of the Jacobian matrix */
+    retval = SUNMatCopy(A, cvls_mem->savedJ);
+    if (retval)
+    {
+      cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
+                     MSG_LS_SUNMAT_FAILED);
+      cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
+      return (cvls_mem->last_flag);
+    }
+  }
+
+  /* Perform linear combination A = I - gamma*J */
+  retval = SUNMatScaleAddI(-gamma, A);
+  if (retval)
+  {
+    cvProcessError(cv_mem, CVLS_SUNMAT_FAIL, __LINE__, __func__, __FILE__,
+                   MSG_LS_SUNMAT_FAILED);
+    cvls_mem->last_flag = CVLS_SUNMAT_FAIL;
+    return (cvls_mem->last_flag);
+  }
+
+  return (CVLS_SUCCESS);
+}
+
+/*-----------------------------------------------------------------
+  cvLsInitialize
+
+  This routine performs remaining initializations specific
+  to the iterative linear solver interface (and solver itself)
+  -----------------------------------------------------------------*/
+int cvLsInitialize(CVodeMem cv_mem)
+{
+  CVLsMem cvls_mem;
+  int retval;
+
+  /* access CVLsMem structure */
+  if (cv_mem->cv_lmem == NULL)
+  {
+    cvProcessError(cv_mem, CVLS_LMEM_NULL, __LINE__, __func__, __FILE__,
                    MSG_LS_LMEM_NULL);
     return (CVLS_LMEM_NULL);
   }
@@ -1942,6 +2735,257 @@ int cvLsSolve(CVodeMem cv_mem, N_Vector b, N_Vector weight, N_Vector ynow,
   return (0);
 }
 
+/*-----------------------------------------------------------------
+  cvLsSolveMulti
+
+  This routine solves the linear systems with several right-hand
+  sides using SUNLinSolSolveMulti. Direct solvers do not use the
+  weights or tolerances and solve in place. Iterative solvers use
+  the weights of b[0] as scaling vectors for all systems, and each
+  right-hand side is scaled by the RMS norm of weight[i]/weight[0]
+  so that its residual is measured approximately in its own
+  weighted norm. Right-hand sides that are already small are not
+  passed to the solver and are not scaled, as in cvLsSolve. The
+  initial guesses are zero. If the block solve does not converge,
+  the systems are solved one at a time with cvLsSolve. The
+  solutions are returned in b.
+  -----------------------------------------------------------------*/
+int cvLsSolveMulti(CVodeMem cv_mem, int nrhs, N_Vector* b, N_Vector* weight,
+                   N_Vector ynow, N_Vector fnow)
+{
+  CVLsMem cvls_mem;
+  sunrealtype deltar, delta;
+  int curiter, nact, i, retval;
+
+  /* access CVLsMem structure */
+  if (cv_mem->cv_lmem == NULL)
+  {
+    cvProcessError(cv_mem, CVLS_LMEM_NULL, __LINE__, __func__, __FILE__,
+                   MSG_LS_LMEM_NULL);
+    return (CVLS_LMEM_NULL);
+  }
+  cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+
+  curiter = 0;
+  nact    = nrhs;
+  delta   = ZERO;
+
+  /* If the linear solver is iterative: skip the right-hand sides with small
+     norms, scale the others by their weight ratios, and set the tolerance */
+  if (cvls_mem->iterative)
+  {
+    if (cvLsMultiAlloc(cvls_mem, nrhs))
+    {
+      cvProcessError(cv_mem, CVLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                     MSG_LS_MEM_FAIL);
+      return (-1);
+    }
+
+    /* get current nonlinear solver iteration */
+    if (cv_mem->cv_ism == CV_SIMULTANEOUS)
+    {
+      retval = SUNNonlinSolGetCurIter(cv_mem->NLSsim, &curiter);
+    }
+    else { retval = SUNNonlinSolGetCurIter(cv_mem->NLSstg, &curiter); }
+
+    deltar = cvls_mem->eplifac * cv_mem->cv_tq[4];
+
+    retval = N_VWrmsNormVectorArray(nrhs, b, weight, cvls_mem->cmulti);
+    if (retval != 0) { return (-1); }
+
+    SUNLogInfo(CV_LOGGER, "begin-linear-solve",
+               "iterative = 1, nrhs = %d, b-tol = %.16g, res-tol = %.16g",
+               nrhs, deltar, deltar * cvls_mem->nrmfac);
+
+    /* the weight ratios are the RMS norms of weight[i] / weight[0] */
+    N_VInv(weight[0], cvls_mem->x);
+
+    nact = 0;
+    for (i = 0; i < nrhs; i++)
+    {
+      if (cvls_mem->cmulti[i] <= deltar)
+      {
+        if (curiter > 0) { N_VConst(ZERO, b[i]); }
+        continue;
+      }
+      cvls_mem->bmulti[nact] = b[i];
+      cvls_mem->cmulti[nact] = N_VWrmsNorm(weight[i], cvls_mem->x);
+      nact++;
+    }
+
+    if (nact == 0)
+    {
+      cvls_mem->last_flag = CVLS_SUCCESS;
+
+      SUNLogInfo(CV_LOGGER, "end-linear-solve", "status = success small rhs");
+
+      return (cvls_mem->last_flag);
+    }
+
+    retval = N_VScaleVectorArray(nact, cvls_mem->cmulti, cvls_mem->bmulti,
+                                 cvls_mem->bmulti);
+    if (retval != 0) { return (-1); }
+
+    /* Adjust tolerance for 2-norm */
+    delta = deltar * cvls_mem->nrmfac;
+
+    retval = SUNLinSolSetScalingVectors(cvls_mem->LS, weight[0], weight[0]);
+    if (retval != SUN_SUCCESS)
+    {
+      cvProcessError(cv_mem, CVLS_SUNLS_FAIL, __LINE__, __func__, __FILE__,
+                     "Error in calling SUNLinSolSetScalingVectors");
+      cvls_mem->last_flag = CVLS_SUNLS_FAIL;
+
+      SUNLogInfo(CV_LOGGER, "end-linear-solve",
+                 "status = failed set scaling vectors");
+
+      return (cvls_mem->last_flag);
+    }
+
+    retval = SUNLinSolSetZeroGuess(cvls_mem->LS, SUNTRUE);
+    if (retval != SUN_SUCCESS)
+    {
+      SUNLogInfo(CV_LOGGER, "end-linear-solve",
+                 "status = failed set zero guess", "");
+      return (-1);
+    }
+  }
+  else
+  {
+    SUNLogInfo(CV_LOGGER, "begin-linear-solve", "iterative = 0, nrhs = %d",
+               nrhs);
+  }
+
+  /* Set vectors ycur and fcur for use by the Jacobian routines */
+  cvls_mem->ycur = ynow;
+  cvls_mem->fcur = fnow;
+
+  /* If a user-provided jtsetup routine is supplied, call that here */
+  if (cvls_mem->jtsetup)
+  {
+    cvls_mem->last_flag = cvls_mem->jtsetup(cv_mem->cv_tn, ynow, fnow,
+                                            cvls_mem->jt_data);
+    cvls_mem->njtsetup++;
+    if (cvls_mem->last_flag != 0)
+    {
+      cvProcessError(cv_mem, cvls_mem->last_flag, __LINE__, __func__, __FILE__,
+                     MSG_LS_JTSETUP_FAILED);
+
+      SUNLogInfo(CV_LOGGER, "end-linear-solve", "status = failed J-times setup",
+                 "");
+      return (cvls_mem->last_flag);
+    }
+  }
+
+  if (cvls_mem->iterative)
+  {
+    /* Set the initial guesses to zero, as in cvLsSolve, and call the solver
+       with the solutions in xmulti */
+    retval = N_VConstVectorArray(nact, ZERO, cvls_mem->xmulti);
+    if (retval != 0) { return (-1); }
+
+    retval = SUNLinSolSolveMulti(cvls_mem->LS, cvls_mem->A, nact,
+                                 cvls_mem->xmulti, cvls_mem->bmulti, delta);
+    if (cvls_mem->LS->ops->numiters)
+    {
+      cvls_mem->nli += SUNLinSolNumIters(cvls_mem->LS);
+    }
+
+    for (i = 0; i < nact; i++)
+    {
+      cvls_mem->cmulti[i] = ONE / cvls_mem->cmulti[i];
+    }
+
+    /* only accept a converged block solve, a reduced residual is retried
+       one system at a time below */
+    if (retval == SUN_SUCCESS)
+    {
+      /* copy the solutions to b and undo the weight scaling */
+      cvls_mem->last_flag = retval;
+      (void)N_VScaleVectorArray(nact, cvls_mem->cmulti, cvls_mem->xmulti,
+                                cvls_mem->bmulti);
+
+      /* scale only the solved systems, the skipped ones are left as is */
+      if (cvls_mem->scalesol && cv_mem->cv_gamrat != ONE)
+      {
+        for (i = 0; i < nact; i++)
+        {
+          N_VScale(TWO / (ONE + cv_mem->cv_gamrat), cvls_mem->bmulti[i],
+                   cvls_mem->bmulti[i]);
+        }
+      }
+
+      SUNLogInfo(CV_LOGGER, "end-linear-solve", "status = success", "");
+
+      return (0);
+    }
+
+    cvls_mem->ncfl++;
+    cvls_mem->last_flag = retval;
+
+    SUNLogInfo(CV_LOGGER, "end-linear-solve",
+               "status = failed block solve, retval = %i", retval);
+
+    if (retval < 0)
+    {
+      if (retval == SUNLS_ATIMES_FAIL_UNREC)
+      {
+        cvProcessError(cv_mem, SUNLS_ATIMES_FAIL_UNREC, __LINE__, __func__,
+                       __FILE__, MSG_LS_JTIMES_FAILED);
+      }
+      if (retval == SUNLS_PSOLVE_FAIL_UNREC)
+      {
+        cvProcessError(cv_mem, SUNLS_PSOLVE_FAIL_UNREC, __LINE__, __func__,
+                       __FILE__, MSG_LS_PSOLVE_FAILED);
+      }
+      return (-1);
+    }
+
+    /* Solve the systems one at a time with their own weights */
+    (void)N_VScaleVectorArray(nact, cvls_mem->cmulti, cvls_mem->bmulti,
+                              cvls_mem->bmulti);
+    for (i = 0; i < nrhs; i++)
+    {
+      retval = cvLsSolve(cv_mem, b[i], weight[i], ynow, fnow);
+      if (retval != 0) { return (retval); }
+    }
+
+    return (0);
+  }
+
+  /* Call solver, overwriting b with the solutions */
+  retval = SUNLinSolSolveMulti(cvls_mem->LS, cvls_mem->A, nrhs, b, b, ZERO);
+
+  /* If using a BDF method and gamma has changed, scale the corrections to
+     account for change in gamma */
+  if (cvls_mem->scalesol && cv_mem->cv_gamrat != ONE)
+  {
+    for (i = 0; i < nrhs; i++)
+    {
+      N_VScale(TWO / (ONE + cv_mem->cv_gamrat), b[i], b[i]);
+    }
+  }
+
+  /* Increment counter ncfl */
+  if (retval != SUN_SUCCESS) { cvls_mem->ncfl++; }
+
+  /* Interpret solver return value  */
+  cvls_mem->last_flag = retval;
+
+  SUNLogInfoIf(retval == SUN_SUCCESS, CV_LOGGER, "end-linear-solve",
+               "status = success", "");
+  SUNLogInfoIf(retval != SUN_SUCCESS, CV_LOGGER, "end-linear-solve",
+               "status = failed, retval = %i", retval);
+
+  if (retval == SUN_SUCCESS) { return (0); }
+  if (retval == SUN_ERR_EXT_FAIL)
+  {
+    cvProcessError(cv_mem, SUN_ERR_EXT_FAIL, __LINE__, __func__, __FILE__,
+                   "Failure in SUNLinSol external package");
+  }
+  return ((retval < 0) ? -1 : 1);
+}
+
 /*-----------------------------------------------------------------
   cvLsFree
 
@@ -1976,6 +3020,11 @@ int cvLsFree(CVodeMem cv_mem)
     cvls_mem->savedJ = NULL;
   }
 
+  /* Free batched RHS, per-thread, and multiple RHS workspace */
+  cvLsBatchFree(cvls_mem);
+  cvLsThreadFree(cvls_mem);
+  cvLsMultiFree(cvls_mem);
+
   /* Nullify other N_Vector pointers */
   cvls_mem->ycur = NULL;
   cvls_mem->fcur = NULL;
@@ -345,6 +345,20 @@ static int cvNlsLSolveSensSim(N_Vector deltaSim, void* cvode_mem)
   }
   cv_mem = (CVodeMem)cvode_mem;
 
+  /* solve the state and sensitivity linear systems together if possible */
+  if (cv_mem->cv_lsolvemulti)
+  {
+    retval = cv_mem->cv_lsolvemulti(cv_mem, cv_mem->cv_Ns + 1,
+                                    NV_VECS_SW(deltaSim),
+                                    NV_VECS_SW(cv_mem->ewtSim), cv_mem->cv_y,
+                                    cv_mem->cv_ftemp);
+
+    if (retval < 0) { return (CV_LSOLVE_FAIL); }
+    if (retval > 0) { return (SUN_NLS_CONV_RECVR); }
+
+    return (CV_SUCCESS);
+  }
+
   /* extract state delta from the vector wrapper */
   delta = NV_VEC_SW(deltaSim, 0);
 
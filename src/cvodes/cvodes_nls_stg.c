@@ -290,6 +290,19 @@ static int cvNlsLSolveSensStg(N_Vector deltaStg, void* cvode_mem)
   /* extract sensitivity deltas from the vector wrapper */
   deltaS = NV_VECS_SW(deltaStg);
 
+  /* solve the sensitivity linear systems together if possible */
+  if (cv_mem->cv_lsolvemulti)
+  {
+    retval = cv_mem->cv_lsolvemulti(cv_mem, cv_mem->cv_Ns, deltaS,
+                                    cv_mem->cv_ewtS, cv_mem->cv_y,
+                                    cv_mem->cv_ftemp);
+
+    if (retval < 0) { return (CV_LSOLVE_FAIL); }
+    if (retval > 0) { return (SUN_NLS_CONV_RECVR); }
+
+    return (CV_SUCCESS);
+  }
+
   /* solve the sensitivity linear systems */
   for (is = 0; is < cv_mem->cv_Ns; is++)
   {
@@ -89,6 +89,7 @@
 #include <sunnonlinsol/sunnonlinsol_newton.h>
 
 #include "ida_impl.h"
+#include "ida_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
 
 /*
@@ -250,6 +251,12 @@ static int IDARcheck2(IDAMem IDA_mem);
 static int IDARcheck3(IDAMem IDA_mem);
 static int IDARootfind(IDAMem IDA_mem);
 
+/* Step trace functions */
+
+static void IDAStepTraceCounters(IDAMem IDA_mem, long int counters[]);
+static void IDAStepTraceRecord(IDAMem IDA_mem, SUNStepTrace trace,
+                               int sflag, const long int start[]);
+
 /*
  * =================================================================
  * EXPORTED FUNCTIONS IMPLEMENTATION
@@ -296,6 +303,8 @@ void* IDACreate(SUNContext sunctx)
   memset(IDA_mem, 0, sizeof(struct IDAMemRec));
 
   IDA_mem->ida_sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct IDAMemRec));
 
   /* Set unit roundoff in IDA_mem */
   IDA_mem->ida_uround = SUN_UNIT_ROUNDOFF;
@@ -1069,6 +1078,8 @@ int IDASolve(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
   sunrealtype tdist, troundoff, ypnorm, rh, nrm;
   IDAMem IDA_mem;
   sunbooleantype inactive_roots;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   /* Check for legal inputs in all cases. */
 
@@ -1397,8 +1408,13 @@ int IDASolve(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
 
     /* Call IDAStep to take a step. */
 
+    trace = IDA_STEPTRACE;
+    if (trace) { IDAStepTraceCounters(IDA_mem, trace_start); }
+
     sflag = IDAStep(IDA_mem);
 
+    if (trace) { IDAStepTraceRecord(IDA_mem, trace, sflag, trace_start); }
+
     /* Process all failed-step cases, and exit loop. */
 
     if (sflag != IDA_SUCCESS)
@@ -1720,6 +1736,8 @@ void IDAFree(void** ida_mem)
     IDA_mem->ida_gactive = NULL;
   }
 
+  sunMemAccountFree(IDA_mem->ida_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct IDAMemRec));
   free(*ida_mem);
   *ida_mem = NULL;
 }
@@ -3963,6 +3981,74 @@ static int IDARootfind(IDAMem IDA_mem)
   return (RTFOUND);
 }
 
+/*
+ * =================================================================
+ * Step trace functions
+ * =================================================================
+ */
+
+/*
+ * IDAStepTraceCounters
+ *
+ * Samples the cumulative integrator and linear solver counters that
+ * are differenced to form a step trace record.
+ */
+
+static void IDAStepTraceCounters(IDAMem IDA_mem, long int counters[])
+{
+  IDALsMem idals_mem = NULL;
+
+  counters[SUN_STEPTRACE_NETF]    = IDA_mem->ida_netf;
+  counters[SUN_STEPTRACE_NCFN]    = IDA_mem->ida_ncfn;
+  counters[SUN_STEPTRACE_NNI]     = IDA_mem->ida_nni;
+  counters[SUN_STEPTRACE_NSETUPS] = IDA_mem->ida_nsetups;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  if (IDA_mem->ida_lmem)
+  {
+    idals_mem                       = (IDALsMem)IDA_mem->ida_lmem;
+    counters[SUN_STEPTRACE_NLI]     = idals_mem->nli;
+    counters[SUN_STEPTRACE_NJEVALS] = idals_mem->nje;
+  }
+}
+
+/*
+ * IDAStepTraceRecord
+ *
+ * Writes a record for the step just attempted by IDAStep to trace, the
+ * step trace that was attached to the SUNContext when the counters in
+ * start were sampled. On failure the record holds the step size and
+ * order of the last attempt.
+ */
+
+static void IDAStepTraceRecord(IDAMem IDA_mem, SUNStepTrace trace,
+                               int sflag, const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  IDAStepTraceCounters(IDA_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_IDA, start, end);
+
+  record.t    = (double)IDA_mem->ida_tn;
+  record.flag = sflag;
+  if (sflag == IDA_SUCCESS)
+  {
+    record.h     = (double)IDA_mem->ida_hused;
+    record.step  = IDA_mem->ida_nst;
+    record.order = IDA_mem->ida_kused;
+  }
+  else
+  {
+    record.h     = (double)IDA_mem->ida_hh;
+    record.step  = IDA_mem->ida_nst + 1;
+    record.order = IDA_mem->ida_kk;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
 /*
  * =================================================================
  * IDA error message handling functions
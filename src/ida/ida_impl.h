@@ -26,6 +26,7 @@
 
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
 extern "C" {
@@ -43,8 +44,9 @@ extern "C" {
 /* Shortcuts                                                       */
 /*=================================================================*/
 
-#define IDA_PROFILER IDA_mem->ida_sunctx->profiler
-#define IDA_LOGGER   IDA_mem->ida_sunctx->logger
+#define IDA_PROFILER  IDA_mem->ida_sunctx->profiler
+#define IDA_LOGGER    IDA_mem->ida_sunctx->logger
+#define IDA_STEPTRACE IDA_mem->ida_sunctx->steptrace
 
 /*
  * =================================================================
@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sundials/sundials_math.h>
 
 #include "idas_impl.h"
@@ -36,6 +37,9 @@
 #define HUNDRED     SUN_RCONST(100.0)     /* real 100.0 */
 #define FUZZ_FACTOR SUN_RCONST(1000000.0) /* fuzz factor for IDAAgetY */
 
+/* Default number of data points kept in memory with disk storage */
+#define IDAA_NCACHE_DEFAULT (2 * MXORDP1)
+
 /*=================================================================*/
 /* Shortcuts                                                       */
 /*=================================================================*/
@@ -84,6 +88,13 @@ static int IDAArhsQ(sunrealtype tt, N_Vector yyB, N_Vector ypB, N_Vector rrQB,
 static int IDAAGettnSolutionYp(IDAMem IDA_mem, N_Vector yp);
 static int IDAAGettnSolutionYpS(IDAMem IDA_mem, N_Vector* ypS);
 
+static int IDAAstorageInit(IDAMem IDA_mem);
+static void IDAAstorageFree(IDAMem IDA_mem);
+static int IDAAdataStorePnt(IDAMem IDA_mem, long int i);
+static int IDAAckpntWrite(IDAMem IDA_mem, IDAckpntMem ck_mem);
+static int IDAAckpntRead(IDAMem IDA_mem, IDAckpntMem ck_mem);
+static void IDAAckpntPrefetch(IDAMem IDA_mem, IDAckpntMem ck_mem);
+
 extern int IDAGetSolution(void* ida_mem, sunrealtype t, N_Vector yret,
                           N_Vector ypret);
 
@@ -156,6 +167,25 @@ int IDAAdjInit(void* ida_mem, long int steps, int interp)
   /* Last index used in IDAAfindIndex, initialize to invalid value */
   IDAADJ_mem->ia_ilast = -1;
 
+  /* Interpolation workspace, allocated at the first call to IDASolveF */
+  IDAADJ_mem->ia_yyTmp  = NULL;
+  IDAADJ_mem->ia_ypTmp  = NULL;
+  IDAADJ_mem->ia_yySTmp = NULL;
+  IDAADJ_mem->ia_ypSTmp = NULL;
+
+  /* By default all data is kept in memory */
+  IDAADJ_mem->ia_storeDir      = NULL;
+  IDAADJ_mem->ia_storeCompress = SUNFALSE;
+  IDAADJ_mem->ia_ncache        = 0;
+  IDAADJ_mem->ia_store         = NULL;
+  IDAADJ_mem->ia_storeBuf      = NULL;
+  IDAADJ_mem->ia_storeVecs     = NULL;
+  IDAADJ_mem->ia_slotContent   = NULL;
+  IDAADJ_mem->ia_slotPnt       = NULL;
+  IDAADJ_mem->ia_slotUsed      = NULL;
+  IDAADJ_mem->ia_slotDirty     = NULL;
+  IDAADJ_mem->ia_pntSlot       = NULL;
+
   /* Allocate space for the array of Data Point structures. */
   if (IDAAdataMalloc(IDA_mem) == SUNFALSE)
   {
@@ -263,6 +293,12 @@ int IDAAdjReInit(void* ida_mem)
   IDAADJ_mem->ia_nckpnts   = 0;
   IDAADJ_mem->ia_ckpntData = NULL;
 
+  /* Reuse the check point space in the storage file */
+  if (IDAADJ_mem->ia_store != NULL)
+  {
+    IDAADJ_mem->ia_ckOffset = IDAADJ_mem->ia_ckBase;
+  }
+
   /* Flags for tracking the first calls to IDASolveF and IDASolveF. */
   IDAADJ_mem->ia_firstIDAFcall = SUNTRUE;
   IDAADJ_mem->ia_tstopIDAFcall = SUNFALSE;
@@ -305,6 +341,8 @@ void IDAAdjFree(void* ida_mem)
       IDAAbckpbDelete(&(IDAADJ_mem->IDAB_mem));
     }
 
+    free(IDAADJ_mem->ia_storeDir);
+
     /* Free IDAA memory. */
     free(IDAADJ_mem);
 
@@ -468,6 +506,17 @@ int IDASolveF(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
       /* Do we need to store sensitivities? */
       if (!IDA_mem->ida_sensi) { IDAADJ_mem->ia_storeSensi = SUNFALSE; }
 
+      /* How many data points are kept in memory with disk storage? */
+      if (IDAADJ_mem->ia_storeDir != NULL)
+      {
+        if (IDAADJ_mem->ia_ncache == 0)
+        {
+          IDAADJ_mem->ia_ncache = IDAA_NCACHE_DEFAULT;
+        }
+        IDAADJ_mem->ia_ncache = SUNMIN(IDAADJ_mem->ia_ncache,
+                                       IDAADJ_mem->ia_nsteps);
+      }
+
       /* Allocate space for interpolation data */
       allocOK = IDAADJ_mem->ia_malloc(IDA_mem);
       if (!allocOK)
@@ -478,6 +527,18 @@ int IDASolveF(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
         return (IDA_MEM_FAIL);
       }
 
+      /* Set up the storage file */
+      if (IDAADJ_mem->ia_storeDir != NULL)
+      {
+        flag = IDAAstorageInit(IDA_mem);
+        if (flag != IDA_SUCCESS)
+        {
+          IDAADJ_mem->ia_free(IDA_mem);
+          SUNDIALS_MARK_FUNCTION_END(IDA_PROFILER);
+          return (flag);
+        }
+      }
+
       /* Rename phi and, if needed, phiS for use in interpolation */
       for (i = 0; i < MXORDP1; i++)
       {
@@ -495,7 +556,7 @@ int IDASolveF(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
     }
 
     dt_mem[0]->t = IDAADJ_mem->ck_mem->ck_t0;
-    IDAADJ_mem->ia_storePnt(IDA_mem, dt_mem[0]);
+    IDAAdataStorePnt(IDA_mem, 0);
 
     IDAADJ_mem->ia_firstIDAFcall = SUNFALSE;
   }
@@ -584,14 +645,18 @@ int IDASolveF(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
 
       /* Reset i=0 and load dt_mem[0] */
       dt_mem[0]->t = IDAADJ_mem->ck_mem->ck_t0;
-      IDAADJ_mem->ia_storePnt(IDA_mem, dt_mem[0]);
+      IDAAdataStorePnt(IDA_mem, 0);
     }
     else
     {
       /* Load next point in dt_mem */
       dt_mem[IDA_mem->ida_nst % IDAADJ_mem->ia_nsteps]->t = IDA_mem->ida_tn;
-      IDAADJ_mem->ia_storePnt(IDA_mem,
-                              dt_mem[IDA_mem->ida_nst % IDAADJ_mem->ia_nsteps]);
+      if (IDAAdataStorePnt(IDA_mem, IDA_mem->ida_nst % IDAADJ_mem->ia_nsteps) ==
+          IDA_MEM_FAIL)
+      {
+        flag = IDA_MEM_FAIL;
+        break;
+      }
     }
 
     /* Set t1 field of the current check point structure
@@ -641,6 +706,9 @@ int IDASolveF(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
   IDAADJ_mem->ia_ckpntData = IDAADJ_mem->ck_mem;
   IDAADJ_mem->ia_np        = IDA_mem->ida_nst % IDAADJ_mem->ia_nsteps + 1;
 
+  /* Start reading the check point needed first by IDASolveB */
+  IDAAckpntPrefetch(IDA_mem, IDAADJ_mem->ck_mem->ck_next);
+
   SUNDIALS_MARK_FUNCTION_END(IDA_PROFILER);
   return (flag);
 }
@@ -1747,6 +1815,9 @@ int IDASolveB(void* ida_mem, sunrealtype tBout, int itaskB)
   /* Loop while propagating backward problems */
   for (;;)
   {
+    /* Start reading the check point of the next interval */
+    IDAAckpntPrefetch(IDA_mem, ck_mem->ck_next);
+
     /* Store interpolation data if not available.
        This is the 2nd forward integration pass */
     if (ck_mem != IDAADJ_mem->ia_ckpntData)
@@ -2000,6 +2071,10 @@ static IDAckpntMem IDAAckpntInit(IDAMem IDA_mem)
   /* Alloc 3: current order, i.e. 1,  +   2. */
   ck_mem->ck_phi_alloc = 3;
 
+  /* The first check point is always kept in memory */
+  ck_mem->ck_offset = -1;
+  ck_mem->ck_size   = 0;
+
   if (!IDAAckpntAllocVectors(IDA_mem, ck_mem))
   {
     free(ck_mem);
@@ -2071,6 +2146,20 @@ static IDAckpntMem IDAAckpntNew(IDAMem IDA_mem)
   ck_mem->ck_phi_alloc = (IDA_mem->ida_kk + 2 < MXORDP1) ? IDA_mem->ida_kk + 2
                                                          : MXORDP1;
 
+  /* With disk storage, write the phi* vectors to the storage file */
+  ck_mem->ck_offset = -1;
+  ck_mem->ck_size   = 0;
+
+  if (IDA_mem->ida_adj_mem->ia_store != NULL)
+  {
+    if (IDAAckpntWrite(IDA_mem, ck_mem) != IDA_SUCCESS)
+    {
+      free(ck_mem);
+      ck_mem = NULL;
+    }
+    return (ck_mem);
+  }
+
   if (!IDAAckpntAllocVectors(IDA_mem, ck_mem))
   {
     free(ck_mem);
@@ -2101,6 +2190,13 @@ static void IDAAckpntDelete(IDAckpntMem* ck_memPtr)
     /* move head of list */
     *ck_memPtr = (*ck_memPtr)->ck_next;
 
+    /* nothing else to free if the vectors are in the storage file */
+    if (tmp->ck_offset >= 0)
+    {
+      free(tmp);
+      return;
+    }
+
     /* free N_Vectors in tmp */
     for (j = 0; j < tmp->ck_phi_alloc; j++) { N_VDestroy(tmp->ck_phi[j]); }
 
@@ -2367,6 +2463,9 @@ static void IDAAdataFree(IDAMem IDA_mem)
 
   if (IDAADJ_mem == NULL) { return; }
 
+  /* Close the storage file and return the cached data to the data points */
+  IDAAstorageFree(IDA_mem);
+
   /* Destroy data points by calling the interpolation's 'free' routine. */
   IDAADJ_mem->ia_free(IDA_mem);
 
@@ -2410,7 +2509,7 @@ static int IDAAdataStore(IDAMem IDA_mem, IDAckpntMem ck_mem)
 
   /* Set first structure in dt_mem[0] */
   dt_mem[0]->t = ck_mem->ck_t0;
-  IDAADJ_mem->ia_storePnt(IDA_mem, dt_mem[0]);
+  IDAAdataStorePnt(IDA_mem, 0);
 
   /* Decide whether TSTOP must be activated */
   if (IDAADJ_mem->ia_tstopIDAFcall)
@@ -2428,7 +2527,8 @@ static int IDAAdataStore(IDAMem IDA_mem, IDAckpntMem ck_mem)
     if (flag < 0) { return (IDA_FWD_FAIL); }
 
     dt_mem[i]->t = t;
-    IDAADJ_mem->ia_storePnt(IDA_mem, dt_mem[i]);
+    flag         = IDAAdataStorePnt(IDA_mem, i);
+    if (flag == IDA_MEM_FAIL) { return (IDA_FWD_FAIL); }
 
     i++;
   }
@@ -2505,13 +2605,22 @@ static int IDAAckpntGet(IDAMem IDA_mem, IDAckpntMem ck_mem)
     IDA_mem->ida_ss       = ck_mem->ck_ss;
     IDA_mem->ida_ssS      = ck_mem->ck_ssS;
 
-    /* Copy the arrays from check point data structure */
-    for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+    /* Read the arrays from the storage file or copy them from check point
+       data structure */
+    if (ck_mem->ck_offset >= 0)
+    {
+      flag = IDAAckpntRead(IDA_mem, ck_mem);
+      if (flag != IDA_SUCCESS) { return (flag); }
+    }
+    else
     {
-      N_VScale(ONE, ck_mem->ck_phi[j], IDA_mem->ida_phi[j]);
+      for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+      {
+        N_VScale(ONE, ck_mem->ck_phi[j], IDA_mem->ida_phi[j]);
+      }
     }
 
-    if (ck_mem->ck_quadr)
+    if (ck_mem->ck_quadr && ck_mem->ck_offset < 0)
     {
       for (j = 0; j < ck_mem->ck_phi_alloc; j++)
       {
@@ -2519,7 +2628,7 @@ static int IDAAckpntGet(IDAMem IDA_mem, IDAckpntMem ck_mem)
       }
     }
 
-    if (ck_mem->ck_sensi)
+    if (ck_mem->ck_sensi && ck_mem->ck_offset < 0)
     {
       for (is = 0; is < IDA_mem->ida_Ns; is++)
       {
@@ -2530,7 +2639,7 @@ static int IDAAckpntGet(IDAMem IDA_mem, IDAckpntMem ck_mem)
       }
     }
 
-    if (ck_mem->ck_quadr_sensi)
+    if (ck_mem->ck_quadr_sensi && ck_mem->ck_offset < 0)
     {
       for (is = 0; is < IDA_mem->ida_Ns; is++)
       {
@@ -2557,6 +2666,665 @@ static int IDAAckpntGet(IDAMem IDA_mem, IDAckpntMem ck_mem)
   return (IDA_SUCCESS);
 }
 
+/*
+ * -----------------------------------------------------------------
+ * Functions for disk storage of check point and interpolation data
+ * -----------------------------------------------------------------
+ */
+
+/*
+ * IDAAbufSize, IDAAbufPack, IDAAbufUnpack
+ *
+ * Size of the buffer for n vectors and packing/unpacking of the
+ * vectors into/from the buffer.
+ */
+
+static int IDAAbufSize(int n, N_Vector* vecs, size_t* size)
+{
+  sunindextype vsize;
+  int i;
+
+  *size = 0;
+  for (i = 0; i < n; i++)
+  {
+    if (N_VBufSize(vecs[i], &vsize) != SUN_SUCCESS) { return (-1); }
+    *size += (size_t)vsize;
+  }
+
+  return (0);
+}
+
+static int IDAAbufPack(int n, N_Vector* vecs, char* buf)
+{
+  sunindextype vsize;
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    if (N_VBufSize(vecs[i], &vsize) != SUN_SUCCESS) { return (-1); }
+    if (N_VBufPack(vecs[i], buf) != SUN_SUCCESS) { return (-1); }
+    buf += vsize;
+  }
+
+  return (0);
+}
+
+static int IDAAbufUnpack(int n, N_Vector* vecs, char* buf)
+{
+  sunindextype vsize;
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    if (N_VBufSize(vecs[i], &vsize) != SUN_SUCCESS) { return (-1); }
+    if (N_VBufUnpack(vecs[i], buf) != SUN_SUCCESS) { return (-1); }
+    buf += vsize;
+  }
+
+  return (0);
+}
+
+/*
+ * IDAAckpntVectors
+ *
+ * Collects the phi* vectors in IDA_mem saved at the check point
+ * ck_mem in the array vecs. Returns the number of vectors.
+ */
+
+static int IDAAckpntVectors(IDAMem IDA_mem, IDAckpntMem ck_mem, N_Vector* vecs)
+{
+  int j, is, n;
+
+  n = 0;
+  for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+  {
+    vecs[n++] = IDA_mem->ida_phi[j];
+  }
+
+  if (ck_mem->ck_quadr)
+  {
+    for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+    {
+      vecs[n++] = IDA_mem->ida_phiQ[j];
+    }
+  }
+
+  if (ck_mem->ck_sensi)
+  {
+    for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+    {
+      for (is = 0; is < IDA_mem->ida_Ns; is++)
+      {
+        vecs[n++] = IDA_mem->ida_phiS[j][is];
+      }
+    }
+  }
+
+  if (ck_mem->ck_quadr_sensi)
+  {
+    for (j = 0; j < ck_mem->ck_phi_alloc; j++)
+    {
+      for (is = 0; is < IDA_mem->ida_Ns; is++)
+      {
+        vecs[n++] = IDA_mem->ida_phiQS[j][is];
+      }
+    }
+  }
+
+  return (n);
+}
+
+/*
+ * IDAAdataVectors
+ *
+ * Collects the vectors of the data point content (not the first
+ * data point) in the array vecs. Returns the number of vectors.
+ */
+
+static int IDAAdataVectors(IDAMem IDA_mem, void* content, N_Vector* vecs)
+{
+  IDAadjMem IDAADJ_mem;
+  IDAhermiteDataMem hcontent;
+  IDApolynomialDataMem pcontent;
+  int is, n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  n = 0;
+  if (IDAADJ_mem->ia_interpType == IDA_HERMITE)
+  {
+    hcontent  = (IDAhermiteDataMem)content;
+    vecs[n++] = hcontent->y;
+    vecs[n++] = hcontent->yd;
+    if (IDAADJ_mem->ia_storeSensi)
+    {
+      for (is = 0; is < IDA_mem->ida_Ns; is++) { vecs[n++] = hcontent->yS[is]; }
+      for (is = 0; is < IDA_mem->ida_Ns; is++)
+      {
+        vecs[n++] = hcontent->ySd[is];
+      }
+    }
+  }
+  else
+  {
+    pcontent  = (IDApolynomialDataMem)content;
+    vecs[n++] = pcontent->y;
+    if (IDAADJ_mem->ia_storeSensi)
+    {
+      for (is = 0; is < IDA_mem->ida_Ns; is++) { vecs[n++] = pcontent->yS[is]; }
+    }
+  }
+
+  return (n);
+}
+
+/*
+ * IDAAstorageInit
+ *
+ * This routine creates the storage file and the cache of data
+ * points. The content structures allocated by the interpolation
+ * module for the data points 1,...,ncache become the cache slots.
+ */
+
+static int IDAAstorageInit(IDAMem IDA_mem)
+{
+  IDAadjMem IDAADJ_mem;
+  IDAdtpntMem* dt_mem;
+  N_Vector v;
+  long int i, ncache;
+  int n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+  dt_mem     = IDAADJ_mem->dt_mem;
+  ncache     = IDAADJ_mem->ia_ncache;
+
+  /* The vectors must support packing into a buffer */
+  v = IDA_mem->ida_phi[0];
+  if (v->ops->nvbufsize == NULL || v->ops->nvbufpack == NULL ||
+      v->ops->nvbufunpack == NULL)
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_NO_BUFOPS);
+    return (IDA_ILL_INPUT);
+  }
+
+  if (IDA_mem->ida_quadr)
+  {
+    v = IDA_mem->ida_phiQ[0];
+    if (v->ops->nvbufsize == NULL || v->ops->nvbufpack == NULL ||
+        v->ops->nvbufunpack == NULL)
+    {
+      IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                      MSGAM_NO_BUFOPS);
+      return (IDA_ILL_INPUT);
+    }
+  }
+
+  /* Vector list, large enough for a check point */
+  IDAADJ_mem->ia_storeVecs =
+    (N_Vector*)malloc(2 * MXORDP1 * (IDA_mem->ida_Ns + 1) * sizeof(N_Vector));
+
+  /* Cache tables */
+  IDAADJ_mem->ia_slotContent = (void**)malloc(ncache * sizeof(void*));
+  IDAADJ_mem->ia_slotPnt     = (long int*)malloc(ncache * sizeof(long int));
+  IDAADJ_mem->ia_slotUsed    = (long int*)malloc(ncache * sizeof(long int));
+  IDAADJ_mem->ia_slotDirty =
+    (sunbooleantype*)malloc(ncache * sizeof(sunbooleantype));
+  IDAADJ_mem->ia_pntSlot =
+    (long int*)malloc((IDAADJ_mem->ia_nsteps + 1) * sizeof(long int));
+
+  if (IDAADJ_mem->ia_storeVecs == NULL || IDAADJ_mem->ia_slotContent == NULL ||
+      IDAADJ_mem->ia_slotPnt == NULL || IDAADJ_mem->ia_slotUsed == NULL ||
+      IDAADJ_mem->ia_slotDirty == NULL || IDAADJ_mem->ia_pntSlot == NULL)
+  {
+    IDAAstorageFree(IDA_mem);
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_MEM_FAIL);
+    return (IDA_MEM_FAIL);
+  }
+
+  /* Size of a data point record; polynomial interpolation also stores the
+     order */
+  n = IDAAdataVectors(IDA_mem, dt_mem[1]->content, IDAADJ_mem->ia_storeVecs);
+  if (IDAAbufSize(n, IDAADJ_mem->ia_storeVecs, &IDAADJ_mem->ia_pntSize))
+  {
+    IDAAstorageFree(IDA_mem);
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_NO_BUFOPS);
+    return (IDA_ILL_INPUT);
+  }
+  if (IDAADJ_mem->ia_interpType == IDA_POLYNOMIAL)
+  {
+    IDAADJ_mem->ia_pntSize += sizeof(int);
+  }
+
+  IDAADJ_mem->ia_storeBufSize = IDAADJ_mem->ia_pntSize;
+  IDAADJ_mem->ia_storeBuf     = (char*)malloc(IDAADJ_mem->ia_storeBufSize);
+  if (IDAADJ_mem->ia_storeBuf == NULL)
+  {
+    IDAAstorageFree(IDA_mem);
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_MEM_FAIL);
+    return (IDA_MEM_FAIL);
+  }
+
+  /* The data points 1,...,nsteps have fixed records at the start of the
+     file, followed by the check points */
+  IDAADJ_mem->ia_pntRecord = IDAAstoreRecordSize(IDAADJ_mem->ia_pntSize);
+  if ((uint64_t)IDAADJ_mem->ia_pntRecord >
+      (uint64_t)(INT64_MAX / (IDAADJ_mem->ia_nsteps + 1)))
+  {
+    IDAAstorageFree(IDA_mem);
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_FULL);
+    return (IDA_MEM_FAIL);
+  }
+  IDAADJ_mem->ia_ckBase = (IDAAoffset)IDAADJ_mem->ia_nsteps *
+                          (IDAAoffset)IDAADJ_mem->ia_pntRecord;
+  IDAADJ_mem->ia_ckOffset = IDAADJ_mem->ia_ckBase;
+
+  IDAADJ_mem->ia_store = IDAAstoreCreate(IDAADJ_mem->ia_storeDir,
+                                         IDAADJ_mem->ia_storeCompress);
+  if (IDAADJ_mem->ia_store == NULL)
+  {
+    IDAAstorageFree(IDA_mem);
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_CREATE, IDAADJ_mem->ia_storeDir);
+    return (IDA_MEM_FAIL);
+  }
+
+  /* Turn the allocated contents into empty cache slots */
+  for (i = 0; i <= IDAADJ_mem->ia_nsteps; i++)
+  {
+    IDAADJ_mem->ia_pntSlot[i] = -1;
+  }
+
+  for (i = 0; i < ncache; i++)
+  {
+    IDAADJ_mem->ia_slotContent[i] = dt_mem[i + 1]->content;
+    IDAADJ_mem->ia_slotPnt[i]     = -1;
+    IDAADJ_mem->ia_slotUsed[i]    = 0;
+    IDAADJ_mem->ia_slotDirty[i]   = SUNFALSE;
+    dt_mem[i + 1]->content        = NULL;
+  }
+  IDAADJ_mem->ia_useCount = 0;
+
+  return (IDA_SUCCESS);
+}
+
+/*
+ * IDAAstorageFree
+ *
+ * This routine closes the storage file and gives the contents of the
+ * cache slots back to the data points 1,...,ncache so that the
+ * interpolation module can free them.
+ */
+
+static void IDAAstorageFree(IDAMem IDA_mem)
+{
+  IDAadjMem IDAADJ_mem;
+  IDAdtpntMem* dt_mem;
+  long int i;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+  dt_mem     = IDAADJ_mem->dt_mem;
+
+  if (IDAADJ_mem->ia_slotContent != NULL && IDAADJ_mem->ia_store != NULL)
+  {
+    for (i = 1; i <= IDAADJ_mem->ia_nsteps; i++) { dt_mem[i]->content = NULL; }
+    for (i = 0; i < IDAADJ_mem->ia_ncache; i++)
+    {
+      dt_mem[i + 1]->content = IDAADJ_mem->ia_slotContent[i];
+    }
+  }
+
+  IDAAstoreFree(&IDAADJ_mem->ia_store);
+
+  free(IDAADJ_mem->ia_storeBuf);
+  free(IDAADJ_mem->ia_storeVecs);
+  free(IDAADJ_mem->ia_slotContent);
+  free(IDAADJ_mem->ia_slotPnt);
+  free(IDAADJ_mem->ia_slotUsed);
+  free(IDAADJ_mem->ia_slotDirty);
+  free(IDAADJ_mem->ia_pntSlot);
+
+  IDAADJ_mem->ia_storeBuf    = NULL;
+  IDAADJ_mem->ia_storeVecs   = NULL;
+  IDAADJ_mem->ia_slotContent = NULL;
+  IDAADJ_mem->ia_slotPnt     = NULL;
+  IDAADJ_mem->ia_slotUsed    = NULL;
+  IDAADJ_mem->ia_slotDirty   = NULL;
+  IDAADJ_mem->ia_pntSlot     = NULL;
+}
+
+/*
+ * IDAAdataWrite, IDAAdataRead
+ *
+ * Write/read the data point i (in memory) to/from its record in the
+ * storage file.
+ */
+
+static int IDAAdataWrite(IDAMem IDA_mem, long int i)
+{
+  IDAadjMem IDAADJ_mem;
+  void* content;
+  int n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+  content    = IDAADJ_mem->dt_mem[i]->content;
+
+  n = IDAAdataVectors(IDA_mem, content, IDAADJ_mem->ia_storeVecs);
+  if (IDAAbufPack(n, IDAADJ_mem->ia_storeVecs, IDAADJ_mem->ia_storeBuf))
+  {
+    return (-1);
+  }
+
+  if (IDAADJ_mem->ia_interpType == IDA_POLYNOMIAL)
+  {
+    memcpy(IDAADJ_mem->ia_storeBuf + IDAADJ_mem->ia_pntSize - sizeof(int),
+           &((IDApolynomialDataMem)content)->order, sizeof(int));
+  }
+
+  return (IDAAstoreWrite(IDAADJ_mem->ia_store,
+                         (IDAAoffset)(i - 1) *
+                             (IDAAoffset)IDAADJ_mem->ia_pntRecord,
+                         IDAADJ_mem->ia_storeBuf, IDAADJ_mem->ia_pntSize));
+}
+
+static int IDAAdataRead(IDAMem IDA_mem, long int i)
+{
+  IDAadjMem IDAADJ_mem;
+  void* content;
+  int n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+  content    = IDAADJ_mem->dt_mem[i]->content;
+
+  if (IDAAstoreRead(IDAADJ_mem->ia_store,
+                    (IDAAoffset)(i - 1) *
+                        (IDAAoffset)IDAADJ_mem->ia_pntRecord,
+                    IDAADJ_mem->ia_storeBuf, IDAADJ_mem->ia_pntSize))
+  {
+    return (-1);
+  }
+
+  n = IDAAdataVectors(IDA_mem, content, IDAADJ_mem->ia_storeVecs);
+  if (IDAAbufUnpack(n, IDAADJ_mem->ia_storeVecs, IDAADJ_mem->ia_storeBuf))
+  {
+    return (-1);
+  }
+
+  if (IDAADJ_mem->ia_interpType == IDA_POLYNOMIAL)
+  {
+    memcpy(&((IDApolynomialDataMem)content)->order,
+           IDAADJ_mem->ia_storeBuf + IDAADJ_mem->ia_pntSize - sizeof(int),
+           sizeof(int));
+  }
+
+  return (0);
+}
+
+/*
+ * IDAAdataSlot
+ *
+ * Attaches a cache slot to the data point i. An empty slot is used
+ * if available, otherwise the least recently used slot not holding
+ * one of the data points lo,...,hi is written to the storage file
+ * (if needed) and reused. Returns the slot or -1 on failure.
+ */
+
+static long int IDAAdataSlot(IDAMem IDA_mem, long int i, long int lo,
+                             long int hi)
+{
+  IDAadjMem IDAADJ_mem;
+  long int s, k, p;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  s = -1;
+  for (k = 0; k < IDAADJ_mem->ia_ncache; k++)
+  {
+    p = IDAADJ_mem->ia_slotPnt[k];
+    if (p < 0)
+    {
+      s = k;
+      break;
+    }
+    if (p >= lo && p <= hi) { continue; }
+    if (s < 0 || IDAADJ_mem->ia_slotUsed[k] < IDAADJ_mem->ia_slotUsed[s])
+    {
+      s = k;
+    }
+  }
+  if (s < 0) { return (-1); }
+
+  /* Evict the data point held by the slot */
+  p = IDAADJ_mem->ia_slotPnt[s];
+  if (p >= 0)
+  {
+    if (IDAADJ_mem->ia_slotDirty[s] && IDAAdataWrite(IDA_mem, p))
+    {
+      return (-1);
+    }
+    IDAADJ_mem->dt_mem[p]->content = NULL;
+    IDAADJ_mem->ia_pntSlot[p]      = -1;
+  }
+
+  IDAADJ_mem->ia_slotPnt[s]      = i;
+  IDAADJ_mem->ia_slotDirty[s]    = SUNFALSE;
+  IDAADJ_mem->ia_pntSlot[i]      = s;
+  IDAADJ_mem->dt_mem[i]->content = IDAADJ_mem->ia_slotContent[s];
+
+  return (s);
+}
+
+/*
+ * IDAAdataLoad
+ *
+ * This routine makes sure that the data points lo,...,hi are in
+ * memory, reading them from the storage file if needed. The backward
+ * integration proceeds to lower data points, so the data points
+ * preceding lo are prefetched.
+ */
+
+int IDAAdataLoad(IDAMem IDA_mem, long int lo, long int hi)
+{
+  IDAadjMem IDAADJ_mem;
+  long int i, s;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  if (IDAADJ_mem->ia_store == NULL) { return (IDA_SUCCESS); }
+
+  /* The first data point is always in memory */
+  if (lo < 1) { lo = 1; }
+
+  for (i = lo; i <= hi; i++)
+  {
+    s = IDAADJ_mem->ia_pntSlot[i];
+    if (s < 0)
+    {
+      s = IDAAdataSlot(IDA_mem, i, lo, hi);
+      if (s >= 0 && IDAAdataRead(IDA_mem, i))
+      {
+        IDAADJ_mem->ia_slotPnt[s]      = -1;
+        IDAADJ_mem->ia_pntSlot[i]      = -1;
+        IDAADJ_mem->dt_mem[i]->content = NULL;
+        s                              = -1;
+      }
+      if (s < 0)
+      {
+        IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                        MSGAM_STORE_FAIL);
+        return (IDA_MEM_FAIL);
+      }
+    }
+    IDAADJ_mem->ia_slotUsed[s] = ++IDAADJ_mem->ia_useCount;
+  }
+
+  for (i = lo - 1; i >= 1 && i >= lo - IDAA_NPREFETCH; i--)
+  {
+    if (IDAADJ_mem->ia_pntSlot[i] < 0)
+    {
+      IDAAstorePrefetch(IDAADJ_mem->ia_store,
+                        (IDAAoffset)(i - 1) *
+                            (IDAAoffset)IDAADJ_mem->ia_pntRecord,
+                        IDAADJ_mem->ia_pntSize);
+    }
+  }
+
+  return (IDA_SUCCESS);
+}
+
+/*
+ * IDAAdataStorePnt
+ *
+ * This routine stores the current solution in the data point i using
+ * the interpolation module. With disk storage, the data point gets a
+ * cache slot first. Storing the first data point starts a new
+ * interval, so the data of the previous interval is not written to
+ * the storage file anymore.
+ */
+
+static int IDAAdataStorePnt(IDAMem IDA_mem, long int i)
+{
+  IDAadjMem IDAADJ_mem;
+  long int s;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  if (IDAADJ_mem->ia_store != NULL)
+  {
+    if (i == 0)
+    {
+      for (s = 0; s < IDAADJ_mem->ia_ncache; s++)
+      {
+        IDAADJ_mem->ia_slotDirty[s] = SUNFALSE;
+      }
+    }
+    else
+    {
+      s = IDAADJ_mem->ia_pntSlot[i];
+      if (s < 0) { s = IDAAdataSlot(IDA_mem, i, i, i); }
+      if (s < 0)
+      {
+        IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                        MSGAM_STORE_FAIL);
+        return (IDA_MEM_FAIL);
+      }
+      IDAADJ_mem->ia_slotUsed[s]  = ++IDAADJ_mem->ia_useCount;
+      IDAADJ_mem->ia_slotDirty[s] = SUNTRUE;
+    }
+  }
+
+  return (IDAADJ_mem->ia_storePnt(IDA_mem, IDAADJ_mem->dt_mem[i]));
+}
+
+/*
+ * IDAAckpntWrite, IDAAckpntRead
+ *
+ * Write the phi* vectors in IDA_mem to a new record in the storage
+ * file for the check point ck_mem, or read them back into IDA_mem.
+ */
+
+static int IDAAckpntWrite(IDAMem IDA_mem, IDAckpntMem ck_mem)
+{
+  IDAadjMem IDAADJ_mem;
+  size_t size, record;
+  char* buf;
+  int n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  n = IDAAckpntVectors(IDA_mem, ck_mem, IDAADJ_mem->ia_storeVecs);
+  if (IDAAbufSize(n, IDAADJ_mem->ia_storeVecs, &size))
+  {
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_FAIL);
+    return (IDA_MEM_FAIL);
+  }
+
+  /* The record must fit below the largest file offset */
+  record = IDAAstoreRecordSize(size);
+  if ((uint64_t)record > (uint64_t)(INT64_MAX - IDAADJ_mem->ia_ckOffset))
+  {
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_FULL);
+    return (IDA_MEM_FAIL);
+  }
+
+  if (size > IDAADJ_mem->ia_storeBufSize)
+  {
+    buf = (char*)realloc(IDAADJ_mem->ia_storeBuf, size);
+    if (buf == NULL)
+    {
+      IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSGAM_MEM_FAIL);
+      return (IDA_MEM_FAIL);
+    }
+    IDAADJ_mem->ia_storeBuf     = buf;
+    IDAADJ_mem->ia_storeBufSize = size;
+  }
+
+  if (IDAAbufPack(n, IDAADJ_mem->ia_storeVecs, IDAADJ_mem->ia_storeBuf) ||
+      IDAAstoreWrite(IDAADJ_mem->ia_store, IDAADJ_mem->ia_ckOffset,
+                     IDAADJ_mem->ia_storeBuf, size))
+  {
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_FAIL);
+    return (IDA_MEM_FAIL);
+  }
+
+  ck_mem->ck_offset = IDAADJ_mem->ia_ckOffset;
+  ck_mem->ck_size   = size;
+
+  IDAADJ_mem->ia_ckOffset += (IDAAoffset)record;
+
+  return (IDA_SUCCESS);
+}
+
+static int IDAAckpntRead(IDAMem IDA_mem, IDAckpntMem ck_mem)
+{
+  IDAadjMem IDAADJ_mem;
+  int n;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  n = IDAAckpntVectors(IDA_mem, ck_mem, IDAADJ_mem->ia_storeVecs);
+
+  if (IDAAstoreRead(IDAADJ_mem->ia_store, ck_mem->ck_offset,
+                    IDAADJ_mem->ia_storeBuf, ck_mem->ck_size) ||
+      IDAAbufUnpack(n, IDAADJ_mem->ia_storeVecs, IDAADJ_mem->ia_storeBuf))
+  {
+    IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_FAIL);
+    return (IDA_MEM_FAIL);
+  }
+
+  return (IDA_SUCCESS);
+}
+
+/*
+ * IDAAckpntPrefetch
+ *
+ * Starts reading the check point ck_mem in the background if it is
+ * in the storage file.
+ */
+
+static void IDAAckpntPrefetch(IDAMem IDA_mem, IDAckpntMem ck_mem)
+{
+  IDAadjMem IDAADJ_mem;
+
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  if (IDAADJ_mem->ia_store == NULL || ck_mem == NULL || ck_mem->ck_offset < 0)
+  {
+    return;
+  }
+
+  IDAAstorePrefetch(IDAADJ_mem->ia_store, ck_mem->ck_offset, ck_mem->ck_size);
+}
+
 /*
  * -----------------------------------------------------------------
  * Functions specific to cubic Hermite interpolation
@@ -2577,7 +3345,7 @@ static sunbooleantype IDAAhermiteMalloc(IDAMem IDA_mem)
   IDAadjMem IDAADJ_mem;
   IDAdtpntMem* dt_mem;
   IDAhermiteDataMem content;
-  long int i, ii = 0;
+  long int i, ii = 0, nalloc;
   sunbooleantype allocOK;
 
   allocOK = SUNTRUE;
@@ -2613,11 +3381,15 @@ static sunbooleantype IDAAhermiteMalloc(IDAMem IDA_mem)
     }
   }
 
-  /* Allocate space for the content field of the dt structures */
+  /* Allocate space for the content field of the dt structures. With disk
+     storage, only the first data point and the cached ones need space. */
 
   dt_mem = IDAADJ_mem->dt_mem;
 
-  for (i = 0; i <= IDAADJ_mem->ia_nsteps; i++)
+  nalloc = (IDAADJ_mem->ia_storeDir != NULL) ? IDAADJ_mem->ia_ncache
+                                             : IDAADJ_mem->ia_nsteps;
+
+  for (i = 0; i <= nalloc; i++)
   {
     content = NULL;
     content = (IDAhermiteDataMem)malloc(sizeof(struct IDAhermiteDataMemRec));
@@ -2866,6 +3638,10 @@ static int IDAAhermiteGetY(IDAMem IDA_mem, sunrealtype t, N_Vector yy,
     return (IDA_SUCCESS);
   }
 
+  /* Make sure the data points are in memory */
+  flag = IDAAdataLoad(IDA_mem, indx - 1, indx);
+  if (flag != IDA_SUCCESS) { return (flag); }
+
   /* Extract stuff from the appropriate data points */
   t0    = dt_mem[indx - 1]->t;
   t1    = dt_mem[indx]->t;
@@ -3042,7 +3818,7 @@ static sunbooleantype IDAApolynomialMalloc(IDAMem IDA_mem)
   IDAadjMem IDAADJ_mem;
   IDAdtpntMem* dt_mem;
   IDApolynomialDataMem content;
-  long int i, ii = 0;
+  long int i, ii = 0, nalloc;
   sunbooleantype allocOK;
 
   allocOK = SUNTRUE;
@@ -3077,10 +3853,14 @@ static sunbooleantype IDAApolynomialMalloc(IDAMem IDA_mem)
     }
   }
 
-  /* Allocate space for the content field of the dt structures */
+  /* Allocate space for the content field of the dt structures. With disk
+     storage, only the first data point and the cached ones need space. */
   dt_mem = IDAADJ_mem->dt_mem;
 
-  for (i = 0; i <= IDAADJ_mem->ia_nsteps; i++)
+  nalloc = (IDAADJ_mem->ia_storeDir != NULL) ? IDAADJ_mem->ia_ncache
+                                             : IDAADJ_mem->ia_nsteps;
+
+  for (i = 0; i <= nalloc; i++)
   {
     content = NULL;
     content = (IDApolynomialDataMem)malloc(sizeof(struct IDApolynomialDataMemRec));
@@ -3350,14 +4130,18 @@ static int IDAApolynomialGetY(IDAMem IDA_mem, sunrealtype t, N_Vector yy,
 
   if (dir == 1)
   {
-    base    = indx;
+    base = indx;
+    flag = IDAAdataLoad(IDA_mem, base, base);
+    if (flag != IDA_SUCCESS) { return (flag); }
     content = (IDApolynomialDataMem)(dt_mem[base]->content);
     order   = content->order;
     if (indx < order) { base += order - indx; }
   }
   else
   {
-    base    = indx - 1;
+    base = indx - 1;
+    flag = IDAAdataLoad(IDA_mem, base, base);
+    if (flag != IDA_SUCCESS) { return (flag); }
     content = (IDApolynomialDataMem)(dt_mem[base]->content);
     order   = content->order;
     if (IDAADJ_mem->ia_np - indx > order)
@@ -3370,6 +4154,11 @@ static int IDAApolynomialGetY(IDAMem IDA_mem, sunrealtype t, N_Vector yy,
 
   if (newpoint)
   {
+    /* Make sure the data points are in memory */
+    if (dir == 1) { flag = IDAAdataLoad(IDA_mem, base - order, base); }
+    else { flag = IDAAdataLoad(IDA_mem, base - 1, base - 1 + order); }
+    if (flag != IDA_SUCCESS) { return (flag); }
+
     /* Store 0-th order DD */
     if (dir == 1)
     {
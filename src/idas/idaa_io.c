@@ -28,6 +28,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sundials/sundials_types.h>
 
 #include "idas_impl.h"
@@ -82,6 +83,161 @@ int IDAAdjSetNoSensi(void* ida_mem)
   return (IDA_SUCCESS);
 }
 
+/*
+ * -----------------------------------------------------------------
+ * IDAAdjSetStorageDirectory
+ * -----------------------------------------------------------------
+ * Enables (dir != NULL) or disables (dir == NULL) disk storage of
+ * check point and interpolation data in the directory dir.
+ * -----------------------------------------------------------------
+ */
+
+int IDAAdjSetStorageDirectory(void* ida_mem, const char* dir)
+{
+  IDAMem IDA_mem;
+  IDAadjMem IDAADJ_mem;
+  char* dircopy;
+
+  /* Is ida_mem valid? */
+  if (ida_mem == NULL)
+  {
+    IDAProcessError(NULL, IDA_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSGAM_NULL_IDAMEM);
+    return IDA_MEM_NULL;
+  }
+  IDA_mem = (IDAMem)ida_mem;
+
+  /* Is ASA initialized? */
+  if (IDA_mem->ida_adjMallocDone == SUNFALSE)
+  {
+    IDAProcessError(IDA_mem, IDA_NO_ADJ, __LINE__, __func__, __FILE__,
+                    MSGAM_NO_ADJ);
+    return (IDA_NO_ADJ);
+  }
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  /* The data structures are set up in the first call to IDASolveF */
+  if (IDAADJ_mem->ia_mallocDone)
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_LATE);
+    return (IDA_ILL_INPUT);
+  }
+
+  dircopy = NULL;
+  if (dir != NULL)
+  {
+    dircopy = (char*)malloc(strlen(dir) + 1);
+    if (dircopy == NULL)
+    {
+      IDAProcessError(IDA_mem, IDA_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSGAM_MEM_FAIL);
+      return (IDA_MEM_FAIL);
+    }
+    strcpy(dircopy, dir);
+  }
+
+  free(IDAADJ_mem->ia_storeDir);
+  IDAADJ_mem->ia_storeDir = dircopy;
+
+  return (IDA_SUCCESS);
+}
+
+/*
+ * -----------------------------------------------------------------
+ * IDAAdjSetStorageCompression
+ * -----------------------------------------------------------------
+ * Enables or disables lossless compression of the data written to
+ * the storage file.
+ * -----------------------------------------------------------------
+ */
+
+int IDAAdjSetStorageCompression(void* ida_mem, sunbooleantype compress)
+{
+  IDAMem IDA_mem;
+  IDAadjMem IDAADJ_mem;
+
+  /* Is ida_mem valid? */
+  if (ida_mem == NULL)
+  {
+    IDAProcessError(NULL, IDA_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSGAM_NULL_IDAMEM);
+    return IDA_MEM_NULL;
+  }
+  IDA_mem = (IDAMem)ida_mem;
+
+  /* Is ASA initialized? */
+  if (IDA_mem->ida_adjMallocDone == SUNFALSE)
+  {
+    IDAProcessError(IDA_mem, IDA_NO_ADJ, __LINE__, __func__, __FILE__,
+                    MSGAM_NO_ADJ);
+    return (IDA_NO_ADJ);
+  }
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  if (IDAADJ_mem->ia_mallocDone)
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_LATE);
+    return (IDA_ILL_INPUT);
+  }
+
+  IDAADJ_mem->ia_storeCompress = compress;
+
+  return (IDA_SUCCESS);
+}
+
+/*
+ * -----------------------------------------------------------------
+ * IDAAdjSetStorageCacheSize
+ * -----------------------------------------------------------------
+ * Sets the number of data points kept in memory with disk storage.
+ * -----------------------------------------------------------------
+ */
+
+int IDAAdjSetStorageCacheSize(void* ida_mem, long int ncache)
+{
+  IDAMem IDA_mem;
+  IDAadjMem IDAADJ_mem;
+
+  /* Is ida_mem valid? */
+  if (ida_mem == NULL)
+  {
+    IDAProcessError(NULL, IDA_MEM_NULL, __LINE__, __func__, __FILE__,
+                    MSGAM_NULL_IDAMEM);
+    return IDA_MEM_NULL;
+  }
+  IDA_mem = (IDAMem)ida_mem;
+
+  /* Is ASA initialized? */
+  if (IDA_mem->ida_adjMallocDone == SUNFALSE)
+  {
+    IDAProcessError(IDA_mem, IDA_NO_ADJ, __LINE__, __func__, __FILE__,
+                    MSGAM_NO_ADJ);
+    return (IDA_NO_ADJ);
+  }
+  IDAADJ_mem = IDA_mem->ida_adj_mem;
+
+  if (IDAADJ_mem->ia_mallocDone)
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_STORE_LATE);
+    return (IDA_ILL_INPUT);
+  }
+
+  /* The polynomial interpolation needs up to MXORDP1 data points at once */
+  if (ncache < 0 || (ncache > 0 && ncache < MXORDP1))
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSGAM_BAD_NCACHE);
+    return (IDA_ILL_INPUT);
+  }
+
+  IDAADJ_mem->ia_ncache = ncache;
+
+  return (IDA_SUCCESS);
+}
+
 /*
  * -----------------------------------------------------------------
  * Optional input functions for backward integration
@@ -753,6 +909,7 @@ int IDAGetAdjDataPointHermite(void* ida_mem, int which, sunrealtype* t,
   IDAadjMem IDAADJ_mem;
   IDAdtpntMem* dt_mem;
   IDAhermiteDataMem content;
+  int flag;
 
   /* Is ida_mem valid? */
   if (ida_mem == NULL)
@@ -781,6 +938,10 @@ int IDAGetAdjDataPointHermite(void* ida_mem, int which, sunrealtype* t,
     return (IDA_ILL_INPUT);
   }
 
+  /* Make sure the data point is in memory */
+  flag = IDAAdataLoad(IDA_mem, which, which);
+  if (flag != IDA_SUCCESS) { return (flag); }
+
   *t      = dt_mem[which]->t;
   content = (IDAhermiteDataMem)dt_mem[which]->content;
 
@@ -808,6 +969,7 @@ int IDAGetAdjDataPointPolynomial(void* ida_mem, int which, sunrealtype* t,
   IDAadjMem IDAADJ_mem;
   IDAdtpntMem* dt_mem;
   IDApolynomialDataMem content;
+  int flag;
   /* Is ida_mem valid? */
   if (ida_mem == NULL)
   {
@@ -835,6 +997,10 @@ int IDAGetAdjDataPointPolynomial(void* ida_mem, int which, sunrealtype* t,
     return (IDA_ILL_INPUT);
   }
 
+  /* Make sure the data point is in memory */
+  flag = IDAAdataLoad(IDA_mem, which, which);
+  if (flag != IDA_SUCCESS) { return (flag); }
+
   *t      = dt_mem[which]->t;
   content = (IDApolynomialDataMem)dt_mem[which]->content;
 
@@ -0,0 +1,752 @@
+/*
+ * -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * This is the implementation file for the file storage used by the
+ * IDAA adjoint integrator to keep check point and interpolation
+ * data out of memory.
+ *
+ * Records are written at offsets chosen by the caller. Each record
+ * starts with a header holding the number of stored bytes and a
+ * flag marking compressed records. The lossless compression XORs
+ * each word of the buffer with the previous word, groups the bytes
+ * of equal significance, and run-length encodes zero bytes. For
+ * smooth data the leading bytes of the differences are mostly zero.
+ * A record is stored uncompressed if compression does not shrink it.
+ *
+ * If SUNDIALS was built with pthreads, records can be prefetched:
+ * a background thread reads and decompresses them into a small set
+ * of buffers, from which later reads are served.
+ * -----------------------------------------------------------------
+ */
+
+/* Use 64-bit file offsets with fseeko on 32-bit POSIX systems */
+#if !defined(_WIN32)
+#if !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#endif
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "idas_impl.h"
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+#include <pthread.h>
+#endif
+
+/* Shortest run of zero bytes encoded as a run */
+#define IDAA_MINRUN 3
+
+/* Record header: stored bytes and compression flag */
+#define IDAA_HEADER (2 * sizeof(size_t))
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+
+/* States of a prefetch buffer */
+#define PF_EMPTY  0
+#define PF_QUEUED 1
+#define PF_BUSY   2
+#define PF_READY  3
+#define PF_FAILED 4
+
+typedef struct
+{
+  int state;         /* one of the PF_* states              */
+  IDAAoffset offset; /* offset of the record                */
+  size_t size;       /* uncompressed size of the record     */
+  long int seq;      /* request number, for FIFO processing */
+  char* buf;         /* uncompressed record                 */
+  size_t bufsize;    /* allocated size of buf               */
+}* IDAAprefetch;
+
+#endif
+
+struct IDAAstoreMemRec
+{
+  FILE* fp;                /* storage file                      */
+  char* fname;             /* name of the file, removed on free */
+  sunbooleantype compress; /* compress records?                 */
+
+  /* Scratch buffers for the calling thread */
+  char* cbuf; /* compressed record */
+  char* tbuf; /* shuffled record   */
+  size_t scratch_size;
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_t thread;       /* prefetch thread                  */
+  pthread_mutex_t lock;   /* protects the prefetch buffers    */
+  pthread_mutex_t iolock; /* protects the file position       */
+  pthread_cond_t cond;    /* signals requests and completions */
+  sunbooleantype quit;    /* tells the thread to return       */
+  long int seq;           /* number of prefetch requests      */
+
+  IDAAprefetch pf[IDAA_NPREFETCH];
+
+  /* Scratch buffers for the prefetch thread */
+  char* pf_cbuf;
+  char* pf_tbuf;
+  size_t pf_scratch_size;
+#endif
+};
+
+/*=================================================================*/
+/*                      Compression                                */
+/*=================================================================*/
+
+/*
+ * IDAAstoreEncode
+ *
+ * Compresses the n bytes in raw into out using tmp as workspace.
+ * Returns the compressed size or 0 if the result would not be
+ * smaller than n.
+ */
+
+static size_t IDAAstoreEncode(const char* raw, size_t n, char* tmp, char* out)
+{
+  const unsigned char* r = (const unsigned char*)raw;
+  unsigned char* t       = (unsigned char*)tmp;
+  unsigned char* o       = (unsigned char*)out;
+  size_t w               = sizeof(sunrealtype);
+  size_t nw              = n / w;
+  size_t i, j, k, b, run, lit, m;
+
+  /* XOR with the previous word and group bytes of equal significance */
+  for (b = 0; b < w; b++)
+  {
+    t[b * nw] = r[b];
+    for (k = 1; k < nw; k++)
+    {
+      t[b * nw + k] = r[k * w + b] ^ r[(k - 1) * w + b];
+    }
+  }
+  for (i = nw * w; i < n; i++) { t[i] = r[i]; }
+
+  /* Run-length encode zero bytes */
+  m = 0;
+  i = 0;
+  while (i < n)
+  {
+    /* zero run starting at i */
+    run = 0;
+    while (i + run < n && t[i + run] == 0 && run < 127 + IDAA_MINRUN)
+    {
+      run++;
+    }
+
+    if (run >= IDAA_MINRUN)
+    {
+      if (m + 1 >= n) { return 0; }
+      o[m++] = (unsigned char)(128 + run - IDAA_MINRUN);
+      i += run;
+      continue;
+    }
+
+    /* literal run up to the next zero run */
+    lit = 0;
+    for (j = i; j < n && lit < 128; j++, lit++)
+    {
+      if (j + IDAA_MINRUN <= n && t[j] == 0 && t[j + 1] == 0 && t[j + 2] == 0)
+      {
+        break;
+      }
+    }
+
+    if (m + 1 + lit >= n) { return 0; }
+    o[m++] = (unsigned char)(lit - 1);
+    memcpy(o + m, t + i, lit);
+    m += lit;
+    i += lit;
+  }
+
+  return m;
+}
+
+/*
+ * IDAAstoreDecode
+ *
+ * Decompresses the m bytes in in into the n bytes of raw using tmp
+ * as workspace. Returns 0 on success and -1 if the data is corrupt.
+ */
+
+static int IDAAstoreDecode(const char* in, size_t m, char* tmp, char* raw,
+                           size_t n)
+{
+  const unsigned char* c = (const unsigned char*)in;
+  unsigned char* t       = (unsigned char*)tmp;
+  unsigned char* r       = (unsigned char*)raw;
+  size_t w               = sizeof(sunrealtype);
+  size_t nw              = n / w;
+  size_t i, j, k, b, len;
+
+  /* Undo the run-length encoding */
+  i = 0;
+  j = 0;
+  while (i < m)
+  {
+    if (c[i] >= 128)
+    {
+      len = (size_t)c[i] - 128 + IDAA_MINRUN;
+      if (j + len > n) { return -1; }
+      memset(t + j, 0, len);
+      i++;
+    }
+    else
+    {
+      len = (size_t)c[i] + 1;
+      if (j + len > n || i + 1 + len > m) { return -1; }
+      memcpy(t + j, c + i + 1, len);
+      i += 1 + len;
+    }
+    j += len;
+  }
+  if (j != n) { return -1; }
+
+  /* Undo the byte grouping and the XOR with the previous word */
+  for (b = 0; b < w && nw > 0; b++)
+  {
+    r[b] = t[b * nw];
+    for (k = 1; k < nw; k++)
+    {
+      r[k * w + b] = t[b * nw + k] ^ r[(k - 1) * w + b];
+    }
+  }
+  for (i = nw * w; i < n; i++) { r[i] = t[i]; }
+
+  return 0;
+}
+
+/*
+ * IDAAstoreScratch
+ *
+ * Makes sure the scratch buffers hold at least n bytes.
+ */
+
+static int IDAAstoreScratch(char** cbuf, char** tbuf, size_t* size, size_t n)
+{
+  char* tmp;
+
+  if (*size >= n) { return 0; }
+
+  tmp = (char*)realloc(*cbuf, n);
+  if (tmp == NULL) { return -1; }
+  *cbuf = tmp;
+
+  tmp = (char*)realloc(*tbuf, n);
+  if (tmp == NULL) { return -1; }
+  *tbuf = tmp;
+
+  *size = n;
+  return 0;
+}
+
+/*
+ * IDAAstoreSeek
+ *
+ * Moves the file position to offset. Plain fseek takes a long int,
+ * which is 32 bits on Windows, so the 64-bit variants are used.
+ * Returns 0 on success and -1 on failure.
+ */
+
+static int IDAAstoreSeek(FILE* fp, IDAAoffset offset)
+{
+#if defined(_WIN32)
+  return _fseeki64(fp, (__int64)offset, SEEK_SET) ? -1 : 0;
+#else
+  if ((IDAAoffset)(off_t)offset != offset) { return -1; }
+  return fseeko(fp, (off_t)offset, SEEK_SET) ? -1 : 0;
+#endif
+}
+
+/*
+ * IDAAstoreOpen
+ *
+ * Creates the file fname for reading and writing. The "x" mode of
+ * fopen is C11 only, so the file is created with open and O_EXCL,
+ * which fails if the file already exists. Returns NULL on failure.
+ */
+
+static FILE* IDAAstoreOpen(const char* fname)
+{
+  FILE* fp;
+  int fd;
+
+#if defined(_WIN32)
+  fd = _open(fname, _O_CREAT | _O_EXCL | _O_RDWR | _O_BINARY,
+             _S_IREAD | _S_IWRITE);
+  if (fd < 0) { return NULL; }
+  fp = _fdopen(fd, "w+b");
+  if (fp == NULL) { _close(fd); }
+#else
+  fd = open(fname, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) { return NULL; }
+  fp = fdopen(fd, "w+b");
+  if (fp == NULL) { close(fd); }
+#endif
+
+  if (fp == NULL) { remove(fname); }
+  return fp;
+}
+
+/*
+ * IDAAstoreReadRecord
+ *
+ * Reads the record at offset into data (size bytes) using the given
+ * scratch buffers. The file position is protected by iolock when
+ * prefetching is enabled.
+ */
+
+static int IDAAstoreReadRecord(IDAAstoreMem store, IDAAoffset offset,
+                               char* data, size_t size, char** cbuf,
+                               char** tbuf, size_t* scratch_size)
+{
+  size_t hdr[2];
+  size_t nread;
+
+  if (IDAAstoreScratch(cbuf, tbuf, scratch_size, size)) { return -1; }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_mutex_lock(&store->iolock);
+#endif
+
+  nread = 0;
+  if (IDAAstoreSeek(store->fp, offset) == 0 &&
+      fread(hdr, sizeof(size_t), 2, store->fp) == 2 && hdr[0] <= size)
+  {
+    nread = fread(hdr[1] ? *cbuf : data, 1, hdr[0], store->fp);
+  }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_mutex_unlock(&store->iolock);
+#endif
+
+  if (nread == 0 || nread != hdr[0]) { return -1; }
+
+  if (hdr[1])
+  {
+    return IDAAstoreDecode(*cbuf, hdr[0], *tbuf, data, size);
+  }
+
+  return (hdr[0] == size) ? 0 : -1;
+}
+
+/*=================================================================*/
+/*                      Prefetch thread                            */
+/*=================================================================*/
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+
+static void* IDAAstoreThread(void* arg)
+{
+  IDAAstoreMem store = (IDAAstoreMem)arg;
+  IDAAprefetch pf;
+  int i, retval;
+
+  pthread_mutex_lock(&store->lock);
+
+  for (;;)
+  {
+    /* Oldest queued request */
+    pf = NULL;
+    for (i = 0; i < IDAA_NPREFETCH; i++)
+    {
+      if (store->pf[i]->state == PF_QUEUED &&
+          (pf == NULL || store->pf[i]->seq < pf->seq))
+      {
+        pf = store->pf[i];
+      }
+    }
+
+    if (pf == NULL)
+    {
+      if (store->quit) { break; }
+      pthread_cond_wait(&store->cond, &store->lock);
+      continue;
+    }
+
+    pf->state = PF_BUSY;
+    pthread_mutex_unlock(&store->lock);
+
+    retval = IDAAstoreReadRecord(store, pf->offset, pf->buf, pf->size,
+                                 &store->pf_cbuf, &store->pf_tbuf,
+                                 &store->pf_scratch_size);
+
+    pthread_mutex_lock(&store->lock);
+    pf->state = (retval == 0) ? PF_READY : PF_FAILED;
+    pthread_cond_broadcast(&store->cond);
+  }
+
+  pthread_mutex_unlock(&store->lock);
+
+  return NULL;
+}
+
+/*
+ * IDAAstoreFind
+ *
+ * Returns the prefetch buffer for the record at offset, waiting
+ * until it is no longer queued or busy, or NULL if the record was
+ * not prefetched. Must be called with the lock held.
+ */
+
+static IDAAprefetch IDAAstoreFind(IDAAstoreMem store, IDAAoffset offset)
+{
+  int i;
+
+  for (i = 0; i < IDAA_NPREFETCH; i++)
+  {
+    if (store->pf[i]->state != PF_EMPTY && store->pf[i]->offset == offset)
+    {
+      while (store->pf[i]->state == PF_QUEUED || store->pf[i]->state == PF_BUSY)
+      {
+        pthread_cond_wait(&store->cond, &store->lock);
+      }
+      return store->pf[i];
+    }
+  }
+
+  return NULL;
+}
+
+#endif
+
+/*=================================================================*/
+/*                      Exported (private) functions               */
+/*=================================================================*/
+
+/*
+ * IDAAstoreCreate
+ *
+ * Creates a new storage file in the directory dir. Returns NULL if
+ * the file cannot be created.
+ */
+
+IDAAstoreMem IDAAstoreCreate(const char* dir, sunbooleantype compress)
+{
+  IDAAstoreMem store;
+  size_t len;
+  int k;
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  int i;
+#endif
+
+  store = (IDAAstoreMem)calloc(1, sizeof(struct IDAAstoreMemRec));
+  if (store == NULL) { return NULL; }
+
+  store->compress = compress;
+
+  /* Pick a file name that is not in use yet */
+  len          = strlen(dir) + 64;
+  store->fname = (char*)malloc(len);
+  if (store->fname == NULL)
+  {
+    free(store);
+    return NULL;
+  }
+
+  for (k = 0; k < 1000 && store->fp == NULL; k++)
+  {
+    snprintf(store->fname, len, "%s/idas_adjoint_%lx_%d.bin",
+             dir, (unsigned long)(size_t)store, k);
+    store->fp = IDAAstoreOpen(store->fname);
+  }
+
+  if (store->fp == NULL)
+  {
+    free(store->fname);
+    free(store);
+    return NULL;
+  }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  for (i = 0; i < IDAA_NPREFETCH; i++)
+  {
+    store->pf[i] = (IDAAprefetch)calloc(1, sizeof(*store->pf[i]));
+    if (store->pf[i] == NULL)
+    {
+      while (i > 0) { free(store->pf[--i]); }
+      fclose(store->fp);
+      remove(store->fname);
+      free(store->fname);
+      free(store);
+      return NULL;
+    }
+  }
+
+  pthread_mutex_init(&store->lock, NULL);
+  pthread_mutex_init(&store->iolock, NULL);
+  pthread_cond_init(&store->cond, NULL);
+
+  if (pthread_create(&store->thread, NULL, IDAAstoreThread, store))
+  {
+    pthread_mutex_destroy(&store->lock);
+    pthread_mutex_destroy(&store->iolock);
+    pthread_cond_destroy(&store->cond);
+    for (i = 0; i < IDAA_NPREFETCH; i++) { free(store->pf[i]); }
+    fclose(store->fp);
+    remove(store->fname);
+    free(store->fname);
+    free(store);
+    return NULL;
+  }
+#endif
+
+  return store;
+}
+
+/*
+ * IDAAstoreFree
+ *
+ * Stops the prefetch thread, removes the storage file, and frees
+ * the storage structure.
+ */
+
+void IDAAstoreFree(IDAAstoreMem* store)
+{
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  int i;
+#endif
+
+  if (*store == NULL) { return; }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_mutex_lock(&(*store)->lock);
+  (*store)->quit = SUNTRUE;
+  for (i = 0; i < IDAA_NPREFETCH; i++)
+  {
+    if ((*store)->pf[i]->state == PF_QUEUED)
+    {
+      (*store)->pf[i]->state = PF_EMPTY;
+    }
+  }
+  pthread_cond_broadcast(&(*store)->cond);
+  pthread_mutex_unlock(&(*store)->lock);
+
+  pthread_join((*store)->thread, NULL);
+
+  pthread_mutex_destroy(&(*store)->lock);
+  pthread_mutex_destroy(&(*store)->iolock);
+  pthread_cond_destroy(&(*store)->cond);
+
+  for (i = 0; i < IDAA_NPREFETCH; i++)
+  {
+    free((*store)->pf[i]->buf);
+    free((*store)->pf[i]);
+  }
+  free((*store)->pf_cbuf);
+  free((*store)->pf_tbuf);
+#endif
+
+  fclose((*store)->fp);
+  remove((*store)->fname);
+
+  free((*store)->fname);
+  free((*store)->cbuf);
+  free((*store)->tbuf);
+  free(*store);
+  *store = NULL;
+}
+
+/*
+ * IDAAstoreWrite
+ *
+ * Writes size bytes from data as a record at offset. The record
+ * occupies at most IDAAstoreRecordSize(size) bytes. Returns 0 on
+ * success and -1 on failure.
+ */
+
+int IDAAstoreWrite(IDAAstoreMem store, IDAAoffset offset, const char* data,
+                   size_t size)
+{
+  size_t hdr[2];
+  const char* out;
+  int retval;
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  IDAAprefetch pf;
+#endif
+
+  if (IDAAstoreScratch(&store->cbuf, &store->tbuf, &store->scratch_size, size))
+  {
+    return -1;
+  }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  /* Drop a prefetched copy of the old record */
+  pthread_mutex_lock(&store->lock);
+  pf = IDAAstoreFind(store, offset);
+  if (pf != NULL) { pf->state = PF_EMPTY; }
+  pthread_mutex_unlock(&store->lock);
+#endif
+
+  hdr[0] = 0;
+  if (store->compress)
+  {
+    hdr[0] = IDAAstoreEncode(data, size, store->tbuf, store->cbuf);
+  }
+
+  if (hdr[0] > 0)
+  {
+    hdr[1] = 1;
+    out    = store->cbuf;
+  }
+  else
+  {
+    hdr[0] = size;
+    hdr[1] = 0;
+    out    = data;
+  }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_mutex_lock(&store->iolock);
+#endif
+
+  retval = 0;
+  if (IDAAstoreSeek(store->fp, offset) != 0 ||
+      fwrite(hdr, sizeof(size_t), 2, store->fp) != 2 ||
+      fwrite(out, 1, hdr[0], store->fp) != hdr[0] || fflush(store->fp) != 0)
+  {
+    retval = -1;
+  }
+
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  pthread_mutex_unlock(&store->iolock);
+#endif
+
+  return retval;
+}
+
+/*
+ * IDAAstoreRead
+ *
+ * Reads the record at offset into data (size bytes), from a prefetch
+ * buffer if available. Returns 0 on success and -1 on failure.
+ */
+
+int IDAAstoreRead(IDAAstoreMem store, IDAAoffset offset, char* data,
+                  size_t size)
+{
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  IDAAprefetch pf;
+
+  pthread_mutex_lock(&store->lock);
+  pf = IDAAstoreFind(store, offset);
+  if (pf != NULL)
+  {
+    if (pf->state == PF_READY && pf->size == size)
+    {
+      memcpy(data, pf->buf, size);
+      pf->state = PF_EMPTY;
+      pthread_mutex_unlock(&store->lock);
+      return 0;
+    }
+    pf->state = PF_EMPTY;
+  }
+  pthread_mutex_unlock(&store->lock);
+#endif
+
+  return IDAAstoreReadRecord(store, offset, data, size, &store->cbuf,
+                             &store->tbuf, &store->scratch_size);
+}
+
+/*
+ * IDAAstorePrefetch
+ *
+ * Requests the record at offset (size bytes) to be read in the
+ * background. Does nothing without pthreads, if the record is already
+ * requested, or if all prefetch buffers are in use.
+ */
+
+void IDAAstorePrefetch(IDAAstoreMem store, IDAAoffset offset, size_t size)
+{
+#if defined(SUNDIALS_PTHREADS_ENABLED)
+  IDAAprefetch pf;
+  char* tmp;
+  int i;
+
+  pthread_mutex_lock(&store->lock);
+
+  /* Already requested? Otherwise take an empty buffer or replace the
+     oldest unused prefetched record. */
+  pf = NULL;
+  for (i = 0; i < IDAA_NPREFETCH; i++)
+  {
+    if (store->pf[i]->state != PF_EMPTY && store->pf[i]->offset == offset)
+    {
+      pthread_mutex_unlock(&store->lock);
+      return;
+    }
+  }
+  for (i = 0; i < IDAA_NPREFETCH && pf == NULL; i++)
+  {
+    if (store->pf[i]->state == PF_EMPTY) { pf = store->pf[i]; }
+  }
+  if (pf == NULL)
+  {
+    for (i = 0; i < IDAA_NPREFETCH; i++)
+    {
+      if ((store->pf[i]->state == PF_READY ||
+           store->pf[i]->state == PF_FAILED) &&
+          (pf == NULL || store->pf[i]->seq < pf->seq))
+      {
+        pf = store->pf[i];
+      }
+    }
+  }
+
+  if (pf != NULL && pf->bufsize < size)
+  {
+    tmp = (char*)realloc(pf->buf, size);
+    if (tmp == NULL) { pf = NULL; }
+    else
+    {
+      pf->buf     = tmp;
+      pf->bufsize = size;
+    }
+  }
+
+  if (pf != NULL)
+  {
+    pf->offset = offset;
+    pf->size   = size;
+    pf->seq    = store->seq++;
+    pf->state  = PF_QUEUED;
+    pthread_cond_broadcast(&store->cond);
+  }
+
+  pthread_mutex_unlock(&store->lock);
+#else
+  (void)store;
+  (void)offset;
+  (void)size;
+#endif
+}
+
+/*
+ * IDAAstoreRecordSize
+ *
+ * Returns the largest number of bytes a record of size bytes may
+ * occupy in the file.
+ */
+
+size_t IDAAstoreRecordSize(size_t size) { return IDAA_HEADER + size; }
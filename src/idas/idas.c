@@ -147,6 +147,7 @@
 #include <sunnonlinsol/sunnonlinsol_newton.h>
 
 #include "idas_impl.h"
+#include "idas_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
 
 /*
@@ -256,6 +257,9 @@ static void IDAQuadFreeVectors(IDAMem IDA_mem);
 
 static sunbooleantype IDASensAllocVectors(IDAMem IDA_mem, N_Vector tmpl);
 static void IDASensFreeVectors(IDAMem IDA_mem);
+static sunbooleantype IDASensContiguous(IDAMem IDA_mem, N_Vector tmpl);
+static N_Vector* IDASensCloneVectorArray(IDAMem IDA_mem, N_Vector tmpl);
+static void IDASensDestroyVectorArray(IDAMem IDA_mem, N_Vector* vs);
 
 static sunbooleantype IDAQuadSensAllocVectors(IDAMem ida_mem, N_Vector tmpl);
 static void IDAQuadSensFreeVectors(IDAMem ida_mem);
@@ -360,6 +364,12 @@ static int IDARcheck2(IDAMem IDA_mem);
 static int IDARcheck3(IDAMem IDA_mem);
 static int IDARootfind(IDAMem IDA_mem);
 
+/* Step trace functions */
+
+static void IDAStepTraceCounters(IDAMem IDA_mem, long int counters[]);
+static void IDAStepTraceRecord(IDAMem IDA_mem, SUNStepTrace trace,
+                               int sflag, const long int start[]);
+
 /* Sensitivity residual DQ function */
 
 static int IDASensRes1DQ(int Ns, sunrealtype t, N_Vector yy, N_Vector yp,
@@ -425,6 +435,8 @@ void* IDACreate(SUNContext sunctx)
   memset(IDA_mem, 0, sizeof(struct IDAMemRec));
 
   IDA_mem->ida_sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct IDAMemRec));
 
   /* Set unit roundoff in IDA_mem */
   IDA_mem->ida_uround = SUN_UNIT_ROUNDOFF;
@@ -492,6 +504,7 @@ void* IDACreate(SUNContext sunctx)
   IDA_mem->ida_itolS      = IDA_EE;
   IDA_mem->ida_atolSmin0  = NULL;
   IDA_mem->ida_ism        = -1; /* initialize to invalid option */
+  IDA_mem->ida_contigS    = SUNFALSE;
 
   /* Defaults for sensi. quadr. optional inputs. */
   IDA_mem->ida_quadr_sensi = SUNFALSE;
@@ -712,6 +725,8 @@ int IDAInit(void* ida_mem, IDAResFn res, sunrealtype t0, N_Vector yy0,
   IDA_mem->ida_lfree  = NULL;
   IDA_mem->ida_lmem   = NULL;
 
+  IDA_mem->ida_lsolvemulti = NULL;
+
   /* Set forceSetup to SUNFALSE */
 
   IDA_mem->ida_forceSetup = SUNFALSE;
@@ -2511,6 +2526,8 @@ int IDASolve(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
   sunrealtype tdist, troundoff, ypnorm, rh, nrm;
   IDAMem IDA_mem;
   sunbooleantype inactive_roots;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   /* Check for legal inputs in all cases. */
 
@@ -2980,8 +2997,13 @@ int IDASolve(void* ida_mem, sunrealtype tout, sunrealtype* tret, N_Vector yret,
 
     /* Call IDAStep to take a step. */
 
+    trace = IDA_STEPTRACE;
+    if (trace) { IDAStepTraceCounters(IDA_mem, trace_start); }
+
     sflag = IDAStep(IDA_mem);
 
+    if (trace) { IDAStepTraceRecord(IDA_mem, trace, sflag, trace_start); }
+
     /* Process all failed-step cases, and exit loop. */
 
     if (sflag != IDA_SUCCESS)
@@ -4096,6 +4118,8 @@ void IDAFree(void** ida_mem)
   free(IDA_mem->ida_Zvecs);
   IDA_mem->ida_Zvecs = NULL;
 
+  sunMemAccountFree(IDA_mem->ida_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct IDAMemRec));
   free(*ida_mem);
   *ida_mem = NULL;
 }
@@ -4558,6 +4582,80 @@ static void IDAQuadFreeVectors(IDAMem IDA_mem)
   IDA_mem->ida_VatolQMallocDone = SUNFALSE;
 }
 
+/*
+ * IDASensContiguous
+ *
+ * Returns SUNTRUE if the sensitivity vector arrays are stored in one
+ * contiguous block each. This requires the user option and a vector
+ * that provides access to its local data array.
+ */
+
+static sunbooleantype IDASensContiguous(IDAMem IDA_mem, N_Vector tmpl)
+{
+  return (IDA_mem->ida_contigS && tmpl->ops->nvcloneempty &&
+          tmpl->ops->nvgetarraypointer && tmpl->ops->nvsetarraypointer &&
+          tmpl->ops->nvgetlocallength);
+}
+
+/*
+ * IDASensCloneVectorArray
+ *
+ * Creates an array of Ns vectors like tmpl. With contiguous storage the
+ * vectors are empty clones attached to consecutive length N pieces of a
+ * single N x Ns block, i.e., vector is starts at entry is*N of the block.
+ */
+
+static N_Vector* IDASensCloneVectorArray(IDAMem IDA_mem, N_Vector tmpl)
+{
+  N_Vector* vs;
+  sunrealtype* data;
+  sunindextype n;
+  int is;
+
+  if (!IDASensContiguous(IDA_mem, tmpl))
+  {
+    return (N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl));
+  }
+
+  n    = N_VGetLocalLength(tmpl);
+  data = (sunrealtype*)malloc(SUNMAX(1, n * IDA_mem->ida_Ns) *
+                              sizeof(sunrealtype));
+  if (data == NULL) { return (NULL); }
+
+  vs = N_VCloneEmptyVectorArray(IDA_mem->ida_Ns, tmpl);
+  if (vs == NULL)
+  {
+    free(data);
+    return (NULL);
+  }
+
+  for (is = 0; is < IDA_mem->ida_Ns; is++)
+  {
+    N_VSetArrayPointer(data + is * n, vs[is]);
+  }
+
+  return (vs);
+}
+
+/*
+ * IDASensDestroyVectorArray
+ *
+ * Frees an array created by IDASensCloneVectorArray.
+ */
+
+static void IDASensDestroyVectorArray(IDAMem IDA_mem, N_Vector* vs)
+{
+  sunrealtype* data = NULL;
+
+  if (vs == NULL) { return; }
+
+  /* the block starts at the data of the first vector */
+  if (IDASensContiguous(IDA_mem, vs[0])) { data = N_VGetArrayPointer(vs[0]); }
+
+  N_VDestroyVectorArray(vs, IDA_mem->ida_Ns);
+  free(data);
+}
+
 /*
  * IDASensAllocVectors
  *
@@ -4576,72 +4674,72 @@ static sunbooleantype IDASensAllocVectors(IDAMem IDA_mem, N_Vector tmpl)
   IDA_mem->ida_tmpS3 = N_VClone(tmpl);
   if (IDA_mem->ida_tmpS3 == NULL) { return (SUNFALSE); }
 
-  IDA_mem->ida_ewtS = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_ewtS = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_ewtS == NULL)
   {
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_eeS = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_eeS = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_eeS == NULL)
   {
     N_VDestroy(IDA_mem->ida_tmpS3);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_yyS = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_yyS = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_yyS == NULL)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_ypS = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_ypS = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_ypS == NULL)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_yySpredict = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_yySpredict = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_yySpredict == NULL)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_ypSpredict = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_ypSpredict = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_ypSpredict == NULL)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
 
-  IDA_mem->ida_deltaS = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+  IDA_mem->ida_deltaS = IDASensCloneVectorArray(IDA_mem, tmpl);
   if (IDA_mem->ida_deltaS == NULL)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_ypSpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypSpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
     N_VDestroy(IDA_mem->ida_tmpS3);
     return (SUNFALSE);
   }
@@ -4657,17 +4755,17 @@ static sunbooleantype IDASensAllocVectors(IDAMem IDA_mem, N_Vector tmpl)
   maxcol = SUNMAX(IDA_mem->ida_maxord, 4);
   for (j = 0; j <= maxcol; j++)
   {
-    IDA_mem->ida_phiS[j] = N_VCloneVectorArray(IDA_mem->ida_Ns, tmpl);
+    IDA_mem->ida_phiS[j] = IDASensCloneVectorArray(IDA_mem, tmpl);
     if (IDA_mem->ida_phiS[j] == NULL)
     {
       N_VDestroy(IDA_mem->ida_tmpS3);
-      N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_ypSpredict, IDA_mem->ida_Ns);
-      N_VDestroyVectorArray(IDA_mem->ida_deltaS, IDA_mem->ida_Ns);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypSpredict);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_deltaS);
       return (SUNFALSE);
     }
   }
@@ -4683,16 +4781,16 @@ static sunbooleantype IDASensAllocVectors(IDAMem IDA_mem, N_Vector tmpl)
   if (IDA_mem->ida_pbar == NULL)
   {
     N_VDestroy(IDA_mem->ida_tmpS3);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypSpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_deltaS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypSpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_deltaS);
     for (j = 0; j <= maxcol; j++)
     {
-      N_VDestroyVectorArray(IDA_mem->ida_phiS[j], IDA_mem->ida_Ns);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_phiS[j]);
     }
     return (SUNFALSE);
   }
@@ -4702,16 +4800,16 @@ static sunbooleantype IDASensAllocVectors(IDAMem IDA_mem, N_Vector tmpl)
   if (IDA_mem->ida_plist == NULL)
   {
     N_VDestroy(IDA_mem->ida_tmpS3);
-    N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_ypSpredict, IDA_mem->ida_Ns);
-    N_VDestroyVectorArray(IDA_mem->ida_deltaS, IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypSpredict);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_deltaS);
     for (j = 0; j <= maxcol; j++)
     {
-      N_VDestroyVectorArray(IDA_mem->ida_phiS[j], IDA_mem->ida_Ns);
+      IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_phiS[j]);
     }
     free(IDA_mem->ida_pbar);
     IDA_mem->ida_pbar = NULL;
@@ -4735,19 +4833,19 @@ static void IDASensFreeVectors(IDAMem IDA_mem)
 {
   int j, maxcol;
 
-  N_VDestroyVectorArray(IDA_mem->ida_deltaS, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_ypSpredict, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_yySpredict, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_ypS, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_yyS, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_eeS, IDA_mem->ida_Ns);
-  N_VDestroyVectorArray(IDA_mem->ida_ewtS, IDA_mem->ida_Ns);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_deltaS);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypSpredict);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yySpredict);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ypS);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_yyS);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_eeS);
+  IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_ewtS);
   N_VDestroy(IDA_mem->ida_tmpS3);
 
   maxcol = SUNMAX(IDA_mem->ida_maxord_alloc, 4);
   for (j = 0; j <= maxcol; j++)
   {
-    N_VDestroyVectorArray(IDA_mem->ida_phiS[j], IDA_mem->ida_Ns);
+    IDASensDestroyVectorArray(IDA_mem, IDA_mem->ida_phiS[j]);
   }
 
   free(IDA_mem->ida_pbar);
@@ -8755,6 +8853,74 @@ static int IDAQuadSensRhs1InternalDQ(IDAMem IDA_mem, int is, sunrealtype t,
   return (0);
 }
 
+/*
+ * =================================================================
+ * Step trace functions
+ * =================================================================
+ */
+
+/*
+ * IDAStepTraceCounters
+ *
+ * Samples the cumulative integrator and linear solver counters that
+ * are differenced to form a step trace record.
+ */
+
+static void IDAStepTraceCounters(IDAMem IDA_mem, long int counters[])
+{
+  IDALsMem idals_mem = NULL;
+
+  counters[SUN_STEPTRACE_NETF]    = IDA_mem->ida_netf;
+  counters[SUN_STEPTRACE_NCFN]    = IDA_mem->ida_ncfn;
+  counters[SUN_STEPTRACE_NNI]     = IDA_mem->ida_nni;
+  counters[SUN_STEPTRACE_NSETUPS] = IDA_mem->ida_nsetups;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  if (IDA_mem->ida_lmem)
+  {
+    idals_mem                       = (IDALsMem)IDA_mem->ida_lmem;
+    counters[SUN_STEPTRACE_NLI]     = idals_mem->nli;
+    counters[SUN_STEPTRACE_NJEVALS] = idals_mem->nje;
+  }
+}
+
+/*
+ * IDAStepTraceRecord
+ *
+ * Writes a record for the step just attempted by IDAStep to trace, the
+ * step trace that was attached to the SUNContext when the counters in
+ * start were sampled. On failure the record holds the step size and
+ * order of the last attempt.
+ */
+
+static void IDAStepTraceRecord(IDAMem IDA_mem, SUNStepTrace trace,
+                               int sflag, const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  IDAStepTraceCounters(IDA_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_IDAS, start, end);
+
+  record.t    = (double)IDA_mem->ida_tn;
+  record.flag = sflag;
+  if (sflag == IDA_SUCCESS)
+  {
+    record.h     = (double)IDA_mem->ida_hused;
+    record.step  = IDA_mem->ida_nst;
+    record.order = IDA_mem->ida_kused;
+  }
+  else
+  {
+    record.h     = (double)IDA_mem->ida_hh;
+    record.step  = IDA_mem->ida_nst + 1;
+    record.order = IDA_mem->ida_kk;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
 /*
  * =================================================================
  * IDA error message handling functions
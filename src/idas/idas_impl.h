@@ -25,6 +25,7 @@
 
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
 extern "C" {
@@ -42,8 +43,9 @@ extern "C" {
 /* Shortcuts                                                       */
 /*=================================================================*/
 
-#define IDA_PROFILER IDA_mem->ida_sunctx->profiler
-#define IDA_LOGGER   IDA_mem->ida_sunctx->logger
+#define IDA_PROFILER  IDA_mem->ida_sunctx->profiler
+#define IDA_LOGGER    IDA_mem->ida_sunctx->logger
+#define IDA_STEPTRACE IDA_mem->ida_sunctx->steptrace
 
 /*
  * =================================================================
@@ -164,6 +166,8 @@ typedef struct IDAMemRec
   int ida_DQtype;
   sunrealtype ida_DQrhomax;
 
+  sunbooleantype ida_contigS; /* one contiguous N x Ns block per array?   */
+
   sunbooleantype ida_errconS; /* SUNTRUE if sensitivities in err. control  */
 
   int ida_itolS;
@@ -470,6 +474,10 @@ typedef struct IDAMemRec
   int (*ida_lsolve)(struct IDAMemRec* idamem, N_Vector b, N_Vector weight,
                     N_Vector ycur, N_Vector ypcur, N_Vector rescur);
 
+  int (*ida_lsolvemulti)(struct IDAMemRec* idamem, int nrhs, N_Vector* b,
+                         N_Vector* weight, N_Vector ycur, N_Vector ypcur,
+                         N_Vector rescur);
+
   int (*ida_lperf)(struct IDAMemRec* idamem, int perftask);
 
   int (*ida_lfree)(struct IDAMemRec* idamem);
@@ -548,6 +556,10 @@ typedef struct IDAadjMemRec* IDAadjMem;
 typedef struct IDAckpntMemRec* IDAckpntMem;
 typedef struct IDAdtpntMemRec* IDAdtpntMem;
 typedef struct IDABMemRec* IDABMem;
+typedef struct IDAAstoreMemRec* IDAAstoreMem;
+
+/* Offsets in the storage file of the adjoint module */
+typedef int64_t IDAAoffset;
 
 /*
  * -----------------------------------------------------------------
@@ -638,6 +650,11 @@ struct IDAckpntMemRec
   /* How many phi, phiS, phiQ and phiQS were allocated? */
   int ck_phi_alloc;
 
+  /* Offset and size of the phi* vectors in the storage file
+     (ck_offset < 0 if the vectors are kept in memory) */
+  IDAAoffset ck_offset;
+  size_t ck_size;
+
   /* Pointer to next structure in list */
   struct IDAckpntMemRec* ck_next;
 };
@@ -844,8 +861,61 @@ struct IDAadjMemRec
   /* Workspace for wrapper functions */
   N_Vector ia_yyTmp, ia_ypTmp;
   N_Vector *ia_yySTmp, *ia_ypSTmp;
+
+  /* ------------
+   * Storage data
+   * ------------ */
+
+  /* Options set by the user */
+  char* ia_storeDir;               /* directory for the storage file */
+  sunbooleantype ia_storeCompress; /* compress stored records?       */
+  long int ia_ncache;              /* data points kept in memory     */
+
+  /* Storage file (NULL if all data is kept in memory) */
+  IDAAstoreMem ia_store;
+
+  /* Sizes of the records in the storage file */
+  size_t ia_pntSize;      /* packed data point               */
+  size_t ia_pntRecord;    /* file space for one data point   */
+  IDAAoffset ia_ckBase;   /* offset of the first check point */
+  IDAAoffset ia_ckOffset; /* offset of the next check point  */
+
+  /* Buffer and vector list for packing records */
+  char* ia_storeBuf;
+  size_t ia_storeBufSize;
+  N_Vector* ia_storeVecs;
+
+  /* Cache of data points: the content structures of the ncache slots
+     are attached to the data points they currently hold */
+  void** ia_slotContent;        /* content of each slot                 */
+  long int* ia_slotPnt;         /* data point in each slot (-1 if none) */
+  long int* ia_slotUsed;        /* last use of each slot                */
+  sunbooleantype* ia_slotDirty; /* slot not written to the file yet?    */
+  long int* ia_pntSlot;         /* slot of each data point (-1 if none) */
+  long int ia_useCount;         /* number of slot uses                  */
 };
 
+/*
+ * -----------------------------------------------------------------
+ * Storage file for the adjoint module (idaa_store.c)
+ * -----------------------------------------------------------------
+ */
+
+/* Number of records read ahead by the prefetch thread */
+#define IDAA_NPREFETCH 4
+
+IDAAstoreMem IDAAstoreCreate(const char* dir, sunbooleantype compress);
+void IDAAstoreFree(IDAAstoreMem* store);
+int IDAAstoreWrite(IDAAstoreMem store, IDAAoffset offset, const char* data,
+                   size_t size);
+int IDAAstoreRead(IDAAstoreMem store, IDAAoffset offset, char* data,
+                  size_t size);
+void IDAAstorePrefetch(IDAAstoreMem store, IDAAoffset offset, size_t size);
+size_t IDAAstoreRecordSize(size_t size);
+
+/* Makes the data points lo to hi available in memory (idaa.c) */
+int IDAAdataLoad(IDAMem IDA_mem, long int lo, long int hi);
+
 /*
  * =================================================================
  *     I N T E R F A C E   T O    L I N E A R   S O L V E R S
@@ -915,6 +985,22 @@ struct IDAadjMemRec
  * -----------------------------------------------------------------
  */
 
+/*
+ * -----------------------------------------------------------------
+ * int (*ida_lsolvemulti)(IDAMem IDA_mem, int nrhs, N_Vector* b,
+ *                        N_Vector* weight, N_Vector ycur,
+ *                        N_Vector ypcur, N_Vector rescur);
+ * -----------------------------------------------------------------
+ * ida_lsolvemulti is optional and solves P x = b[i] for the nrhs
+ * right-hand sides together, returning the solutions in b. The
+ * error weights of b[i] are in weight[i]. It is set for direct
+ * solvers that support several right-hand sides and, when enabled
+ * with IDASetSensBlockKrylov, for iterative solvers, so the
+ * sensitivity systems may be solved with the state system.
+ * The return values are the same as for ida_lsolve.
+ * -----------------------------------------------------------------
+ */
+
 /*
  * -----------------------------------------------------------------
  * int (*ida_lperf)(IDAMem IDA_mem, int perftask);
@@ -1076,6 +1162,8 @@ int IDASensResDQ(int Ns, sunrealtype t, N_Vector yy, N_Vector yp,
 #define MSG_BAD_DQTYPE \
   "Illegal value for DQtype. Legal values are: IDA_CENTERED and IDA_FORWARD."
 #define MSG_BAD_DQRHO "DQrhomax < 0 illegal."
+#define MSG_SENS_CONTIG_ALLOC \
+  "The sensitivity storage must be chosen before calling IDASensInit."
 
 #define MSG_NULL_ABSTOLQS "abstolQS = NULL illegal parameter."
 #define MSG_BAD_RELTOLQS  "reltolQS < 0 illegal parameter."
@@ -1251,6 +1339,15 @@ int IDASensResDQ(int Ns, sunrealtype t, N_Vector yy, N_Vector yp,
   "This function cannot be called for the specified interp type."
 #define MSGAM_MEM_FAIL  "A memory request failed."
 #define MSGAM_NO_INITBS "Illegal attempt to call before calling IDAInitBS."
+#define MSGAM_STORE_LATE \
+  "Storage options must be set before the first call to IDASolveF."
+#define MSGAM_BAD_NCACHE "ncache must be zero or at least 6."
+#define MSGAM_NO_BUFOPS                                                    \
+  "Disk storage requires the N_Vector operations N_VBufSize, N_VBufPack, " \
+  "and N_VBufUnpack."
+#define MSGAM_STORE_CREATE "Could not create a storage file in %s."
+#define MSGAM_STORE_FAIL   "Reading or writing the storage file failed."
+#define MSGAM_STORE_FULL   "The storage file exceeds the largest file offset."
 
 #ifdef __cplusplus
 }
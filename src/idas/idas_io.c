@@ -989,6 +989,33 @@ int IDASetSensMaxNonlinIters(void* ida_mem, int maxcorS)
 
 /*-----------------------------------------------------------------*/
 
+int IDASetSensContiguous(void* ida_mem, sunbooleantype contiguous)
+{
+  IDAMem IDA_mem;
+
+  if (ida_mem == NULL)
+  {
+    IDAProcessError(NULL, IDA_MEM_NULL, __LINE__, __func__, __FILE__, MSG_NO_MEM);
+    return (IDA_MEM_NULL);
+  }
+
+  IDA_mem = (IDAMem)ida_mem;
+
+  /* the storage cannot change once the vectors are allocated */
+  if (IDA_mem->ida_sensMallocDone)
+  {
+    IDAProcessError(IDA_mem, IDA_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    MSG_SENS_CONTIG_ALLOC);
+    return (IDA_ILL_INPUT);
+  }
+
+  IDA_mem->ida_contigS = contiguous;
+
+  return (IDA_SUCCESS);
+}
+
+/*-----------------------------------------------------------------*/
+
 int IDASetSensParams(void* ida_mem, sunrealtype* p, sunrealtype* pbar, int* plist)
 {
   IDAMem IDA_mem;
@@ -15,6 +15,7 @@
  * Implementation file for IDAS' linear solver interface
  *-----------------------------------------------------------------*/
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,6 +28,10 @@
 #include "idas_impl.h"
 #include "idas_ls_impl.h"
 
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
 /* constants */
 #define MAX_ITERS 3 /* max. number of attempts to recover in DQ J*v */
 #define ZERO      SUN_RCONST(0.0)
@@ -194,6 +199,13 @@ int IDASetLinearSolver(void* ida_mem, SUNLinearSolver LS, SUNMatrix A)
   /* Set ida_lperf if using an iterative SUNLinearSolver object */
   IDA_mem->ida_lperf = (iterative) ? idaLsPerf : NULL;
 
+  /* Solve several systems with one call if the direct solver supports it */
+  IDA_mem->ida_lsolvemulti = NULL;
+  if ((LSType == SUNLINEARSOLVER_DIRECT) && (LS->ops->solvemulti != NULL))
+  {
+    IDA_mem->ida_lsolvemulti = idaLsSolveMulti;
+  }
+
   /* Allocate memory for IDALsMemRec */
   idals_mem = NULL;
   idals_mem = (IDALsMem)malloc(sizeof(struct IDALsMemRec));
@@ -364,6 +376,66 @@ int IDASetJacFn(void* ida_mem, IDALsJacFn jac)
   return (IDALS_SUCCESS);
 }
 
+/* IDASetBatchResFn specifies a function evaluating the residual at
+   several points in one call. When set, it is used by the internal dense
+   and band DQ Jacobian approximations with at most max_batch points per
+   call (IDALS_MAX_BATCH if max_batch = 0, all columns or column groups at
+   once if max_batch < 0). */
+int IDASetBatchResFn(void* ida_mem, IDALsBatchResFn fb, int max_batch)
+{
+  IDAMem IDA_mem;
+  IDALsMem idals_mem;
+  int retval;
+
+  /* access IDALsMem structure */
+  retval = idaLs_AccessLMem(ida_mem, __func__, &IDA_mem, &idals_mem);
+  if (retval != IDALS_SUCCESS) { return (retval); }
+
+  /* release batch vectors sized for a previous setting */
+  idaLsBatchFree(idals_mem);
+
+  idals_mem->resbatch  = fb;
+  /* max_batch = 0 selects the default bound, max_batch < 0 all columns */
+  if (max_batch == 0) { idals_mem->max_batch = IDALS_MAX_BATCH; }
+  else if (max_batch < 0) { idals_mem->max_batch = INT_MAX; }
+  else { idals_mem->max_batch = max_batch; }
+
+  return (IDALS_SUCCESS);
+}
+
+/* IDASetDQJacNumThreads specifies the number of OpenMP threads used to
+   evaluate the columns (or column groups) of the internal dense and band
+   DQ Jacobian approximations concurrently. The residual function must be
+   thread-safe when nthreads > 1. */
+int IDASetDQJacNumThreads(void* ida_mem, int nthreads)
+{
+  IDAMem IDA_mem;
+  IDALsMem idals_mem;
+  int retval;
+
+  /* access IDALsMem structure */
+  retval = idaLs_AccessLMem(ida_mem, __func__, &IDA_mem, &idals_mem);
+  if (retval != IDALS_SUCCESS) { return (retval); }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* release work vectors sized for a previous setting */
+  idaLsThreadFree(idals_mem);
+
+  idals_mem->dqnthreads = (nthreads > 1) ? nthreads : 0;
+
+  return (IDALS_SUCCESS);
+#else
+  if (nthreads > 1)
+  {
+    IDAProcessError(IDA_mem, IDALS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "SUNDIALS was not built with OpenMP enabled");
+    return (IDALS_ILL_INPUT);
+  }
+
+  return (IDALS_SUCCESS);
+#endif
+}
+
 /* IDASetEpsLin specifies the nonlinear -> linear tolerance scale factor */
 int IDASetEpsLin(void* ida_mem, sunrealtype eplifac)
 {
@@ -441,6 +513,41 @@ int IDASetLinearSolutionScaling(void* ida_mem, sunbooleantype onoff)
   return (IDALS_SUCCESS);
 }
 
+/* IDASetSensBlockKrylov enables or disables solving the state and sensitivity
+   systems together with a block Krylov method */
+int IDASetSensBlockKrylov(void* ida_mem, sunbooleantype onoff)
+{
+  IDAMem IDA_mem;
+  IDALsMem idals_mem;
+  int retval;
+
+  /* access IDALsMem structure */
+  retval = idaLs_AccessLMem(ida_mem, __func__, &IDA_mem, &idals_mem);
+  if (retval != IDALS_SUCCESS) { return (retval); }
+
+  /* direct solvers always solve the systems together (if supported) */
+  if (!(idals_mem->iterative)) { return (IDALS_SUCCESS); }
+
+  if (!onoff)
+  {
+    IDA_mem->ida_lsolvemulti = NULL;
+    return (IDALS_SUCCESS);
+  }
+
+  /* the solver must support several right-hand sides and scaling vectors */
+  if ((idals_mem->LS->ops->solvemulti == NULL) ||
+      (idals_mem->LS->ops->setscalingvectors == NULL))
+  {
+    IDAProcessError(IDA_mem, IDALS_ILL_INPUT, __LINE__, __func__, __FILE__,
+                    "The linear solver does not support block Krylov solves.");
+    return (IDALS_ILL_INPUT);
+  }
+
+  IDA_mem->ida_lsolvemulti = idaLsSolveMulti;
+
+  return (IDALS_SUCCESS);
+}
+
 /* IDASetIncrementFactor specifies increment factor for DQ approximations to Jv */
 int IDASetIncrementFactor(void* ida_mem, sunrealtype dqincfac)
 {
@@ -1008,6 +1115,20 @@ int idaLsDenseDQJac(sunrealtype tt, sunrealtype c_j, N_Vector yy, N_Vector yp,
   /* access LsMem interface structure */
   idals_mem = (IDALsMem)IDA_mem->ida_lmem;
 
+  /* evaluate all perturbed points with the batched residual if provided */
+  if (idals_mem->resbatch)
+  {
+    return (idaLsDenseDQJacBatch(tt, c_j, yy, yp, rr, Jac, IDA_mem));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the columns concurrently if requested */
+  if (idals_mem->dqnthreads > 1)
+  {
+    return (idaLsDenseDQJacOMP(tt, c_j, yy, yp, rr, Jac, IDA_mem));
+  }
+#endif
+
   /* access matrix dimension */
   N = SUNDenseMatrix_Columns(Jac);
 
@@ -1114,6 +1235,20 @@ int idaLsBandDQJac(sunrealtype tt, sunrealtype c_j, N_Vector yy, N_Vector yp,
   /* access LsMem interface structure */
   idals_mem = (IDALsMem)IDA_mem->ida_lmem;
 
+  /* evaluate all column groups with the batched residual if provided */
+  if (idals_mem->resbatch)
+  {
+    return (idaLsBandDQJacBatch(tt, c_j, yy, yp, rr, Jac, IDA_mem));
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* evaluate the column groups concurrently if requested */
+  if (idals_mem->dqnthreads > 1)
+  {
+    return (idaLsBandDQJacOMP(tt, c_j, yy, yp, rr, Jac, IDA_mem));
+  }
+#endif
+
   /* access matrix dimensions */
   N      = SUNBandMatrix_Columns(Jac);
   mupper = SUNBandMatrix_UpperBandwidth(Jac);
@@ -1229,6 +1364,683 @@ int idaLsBandDQJac(sunrealtype tt, sunrealtype c_j, N_Vector yy, N_Vector yp,
   return (retval);
 }
 
+/*---------------------------------------------------------------
+  idaLsDenseDQJacBatch
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian F_y + c_j*F_y' using the batched residual
+  function. The perturbed points (yy + inc_j e_j, yp + c_j inc_j e_j)
+  for up to max_batch columns are evaluated in one call and the
+  columns of J are then formed as in idaLsDenseDQJac.
+  ---------------------------------------------------------------*/
+int idaLsDenseDQJacBatch(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                         N_Vector yp, N_Vector rr, SUNMatrix Jac,
+                         IDAMem IDA_mem)
+{
+  sunrealtype inc, inc_inv, srur;
+  sunrealtype *y_data, *yp_data, *ewt_data, *cns_data = NULL;
+  N_Vector jthCol;
+  sunindextype j, j0, N;
+  int k, nb, nstates;
+  IDALsMem idals_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  idals_mem = (IDALsMem)IDA_mem->ida_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* number of points per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (idals_mem->max_batch < N) ? idals_mem->max_batch : (int)N;
+  if (idaLsBatchAlloc(idals_mem, yy, nb))
+  {
+    IDAProcessError(IDA_mem, IDALS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (IDALS_MEM_FAIL);
+  }
+
+  /* Create an empty vector for matrix column calculations */
+  jthCol = N_VCloneEmpty(yy);
+
+  /* Obtain pointers to the data for ewt, yy, yp. */
+  ewt_data = N_VGetArrayPointer(IDA_mem->ida_ewt);
+  y_data   = N_VGetArrayPointer(yy);
+  yp_data  = N_VGetArrayPointer(yp);
+  if (IDA_mem->ida_constraintsSet)
+  {
+    cns_data = N_VGetArrayPointer(IDA_mem->ida_constraints);
+  }
+
+  srur = SUNRsqrt(IDA_mem->ida_uround);
+
+  for (j0 = 0; j0 < N; j0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, N - j0);
+
+    /* Load the perturbed points */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j], cns_data,
+                       j, srur);
+      N_VScale(ONE, yy, idals_mem->ybatch[k]);
+      N_VScale(ONE, yp, idals_mem->ypbatch[k]);
+      N_VGetArrayPointer(idals_mem->ybatch[k])[j] += inc;
+      N_VGetArrayPointer(idals_mem->ypbatch[k])[j] += c_j * inc;
+    }
+
+    retval = idals_mem->resbatch(tt, nstates, idals_mem->ybatch,
+                                 idals_mem->ypbatch, idals_mem->rbatch,
+                                 IDA_mem->ida_user_data);
+    idals_mem->nreDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Construct the difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      j   = j0 + k;
+      inc = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j], cns_data,
+                       j, srur);
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, idals_mem->rbatch[k], -inc_inv, rr, jthCol);
+    }
+  }
+
+  /* Destroy jthCol vector */
+  N_VSetArrayPointer(NULL, jthCol);
+  N_VDestroy(jthCol);
+
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  idaLsBandDQJacBatch
+
+  This routine generates a banded difference quotient approximation
+  to the DAE system Jacobian using the batched residual function.
+  The perturbed points for up to max_batch column groups are
+  evaluated in one call and the columns of J are then formed as in
+  idaLsBandDQJac.
+  ---------------------------------------------------------------*/
+int idaLsBandDQJacBatch(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                        N_Vector yp, N_Vector rr, SUNMatrix Jac,
+                        IDAMem IDA_mem)
+{
+  sunrealtype inc, inc_inv, srur;
+  sunrealtype *y_data, *yp_data, *ewt_data, *cns_data = NULL;
+  sunrealtype *ytemp_data, *yptemp_data, *rtemp_data, *r_data, *col_j;
+  sunindextype i, j, i1, i2, width, ngroups, group, g0;
+  sunindextype N, mupper, mlower;
+  int k, nb, nstates;
+  IDALsMem idals_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  idals_mem = (IDALsMem)IDA_mem->ida_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* Compute miscellaneous values for the Jacobian computation. */
+  srur    = SUNRsqrt(IDA_mem->ida_uround);
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+  /* number of points per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (idals_mem->max_batch < ngroups) ? idals_mem->max_batch : (int)ngroups;
+  if (idaLsBatchAlloc(idals_mem, yy, nb))
+  {
+    IDAProcessError(IDA_mem, IDALS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (IDALS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, rr, yy, yp. */
+  ewt_data = N_VGetArrayPointer(IDA_mem->ida_ewt);
+  r_data   = N_VGetArrayPointer(rr);
+  y_data   = N_VGetArrayPointer(yy);
+  yp_data  = N_VGetArrayPointer(yp);
+  if (IDA_mem->ida_constraintsSet)
+  {
+    cns_data = N_VGetArrayPointer(IDA_mem->ida_constraints);
+  }
+
+  for (g0 = 0; g0 < ngroups; g0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, ngroups - g0);
+
+    /* Load the points with all yy[j] and yp[j] in each group incremented */
+    for (k = 0; k < nstates; k++)
+    {
+      group = g0 + k;
+      N_VScale(ONE, yy, idals_mem->ybatch[k]);
+      N_VScale(ONE, yp, idals_mem->ypbatch[k]);
+      ytemp_data  = N_VGetArrayPointer(idals_mem->ybatch[k]);
+      yptemp_data = N_VGetArrayPointer(idals_mem->ypbatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        inc = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j],
+                         cns_data, j, srur);
+        ytemp_data[j] += inc;
+        yptemp_data[j] += c_j * inc;
+      }
+    }
+
+    retval = idals_mem->resbatch(tt, nstates, idals_mem->ybatch,
+                                 idals_mem->ypbatch, idals_mem->rbatch,
+                                 IDA_mem->ida_user_data);
+    idals_mem->nreDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Load the difference quotient Jacobian elements */
+    for (k = 0; k < nstates; k++)
+    {
+      group      = g0 + k;
+      rtemp_data = N_VGetArrayPointer(idals_mem->rbatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc   = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j],
+                           cns_data, j, srur);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv *
+                                             (rtemp_data[i] - r_data[i]);
+        }
+      }
+    }
+  }
+
+  return (retval);
+}
+
+/*---------------------------------------------------------------
+  idaLsDQInc
+
+  This routine returns the increment to y_j used in the DQ
+  Jacobian approximations: sqrt(uround)*abs(y_j), with adjustments
+  using yp_j and ewt_j if this is small, the sign of hh*yp_j, and
+  a further sign adjustment if y_j has an inequality constraint.
+  ---------------------------------------------------------------*/
+sunrealtype idaLsDQInc(IDAMem IDA_mem, sunrealtype yj, sunrealtype ypj,
+                       sunrealtype ewtj, sunrealtype* cns_data,
+                       sunindextype j, sunrealtype srur)
+{
+  sunrealtype inc, conj;
+
+  inc = SUNMAX(srur * SUNMAX(SUNRabs(yj), SUNRabs(IDA_mem->ida_hh * ypj)),
+               ONE / ewtj);
+  if (IDA_mem->ida_hh * ypj < ZERO) { inc = -inc; }
+  inc = (yj + inc) - yj;
+
+  if (IDA_mem->ida_constraintsSet)
+  {
+    conj = cns_data[j];
+    if (SUNRabs(conj) == ONE)
+    {
+      if ((yj + inc) * conj < ZERO) { inc = -inc; }
+    }
+    else if (SUNRabs(conj) == TWO)
+    {
+      if ((yj + inc) * conj <= ZERO) { inc = -inc; }
+    }
+  }
+
+  return (inc);
+}
+
+/*---------------------------------------------------------------
+  idaLsBatchAlloc and idaLsBatchFree
+
+  These routines allocate (at least nvecs) and free the vectors
+  passed to the batched residual function.
+  ---------------------------------------------------------------*/
+int idaLsBatchAlloc(IDALsMem idals_mem, N_Vector tmpl, int nvecs)
+{
+  if (idals_mem->nbatch >= nvecs) { return (0); }
+
+  idaLsBatchFree(idals_mem);
+
+  idals_mem->ybatch  = N_VCloneVectorArray(nvecs, tmpl);
+  idals_mem->ypbatch = N_VCloneVectorArray(nvecs, tmpl);
+  idals_mem->rbatch  = N_VCloneVectorArray(nvecs, tmpl);
+  if (idals_mem->ybatch == NULL || idals_mem->ypbatch == NULL ||
+      idals_mem->rbatch == NULL)
+  {
+    idaLsBatchFree(idals_mem);
+    return (-1);
+  }
+  idals_mem->nbatch = nvecs;
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  idaLsMultiAlloc and idaLsMultiFree
+
+  These routines grow (to at least nrhs) and free the workspace
+  for solving several systems together with an iterative solver.
+  ---------------------------------------------------------------*/
+int idaLsMultiAlloc(IDALsMem idals_mem, int nrhs)
+{
+  if (idals_mem->nmulti >= nrhs) { return (0); }
+
+  idaLsMultiFree(idals_mem);
+
+  idals_mem->bmulti = (N_Vector*)malloc(nrhs * sizeof(N_Vector));
+  idals_mem->cmulti = (sunrealtype*)malloc(nrhs * sizeof(sunrealtype));
+  idals_mem->xmulti = N_VCloneVectorArray(nrhs, idals_mem->x);
+  if (idals_mem->bmulti == NULL || idals_mem->cmulti == NULL ||
+      idals_mem->xmulti == NULL)
+  {
+    idaLsMultiFree(idals_mem);
+    return (-1);
+  }
+  idals_mem->nmulti = nrhs;
+
+  return (0);
+}
+
+void idaLsMultiFree(IDALsMem idals_mem)
+{
+  if (idals_mem->xmulti)
+  {
+    N_VDestroyVectorArray(idals_mem->xmulti, idals_mem->nmulti);
+  }
+  free(idals_mem->bmulti);
+  free(idals_mem->cmulti);
+  idals_mem->bmulti = NULL;
+  idals_mem->cmulti = NULL;
+  idals_mem->xmulti = NULL;
+  idals_mem->nmulti = 0;
+}
+
+void idaLsBatchFree(IDALsMem idals_mem)
+{
+  if (idals_mem->ybatch)
+  {
+    N_VDestroyVectorArray(idals_mem->ybatch, idals_mem->nbatch);
+  }
+  if (idals_mem->ypbatch)
+  {
+    N_VDestroyVectorArray(idals_mem->ypbatch, idals_mem->nbatch);
+  }
+  if (idals_mem->rbatch)
+  {
+    N_VDestroyVectorArray(idals_mem->rbatch, idals_mem->nbatch);
+  }
+  idals_mem->ybatch  = NULL;
+  idals_mem->ypbatch = NULL;
+  idals_mem->rbatch  = NULL;
+  idals_mem->nbatch  = 0;
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+
+/*---------------------------------------------------------------
+  idaLsDenseDQJacOMP
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian F_y + c_j*F_y' with the columns distributed
+  across dqnthreads OpenMP threads. Each thread perturbs its own
+  copies of yy and yp and the columns are formed exactly as in
+  idaLsDenseDQJac, so the result does not depend on the number of
+  threads. If the residual function fails, the value returned for
+  the first failed column is returned.
+  ---------------------------------------------------------------*/
+int idaLsDenseDQJacOMP(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                       N_Vector yp, N_Vector rr, SUNMatrix Jac, IDAMem IDA_mem)
+{
+  sunrealtype srur;
+  sunrealtype *y_data, *yp_data, *ewt_data, *cns_data = NULL;
+  sunindextype N;
+  IDALsMem idals_mem;
+
+  /* access LsMem interface structure */
+  idals_mem = (IDALsMem)IDA_mem->ida_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* per-thread work vectors */
+  if (idaLsThreadAlloc(idals_mem, yy))
+  {
+    IDAProcessError(IDA_mem, IDALS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (IDALS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, yy, yp. */
+  ewt_data = N_VGetArrayPointer(IDA_mem->ida_ewt);
+  y_data   = N_VGetArrayPointer(yy);
+  yp_data  = N_VGetArrayPointer(yp);
+  if (IDA_mem->ida_constraintsSet)
+  {
+    cns_data = N_VGetArrayPointer(IDA_mem->ida_constraints);
+  }
+
+  srur = SUNRsqrt(IDA_mem->ida_uround);
+
+#pragma omp parallel num_threads(idals_mem->dqnthreads)
+  {
+    int tid           = omp_get_thread_num();
+    N_Vector ytemp    = idals_mem->ythr[tid];
+    N_Vector yptemp   = idals_mem->ypthr[tid];
+    N_Vector rtemp    = idals_mem->rthr[tid];
+    N_Vector jthCol   = idals_mem->colthr[tid];
+    sunrealtype* ytd  = N_VGetArrayPointer(ytemp);
+    sunrealtype* yptd = N_VGetArrayPointer(yptemp);
+    sunrealtype inc, inc_inv;
+    sunindextype j;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, yy, ytemp);
+    N_VScale(ONE, yp, yptemp);
+
+#pragma omp for schedule(static)
+    for (j = 0; j < N; j++)
+    {
+      /* skip the remaining columns of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = j; }
+
+      inc = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j], cns_data,
+                       j, srur);
+
+      ytd[j] += inc;
+      yptd[j] += c_j * inc;
+      ier = IDA_mem->ida_res(tt, ytemp, yptemp, rtemp, IDA_mem->ida_user_data);
+      nfe++;
+      ytd[j]  = y_data[j];
+      yptd[j] = yp_data[j];
+      if (ier != 0)
+      {
+        jfail = j;
+        ret   = ier;
+        continue;
+      }
+
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, rtemp, -inc_inv, rr, jthCol);
+    }
+
+    N_VSetArrayPointer(NULL, jthCol);
+
+    idals_mem->thrfirst[tid] = jfirst;
+    idals_mem->thrfail[tid]  = jfail;
+    idals_mem->thrret[tid]   = ret;
+    idals_mem->thrnre[tid]   = nfe;
+  }
+
+  return (idaLsThreadRetval(idals_mem));
+}
+
+/*---------------------------------------------------------------
+  idaLsBandDQJacOMP
+
+  This routine generates a banded difference quotient approximation
+  to the DAE system Jacobian with the column groups distributed
+  across dqnthreads OpenMP threads. Each thread perturbs its own
+  copies of yy and yp and the columns are formed exactly as in
+  idaLsBandDQJac.
+  ---------------------------------------------------------------*/
+int idaLsBandDQJacOMP(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                      N_Vector yp, N_Vector rr, SUNMatrix Jac, IDAMem IDA_mem)
+{
+  sunrealtype srur;
+  sunrealtype *y_data, *yp_data, *ewt_data, *r_data, *cns_data = NULL;
+  sunindextype width, ngroups, N, mupper, mlower;
+  IDALsMem idals_mem;
+
+  /* access LsMem interface structure */
+  idals_mem = (IDALsMem)IDA_mem->ida_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* per-thread work vectors */
+  if (idaLsThreadAlloc(idals_mem, yy))
+  {
+    IDAProcessError(IDA_mem, IDALS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (IDALS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for ewt, rr, yy, yp. */
+  ewt_data = N_VGetArrayPointer(IDA_mem->ida_ewt);
+  r_data   = N_VGetArrayPointer(rr);
+  y_data   = N_VGetArrayPointer(yy);
+  yp_data  = N_VGetArrayPointer(yp);
+  if (IDA_mem->ida_constraintsSet)
+  {
+    cns_data = N_VGetArrayPointer(IDA_mem->ida_constraints);
+  }
+
+  /* Compute miscellaneous values for the Jacobian computation. */
+  srur    = SUNRsqrt(IDA_mem->ida_uround);
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+#pragma omp parallel num_threads(idals_mem->dqnthreads)
+  {
+    int tid           = omp_get_thread_num();
+    N_Vector ytemp    = idals_mem->ythr[tid];
+    N_Vector yptemp   = idals_mem->ypthr[tid];
+    N_Vector rtemp    = idals_mem->rthr[tid];
+    sunrealtype* ytd  = N_VGetArrayPointer(ytemp);
+    sunrealtype* yptd = N_VGetArrayPointer(yptemp);
+    sunrealtype* rtd  = N_VGetArrayPointer(rtemp);
+    sunrealtype *col_j, inc, inc_inv;
+    sunindextype group, i, j, i1, i2;
+    int ier;
+
+    /* failure and counter of this thread, stored after the loop */
+    sunindextype jfirst = -1;
+    sunindextype jfail  = -1;
+    long int nfe        = 0;
+    int ret             = 0;
+
+    N_VScale(ONE, yy, ytemp);
+    N_VScale(ONE, yp, yptemp);
+
+#pragma omp for schedule(static)
+    for (group = 0; group < ngroups; group++)
+    {
+      /* skip the remaining groups of this thread after a failure */
+      if (jfail >= 0) { continue; }
+      if (jfirst < 0) { jfirst = group; }
+
+      /* Increment all yy[j] and yp[j] in this group */
+      for (j = group; j < N; j += width)
+      {
+        inc = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j],
+                         cns_data, j, srur);
+        ytd[j] += inc;
+        yptd[j] += c_j * inc;
+      }
+
+      ier = IDA_mem->ida_res(tt, ytemp, yptemp, rtemp, IDA_mem->ida_user_data);
+      nfe++;
+
+      /* Reset the perturbed components of ytemp and yptemp */
+      for (j = group; j < N; j += width)
+      {
+        ytd[j]  = y_data[j];
+        yptd[j] = yp_data[j];
+      }
+
+      if (ier != 0)
+      {
+        jfail = group;
+        ret   = ier;
+        continue;
+      }
+
+      /* Load the difference quotient Jacobian elements */
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc   = idaLsDQInc(IDA_mem, y_data[j], yp_data[j], ewt_data[j],
+                           cns_data, j, srur);
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv * (rtd[i] - r_data[i]);
+        }
+      }
+    }
+
+    idals_mem->thrfirst[tid] = jfirst;
+    idals_mem->thrfail[tid]  = jfail;
+    idals_mem->thrret[tid]   = ret;
+    idals_mem->thrnre[tid]   = nfe;
+  }
+
+  return (idaLsThreadRetval(idals_mem));
+}
+
+/*---------------------------------------------------------------
+  idaLsThreadAlloc
+
+  This routine allocates the per-thread work vectors (if needed)
+  and resets the per-thread failure flags and counters.
+  ---------------------------------------------------------------*/
+int idaLsThreadAlloc(IDALsMem idals_mem, N_Vector tmpl)
+{
+  int nt = idals_mem->dqnthreads;
+  int k;
+
+  if (idals_mem->nthrvecs < nt)
+  {
+    idaLsThreadFree(idals_mem);
+
+    idals_mem->ythr     = N_VCloneVectorArray(nt, tmpl);
+    idals_mem->ypthr    = N_VCloneVectorArray(nt, tmpl);
+    idals_mem->rthr     = N_VCloneVectorArray(nt, tmpl);
+    idals_mem->colthr   = N_VCloneEmptyVectorArray(nt, tmpl);
+    idals_mem->thrfirst = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    idals_mem->thrfail  = (sunindextype*)malloc(nt * sizeof(sunindextype));
+    idals_mem->thrret   = (int*)malloc(nt * sizeof(int));
+    idals_mem->thrnre   = (long int*)malloc(nt * sizeof(long int));
+    idals_mem->nthrvecs = nt;
+    if (idals_mem->ythr == NULL || idals_mem->ypthr == NULL ||
+        idals_mem->rthr == NULL || idals_mem->colthr == NULL ||
+        idals_mem->thrfail == NULL || idals_mem->thrret == NULL ||
+        idals_mem->thrnre == NULL || idals_mem->thrfirst == NULL)
+    {
+      idaLsThreadFree(idals_mem);
+      return (-1);
+    }
+  }
+
+  for (k = 0; k < nt; k++)
+  {
+    idals_mem->thrfirst[k] = -1;
+    idals_mem->thrfail[k]  = -1;
+    idals_mem->thrret[k]   = 0;
+    idals_mem->thrnre[k]   = 0;
+  }
+
+  return (0);
+}
+
+/*---------------------------------------------------------------
+  idaLsThreadRetval
+
+  This routine adds the per-thread residual evaluations to nreDQ
+  and returns the residual return value for the first failed
+  column (or group), i.e., the value the serial loop would return.
+  ---------------------------------------------------------------*/
+int idaLsThreadRetval(IDALsMem idals_mem)
+{
+  sunindextype jfail = -1;
+  int k, retval      = 0;
+
+  /* first failed column (or group) over all threads */
+  for (k = 0; k < idals_mem->dqnthreads; k++)
+  {
+    if (idals_mem->thrfail[k] >= 0 &&
+        (jfail < 0 || idals_mem->thrfail[k] < jfail))
+    {
+      jfail  = idals_mem->thrfail[k];
+      retval = idals_mem->thrret[k];
+    }
+  }
+
+  /* the serial loop stops after the failed evaluation, so only the
+     threads whose block starts at or before it are counted */
+  for (k = 0; k < idals_mem->dqnthreads; k++)
+  {
+    if (idals_mem->thrfirst[k] >= 0 &&
+        (jfail < 0 || idals_mem->thrfirst[k] <= jfail))
+    {
+      idals_mem->nreDQ += idals_mem->thrnre[k];
+    }
+  }
+
+  return (retval);
+}
+
+#endif
+
+/*---------------------------------------------------------------
+  idaLsThreadFree
+
+  This routine frees the per-thread work vectors.
+  ---------------------------------------------------------------*/
+void idaLsThreadFree(IDALsMem idals_mem)
+{
+  if (idals_mem->ythr)
+  {
+    N_VDestroyVectorArray(idals_mem->ythr, idals_mem->nthrvecs);
+  }
+  if (idals_mem->ypthr)
+  {
+    N_VDestroyVectorArray(idals_mem->ypthr, idals_mem->nthrvecs);
+  }
+  if (idals_mem->rthr)
+  {
+    N_VDestroyVectorArray(idals_mem->rthr, idals_mem->nthrvecs);
+  }
+  if (idals_mem->colthr)
+  {
+    N_VDestroyVectorArray(idals_mem->colthr, idals_mem->nthrvecs);
+  }
+  free(idals_mem->thrfirst);
+  free(idals_mem->thrfail);
+  free(idals_mem->thrret);
+  free(idals_mem->thrnre);
+  idals_mem->ythr     = NULL;
+  idals_mem->ypthr    = NULL;
+  idals_mem->rthr     = NULL;
+  idals_mem->colthr   = NULL;
+  idals_mem->thrfirst = NULL;
+  idals_mem->thrfail  = NULL;
+  idals_mem->thrret   = NULL;
+  idals_mem->thrnre   = NULL;
+  idals_mem->nthrvecs = 0;
+}
+
 /*---------------------------------------------------------------
   idaLsDQJtimes
 
@@ -1664,6 +2476,213 @@ int idaLsSolve(IDAMem IDA_mem, N_Vector b, N_Vector weight, N_Vector ycur,
   return (0);
 }
 
+/*---------------------------------------------------------------
+ idaLsSolveMulti
+
+ This routine solves the linear systems with several right-hand
+ sides using SUNLinSolSolveMulti. Direct solvers do not use the
+ weights or tolerances and solve in place. Iterative solvers use
+ the weights of b[0] as scaling vectors for all systems, and each
+ right-hand side is scaled by the RMS norm of weight[i]/weight[0]
+ so that its residual is measured approximately in its own
+ weighted norm. As in idaLsSolve, no right-hand side is skipped
+ and the initial guesses are zero. If the block solve does not
+ converge, the systems are solved one at a time with idaLsSolve.
+ The solutions are returned in b.
+---------------------------------------------------------------*/
+int idaLsSolveMulti(IDAMem IDA_mem, int nrhs, N_Vector* b, N_Vector* weight,
+                    N_Vector ycur, N_Vector ypcur, N_Vector rescur)
+{
+  IDALsMem idals_mem;
+  sunrealtype tol;
+  int i, retval;
+
+  /* access IDALsMem structure */
+  if (IDA_mem->ida_lmem == NULL)
+  {
+    IDAProcessError(IDA_mem, IDALS_LMEM_NULL, __LINE__, __func__, __FILE__,
+                    MSG_LS_LMEM_NULL);
+    return (IDALS_LMEM_NULL);
+  }
+  idals_mem = (IDALsMem)IDA_mem->ida_lmem;
+
+  tol = ZERO;
+
+  /* If the linear solver is iterative: scale the right-hand sides by their
+     weight ratios and set the tolerance as in idaLsSolve */
+  if (idals_mem->iterative)
+  {
+    if (idaLsMultiAlloc(idals_mem, nrhs))
+    {
+      IDAProcessError(IDA_mem, IDALS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                      MSG_LS_MEM_FAIL);
+      return (-1);
+    }
+
+    tol = idals_mem->nrmfac * idals_mem->eplifac * IDA_mem->ida_epsNewt;
+
+    SUNLogInfo(IDA_LOGGER, "begin-linear-solve",
+               "iterative = 1, nrhs = %d, res-tol = %.16g", nrhs, tol);
+
+    /* the weight ratios are the RMS norms of weight[i] / weight[0] */
+    N_VInv(weight[0], idals_mem->x);
+    for (i = 0; i < nrhs; i++)
+    {
+      idals_mem->bmulti[i] = b[i];
+      idals_mem->cmulti[i] = N_VWrmsNorm(weight[i], idals_mem->x);
+    }
+
+    retval = N_VScaleVectorArray(nrhs, idals_mem->cmulti, idals_mem->bmulti,
+                                 idals_mem->bmulti);
+    if (retval != 0) { return (-1); }
+
+    retval = SUNLinSolSetScalingVectors(idals_mem->LS, weight[0], weight[0]);
+    if (retval != SUN_SUCCESS)
+    {
+      IDAProcessError(IDA_mem, IDALS_SUNLS_FAIL, __LINE__, __func__, __FILE__,
+                      "Error in calling SUNLinSolSetScalingVectors");
+      idals_mem->last_flag = IDALS_SUNLS_FAIL;
+
+      SUNLogInfo(IDA_LOGGER, "end-linear-solve",
+                 "status = failed set scaling vectors");
+
+      return (idals_mem->last_flag);
+    }
+
+    retval = SUNLinSolSetZeroGuess(idals_mem->LS, SUNTRUE);
+    if (retval != SUN_SUCCESS)
+    {
+      SUNLogInfo(IDA_LOGGER, "end-linear-solve",
+                 "status = failed set zero guess", "");
+      return (-1);
+    }
+  }
+  else
+  {
+    SUNLogInfo(IDA_LOGGER, "begin-linear-solve", "iterative = 0, nrhs = %d",
+               nrhs);
+  }
+
+  /* Set vectors ycur, ypcur and rcur for use by the Jacobian routines */
+  idals_mem->ycur  = ycur;
+  idals_mem->ypcur = ypcur;
+  idals_mem->rcur  = rescur;
+
+  /* If a user-provided jtsetup routine is supplied, call that here */
+  if (idals_mem->jtsetup)
+  {
+    idals_mem->last_flag = idals_mem->jtsetup(IDA_mem->ida_tn, ycur, ypcur,
+                                              rescur, IDA_mem->ida_cj,
+                                              idals_mem->jt_data);
+    idals_mem->njtsetup++;
+    if (idals_mem->last_flag != 0)
+    {
+      IDAProcessError(IDA_mem, idals_mem->last_flag, __LINE__, __func__,
+                      __FILE__, MSG_LS_JTSETUP_FAILED);
+
+      SUNLogInfo(IDA_LOGGER, "end-linear-solve", "status = failed J-times setup");
+      return (idals_mem->last_flag);
+    }
+  }
+
+  if (idals_mem->iterative)
+  {
+    /* Set the initial guesses to zero, as in idaLsSolve, and call the solver
+       with the solutions in xmulti */
+    retval = N_VConstVectorArray(nrhs, ZERO, idals_mem->xmulti);
+    if (retval != 0) { return (-1); }
+
+    retval = SUNLinSolSolveMulti(idals_mem->LS, idals_mem->J, nrhs,
+                                 idals_mem->xmulti, idals_mem->bmulti, tol);
+    idals_mem->nli += SUNLinSolNumIters(idals_mem->LS);
+
+    for (i = 0; i < nrhs; i++)
+    {
+      idals_mem->cmulti[i] = ONE / idals_mem->cmulti[i];
+    }
+
+    if (retval == SUN_SUCCESS)
+    {
+      /* copy the solutions to b and undo the weight scaling */
+      idals_mem->last_flag = retval;
+      (void)N_VScaleVectorArray(nrhs, idals_mem->cmulti, idals_mem->xmulti,
+                                idals_mem->bmulti);
+
+      /* Scale the corrections to account for change in cj */
+      if (idals_mem->scalesol && (IDA_mem->ida_cjratio != ONE))
+      {
+        for (i = 0; i < nrhs; i++)
+        {
+          N_VScale(TWO / (ONE + IDA_mem->ida_cjratio), idals_mem->bmulti[i],
+                   idals_mem->bmulti[i]);
+        }
+      }
+
+      SUNLogInfo(IDA_LOGGER, "end-linear-solve", "status = success");
+
+      return (0);
+    }
+
+    idals_mem->ncfl++;
+    idals_mem->last_flag = retval;
+
+    SUNLogInfo(IDA_LOGGER, "end-linear-solve",
+               "status = failed block solve, retval = %i", retval);
+
+    if (retval < 0)
+    {
+      if (retval == SUNLS_PSOLVE_FAIL_UNREC)
+      {
+        IDAProcessError(IDA_mem, SUNLS_PSOLVE_FAIL_UNREC, __LINE__, __func__,
+                        __FILE__, MSG_LS_PSOLVE_FAILED);
+      }
+      return (-1);
+    }
+
+    /* Solve the systems one at a time with their own weights */
+    (void)N_VScaleVectorArray(nrhs, idals_mem->cmulti, idals_mem->bmulti,
+                              idals_mem->bmulti);
+    for (i = 0; i < nrhs; i++)
+    {
+      retval = idaLsSolve(IDA_mem, b[i], weight[i], ycur, ypcur, rescur);
+      if (retval != 0) { return (retval); }
+    }
+
+    return (0);
+  }
+
+  /* Call solver, overwriting b with the solutions */
+  retval = SUNLinSolSolveMulti(idals_mem->LS, idals_mem->J, nrhs, b, b, ZERO);
+
+  /* Scale the corrections to account for change in cj */
+  if (idals_mem->scalesol && (IDA_mem->ida_cjratio != ONE))
+  {
+    for (i = 0; i < nrhs; i++)
+    {
+      N_VScale(TWO / (ONE + IDA_mem->ida_cjratio), b[i], b[i]);
+    }
+  }
+
+  /* Increment ncfl counter */
+  if (retval != SUN_SUCCESS) { idals_mem->ncfl++; }
+
+  /* Interpret solver return value  */
+  idals_mem->last_flag = retval;
+
+  SUNLogInfoIf(retval == SUN_SUCCESS, IDA_LOGGER, "end-linear-solve",
+               "status = success");
+  SUNLogInfoIf(retval != SUN_SUCCESS, IDA_LOGGER, "end-linear-solve",
+               "status = failed, retval = %i", retval);
+
+  if (retval == SUN_SUCCESS) { return (0); }
+  if (retval == SUN_ERR_EXT_FAIL)
+  {
+    IDAProcessError(IDA_mem, SUN_ERR_EXT_FAIL, __LINE__, __func__, __FILE__,
+                    "Failure in SUNLinSol external package");
+  }
+  return ((retval < 0) ? -1 : 1);
+}
+
 /*---------------------------------------------------------------
  idaLsPerf: accumulates performance statistics information
  for IDA
@@ -1758,6 +2777,11 @@ int idaLsFree(IDAMem IDA_mem)
     idals_mem->x = NULL;
   }
 
+  /* Free batched residual, per-thread, and multiple RHS workspace */
+  idaLsBatchFree(idals_mem);
+  idaLsThreadFree(idals_mem);
+  idaLsMultiFree(idals_mem);
+
   /* Nullify other N_Vector pointers */
   idals_mem->ycur  = NULL;
   idals_mem->ypcur = NULL;
@@ -26,6 +26,12 @@
 extern "C" {
 #endif
 
+/*-----------------------------------------------------------------
+  IDALS_MAX_BATCH  default maximum number of points passed to the
+                 batched function in one call
+  -----------------------------------------------------------------*/
+#define IDALS_MAX_BATCH 32
+
 /*-----------------------------------------------------------------
   Types : struct IDALsMemRec, struct *IDALsMem
 
@@ -44,6 +50,32 @@ typedef struct IDALsMemRec
   IDALsJacFn jac;       /* Jacobian routine to be called                 */
   void* J_data;         /* J_data is passed to jac                       */
 
+  /* Batched residual used by the DQ Jacobian approximations (may be NULL) */
+  IDALsBatchResFn resbatch;
+  int max_batch;     /* max states per call, INT_MAX for all columns   */
+  int nbatch;        /* number of allocated batch vectors              */
+  N_Vector* ybatch;  /* perturbed y values                             */
+  N_Vector* ypbatch; /* perturbed y' values                            */
+  N_Vector* rbatch;  /* residuals at the perturbed values              */
+
+  /* Thread-parallel DQ Jacobian approximations (OpenMP builds only) */
+  int dqnthreads;         /* number of threads, <= 1 for the serial loop      */
+  int nthrvecs;           /* number of allocated per-thread work vectors      */
+  N_Vector* ythr;         /* per-thread perturbed y values                    */
+  N_Vector* ypthr;        /* per-thread perturbed y' values                   */
+  N_Vector* rthr;         /* per-thread residual values                       */
+  N_Vector* colthr;       /* per-thread (empty) dense matrix columns          */
+  sunindextype* thrfirst; /* per-thread first column (or group)               */
+  sunindextype* thrfail;  /* per-thread failed column (or group)              */
+  int* thrret;            /* per-thread residual return value for it          */
+  long int* thrnre;       /* per-thread number of residual evaluations        */
+
+  /* Block Krylov solves of several systems (iterative solvers only) */
+  int nmulti;          /* length of bmulti, xmulti, and cmulti          */
+  N_Vector* bmulti;    /* right-hand sides passed to the solver         */
+  N_Vector* xmulti;    /* solutions of the block solve                  */
+  sunrealtype* cmulti; /* weight ratios of the right-hand sides         */
+
   /* Linear solver, matrix and vector objects/pointers */
   SUNLinearSolver LS; /* generic linear solver object                  */
   SUNMatrix J;        /* J = dF/dy + cj*dF/dy'                         */
@@ -131,6 +163,28 @@ int idaLsDenseDQJac(sunrealtype tt, sunrealtype c_j, N_Vector yy, N_Vector yp,
 int idaLsBandDQJac(sunrealtype tt, sunrealtype c_j, N_Vector yy, N_Vector yp,
                    N_Vector rr, SUNMatrix Jac, IDAMem IDA_mem, N_Vector tmp1,
                    N_Vector tmp2, N_Vector tmp3);
+int idaLsDenseDQJacBatch(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                         N_Vector yp, N_Vector rr, SUNMatrix Jac,
+                         IDAMem IDA_mem);
+int idaLsBandDQJacBatch(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                        N_Vector yp, N_Vector rr, SUNMatrix Jac,
+                        IDAMem IDA_mem);
+sunrealtype idaLsDQInc(IDAMem IDA_mem, sunrealtype yj, sunrealtype ypj,
+                       sunrealtype ewtj, sunrealtype* cns_data,
+                       sunindextype j, sunrealtype srur);
+int idaLsBatchAlloc(IDALsMem idals_mem, N_Vector tmpl, int nvecs);
+void idaLsBatchFree(IDALsMem idals_mem);
+void idaLsThreadFree(IDALsMem idals_mem);
+int idaLsMultiAlloc(IDALsMem idals_mem, int nrhs);
+void idaLsMultiFree(IDALsMem idals_mem);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+int idaLsDenseDQJacOMP(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                       N_Vector yp, N_Vector rr, SUNMatrix Jac, IDAMem IDA_mem);
+int idaLsBandDQJacOMP(sunrealtype tt, sunrealtype c_j, N_Vector yy,
+                      N_Vector yp, N_Vector rr, SUNMatrix Jac, IDAMem IDA_mem);
+int idaLsThreadAlloc(IDALsMem idals_mem, N_Vector tmpl);
+int idaLsThreadRetval(IDALsMem idals_mem);
+#endif
 
 /* Generic linit/lsetup/lsolve/lperf/lfree interface routines for IDA to call */
 int idaLsInitialize(IDAMem IDA_mem);
@@ -138,6 +192,8 @@ int idaLsSetup(IDAMem IDA_mem, N_Vector y, N_Vector yp, N_Vector r,
                N_Vector vt1, N_Vector vt2, N_Vector vt3);
 int idaLsSolve(IDAMem IDA_mem, N_Vector b, N_Vector weight, N_Vector ycur,
                N_Vector ypcur, N_Vector rescur);
+int idaLsSolveMulti(IDAMem IDA_mem, int nrhs, N_Vector* b, N_Vector* weight,
+                    N_Vector ycur, N_Vector ypcur, N_Vector rescur);
 int idaLsPerf(IDAMem IDA_mem, int perftask);
 int idaLsFree(IDAMem IDA_mem);
 
@@ -326,6 +326,21 @@ static int idaNlsLSolveSensSim(N_Vector deltaSim, void* ida_mem)
   }
   IDA_mem = (IDAMem)ida_mem;
 
+  /* solve the state and sensitivity linear systems together if possible */
+  if (IDA_mem->ida_lsolvemulti)
+  {
+    retval = IDA_mem->ida_lsolvemulti(IDA_mem, IDA_mem->ida_Ns + 1,
+                                      NV_VECS_SW(deltaSim),
+                                      NV_VECS_SW(IDA_mem->ewtSim),
+                                      IDA_mem->ida_yy, IDA_mem->ida_yp,
+                                      IDA_mem->ida_savres);
+
+    if (retval < 0) { return (IDA_LSOLVE_FAIL); }
+    if (retval > 0) { return (IDA_LSOLVE_RECVR); }
+
+    return (IDA_SUCCESS);
+  }
+
   /* extract state update vector from the vector wrapper */
   delta = NV_VEC_SW(deltaSim, 0);
 
@@ -278,6 +278,20 @@ static int idaNlsLSolveSensStg(N_Vector deltaStg, void* ida_mem)
   }
   IDA_mem = (IDAMem)ida_mem;
 
+  /* solve the sensitivity linear systems together if possible */
+  if (IDA_mem->ida_lsolvemulti)
+  {
+    retval = IDA_mem->ida_lsolvemulti(IDA_mem, IDA_mem->ida_Ns,
+                                      NV_VECS_SW(deltaStg), IDA_mem->ida_ewtS,
+                                      IDA_mem->ida_yy, IDA_mem->ida_yp,
+                                      IDA_mem->ida_delta);
+
+    if (retval < 0) { return (IDA_LSOLVE_FAIL); }
+    if (retval > 0) { return (IDA_LSOLVE_RECVR); }
+
+    return (IDA_SUCCESS);
+  }
+
   for (is = 0; is < IDA_mem->ida_Ns; is++)
   {
     retval = IDA_mem->ida_lsolve(IDA_mem, NV_VEC_SW(deltaStg, is),
@@ -69,6 +69,7 @@
 #include <sundials/sundials_math.h>
 
 #include "kinsol_impl.h"
+#include "kinsol_ls_impl.h"
 #include "sundials/priv/sundials_errors_impl.h"
 
 /*
@@ -185,6 +186,9 @@ static int KINStop(KINMem kin_mem, sunbooleantype maxStepTaken, int sflag);
 static int AndersonAcc(KINMem kin_mem, N_Vector gval, N_Vector fv, N_Vector x,
                        N_Vector x_old, long int iter, sunrealtype* R,
                        sunrealtype* gamma);
+static void KINStepTraceCounters(KINMem kin_mem, long int counters[]);
+static void KINStepTraceRecord(KINMem kin_mem, SUNStepTrace trace, int ret,
+                               sunrealtype stepl, const long int start[]);
 
 /*
  * =================================================================
@@ -232,6 +236,8 @@ void* KINCreate(SUNContext sunctx)
   memset(kin_mem, 0, sizeof(struct KINMemRec));
 
   kin_mem->kin_sunctx = sunctx;
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                     sizeof(struct KINMemRec));
 
   /* set uround (unit roundoff) */
 
@@ -377,6 +383,8 @@ int KINInit(void* kinmem, KINSysFn func, N_Vector tmpl)
   {
     KINProcessError(kin_mem, KIN_MEM_FAIL, __LINE__, __func__, __FILE__,
                     MSG_MEM_FAIL);
+    sunMemAccountFree(kin_mem->kin_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                      sizeof(struct KINMemRec));
     free(kin_mem);
     kin_mem = NULL;
     SUNDIALS_MARK_FUNCTION_END(KIN_PROFILER);
@@ -479,6 +487,8 @@ int KINSol(void* kinmem, N_Vector u, int strategy_in, N_Vector u_scale,
   KINMem kin_mem;
   int ret, sflag;
   sunbooleantype maxStepTaken;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   /* initialize to avoid compiler warning messages */
 
@@ -620,6 +630,9 @@ int KINSol(void* kinmem, N_Vector u, int strategy_in, N_Vector u_scale,
   {
     kin_mem->kin_retry_nni = SUNFALSE;
 
+    trace = KIN_STEPTRACE;
+    if (trace) { KINStepTraceCounters(kin_mem, trace_start); }
+
     kin_mem->kin_nni++;
 
     /* calculate the epsilon (stopping criteria for iterative linear solver)
@@ -713,6 +726,11 @@ int KINSol(void* kinmem, N_Vector u, int strategy_in, N_Vector u_scale,
                  kin_mem->kin_nni, kin_mem->kin_nfe, kin_mem->kin_fnorm);
 #endif
 
+    if (trace)
+    {
+      KINStepTraceRecord(kin_mem, trace, ret, kin_mem->kin_stepl, trace_start);
+    }
+
     if (ret != CONTINUE_ITERATIONS) { break; }
 
   } /* end of loop; return */
@@ -793,6 +811,8 @@ void KINFree(void** kinmem)
 
   if (kin_mem->kin_lfree != NULL) { kin_mem->kin_lfree(kin_mem); }
 
+  sunMemAccountFree(kin_mem->kin_sunctx, SUN_MEMSUBSYSTEM_INTEGRATOR,
+                    sizeof(struct KINMemRec));
   free(*kinmem);
   *kinmem = NULL;
 }
@@ -2551,6 +2571,71 @@ void KINPrintInfo(SUNDIALS_MAYBE_UNUSED KINMem kin_mem, int info_code,
   return;
 }
 
+/*
+ * =================================================================
+ * KINSOL step trace functions
+ * =================================================================
+ */
+
+/*
+ * KINStepTraceCounters
+ *
+ * Samples the cumulative solver and linear solver counters that are
+ * differenced to form a step trace record.
+ */
+
+static void KINStepTraceCounters(KINMem kin_mem, long int counters[])
+{
+  KINLsMem kinls_mem = NULL;
+
+  counters[SUN_STEPTRACE_NETF]    = 0;
+  counters[SUN_STEPTRACE_NCFN]    = 0;
+  counters[SUN_STEPTRACE_NNI]     = kin_mem->kin_nni;
+  counters[SUN_STEPTRACE_NSETUPS] = 0;
+  counters[SUN_STEPTRACE_NLI]     = 0;
+  counters[SUN_STEPTRACE_NJEVALS] = 0;
+
+  if (kin_mem->kin_lmem)
+  {
+    kinls_mem                       = (KINLsMem)kin_mem->kin_lmem;
+    counters[SUN_STEPTRACE_NLI]     = kinls_mem->nli;
+    counters[SUN_STEPTRACE_NJEVALS] = kinls_mem->nje;
+  }
+}
+
+/*
+ * KINStepTraceRecord
+ *
+ * Writes a record for the nonlinear iteration just completed to trace,
+ * the step trace that was attached to the SUNContext when the counters
+ * in start were sampled. The time and step size
+ * fields hold the scaled norm of the system function and the scaled
+ * length of the step (zero for the fixed point iterations).
+ */
+
+static void KINStepTraceRecord(KINMem kin_mem, SUNStepTrace trace, int ret,
+                               sunrealtype stepl, const long int start[])
+{
+  SUNStepTraceRecord record;
+  long int end[SUN_STEPTRACE_NCOUNTERS];
+
+  KINStepTraceCounters(kin_mem, end);
+  sunStepTraceInitRecord(&record, SUN_STEPTRACE_KINSOL, start, end);
+
+  record.t    = (double)kin_mem->kin_fnorm;
+  record.h    = (double)stepl;
+  record.step = kin_mem->kin_nni;
+  record.flag = ret;
+
+  /* KINSOL does not count setups, lsetup sets nnilset to the current nni */
+  if (kin_mem->kin_lsetup && kin_mem->kin_nnilset == kin_mem->kin_nni)
+  {
+    record.nsetups = 1;
+  }
+
+  (void)SUNStepTrace_Record(trace, &record);
+}
+
 /*
  * =================================================================
  * KINSOL Error Handling functions
@@ -2628,6 +2713,8 @@ static int KINPicardAA(KINMem kin_mem)
   N_Vector delta;   /* temporary workspace vector  */
   sunrealtype epsmin;
   sunrealtype fnormp;
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   delta  = kin_mem->kin_vtemp1;
   ret    = CONTINUE_ITERATIONS;
@@ -2645,6 +2732,9 @@ static int KINPicardAA(KINMem kin_mem)
 
   while (ret == CONTINUE_ITERATIONS)
   {
+    trace = KIN_STEPTRACE;
+    if (trace) { KINStepTraceCounters(kin_mem, trace_start); }
+
     /* update iteration count */
     kin_mem->kin_nni++;
 
@@ -2746,6 +2836,11 @@ static int KINPicardAA(KINMem kin_mem)
       KINForcingTerm(kin_mem, fnormp);
     }
 
+    if (trace)
+    {
+      KINStepTraceRecord(kin_mem, trace, ret, ZERO, trace_start);
+    }
+
   } /* end of loop; return */
 #if SUNDIALS_LOGGING_LEVEL >= SUNDIALS_LOGLEVEL_INFO
   KINPrintInfo(kin_mem, PRNT_RETVAL, "KINSOL", __func__, INFO_RETVAL, ret);
@@ -2831,6 +2926,8 @@ static int KINFP(KINMem kin_mem)
   long int iter_aa;   /* iteration count for AA      */
   sunrealtype tolfac; /* tolerance adjustment factor */
   N_Vector delta;     /* temporary workspace vector  */
+  long int trace_start[SUN_STEPTRACE_NCOUNTERS] = {0};
+  SUNStepTrace trace;
 
   delta  = kin_mem->kin_vtemp1;
   ret    = CONTINUE_ITERATIONS;
@@ -2843,6 +2940,9 @@ static int KINFP(KINMem kin_mem)
 
   while (ret == CONTINUE_ITERATIONS)
   {
+    trace = KIN_STEPTRACE;
+    if (trace) { KINStepTraceCounters(kin_mem, trace_start); }
+
     /* update iteration count */
     kin_mem->kin_nni++;
 
@@ -2938,6 +3038,11 @@ static int KINFP(KINMem kin_mem)
       N_VScale(ONE, kin_mem->kin_unew, kin_mem->kin_uu);
     }
 
+    if (trace)
+    {
+      KINStepTraceRecord(kin_mem, trace, ret, ZERO, trace_start);
+    }
+
   } /* end of loop; return */
 
 #if SUNDIALS_LOGGING_LEVEL >= SUNDIALS_LOGLEVEL_INFO
@@ -28,6 +28,7 @@
 #include "sundials_iterative_impl.h"
 #include "sundials_logger_impl.h"
 #include "sundials_macros.h"
+#include "sundials_steptrace_impl.h"
 
 #ifdef __cplusplus /* wrapper to enable C++ usage */
 extern "C" {
@@ -61,8 +62,9 @@ extern "C" {
 /* Shortcuts                                                       */
 /*=================================================================*/
 
-#define KIN_PROFILER kin_mem->kin_sunctx->profiler
-#define KIN_LOGGER   kin_mem->kin_sunctx->logger
+#define KIN_PROFILER  kin_mem->kin_sunctx->profiler
+#define KIN_LOGGER    kin_mem->kin_sunctx->logger
+#define KIN_STEPTRACE kin_mem->kin_sunctx->steptrace
 
 /*
  * -----------------------------------------------------------------
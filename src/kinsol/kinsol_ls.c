@@ -16,6 +16,7 @@
  *-----------------------------------------------------------------*/
 
 #include <stdarg.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -264,6 +265,35 @@ int KINSetJacFn(void* kinmem, KINLsJacFn jac)
   return (KINLS_SUCCESS);
 }
 
+/*------------------------------------------------------------------
+  KINSetBatchSysFn specifies a function evaluating the system
+  function at several points in one call. When set, it is used by
+  the internal dense and band DQ Jacobian approximations with at
+  most max_batch points per call (KINLS_MAX_BATCH if max_batch = 0,
+  all columns or column groups at once if max_batch < 0).
+  ------------------------------------------------------------------*/
+int KINSetBatchSysFn(void* kinmem, KINLsBatchSysFn fb, int max_batch)
+{
+  KINMem kin_mem;
+  KINLsMem kinls_mem;
+  int retval;
+
+  /* access KINLsMem structure */
+  retval = kinLs_AccessLMem(kinmem, __func__, &kin_mem, &kinls_mem);
+  if (retval != KIN_SUCCESS) { return (retval); }
+
+  /* release batch vectors sized for a previous setting */
+  kinLsBatchFree(kinls_mem);
+
+  kinls_mem->fbatch    = fb;
+  /* max_batch = 0 selects the default bound, max_batch < 0 all columns */
+  if (max_batch == 0) { kinls_mem->max_batch = KINLS_MAX_BATCH; }
+  else if (max_batch < 0) { kinls_mem->max_batch = INT_MAX; }
+  else { kinls_mem->max_batch = max_batch; }
+
+  return (KINLS_SUCCESS);
+}
+
 /*------------------------------------------------------------------
   KINSetPreconditioner sets the preconditioner setup and solve
   functions
@@ -786,6 +816,12 @@ int kinLsDenseDQJac(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem,
   /* access LsMem interface structure */
   kinls_mem = (KINLsMem)kin_mem->kin_lmem;
 
+  /* evaluate all perturbed points with the batched function if provided */
+  if (kinls_mem->fbatch)
+  {
+    return (kinLsDenseDQJacBatch(u, fu, Jac, kin_mem, tmp1));
+  }
+
   /* access matrix dimension */
   N = SUNDenseMatrix_Columns(Jac);
 
@@ -864,6 +900,12 @@ int kinLsBandDQJac(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem,
   /* access LsMem interface structure */
   kinls_mem = (KINLsMem)kin_mem->kin_lmem;
 
+  /* evaluate all column groups with the batched function if provided */
+  if (kinls_mem->fbatch)
+  {
+    return (kinLsBandDQJacBatch(u, fu, Jac, kin_mem));
+  }
+
   /* access matrix dimensions */
   N      = SUNBandMatrix_Columns(Jac);
   mupper = SUNBandMatrix_UpperBandwidth(Jac);
@@ -925,6 +967,224 @@ int kinLsBandDQJac(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem,
   return (0);
 }
 
+/*------------------------------------------------------------------
+  kinLsDenseDQJacBatch
+
+  This routine generates a dense difference quotient approximation
+  to the Jacobian of F(u) using the batched system function. The
+  perturbed points u + sigma_j e_j for up to max_batch columns are
+  evaluated in one call and the columns of J are then formed with
+  the increments used in kinLsDenseDQJac.
+  ------------------------------------------------------------------*/
+int kinLsDenseDQJacBatch(N_Vector u, N_Vector fu, SUNMatrix Jac,
+                         KINMem kin_mem, N_Vector tmp1)
+{
+  sunrealtype inc, inc_inv, ujscale, sign;
+  sunrealtype *u_data, *uscale_data;
+  N_Vector jthCol;
+  sunindextype j, j0, N;
+  int k, nb, nstates;
+  KINLsMem kinls_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  kinls_mem = (KINLsMem)kin_mem->kin_lmem;
+
+  /* access matrix dimension */
+  N = SUNDenseMatrix_Columns(Jac);
+
+  /* number of points per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (kinls_mem->max_batch < N) ? kinls_mem->max_batch : (int)N;
+  if (kinLsBatchAlloc(kinls_mem, u, nb))
+  {
+    KINProcessError(kin_mem, KINLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (KINLS_MEM_FAIL);
+  }
+
+  /* Create an empty vector for matrix column calculations */
+  jthCol = N_VCloneEmpty(tmp1);
+
+  /* Obtain pointers to the data for u and uscale */
+  u_data      = N_VGetArrayPointer(u);
+  uscale_data = N_VGetArrayPointer(kin_mem->kin_uscale);
+
+  for (j0 = 0; j0 < N; j0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, N - j0);
+
+    /* Load the perturbed points */
+    for (k = 0; k < nstates; k++)
+    {
+      j       = j0 + k;
+      ujscale = ONE / uscale_data[j];
+      sign    = (u_data[j] >= ZERO) ? ONE : -ONE;
+      inc = kin_mem->kin_sqrt_relfunc * SUNMAX(SUNRabs(u_data[j]), ujscale) *
+            sign;
+      N_VScale(ONE, u, kinls_mem->ubatch[k]);
+      N_VGetArrayPointer(kinls_mem->ubatch[k])[j] += inc;
+    }
+
+    retval = kinls_mem->fbatch(nstates, kinls_mem->ubatch, kinls_mem->fbatchv,
+                               kin_mem->kin_user_data);
+    kinls_mem->nfeDQ += nstates;
+    if (retval != 0) { break; }
+
+    /* Construct the difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      j       = j0 + k;
+      ujscale = ONE / uscale_data[j];
+      sign    = (u_data[j] >= ZERO) ? ONE : -ONE;
+      inc = kin_mem->kin_sqrt_relfunc * SUNMAX(SUNRabs(u_data[j]), ujscale) *
+            sign;
+      inc_inv = ONE / inc;
+      N_VSetArrayPointer(SUNDenseMatrix_Column(Jac, j), jthCol);
+      N_VLinearSum(inc_inv, kinls_mem->fbatchv[k], -inc_inv, fu, jthCol);
+    }
+  }
+
+  /* Destroy jthCol vector */
+  N_VSetArrayPointer(NULL, jthCol);
+  N_VDestroy(jthCol);
+
+  return (retval);
+}
+
+/*------------------------------------------------------------------
+  kinLsBandDQJacBatch
+
+  This routine generates a banded difference quotient approximation
+  to the Jacobian of F(u) using the batched system function. The
+  perturbed points for up to max_batch column groups are evaluated
+  in one call and the columns of J are then formed as in
+  kinLsBandDQJac.
+  ------------------------------------------------------------------*/
+int kinLsBandDQJacBatch(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem)
+{
+  sunrealtype inc, inc_inv;
+  sunindextype group, g0, i, j, width, ngroups, i1, i2;
+  sunindextype N, mupper, mlower;
+  sunrealtype *col_j, *fu_data, *futemp_data, *u_data, *utemp_data, *uscale_data;
+  int k, nb, nstates;
+  KINLsMem kinls_mem;
+  int retval = 0;
+
+  /* access LsMem interface structure */
+  kinls_mem = (KINLsMem)kin_mem->kin_lmem;
+
+  /* access matrix dimensions */
+  N      = SUNBandMatrix_Columns(Jac);
+  mupper = SUNBandMatrix_UpperBandwidth(Jac);
+  mlower = SUNBandMatrix_LowerBandwidth(Jac);
+
+  /* Set bandwidth and number of column groups for band differencing */
+  width   = mlower + mupper + 1;
+  ngroups = SUNMIN(width, N);
+
+  /* number of points per call and batch workspace (max_batch <= INT_MAX,
+     so the count fits in an int) */
+  nb = (kinls_mem->max_batch < ngroups) ? kinls_mem->max_batch : (int)ngroups;
+  if (kinLsBatchAlloc(kinls_mem, u, nb))
+  {
+    KINProcessError(kin_mem, KINLS_MEM_FAIL, __LINE__, __func__, __FILE__,
+                    MSG_LS_MEM_FAIL);
+    return (KINLS_MEM_FAIL);
+  }
+
+  /* Obtain pointers to the data for fu, u, and uscale */
+  fu_data     = N_VGetArrayPointer(fu);
+  u_data      = N_VGetArrayPointer(u);
+  uscale_data = N_VGetArrayPointer(kin_mem->kin_uscale);
+
+  for (g0 = 0; g0 < ngroups; g0 += nb)
+  {
+    nstates = (int)SUNMIN(nb, ngroups - g0);
+
+    /* Load the points with all u components in each group incremented */
+    for (k = 0; k < nstates; k++)
+    {
+      group = g0 + k;
+      N_VScale(ONE, u, kinls_mem->ubatch[k]);
+      utemp_data = N_VGetArrayPointer(kinls_mem->ubatch[k]);
+      for (j = group; j < N; j += width)
+      {
+        inc = kin_mem->kin_sqrt_relfunc *
+              SUNMAX(SUNRabs(u_data[j]), ONE / SUNRabs(uscale_data[j]));
+        utemp_data[j] += inc;
+      }
+    }
+
+    retval = kinls_mem->fbatch(nstates, kinls_mem->ubatch, kinls_mem->fbatchv,
+                               kin_mem->kin_user_data);
+    kinls_mem->nfeDQ += nstates;
+    if (retval != 0) { return (retval); }
+
+    /* Form and load difference quotients */
+    for (k = 0; k < nstates; k++)
+    {
+      group       = g0 + k;
+      futemp_data = N_VGetArrayPointer(kinls_mem->fbatchv[k]);
+      for (j = group; j < N; j += width)
+      {
+        col_j = SUNBandMatrix_Column(Jac, j);
+        inc   = kin_mem->kin_sqrt_relfunc *
+              SUNMAX(SUNRabs(u_data[j]), ONE / SUNRabs(uscale_data[j]));
+        inc_inv = ONE / inc;
+        i1      = SUNMAX(0, j - mupper);
+        i2      = SUNMIN(j + mlower, N - 1);
+        for (i = i1; i <= i2; i++)
+        {
+          SM_COLUMN_ELEMENT_B(col_j, i, j) = inc_inv *
+                                             (futemp_data[i] - fu_data[i]);
+        }
+      }
+    }
+  }
+
+  return (0);
+}
+
+/*------------------------------------------------------------------
+  kinLsBatchAlloc and kinLsBatchFree
+
+  These routines allocate (at least nvecs) and free the vectors
+  passed to the batched system function.
+  ------------------------------------------------------------------*/
+int kinLsBatchAlloc(KINLsMem kinls_mem, N_Vector tmpl, int nvecs)
+{
+  if (kinls_mem->nbatch >= nvecs) { return (0); }
+
+  kinLsBatchFree(kinls_mem);
+
+  kinls_mem->ubatch  = N_VCloneVectorArray(nvecs, tmpl);
+  kinls_mem->fbatchv = N_VCloneVectorArray(nvecs, tmpl);
+  if (kinls_mem->ubatch == NULL || kinls_mem->fbatchv == NULL)
+  {
+    kinLsBatchFree(kinls_mem);
+    return (-1);
+  }
+  kinls_mem->nbatch = nvecs;
+
+  return (0);
+}
+
+void kinLsBatchFree(KINLsMem kinls_mem)
+{
+  if (kinls_mem->ubatch)
+  {
+    N_VDestroyVectorArray(kinls_mem->ubatch, kinls_mem->nbatch);
+  }
+  if (kinls_mem->fbatchv)
+  {
+    N_VDestroyVectorArray(kinls_mem->fbatchv, kinls_mem->nbatch);
+  }
+  kinls_mem->ubatch  = NULL;
+  kinls_mem->fbatchv = NULL;
+  kinls_mem->nbatch  = 0;
+}
+
 /*------------------------------------------------------------------
   kinLsDQJtimes
 
@@ -1357,6 +1617,9 @@ int kinLsFree(KINMem kin_mem)
   if (kin_mem->kin_lmem == NULL) { return (KINLS_SUCCESS); }
   kinls_mem = (KINLsMem)kin_mem->kin_lmem;
 
+  /* Free batched system function vectors */
+  kinLsBatchFree(kinls_mem);
+
   /* Nullify SUNMatrix pointer */
   kinls_mem->J = NULL;
 
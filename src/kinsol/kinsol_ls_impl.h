@@ -26,6 +26,12 @@
 extern "C" {
 #endif
 
+/*------------------------------------------------------------------
+  KINLS_MAX_BATCH  default maximum number of points passed to the
+                 batched function in one call
+  ------------------------------------------------------------------*/
+#define KINLS_MAX_BATCH 32
+
 /*------------------------------------------------------------------
   keys for KINPrintInfo (do not use 1 -> conflict with PRNT_RETVAL)
   ------------------------------------------------------------------*/
@@ -50,6 +56,13 @@ typedef struct KINLsMemRec
   KINLsJacFn jac;       /* Jacobian routine to be called                 */
   void* J_data;         /* J_data is passed to jac                       */
 
+  /* Batched system function used by the DQ Jacobian approximations */
+  KINLsBatchSysFn fbatch;
+  int max_batch;     /* max states per call, INT_MAX for all columns   */
+  int nbatch;        /* number of allocated batch vectors              */
+  N_Vector* ubatch;  /* perturbed u values                             */
+  N_Vector* fbatchv; /* system function values at the perturbed u      */
+
   /* Linear solver, matrix and vector objects/pointers */
   SUNLinearSolver LS; /* generic iterative linear solver object        */
   SUNMatrix J;        /* problem Jacobian                              */
@@ -122,6 +135,11 @@ int kinLsDenseDQJac(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem,
 
 int kinLsBandDQJac(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem,
                    N_Vector tmp1, N_Vector tmp2);
+int kinLsDenseDQJacBatch(N_Vector u, N_Vector fu, SUNMatrix Jac,
+                         KINMem kin_mem, N_Vector tmp1);
+int kinLsBandDQJacBatch(N_Vector u, N_Vector fu, SUNMatrix Jac, KINMem kin_mem);
+int kinLsBatchAlloc(KINLsMem kinls_mem, N_Vector tmpl, int nvecs);
+void kinLsBatchFree(KINLsMem kinls_mem);
 
 /* Generic linit/lsetup/lsolve/lfree interface routines for KINSOL to call */
 int kinLsInitialize(KINMem kin_mem);
@@ -170,6 +170,7 @@ N_Vector N_VNewEmpty_OpenMP(sunindextype length, int num_threads,
   content = NULL;
   content = (N_VectorContent_OpenMP)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -205,6 +206,8 @@ N_Vector N_VNew_OpenMP(sunindextype length, int num_threads, SUNContext sunctx)
   {
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
 
     /* Attach data */
     NV_OWN_DATA_OMP(v) = SUNTRUE;
@@ -309,6 +312,7 @@ N_Vector N_VCloneEmpty_OpenMP(N_Vector w)
   content = NULL;
   content = (N_VectorContent_OpenMP)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -345,6 +349,8 @@ N_Vector N_VClone_OpenMP(N_Vector w)
   {
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
   }
 
   /* Attach data */
@@ -368,9 +374,13 @@ void N_VDestroy_OpenMP(N_Vector v)
     /* free data array if it's owned by the vector */
     if (NV_OWN_DATA_OMP(v) && NV_DATA_OMP(v) != NULL)
     {
+      sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                        NV_LENGTH_OMP(v) * sizeof(sunrealtype));
       free(NV_DATA_OMP(v));
       NV_DATA_OMP(v) = NULL;
     }
+    sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                      sizeof(struct _N_VectorContent_OpenMP));
     free(v->content);
     v->content = NULL;
   }
@@ -241,6 +241,7 @@ N_Vector N_VNewEmpty_Pthreads(sunindextype length, int num_threads,
   content = NULL;
   content = (N_VectorContent_Pthreads)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -278,6 +279,8 @@ N_Vector N_VNew_Pthreads(sunindextype length, int num_threads, SUNContext sunctx
     data = NULL;
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
 
     /* Attach data */
     NV_OWN_DATA_PT(v) = SUNTRUE;
@@ -383,6 +386,7 @@ N_Vector N_VCloneEmpty_Pthreads(N_Vector w)
   content = NULL;
   content = (N_VectorContent_Pthreads)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -421,6 +425,8 @@ N_Vector N_VClone_Pthreads(N_Vector w)
     data = NULL;
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
 
     /* Attach data */
     NV_OWN_DATA_PT(v) = SUNTRUE;
@@ -443,9 +449,13 @@ void N_VDestroy_Pthreads(N_Vector v)
   {
     if (NV_OWN_DATA_PT(v) && NV_DATA_PT(v) != NULL)
     {
+      sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                        NV_LENGTH_PT(v) * sizeof(sunrealtype));
       free(NV_DATA_PT(v));
       NV_DATA_PT(v) = NULL;
     }
+    sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                      sizeof(struct _N_VectorContent_Pthreads));
     free(v->content);
     v->content = NULL;
   }
@@ -150,6 +150,7 @@ N_Vector N_VNewEmpty_Serial(sunindextype length, SUNContext sunctx)
   content = NULL;
   content = (N_VectorContent_Serial)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -184,6 +185,8 @@ N_Vector N_VNew_Serial(sunindextype length, SUNContext sunctx)
   {
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
   }
 
   /* Attach data */
@@ -297,6 +300,7 @@ N_Vector N_VCloneEmpty_Serial(N_Vector w)
   content = NULL;
   content = (N_VectorContent_Serial)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, sizeof *content);
 
   /* Attach content */
   v->content = content;
@@ -328,6 +332,8 @@ N_Vector N_VClone_Serial(N_Vector w)
   {
     data = (sunrealtype*)malloc(length * sizeof(sunrealtype));
     SUNAssertNull(data, SUN_ERR_MALLOC_FAIL);
+    sunMemAccountAlloc(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                       length * sizeof(sunrealtype));
 
     /* Attach data */
     NV_OWN_DATA_S(v) = SUNTRUE;
@@ -347,9 +353,13 @@ void N_VDestroy_Serial(N_Vector v)
     /* free data array if it's owned by the vector */
     if (NV_OWN_DATA_S(v) && NV_DATA_S(v) != NULL)
     {
+      sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                        NV_LENGTH_S(v) * sizeof(sunrealtype));
       free(NV_DATA_S(v));
       NV_DATA_S(v) = NULL;
     }
+    sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR,
+                      sizeof(struct _N_VectorContent_Serial));
     free(v->content);
     v->content = NULL;
   }
@@ -215,6 +215,50 @@ void SUNDlsMat_bandGBTRS(sunrealtype** a, sunindextype n, sunindextype smu,
   }
 }
 
+void SUNDlsMat_bandGBTRSMulti(sunrealtype** a, sunindextype n, sunindextype smu,
+                              sunindextype ml, sunindextype* p, int nrhs,
+                              sunrealtype** b)
+{
+  sunindextype k, l, i, first_row_k, last_row_k;
+  sunrealtype mult, *diag_k, *b_j;
+  int j;
+
+  /* Solve Ly = Pb, applying each column of L to all right-hand sides */
+
+  for (k = 0; k < n - 1; k++)
+  {
+    l          = p[k];
+    diag_k     = a[k] + smu;
+    last_row_k = SUNMIN(n - 1, k + ml);
+    for (j = 0; j < nrhs; j++)
+    {
+      b_j  = b[j];
+      mult = b_j[l];
+      if (l != k)
+      {
+        b_j[l] = b_j[k];
+        b_j[k] = mult;
+      }
+      for (i = k + 1; i <= last_row_k; i++) { b_j[i] += mult * diag_k[i - k]; }
+    }
+  }
+
+  /* Solve Ux = y, applying each column of U to all right-hand sides */
+
+  for (k = n - 1; k >= 0; k--)
+  {
+    diag_k      = a[k] + smu;
+    first_row_k = SUNMAX(0, k - smu);
+    for (j = 0; j < nrhs; j++)
+    {
+      b_j = b[j];
+      b_j[k] /= (*diag_k);
+      mult = -b_j[k];
+      for (i = first_row_k; i <= k - 1; i++) { b_j[i] += mult * diag_k[i - k]; }
+    }
+  }
+}
+
 void SUNDlsMat_bandCopy(sunrealtype** a, sunrealtype** b, sunindextype n,
                         sunindextype a_smu, sunindextype b_smu,
                         sunindextype copymu, sunindextype copyml)
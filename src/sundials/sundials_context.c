@@ -24,6 +24,7 @@
 #include <sundials/sundials_context.h>
 #include <sundials/sundials_errors.h>
 #include <sundials/sundials_logger.h>
+#include <sundials/sundials_nvector.h>
 #include <sundials/sundials_profiler.h>
 #include <sundials/sundials_types.h>
 
@@ -91,13 +92,21 @@ SUNErrCode SUNContext_Create(SUNComm comm, SUNContext* sunctx_out)
     SUNCheckCallNoRet(err);
     if (err) { break; }
 
-    sunctx->logger       = logger;
-    sunctx->own_logger   = logger != NULL;
-    sunctx->profiler     = profiler;
-    sunctx->own_profiler = profiler != NULL;
-    sunctx->last_err     = SUN_SUCCESS;
-    sunctx->err_handler  = eh;
-    sunctx->comm         = comm;
+    sunctx->logger           = logger;
+    sunctx->own_logger       = logger != NULL;
+    sunctx->steptrace        = NULL;
+    sunctx->scratch          = NULL;
+    sunctx->scratch_in_use   = NULL;
+    sunctx->nscratch         = 0;
+    sunctx->scratch_capacity = 0;
+    sunctx->scratch_sharing  = SUNFALSE;
+    sunctx->profiler         = profiler;
+    sunctx->own_profiler     = profiler != NULL;
+    sunctx->last_err         = SUN_SUCCESS;
+    sunctx->err_handler      = eh;
+    sunctx->comm             = comm;
+    memset(sunctx->mem_current, 0, sizeof(sunctx->mem_current));
+    memset(sunctx->mem_peak, 0, sizeof(sunctx->mem_peak));
   }
   while (0);
 
@@ -250,6 +259,185 @@ SUNErrCode SUNContext_SetLogger(SUNContext sunctx, SUNLogger logger)
   return SUN_SUCCESS;
 }
 
+SUNErrCode SUNContext_GetStepTrace(SUNContext sunctx, SUNStepTrace* trace)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  /* get step trace */
+  *trace = sunctx->steptrace;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_SetStepTrace(SUNContext sunctx, SUNStepTrace trace)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  /* set step trace (NULL disables tracing), the trace is owned by the user */
+  sunctx->steptrace = trace;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_SetScratchSharing(SUNContext sunctx,
+                                        sunbooleantype onoff)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  /* objects created after this call borrow their scratch vectors from the
+     context rather than allocating their own */
+  sunctx->scratch_sharing = onoff;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_GetScratchSharing(SUNContext sunctx, sunbooleantype* onoff)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  *onoff = sunctx->scratch_sharing;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_GetScratchSpace(SUNContext sunctx, long int* nvectors,
+                                      long int* lenrw, long int* leniw)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  sunindextype lrw1, liw1;
+  int i;
+
+  *nvectors = sunctx->nscratch;
+  *lenrw    = 0;
+  *leniw    = 0;
+
+  for (i = 0; i < sunctx->nscratch; i++)
+  {
+    if (sunctx->scratch[i]->ops->nvspace)
+    {
+      N_VSpace(sunctx->scratch[i], &lrw1, &liw1);
+      *lenrw += lrw1;
+      *leniw += liw1;
+    }
+  }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_FreeScratchVectors(SUNContext sunctx)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  /* destroy idle vectors and compact the borrowed ones */
+  int i, n = 0;
+  for (i = 0; i < sunctx->nscratch; i++)
+  {
+    if (sunctx->scratch_in_use[i])
+    {
+      sunctx->scratch[n]        = sunctx->scratch[i];
+      sunctx->scratch_in_use[n] = SUNTRUE;
+      n++;
+    }
+    else { N_VDestroy(sunctx->scratch[i]); }
+  }
+  sunctx->nscratch = n;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_GetMemoryUsage(SUNContext sunctx,
+                                     SUNMemorySubsystem subsystem,
+                                     size_t* current, size_t* peak)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  if (subsystem < SUN_MEMSUBSYSTEM_NVECTOR || subsystem > SUN_MEMSUBSYSTEM_TOTAL)
+  {
+    return SUN_ERR_ARG_OUTOFRANGE;
+  }
+
+  if (current) { *current = sunctx->mem_current[subsystem]; }
+  if (peak) { *peak = sunctx->mem_peak[subsystem]; }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNContext_ResetMemoryPeaks(SUNContext sunctx)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  for (int i = 0; i <= SUN_MEMSUBSYSTEM_TOTAL; i++)
+  {
+    sunctx->mem_peak[i] = sunctx->mem_current[i];
+  }
+
+  return SUN_SUCCESS;
+}
+
+void sunMemAccountMismatch(SUNContext sunctx, SUNMemorySubsystem subsystem,
+                           size_t bytes)
+{
+  SUNLogger_QueueMsg(sunctx->logger, SUN_LOGLEVEL_WARNING, __func__,
+                     "mem-account",
+                     "releasing %lu bytes of subsystem %d with only %lu "
+                     "bytes recorded",
+                     (unsigned long)bytes, (int)subsystem,
+                     (unsigned long)sunctx->mem_current[subsystem]);
+}
+
+SUNErrCode SUNContext_PrintMemoryUsage(SUNContext sunctx, FILE* outfile,
+                                       SUNOutputFormat fmt)
+{
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+
+  SUNFunctionBegin(sunctx);
+
+  static const char* names[] = {"N_Vector",        "SUNMatrix",
+                                "SUNLinearSolver", "SUNNonlinearSolver",
+                                "Integrator",      "Total"};
+
+  switch (fmt)
+  {
+  case SUN_OUTPUTFORMAT_TABLE:
+    fprintf(outfile, "%-20s %16s %16s\n", "Subsystem", "Current bytes",
+            "Peak bytes");
+    for (int i = 0; i <= SUN_MEMSUBSYSTEM_TOTAL; i++)
+    {
+      fprintf(outfile, "%-20s %16lu %16lu\n", names[i],
+              (unsigned long)sunctx->mem_current[i],
+              (unsigned long)sunctx->mem_peak[i]);
+    }
+    break;
+  case SUN_OUTPUTFORMAT_CSV:
+    for (int i = 0; i <= SUN_MEMSUBSYSTEM_TOTAL; i++)
+    {
+      fprintf(outfile, "%s%s current bytes,%lu,%s peak bytes,%lu",
+              i ? "," : "", names[i], (unsigned long)sunctx->mem_current[i],
+              names[i], (unsigned long)sunctx->mem_peak[i]);
+    }
+    fprintf(outfile, "\n");
+    break;
+  default: return SUN_ERR_ARG_OUTOFRANGE;
+  }
+
+  return SUN_SUCCESS;
+}
+
 SUNErrCode SUNContext_Free(SUNContext* sunctx)
 {
 #ifdef SUNDIALS_ADIAK_ENABLED
@@ -258,6 +446,14 @@ SUNErrCode SUNContext_Free(SUNContext* sunctx)
 
   if (!sunctx || !(*sunctx)) { return SUN_SUCCESS; }
 
+  /* destroy the scratch vectors (all objects using them should be freed) */
+  for (int i = 0; i < (*sunctx)->nscratch; i++)
+  {
+    N_VDestroy((*sunctx)->scratch[i]);
+  }
+  free((*sunctx)->scratch);
+  free((*sunctx)->scratch_in_use);
+
 #if defined(SUNDIALS_BUILD_WITH_PROFILING) && !defined(SUNDIALS_CALIPER_ENABLED)
   /* Find out where we are printing to */
   FILE* fp                    = NULL;
@@ -182,6 +182,54 @@ void SUNDlsMat_denseGETRS(sunrealtype** a, sunindextype n, sunindextype* p,
   b[0] /= a[0][0];
 }
 
+void SUNDlsMat_denseGETRSMulti(sunrealtype** a, sunindextype n, sunindextype* p,
+                               int nrhs, sunrealtype** b)
+{
+  sunindextype i, k, pk;
+  sunrealtype *col_k, *b_j, tmp;
+  int j;
+
+  /* Permute each b, based on pivot information in p */
+  for (j = 0; j < nrhs; j++)
+  {
+    b_j = b[j];
+    for (k = 0; k < n; k++)
+    {
+      pk = p[k];
+      if (pk != k)
+      {
+        tmp     = b_j[k];
+        b_j[k]  = b_j[pk];
+        b_j[pk] = tmp;
+      }
+    }
+  }
+
+  /* Solve Ly = b, applying each column of L to all right-hand sides */
+  for (k = 0; k < n - 1; k++)
+  {
+    col_k = a[k];
+    for (j = 0; j < nrhs; j++)
+    {
+      b_j = b[j];
+      for (i = k + 1; i < n; i++) { b_j[i] -= col_k[i] * b_j[k]; }
+    }
+  }
+
+  /* Solve Ux = y, applying each column of U to all right-hand sides */
+  for (k = n - 1; k > 0; k--)
+  {
+    col_k = a[k];
+    for (j = 0; j < nrhs; j++)
+    {
+      b_j = b[j];
+      b_j[k] /= col_k[k];
+      for (i = 0; i < k; i++) { b_j[i] -= col_k[i] * b_j[k]; }
+    }
+  }
+  for (j = 0; j < nrhs; j++) { b[j][0] /= a[0][0]; }
+}
+
 /*
  * Cholesky decomposition of a symmetric positive-definite matrix
  * A = C^T*C: gaxpy version.
@@ -26,6 +26,11 @@
 #include "sundials_iterative_impl.h"
 #include "sundials_logger_impl.h"
 
+/* bytes recorded in the context memory accounting for a generic solver */
+#define LS_GENERIC_BYTES                   \
+  (sizeof(struct _generic_SUNLinearSolver) + \
+   sizeof(struct _generic_SUNLinearSolver_Ops))
+
 #if defined(SUNDIALS_BUILD_WITH_PROFILING)
 static SUNProfiler getSUNProfiler(SUNLinearSolver S)
 {
@@ -72,12 +77,16 @@ SUNLinearSolver SUNLinSolNewEmpty(SUNContext sunctx)
   ops->lastflag          = NULL;
   ops->space             = NULL;
   ops->free              = NULL;
+  ops->scratchspace      = NULL;
+  ops->solvemulti        = NULL;
 
   /* attach ops and initialize content and context to NULL */
   LS->ops     = ops;
   LS->content = NULL;
   LS->sunctx  = sunctx;
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_LINEARSOLVER, LS_GENERIC_BYTES);
+
   return (LS);
 }
 
@@ -183,6 +192,25 @@ int SUNLinSolSolve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
   return (ier);
 }
 
+int SUNLinSolSolveMulti(SUNLinearSolver S, SUNMatrix A, int nrhs, N_Vector* X,
+                        N_Vector* B, sunrealtype tol)
+{
+  int ier, i;
+  SUNDIALS_MARK_FUNCTION_BEGIN(getSUNProfiler(S));
+  if (S->ops->solvemulti) { ier = S->ops->solvemulti(S, A, nrhs, X, B, tol); }
+  else
+  {
+    /* solve the systems one after another, stopping at the first failure */
+    ier = SUN_SUCCESS;
+    for (i = 0; (i < nrhs) && (ier == SUN_SUCCESS); i++)
+    {
+      ier = S->ops->solve(S, A, X[i], B[i], tol);
+    }
+  }
+  SUNDIALS_MARK_FUNCTION_END(getSUNProfiler(S));
+  return (ier);
+}
+
 int SUNLinSolNumIters(SUNLinearSolver S)
 {
   int result;
@@ -228,10 +256,29 @@ SUNErrCode SUNLinSolSpace(SUNLinearSolver S, long int* lenrwLS, long int* leniwL
   }
 }
 
+SUNErrCode SUNLinSolScratchSpace(SUNLinearSolver S, long int* lenrwLS,
+                                 long int* leniwLS)
+{
+  if (S->ops->scratchspace)
+  {
+    return (S->ops->scratchspace(S, lenrwLS, leniwLS));
+  }
+  else
+  {
+    *lenrwLS = 0;
+    *leniwLS = 0;
+    return SUN_SUCCESS;
+  }
+}
+
 SUNErrCode SUNLinSolFree(SUNLinearSolver S)
 {
   if (S == NULL) { return SUN_SUCCESS; }
 
+  /* the generic object is accounted here so that implementations which free
+     it directly rather than through SUNLinSolFreeEmpty are handled */
+  sunMemAccountFree(S->sunctx, SUN_MEMSUBSYSTEM_LINEARSOLVER, LS_GENERIC_BYTES);
+
   /* if the free operation exists use it */
   if (S->ops)
   {
@@ -25,6 +25,10 @@
 #include "sundials/sundials_errors.h"
 #include "sundials/sundials_types.h"
 
+/* bytes recorded in the context memory accounting for a generic matrix */
+#define MAT_GENERIC_BYTES \
+  (sizeof(struct _generic_SUNMatrix) + sizeof(struct _generic_SUNMatrix_Ops))
+
 #if defined(SUNDIALS_BUILD_WITH_PROFILING)
 static SUNProfiler getSUNProfiler(SUNMatrix A) { return (A->sunctx->profiler); }
 #endif
@@ -68,6 +72,8 @@ SUNMatrix SUNMatNewEmpty(SUNContext sunctx)
   A->content = NULL;
   A->sunctx  = sunctx;
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_MATRIX, MAT_GENERIC_BYTES);
+
   return (A);
 }
 
@@ -139,6 +145,10 @@ void SUNMatDestroy(SUNMatrix A)
 {
   if (A == NULL) { return; }
 
+  /* the generic object is accounted here so that implementations which free
+     it directly rather than through SUNMatFreeEmpty are handled */
+  sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, MAT_GENERIC_BYTES);
+
   /* if the destroy operation exists use it */
   if (A->ops)
   {
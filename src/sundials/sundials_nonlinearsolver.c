@@ -24,6 +24,11 @@
 #include "sundials/sundials_errors.h"
 #include "sundials_logger_impl.h"
 
+/* bytes recorded in the context memory accounting for a generic solver */
+#define NLS_GENERIC_BYTES                     \
+  (sizeof(struct _generic_SUNNonlinearSolver) + \
+   sizeof(struct _generic_SUNNonlinearSolver_Ops))
+
 #if defined(SUNDIALS_BUILD_WITH_PROFILING)
 static SUNProfiler getSUNProfiler(SUNNonlinearSolver NLS)
 {
@@ -73,6 +78,9 @@ SUNNonlinearSolver SUNNonlinSolNewEmpty(SUNContext sunctx)
   NLS->ops     = ops;
   NLS->content = NULL;
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                     NLS_GENERIC_BYTES);
+
   return (NLS);
 }
 
@@ -136,6 +144,11 @@ SUNErrCode SUNNonlinSolFree(SUNNonlinearSolver NLS)
 {
   if (NLS == NULL) { return (SUN_SUCCESS); }
 
+  /* the generic object is accounted here so that implementations which free
+     it directly rather than through SUNNonlinSolFreeEmpty are handled */
+  sunMemAccountFree(NLS->sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                    NLS_GENERIC_BYTES);
+
   /* if the free operation exists use it */
   if (NLS->ops)
   {
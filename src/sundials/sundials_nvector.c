@@ -28,6 +28,10 @@
 #include "sundials/sundials_errors.h"
 #include "sundials/sundials_types.h"
 
+/* bytes recorded in the context memory accounting for a generic vector */
+#define NV_GENERIC_BYTES \
+  (sizeof(struct _generic_N_Vector) + sizeof(struct _generic_N_Vector_Ops))
+
 #if defined(SUNDIALS_BUILD_WITH_PROFILING)
 static inline SUNProfiler getSUNProfiler(N_Vector v)
 {
@@ -156,6 +160,8 @@ N_Vector N_VNewEmpty(SUNContext sunctx)
   v->content = NULL;
   v->sunctx  = sunctx;
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_NVECTOR, NV_GENERIC_BYTES);
+
   return v;
 }
 
@@ -304,6 +310,10 @@ void N_VDestroy(N_Vector v)
 {
   if (v == NULL) { return; }
 
+  /* the generic object is accounted here so that implementations which free
+     it directly rather than through N_VFreeEmpty are handled */
+  sunMemAccountFree(v->sunctx, SUN_MEMSUBSYSTEM_NVECTOR, NV_GENERIC_BYTES);
+
   /* if the destroy operation exists use it */
   if (v->ops->nvdestroy) { v->ops->nvdestroy(v); }
   else
@@ -1000,6 +1010,8 @@ SUNErrCode N_VBufUnpack(N_Vector x, void* buf)
  *   N_VCloneEmptyVectorArray
  *   N_VCloneVectorArray
  *   N_VDestroyVectorArray
+ *   N_VBorrowScratchVectorArray
+ *   N_VReturnScratchVectorArray
  * -----------------------------------------------------------------*/
 
 N_Vector* N_VNewVectorArray(int count, SUNContext sunctx)
@@ -1079,6 +1091,119 @@ void N_VDestroyVectorArray(N_Vector* vs, int count)
   return;
 }
 
+/* Scratch vectors are interchangeable if they have the same type, length,
+   and communicator. The layout of vectors with the same type and length is
+   assumed to match (e.g., the partitioning of a ManyVector). */
+static sunbooleantype scratchCompatible(N_Vector v, N_Vector w)
+{
+  if (v->ops->nvgetvectorid != w->ops->nvgetvectorid ||
+      v->ops->nvclone != w->ops->nvclone)
+  {
+    return SUNFALSE;
+  }
+  if (w->ops->nvgetvectorid && N_VGetVectorID(v) != N_VGetVectorID(w))
+  {
+    return SUNFALSE;
+  }
+  if (w->ops->nvgetlength && N_VGetLength(v) != N_VGetLength(w))
+  {
+    return SUNFALSE;
+  }
+  if (w->ops->nvgetlocallength && N_VGetLocalLength(v) != N_VGetLocalLength(w))
+  {
+    return SUNFALSE;
+  }
+  if (w->ops->nvgetcommunicator &&
+      N_VGetCommunicator(v) != N_VGetCommunicator(w))
+  {
+    return SUNFALSE;
+  }
+  return SUNTRUE;
+}
+
+SUNErrCode N_VBorrowScratchVectorArray(int count, N_Vector w, N_Vector* vs)
+{
+  SUNFunctionBegin(w->sunctx);
+  SUNContext sunctx = w->sunctx;
+  int i, j;
+
+  SUNAssert(count >= 0 && vs, SUN_ERR_ARG_CORRUPT);
+
+  for (j = 0; j < count; j++)
+  {
+    vs[j] = NULL;
+
+    /* look for an idle compatible vector */
+    for (i = 0; i < sunctx->nscratch; i++)
+    {
+      if (!sunctx->scratch_in_use[i] &&
+          scratchCompatible(sunctx->scratch[i], w))
+      {
+        sunctx->scratch_in_use[i] = SUNTRUE;
+        vs[j]                     = sunctx->scratch[i];
+        break;
+      }
+    }
+    if (vs[j]) { continue; }
+
+    /* grow the pool */
+    if (sunctx->nscratch == sunctx->scratch_capacity)
+    {
+      int capacity = SUNMAX(2 * sunctx->scratch_capacity, 8);
+      N_Vector* scratch =
+        (N_Vector*)realloc(sunctx->scratch, capacity * sizeof(N_Vector));
+      if (scratch) { sunctx->scratch = scratch; }
+      sunbooleantype* in_use =
+        (sunbooleantype*)realloc(sunctx->scratch_in_use,
+                                 capacity * sizeof(sunbooleantype));
+      if (in_use) { sunctx->scratch_in_use = in_use; }
+      if (!scratch || !in_use)
+      {
+        SUNCheckCall(N_VReturnScratchVectorArray(j, vs));
+        return SUN_ERR_MALLOC_FAIL;
+      }
+      sunctx->scratch_capacity = capacity;
+    }
+
+    vs[j] = N_VClone(w);
+    if (!vs[j])
+    {
+      SUNCheckCall(N_VReturnScratchVectorArray(j, vs));
+      return SUN_ERR_MEM_FAIL;
+    }
+
+    sunctx->scratch[sunctx->nscratch]        = vs[j];
+    sunctx->scratch_in_use[sunctx->nscratch] = SUNTRUE;
+    sunctx->nscratch++;
+  }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode N_VReturnScratchVectorArray(int count, N_Vector* vs)
+{
+  int i, j;
+
+  if (count < 1 || !vs) { return SUN_SUCCESS; }
+
+  SUNFunctionBegin(vs[0]->sunctx);
+  SUNContext sunctx = vs[0]->sunctx;
+
+  for (j = 0; j < count; j++)
+  {
+    for (i = 0; i < sunctx->nscratch; i++)
+    {
+      if (sunctx->scratch[i] == vs[j]) { break; }
+    }
+    SUNAssert(i < sunctx->nscratch && sunctx->scratch_in_use[i],
+              SUN_ERR_ARG_CORRUPT);
+    sunctx->scratch_in_use[i] = SUNFALSE;
+    vs[j]                     = NULL;
+  }
+
+  return SUN_SUCCESS;
+}
+
 /* These function are really only for users of the Fortran interface */
 N_Vector N_VGetVecAtIndexVectorArray(N_Vector* vs, int index)
 {
@@ -91,6 +91,16 @@ N_Vector N_VNewEmpty_SensWrapper(int nvecs, SUNContext sunctx)
     return (NULL);
   }
 
+  content->cvals = NULL;
+  content->cvals = (sunrealtype*)malloc(nvecs * sizeof(sunrealtype));
+  if (content->cvals == NULL)
+  {
+    free(content->vecs);
+    free(content);
+    N_VFreeEmpty(v);
+    return (NULL);
+  }
+
   /* initialize vector array to null */
   for (i = 0; i < nvecs; i++) { content->vecs[i] = NULL; }
 
@@ -225,6 +235,17 @@ N_Vector N_VCloneEmpty_SensWrapper(N_Vector w)
     return (NULL);
   }
 
+  content->cvals = NULL;
+  content->cvals = (sunrealtype*)malloc(NV_NVECS_SW(w) * sizeof(sunrealtype));
+  if (content->cvals == NULL)
+  {
+    free(ops);
+    free(v);
+    free(content->vecs);
+    free(content);
+    return (NULL);
+  }
+
   /* initialize vector array to null */
   for (i = 0; i < NV_NVECS_SW(w); i++) { content->vecs[i] = NULL; }
 
@@ -284,6 +305,8 @@ void N_VDestroy_SensWrapper(N_Vector v)
 
   free(NV_VECS_SW(v));
   NV_VECS_SW(v) = NULL;
+  free(NV_CVALS_SW(v));
+  NV_CVALS_SW(v) = NULL;
   free(v->content);
   v->content = NULL;
   free(v->ops);
@@ -296,26 +319,24 @@ void N_VDestroy_SensWrapper(N_Vector v)
 
 /*==============================================================================
   Standard vector operations
+
+  The linear sum, scale, constant, and WRMS norm operations act on all wrapped
+  vectors with one call to the corresponding vector array operation, so vectors
+  with fused operations enabled process all of them in a single kernel.
   ============================================================================*/
 
 void N_VLinearSum_SensWrapper(sunrealtype a, N_Vector x, sunrealtype b,
                               N_Vector y, N_Vector z)
 {
-  int i;
-
-  for (i = 0; i < NV_NVECS_SW(x); i++)
-  {
-    N_VLinearSum(a, NV_VEC_SW(x, i), b, NV_VEC_SW(y, i), NV_VEC_SW(z, i));
-  }
+  (void)N_VLinearSumVectorArray(NV_NVECS_SW(x), a, NV_VECS_SW(x), b,
+                                NV_VECS_SW(y), NV_VECS_SW(z));
 
   return;
 }
 
 void N_VConst_SensWrapper(sunrealtype c, N_Vector z)
 {
-  int i;
-
-  for (i = 0; i < NV_NVECS_SW(z); i++) { N_VConst(c, NV_VEC_SW(z, i)); }
+  (void)N_VConstVectorArray(NV_NVECS_SW(z), c, NV_VECS_SW(z));
 
   return;
 }
@@ -348,10 +369,10 @@ void N_VScale_SensWrapper(sunrealtype c, N_Vector x, N_Vector z)
 {
   int i;
 
-  for (i = 0; i < NV_NVECS_SW(x); i++)
-  {
-    N_VScale(c, NV_VEC_SW(x, i), NV_VEC_SW(z, i));
-  }
+  for (i = 0; i < NV_NVECS_SW(x); i++) { NV_CVALS_SW(x)[i] = c; }
+
+  (void)N_VScaleVectorArray(NV_NVECS_SW(x), NV_CVALS_SW(x), NV_VECS_SW(x),
+                            NV_VECS_SW(z));
 
   return;
 }
@@ -426,14 +447,16 @@ sunrealtype N_VMaxNorm_SensWrapper(N_Vector x)
 sunrealtype N_VWrmsNorm_SensWrapper(N_Vector x, N_Vector w)
 {
   int i;
-  sunrealtype nrm, tmp;
+  sunrealtype nrm;
 
   nrm = ZERO;
 
+  (void)N_VWrmsNormVectorArray(NV_NVECS_SW(x), NV_VECS_SW(x), NV_VECS_SW(w),
+                               NV_CVALS_SW(x));
+
   for (i = 0; i < NV_NVECS_SW(x); i++)
   {
-    tmp = N_VWrmsNorm(NV_VEC_SW(x, i), NV_VEC_SW(w, i));
-    if (tmp > nrm) { nrm = tmp; }
+    if (NV_CVALS_SW(x)[i] > nrm) { nrm = NV_CVALS_SW(x)[i]; }
   }
 
   return (nrm);
@@ -0,0 +1,799 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * Implementation of the SUNDIALS Parareal class.
+ *
+ * The interval [t0, tf] is split into N slices. With U_n the start
+ * value of slice n, G and F the coarse and fine propagators over a
+ * slice, and k the iteration, the Parareal correction is
+ *
+ *   U_{n+1}^k = G(U_n^k) + F(U_n^{k-1}) - G(U_n^{k-1}).
+ *
+ * Each slice keeps the fine value F[n] and the coarse value G[n] at
+ * the start the fine solve was launched from. A slice is processed
+ * once per iteration in order of increasing n: the coarse solve and
+ * correction give the new end value, and a fine solve from the new
+ * start is launched (to be used in the next iteration) only if the
+ * start changed by more than the tolerance. Fine solves thus run
+ * while the coarse sweep continues down the slices. A slice is final
+ * when its start is final and no fine solve was launched; the first
+ * slice has a final start, so at least one more slice becomes final
+ * in each iteration. When the change of every slice is below the
+ * tolerance no fine solve is launched and all slices become final
+ * in the same sweep.
+ *
+ * Slices are owned round-robin by the ranks of the time
+ * communicator. The end value of slice n and its status are sent to
+ * the owner of slice n+1. On a rank, fine solves are queued and run
+ * by the OpenMP threads (one fine SUNStepper per thread) while the
+ * main thread performs the coarse sweep.
+ * ----------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <sundials/priv/sundials_errors_impl.h>
+#include <sundials/sundials_core.h>
+#include <sundials/sundials_parareal.h>
+
+#include "sundials/sundials_errors.h"
+#include "sundials/sundials_nvector.h"
+#include "sundials/sundials_types.h"
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#include <omp.h>
+#endif
+
+#if SUNDIALS_MPI_ENABLED
+#include <mpi.h>
+#include <sundials/priv/sundials_mpi_errors_impl.h>
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+
+/* Default tolerances for the change of the slice end values */
+#define PARAREAL_RTOL SUN_RCONST(1.0e-6)
+#define PARAREAL_ATOL SUN_RCONST(1.0e-10)
+
+/* Status sent with the end value of a slice */
+enum
+{
+  PARAREAL_FINAL,   /* the end value will not change anymore        */
+  PARAREAL_CHANGED, /* the end value changed by more than tolerance */
+  PARAREAL_FAILED,  /* a propagator failed on this or an earlier slice */
+  PARAREAL_NSTATUS
+};
+
+struct SUNParareal_
+{
+  SUNContext sunctx;
+
+  /* propagators */
+  SUNStepper coarse; /* coarse propagator, used by the main thread */
+  SUNStepper* fine;  /* fine propagators, one per thread           */
+  int nfine;         /* number of fine propagators (threads)       */
+
+  /* options */
+  int nslices;      /* number of time slices (0: one per thread)  */
+  int maxiters;     /* maximum iterations (0: number of slices)   */
+  sunrealtype rtol; /* relative tolerance for the slice changes   */
+  sunrealtype atol; /* absolute tolerance for the slice changes   */
+
+  /* time communicator */
+  SUNComm comm;
+  int rank;
+  int nranks;
+
+  /* current interval and slice width */
+  sunrealtype t0;
+  sunrealtype tf;
+  sunrealtype dt;
+
+  /* slice workspace, only allocated for the slices owned by this rank */
+  int nalloc;           /* number of slices in the workspace       */
+  N_Vector* ustart;     /* start value of each slice               */
+  N_Vector* uend;       /* end value of each slice                 */
+  N_Vector* ffine;      /* fine start (at launch) and fine value   */
+  N_Vector* gcoarse;    /* coarse value at the fine start          */
+  N_Vector tmp1;        /* work vectors                            */
+  N_Vector tmp2;
+  int* slice_final;     /* slice end value is final                */
+  int* start_final;     /* slice start value is final              */
+  int* start_changed;   /* slice start value changed this sweep    */
+  int* fine_pending;    /* fine value not yet waited for           */
+  int* fine_fresh;      /* fine value not yet used in a correction */
+  int* fine_done;       /* fine solve completed (atomic)           */
+  SUNErrCode* fine_err; /* fine solve return value                 */
+
+  /* fine solve queue (ring buffer of slice indices) */
+  int* queue;
+  int qhead;
+  int qtail;
+  int shutdown;
+
+  /* message buffer */
+  char* buf;
+  sunindextype bufsize;
+
+  /* statistics */
+  int niters;
+  long int nfinesolves;
+  long int ncoarsesolves;
+  sunrealtype maxchange;
+};
+
+/* -----------------------------------------------------------------
+ * Private functions
+ * ----------------------------------------------------------------*/
+
+/* Propagate yin from t0 to t1 with the stepper S and store the result in
+   yout (which may be the same vector as yin) */
+static SUNErrCode sunParareal_Propagate(SUNStepper S, sunrealtype t0,
+                                        sunrealtype t1, N_Vector yin,
+                                        N_Vector yout)
+{
+  SUNErrCode err;
+  sunrealtype tret;
+
+  err = SUNStepper_Reset(S, t0, yin);
+  if (err) { return err; }
+
+  err = SUNStepper_SetStepDirection(S, t1 - t0);
+  if (err && err != SUN_ERR_NOT_IMPLEMENTED) { return err; }
+
+  err = SUNStepper_SetStopTime(S, t1);
+  if (err && err != SUN_ERR_NOT_IMPLEMENTED) { return err; }
+
+  if (yout != yin) { N_VScale(ONE, yin, yout); }
+  return SUNStepper_Evolve(S, t1, yout, &tret);
+}
+
+/* Start and end time of slice n, the last slice ends exactly at tf */
+static void sunParareal_SliceTimes(SUNParareal pr, int n, sunrealtype* tn,
+                                   sunrealtype* tn1)
+{
+  *tn  = pr->t0 + n * pr->dt;
+  *tn1 = (n == pr->nalloc - 1) ? pr->tf : pr->t0 + (n + 1) * pr->dt;
+}
+
+/* Run the fine solve of slice n with the fine stepper of thread tid */
+static void sunParareal_RunFine(SUNParareal pr, int n, int tid)
+{
+  sunrealtype tn, tn1;
+
+  sunParareal_SliceTimes(pr, n, &tn, &tn1);
+  pr->fine_err[n] = sunParareal_Propagate(pr->fine[tid], tn, tn1,
+                                          pr->ffine[n], pr->ffine[n]);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+#pragma omp atomic write seq_cst
+#endif
+  pr->fine_done[n] = 1;
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+/* Take a slice index from the fine solve queue, returns -1 if it is empty */
+static int sunParareal_Dequeue(SUNParareal pr)
+{
+  int n = -1;
+#pragma omp critical(sunparareal_queue)
+  {
+    if (pr->qhead < pr->qtail)
+    {
+      n = pr->queue[pr->qhead % pr->nalloc];
+      pr->qhead++;
+    }
+  }
+  return n;
+}
+#endif
+
+/* Launch the fine solve of slice n from its current start value. With more
+   than one thread the solve is queued, otherwise it is run immediately. */
+static void sunParareal_LaunchFine(SUNParareal pr, int n)
+{
+  N_VScale(ONE, pr->ustart[n], pr->ffine[n]);
+  pr->fine_pending[n] = 1;
+  pr->fine_fresh[n]   = 1;
+  pr->fine_done[n]    = 0;
+  pr->nfinesolves++;
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (pr->nfine > 1)
+  {
+#pragma omp critical(sunparareal_queue)
+    {
+      pr->queue[pr->qtail % pr->nalloc] = n;
+      pr->qtail++;
+    }
+    return;
+  }
+#endif
+
+  sunParareal_RunFine(pr, n, 0);
+}
+
+/* Wait for the fine solve of slice n, the main thread runs queued fine solves
+   while it waits */
+static SUNErrCode sunParareal_WaitFine(SUNParareal pr, int n)
+{
+  if (!pr->fine_pending[n]) { return SUN_SUCCESS; }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (pr->nfine > 1)
+  {
+    int done = 0;
+    while (!done)
+    {
+#pragma omp atomic read seq_cst
+      done = pr->fine_done[n];
+      if (!done)
+      {
+        int m = sunParareal_Dequeue(pr);
+        if (m >= 0) { sunParareal_RunFine(pr, m, omp_get_thread_num()); }
+      }
+    }
+  }
+#endif
+
+  pr->fine_pending[n] = 0;
+  return pr->fine_err[n];
+}
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+/* Fine solve loop of the threads other than the main thread */
+static void sunParareal_Worker(SUNParareal pr)
+{
+  int shutdown = 0;
+  while (!shutdown)
+  {
+    int n = sunParareal_Dequeue(pr);
+    if (n >= 0) { sunParareal_RunFine(pr, n, omp_get_thread_num()); }
+    else
+    {
+#pragma omp atomic read seq_cst
+      shutdown = pr->shutdown;
+    }
+  }
+}
+#endif
+
+/* Receive the start value and status of slice n from the owner of slice n-1.
+   If the sender is this rank the start value is already in place. */
+static SUNErrCode sunParareal_Recv(SUNParareal pr, int n, int* status)
+{
+  SUNFunctionBegin(pr->sunctx);
+  int owner = (n - 1) % pr->nranks;
+
+  if (owner == pr->rank) { return SUN_SUCCESS; }
+
+#if SUNDIALS_MPI_ENABLED
+  SUNCheckMPICall(MPI_Recv(pr->buf,
+                           (int)(pr->bufsize + PARAREAL_NSTATUS * sizeof(int)),
+                           MPI_BYTE, owner, 0, pr->comm, MPI_STATUS_IGNORE));
+  SUNCheckCall(N_VBufUnpack(pr->ustart[n], pr->buf));
+  memcpy(status, pr->buf + pr->bufsize, PARAREAL_NSTATUS * sizeof(int));
+#else
+  (void)status;
+#endif
+
+  return SUN_SUCCESS;
+}
+
+/* Send the end value and status of slice n to the owner of slice n+1 */
+static SUNErrCode sunParareal_Send(SUNParareal pr, int n, int* status)
+{
+  SUNFunctionBegin(pr->sunctx);
+  int owner = (n + 1) % pr->nranks;
+
+  if (owner == pr->rank)
+  {
+    /* the start of slice n+1 is the end of slice n (aliased) */
+    pr->start_final[n + 1]   = status[PARAREAL_FINAL];
+    pr->start_changed[n + 1] = status[PARAREAL_CHANGED];
+    return SUN_SUCCESS;
+  }
+
+#if SUNDIALS_MPI_ENABLED
+  SUNCheckCall(N_VBufPack(pr->uend[n], pr->buf));
+  memcpy(pr->buf + pr->bufsize, status, PARAREAL_NSTATUS * sizeof(int));
+  SUNCheckMPICall(MPI_Send(pr->buf,
+                           (int)(pr->bufsize + PARAREAL_NSTATUS * sizeof(int)),
+                           MPI_BYTE, owner, 0, pr->comm));
+#endif
+
+  return SUN_SUCCESS;
+}
+
+/* Process slice n in iteration k, see the description at the top */
+static SUNErrCode sunParareal_Slice(SUNParareal pr, int n, int k, int maxiters,
+                                    int* status, sunrealtype* change)
+{
+  sunrealtype tn, tn1;
+  int launch;
+  SUNErrCode err;
+
+  sunParareal_SliceTimes(pr, n, &tn, &tn1);
+  *change = ZERO;
+
+  /* initial coarse sweep */
+  if (k == 0)
+  {
+    err = sunParareal_Propagate(pr->coarse, tn, tn1, pr->ustart[n],
+                                pr->gcoarse[n]);
+    pr->ncoarsesolves++;
+    if (err) { return err; }
+
+    N_VScale(ONE, pr->gcoarse[n], pr->uend[n]);
+    sunParareal_LaunchFine(pr, n);
+
+    status[PARAREAL_FINAL]   = 0;
+    status[PARAREAL_CHANGED] = 1;
+    return SUN_SUCCESS;
+  }
+
+  err = sunParareal_WaitFine(pr, n);
+  if (err) { return err; }
+
+  /* a new fine solve is needed if the start changed */
+  launch = pr->start_changed[n] && (k < maxiters);
+
+  /* correction, the end value is unchanged if neither the start value nor
+     the fine value changed */
+  if (pr->fine_fresh[n] || pr->start_changed[n])
+  {
+    err = sunParareal_Propagate(pr->coarse, tn, tn1, pr->ustart[n], pr->tmp1);
+    pr->ncoarsesolves++;
+    if (err) { return err; }
+
+    N_VLinearSum(ONE, pr->tmp1, ONE, pr->ffine[n], pr->tmp2);
+    N_VLinearSum(ONE, pr->tmp2, -ONE, pr->gcoarse[n], pr->tmp2);
+    if (launch) { N_VScale(ONE, pr->tmp1, pr->gcoarse[n]); }
+
+    /* WRMS norm of the change with weights 1 / (rtol |U| + atol) */
+    N_VLinearSum(ONE, pr->tmp2, -ONE, pr->uend[n], pr->uend[n]);
+    N_VAbs(pr->tmp2, pr->tmp1);
+    N_VScale(pr->rtol, pr->tmp1, pr->tmp1);
+    N_VAddConst(pr->tmp1, pr->atol, pr->tmp1);
+    N_VInv(pr->tmp1, pr->tmp1);
+    *change = N_VWrmsNorm(pr->uend[n], pr->tmp1);
+    N_VScale(ONE, pr->tmp2, pr->uend[n]);
+
+    pr->fine_fresh[n] = 0;
+  }
+
+  if (launch) { sunParareal_LaunchFine(pr, n); }
+
+  status[PARAREAL_FINAL]   = (pr->start_final[n] && !launch) || (k == maxiters);
+  status[PARAREAL_CHANGED] = (*change > ONE);
+  return SUN_SUCCESS;
+}
+
+/* Parareal iterations on this rank */
+static SUNErrCode sunParareal_Iterate(SUNParareal pr, int nslices, int maxiters)
+{
+  int k, n, nactive;
+  int status[PARAREAL_NSTATUS];
+  sunrealtype change, maxchange;
+  SUNErrCode err, failed;
+
+  failed = SUN_SUCCESS;
+
+  for (k = 0; k <= maxiters; k++)
+  {
+    nactive   = 0;
+    maxchange = ZERO;
+
+    for (n = pr->rank; n < nslices; n += pr->nranks)
+    {
+      if (pr->slice_final[n]) { continue; }
+      nactive++;
+
+      status[PARAREAL_FINAL]   = 0;
+      status[PARAREAL_CHANGED] = 0;
+      status[PARAREAL_FAILED]  = 0;
+
+      /* receive the start value unless it is final */
+      if (n > 0 && !pr->start_final[n])
+      {
+        int recv[PARAREAL_NSTATUS] = {0, 0, 0};
+        err = sunParareal_Recv(pr, n, recv);
+        if (err) { return err; }
+        if (pr->rank != (n - 1) % pr->nranks)
+        {
+          pr->start_final[n]   = recv[PARAREAL_FINAL];
+          pr->start_changed[n] = recv[PARAREAL_CHANGED];
+          if (recv[PARAREAL_FAILED] && !failed) { failed = SUN_ERR_OP_FAIL; }
+        }
+      }
+
+      /* after a failure only the status is forwarded so that the ranks
+         terminate together */
+      if (!failed)
+      {
+        err = sunParareal_Slice(pr, n, k, maxiters, status, &change);
+        if (err) { failed = err; }
+        maxchange = SUNMAX(maxchange, change);
+      }
+      if (failed)
+      {
+        status[PARAREAL_FINAL]   = (n == 0) || pr->start_final[n];
+        status[PARAREAL_CHANGED] = 0;
+        status[PARAREAL_FAILED]  = 1;
+      }
+
+      pr->start_changed[n] = 0;
+      pr->slice_final[n]   = status[PARAREAL_FINAL];
+
+      if (n < nslices - 1)
+      {
+        err = sunParareal_Send(pr, n, status);
+        if (err) { return err; }
+      }
+    }
+
+    if (nactive == 0) { break; }
+    pr->niters    = k;
+    pr->maxchange = maxchange;
+  }
+
+  return failed;
+}
+
+/* Free the slice workspace */
+static void sunParareal_FreeWorkspace(SUNParareal pr)
+{
+  int n;
+
+  if (pr->ustart && pr->uend && pr->ffine && pr->gcoarse)
+  {
+    for (n = 0; n < pr->nalloc; n++)
+    {
+      /* the start of slice n may alias the end of slice n-1 */
+      if (pr->ustart[n] && (n == 0 || pr->ustart[n] != pr->uend[n - 1]))
+      {
+        N_VDestroy(pr->ustart[n]);
+      }
+      if (pr->uend[n]) { N_VDestroy(pr->uend[n]); }
+      if (pr->ffine[n]) { N_VDestroy(pr->ffine[n]); }
+      if (pr->gcoarse[n]) { N_VDestroy(pr->gcoarse[n]); }
+    }
+  }
+  if (pr->tmp1) { N_VDestroy(pr->tmp1); }
+  if (pr->tmp2) { N_VDestroy(pr->tmp2); }
+
+  free(pr->ustart);
+  free(pr->uend);
+  free(pr->ffine);
+  free(pr->gcoarse);
+  free(pr->slice_final);
+  free(pr->start_final);
+  free(pr->start_changed);
+  free(pr->fine_pending);
+  free(pr->fine_fresh);
+  free(pr->fine_done);
+  free(pr->fine_err);
+  free(pr->queue);
+  free(pr->buf);
+
+  pr->ustart        = NULL;
+  pr->uend          = NULL;
+  pr->ffine         = NULL;
+  pr->gcoarse       = NULL;
+  pr->tmp1          = NULL;
+  pr->tmp2          = NULL;
+  pr->slice_final   = NULL;
+  pr->start_final   = NULL;
+  pr->start_changed = NULL;
+  pr->fine_pending  = NULL;
+  pr->fine_fresh    = NULL;
+  pr->fine_done     = NULL;
+  pr->fine_err      = NULL;
+  pr->queue         = NULL;
+  pr->buf           = NULL;
+  pr->nalloc        = 0;
+}
+
+/* Allocate the workspace for nslices slices, vectors are only created for
+   the slices owned by this rank */
+static SUNErrCode sunParareal_AllocWorkspace(SUNParareal pr, int nslices,
+                                             N_Vector tmpl)
+{
+  int n;
+
+  pr->nalloc        = nslices;
+  pr->ustart        = (N_Vector*)calloc(nslices, sizeof(N_Vector));
+  pr->uend          = (N_Vector*)calloc(nslices, sizeof(N_Vector));
+  pr->ffine         = (N_Vector*)calloc(nslices, sizeof(N_Vector));
+  pr->gcoarse       = (N_Vector*)calloc(nslices, sizeof(N_Vector));
+  pr->slice_final   = (int*)calloc(nslices, sizeof(int));
+  pr->start_final   = (int*)calloc(nslices, sizeof(int));
+  pr->start_changed = (int*)calloc(nslices, sizeof(int));
+  pr->fine_pending  = (int*)calloc(nslices, sizeof(int));
+  pr->fine_fresh    = (int*)calloc(nslices, sizeof(int));
+  pr->fine_done     = (int*)calloc(nslices, sizeof(int));
+  pr->fine_err      = (SUNErrCode*)calloc(nslices, sizeof(SUNErrCode));
+  pr->queue         = (int*)calloc(nslices, sizeof(int));
+  if (!pr->ustart || !pr->uend || !pr->ffine || !pr->gcoarse ||
+      !pr->slice_final || !pr->start_final || !pr->start_changed ||
+      !pr->fine_pending || !pr->fine_fresh || !pr->fine_done ||
+      !pr->fine_err || !pr->queue)
+  {
+    return SUN_ERR_MALLOC_FAIL;
+  }
+
+  for (n = pr->rank; n < nslices; n += pr->nranks)
+  {
+    pr->uend[n]    = N_VClone(tmpl);
+    pr->ffine[n]   = N_VClone(tmpl);
+    pr->gcoarse[n] = N_VClone(tmpl);
+    if (n > 0 && (n - 1) % pr->nranks == pr->rank)
+    {
+      pr->ustart[n] = pr->uend[n - 1];
+    }
+    else { pr->ustart[n] = N_VClone(tmpl); }
+    if (!pr->uend[n] || !pr->ffine[n] || !pr->gcoarse[n] || !pr->ustart[n])
+    {
+      return SUN_ERR_MEM_FAIL;
+    }
+  }
+
+  pr->tmp1 = N_VClone(tmpl);
+  pr->tmp2 = N_VClone(tmpl);
+  if (!pr->tmp1 || !pr->tmp2) { return SUN_ERR_MEM_FAIL; }
+
+  if (pr->nranks > 1)
+  {
+    if (N_VBufSize(tmpl, &pr->bufsize)) { return SUN_ERR_ARG_INCOMPATIBLE; }
+    pr->buf = (char*)malloc(pr->bufsize + PARAREAL_NSTATUS * sizeof(int));
+    if (!pr->buf) { return SUN_ERR_MALLOC_FAIL; }
+  }
+
+  return SUN_SUCCESS;
+}
+
+/* -----------------------------------------------------------------
+ * Exported functions
+ * ----------------------------------------------------------------*/
+
+SUNErrCode SUNParareal_Create(SUNStepper coarse, SUNStepper* fine, int nfine,
+                              SUNContext sunctx, SUNParareal* pr_out)
+{
+  SUNParareal pr;
+  int i;
+
+  if (!sunctx) { return SUN_ERR_SUNCTX_CORRUPT; }
+  if (!coarse || !fine || !pr_out) { return SUN_ERR_ARG_CORRUPT; }
+  if (nfine < 1) { return SUN_ERR_ARG_OUTOFRANGE; }
+  for (i = 0; i < nfine; i++)
+  {
+    if (!fine[i]) { return SUN_ERR_ARG_CORRUPT; }
+  }
+
+#if !defined(SUNDIALS_OPENMP_ENABLED)
+  /* several fine propagators are only used with OpenMP threads */
+  if (nfine > 1) { return SUN_ERR_ARG_INCOMPATIBLE; }
+#endif
+
+  pr = (SUNParareal)calloc(1, sizeof(*pr));
+  if (!pr) { return SUN_ERR_MALLOC_FAIL; }
+
+  pr->fine = (SUNStepper*)malloc(nfine * sizeof(SUNStepper));
+  if (!pr->fine)
+  {
+    free(pr);
+    return SUN_ERR_MALLOC_FAIL;
+  }
+  for (i = 0; i < nfine; i++) { pr->fine[i] = fine[i]; }
+
+  pr->sunctx = sunctx;
+  pr->coarse = coarse;
+  pr->nfine  = nfine;
+  pr->rtol   = PARAREAL_RTOL;
+  pr->atol   = PARAREAL_ATOL;
+  pr->comm   = SUN_COMM_NULL;
+  pr->rank   = 0;
+  pr->nranks = 1;
+
+  *pr_out = pr;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_SetNumSlices(SUNParareal pr, int nslices)
+{
+  if (!pr) { return SUN_ERR_ARG_CORRUPT; }
+  pr->nslices = (nslices > 0) ? nslices : 0;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_SetMaxIters(SUNParareal pr, int maxiters)
+{
+  if (!pr) { return SUN_ERR_ARG_CORRUPT; }
+  pr->maxiters = (maxiters > 0) ? maxiters : 0;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_SetTolerances(SUNParareal pr, sunrealtype rtol,
+                                     sunrealtype atol)
+{
+  if (!pr) { return SUN_ERR_ARG_CORRUPT; }
+  if (rtol < ZERO || atol < ZERO || (rtol == ZERO && atol == ZERO))
+  {
+    return SUN_ERR_ARG_OUTOFRANGE;
+  }
+  pr->rtol = rtol;
+  pr->atol = atol;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_SetTimeComm(SUNParareal pr, SUNComm comm)
+{
+  if (!pr) { return SUN_ERR_ARG_CORRUPT; }
+
+#if SUNDIALS_MPI_ENABLED
+  SUNFunctionBegin(pr->sunctx);
+  if (comm == SUN_COMM_NULL)
+  {
+    pr->comm   = SUN_COMM_NULL;
+    pr->rank   = 0;
+    pr->nranks = 1;
+    return SUN_SUCCESS;
+  }
+  SUNCheckMPICall(MPI_Comm_rank(comm, &pr->rank));
+  SUNCheckMPICall(MPI_Comm_size(comm, &pr->nranks));
+  pr->comm = comm;
+  return SUN_SUCCESS;
+#else
+  if (comm != SUN_COMM_NULL) { return SUN_ERR_ARG_INCOMPATIBLE; }
+  return SUN_SUCCESS;
+#endif
+}
+
+SUNErrCode SUNParareal_Evolve(SUNParareal pr, sunrealtype t0, N_Vector y0,
+                              sunrealtype tf, N_Vector yf)
+{
+  int nslices, maxiters, last;
+  SUNErrCode err;
+
+  if (!pr || !y0 || !yf) { return SUN_ERR_ARG_CORRUPT; }
+  SUNFunctionBegin(pr->sunctx);
+  if (tf == t0) { return SUN_ERR_ARG_OUTOFRANGE; }
+
+  nslices  = (pr->nslices > 0) ? pr->nslices : pr->nfine * pr->nranks;
+  maxiters = (pr->maxiters > 0) ? SUNMIN(pr->maxiters, nslices) : nslices;
+  last     = nslices - 1;
+
+  pr->t0            = t0;
+  pr->tf            = tf;
+  pr->dt            = (tf - t0) / nslices;
+  pr->niters        = 0;
+  pr->nfinesolves   = 0;
+  pr->ncoarsesolves = 0;
+  pr->maxchange     = ZERO;
+  pr->qhead         = 0;
+  pr->qtail         = 0;
+  pr->shutdown      = 0;
+
+  err = sunParareal_AllocWorkspace(pr, nslices, y0);
+  if (err)
+  {
+    sunParareal_FreeWorkspace(pr);
+    return err;
+  }
+
+  /* the first slice starts from y0 on its owner */
+  if (pr->rank == 0)
+  {
+    N_VScale(ONE, y0, pr->ustart[0]);
+    pr->start_final[0] = 1;
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (pr->nfine > 1)
+  {
+#pragma omp parallel num_threads(pr->nfine)
+    {
+#pragma omp master
+      {
+        err = sunParareal_Iterate(pr, nslices, maxiters);
+
+        /* discard the remaining queued fine solves, whose results are no
+           longer needed, before releasing the threads */
+        while (sunParareal_Dequeue(pr) >= 0) {}
+#pragma omp atomic write seq_cst
+        pr->shutdown = 1;
+      }
+      if (omp_get_thread_num() != 0) { sunParareal_Worker(pr); }
+    }
+  }
+  else
+#endif
+  {
+    err = sunParareal_Iterate(pr, nslices, maxiters);
+  }
+
+#if SUNDIALS_MPI_ENABLED
+  if (pr->nranks > 1)
+  {
+    int failed = (err != SUN_SUCCESS);
+    int niters = pr->niters;
+    long int counts[2] = {pr->nfinesolves, pr->ncoarsesolves};
+    double change      = (double)pr->maxchange;
+
+    /* the solution is on the owner of the last slice */
+    if (pr->rank == last % pr->nranks)
+    {
+      SUNCheckCallNoRet(N_VBufPack(pr->uend[last], pr->buf));
+    }
+    SUNCheckMPICallNoRet(MPI_Bcast(pr->buf, (int)pr->bufsize, MPI_BYTE,
+                                   last % pr->nranks, pr->comm));
+    N_VBufUnpack(yf, pr->buf);
+
+    SUNCheckMPICallNoRet(MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT,
+                                       MPI_MAX, pr->comm));
+    SUNCheckMPICallNoRet(MPI_Allreduce(MPI_IN_PLACE, &niters, 1, MPI_INT,
+                                       MPI_MAX, pr->comm));
+    SUNCheckMPICallNoRet(MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_LONG,
+                                       MPI_SUM, pr->comm));
+    SUNCheckMPICallNoRet(MPI_Allreduce(MPI_IN_PLACE, &change, 1, MPI_DOUBLE,
+                                       MPI_MAX, pr->comm));
+    pr->niters        = niters;
+    pr->nfinesolves   = counts[0];
+    pr->ncoarsesolves = counts[1];
+    pr->maxchange     = (sunrealtype)change;
+    if (failed && !err) { err = SUN_ERR_OP_FAIL; }
+  }
+  else
+#endif
+  {
+    N_VScale(ONE, pr->uend[last], yf);
+  }
+
+  sunParareal_FreeWorkspace(pr);
+
+  return err;
+}
+
+SUNErrCode SUNParareal_GetNumIters(SUNParareal pr, int* niters)
+{
+  if (!pr || !niters) { return SUN_ERR_ARG_CORRUPT; }
+  *niters = pr->niters;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_GetNumFineSolves(SUNParareal pr, long int* nfine)
+{
+  if (!pr || !nfine) { return SUN_ERR_ARG_CORRUPT; }
+  *nfine = pr->nfinesolves;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_GetNumCoarseSolves(SUNParareal pr, long int* ncoarse)
+{
+  if (!pr || !ncoarse) { return SUN_ERR_ARG_CORRUPT; }
+  *ncoarse = pr->ncoarsesolves;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_GetMaxChange(SUNParareal pr, sunrealtype* change)
+{
+  if (!pr || !change) { return SUN_ERR_ARG_CORRUPT; }
+  *change = pr->maxchange;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNParareal_Destroy(SUNParareal* pr)
+{
+  if (!pr || !(*pr)) { return SUN_SUCCESS; }
+  free((*pr)->fine);
+  free(*pr);
+  *pr = NULL;
+  return SUN_SUCCESS;
+}
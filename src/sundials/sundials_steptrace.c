@@ -0,0 +1,237 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * SUNDIALS step trace class implementation.
+ *
+ * The trace file consists of a 64 byte header followed by a ring of
+ * capacity fixed-size SUNStepTraceRecord entries. The header stores
+ * the total number of records written so the oldest record is located
+ * at slot (nrecords % capacity) once the ring has wrapped around. When
+ * mmap is available the file is mapped into memory and records are
+ * written directly into the mapping, otherwise the ring is kept in
+ * memory and written to the file by SUNStepTrace_Flush/Destroy.
+ * ----------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sundials/sundials_config.h>
+#include <sundials/sundials_errors.h>
+#include <sundials/sundials_steptrace.h>
+#include <sundials/sundials_types.h>
+
+#if defined(SUNDIALS_HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SUN_STEPTRACE_MAGIC "SUNTRACE"
+
+/* Trace file header, padded to 64 bytes */
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  int64_t capacity;
+  int64_t nrecords;
+  char reserved[32];
+} sunStepTraceHeader;
+
+struct SUNStepTrace_
+{
+  char* filename;
+  int64_t capacity;
+  size_t nbytes;              /* size of the header and ring in bytes */
+  sunStepTraceHeader* header; /* start of the mapped (or buffered) file */
+  SUNStepTraceRecord* ring;   /* first record slot following the header */
+#if defined(SUNDIALS_HAVE_MMAP)
+  int fd;
+#endif
+};
+
+static SUNErrCode sunStepTraceOpen(SUNStepTrace trace);
+static SUNErrCode sunStepTraceClose(SUNStepTrace trace);
+
+SUNErrCode SUNStepTrace_Create(const char* filename, int64_t capacity,
+                               SUNStepTrace* trace_out)
+{
+  SUNStepTrace trace = NULL;
+  SUNErrCode err     = SUN_SUCCESS;
+
+  if (!trace_out || !filename || !strlen(filename)) { return SUN_ERR_ARG_CORRUPT; }
+  *trace_out = NULL;
+
+  if (capacity < 1) { return SUN_ERR_ARG_OUTOFRANGE; }
+
+  trace = (SUNStepTrace)malloc(sizeof(struct SUNStepTrace_));
+  if (!trace) { return SUN_ERR_MALLOC_FAIL; }
+
+  trace->filename = (char*)malloc(strlen(filename) + 1);
+  if (!trace->filename)
+  {
+    free(trace);
+    return SUN_ERR_MALLOC_FAIL;
+  }
+  strcpy(trace->filename, filename);
+
+  trace->capacity = capacity;
+  trace->nbytes   = sizeof(sunStepTraceHeader) +
+                  (size_t)capacity * sizeof(SUNStepTraceRecord);
+  trace->header = NULL;
+  trace->ring   = NULL;
+#if defined(SUNDIALS_HAVE_MMAP)
+  trace->fd = -1;
+#endif
+
+  err = sunStepTraceOpen(trace);
+  if (err)
+  {
+    free(trace->filename);
+    free(trace);
+    return err;
+  }
+
+  memcpy(trace->header->magic, SUN_STEPTRACE_MAGIC, 8);
+  trace->header->version     = SUN_STEPTRACE_VERSION;
+  trace->header->record_size = (uint32_t)sizeof(SUNStepTraceRecord);
+  trace->header->capacity    = capacity;
+  trace->header->nrecords    = 0;
+  memset(trace->header->reserved, 0, sizeof(trace->header->reserved));
+
+  *trace_out = trace;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNStepTrace_Record(SUNStepTrace trace,
+                               const SUNStepTraceRecord* record)
+{
+  if (!trace || !record) { return SUN_ERR_ARG_CORRUPT; }
+
+  int64_t slot = trace->header->nrecords % trace->capacity;
+  memcpy(trace->ring + slot, record, sizeof(SUNStepTraceRecord));
+  trace->header->nrecords++;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNStepTrace_GetNumRecords(SUNStepTrace trace, int64_t* nrecords)
+{
+  if (!trace || !nrecords) { return SUN_ERR_ARG_CORRUPT; }
+  *nrecords = trace->header->nrecords;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNStepTrace_Flush(SUNStepTrace trace)
+{
+  if (!trace) { return SUN_ERR_ARG_CORRUPT; }
+
+#if defined(SUNDIALS_HAVE_MMAP)
+  if (msync(trace->header, trace->nbytes, MS_SYNC)) { return SUN_ERR_OP_FAIL; }
+#else
+  FILE* fp = fopen(trace->filename, "wb");
+  if (!fp) { return SUN_ERR_FILE_OPEN; }
+  size_t nwritten = fwrite(trace->header, 1, trace->nbytes, fp);
+  fclose(fp);
+  if (nwritten != trace->nbytes) { return SUN_ERR_OP_FAIL; }
+#endif
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNStepTrace_Destroy(SUNStepTrace* trace)
+{
+  SUNErrCode err = SUN_SUCCESS;
+
+  if (!trace || !(*trace)) { return SUN_SUCCESS; }
+
+  err = SUNStepTrace_Flush(*trace);
+  if (sunStepTraceClose(*trace) && !err) { err = SUN_ERR_DESTROY_FAIL; }
+
+  free((*trace)->filename);
+  free(*trace);
+  *trace = NULL;
+
+  return err;
+}
+
+/* -----------------------------------------------------------------
+ * Private functions
+ * ----------------------------------------------------------------*/
+
+#if defined(SUNDIALS_HAVE_MMAP)
+
+static SUNErrCode sunStepTraceOpen(SUNStepTrace trace)
+{
+  void* addr = NULL;
+
+  trace->fd = open(trace->filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (trace->fd < 0) { return SUN_ERR_FILE_OPEN; }
+
+  if (ftruncate(trace->fd, (off_t)trace->nbytes))
+  {
+    close(trace->fd);
+    return SUN_ERR_OP_FAIL;
+  }
+
+  addr = mmap(NULL, trace->nbytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+              trace->fd, 0);
+  if (addr == MAP_FAILED)
+  {
+    close(trace->fd);
+    return SUN_ERR_MEM_FAIL;
+  }
+
+  trace->header = (sunStepTraceHeader*)addr;
+  trace->ring   = (SUNStepTraceRecord*)(trace->header + 1);
+
+  return SUN_SUCCESS;
+}
+
+static SUNErrCode sunStepTraceClose(SUNStepTrace trace)
+{
+  SUNErrCode err = SUN_SUCCESS;
+  if (munmap(trace->header, trace->nbytes)) { err = SUN_ERR_MEM_FAIL; }
+  if (close(trace->fd)) { err = SUN_ERR_OP_FAIL; }
+  trace->header = NULL;
+  trace->ring   = NULL;
+  trace->fd     = -1;
+  return err;
+}
+
+#else
+
+static SUNErrCode sunStepTraceOpen(SUNStepTrace trace)
+{
+  /* check the file can be written before buffering in memory */
+  FILE* fp = fopen(trace->filename, "wb");
+  if (!fp) { return SUN_ERR_FILE_OPEN; }
+  fclose(fp);
+
+  trace->header = (sunStepTraceHeader*)calloc(1, trace->nbytes);
+  if (!trace->header) { return SUN_ERR_MALLOC_FAIL; }
+  trace->ring = (SUNStepTraceRecord*)(trace->header + 1);
+
+  return SUN_SUCCESS;
+}
+
+static SUNErrCode sunStepTraceClose(SUNStepTrace trace)
+{
+  free(trace->header);
+  trace->header = NULL;
+  trace->ring   = NULL;
+  return SUN_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * Utilities for writing step trace records from the packages.
+ * ----------------------------------------------------------------*/
+
+#ifndef _SUNDIALS_STEPTRACE_IMPL_H
+#define _SUNDIALS_STEPTRACE_IMPL_H
+
+#include <string.h>
+#include <sundials/sundials_steptrace.h>
+
+/* The packages sample the following cumulative counters before and after a
+   step and store the differences in the record */
+enum
+{
+  SUN_STEPTRACE_NETF,
+  SUN_STEPTRACE_NCFN,
+  SUN_STEPTRACE_NNI,
+  SUN_STEPTRACE_NLI,
+  SUN_STEPTRACE_NSETUPS,
+  SUN_STEPTRACE_NJEVALS,
+  SUN_STEPTRACE_NCOUNTERS
+};
+
+/* Initialize a record with the writer id and the per-step counter values */
+static inline void sunStepTraceInitRecord(SUNStepTraceRecord* record,
+                                          SUNStepTraceSolverID solver,
+                                          const long int start[],
+                                          const long int end[])
+{
+  memset(record, 0, sizeof(SUNStepTraceRecord));
+  record->solver  = (int32_t)solver;
+  record->netf    = (int32_t)(end[SUN_STEPTRACE_NETF] - start[SUN_STEPTRACE_NETF]);
+  record->ncfn    = (int32_t)(end[SUN_STEPTRACE_NCFN] - start[SUN_STEPTRACE_NCFN]);
+  record->nni     = (int32_t)(end[SUN_STEPTRACE_NNI] - start[SUN_STEPTRACE_NNI]);
+  record->nli     = (int32_t)(end[SUN_STEPTRACE_NLI] - start[SUN_STEPTRACE_NLI]);
+  record->nsetups = (int32_t)(end[SUN_STEPTRACE_NSETUPS] -
+                              start[SUN_STEPTRACE_NSETUPS]);
+  record->njevals = (int32_t)(end[SUN_STEPTRACE_NJEVALS] -
+                              start[SUN_STEPTRACE_NJEVALS]);
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <sundials/sundials_config.h>
 #include <sundials/sundials_types.h>
+#include <time.h>
 
 static inline char* sunCombineFileAndLine(int line, const char* file)
 {
@@ -86,4 +87,20 @@ static inline void sunCompensatedSum(sunrealtype base, sunrealtype inc,
   *sum                      = tmp2;
 }
 
+/*
+ * Wall clock time in seconds from an arbitrary starting point, used to
+ * measure the cost of solver operations at runtime. Falls back to the
+ * processor time if POSIX timers are not available.
+ */
+static inline double sunWallClockTime(void)
+{
+#if defined(SUNDIALS_HAVE_POSIX_TIMERS)
+  struct timespec spec;
+  clock_gettime(CLOCK_MONOTONIC, &spec);
+  return (double)spec.tv_sec + (double)spec.tv_nsec / 1.0e9;
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
 #endif /* _SUNDIALS_UTILS_H */
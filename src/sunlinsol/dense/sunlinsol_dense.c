@@ -28,6 +28,9 @@
 
 #define ONE SUN_RCONST(1.0)
 
+/* number of right-hand sides solved together in SUNLinSolSolveMulti */
+#define RHS_BLOCK 16
+
 /*
  * -----------------------------------------------------------------
  * Dense solver structure accessibility macros:
@@ -75,6 +78,7 @@ SUNLinearSolver SUNLinSol_Dense(SUNDIALS_MAYBE_UNUSED N_Vector y, SUNMatrix A,
   S->ops->initialize = SUNLinSolInitialize_Dense;
   S->ops->setup      = SUNLinSolSetup_Dense;
   S->ops->solve      = SUNLinSolSolve_Dense;
+  S->ops->solvemulti = SUNLinSolSolveMulti_Dense;
   S->ops->lastflag   = SUNLinSolLastFlag_Dense;
   S->ops->space      = SUNLinSolSpace_Dense;
   S->ops->free       = SUNLinSolFree_Dense;
@@ -96,6 +100,9 @@ SUNLinearSolver SUNLinSol_Dense(SUNDIALS_MAYBE_UNUSED N_Vector y, SUNMatrix A,
   content->pivots = (sunindextype*)malloc(MatrixRows * sizeof(sunindextype));
   SUNAssertNull(content->pivots, SUN_ERR_MALLOC_FAIL);
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_LINEARSOLVER,
+                     sizeof *content + MatrixRows * sizeof(sunindextype));
+
   return (S);
 }
 
@@ -179,6 +186,45 @@ int SUNLinSolSolve_Dense(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
   return SUN_SUCCESS;
 }
 
+int SUNLinSolSolveMulti_Dense(SUNLinearSolver S, SUNMatrix A, int nrhs,
+                              N_Vector* X, N_Vector* B,
+                              SUNDIALS_MAYBE_UNUSED sunrealtype tol)
+{
+  SUNFunctionBegin(S->sunctx);
+  sunrealtype **A_cols, *xdata[RHS_BLOCK];
+  sunindextype* pivots;
+  int i, j, nb;
+
+  /* access data pointers (return with failure on NULL) */
+  A_cols = NULL;
+  pivots = NULL;
+  A_cols = SUNDenseMatrix_Cols(A);
+  SUNCheckLastErr();
+  pivots = PIVOTS(S);
+
+  SUNAssert(A_cols, SUN_ERR_ARG_CORRUPT);
+  SUNAssert(pivots, SUN_ERR_ARG_CORRUPT);
+
+  /* solve blocks of right-hand sides using LU factors, so each column of the
+     factors is loaded once per block */
+  for (i = 0; i < nrhs; i += RHS_BLOCK)
+  {
+    nb = SUNMIN(RHS_BLOCK, nrhs - i);
+    for (j = 0; j < nb; j++)
+    {
+      /* copy b into x */
+      N_VScale(ONE, B[i + j], X[i + j]);
+      SUNCheckLastErr();
+      xdata[j] = N_VGetArrayPointer(X[i + j]);
+      SUNCheckLastErr();
+      SUNAssert(xdata[j], SUN_ERR_ARG_CORRUPT);
+    }
+    SUNDlsMat_denseGETRSMulti(A_cols, SUNDenseMatrix_Rows(A), pivots, nb, xdata);
+  }
+  LASTFLAG(S) = SUN_SUCCESS;
+  return SUN_SUCCESS;
+}
+
 sunindextype SUNLinSolLastFlag_Dense(SUNLinearSolver S)
 {
   /* return the stored 'last_flag' value */
@@ -203,6 +249,9 @@ SUNErrCode SUNLinSolFree_Dense(SUNLinearSolver S)
   /* delete items from contents, then delete generic structure */
   if (S->content)
   {
+    sunMemAccountFree(S->sunctx, SUN_MEMSUBSYSTEM_LINEARSOLVER,
+                      sizeof(struct _SUNLinearSolverContent_Dense) +
+                        DENSE_CONTENT(S)->N * sizeof(sunindextype));
     if (PIVOTS(S))
     {
       free(PIVOTS(S));
@@ -44,6 +44,8 @@
 #define NUMERIC(S)        (KLU_CONTENT(S)->numeric)
 #define COMMON(S)         (KLU_CONTENT(S)->common)
 #define SOLVE(S)          (KLU_CONTENT(S)->klu_solver)
+#define RHS(S)            (KLU_CONTENT(S)->rhs)
+#define LRHS(S)           (KLU_CONTENT(S)->lrhs)
 
 /*
  * -----------------------------------------------------------------
@@ -86,6 +88,7 @@ SUNLinearSolver SUNLinSol_KLU(N_Vector y, SUNMatrix A, SUNContext sunctx)
   S->ops->initialize = SUNLinSolInitialize_KLU;
   S->ops->setup      = SUNLinSolSetup_KLU;
   S->ops->solve      = SUNLinSolSolve_KLU;
+  S->ops->solvemulti = SUNLinSolSolveMulti_KLU;
   S->ops->lastflag   = SUNLinSolLastFlag_KLU;
   S->ops->space      = SUNLinSolSpace_KLU;
   S->ops->free       = SUNLinSolFree_KLU;
@@ -107,6 +110,8 @@ SUNLinearSolver SUNLinSol_KLU(N_Vector y, SUNMatrix A, SUNContext sunctx)
   content->first_factorize = 1;
   content->symbolic        = NULL;
   content->numeric         = NULL;
+  content->rhs             = NULL;
+  content->lrhs            = 0;
 
 #if defined(SUNDIALS_INT64_T)
   if (SUNSparseMatrix_SparseType(A) == CSC_MAT)
@@ -377,15 +382,83 @@ int SUNLinSolSolve_KLU(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b,
   return (LASTFLAG(S));
 }
 
+int SUNLinSolSolveMulti_KLU(SUNLinearSolver S, SUNMatrix A, int nrhs,
+                            N_Vector* X, N_Vector* B,
+                            SUNDIALS_MAYBE_UNUSED sunrealtype tol)
+{
+  int flag, j;
+  sunindextype n, i;
+  sunrealtype *data, *col;
+
+  /* check for valid inputs */
+  if ((A == NULL) || (S == NULL) || (X == NULL) || (B == NULL))
+  {
+    return SUN_ERR_ARG_CORRUPT;
+  }
+
+  n = SUNSparseMatrix_NP(A);
+
+  /* grow the workspace for the right-hand sides (if necessary) */
+  if (LRHS(S) < n * nrhs)
+  {
+    free(RHS(S));
+    LRHS(S) = 0;
+    RHS(S)  = (sunrealtype*)malloc(n * nrhs * sizeof(sunrealtype));
+    if (RHS(S) == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return (LASTFLAG(S));
+    }
+    LRHS(S) = n * nrhs;
+  }
+
+  /* copy the right-hand sides into the columns of the workspace */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(B[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return (LASTFLAG(S));
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { col[i] = data[i]; }
+  }
+
+  /* Call KLU to solve the linear systems together */
+  flag = SOLVE(S)(SYMBOLIC(S), NUMERIC(S), n, nrhs, RHS(S), &COMMON(S));
+  if (flag == 0)
+  {
+    LASTFLAG(S) = SUNLS_PACKAGE_FAIL_REC;
+    return (LASTFLAG(S));
+  }
+
+  /* copy the solutions into x */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(X[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return (LASTFLAG(S));
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { data[i] = col[i]; }
+  }
+
+  LASTFLAG(S) = SUN_SUCCESS;
+  return (LASTFLAG(S));
+}
+
 sunindextype SUNLinSolLastFlag_KLU(SUNLinearSolver S) { return (LASTFLAG(S)); }
 
-SUNErrCode SUNLinSolSpace_KLU(SUNDIALS_MAYBE_UNUSED SUNLinearSolver S,
-                              long int* lenrwLS, long int* leniwLS)
+SUNErrCode SUNLinSolSpace_KLU(SUNLinearSolver S, long int* lenrwLS,
+                              long int* leniwLS)
 {
   /* since the klu structures are opaque objects, we
      omit those from these results */
-  *leniwLS = 2;
-  *lenrwLS = 0;
+  *leniwLS = 3;
+  *lenrwLS = LRHS(S);
   return SUN_SUCCESS;
 }
 
@@ -399,6 +472,7 @@ SUNErrCode SUNLinSolFree_KLU(SUNLinearSolver S)
   {
     if (NUMERIC(S)) { sun_klu_free_numeric(&NUMERIC(S), &COMMON(S)); }
     if (SYMBOLIC(S)) { sun_klu_free_symbolic(&SYMBOLIC(S), &COMMON(S)); }
+    free(RHS(S));
     free(S->content);
     S->content = NULL;
   }
@@ -48,6 +48,8 @@
 #define LAPACKBAND_CONTENT(S) ((SUNLinearSolverContent_LapackBand)(S->content))
 #define PIVOTS(S)             (LAPACKBAND_CONTENT(S)->pivots)
 #define LASTFLAG(S)           (LAPACKBAND_CONTENT(S)->last_flag)
+#define RHS(S)                (LAPACKBAND_CONTENT(S)->rhs)
+#define NRHS(S)               (LAPACKBAND_CONTENT(S)->nrhs)
 
 /*
  * -----------------------------------------------------------------
@@ -91,6 +93,7 @@ SUNLinearSolver SUNLinSol_LapackBand(N_Vector y, SUNMatrix A, SUNContext sunctx)
   S->ops->initialize = SUNLinSolInitialize_LapackBand;
   S->ops->setup      = SUNLinSolSetup_LapackBand;
   S->ops->solve      = SUNLinSolSolve_LapackBand;
+  S->ops->solvemulti = SUNLinSolSolveMulti_LapackBand;
   S->ops->lastflag   = SUNLinSolLastFlag_LapackBand;
   S->ops->space      = SUNLinSolSpace_LapackBand;
   S->ops->free       = SUNLinSolFree_LapackBand;
@@ -111,6 +114,8 @@ SUNLinearSolver SUNLinSol_LapackBand(N_Vector y, SUNMatrix A, SUNContext sunctx)
   content->N         = MatrixRows;
   content->last_flag = 0;
   content->pivots    = NULL;
+  content->rhs       = NULL;
+  content->nrhs      = 0;
 
   /* Allocate content */
   content->pivots = (sunindextype*)malloc(MatrixRows * sizeof(sunindextype));
@@ -214,6 +219,77 @@ int SUNLinSolSolve_LapackBand(SUNLinearSolver S, SUNMatrix A, N_Vector x,
   return SUN_SUCCESS;
 }
 
+int SUNLinSolSolveMulti_LapackBand(SUNLinearSolver S, SUNMatrix A, int nrhs,
+                                   N_Vector* X, N_Vector* B,
+                                   SUNDIALS_MAYBE_UNUSED sunrealtype tol)
+{
+  sunindextype n, ml, mu, ldim, nr, ier, i;
+  sunrealtype *data, *col;
+  int j;
+
+  /* check for valid inputs */
+  if ((A == NULL) || (S == NULL) || (X == NULL) || (B == NULL))
+  {
+    return SUN_ERR_ARG_CORRUPT;
+  }
+
+  n    = SUNBandMatrix_Rows(A);
+  ml   = SUNBandMatrix_LowerBandwidth(A);
+  mu   = SUNBandMatrix_UpperBandwidth(A);
+  ldim = SUNBandMatrix_LDim(A);
+
+  /* grow the workspace for the right-hand sides (if necessary) */
+  if (NRHS(S) < nrhs)
+  {
+    free(RHS(S));
+    NRHS(S) = 0;
+    RHS(S)  = (sunrealtype*)malloc(n * nrhs * sizeof(sunrealtype));
+    if (RHS(S) == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    NRHS(S) = nrhs;
+  }
+
+  /* copy the right-hand sides into the columns of the workspace */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(B[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { col[i] = data[i]; }
+  }
+
+  /* Call LAPACK to solve the linear systems together */
+  nr  = nrhs;
+  ier = 0;
+  xgbtrs_f77("N", &n, &ml, &mu, &nr, SUNBandMatrix_Data(A), &ldim, PIVOTS(S),
+             RHS(S), &n, &ier);
+  LASTFLAG(S) = ier;
+  if (ier < 0) { return SUN_ERR_EXT_FAIL; }
+
+  /* copy the solutions into x */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(X[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { data[i] = col[i]; }
+  }
+
+  LASTFLAG(S) = SUN_SUCCESS;
+  return SUN_SUCCESS;
+}
+
 sunindextype SUNLinSolLastFlag_LapackBand(SUNLinearSolver S)
 {
   return (LASTFLAG(S));
@@ -222,8 +298,8 @@ sunindextype SUNLinSolLastFlag_LapackBand(SUNLinearSolver S)
 SUNErrCode SUNLinSolSpace_LapackBand(SUNLinearSolver S, long int* lenrwLS,
                                      long int* leniwLS)
 {
-  *lenrwLS = 0;
-  *leniwLS = 2 + LAPACKBAND_CONTENT(S)->N;
+  *lenrwLS = LAPACKBAND_CONTENT(S)->N * NRHS(S);
+  *leniwLS = 3 + LAPACKBAND_CONTENT(S)->N;
   return SUN_SUCCESS;
 }
 
@@ -240,6 +316,11 @@ SUNErrCode SUNLinSolFree_LapackBand(SUNLinearSolver S)
       free(PIVOTS(S));
       PIVOTS(S) = NULL;
     }
+    if (RHS(S))
+    {
+      free(RHS(S));
+      RHS(S) = NULL;
+    }
     free(S->content);
     S->content = NULL;
   }
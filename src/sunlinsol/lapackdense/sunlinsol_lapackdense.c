@@ -49,6 +49,8 @@
   ((SUNLinearSolverContent_LapackDense)(S->content))
 #define PIVOTS(S)   (LAPACKDENSE_CONTENT(S)->pivots)
 #define LASTFLAG(S) (LAPACKDENSE_CONTENT(S)->last_flag)
+#define RHS(S)      (LAPACKDENSE_CONTENT(S)->rhs)
+#define NRHS(S)     (LAPACKDENSE_CONTENT(S)->nrhs)
 
 /*
  * -----------------------------------------------------------------
@@ -92,6 +94,7 @@ SUNLinearSolver SUNLinSol_LapackDense(N_Vector y, SUNMatrix A, SUNContext sunctx
   S->ops->initialize = SUNLinSolInitialize_LapackDense;
   S->ops->setup      = SUNLinSolSetup_LapackDense;
   S->ops->solve      = SUNLinSolSolve_LapackDense;
+  S->ops->solvemulti = SUNLinSolSolveMulti_LapackDense;
   S->ops->lastflag   = SUNLinSolLastFlag_LapackDense;
   S->ops->space      = SUNLinSolSpace_LapackDense;
   S->ops->free       = SUNLinSolFree_LapackDense;
@@ -112,6 +115,8 @@ SUNLinearSolver SUNLinSol_LapackDense(N_Vector y, SUNMatrix A, SUNContext sunctx
   content->N         = MatrixRows;
   content->last_flag = 0;
   content->pivots    = NULL;
+  content->rhs       = NULL;
+  content->nrhs      = 0;
 
   /* Allocate content */
   content->pivots = (sunindextype*)malloc(MatrixRows * sizeof(sunindextype));
@@ -207,6 +212,74 @@ int SUNLinSolSolve_LapackDense(SUNLinearSolver S, SUNMatrix A, N_Vector x,
   return SUN_SUCCESS;
 }
 
+int SUNLinSolSolveMulti_LapackDense(SUNLinearSolver S, SUNMatrix A, int nrhs,
+                                    N_Vector* X, N_Vector* B,
+                                    SUNDIALS_MAYBE_UNUSED sunrealtype tol)
+{
+  sunindextype n, nr, ier, i;
+  sunrealtype *data, *col;
+  int j;
+
+  /* check for valid inputs */
+  if ((A == NULL) || (S == NULL) || (X == NULL) || (B == NULL))
+  {
+    return SUN_ERR_ARG_CORRUPT;
+  }
+
+  n = SUNDenseMatrix_Rows(A);
+
+  /* grow the workspace for the right-hand sides (if necessary) */
+  if (NRHS(S) < nrhs)
+  {
+    free(RHS(S));
+    NRHS(S) = 0;
+    RHS(S)  = (sunrealtype*)malloc(n * nrhs * sizeof(sunrealtype));
+    if (RHS(S) == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    NRHS(S) = nrhs;
+  }
+
+  /* copy the right-hand sides into the columns of the workspace */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(B[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { col[i] = data[i]; }
+  }
+
+  /* Call LAPACK to solve the linear systems together */
+  nr  = nrhs;
+  ier = 0;
+  xgetrs_f77("N", &n, &nr, SUNDenseMatrix_Data(A), &n, PIVOTS(S), RHS(S), &n,
+             &ier);
+  LASTFLAG(S) = ier;
+  if (ier < 0) { return SUN_ERR_EXT_FAIL; }
+
+  /* copy the solutions into x */
+  for (j = 0; j < nrhs; j++)
+  {
+    data = N_VGetArrayPointer(X[j]);
+    if (data == NULL)
+    {
+      LASTFLAG(S) = SUN_ERR_MEM_FAIL;
+      return SUN_ERR_MEM_FAIL;
+    }
+    col = RHS(S) + j * n;
+    for (i = 0; i < n; i++) { data[i] = col[i]; }
+  }
+
+  LASTFLAG(S) = SUN_SUCCESS;
+  return SUN_SUCCESS;
+}
+
 sunindextype SUNLinSolLastFlag_LapackDense(SUNLinearSolver S)
 {
   return (LASTFLAG(S));
@@ -215,8 +288,8 @@ sunindextype SUNLinSolLastFlag_LapackDense(SUNLinearSolver S)
 SUNErrCode SUNLinSolSpace_LapackDense(SUNLinearSolver S, long int* lenrwLS,
                                       long int* leniwLS)
 {
-  *lenrwLS = 0;
-  *leniwLS = 2 + LAPACKDENSE_CONTENT(S)->N;
+  *lenrwLS = LAPACKDENSE_CONTENT(S)->N * NRHS(S);
+  *leniwLS = 3 + LAPACKDENSE_CONTENT(S)->N;
   return SUN_SUCCESS;
 }
 
@@ -233,6 +306,11 @@ SUNErrCode SUNLinSolFree_LapackDense(SUNLinearSolver S)
       free(PIVOTS(S));
       PIVOTS(S) = NULL;
     }
+    if (RHS(S))
+    {
+      free(RHS(S));
+      RHS(S) = NULL;
+    }
     free(S->content);
     S->content = NULL;
   }
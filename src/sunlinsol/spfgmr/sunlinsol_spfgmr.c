@@ -39,6 +39,10 @@
 #define SPFGMR_CONTENT(S) ((SUNLinearSolverContent_SPFGMR)(S->content))
 #define LASTFLAG(S)       (SPFGMR_CONTENT(S)->last_flag)
 
+/* private function to perform the solve with the Krylov bases in place */
+static int spfgmrSolve(SUNLinearSolver S, N_Vector x, N_Vector b,
+                       sunrealtype delta);
+
 /*
  * -----------------------------------------------------------------
  * exported functions
@@ -92,6 +96,7 @@ SUNLinearSolver SUNLinSol_SPFGMR(N_Vector y, int pretype, int maxl,
   S->ops->resid             = SUNLinSolResid_SPFGMR;
   S->ops->lastflag          = SUNLinSolLastFlag_SPFGMR;
   S->ops->space             = SUNLinSolSpace_SPFGMR;
+  S->ops->scratchspace      = SUNLinSolScratchSpace_SPFGMR;
   S->ops->free              = SUNLinSolFree_SPFGMR;
 
   /* Create content */
@@ -128,6 +133,9 @@ SUNLinearSolver SUNLinSol_SPFGMR(N_Vector y, int pretype, int maxl,
   content->cv           = NULL;
   content->Xv           = NULL;
 
+  /* Borrow the Krylov bases from the context if scratch sharing is enabled */
+  SUNCheckCallNull(SUNContext_GetScratchSharing(sunctx, &(content->scratch_V)));
+
   /* Allocate content */
   content->xcor = N_VClone(y);
   SUNCheckLastErrNull();
@@ -234,15 +242,31 @@ SUNErrCode SUNLinSolInitialize_SPFGMR(SUNLinearSolver S)
   /*   Krylov subspace vectors */
   if (content->V == NULL)
   {
-    content->V = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
-    SUNCheckLastErr();
+    if (content->scratch_V)
+    {
+      content->V = (N_Vector*)calloc(content->maxl + 1, sizeof(N_Vector));
+      SUNAssert(content->V, SUN_ERR_MALLOC_FAIL);
+    }
+    else
+    {
+      content->V = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
+      SUNCheckLastErr();
+    }
   }
 
   /*   Preconditioned basis vectors */
   if (content->Z == NULL)
   {
-    content->Z = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
-    SUNCheckLastErr();
+    if (content->scratch_V)
+    {
+      content->Z = (N_Vector*)calloc(content->maxl + 1, sizeof(N_Vector));
+      SUNAssert(content->Z, SUN_ERR_MALLOC_FAIL);
+    }
+    else
+    {
+      content->Z = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
+      SUNCheckLastErr();
+    }
   }
 
   /*   Hessenberg matrix Hes */
@@ -365,6 +389,38 @@ int SUNLinSolSolve_SPFGMR(SUNLinearSolver S, SUNDIALS_MAYBE_UNUSED SUNMatrix A,
                           N_Vector x, N_Vector b, sunrealtype delta)
 {
   SUNFunctionBegin(S->sunctx);
+  int status;
+
+  if (!SPFGMR_CONTENT(S)->scratch_V) { return spfgmrSolve(S, x, b, delta); }
+
+  /* borrow the Krylov bases from the context for the length of the solve */
+  SUNCheckCall(N_VBorrowScratchVectorArray(SPFGMR_CONTENT(S)->maxl + 1,
+                                           SPFGMR_CONTENT(S)->vtemp,
+                                           SPFGMR_CONTENT(S)->V));
+  status = N_VBorrowScratchVectorArray(SPFGMR_CONTENT(S)->maxl + 1,
+                                       SPFGMR_CONTENT(S)->vtemp,
+                                       SPFGMR_CONTENT(S)->Z);
+  if (status)
+  {
+    SUNCheckCall(N_VReturnScratchVectorArray(SPFGMR_CONTENT(S)->maxl + 1,
+                                             SPFGMR_CONTENT(S)->V));
+    SUNCheckCall(status);
+  }
+
+  status = spfgmrSolve(S, x, b, delta);
+
+  SUNCheckCall(N_VReturnScratchVectorArray(SPFGMR_CONTENT(S)->maxl + 1,
+                                           SPFGMR_CONTENT(S)->Z));
+  SUNCheckCall(N_VReturnScratchVectorArray(SPFGMR_CONTENT(S)->maxl + 1,
+                                           SPFGMR_CONTENT(S)->V));
+
+  return status;
+}
+
+static int spfgmrSolve(SUNLinearSolver S, N_Vector x, N_Vector b,
+                       sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
 
   /* local data and shortcut variables */
   N_Vector *V, *Z, xcor, vtemp, s1, s2;
@@ -750,7 +806,7 @@ SUNErrCode SUNLinSolSpace_SPFGMR(SUNLinearSolver S, long int* lenrwLS,
                                  long int* leniwLS)
 {
   SUNFunctionBegin(S->sunctx);
-  int maxl;
+  int maxl, nvecs;
   sunindextype liw1, lrw1;
   maxl = SPFGMR_CONTENT(S)->maxl;
   if (SPFGMR_CONTENT(S)->vtemp->ops->nvspace)
@@ -759,8 +815,26 @@ SUNErrCode SUNLinSolSpace_SPFGMR(SUNLinearSolver S, long int* lenrwLS,
     SUNCheckLastErr();
   }
   else { lrw1 = liw1 = 0; }
-  *lenrwLS = lrw1 * (2 * maxl + 4) + maxl * (maxl + 5) + 2;
-  *leniwLS = liw1 * (2 * maxl + 4);
+  nvecs = SPFGMR_CONTENT(S)->scratch_V ? 2 : 2 * maxl + 4;
+  *lenrwLS = lrw1 * nvecs + maxl * (maxl + 5) + 2;
+  *leniwLS = liw1 * nvecs;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNLinSolScratchSpace_SPFGMR(SUNLinearSolver S, long int* lenrwLS,
+                                        long int* leniwLS)
+{
+  SUNFunctionBegin(S->sunctx);
+  sunindextype liw1, lrw1;
+  *lenrwLS = 0;
+  *leniwLS = 0;
+  if (SPFGMR_CONTENT(S)->scratch_V && SPFGMR_CONTENT(S)->vtemp->ops->nvspace)
+  {
+    N_VSpace(SPFGMR_CONTENT(S)->vtemp, &lrw1, &liw1);
+    SUNCheckLastErr();
+    *lenrwLS = lrw1 * 2 * (SPFGMR_CONTENT(S)->maxl + 1);
+    *leniwLS = liw1 * 2 * (SPFGMR_CONTENT(S)->maxl + 1);
+  }
   return SUN_SUCCESS;
 }
 
@@ -785,12 +859,22 @@ SUNErrCode SUNLinSolFree_SPFGMR(SUNLinearSolver S)
     }
     if (SPFGMR_CONTENT(S)->V)
     {
-      N_VDestroyVectorArray(SPFGMR_CONTENT(S)->V, SPFGMR_CONTENT(S)->maxl + 1);
+      if (SPFGMR_CONTENT(S)->scratch_V) { free(SPFGMR_CONTENT(S)->V); }
+      else
+      {
+        N_VDestroyVectorArray(SPFGMR_CONTENT(S)->V,
+                              SPFGMR_CONTENT(S)->maxl + 1);
+      }
       SPFGMR_CONTENT(S)->V = NULL;
     }
     if (SPFGMR_CONTENT(S)->Z)
     {
-      N_VDestroyVectorArray(SPFGMR_CONTENT(S)->Z, SPFGMR_CONTENT(S)->maxl + 1);
+      if (SPFGMR_CONTENT(S)->scratch_V) { free(SPFGMR_CONTENT(S)->Z); }
+      else
+      {
+        N_VDestroyVectorArray(SPFGMR_CONTENT(S)->Z,
+                              SPFGMR_CONTENT(S)->maxl + 1);
+      }
       SPFGMR_CONTENT(S)->Z = NULL;
     }
     if (SPFGMR_CONTENT(S)->Hes)
@@ -30,6 +30,10 @@
 #define ZERO SUN_RCONST(0.0)
 #define ONE  SUN_RCONST(1.0)
 
+/* relative norm below which a new block Krylov vector is treated as
+   linearly dependent on the previous ones */
+#define BLOCK_DEPTOL (SUN_RCONST(100.0) * SUN_UNIT_ROUNDOFF)
+
 /*
  * -----------------------------------------------------------------
  * SPGMR solver structure accessibility macros:
@@ -39,6 +43,23 @@
 #define SPGMR_CONTENT(S) ((SUNLinearSolverContent_SPGMR)(S->content))
 #define LASTFLAG(S)      (SPGMR_CONTENT(S)->last_flag)
 
+/* private function to perform the solve with the Krylov basis in place */
+static int spgmrSolve(SUNLinearSolver S, N_Vector x, N_Vector b,
+                      sunrealtype delta);
+
+/* private functions for the block solve with several right-hand sides */
+static SUNErrCode spgmrBlockAlloc(SUNLinearSolver S, int nrhs);
+static SUNErrCode spgmrBlockOrth(N_Vector* V, int k, sunrealtype* h,
+                                 sunrealtype* cv, N_Vector* Xv,
+                                 sunrealtype* vnorm0, sunrealtype* vnorm);
+static int spgmrBlockResid(SUNLinearSolver S, N_Vector x, N_Vector b,
+                           N_Vector r, sunbooleantype zeroguess,
+                           sunrealtype delta);
+static int spgmrBlockATimes(SUNLinearSolver S, N_Vector v, N_Vector z,
+                            sunrealtype delta);
+static int spgmrBlockUpdate(SUNLinearSolver S, N_Vector xcor, N_Vector x,
+                            sunbooleantype zeroguess, sunrealtype delta);
+
 /*
  * -----------------------------------------------------------------
  * exported functions
@@ -85,11 +106,13 @@ SUNLinearSolver SUNLinSol_SPGMR(N_Vector y, int pretype, int maxl,
   S->ops->initialize        = SUNLinSolInitialize_SPGMR;
   S->ops->setup             = SUNLinSolSetup_SPGMR;
   S->ops->solve             = SUNLinSolSolve_SPGMR;
+  S->ops->solvemulti        = SUNLinSolSolveMulti_SPGMR;
   S->ops->numiters          = SUNLinSolNumIters_SPGMR;
   S->ops->resnorm           = SUNLinSolResNorm_SPGMR;
   S->ops->resid             = SUNLinSolResid_SPGMR;
   S->ops->lastflag          = SUNLinSolLastFlag_SPGMR;
   S->ops->space             = SUNLinSolSpace_SPGMR;
+  S->ops->scratchspace      = SUNLinSolScratchSpace_SPGMR;
   S->ops->free              = SUNLinSolFree_SPGMR;
 
   /* Create content */
@@ -124,6 +147,15 @@ SUNLinearSolver SUNLinSol_SPGMR(N_Vector y, int pretype, int maxl,
   content->yg           = NULL;
   content->cv           = NULL;
   content->Xv           = NULL;
+  content->nrhs         = 0;
+  content->V_b          = NULL;
+  content->Xv_b         = NULL;
+  content->w_b          = NULL;
+  content->lh_b         = 0;
+  content->h_b          = NULL;
+
+  /* Borrow the Krylov basis from the context if scratch sharing is enabled */
+  SUNCheckCallNull(SUNContext_GetScratchSharing(sunctx, &(content->scratch_V)));
 
   /* Allocate content */
   content->xcor = N_VClone(y);
@@ -226,11 +258,19 @@ SUNErrCode SUNLinSolInitialize_SPGMR(SUNLinearSolver S)
   /* allocate solver-specific memory (where the size depends on the
      choice of maxl) here */
 
-  /*   Krylov subspace vectors */
+  /*   Krylov subspace vectors (only the array when borrowed during solves) */
   if (content->V == NULL)
   {
-    content->V = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
-    SUNCheckLastErr();
+    if (content->scratch_V)
+    {
+      content->V = (N_Vector*)calloc(content->maxl + 1, sizeof(N_Vector));
+      SUNAssert(content->V, SUN_ERR_MALLOC_FAIL);
+    }
+    else
+    {
+      content->V = N_VCloneVectorArray(content->maxl + 1, content->vtemp);
+      SUNCheckLastErr();
+    }
   }
 
   /*   Hessenberg matrix Hes */
@@ -350,6 +390,27 @@ int SUNLinSolSolve_SPGMR(SUNLinearSolver S, SUNDIALS_MAYBE_UNUSED SUNMatrix A,
                          N_Vector x, N_Vector b, sunrealtype delta)
 {
   SUNFunctionBegin(S->sunctx);
+  int status;
+
+  if (!SPGMR_CONTENT(S)->scratch_V) { return spgmrSolve(S, x, b, delta); }
+
+  /* borrow the Krylov basis from the context for the length of the solve */
+  SUNCheckCall(N_VBorrowScratchVectorArray(SPGMR_CONTENT(S)->maxl + 1,
+                                           SPGMR_CONTENT(S)->vtemp,
+                                           SPGMR_CONTENT(S)->V));
+
+  status = spgmrSolve(S, x, b, delta);
+
+  SUNCheckCall(N_VReturnScratchVectorArray(SPGMR_CONTENT(S)->maxl + 1,
+                                           SPGMR_CONTENT(S)->V));
+
+  return status;
+}
+
+static int spgmrSolve(SUNLinearSolver S, N_Vector x, N_Vector b,
+                      sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
 
   /* local data and shortcut variables */
   N_Vector *V, xcor, vtemp, s1, s2;
@@ -819,6 +880,543 @@ int SUNLinSolSolve_SPGMR(SUNLinearSolver S, SUNDIALS_MAYBE_UNUSED SUNMatrix A,
   return (LASTFLAG(S));
 }
 
+int SUNLinSolSolveMulti_SPGMR(SUNLinearSolver S, SUNMatrix A, int nrhs,
+                              N_Vector* X, N_Vector* B, sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
+
+  /* local data and shortcut variables */
+  N_Vector *V, *Rv, *Xv, xcor;
+  sunrealtype *G0, *res, *cv, *H, *R, *G, *Y, *givens, *res_norm;
+  sunrealtype vnorm0, vnorm, rho, beta, a, b, r, cs, sn;
+  sunbooleantype zeroguess, converged, breakdown;
+  int i, j, k, l, c, s, t, p, q, m, nb, nc, J, ntries, max_restarts, status;
+  long int lh;
+  int* nli;
+
+  /* a single right-hand side uses the standard solve */
+  if (nrhs == 1) { return SUNLinSolSolve_SPGMR(S, A, X[0], B[0], delta); }
+
+  SUNAssert(nrhs > 1, SUN_ERR_ARG_OUTOFRANGE);
+  SUNAssert(SPGMR_CONTENT(S)->ATimes, SUN_ERR_ARG_CORRUPT);
+  SUNAssert((SPGMR_CONTENT(S)->pretype == SUN_PREC_NONE) ||
+              SPGMR_CONTENT(S)->Psolve,
+            SUN_ERR_ARG_CORRUPT);
+
+  /* Make local shortcuts to solver variables. */
+  p            = nrhs;
+  m            = SPGMR_CONTENT(S)->maxl;
+  max_restarts = SPGMR_CONTENT(S)->max_restarts;
+  xcor         = SPGMR_CONTENT(S)->xcor;
+  zeroguess    = SPGMR_CONTENT(S)->zeroguess;
+  nli          = &(SPGMR_CONTENT(S)->numiters);
+  res_norm     = &(SPGMR_CONTENT(S)->resnorm);
+
+  /* the zero guess flag only applies to this solve */
+  SPGMR_CONTENT(S)->zeroguess = SUNFALSE;
+
+  /* Initialize counters and convergence flag */
+  *nli      = 0;
+  converged = SUNFALSE;
+  beta = rho = ZERO;
+
+  /* Grow the block workspace (if necessary) and set shortcuts into it */
+  SUNCheckCall(spgmrBlockAlloc(S, p));
+  V   = SPGMR_CONTENT(S)->V_b;
+  Rv  = V + (m + 1) * p;
+  Xv  = SPGMR_CONTENT(S)->Xv_b;
+  G0  = SPGMR_CONTENT(S)->w_b;
+  res = G0 + p * p;
+  cv  = res + p;
+
+  SUNLogInfo(S->sunctx->logger, "linear-solver", "solver = spgmr, nrhs = %i",
+             p);
+
+  /* Set Rv[c] to the initial residuals s1 P1_inv (b_c - A x_c) */
+  for (c = 0; c < p; c++)
+  {
+    status = spgmrBlockResid(S, X[c], B[c], Rv[c], zeroguess, delta);
+    if (status != SUN_SUCCESS) { return (status); }
+  }
+
+  /* Begin outer iterations: up to (max_restarts + 1) attempts */
+  for (ntries = 0; ntries <= max_restarts; ntries++)
+  {
+    /* Orthonormalize the residuals, Rv = V G0, dropping residuals that
+       are linearly dependent on the previous ones. The block size q is
+       the number of remaining basis vectors. */
+    for (i = 0; i < p * p; i++) { G0[i] = ZERO; }
+    q = 0;
+    for (c = 0; c < p; c++)
+    {
+      N_VScale(ONE, Rv[c], V[q]);
+      SUNCheckLastErr();
+      SUNCheckCall(spgmrBlockOrth(V, q, G0 + c * p, cv, Xv, &vnorm0, &vnorm));
+      if (vnorm > BLOCK_DEPTOL * vnorm0)
+      {
+        G0[q + c * p] = vnorm;
+        N_VScale(ONE / vnorm, V[q], V[q]);
+        SUNCheckLastErr();
+        q++;
+      }
+    }
+
+    /* Residual norms, return if all are small */
+    rho = ZERO;
+    for (c = 0; c < p; c++)
+    {
+      res[c] = ZERO;
+      for (i = 0; i < q; i++) { res[c] += G0[i + c * p] * G0[i + c * p]; }
+      res[c] = SUNRsqrt(res[c]);
+      rho    = SUNMAX(rho, res[c]);
+    }
+    if (ntries == 0) { beta = rho; }
+    *res_norm = rho;
+
+    if (rho <= delta)
+    {
+      if (zeroguess)
+      {
+        for (c = 0; c < p; c++)
+        {
+          N_VConst(ZERO, X[c]);
+          SUNCheckLastErr();
+        }
+      }
+      converged = SUNTRUE;
+      break;
+    }
+
+    /* Grow the Hessenberg matrix H, its triangular factor R, the rotated
+       right-hand sides G, the coefficients Y, and the Givens rotations */
+    nb = (m + 1) * q;
+    nc = m * q;
+    lh = 2 * (long int)nb * nc + (long int)(nb + nc) * p + 2L * nc * q;
+    if (SPGMR_CONTENT(S)->lh_b < lh)
+    {
+      free(SPGMR_CONTENT(S)->h_b);
+      SPGMR_CONTENT(S)->lh_b = 0;
+      SPGMR_CONTENT(S)->h_b  = (sunrealtype*)malloc(lh * sizeof(sunrealtype));
+      SUNAssert(SPGMR_CONTENT(S)->h_b, SUN_ERR_MALLOC_FAIL);
+      SPGMR_CONTENT(S)->lh_b = lh;
+    }
+    H      = SPGMR_CONTENT(S)->h_b;
+    R      = H + nb * nc;
+    G      = R + nb * nc;
+    Y      = G + nb * p;
+    givens = Y + nc * p;
+
+    for (i = 0; i < nb * nc; i++) { H[i] = ZERO; }
+    for (c = 0; c < p; c++)
+    {
+      for (i = 0; i < nb; i++)
+      {
+        G[i + c * nb] = (i < q) ? G0[i + c * p] : ZERO;
+      }
+    }
+
+    /* Block Arnoldi process: basis vector V[j+q] comes from A-tilde V[j],
+       so H is upper Hessenberg with q subdiagonals. J is the number of
+       columns of H in the least squares problem. */
+    J         = 0;
+    breakdown = SUNFALSE;
+    for (s = 0; (s < m) && !converged && !breakdown; s++)
+    {
+      (*nli)++;
+
+      /* Apply A-tilde = s1 P1_inv A P2_inv s2_inv to the last block */
+      for (c = 0; c < q; c++)
+      {
+        status = spgmrBlockATimes(S, V[s * q + c], V[(s + 1) * q + c], delta);
+        if (status != SUN_SUCCESS) { return (status); }
+      }
+
+      /* Orthogonalize the new vectors and update the QR factorization */
+      for (c = 0; c < q; c++)
+      {
+        j = s * q + c;
+        k = j + q;
+
+        SUNCheckCall(spgmrBlockOrth(V, k, H + j * nb, cv, Xv, &vnorm0, &vnorm));
+        breakdown       = (vnorm <= BLOCK_DEPTOL * vnorm0);
+        H[k + j * nb] = breakdown ? ZERO : vnorm;
+
+        /* Apply the previous Givens rotations to column j */
+        for (i = 0; i <= k; i++) { R[i + j * nb] = H[i + j * nb]; }
+        for (l = 0; l < j; l++)
+        {
+          for (t = q; t > 0; t--)
+          {
+            cs                    = givens[2 * (l * q + t - 1)];
+            sn                    = givens[2 * (l * q + t - 1) + 1];
+            a                     = R[l + t - 1 + j * nb];
+            b                     = R[l + t + j * nb];
+            R[l + t - 1 + j * nb] = cs * a - sn * b;
+            R[l + t + j * nb]     = sn * a + cs * b;
+          }
+        }
+
+        /* Compute the rotations that eliminate the subdiagonal entries */
+        for (t = q; t > 0; t--)
+        {
+          a = R[j + t - 1 + j * nb];
+          b = R[j + t + j * nb];
+          if (b == ZERO)
+          {
+            cs = ONE;
+            sn = ZERO;
+          }
+          else
+          {
+            r                     = SUNRsqrt(a * a + b * b);
+            cs                    = a / r;
+            sn                    = -b / r;
+            R[j + t - 1 + j * nb] = r;
+            R[j + t + j * nb]     = ZERO;
+          }
+          givens[2 * (j * q + t - 1)]     = cs;
+          givens[2 * (j * q + t - 1) + 1] = sn;
+        }
+
+        /* Stop if A-tilde V[j] depends on the previous columns */
+        if (SUNRabs(R[j + j * nb]) <= BLOCK_DEPTOL * vnorm0)
+        {
+          breakdown = SUNTRUE;
+          break;
+        }
+
+        /* Apply the rotations to the right-hand sides */
+        for (t = q; t > 0; t--)
+        {
+          cs = givens[2 * (j * q + t - 1)];
+          sn = givens[2 * (j * q + t - 1) + 1];
+          for (i = 0; i < p; i++)
+          {
+            a                     = G[j + t - 1 + i * nb];
+            b                     = G[j + t + i * nb];
+            G[j + t - 1 + i * nb] = cs * a - sn * b;
+            G[j + t + i * nb]     = sn * a + cs * b;
+          }
+        }
+        J = j + 1;
+
+        /* Update the residual norms; break if convergence test passes */
+        rho = ZERO;
+        for (i = 0; i < p; i++)
+        {
+          res[i] = ZERO;
+          for (l = J; l < J + q; l++)
+          {
+            res[i] += G[l + i * nb] * G[l + i * nb];
+          }
+          res[i] = SUNRsqrt(res[i]);
+          rho    = SUNMAX(rho, res[i]);
+        }
+        *res_norm = rho;
+
+        SUNLogInfo(S->sunctx->logger, "linear-iterate",
+                   "cur-iter = %i, total-iters = %i, res-norm = %.16g", s + 1,
+                   *nli, *res_norm);
+
+        if (rho <= delta)
+        {
+          converged = SUNTRUE;
+          break;
+        }
+        if (breakdown) { break; }
+
+        /* Normalize V[k] with the norm from the orthogonalization */
+        N_VScale(ONE / vnorm, V[k], V[k]);
+        SUNCheckLastErr();
+      }
+    }
+
+    if (J == 0)
+    {
+      LASTFLAG(S) = SUNLS_QRFACT_FAIL;
+
+      SUNLogInfo(S->sunctx->logger, "linear-solver",
+                 "status = failed QR factorization");
+
+      return (LASTFLAG(S));
+    }
+
+    /* Solve R Y = G for the coefficients of the corrections */
+    for (c = 0; c < p; c++)
+    {
+      for (i = J - 1; i >= 0; i--)
+      {
+        a = G[i + c * nb];
+        for (l = i + 1; l < J; l++) { a -= R[i + l * nb] * Y[l + c * nc]; }
+        Y[i + c * nc] = a / R[i + i * nb];
+      }
+    }
+
+    /* Add the corrections V Y to the solutions */
+    for (c = 0; c < p; c++)
+    {
+      SUNCheckCall(N_VLinearCombination(J, Y + c * nc, V, xcor));
+      status = spgmrBlockUpdate(S, xcor, X[c], zeroguess, delta);
+      if (status != SUN_SUCCESS) { return (status); }
+    }
+    zeroguess = SUNFALSE;
+
+    if (converged || (ntries == max_restarts)) { break; }
+
+    /* Restart from the residuals Rv = V (G0 - H Y) */
+    for (c = 0; c < p; c++)
+    {
+      for (i = 0; i < J + q; i++)
+      {
+        a = (i < q) ? G0[i + c * p] : ZERO;
+        for (l = 0; l < J; l++) { a -= H[i + l * nb] * Y[l + c * nc]; }
+        cv[i] = a;
+      }
+      SUNCheckCall(N_VLinearCombination(J + q, cv, V, Rv[c]));
+    }
+  }
+
+  if (converged) { LASTFLAG(S) = SUN_SUCCESS; }
+  else { LASTFLAG(S) = (rho < beta) ? SUNLS_RES_REDUCED : SUNLS_CONV_FAIL; }
+
+  SUNLogInfo(S->sunctx->logger, "linear-solver",
+             "status = %i, total-iters = %i, res-norm = %.16g", LASTFLAG(S),
+             *nli, *res_norm);
+
+  return (LASTFLAG(S));
+}
+
+/* Grow the block workspace to allow nrhs right-hand sides */
+static SUNErrCode spgmrBlockAlloc(SUNLinearSolver S, int nrhs)
+{
+  SUNFunctionBegin(S->sunctx);
+  int m = SPGMR_CONTENT(S)->maxl;
+
+  if (SPGMR_CONTENT(S)->nrhs >= nrhs) { return SUN_SUCCESS; }
+
+  if (SPGMR_CONTENT(S)->V_b)
+  {
+    N_VDestroyVectorArray(SPGMR_CONTENT(S)->V_b,
+                          (m + 2) * SPGMR_CONTENT(S)->nrhs);
+  }
+  free(SPGMR_CONTENT(S)->Xv_b);
+  free(SPGMR_CONTENT(S)->w_b);
+  SPGMR_CONTENT(S)->V_b  = NULL;
+  SPGMR_CONTENT(S)->Xv_b = NULL;
+  SPGMR_CONTENT(S)->w_b  = NULL;
+  SPGMR_CONTENT(S)->nrhs = 0;
+
+  /* (m + 1) * nrhs basis vectors and nrhs residuals */
+  SPGMR_CONTENT(S)->V_b = N_VCloneVectorArray((m + 2) * nrhs,
+                                              SPGMR_CONTENT(S)->vtemp);
+  SUNCheckLastErr();
+
+  SPGMR_CONTENT(S)->Xv_b =
+    (N_Vector*)malloc(((m + 1) * nrhs + 1) * sizeof(N_Vector));
+  SUNAssert(SPGMR_CONTENT(S)->Xv_b, SUN_ERR_MALLOC_FAIL);
+
+  /* residual coefficients, residual norms, and fused op scalars */
+  SPGMR_CONTENT(S)->w_b = (sunrealtype*)malloc(
+    (nrhs * nrhs + nrhs + (m + 1) * nrhs + 1) * sizeof(sunrealtype));
+  SUNAssert(SPGMR_CONTENT(S)->w_b, SUN_ERR_MALLOC_FAIL);
+
+  SPGMR_CONTENT(S)->nrhs = nrhs;
+  return SUN_SUCCESS;
+}
+
+/* Orthogonalize V[k] against V[0], ..., V[k-1] with classical Gram-Schmidt
+   and one reorthogonalization, using fused dot products. The coefficients
+   are returned in h and the norms of V[k] before and after in vnorm0 and
+   vnorm. V[k] is not normalized. */
+static SUNErrCode spgmrBlockOrth(N_Vector* V, int k, sunrealtype* h,
+                                 sunrealtype* cv, N_Vector* Xv,
+                                 sunrealtype* vnorm0, sunrealtype* vnorm)
+{
+  SUNFunctionBegin(V[k]->sunctx);
+  int i, pass;
+
+  /* the last dot product is the squared norm of V[k] */
+  SUNCheckCall(N_VDotProdMulti(k + 1, V[k], V, cv));
+  *vnorm0 = SUNRsqrt(SUNMAX(cv[k], ZERO));
+
+  if (k == 0)
+  {
+    *vnorm = *vnorm0;
+    return SUN_SUCCESS;
+  }
+
+  for (i = 0; i < k; i++) { h[i] = ZERO; }
+
+  Xv[0] = V[k];
+  for (i = 0; i < k; i++) { Xv[i + 1] = V[i]; }
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    if (pass > 0) { SUNCheckCall(N_VDotProdMulti(k, V[k], V, cv)); }
+
+    /* V[k] = V[k] - sum_i cv[i] V[i] */
+    for (i = k; i > 0; i--)
+    {
+      h[i - 1] += cv[i - 1];
+      cv[i] = -cv[i - 1];
+    }
+    cv[0] = ONE;
+    SUNCheckCall(N_VLinearCombination(k + 1, cv, Xv, V[k]));
+  }
+
+  *vnorm = SUNRsqrt(N_VDotProd(V[k], V[k]));
+  SUNCheckLastErr();
+
+  return SUN_SUCCESS;
+}
+
+/* Set r to the scaled and preconditioned residual s1 P1_inv (b - A x) */
+static int spgmrBlockResid(SUNLinearSolver S, N_Vector x, N_Vector b,
+                           N_Vector r, sunbooleantype zeroguess,
+                           sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
+  N_Vector vtemp = SPGMR_CONTENT(S)->vtemp;
+  int pretype    = SPGMR_CONTENT(S)->pretype;
+  int status;
+
+  if (zeroguess)
+  {
+    N_VScale(ONE, b, vtemp);
+    SUNCheckLastErr();
+  }
+  else
+  {
+    status = SPGMR_CONTENT(S)->ATimes(SPGMR_CONTENT(S)->ATData, x, vtemp);
+    if (status != 0)
+    {
+      LASTFLAG(S) = (status < 0) ? SUNLS_ATIMES_FAIL_UNREC
+                                 : SUNLS_ATIMES_FAIL_REC;
+      return (LASTFLAG(S));
+    }
+    N_VLinearSum(ONE, b, -ONE, vtemp, vtemp);
+    SUNCheckLastErr();
+  }
+
+  if ((pretype == SUN_PREC_LEFT) || (pretype == SUN_PREC_BOTH))
+  {
+    N_VScale(ONE, vtemp, r);
+    SUNCheckLastErr();
+    status = SPGMR_CONTENT(S)->Psolve(SPGMR_CONTENT(S)->PData, r, vtemp, delta,
+                                      SUN_PREC_LEFT);
+    if (status != 0)
+    {
+      LASTFLAG(S) = (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC
+                                 : SUNLS_PSOLVE_FAIL_REC;
+      return (LASTFLAG(S));
+    }
+  }
+
+  if (SPGMR_CONTENT(S)->s1) { N_VProd(SPGMR_CONTENT(S)->s1, vtemp, r); }
+  else { N_VScale(ONE, vtemp, r); }
+  SUNCheckLastErr();
+
+  return SUN_SUCCESS;
+}
+
+/* Set z = s1 P1_inv A P2_inv s2_inv v */
+static int spgmrBlockATimes(SUNLinearSolver S, N_Vector v, N_Vector z,
+                            sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
+  N_Vector vtemp = SPGMR_CONTENT(S)->vtemp;
+  int pretype    = SPGMR_CONTENT(S)->pretype;
+  int status;
+
+  if (SPGMR_CONTENT(S)->s2) { N_VDiv(v, SPGMR_CONTENT(S)->s2, vtemp); }
+  else { N_VScale(ONE, v, vtemp); }
+  SUNCheckLastErr();
+
+  if ((pretype == SUN_PREC_RIGHT) || (pretype == SUN_PREC_BOTH))
+  {
+    N_VScale(ONE, vtemp, z);
+    SUNCheckLastErr();
+    status = SPGMR_CONTENT(S)->Psolve(SPGMR_CONTENT(S)->PData, z, vtemp, delta,
+                                      SUN_PREC_RIGHT);
+    if (status != 0)
+    {
+      LASTFLAG(S) = (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC
+                                 : SUNLS_PSOLVE_FAIL_REC;
+      return (LASTFLAG(S));
+    }
+  }
+
+  status = SPGMR_CONTENT(S)->ATimes(SPGMR_CONTENT(S)->ATData, vtemp, z);
+  if (status != 0)
+  {
+    LASTFLAG(S) = (status < 0) ? SUNLS_ATIMES_FAIL_UNREC
+                               : SUNLS_ATIMES_FAIL_REC;
+    return (LASTFLAG(S));
+  }
+
+  if ((pretype == SUN_PREC_LEFT) || (pretype == SUN_PREC_BOTH))
+  {
+    status = SPGMR_CONTENT(S)->Psolve(SPGMR_CONTENT(S)->PData, z, vtemp, delta,
+                                      SUN_PREC_LEFT);
+    if (status != 0)
+    {
+      LASTFLAG(S) = (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC
+                                 : SUNLS_PSOLVE_FAIL_REC;
+      return (LASTFLAG(S));
+    }
+  }
+  else
+  {
+    N_VScale(ONE, z, vtemp);
+    SUNCheckLastErr();
+  }
+
+  if (SPGMR_CONTENT(S)->s1) { N_VProd(SPGMR_CONTENT(S)->s1, vtemp, z); }
+  else { N_VScale(ONE, vtemp, z); }
+  SUNCheckLastErr();
+
+  return SUN_SUCCESS;
+}
+
+/* Add P2_inv s2_inv xcor to x (or set x to it with a zero initial guess) */
+static int spgmrBlockUpdate(SUNLinearSolver S, N_Vector xcor, N_Vector x,
+                            sunbooleantype zeroguess, sunrealtype delta)
+{
+  SUNFunctionBegin(S->sunctx);
+  N_Vector vtemp = SPGMR_CONTENT(S)->vtemp;
+  int pretype    = SPGMR_CONTENT(S)->pretype;
+  int status;
+
+  if (SPGMR_CONTENT(S)->s2)
+  {
+    N_VDiv(xcor, SPGMR_CONTENT(S)->s2, xcor);
+    SUNCheckLastErr();
+  }
+
+  if ((pretype == SUN_PREC_RIGHT) || (pretype == SUN_PREC_BOTH))
+  {
+    status = SPGMR_CONTENT(S)->Psolve(SPGMR_CONTENT(S)->PData, xcor, vtemp,
+                                      delta, SUN_PREC_RIGHT);
+    if (status != 0)
+    {
+      LASTFLAG(S) = (status < 0) ? SUNLS_PSOLVE_FAIL_UNREC
+                                 : SUNLS_PSOLVE_FAIL_REC;
+      return (LASTFLAG(S));
+    }
+  }
+  else
+  {
+    N_VScale(ONE, xcor, vtemp);
+    SUNCheckLastErr();
+  }
+
+  if (zeroguess) { N_VScale(ONE, vtemp, x); }
+  else { N_VLinearSum(ONE, x, ONE, vtemp, x); }
+  SUNCheckLastErr();
+
+  return SUN_SUCCESS;
+}
+
 int SUNLinSolNumIters_SPGMR(SUNLinearSolver S)
 {
   return (SPGMR_CONTENT(S)->numiters);
@@ -843,17 +1441,39 @@ SUNErrCode SUNLinSolSpace_SPGMR(SUNLinearSolver S, long int* lenrwLS,
                                 long int* leniwLS)
 {
   SUNFunctionBegin(S->sunctx);
-  int maxl;
+  int maxl, nrhs, nvecs;
   sunindextype liw1, lrw1;
   maxl = SPGMR_CONTENT(S)->maxl;
+  nrhs = SPGMR_CONTENT(S)->nrhs;
   if (SPGMR_CONTENT(S)->vtemp->ops->nvspace)
   {
     N_VSpace(SPGMR_CONTENT(S)->vtemp, &lrw1, &liw1);
     SUNCheckLastErr();
   }
   else { lrw1 = liw1 = 0; }
-  *lenrwLS = lrw1 * (maxl + 5) + maxl * (maxl + 5) + 2;
-  *leniwLS = liw1 * (maxl + 5);
+  nvecs = SPGMR_CONTENT(S)->scratch_V ? 4 : maxl + 5;
+  /* block workspace allocated by SUNLinSolSolveMulti */
+  nvecs += (maxl + 2) * nrhs;
+  *lenrwLS = lrw1 * nvecs + maxl * (maxl + 5) + 2 + SPGMR_CONTENT(S)->lh_b;
+  if (nrhs > 0) { *lenrwLS += nrhs * nrhs + nrhs + (maxl + 1) * nrhs + 1; }
+  *leniwLS = liw1 * nvecs;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNLinSolScratchSpace_SPGMR(SUNLinearSolver S, long int* lenrwLS,
+                                       long int* leniwLS)
+{
+  SUNFunctionBegin(S->sunctx);
+  sunindextype liw1, lrw1;
+  *lenrwLS = 0;
+  *leniwLS = 0;
+  if (SPGMR_CONTENT(S)->scratch_V && SPGMR_CONTENT(S)->vtemp->ops->nvspace)
+  {
+    N_VSpace(SPGMR_CONTENT(S)->vtemp, &lrw1, &liw1);
+    SUNCheckLastErr();
+    *lenrwLS = lrw1 * (SPGMR_CONTENT(S)->maxl + 1);
+    *leniwLS = liw1 * (SPGMR_CONTENT(S)->maxl + 1);
+  }
   return SUN_SUCCESS;
 }
 
@@ -876,7 +1496,11 @@ SUNErrCode SUNLinSolFree_SPGMR(SUNLinearSolver S)
     }
     if (SPGMR_CONTENT(S)->V)
     {
-      N_VDestroyVectorArray(SPGMR_CONTENT(S)->V, SPGMR_CONTENT(S)->maxl + 1);
+      if (SPGMR_CONTENT(S)->scratch_V) { free(SPGMR_CONTENT(S)->V); }
+      else
+      {
+        N_VDestroyVectorArray(SPGMR_CONTENT(S)->V, SPGMR_CONTENT(S)->maxl + 1);
+      }
       SPGMR_CONTENT(S)->V = NULL;
     }
     if (SPGMR_CONTENT(S)->Hes)
@@ -912,6 +1536,28 @@ SUNErrCode SUNLinSolFree_SPGMR(SUNLinearSolver S)
       free(SPGMR_CONTENT(S)->Xv);
       SPGMR_CONTENT(S)->Xv = NULL;
     }
+    if (SPGMR_CONTENT(S)->V_b)
+    {
+      N_VDestroyVectorArray(SPGMR_CONTENT(S)->V_b,
+                            (SPGMR_CONTENT(S)->maxl + 2) *
+                              SPGMR_CONTENT(S)->nrhs);
+      SPGMR_CONTENT(S)->V_b = NULL;
+    }
+    if (SPGMR_CONTENT(S)->Xv_b)
+    {
+      free(SPGMR_CONTENT(S)->Xv_b);
+      SPGMR_CONTENT(S)->Xv_b = NULL;
+    }
+    if (SPGMR_CONTENT(S)->w_b)
+    {
+      free(SPGMR_CONTENT(S)->w_b);
+      SPGMR_CONTENT(S)->w_b = NULL;
+    }
+    if (SPGMR_CONTENT(S)->h_b)
+    {
+      free(SPGMR_CONTENT(S)->h_b);
+      SPGMR_CONTENT(S)->h_b = NULL;
+    }
     free(S->content);
     S->content = NULL;
   }
@@ -38,6 +38,7 @@ static sunbooleantype compatibleMatrices(SUNMatrix A, SUNMatrix B);
 static sunbooleantype compatibleMatrixAndVectors(SUNMatrix A, N_Vector x,
                                                  N_Vector y);
 static SUNErrCode SMScaleAddNew_Band(sunrealtype c, SUNMatrix A, SUNMatrix B);
+static size_t bandBytes(SUNMatrix A);
 
 /*
  * -----------------------------------------------------------------
@@ -115,6 +116,8 @@ SUNMatrix SUNBandMatrixStorage(sunindextype N, sunindextype mu, sunindextype ml,
   SUNAssertNull(content->cols, SUN_ERR_MALLOC_FAIL);
   for (j = 0; j < N; j++) { content->cols[j] = content->data + j * colSize; }
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_MATRIX, bandBytes(A));
+
   return (A);
 }
 
@@ -253,6 +256,8 @@ void SUNMatDestroy_Band(SUNMatrix A)
   /* free content */
   if (A->content != NULL)
   {
+    sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, bandBytes(A));
+
     /* free data array */
     if (SM_DATA_B(A))
     {
@@ -310,6 +315,7 @@ SUNErrCode SUNMatCopy_Band(SUNMatrix A, SUNMatrix B)
   /* Grow B if A's bandwidth is larger */
   if ((SM_UBAND_B(A) > SM_UBAND_B(B)) || (SM_LBAND_B(A) > SM_LBAND_B(B)))
   {
+    sunMemAccountFree(B->sunctx, SUN_MEMSUBSYSTEM_MATRIX, bandBytes(B));
     ml                     = SUNMAX(SM_LBAND_B(B), SM_LBAND_B(A));
     mu                     = SUNMAX(SM_UBAND_B(B), SM_UBAND_B(A));
     smu                    = SUNMAX(SM_SUBAND_B(B), SM_SUBAND_B(A));
@@ -326,6 +332,7 @@ SUNErrCode SUNMatCopy_Band(SUNMatrix A, SUNMatrix B)
     {
       SM_CONTENT_B(B)->cols[j] = SM_CONTENT_B(B)->data + j * colSize;
     }
+    sunMemAccountAlloc(B->sunctx, SUN_MEMSUBSYSTEM_MATRIX, bandBytes(B));
   }
 
   /* Perform operation */
@@ -433,6 +440,14 @@ SUNErrCode SUNMatSpace_Band(SUNMatrix A, long int* lenrw, long int* leniw)
  * -----------------------------------------------------------------
  */
 
+/* Bytes allocated by the band matrix content for memory accounting */
+static size_t bandBytes(SUNMatrix A)
+{
+  return sizeof(struct _SUNMatrixContent_Band) +
+         SM_LDATA_B(A) * sizeof(sunrealtype) +
+         SM_COLUMNS_B(A) * sizeof(sunrealtype*);
+}
+
 SUNDIALS_MAYBE_UNUSED
 static sunbooleantype compatibleMatrices(SUNMatrix A, SUNMatrix B)
 {
@@ -499,6 +514,7 @@ SUNErrCode SMScaleAddNew_Band(sunrealtype c, SUNMatrix A, SUNMatrix B)
   }
 
   /* replace A contents with C contents, nullify C content pointer, destroy C */
+  sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, bandBytes(A));
   free(SM_DATA_B(A));
   SM_DATA_B(A) = NULL;
   free(SM_COLS_B(A));
@@ -507,7 +523,7 @@ SUNErrCode SMScaleAddNew_Band(sunrealtype c, SUNMatrix A, SUNMatrix B)
   A->content = NULL;
   A->content = C->content;
   C->content = NULL;
-  SUNMatDestroy_Band(C);
+  SUNMatDestroy(C);
 
   return SUN_SUCCESS;
 }
@@ -34,6 +34,7 @@
 static sunbooleantype compatibleMatrices(SUNMatrix A, SUNMatrix B);
 static sunbooleantype compatibleMatrixAndVectors(SUNMatrix A, N_Vector x,
                                                  N_Vector y);
+static size_t denseBytes(SUNMatrix A);
 
 /*
  * -----------------------------------------------------------------
@@ -94,6 +95,8 @@ SUNMatrix SUNDenseMatrix(sunindextype M, sunindextype N, SUNContext sunctx)
   SUNAssertNull(content->cols, SUN_ERR_MALLOC_FAIL);
   for (j = 0; j < N; j++) { content->cols[j] = content->data + j * M; }
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_MATRIX, denseBytes(A));
+
   return (A);
 }
 
@@ -200,6 +203,8 @@ void SUNMatDestroy_Dense(SUNMatrix A)
   /* free content */
   if (A->content != NULL)
   {
+    sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, denseBytes(A));
+
     /* free data array */
     if (SM_DATA_D(A) != NULL)
     {
@@ -351,6 +356,14 @@ SUNErrCode SUNMatSpace_Dense(SUNMatrix A, long int* lenrw, long int* leniw)
  * -----------------------------------------------------------------
  */
 
+/* Bytes allocated by the dense matrix content for memory accounting */
+static size_t denseBytes(SUNMatrix A)
+{
+  return sizeof(struct _SUNMatrixContent_Dense) +
+         SM_LDATA_D(A) * sizeof(sunrealtype) +
+         SM_COLUMNS_D(A) * sizeof(sunrealtype*);
+}
+
 SUNDIALS_MAYBE_UNUSED
 static sunbooleantype compatibleMatrices(SUNMatrix A, SUNMatrix B)
 {
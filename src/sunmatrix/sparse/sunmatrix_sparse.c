@@ -43,6 +43,7 @@ static sunbooleantype compatibleMatrixAndVectors(SUNMatrix A, N_Vector x,
 static SUNErrCode Matvec_SparseCSC(SUNMatrix A, N_Vector x, N_Vector y);
 static SUNErrCode Matvec_SparseCSR(SUNMatrix A, N_Vector x, N_Vector y);
 static SUNErrCode format_convert(const SUNMatrix A, SUNMatrix B);
+static size_t sparseStorageBytes(SUNMatrix A);
 
 /*
  * -----------------------------------------------------------------
@@ -136,6 +137,9 @@ SUNMatrix SUNSparseMatrix(sunindextype M, sunindextype N, sunindextype NNZ,
   SUNAssertNull(content->indexptrs, SUN_ERR_MALLOC_FAIL);
   content->indexptrs[content->NP] = 0;
 
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_MATRIX,
+                     sizeof *content + sparseStorageBytes(A));
+
   return (A);
 }
 
@@ -344,6 +348,7 @@ SUNErrCode SUNSparseMatrix_Realloc(SUNMatrix A)
   SUNAssert(nzmax >= 0, SUN_ERR_ARG_CORRUPT);
 
   /* perform reallocation */
+  sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(A));
   SM_INDEXVALS_S(A) = (sunindextype*)realloc(SM_INDEXVALS_S(A),
                                              nzmax * sizeof(sunindextype));
   SUNAssert(SM_INDEXVALS_S(A), SUN_ERR_MALLOC_FAIL);
@@ -352,6 +357,7 @@ SUNErrCode SUNSparseMatrix_Realloc(SUNMatrix A)
   SUNAssert(SM_DATA_S(A), SUN_ERR_MALLOC_FAIL);
 
   SM_NNZ_S(A) = nzmax;
+  sunMemAccountAlloc(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(A));
 
   return SUN_SUCCESS;
 }
@@ -370,6 +376,7 @@ SUNErrCode SUNSparseMatrix_Reallocate(SUNMatrix A, sunindextype NNZ)
   SUNAssert(NNZ >= 0, SUN_ERR_ARG_OUTOFRANGE);
 
   /* perform reallocation */
+  sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(A));
   SM_INDEXVALS_S(A) = (sunindextype*)realloc(SM_INDEXVALS_S(A),
                                              NNZ * sizeof(sunindextype));
   SUNAssert(SM_INDEXVALS_S(A), SUN_ERR_MALLOC_FAIL);
@@ -378,6 +385,7 @@ SUNErrCode SUNSparseMatrix_Reallocate(SUNMatrix A, sunindextype NNZ)
   SUNAssert(SM_DATA_S(A), SUN_ERR_MALLOC_FAIL);
 
   SM_NNZ_S(A) = NNZ;
+  sunMemAccountAlloc(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(A));
 
   return SUN_SUCCESS;
 }
@@ -521,6 +529,10 @@ void SUNMatDestroy_Sparse(SUNMatrix A)
   /* free content */
   if (A->content != NULL)
   {
+    sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX,
+                      sizeof(struct _SUNMatrixContent_Sparse) +
+                        sparseStorageBytes(A));
+
     /* free data array */
     if (SM_DATA_S(A))
     {
@@ -591,6 +603,7 @@ SUNErrCode SUNMatCopy_Sparse(SUNMatrix A, SUNMatrix B)
      much memory as we have nonzeros in A */
   if (SM_NNZ_S(B) < A_nz)
   {
+    sunMemAccountFree(B->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(B));
     SM_INDEXVALS_S(B) = (sunindextype*)realloc(SM_INDEXVALS_S(B),
                                                A_nz * sizeof(sunindextype));
     SUNAssert(SM_INDEXVALS_S(B), SUN_ERR_MALLOC_FAIL);
@@ -600,6 +613,7 @@ SUNErrCode SUNMatCopy_Sparse(SUNMatrix A, SUNMatrix B)
     SUNAssert(SM_DATA_S(B), SUN_ERR_MALLOC_FAIL);
 
     SM_NNZ_S(B) = A_nz;
+    sunMemAccountAlloc(B->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(B));
   }
 
   /* zero out B so that copy works correctly */
@@ -900,7 +914,9 @@ SUNErrCode SUNMatScaleAdd_Sparse(sunrealtype c, SUNMatrix A, SUNMatrix B)
     /* indicate end of data */
     Cp[N] = nz;
 
-    /* update A's structure with C's values; nullify C's pointers */
+    /* update A's structure with C's values; nullify C's pointers, the
+       storage of C is already accounted so only A's storage is released */
+    sunMemAccountFree(A->sunctx, SUN_MEMSUBSYSTEM_MATRIX, sparseStorageBytes(A));
     SM_NNZ_S(A) = SM_NNZ_S(C);
 
     free(SM_DATA_S(A));
@@ -916,7 +932,7 @@ SUNErrCode SUNMatScaleAdd_Sparse(sunrealtype c, SUNMatrix A, SUNMatrix B)
     SM_INDEXPTRS_S(C) = NULL;
 
     /* clean up */
-    SUNMatDestroy_Sparse(C);
+    SUNMatDestroy(C);
   }
 
   /* clean up */
@@ -960,6 +976,20 @@ SUNErrCode SUNMatSpace_Sparse(SUNMatrix A, long int* lenrw, long int* leniw)
  * =================================================================
  */
 
+/* -----------------------------------------------------------------
+ * Function to compute the bytes allocated for the sparse matrix arrays
+ * (arrays that have been released are not counted)
+ */
+
+static size_t sparseStorageBytes(SUNMatrix A)
+{
+  size_t bytes = 0;
+  if (SM_DATA_S(A)) { bytes += SM_NNZ_S(A) * sizeof(sunrealtype); }
+  if (SM_INDEXVALS_S(A)) { bytes += SM_NNZ_S(A) * sizeof(sunindextype); }
+  if (SM_INDEXPTRS_S(A)) { bytes += (SM_NP_S(A) + 1) * sizeof(sunindextype); }
+  return bytes;
+}
+
 /* -----------------------------------------------------------------
  * Function to check compatibility of two sparse SUNMatrix objects
  */
@@ -0,0 +1,448 @@
+/* -----------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------
+ * SUNDIALS memory helper implementation that caches host memory
+ * blocks in size classes so that repeated allocations of the same
+ * size are served without calling the system allocator.
+ *
+ * Requests are rounded up to a size class. Classes are spaced four
+ * per power of two (e.g., 64, 80, 96, 112, 128, 160, ...) so at most
+ * 25% of a block is unused. Freed blocks are kept on a per-class free
+ * list (linked through the first bytes of each block) until the total
+ * cached size would exceed the high-water limit, after which blocks
+ * are returned to the system. SUNMemory handles are cached as well.
+ * ----------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sundials/priv/sundials_errors_impl.h>
+#include <sundials/sundials_config.h>
+#include <sundials/sundials_errors.h>
+#include <sundials/sundials_math.h>
+#include <sundials/sundials_memory.h>
+#include <sunmemory/sunmemory_system.h>
+
+#if defined(SUNDIALS_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
+#include "sundials_debug.h"
+#include "sundials_macros.h"
+
+/* Smallest size class (log2 and bytes) */
+#define POOL_MIN_SHIFT 6
+#define POOL_MIN_BLOCK ((size_t)1 << POOL_MIN_SHIFT)
+
+/* Number of size classes per power of two (log2 and count) */
+#define POOL_SUB_SHIFT 2
+#define POOL_SUB_COUNT (1 << POOL_SUB_SHIFT)
+
+/* Number of size classes needed to cover all allowed request sizes */
+#define POOL_NUM_CLASSES \
+  (POOL_SUB_COUNT * (8 * sizeof(size_t) - POOL_MIN_SHIFT) + 1)
+
+/* Largest allowed request so the rounded class size cannot overflow */
+#define POOL_MAX_REQUEST (SIZE_MAX >> 2)
+
+/* Default block alignment (a typical cache line) */
+#define POOL_DEFAULT_ALIGNMENT 64
+
+/* Huge page size used for alignment and madvise */
+#define POOL_HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+struct SUNMemoryHelper_Content_SysPool_
+{
+  /* system allocation statistics */
+  unsigned long num_allocations;
+  unsigned long num_deallocations;
+  size_t bytes_allocated;
+  size_t bytes_high_watermark;
+
+  /* cache statistics */
+  unsigned long num_hits;
+  unsigned long num_misses;
+  size_t bytes_cached;
+
+  /* settings */
+  size_t max_cached_bytes;
+  size_t alignment;
+  sunbooleantype huge_pages;
+
+  /* per size class lists of free blocks and the list of free handles */
+  void* free_blocks[POOL_NUM_CLASSES];
+  SUNMemory free_handles;
+};
+
+typedef struct SUNMemoryHelper_Content_SysPool_ SUNMemoryHelper_Content_SysPool;
+
+#define SUNHELPER_CONTENT(h) ((SUNMemoryHelper_Content_SysPool*)h->content)
+
+/* Private functions */
+static size_t poolClassIndex(size_t mem_size);
+static size_t poolClassSize(size_t index);
+static void* poolSysAlloc(SUNMemoryHelper_Content_SysPool* content, size_t size);
+static void poolSysFree(void* ptr);
+
+SUNMemoryHelper SUNMemoryHelper_SysPool(SUNContext sunctx)
+{
+  SUNFunctionBegin(sunctx);
+
+  SUNMemoryHelper helper;
+  SUNMemoryHelper_Content_SysPool* content;
+
+  /* Allocate the helper */
+  helper = SUNMemoryHelper_NewEmpty(sunctx);
+  SUNCheckLastErrNull();
+
+  /* Set the ops */
+  helper->ops->alloc         = SUNMemoryHelper_Alloc_SysPool;
+  helper->ops->dealloc       = SUNMemoryHelper_Dealloc_SysPool;
+  helper->ops->copy          = SUNMemoryHelper_Copy_SysPool;
+  helper->ops->getallocstats = SUNMemoryHelper_GetAllocStats_SysPool;
+  helper->ops->clone         = SUNMemoryHelper_Clone_SysPool;
+  helper->ops->destroy       = SUNMemoryHelper_Destroy_SysPool;
+
+  /* Attach content */
+  content = (SUNMemoryHelper_Content_SysPool*)malloc(
+    sizeof(SUNMemoryHelper_Content_SysPool));
+  SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+
+  content->num_allocations      = 0;
+  content->num_deallocations    = 0;
+  content->bytes_allocated      = 0;
+  content->bytes_high_watermark = 0;
+  content->num_hits             = 0;
+  content->num_misses           = 0;
+  content->bytes_cached         = 0;
+  content->max_cached_bytes     = SIZE_MAX;
+  content->alignment            = POOL_DEFAULT_ALIGNMENT;
+  content->huge_pages           = SUNFALSE;
+  content->free_handles         = NULL;
+  memset(content->free_blocks, 0, sizeof(content->free_blocks));
+
+  helper->content = content;
+
+  return helper;
+}
+
+SUNErrCode SUNMemoryHelper_SetMaxCachedBytes_SysPool(SUNMemoryHelper helper,
+                                                     size_t max_cached_bytes)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  SUNMemoryHelper_Content_SysPool* content = SUNHELPER_CONTENT(helper);
+
+  content->max_cached_bytes = max_cached_bytes;
+
+  /* release cached blocks, largest first, until the cache fits the limit */
+  size_t i = POOL_NUM_CLASSES;
+  while (i > 0 && content->bytes_cached > max_cached_bytes)
+  {
+    i--;
+    while (content->free_blocks[i] && content->bytes_cached > max_cached_bytes)
+    {
+      size_t csize            = poolClassSize(i);
+      void* block             = content->free_blocks[i];
+      content->free_blocks[i] = *((void**)block);
+      poolSysFree(block);
+      content->bytes_cached -= csize;
+      content->bytes_allocated -= csize;
+      content->num_deallocations++;
+    }
+  }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_SetAlignment_SysPool(SUNMemoryHelper helper,
+                                                size_t alignment)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  /* the alignment must be a power of two that can hold a pointer */
+  SUNAssert(alignment >= sizeof(void*) && !(alignment & (alignment - 1)),
+            SUN_ERR_ARG_OUTOFRANGE);
+
+  /* cached blocks may not satisfy the new alignment */
+  SUNCheckCall(SUNMemoryHelper_Trim_SysPool(helper));
+  SUNHELPER_CONTENT(helper)->alignment = alignment;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_SetHugePages_SysPool(SUNMemoryHelper helper,
+                                                sunbooleantype onoff)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  /* cached blocks were allocated with the previous setting */
+  SUNCheckCall(SUNMemoryHelper_Trim_SysPool(helper));
+  SUNHELPER_CONTENT(helper)->huge_pages = onoff;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_Trim_SysPool(SUNMemoryHelper helper)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  SUNMemoryHelper_Content_SysPool* content = SUNHELPER_CONTENT(helper);
+
+  for (size_t i = 0; i < POOL_NUM_CLASSES; i++)
+  {
+    while (content->free_blocks[i])
+    {
+      void* block             = content->free_blocks[i];
+      content->free_blocks[i] = *((void**)block);
+      poolSysFree(block);
+      content->bytes_allocated -= poolClassSize(i);
+      content->num_deallocations++;
+    }
+  }
+  content->bytes_cached = 0;
+
+  while (content->free_handles)
+  {
+    SUNMemory mem         = content->free_handles;
+    content->free_handles = (SUNMemory)mem->ptr;
+    free(mem);
+  }
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_GetPoolStats_SysPool(SUNMemoryHelper helper,
+                                                unsigned long* num_hits,
+                                                unsigned long* num_misses,
+                                                size_t* bytes_cached)
+{
+  SUNFunctionBegin(helper->sunctx);
+  *num_hits     = SUNHELPER_CONTENT(helper)->num_hits;
+  *num_misses   = SUNHELPER_CONTENT(helper)->num_misses;
+  *bytes_cached = SUNHELPER_CONTENT(helper)->bytes_cached;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_Alloc_SysPool(SUNMemoryHelper helper,
+                                         SUNMemory* memptr, size_t mem_size,
+                                         SUNMemoryType mem_type,
+                                         SUNDIALS_MAYBE_UNUSED void* queue)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  SUNAssert(mem_type == SUNMEMTYPE_HOST, SUN_ERR_ARG_INCOMPATIBLE);
+  SUNAssert(mem_size <= POOL_MAX_REQUEST, SUN_ERR_ARG_OUTOFRANGE);
+
+  SUNMemoryHelper_Content_SysPool* content = SUNHELPER_CONTENT(helper);
+
+  SUNMemory mem = NULL;
+  if (content->free_handles)
+  {
+    mem                   = content->free_handles;
+    content->free_handles = (SUNMemory)mem->ptr;
+  }
+  else
+  {
+    mem = SUNMemoryNewEmpty(helper->sunctx);
+    SUNCheckLastErr();
+  }
+
+  mem->ptr   = NULL;
+  mem->own   = SUNTRUE;
+  mem->type  = mem_type;
+  mem->bytes = mem_size;
+
+  size_t index = poolClassIndex(mem_size);
+  size_t csize = poolClassSize(index);
+
+  if (content->free_blocks[index])
+  {
+    mem->ptr                    = content->free_blocks[index];
+    content->free_blocks[index] = *((void**)mem->ptr);
+    content->bytes_cached -= csize;
+    content->num_hits++;
+  }
+  else
+  {
+    mem->ptr = poolSysAlloc(content, csize);
+    SUNAssert(mem->ptr, SUN_ERR_MALLOC_FAIL);
+    content->num_misses++;
+    content->num_allocations++;
+    content->bytes_allocated += csize;
+    content->bytes_high_watermark = SUNMAX(content->bytes_allocated,
+                                           content->bytes_high_watermark);
+  }
+
+  *memptr = mem;
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_Dealloc_SysPool(SUNMemoryHelper helper, SUNMemory mem,
+                                           SUNDIALS_MAYBE_UNUSED void* queue)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  if (mem == NULL) { return SUN_SUCCESS; }
+
+  SUNAssert(mem->type == SUNMEMTYPE_HOST, SUN_ERR_ARG_INCOMPATIBLE);
+
+  SUNMemoryHelper_Content_SysPool* content = SUNHELPER_CONTENT(helper);
+
+  if (mem->ptr != NULL && mem->own)
+  {
+    size_t index = poolClassIndex(mem->bytes);
+    size_t csize = poolClassSize(index);
+
+    if (csize <= content->max_cached_bytes - SUNMIN(content->bytes_cached,
+                                                    content->max_cached_bytes))
+    {
+      *((void**)mem->ptr)         = content->free_blocks[index];
+      content->free_blocks[index] = mem->ptr;
+      content->bytes_cached += csize;
+    }
+    else
+    {
+      poolSysFree(mem->ptr);
+      content->num_deallocations++;
+      content->bytes_allocated -= csize;
+    }
+  }
+
+  /* keep the handle for reuse */
+  mem->ptr              = content->free_handles;
+  content->free_handles = mem;
+
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_Copy_SysPool(SUNMemoryHelper helper, SUNMemory dst,
+                                        SUNMemory src, size_t memory_size,
+                                        SUNDIALS_MAYBE_UNUSED void* queue)
+{
+  SUNFunctionBegin(helper->sunctx);
+  SUNAssert(src->type == SUNMEMTYPE_HOST, SUN_ERR_ARG_INCOMPATIBLE);
+  SUNAssert(dst->type == SUNMEMTYPE_HOST, SUN_ERR_ARG_INCOMPATIBLE);
+  memcpy(dst->ptr, src->ptr, memory_size);
+  return SUN_SUCCESS;
+}
+
+SUNErrCode SUNMemoryHelper_GetAllocStats_SysPool(
+  SUNMemoryHelper helper, SUNDIALS_MAYBE_UNUSED SUNMemoryType mem_type,
+  unsigned long* num_allocations, unsigned long* num_deallocations,
+  size_t* bytes_allocated, size_t* bytes_high_watermark)
+{
+  SUNFunctionBegin(helper->sunctx);
+  SUNAssert(mem_type == SUNMEMTYPE_HOST, SUN_ERR_ARG_INCOMPATIBLE);
+  *num_allocations      = SUNHELPER_CONTENT(helper)->num_allocations;
+  *num_deallocations    = SUNHELPER_CONTENT(helper)->num_deallocations;
+  *bytes_allocated      = SUNHELPER_CONTENT(helper)->bytes_allocated;
+  *bytes_high_watermark = SUNHELPER_CONTENT(helper)->bytes_high_watermark;
+  return SUN_SUCCESS;
+}
+
+SUNMemoryHelper SUNMemoryHelper_Clone_SysPool(SUNMemoryHelper helper)
+{
+  SUNFunctionBegin(helper->sunctx);
+
+  /* the clone has the same settings but its own (empty) cache */
+  SUNMemoryHelper hclone = SUNMemoryHelper_SysPool(helper->sunctx);
+  SUNCheckLastErrNull();
+
+  SUNHELPER_CONTENT(hclone)->max_cached_bytes =
+    SUNHELPER_CONTENT(helper)->max_cached_bytes;
+  SUNHELPER_CONTENT(hclone)->alignment  = SUNHELPER_CONTENT(helper)->alignment;
+  SUNHELPER_CONTENT(hclone)->huge_pages = SUNHELPER_CONTENT(helper)->huge_pages;
+
+  return hclone;
+}
+
+SUNErrCode SUNMemoryHelper_Destroy_SysPool(SUNMemoryHelper helper)
+{
+  if (helper)
+  {
+    if (helper->content)
+    {
+      SUNErrCode err = SUNMemoryHelper_Trim_SysPool(helper);
+      if (err) { return err; }
+      free(helper->content);
+    }
+    if (helper->ops) { free(helper->ops); }
+    free(helper);
+  }
+  return SUN_SUCCESS;
+}
+
+/* -----------------------------------------------------------------
+ * Private functions
+ * ----------------------------------------------------------------*/
+
+/* Returns the size class index for a request of mem_size bytes */
+static size_t poolClassIndex(size_t mem_size)
+{
+  if (mem_size <= POOL_MIN_BLOCK) { return 0; }
+
+  /* power of two below the request and the spacing of its sub-classes */
+  size_t shift = 0;
+  size_t tmp   = mem_size - 1;
+  while (tmp >>= 1) { shift++; }
+
+  size_t base = (size_t)1 << shift;
+  size_t step = base >> POOL_SUB_SHIFT;
+  size_t sub  = (mem_size - base + step - 1) / step;
+
+  return POOL_SUB_COUNT * (shift - POOL_MIN_SHIFT) + sub;
+}
+
+/* Returns the number of bytes in the blocks of a size class */
+static size_t poolClassSize(size_t index)
+{
+  if (index == 0) { return POOL_MIN_BLOCK; }
+
+  size_t shift = POOL_MIN_SHIFT + (index - 1) / POOL_SUB_COUNT;
+  size_t sub   = (index - 1) % POOL_SUB_COUNT + 1;
+
+  return ((size_t)1 << shift) + sub * ((size_t)1 << (shift - POOL_SUB_SHIFT));
+}
+
+/* Allocates an aligned block, the pointer returned by malloc is stored just
+   before the aligned address so the block can be released by poolSysFree */
+static void* poolSysAlloc(SUNMemoryHelper_Content_SysPool* content, size_t size)
+{
+  size_t alignment = content->alignment;
+
+  if (content->huge_pages && size >= POOL_HUGE_PAGE_SIZE)
+  {
+    alignment = SUNMAX(alignment, POOL_HUGE_PAGE_SIZE);
+  }
+
+  void* raw = malloc(size + alignment - 1 + sizeof(void*));
+  if (!raw) { return NULL; }
+
+  uintptr_t addr = ((uintptr_t)raw + sizeof(void*) + alignment - 1) &
+                   ~((uintptr_t)alignment - 1);
+  void* ptr         = (void*)addr;
+  ((void**)ptr)[-1] = raw;
+
+#if defined(SUNDIALS_HAVE_MMAP) && defined(MADV_HUGEPAGE)
+  /* advise the kernel to back whole huge pages in the block with huge pages,
+     failure is not an error since this is only a hint */
+  if (content->huge_pages && size >= POOL_HUGE_PAGE_SIZE)
+  {
+    (void)madvise(ptr, size - size % POOL_HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+  }
+#endif
+
+  return ptr;
+}
+
+static void poolSysFree(void* ptr) { free(((void**)ptr)[-1]); }
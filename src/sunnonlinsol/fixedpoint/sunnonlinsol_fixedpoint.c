@@ -32,6 +32,7 @@ static SUNErrCode AndersonAccelerate(SUNNonlinearSolver NLS, N_Vector gval,
 
 static SUNErrCode AllocateContent(SUNNonlinearSolver NLS, N_Vector tmpl);
 static void FreeContent(SUNNonlinearSolver NLS);
+static size_t AndersonBytes(int m);
 
 /* Content structure accessibility macros */
 #define FP_CONTENT(S) ((SUNNonlinearSolverContent_FixedPoint)(S->content))
@@ -75,6 +76,7 @@ SUNNonlinearSolver SUNNonlinSol_FixedPoint(N_Vector y, int m, SUNContext sunctx)
   content = NULL;
   content = (SUNNonlinearSolverContent_FixedPoint)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER, sizeof *content);
 
   /* Initialize all components of content to 0/NULL */
   memset(content, 0, sizeof(struct _SUNNonlinearSolverContent_FixedPoint));
@@ -288,6 +290,8 @@ SUNErrCode SUNNonlinSolFree_FixedPoint(SUNNonlinearSolver NLS)
   if (NLS->content)
   {
     FreeContent(NLS);
+    sunMemAccountFree(NLS->sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                      sizeof(struct _SUNNonlinearSolverContent_FixedPoint));
     free(NLS->content);
     NLS->content = NULL;
   }
@@ -652,6 +656,9 @@ static SUNErrCode AllocateContent(SUNNonlinearSolver NLS, N_Vector y)
 
     FP_CONTENT(NLS)->Xvecs = (N_Vector*)malloc(2 * (m + 1) * sizeof(N_Vector));
     SUNAssert(FP_CONTENT(NLS)->Xvecs, SUN_ERR_MALLOC_FAIL);
+
+    sunMemAccountAlloc(NLS->sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                       AndersonBytes(m));
   }
 
   return SUN_SUCCESS;
@@ -689,6 +696,12 @@ static void FreeContent(SUNNonlinearSolver NLS)
     FP_CONTENT(NLS)->delta = NULL;
   }
 
+  if (FP_CONTENT(NLS)->Xvecs)
+  {
+    sunMemAccountFree(NLS->sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                      AndersonBytes(FP_CONTENT(NLS)->m));
+  }
+
   if (FP_CONTENT(NLS)->imap)
   {
     free(FP_CONTENT(NLS)->imap);
@@ -739,3 +752,11 @@ static void FreeContent(SUNNonlinearSolver NLS)
 
   return;
 }
+
+/* Bytes allocated for the Anderson acceleration arrays (excluding vectors)
+   for memory accounting */
+static size_t AndersonBytes(int m)
+{
+  return m * sizeof(int) + (m * m + m + 2 * (m + 1)) * sizeof(sunrealtype) +
+         2 * (m + 1) * sizeof(N_Vector);
+}
@@ -71,6 +71,7 @@ SUNNonlinearSolver SUNNonlinSol_Newton(N_Vector y, SUNContext sunctx)
   content = NULL;
   content = (SUNNonlinearSolverContent_Newton)malloc(sizeof *content);
   SUNAssertNull(content, SUN_ERR_MALLOC_FAIL);
+  sunMemAccountAlloc(sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER, sizeof *content);
 
   /* Initialize all components of content to 0/NULL */
   memset(content, 0, sizeof(struct _SUNNonlinearSolverContent_Newton));
@@ -336,6 +337,8 @@ SUNErrCode SUNNonlinSolFree_Newton(SUNNonlinearSolver NLS)
     }
     NEWTON_CONTENT(NLS)->delta = NULL;
 
+    sunMemAccountFree(NLS->sunctx, SUN_MEMSUBSYSTEM_NONLINEARSOLVER,
+                      sizeof(struct _SUNNonlinearSolverContent_Newton));
     free(NLS->content);
     NLS->content = NULL;
   }
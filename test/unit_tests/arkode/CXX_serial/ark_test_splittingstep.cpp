@@ -100,6 +100,119 @@ static int test_forward(sundials::Context& ctx, int order, int partitions)
   return fail;
 }
 
+/* Integrates the ODE
+ *
+ * y' = \sum_{i=0}^{P-1} 2^i / (1 - 2^P) * y,    y(0) = 1
+ *
+ * with the symmetric parallel splitting method, which has two independent
+ * sequential methods. With two threads, each with its own ERK steppers, the
+ * sequential methods run concurrently and the solution must match the serial
+ * solution. A SUNContext is not thread safe, so every partition stepper has its
+ * own context and state vector. Without OpenMP, more than one thread must be
+ * rejected.
+ */
+static int test_concurrent(sundials::Context& ctx, int partitions)
+{
+  constexpr auto t0         = SUN_RCONST(0.0);
+  constexpr auto tf         = SUN_RCONST(1.0);
+  constexpr auto dt         = SUN_RCONST(8.0e-3);
+  constexpr auto local_tol  = SUN_RCONST(1.0e-6);
+  constexpr auto global_tol = SUN_RCONST(10.0) * local_tol;
+  constexpr auto nthreads   = 2;
+  auto y                    = N_VNew_Serial(1, ctx);
+
+  ARKRhsFn f = [](sunrealtype, N_Vector z, N_Vector zdot, void* user_data)
+  {
+    auto lambda = *static_cast<sunrealtype*>(user_data);
+    N_VScale(lambda, z, zdot);
+    return 0;
+  };
+
+  /* steppers for each thread, the first set is also used serially */
+  std::vector<sundials::Context> partition_ctx(nthreads * partitions);
+  std::vector<N_Vector> partition_y(nthreads * partitions);
+  std::vector<void*> partition_mem(nthreads * partitions);
+  std::vector<sunrealtype> lambda(partitions);
+  std::vector<SUNStepper> steppers(nthreads * partitions);
+  for (int i = 0; i < partitions; i++)
+  {
+    /* The lambdas sum up to 1 */
+    lambda[i] = std::pow(SUN_RCONST(2.0), i) /
+                (1 - std::pow(SUN_RCONST(2.0), partitions));
+  }
+  for (int i = 0; i < nthreads * partitions; i++)
+  {
+    partition_y[i] = N_VNew_Serial(1, partition_ctx[i]);
+    N_VConst(SUN_RCONST(1.0), partition_y[i]);
+    partition_mem[i] = ERKStepCreate(f, t0, partition_y[i], partition_ctx[i]);
+    ARKodeSetUserData(partition_mem[i], &lambda[i % partitions]);
+    ARKodeSStolerances(partition_mem[i], local_tol, local_tol);
+    ARKodeCreateSUNStepper(partition_mem[i], &steppers[i]);
+  }
+
+  auto coefficients = SplittingStepCoefficients_SymmetricParallel(partitions);
+  sunrealtype solution[2];
+  long int evolves[2];
+  sunbooleantype fail = SUNFALSE;
+
+  for (int run = 0; run < 2; run++)
+  {
+    N_VConst(SUN_RCONST(1.0), y);
+    auto arkode_mem = SplittingStepCreate(steppers.data(), partitions, t0, y,
+                                          ctx);
+    ARKodeSetFixedStep(arkode_mem, dt);
+    SplittingStepSetCoefficients(arkode_mem, coefficients);
+
+    if (run == 1)
+    {
+#if defined(SUNDIALS_OPENMP_ENABLED)
+      int flag = SplittingStepSetNumThreads(arkode_mem, nthreads,
+                                            steppers.data());
+      fail     = fail || flag != ARK_SUCCESS;
+#else
+      /* the expected error must not abort */
+      SUNContext_ClearErrHandlers(ctx);
+      int flag = SplittingStepSetNumThreads(arkode_mem, nthreads,
+                                            steppers.data());
+      SUNContext_PushErrHandler(ctx, SUNAbortErrHandlerFn, nullptr);
+      fail = fail || flag != ARK_ILL_INPUT;
+#endif
+    }
+
+    auto tret = t0;
+    ARKodeEvolve(arkode_mem, tf, y, &tret, ARK_NORMAL);
+    solution[run] = N_VGetArrayPointer(y)[0];
+    SplittingStepGetNumEvolves(arkode_mem, -1, &evolves[run]);
+    ARKodeFree(&arkode_mem);
+  }
+
+  auto exact_solution = std::exp(t0 - tf);
+  std::cout << "Concurrent solution with " << partitions
+            << " partitions completed with an error of "
+            << solution[1] - exact_solution << " (serial "
+            << solution[0] - exact_solution << ")\n";
+
+  fail = fail || SUNRCompareTol(exact_solution, solution[1], global_tol) ||
+         SUNRCompareTol(solution[0], solution[1], global_tol) ||
+         evolves[0] != evolves[1];
+  if (fail)
+  {
+    std::cerr << "Concurrent solution does not match the serial solution\n";
+  }
+  std::cout << "\n";
+
+  SplittingStepCoefficients_Destroy(&coefficients);
+  N_VDestroy(y);
+  for (int i = 0; i < nthreads * partitions; i++)
+  {
+    ARKodeFree(&partition_mem[i]);
+    SUNStepper_Destroy(&steppers[i]);
+    N_VDestroy(partition_y[i]);
+  }
+
+  return fail;
+}
+
 /* Integrates the ODE
  * 
  * y_1' = y_2 - t
@@ -517,6 +630,9 @@ int main()
                 "ARKODE_SPLITTING_SUZUKI_3_3_2", "ARKODE_SPLITTING_RUTH_3_3_2"};
   for (auto name : names) { errors += test_mixed_directions(ctx, name); }
 
+  errors += test_concurrent(ctx, 2);
+  errors += test_concurrent(ctx, 3);
+
   errors += test_resize(ctx);
   errors += test_custom_stepper(ctx, 4);
   errors += test_custom_stepper(ctx, 6);
@@ -0,0 +1,312 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the discrete adjoint of ERKStep (method 0) and of a DIRK method
+ * in ARKStep (method 1). The gradients of y1(TF) of a Lotka-Volterra problem
+ * with respect to the initial condition and the parameters are compared with
+ * central differences of the fixed step integration. The adjoint computed from
+ * sparse checkpoints must match the one from stored stages.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_arkstep.h"
+#include "arkode/arkode_erkstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define HALF SUN_RCONST(0.5)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(2.0)
+#define H    SUN_RCONST(0.05)
+
+#define NP 4
+
+/* y1' = p0 y1 - p1 y1 y2, y2' = -p2 y2 + p3 y1 y2 */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* p  = (sunrealtype*)user_data;
+  sunrealtype* yd = N_VGetArrayPointer(y);
+  sunrealtype* fd = N_VGetArrayPointer(ydot);
+
+  fd[0] = p[0] * yd[0] - p[1] * yd[0] * yd[1];
+  fd[1] = -p[2] * yd[1] + p[3] * yd[0] * yd[1];
+
+  return 0;
+}
+
+/* (df/dy)^T v */
+static int fy_vjp(sunrealtype t, N_Vector y, N_Vector v, N_Vector Jv,
+                  void* user_data)
+{
+  sunrealtype* p  = (sunrealtype*)user_data;
+  sunrealtype* yd = N_VGetArrayPointer(y);
+  sunrealtype* vd = N_VGetArrayPointer(v);
+  sunrealtype* jd = N_VGetArrayPointer(Jv);
+
+  jd[0] = (p[0] - p[1] * yd[1]) * vd[0] + p[3] * yd[1] * vd[1];
+  jd[1] = -p[1] * yd[0] * vd[0] + (-p[2] + p[3] * yd[0]) * vd[1];
+
+  return 0;
+}
+
+/* (df/dp)^T v */
+static int fp_vjp(sunrealtype t, N_Vector y, N_Vector v, N_Vector Jv,
+                  void* user_data)
+{
+  sunrealtype* yd = N_VGetArrayPointer(y);
+  sunrealtype* vd = N_VGetArrayPointer(v);
+  sunrealtype* jd = N_VGetArrayPointer(Jv);
+
+  jd[0] = yd[0] * vd[0];
+  jd[1] = -yd[0] * yd[1] * vd[0];
+  jd[2] = -yd[1] * vd[1];
+  jd[3] = yd[0] * yd[1] * vd[1];
+
+  return 0;
+}
+
+/* Integrate from y0 with parameters p and return y1(TF) in g. If interval >= 0
+   the adjoint is also computed with the given checkpointing and the gradients
+   with respect to y0 and p are returned in lambda and mu. */
+static int run(SUNContext sunctx, int method, const sunrealtype* y0,
+               sunrealtype* p, long int interval, sunbooleantype save_stages,
+               sunrealtype* g, N_Vector lambda, N_Vector mu, long int* nrecomp)
+{
+  int flag;
+  void* arkode_mem   = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  SUNStepper adj     = NULL;
+  N_Vector y;
+  sunrealtype tret;
+
+  y = N_VNew_Serial(2, sunctx);
+  if (!y) { return 1; }
+  N_VGetArrayPointer(y)[0] = y0[0];
+  N_VGetArrayPointer(y)[1] = y0[1];
+
+  if (method == 0) { arkode_mem = ERKStepCreate(f, ZERO, y, sunctx); }
+  else
+  {
+    arkode_mem = ARKStepCreate(NULL, f, ZERO, y, sunctx);
+    if (!arkode_mem) { return 1; }
+
+    A  = SUNDenseMatrix(2, 2, sunctx);
+    LS = SUNLinSol_Dense(y, A, sunctx);
+    if (!A || !LS) { return 1; }
+
+    flag = ARKodeSetLinearSolver(arkode_mem, LS, A);
+    if (flag) { return 1; }
+
+    flag = ARKodeSetMaxNonlinIters(arkode_mem, 10);
+    if (flag) { return 1; }
+  }
+  if (!arkode_mem) { return 1; }
+
+  flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-10),
+                            SUN_RCONST(1.0e-12));
+  if (flag) { return 1; }
+
+  flag = ARKodeSetUserData(arkode_mem, p);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetFixedStep(arkode_mem, H);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetStopTime(arkode_mem, TF);
+  if (flag) { return 1; }
+
+  if (interval >= 0)
+  {
+    flag = ARKodeSetAdjointCheckpointing(arkode_mem, interval, save_stages);
+    if (flag) { return 1; }
+
+    flag = ARKodeSetAdjointVecJacFn(arkode_mem, fy_vjp, fp_vjp);
+    if (flag) { return 1; }
+  }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+  *g = N_VGetArrayPointer(y)[0];
+
+  if (interval >= 0)
+  {
+    /* final condition d y1(TF) / d y(TF) */
+    N_VConst(ZERO, lambda);
+    N_VGetArrayPointer(lambda)[0] = ONE;
+    N_VConst(ZERO, mu);
+
+    flag = ARKodeCreateAdjointSUNStepper(arkode_mem, mu, &adj);
+    if (flag) { return 1; }
+
+    flag = SUNStepper_Reset(adj, tret, lambda);
+    if (flag) { return 1; }
+
+    /* one step, stop within a checkpoint interval, and finish */
+    flag = SUNStepper_OneStep(adj, ZERO, lambda, &tret);
+    if (flag) { return 1; }
+
+    flag = SUNStepper_Evolve(adj, SUN_RCONST(0.77), lambda, &tret);
+    if (flag) { return 1; }
+    if (tret < SUN_RCONST(0.77) || tret > SUN_RCONST(0.77) + H)
+    {
+      printf("ERROR: adjoint stopped at t = %" GSYM "\n", tret);
+      return 1;
+    }
+
+    flag = SUNStepper_Evolve(adj, ZERO, lambda, &tret);
+    if (flag) { return 1; }
+    if (SUNRabs(tret) > SUN_RCONST(1.0e-12))
+    {
+      printf("ERROR: adjoint ended at t = %" GSYM "\n", tret);
+      return 1;
+    }
+
+    flag = ARKodeGetNumAdjointRecomputedSteps(arkode_mem, nrecomp);
+    if (flag) { return 1; }
+
+    SUNStepper_Destroy(&adj);
+  }
+
+  ARKodeFree(&arkode_mem);
+  if (LS) { SUNLinSolFree(LS); }
+  if (A) { SUNMatDestroy(A); }
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails          = 0;
+  int method         = 0;
+  int i;
+  long int nrecomp   = 0;
+  SUNContext sunctx  = NULL;
+  sunrealtype y0[2]  = {ONE, HALF};
+  sunrealtype p[NP]  = {SUN_RCONST(1.5), ONE, SUN_RCONST(3.0), ONE};
+  sunrealtype eps    = SUN_RCONST(1.0e-5);
+  sunrealtype tol    = SUN_RCONST(1.0e-6);
+  sunrealtype g, gp, gm, fd, err, *save, *ld, *md;
+  N_Vector lambda, mu, lambda_ck, mu_ck;
+
+  if (argc > 1) { method = atoi(argv[1]); }
+  printf("Discrete adjoint test with %s\n", method ? "DIRK" : "ERK");
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  lambda    = N_VNew_Serial(2, sunctx);
+  lambda_ck = N_VNew_Serial(2, sunctx);
+  mu        = N_VNew_Serial(NP, sunctx);
+  mu_ck     = N_VNew_Serial(NP, sunctx);
+  if (!lambda || !lambda_ck || !mu || !mu_ck) { return 1; }
+
+  /* adjoint from stored stages */
+  if (run(sunctx, method, y0, p, 0, SUNTRUE, &g, lambda, mu, &nrecomp))
+  {
+    return 1;
+  }
+  ld = N_VGetArrayPointer(lambda);
+  md = N_VGetArrayPointer(mu);
+  printf("y1(TF) = %" GSYM "\n", g);
+  printf("lambda = %" GSYM " %" GSYM "\n", ld[0], ld[1]);
+  printf("mu     = %" GSYM " %" GSYM " %" GSYM " %" GSYM "\n", md[0], md[1],
+         md[2], md[3]);
+
+  /* central differences of the discrete solution */
+  for (i = 0; i < 2 + NP; i++)
+  {
+    save = (i < 2) ? &y0[i] : &p[i - 2];
+    gp   = *save;
+    *save += eps;
+    if (run(sunctx, method, y0, p, -1, SUNFALSE, &g, NULL, NULL, NULL))
+    {
+      return 1;
+    }
+    *save = gp - eps;
+    if (run(sunctx, method, y0, p, -1, SUNFALSE, &gm, NULL, NULL, NULL))
+    {
+      return 1;
+    }
+    *save = gp;
+    gp    = g;
+
+    fd  = (gp - gm) / (2 * eps);
+    err = (i < 2) ? ld[i] : md[i - 2];
+    err = SUNRabs(fd - err) / SUNMAX(ONE, SUNRabs(fd));
+    if (err > tol)
+    {
+      printf("ERROR: gradient %d differs from finite differences by %" GSYM
+             "\n",
+             i, err);
+      fails++;
+    }
+  }
+
+  /* adjoint recomputed from every third step */
+  if (run(sunctx, method, y0, p, 3, SUNFALSE, &g, lambda_ck, mu_ck, &nrecomp))
+  {
+    return 1;
+  }
+  printf("recomputed steps = %ld\n", nrecomp);
+  if (nrecomp < (long int)(TF / H))
+  {
+    printf("ERROR: too few recomputed steps\n");
+    fails++;
+  }
+
+  N_VLinearSum(ONE, lambda_ck, -ONE, lambda, lambda_ck);
+  N_VLinearSum(ONE, mu_ck, -ONE, mu, mu_ck);
+  err = SUNMAX(N_VMaxNorm(lambda_ck), N_VMaxNorm(mu_ck));
+  printf("difference to stored stages = %" GSYM "\n", err);
+  if (err > SUN_RCONST(1.0e-8))
+  {
+    printf("ERROR: checkpointed adjoint differs\n");
+    fails++;
+  }
+
+  /* adjoint options require checkpointing to be enabled */
+  {
+    N_Vector y       = N_VNew_Serial(2, sunctx);
+    void* arkode_mem = ERKStepCreate(f, ZERO, y, sunctx);
+    if (!arkode_mem) { return 1; }
+    if (ARKodeSetAdjointVecJacFn(arkode_mem, fy_vjp, NULL) != ARK_ADJ_MEM_NULL)
+    {
+      printf("ERROR: adjoint function set without checkpointing\n");
+      fails++;
+    }
+    ARKodeFree(&arkode_mem);
+    N_VDestroy(y);
+  }
+
+  N_VDestroy(lambda);
+  N_VDestroy(lambda_ck);
+  N_VDestroy(mu);
+  N_VDestroy(mu_ck);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
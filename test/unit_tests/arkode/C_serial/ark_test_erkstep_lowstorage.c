@@ -0,0 +1,191 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the low-storage methods in ERKStep. Each built-in method is
+ * run with a fixed step and must match the same method given as a full Butcher
+ * table to near roundoff while using less workspace. Methods with an embedding
+ * are also run with adaptive steps and must be accurate.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_erkstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(1.0)
+#define HFIX SUN_RCONST(1.0e-2)
+
+#define NEQ 20
+
+/* y_i' = -(1 + 0.1 i) (y_i - sin(t)) + cos(t), the solution is y_i = sin(t) */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -(ONE + PT1 * i) * (ydata[i] - sin(t)) + cos(t);
+  }
+
+  return 0;
+}
+
+/* Integrate to TF with a low-storage method (B == NULL) or the given Butcher
+   table and return the solution in y and the real workspace size in lenrw */
+static int integrate(SUNContext sunctx, ARKODE_LSERKTableID ltable,
+                     ARKodeButcherTable B, sunbooleantype adaptive, N_Vector y,
+                     long int* lenrw, ARKodeButcherTable* Bout)
+{
+  int flag;
+  void* arkode_mem = NULL;
+  sunrealtype tret = ZERO;
+  long int leniw;
+  ARKodeButcherTable Bcur;
+
+  N_VConst(ZERO, y);
+
+  arkode_mem = ERKStepCreate(f, ZERO, y, sunctx);
+  if (!arkode_mem) { return 1; }
+
+  if (B) { flag = ERKStepSetTable(arkode_mem, B); }
+  else { flag = ERKStepSetLowStorageTableNum(arkode_mem, ltable); }
+  if (flag) { return 1; }
+
+  if (adaptive)
+  {
+    flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-8),
+                              SUN_RCONST(1.0e-10));
+  }
+  else { flag = ARKodeSetFixedStep(arkode_mem, HFIX); }
+  if (flag) { return 1; }
+
+  flag = ARKodeSetMaxNumSteps(arkode_mem, 100000);
+  if (flag) { return 1; }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = ARKodeGetWorkSpace(arkode_mem, lenrw, &leniw);
+  if (flag) { return 1; }
+
+  /* return a copy of the equivalent Butcher table */
+  if (Bout)
+  {
+    flag = ERKStepGetCurrentButcherTable(arkode_mem, &Bcur);
+    if (flag) { return 1; }
+    *Bout = ARKodeButcherTable_Copy(Bcur);
+    if (!(*Bout)) { return 1; }
+  }
+
+  ARKodeFree(&arkode_mem);
+
+  return 0;
+}
+
+/* Check one low-storage method, the number of failed checks is returned in
+   fails */
+static int check_method(SUNContext sunctx, ARKODE_LSERKTableID ltable,
+                        int* fails)
+{
+  long int lenrw_ls, lenrw_full;
+  sunrealtype diff, err;
+  N_Vector yls, yfull;
+  ARKodeButcherTable B = NULL;
+
+  yls   = N_VNew_Serial(NEQ, sunctx);
+  yfull = N_VNew_Serial(NEQ, sunctx);
+  if (!yls || !yfull) { return 1; }
+
+  /* fixed steps with the low-storage and full forms of the method */
+  if (integrate(sunctx, ltable, NULL, SUNFALSE, yls, &lenrw_ls, &B))
+  {
+    return 1;
+  }
+  if (integrate(sunctx, ltable, B, SUNFALSE, yfull, &lenrw_full, NULL))
+  {
+    return 1;
+  }
+
+  N_VLinearSum(ONE, yls, -ONE, yfull, yfull);
+  diff = N_VMaxNorm(yfull);
+  if (diff > SUN_RCONST(1.0e-12))
+  {
+    printf("ERROR: method %d differs from its Butcher table by %g\n",
+           (int)ltable, (double)diff);
+    (*fails)++;
+  }
+
+  N_VAddConst(yls, -sin(TF), yls);
+  err = N_VMaxNorm(yls);
+  if (err > SUN_RCONST(1.0e-6))
+  {
+    printf("ERROR: method %d fixed step error %g\n", (int)ltable, (double)err);
+    (*fails)++;
+  }
+
+  if (lenrw_ls >= lenrw_full)
+  {
+    printf("ERROR: method %d low-storage lenrw %ld, full lenrw %ld\n",
+           (int)ltable, lenrw_ls, lenrw_full);
+    (*fails)++;
+  }
+
+  /* adaptive steps require an embedding */
+  if (B->d)
+  {
+    if (integrate(sunctx, ltable, NULL, SUNTRUE, yls, &lenrw_ls, NULL))
+    {
+      return 1;
+    }
+    N_VAddConst(yls, -sin(TF), yls);
+    err = N_VMaxNorm(yls);
+    if (err > SUN_RCONST(1.0e-6))
+    {
+      printf("ERROR: method %d adaptive error %g\n", (int)ltable, (double)err);
+      (*fails)++;
+    }
+  }
+
+  ARKodeButcherTable_Free(B);
+  N_VDestroy(yls);
+  N_VDestroy(yfull);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int ltable        = 0;
+  SUNContext sunctx = NULL;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  for (ltable = ARKODE_MIN_LSERK_NUM; ltable <= ARKODE_MAX_LSERK_NUM; ltable++)
+  {
+    if (check_method(sunctx, (ARKODE_LSERKTableID)ltable, &fails)) { return 1; }
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,152 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the EXPStep exponential Rosenbrock time-stepping module. A
+ * mildly nonlinear stiff problem is integrated with each built-in method using
+ * a matrix-free linear solver and the solution must be accurate. The Krylov
+ * dimension must adapt below its maximum and evolving without a linear solver
+ * must fail.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_expstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_spgmr.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(1.0)
+
+#define NEQ 40
+
+/* y_i' = -1e4 (1 + 0.1 i) (y_i - sin(t)) - (y_i - sin(t))^2 + cos(t), the
+   solution is y_i = sin(t) */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunrealtype e;
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    e         = ydata[i] - sin(t);
+    yddata[i] = -SUN_RCONST(1.0e4) * (ONE + PT1 * i) * e - e * e + cos(t);
+  }
+
+  return 0;
+}
+
+/* Integrate to TF with the given method and check the solution, the number of
+   failed checks is returned in fails */
+static int integrate(SUNContext sunctx, ARKODE_EXPMethodID method, int* fails)
+{
+  int flag, maxdim;
+  SUNLinearSolver LS = NULL;
+  N_Vector y         = NULL;
+  void* arkode_mem   = NULL;
+  sunrealtype tret   = ZERO;
+  sunrealtype err;
+  long int nkrylov;
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ZERO, y);
+
+  arkode_mem = EXPStepCreate(f, ZERO, y, sunctx);
+  if (!arkode_mem) { return 1; }
+
+  flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-8));
+  if (flag) { return 1; }
+
+  flag = EXPStepSetMethod(arkode_mem, method);
+  if (flag) { return 1; }
+
+  /* exponential Euler has no error estimate */
+  if (method == ARKODE_EXPRB_EULER_2)
+  {
+    flag = ARKodeSetFixedStep(arkode_mem, SUN_RCONST(1.0e-2));
+    if (flag) { return 1; }
+  }
+
+  /* evolving without a linear solver is an error */
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag != ARK_ILL_INPUT)
+  {
+    printf("ERROR: evolve without a linear solver returned %d\n", flag);
+    (*fails)++;
+  }
+
+  /* only the Jacobian-vector products of the linear solver are used */
+  LS = SUNLinSol_SPGMR(y, SUN_PREC_NONE, 0, sunctx);
+  if (!LS) { return 1; }
+
+  flag = ARKodeSetLinearSolver(arkode_mem, LS, NULL);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetMaxNumSteps(arkode_mem, 20000);
+  if (flag) { return 1; }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+
+  /* the exact solution is sin(TF) */
+  N_VAddConst(y, -sin(TF), y);
+  err = N_VMaxNorm(y);
+  if (err > SUN_RCONST(1.0e-4))
+  {
+    printf("ERROR: method %d solution error %g\n", (int)method, (double)err);
+    (*fails)++;
+  }
+
+  flag = EXPStepGetNumKrylovIters(arkode_mem, &nkrylov);
+  if (flag) { return 1; }
+
+  flag = EXPStepGetMaxKrylovDimUsed(arkode_mem, &maxdim);
+  if (flag) { return 1; }
+
+  /* the Krylov dimension adapts to the problem */
+  if (nkrylov <= 0 || maxdim <= 0 || maxdim >= NEQ)
+  {
+    printf("ERROR: method %d used %ld Krylov iterations, max dimension %d\n",
+           (int)method, nkrylov, maxdim);
+    (*fails)++;
+  }
+
+  ARKodeFree(&arkode_mem);
+  SUNLinSolFree(LS);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  SUNContext sunctx = NULL;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  if (integrate(sunctx, ARKODE_EXPRB_EULER_2, &fails)) { return 1; }
+  if (integrate(sunctx, ARKODE_EXPRB32_3_2, &fails)) { return 1; }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,201 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for EXTRAPStep. Each base method is run with adaptive steps and
+ * order and must be accurate, with a fixed order the observed convergence rate
+ * must match the requested order, and more than one thread must either be
+ * rejected (no OpenMP) or also give an accurate solution.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_extrapstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(1.0)
+
+#define NEQ 20
+
+/* y_i' = -(1 + 0.1 i) (y_i - sin(t)) + cos(t), the solution is y_i = sin(t) */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -(ONE + PT1 * i) * (ydata[i] - sin(t)) + cos(t);
+  }
+
+  return 0;
+}
+
+/* Integrate to TF with adaptive steps (hfix = 0) or a fixed step and return
+   the max error in err, the number of steps in nst, and the number of column
+   changes in nkchanges */
+static int integrate(SUNContext sunctx, ARKODE_ExtrapBaseID base, int order,
+                     int nthreads, sunrealtype hfix, N_Vector y,
+                     sunrealtype* err, long int* nst, long int* nkchanges)
+{
+  int flag;
+  void* arkode_mem = NULL;
+  sunrealtype tret = ZERO;
+  sunrealtype* ydata;
+  sunindextype i;
+
+  N_VConst(ZERO, y);
+
+  arkode_mem = EXTRAPStepCreate(f, ZERO, y, sunctx);
+  if (!arkode_mem) { return 1; }
+
+  flag = EXTRAPStepSetBaseMethod(arkode_mem, base);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetOrder(arkode_mem, order);
+  if (flag) { return 1; }
+
+  flag = EXTRAPStepSetNumThreads(arkode_mem, nthreads);
+  if (flag)
+  {
+    ARKodeFree(&arkode_mem);
+    return flag;
+  }
+
+  if (hfix > ZERO) { flag = ARKodeSetFixedStep(arkode_mem, hfix); }
+  else
+  {
+    flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-10),
+                              SUN_RCONST(1.0e-12));
+  }
+  if (flag) { return 1; }
+
+  flag = ARKodeSetMaxNumSteps(arkode_mem, 100000);
+  if (flag) { return 1; }
+
+  /* stop at TF so the error is not dominated by the interpolant */
+  flag = ARKodeSetStopTime(arkode_mem, TF);
+  if (flag) { return 1; }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = ARKodeGetNumSteps(arkode_mem, nst);
+  if (flag) { return 1; }
+
+  flag = EXTRAPStepGetNumColumnChanges(arkode_mem, nkchanges);
+  if (flag) { return 1; }
+
+  ARKodeFree(&arkode_mem);
+
+  ydata = N_VGetArrayPointer(y);
+  *err  = ZERO;
+  for (i = 0; i < NEQ; i++)
+  {
+    *err = SUNMAX(*err, SUNRabs(ydata[i] - sin(TF)));
+  }
+
+  return 0;
+}
+
+/* Check one base method, the number of failed checks is returned in fails */
+static int check_base(SUNContext sunctx, ARKODE_ExtrapBaseID base, int* fails)
+{
+  int flag, order;
+  long int nst, nkchanges;
+  sunrealtype err, err1, err2, rate;
+  N_Vector y;
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+
+  /* adaptive steps and order */
+  if (integrate(sunctx, base, 0, 1, ZERO, y, &err, &nst, &nkchanges))
+  {
+    return 1;
+  }
+  printf("base %d: adaptive error %g, steps %ld, column changes %ld\n",
+         (int)base, (double)err, nst, nkchanges);
+  if (err > SUN_RCONST(1.0e-8))
+  {
+    printf("ERROR: base %d adaptive error %g\n", (int)base, (double)err);
+    (*fails)++;
+  }
+
+  /* fixed order, compare the error for two step sizes */
+  order = (base == ARKODE_EXTRAP_MIDPOINT) ? 4 : 3;
+  if (integrate(sunctx, base, order, 1, SUN_RCONST(0.1), y, &err1, &nst,
+                &nkchanges) ||
+      integrate(sunctx, base, order, 1, SUN_RCONST(0.05), y, &err2, &nst,
+                &nkchanges))
+  {
+    return 1;
+  }
+  rate = log(err1 / err2) / log(SUN_RCONST(2.0));
+  printf("base %d: order %d observed rate %g\n", (int)base, order, (double)rate);
+  if (SUNRabs(rate - order) > SUN_RCONST(0.5))
+  {
+    printf("ERROR: base %d order %d observed rate %g\n", (int)base, order,
+           (double)rate);
+    (*fails)++;
+  }
+
+  /* concurrent sequences, the order selection uses the cost on the critical
+     path so the steps may differ from the serial run */
+  flag = integrate(sunctx, base, 0, 4, ZERO, y, &err, &nst, &nkchanges);
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (flag) { return 1; }
+  printf("base %d: threaded error %g, steps %ld, column changes %ld\n",
+         (int)base, (double)err, nst, nkchanges);
+  if (err > SUN_RCONST(1.0e-8))
+  {
+    printf("ERROR: base %d threaded error %g\n", (int)base, (double)err);
+    (*fails)++;
+  }
+#else
+  if (flag != ARK_ILL_INPUT)
+  {
+    printf("ERROR: base %d threads accepted without OpenMP\n", (int)base);
+    (*fails)++;
+  }
+#endif
+
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int base          = 0;
+  SUNContext sunctx = NULL;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  for (base = ARKODE_MIN_EXTRAP_NUM; base <= ARKODE_MAX_EXTRAP_NUM; base++)
+  {
+    if (check_base(sunctx, (ARKODE_ExtrapBaseID)base, &fails)) { return 1; }
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,275 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for SUNParareal with ERKStep coarse and fine propagators. With a
+ * tolerance the iteration must stop early with a solution close to the
+ * sequential fine solution, with a negligible tolerance the iteration must
+ * reproduce the sequential fine solution, and more than one fine propagator
+ * must either be rejected (no OpenMP) or also give an accurate solution. The
+ * fine propagators run concurrently, so each one has its own SUNContext.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_erkstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sundials/sundials_parareal.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(2.0)
+
+#define NEQ     20
+#define NSLICES 8
+#define NFINE   4
+
+/* y_i' = -(1 + 0.1 i) (y_i - sin(t)) + cos(t), the solution is y_i = sin(t) */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -(ONE + PT1 * i) * (ydata[i] - sin(t)) + cos(t);
+  }
+
+  return 0;
+}
+
+/* Create an ERKStep integrator and its SUNStepper, the coarse stepper uses a
+   second order method with a large step and the fine stepper a fourth order
+   method with a small step. Fixed steps make the fine solution a smooth
+   function of the slice start value. */
+static int create_stepper(SUNContext sunctx, N_Vector y, int coarse,
+                          void** arkode_mem, SUNStepper* stepper)
+{
+  int flag;
+
+  *arkode_mem = ERKStepCreate(f, ZERO, y, sunctx);
+  if (!*arkode_mem) { return 1; }
+
+  if (coarse)
+  {
+    flag = ARKodeSetOrder(*arkode_mem, 2);
+    if (flag) { return 1; }
+
+    flag = ARKodeSetFixedStep(*arkode_mem, SUN_RCONST(0.125));
+    if (flag) { return 1; }
+  }
+  else
+  {
+    flag = ARKodeSetOrder(*arkode_mem, 4);
+    if (flag) { return 1; }
+
+    flag = ARKodeSetFixedStep(*arkode_mem, SUN_RCONST(0.0078125));
+    if (flag) { return 1; }
+  }
+
+  flag = ARKodeCreateSUNStepper(*arkode_mem, stepper);
+  if (flag) { return 1; }
+
+  return 0;
+}
+
+/* Max difference between two vectors */
+static sunrealtype max_diff(N_Vector x, N_Vector y)
+{
+  sunrealtype* xdata = N_VGetArrayPointer(x);
+  sunrealtype* ydata = N_VGetArrayPointer(y);
+  sunrealtype diff   = ZERO;
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    diff = SUNMAX(diff, SUNRabs(xdata[i] - ydata[i]));
+  }
+
+  return diff;
+}
+
+/* Run Parareal with nfine fine steppers and the given tolerance, the solution
+   is returned in y, the number of iterations in niters */
+static int run_parareal(SUNContext sunctx, SUNStepper coarse, SUNStepper* fine,
+                        int nfine, sunrealtype rtol, sunrealtype atol,
+                        N_Vector y, int* niters)
+{
+  SUNErrCode err;
+  SUNParareal pr = NULL;
+  long int nfsolves, ncsolves;
+  sunrealtype change;
+  N_Vector y0;
+
+  err = SUNParareal_Create(coarse, fine, nfine, sunctx, &pr);
+  if (err) { return err; }
+
+  err = SUNParareal_SetNumSlices(pr, NSLICES);
+  if (err) { return err; }
+
+  err = SUNParareal_SetTolerances(pr, rtol, atol);
+  if (err) { return err; }
+
+  y0 = N_VClone(y);
+  if (!y0) { return 1; }
+  N_VConst(ZERO, y0);
+
+  err = SUNParareal_Evolve(pr, ZERO, y0, TF, y);
+  if (err) { return err; }
+
+  err = SUNParareal_GetNumIters(pr, niters);
+  if (err) { return err; }
+
+  err = SUNParareal_GetNumFineSolves(pr, &nfsolves);
+  if (err) { return err; }
+
+  err = SUNParareal_GetNumCoarseSolves(pr, &ncsolves);
+  if (err) { return err; }
+
+  err = SUNParareal_GetMaxChange(pr, &change);
+  if (err) { return err; }
+
+  printf("threads %d, rtol %g: iterations %d, fine solves %ld, coarse solves "
+         "%ld, last change %g\n",
+         nfine, (double)rtol, *niters, nfsolves, ncsolves, (double)change);
+
+  N_VDestroy(y0);
+  SUNParareal_Destroy(&pr);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int niters        = 0;
+  int i, n;
+  void* coarse_mem  = NULL;
+  void* fine_mem[NFINE];
+  SUNStepper coarse = NULL;
+  SUNStepper fine[NFINE];
+  SUNContext sunctx = NULL;
+  SUNContext fine_ctx[NFINE];
+  sunrealtype tret, diff;
+  N_Vector y, yref, yfine[NFINE];
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  y    = N_VNew_Serial(NEQ, sunctx);
+  yref = N_VNew_Serial(NEQ, sunctx);
+  if (!y || !yref) { return 1; }
+  N_VConst(ZERO, y);
+
+  if (create_stepper(sunctx, y, 1, &coarse_mem, &coarse)) { return 1; }
+  for (i = 0; i < NFINE; i++)
+  {
+    if (SUNContext_Create(SUN_COMM_NULL, &fine_ctx[i])) { return 1; }
+
+    yfine[i] = N_VNew_Serial(NEQ, fine_ctx[i]);
+    if (!yfine[i]) { return 1; }
+    N_VConst(ZERO, yfine[i]);
+
+    if (create_stepper(fine_ctx[i], yfine[i], 0, &fine_mem[i], &fine[i]))
+    {
+      return 1;
+    }
+  }
+
+  /* sequential fine solution, one slice at a time */
+  N_VConst(ZERO, yref);
+  for (n = 0; n < NSLICES; n++)
+  {
+    sunrealtype tn  = n * TF / NSLICES;
+    sunrealtype tn1 = (n == NSLICES - 1) ? TF : (n + 1) * TF / NSLICES;
+    if (SUNStepper_Reset(fine[0], tn, yref)) { return 1; }
+    if (SUNStepper_SetStopTime(fine[0], tn1)) { return 1; }
+    if (SUNStepper_Evolve(fine[0], tn1, yref, &tret)) { return 1; }
+  }
+
+  /* adaptive stopping */
+  if (run_parareal(sunctx, coarse, fine, 1, SUN_RCONST(1.0e-8),
+                   SUN_RCONST(1.0e-10), y, &niters))
+  {
+    return 1;
+  }
+  diff = max_diff(y, yref);
+  printf("difference to sequential fine solution %g\n", (double)diff);
+  if (niters >= NSLICES || diff > SUN_RCONST(1.0e-7))
+  {
+    printf("ERROR: %d iterations, difference %g\n", niters, (double)diff);
+    fails++;
+  }
+
+  /* without a tolerance the sequential fine solution is reproduced */
+  if (run_parareal(sunctx, coarse, fine, 1, ZERO, SUN_RCONST(1.0e-300), y,
+                   &niters))
+  {
+    return 1;
+  }
+  diff = max_diff(y, yref);
+  printf("difference to sequential fine solution %g\n", (double)diff);
+  if (niters > NSLICES || diff > SUN_RCONST(1.0e-12))
+  {
+    printf("ERROR: %d iterations, difference %g\n", niters, (double)diff);
+    fails++;
+  }
+
+  /* concurrent fine solves */
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  if (run_parareal(sunctx, coarse, fine, NFINE, SUN_RCONST(1.0e-8),
+                   SUN_RCONST(1.0e-10), y, &niters))
+  {
+    return 1;
+  }
+  diff = max_diff(y, yref);
+  printf("difference to sequential fine solution %g\n", (double)diff);
+  if (niters >= NSLICES || diff > SUN_RCONST(1.0e-7))
+  {
+    printf("ERROR: threaded %d iterations, difference %g\n", niters,
+           (double)diff);
+    fails++;
+  }
+#else
+  {
+    SUNParareal pr = NULL;
+    if (SUNParareal_Create(coarse, fine, NFINE, sunctx, &pr) !=
+        SUN_ERR_ARG_INCOMPATIBLE)
+    {
+      printf("ERROR: fine propagators for threads accepted without OpenMP\n");
+      fails++;
+      SUNParareal_Destroy(&pr);
+    }
+  }
+#endif
+
+  SUNStepper_Destroy(&coarse);
+  ARKodeFree(&coarse_mem);
+  for (i = 0; i < NFINE; i++)
+  {
+    SUNStepper_Destroy(&fine[i]);
+    ARKodeFree(&fine_mem[i]);
+    N_VDestroy(yfine[i]);
+    SUNContext_Free(&fine_ctx[i]);
+  }
+  N_VDestroy(y);
+  N_VDestroy(yref);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
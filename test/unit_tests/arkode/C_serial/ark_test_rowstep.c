@@ -0,0 +1,160 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the ROWStep Rosenbrock time-stepping module. A mildly nonlinear
+ * stiff problem is integrated with each built-in method and the solution must
+ * be accurate. The W-method must need fewer Jacobian evaluations than the
+ * classical Rosenbrock method and evolving without a linear solver must fail.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_rowstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(10.0)
+
+#define NEQ 10
+
+/* y_i' = -1e4 (1 + 0.1 i) (y_i - sin(t)) - (y_i - sin(t))^2 + cos(t), the
+   solution is y_i = sin(t) */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunrealtype e;
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    e         = ydata[i] - sin(t);
+    yddata[i] = -SUN_RCONST(1.0e4) * (ONE + PT1 * i) * e - e * e + cos(t);
+  }
+
+  return 0;
+}
+
+/* Integrate to TF with the given method and check the solution, the number of
+   failed checks is returned in fails and the number of Jacobian evaluations
+   in nje */
+static int integrate(SUNContext sunctx, ARKODE_ROWTableID table, int* fails,
+                     long int* nje)
+{
+  int flag;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y         = NULL;
+  void* arkode_mem   = NULL;
+  sunrealtype tret   = ZERO;
+  sunrealtype err;
+  sunbooleantype wmethod;
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ZERO, y);
+
+  arkode_mem = ROWStepCreate(f, ZERO, y, sunctx);
+  if (!arkode_mem) { return 1; }
+
+  flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-8));
+  if (flag) { return 1; }
+
+  flag = ROWStepSetTableNum(arkode_mem, table);
+  if (flag) { return 1; }
+
+  /* evolving without a linear solver is an error */
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag != ARK_ILL_INPUT)
+  {
+    printf("ERROR: evolve without a linear solver returned %d\n", flag);
+    (*fails)++;
+  }
+
+  A  = SUNDenseMatrix(NEQ, NEQ, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = ARKodeSetLinearSolver(arkode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetMaxNumSteps(arkode_mem, 20000);
+  if (flag) { return 1; }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+
+  /* the exact solution is sin(TF) */
+  N_VAddConst(y, -sin(TF), y);
+  err = N_VMaxNorm(y);
+  if (err > SUN_RCONST(1.0e-4))
+  {
+    printf("ERROR: method %d solution error %g\n", (int)table, (double)err);
+    (*fails)++;
+  }
+
+  flag = ROWStepGetIsWMethod(arkode_mem, &wmethod);
+  if (flag) { return 1; }
+
+  if (wmethod != (table != ARKODE_ROS3P_3_2_3))
+  {
+    printf("ERROR: method %d has the wrong W-method flag\n", (int)table);
+    (*fails)++;
+  }
+
+  flag = ARKodeGetNumJacEvals(arkode_mem, nje);
+  if (flag) { return 1; }
+
+  ARKodeFree(&arkode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  SUNContext sunctx = NULL;
+  long int nje_ros2, nje_ros3p, nje_ros34pw2;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  if (integrate(sunctx, ARKODE_ROS2_2_1_2, &fails, &nje_ros2)) { return 1; }
+  if (integrate(sunctx, ARKODE_ROS3P_3_2_3, &fails, &nje_ros3p)) { return 1; }
+  if (integrate(sunctx, ARKODE_ROS34PW2_4_2_3, &fails, &nje_ros34pw2))
+  {
+    return 1;
+  }
+
+  /* W-methods reuse the Jacobian across steps */
+  if (nje_ros34pw2 >= nje_ros3p)
+  {
+    printf("ERROR: %ld Jacobian evaluations with ROS34PW2, %ld with ROS3P\n",
+           nje_ros34pw2, nje_ros3p);
+    fails++;
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
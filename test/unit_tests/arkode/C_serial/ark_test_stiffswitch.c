@@ -0,0 +1,213 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for automatic stiffness detection and method switching in ARKStep.
+ * A problem that is nonstiff except on the interval (10, 20) is integrated with
+ * an implicit method (argument 0) or an ImEx method (argument 1). ARKStep must
+ * switch to the explicit method and back, the solution must be accurate, and
+ * the switching statistics must be consistent with the step counter. An
+ * explicit table with the wrong number of stages must be rejected and the
+ * integration is repeated after a reset.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arkode/arkode_arkstep.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define HALF SUN_RCONST(0.5)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(30.0)
+
+#define NEQ 10
+
+/* lambda(t) = 1 in the nonstiff phases and about 1e4 on (10, 20) */
+static sunrealtype lambda(sunrealtype t)
+{
+  return ONE + SUN_RCONST(1.0e4) * HALF *
+                 (tanh(SUN_RCONST(5.0) * (t - SUN_RCONST(10.0))) -
+                  tanh(SUN_RCONST(5.0) * (t - SUN_RCONST(20.0))));
+}
+
+/* y_i' = -lambda(t) (1 + 0.1 i) (y_i - sin(t)) + cos(t), the solution is
+   y_i = sin(t), fi is the stiff relaxation term and fe is cos(t) */
+static int fi(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunrealtype lam     = lambda(t);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -lam * (ONE + PT1 * i) * (ydata[i] - sin(t));
+  }
+
+  return 0;
+}
+
+static int fe(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  N_VConst(cos(t), ydot);
+  return 0;
+}
+
+/* full right-hand side for the implicit method */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  fi(t, y, ydot, user_data);
+  N_VAddConst(ydot, cos(t), ydot);
+  return 0;
+}
+
+/* Integrate to TF and check the solution and switching statistics, the number
+   of failed checks is returned in fails */
+static int integrate(void* arkode_mem, N_Vector y, int* fails)
+{
+  int flag;
+  sunrealtype tret = ZERO;
+  sunrealtype err, rho;
+  sunbooleantype explicit_phase;
+  long int nst, nswitches, nsteps_explicit, nsteps_implicit;
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag < 0) { return 1; }
+
+  /* the exact solution is sin(TF) */
+  N_VAddConst(y, -sin(TF), y);
+  err = N_VMaxNorm(y);
+  if (err > SUN_RCONST(1.0e-4))
+  {
+    printf("ERROR: solution error %g\n", (double)err);
+    (*fails)++;
+  }
+
+  flag = ARKodeGetNumSteps(arkode_mem, &nst);
+  if (flag) { return 1; }
+
+  flag = ARKStepGetStiffnessSwitchingStats(arkode_mem, &nswitches,
+                                           &nsteps_explicit, &nsteps_implicit);
+  if (flag) { return 1; }
+
+  if (nswitches < 2)
+  {
+    printf("ERROR: %ld method switches, expected at least 2\n", nswitches);
+    (*fails)++;
+  }
+
+  /* the statistics are not reset by ARKodeReset */
+  if (nsteps_explicit <= 0 || nsteps_implicit <= 0 ||
+      nsteps_explicit + nsteps_implicit != nst)
+  {
+    printf("ERROR: %ld explicit and %ld implicit steps out of %ld steps\n",
+           nsteps_explicit, nsteps_implicit, nst);
+    (*fails)++;
+  }
+
+  flag = ARKStepGetStiffnessEstimate(arkode_mem, &rho, &explicit_phase);
+  if (flag) { return 1; }
+
+  if (rho <= ZERO || !explicit_phase)
+  {
+    printf("ERROR: nonstiff phase at TF not detected, rho = %g\n", (double)rho);
+    (*fails)++;
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int flag;
+  int imex             = 0;
+  int fails            = 0;
+  SUNContext sunctx    = NULL;
+  N_Vector y           = NULL;
+  SUNMatrix A          = NULL;
+  SUNLinearSolver LS   = NULL;
+  ARKodeButcherTable B = NULL;
+  void* arkode_mem     = NULL;
+  sunrealtype tret     = ZERO;
+
+  if (argc > 1) { imex = atoi(argv[1]); }
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ZERO, y);
+
+  if (imex) { arkode_mem = ARKStepCreate(fe, fi, ZERO, y, sunctx); }
+  else { arkode_mem = ARKStepCreate(NULL, f, ZERO, y, sunctx); }
+  if (!arkode_mem) { return 1; }
+
+  flag = ARKodeSStolerances(arkode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-8));
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(NEQ, NEQ, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = ARKodeSetLinearSolver(arkode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = ARKodeSetMaxNumSteps(arkode_mem, 20000);
+  if (flag) { return 1; }
+
+  flag = ARKStepSetStiffnessSwitching(arkode_mem, SUNTRUE);
+  if (flag) { return 1; }
+
+  /* the explicit table must have as many stages as the implicit table */
+  B = ARKodeButcherTable_LoadERK(ARKODE_HEUN_EULER_2_1_2);
+  if (!B) { return 1; }
+
+  flag = ARKStepSetStiffnessSwitchingTable(arkode_mem, B);
+  if (flag) { return 1; }
+
+  flag = ARKodeEvolve(arkode_mem, TF, y, &tret, ARK_NORMAL);
+  if (flag != ARK_ILL_INPUT)
+  {
+    printf("ERROR: explicit table with 2 stages returned %d\n", flag);
+    fails++;
+  }
+
+  /* restore the default table */
+  flag = ARKStepSetStiffnessSwitchingTable(arkode_mem, NULL);
+  if (flag) { return 1; }
+
+  if (integrate(arkode_mem, y, &fails)) { return 1; }
+
+  /* a reset restarts with the implicit method */
+  N_VConst(ZERO, y);
+  flag = ARKodeReset(arkode_mem, ZERO, y);
+  if (flag) { return 1; }
+
+  if (integrate(arkode_mem, y, &fails)) { return 1; }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  ARKodeButcherTable_Free(B);
+  ARKodeFree(&arkode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
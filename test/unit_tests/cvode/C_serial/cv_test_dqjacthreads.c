@@ -0,0 +1,181 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the thread-parallel CVODE difference quotient Jacobian
+ * approximations. A nonlinear tridiagonal problem is integrated with the dense
+ * and band DQ Jacobians using the serial loop and with several numbers of
+ * OpenMP threads. The solutions and the number of DQ RHS evaluations must match
+ * exactly. Without OpenMP, requesting more than one thread must fail.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_config.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_band.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_band.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+
+#define NEQ 12
+
+/* y_i' = -(i + 1) y_i + 0.1 (y_{i-1}^2 - y_{i+1}) */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -(i + 1) * ydata[i];
+    if (i > 0) { yddata[i] += PT1 * ydata[i - 1] * ydata[i - 1]; }
+    if (i < NEQ - 1) { yddata[i] -= PT1 * ydata[i + 1]; }
+  }
+
+  return 0;
+}
+
+/* Integrate to t = 1 with a dense (band = 0) or band (band = 1) matrix and
+   nthreads threads for the DQ Jacobian, the DQ RHS evaluation count is
+   returned in nfeLS */
+static int integrate(SUNContext sunctx, int band, int nthreads, N_Vector y,
+                     long int* nfeLS)
+{
+  int flag;
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  sunrealtype tret   = ZERO;
+
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  if (band)
+  {
+    A  = SUNBandMatrix(NEQ, 1, 1, sunctx);
+    LS = SUNLinSol_Band(y, A, sunctx);
+  }
+  else
+  {
+    A  = SUNDenseMatrix(NEQ, NEQ, sunctx);
+    LS = SUNLinSol_Dense(y, A, sunctx);
+  }
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  /* returns -1 if the number of threads is not supported */
+  flag = CVodeSetDQJacNumThreads(cvode_mem, nthreads);
+  if (flag)
+  {
+    CVodeFree(&cvode_mem);
+    SUNLinSolFree(LS);
+    SUNMatDestroy(A);
+    return (flag == CVLS_ILL_INPUT) ? -1 : 1;
+  }
+
+  flag = CVode(cvode_mem, ONE, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetNumLinRhsEvals(cvode_mem, nfeLS);
+  if (flag) { return 1; }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  SUNContext sunctx = NULL;
+  N_Vector y        = NULL;
+  N_Vector y_ref    = NULL;
+  int fails         = 0;
+  int band, k;
+  int nthreads[3] = {1, 2, 3};
+  long int nfeLS, nfeLS_ref;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+
+  y_ref = N_VClone(y);
+  if (!y_ref) { return 1; }
+
+  for (band = 0; band < 2; band++)
+  {
+    /* reference solution with the serial loop */
+    if (integrate(sunctx, band, 0, y_ref, &nfeLS_ref)) { return 1; }
+
+    for (k = 0; k < 3; k++)
+    {
+#if !defined(SUNDIALS_OPENMP_ENABLED)
+      if (nthreads[k] > 1)
+      {
+        if (integrate(sunctx, band, nthreads[k], y, &nfeLS) != -1)
+        {
+          printf("ERROR: %d threads accepted without OpenMP\n", nthreads[k]);
+          fails++;
+        }
+        continue;
+      }
+#endif
+
+      if (integrate(sunctx, band, nthreads[k], y, &nfeLS)) { return 1; }
+
+      N_VLinearSum(ONE, y, -ONE, y_ref, y);
+      if (N_VMaxNorm(y) > ZERO)
+      {
+        printf("ERROR: %s solution with %d threads differs from the "
+               "reference\n",
+               band ? "band" : "dense", nthreads[k]);
+        fails++;
+      }
+
+      if (nfeLS != nfeLS_ref)
+      {
+        printf("ERROR: %s DQ RHS evaluations %ld with %d threads, expected "
+               "%ld\n",
+               band ? "band" : "dense", nfeLS, nthreads[k], nfeLS_ref);
+        fails++;
+      }
+    }
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  N_VDestroy(y);
+  N_VDestroy(y_ref);
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,190 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for automatic Adams/BDF method switching in CVODE. A problem that
+ * is nonstiff except on the interval (10, 20) is integrated starting with the
+ * Adams method. CVODE must switch to BDF and back to Adams, the solution must
+ * be accurate, and the switching statistics must be consistent with the solver
+ * counters. The integration is repeated after a reinitialization and method
+ * switching must be rejected without a linear solver.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define HALF SUN_RCONST(0.5)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(30.0)
+
+#define NEQ 10
+
+/* y_i' = -lambda_i(t) (y_i - sin(t)) + cos(t) with lambda_i(t) = 1 in the
+   nonstiff phases and about 1e4 on (10, 20), the solution is y_i = sin(t) */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunrealtype lambda;
+  sunindextype i;
+
+  lambda = ONE + SUN_RCONST(1.0e4) * HALF *
+                   (tanh(SUN_RCONST(5.0) * (t - SUN_RCONST(10.0))) -
+                    tanh(SUN_RCONST(5.0) * (t - SUN_RCONST(20.0))));
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -lambda * (ONE + PT1 * i) * (ydata[i] - sin(t)) + cos(t);
+  }
+
+  return 0;
+}
+
+/* Integrate to TF and check the solution and switching statistics, the number
+   of failed checks is returned in fails */
+static int integrate(void* cvode_mem, N_Vector y, int* fails)
+{
+  int flag, lmm;
+  sunrealtype tret = ZERO;
+  sunrealtype err, tcur, time_adams, time_bdf;
+  long int nst, nswitches, nsteps_adams, nsteps_bdf;
+
+  flag = CVodeGetCurrentMethod(cvode_mem, &lmm);
+  if (flag) { return 1; }
+
+  if (lmm != CV_ADAMS)
+  {
+    printf("ERROR: integration does not start with the Adams method\n");
+    (*fails)++;
+  }
+
+  flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  /* the exact solution is sin(TF) */
+  N_VAddConst(y, -sin(TF), y);
+  err = N_VMaxNorm(y);
+  if (err > SUN_RCONST(1.0e-4))
+  {
+    printf("ERROR: solution error %g\n", (double)err);
+    (*fails)++;
+  }
+
+  flag = CVodeGetNumSteps(cvode_mem, &nst);
+  if (flag) { return 1; }
+
+  flag = CVodeGetCurrentTime(cvode_mem, &tcur);
+  if (flag) { return 1; }
+
+  flag = CVodeGetMethodSwitchingStats(cvode_mem, &nswitches, &nsteps_adams,
+                                      &nsteps_bdf, &time_adams, &time_bdf);
+  if (flag) { return 1; }
+
+  if (nswitches < 2)
+  {
+    printf("ERROR: %ld method switches, expected at least 2\n", nswitches);
+    (*fails)++;
+  }
+
+  if (nsteps_adams <= 0 || nsteps_bdf <= 0 || nsteps_adams + nsteps_bdf != nst)
+  {
+    printf("ERROR: %ld Adams and %ld BDF steps out of %ld steps\n",
+           nsteps_adams, nsteps_bdf, nst);
+    (*fails)++;
+  }
+
+  /* the internal time may be past TF */
+  if (SUNRabs(time_adams + time_bdf - tcur) > SUN_RCONST(1.0e-8) * tcur)
+  {
+    printf("ERROR: Adams time %g and BDF time %g do not sum to %g\n",
+           (double)time_adams, (double)time_bdf, (double)tcur);
+    (*fails)++;
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int flag;
+  int fails          = 0;
+  SUNContext sunctx  = NULL;
+  N_Vector y         = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  void* cvode_mem    = NULL;
+  sunrealtype tret   = ZERO;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ZERO, y);
+
+  cvode_mem = CVodeCreate(CV_ADAMS, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-8));
+  if (flag) { return 1; }
+
+  flag = CVodeSetMaxNumSteps(cvode_mem, 5000);
+  if (flag) { return 1; }
+
+  /* switching requires a linear solver for the BDF steps */
+  flag = CVodeSetMethodSwitching(cvode_mem, SUNTRUE);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+  if (flag != CV_ILL_INPUT)
+  {
+    printf("ERROR: method switching without a linear solver returned %d\n",
+           flag);
+    fails++;
+  }
+
+  A  = SUNDenseMatrix(NEQ, NEQ, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  if (integrate(cvode_mem, y, &fails)) { return 1; }
+
+  /* reinitialization restarts with the Adams method */
+  N_VConst(ZERO, y);
+  flag = CVodeReInit(cvode_mem, ZERO, y);
+  if (flag) { return 1; }
+
+  if (integrate(cvode_mem, y, &fails)) { return 1; }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,182 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the CVODE linear solver setup cost model. A nonlinear
+ * tridiagonal problem is integrated with the default heuristic policy and with
+ * the cost model. The solutions must agree to within the tolerances and the
+ * cost model statistics must be consistent with the solver counters. Invalid
+ * policies must be rejected.
+ * ---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define PT1  SUN_RCONST(0.1)
+#define ONE  SUN_RCONST(1.0)
+
+#define NEQ 12
+
+/* y_i' = -(i + 1) y_i + 0.1 (y_{i-1}^2 - y_{i+1}) + sin(t) */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    yddata[i] = -(i + 1) * ydata[i] + sin(t);
+    if (i > 0) { yddata[i] += PT1 * ydata[i - 1] * ydata[i - 1]; }
+    if (i < NEQ - 1) { yddata[i] -= PT1 * ydata[i + 1]; }
+  }
+
+  return 0;
+}
+
+/* Integrate to t = 10 with the given setup policy and check the cost model
+   statistics, the number of failed checks is returned in fails */
+static int integrate(SUNContext sunctx, int policy, N_Vector y, int* fails)
+{
+  int flag;
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  sunrealtype tret   = ZERO;
+  long int nsetups, njevals, nsetups_model, njevals_model;
+  double jac_time, setup_time, nls_time;
+
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(NEQ, NEQ, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  if (CVodeSetLSetupPolicy(cvode_mem, -1) != CV_ILL_INPUT)
+  {
+    printf("ERROR: invalid setup policy accepted\n");
+    (*fails)++;
+  }
+
+  flag = CVodeSetLSetupPolicy(cvode_mem, policy);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, SUN_RCONST(10.0), y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetNumLinSolvSetups(cvode_mem, &nsetups);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumJacEvals(cvode_mem, &njevals);
+  if (flag) { return 1; }
+
+  flag = CVodeGetLSetupPolicyStats(cvode_mem, &nsetups_model, &njevals_model,
+                                   &jac_time, &setup_time, &nls_time);
+  if (flag) { return 1; }
+
+  if (nsetups_model < 0 || nsetups_model > nsetups)
+  {
+    printf("ERROR: %ld cost model setups out of %ld setups\n", nsetups_model,
+           nsetups);
+    (*fails)++;
+  }
+
+  if (njevals_model < 0 || njevals_model > njevals)
+  {
+    printf("ERROR: %ld cost model Jacobian updates out of %ld updates\n",
+           njevals_model, njevals);
+    (*fails)++;
+  }
+
+  if (jac_time < 0.0 || setup_time < jac_time || nls_time < 0.0)
+  {
+    printf("ERROR: inconsistent timings, jac %g setup %g nls %g\n", jac_time,
+           setup_time, nls_time);
+    (*fails)++;
+  }
+
+  if (policy == CV_LSETUP_HEURISTIC &&
+      (nsetups_model || njevals_model || setup_time > 0.0 || nls_time > 0.0))
+  {
+    printf("ERROR: cost model statistics collected by the heuristic policy\n");
+    (*fails)++;
+  }
+
+  if (policy == CV_LSETUP_COST_MODEL && setup_time <= 0.0)
+  {
+    printf("ERROR: no setup time recorded by the cost model\n");
+    (*fails)++;
+  }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  SUNContext sunctx = NULL;
+  N_Vector y        = NULL;
+  N_Vector y_ref    = NULL;
+  int fails         = 0;
+  sunrealtype err;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+
+  y_ref = N_VClone(y);
+  if (!y_ref) { return 1; }
+
+  if (integrate(sunctx, CV_LSETUP_HEURISTIC, y_ref, &fails)) { return 1; }
+  if (integrate(sunctx, CV_LSETUP_COST_MODEL, y, &fails)) { return 1; }
+
+  /* both policies solve the same problem to the same tolerances */
+  N_VLinearSum(ONE, y, -ONE, y_ref, y);
+  err = N_VMaxNorm(y);
+  if (err > SUN_RCONST(1.0e-4))
+  {
+    printf("ERROR: cost model solution differs from the reference by %g\n",
+           (double)err);
+    fails++;
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  N_VDestroy(y);
+  N_VDestroy(y_ref);
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
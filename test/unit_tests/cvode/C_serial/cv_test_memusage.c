@@ -0,0 +1,157 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the SUNContext memory accounting. A CVODE instance with a
+ * dense matrix and linear solver is created and freed, every subsystem must
+ * report a nonzero high-water mark and no bytes in use at the end.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+
+#define NEQ 10
+
+static const char* names[] = {"N_Vector", "SUNMatrix", "SUNLinearSolver",
+                              "SUNNonlinearSolver", "Integrator", "Total"};
+
+/* Diagonal problem y_i' = -(i + 1) * y_i */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++) { yddata[i] = -(i + 1) * ydata[i]; }
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  SUNContext sunctx  = NULL;
+  N_Vector y         = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  void* cvode_mem    = NULL;
+  sunrealtype tret   = ZERO;
+  int flag           = 0;
+  int fails          = 0;
+  int k;
+  size_t current, peak, vec_bytes;
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &sunctx);
+  if (flag) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  /* a single vector accounts for at least its data */
+  flag = SUNContext_GetMemoryUsage(sunctx, SUN_MEMSUBSYSTEM_NVECTOR, &vec_bytes,
+                                   NULL);
+  if (flag) { return 1; }
+  if (vec_bytes < NEQ * sizeof(sunrealtype))
+  {
+    printf("ERROR: vector usage %zu is too small\n", vec_bytes);
+    fails++;
+  }
+
+  A = SUNDenseMatrix(NEQ, NEQ, sunctx);
+  if (!A) { return 1; }
+
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!LS) { return 1; }
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, ONE, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = SUNContext_PrintMemoryUsage(sunctx, stdout, SUN_OUTPUTFORMAT_TABLE);
+  if (flag) { return 1; }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+
+  /* only y is left in use */
+  flag = SUNContext_GetMemoryUsage(sunctx, SUN_MEMSUBSYSTEM_TOTAL, &current,
+                                   &peak);
+  if (flag) { return 1; }
+  if (current != vec_bytes || peak <= current)
+  {
+    printf("ERROR: total usage %zu (peak %zu) after freeing CVODE\n", current,
+           peak);
+    fails++;
+  }
+
+  N_VDestroy(y);
+
+  for (k = 0; k <= SUN_MEMSUBSYSTEM_TOTAL; k++)
+  {
+    flag = SUNContext_GetMemoryUsage(sunctx, (SUNMemorySubsystem)k, &current,
+                                     &peak);
+    if (flag) { return 1; }
+    if (current != 0 || peak == 0)
+    {
+      printf("ERROR: %s usage %zu, peak %zu\n", names[k], current, peak);
+      fails++;
+    }
+  }
+
+  flag = SUNContext_PrintMemoryUsage(sunctx, stdout, SUN_OUTPUTFORMAT_CSV);
+  if (flag) { return 1; }
+
+  /* peaks drop to the current usage after a reset */
+  flag = SUNContext_ResetMemoryPeaks(sunctx);
+  if (flag) { return 1; }
+
+  flag = SUNContext_GetMemoryUsage(sunctx, SUN_MEMSUBSYSTEM_TOTAL, &current,
+                                   &peak);
+  if (flag || peak != 0)
+  {
+    printf("ERROR: peak %zu after reset\n", peak);
+    fails++;
+  }
+
+  flag = SUNContext_GetMemoryUsage(sunctx, SUN_MEMSUBSYSTEM_TOTAL + 1, &current,
+                                   &peak);
+  if (flag != SUN_ERR_ARG_OUTOFRANGE)
+  {
+    printf("ERROR: invalid subsystem was not rejected\n");
+    fails++;
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
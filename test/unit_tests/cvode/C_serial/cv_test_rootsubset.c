@@ -0,0 +1,380 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the scalable root search. The crossings of y1 = sin(t) with
+ * many levels are located with the full root search, with the scalable search
+ * and the full root function, and with the scalable search and a root function
+ * that only evaluates the requested subset. The roots returned must agree and
+ * the subset function must evaluate far fewer components than the full search.
+ * A root function that is zero at the initial time must be reactivated at the
+ * root of another function to find its own root in the same step.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(7.0)
+
+#define NRT   1000
+#define MAXRT (4 * NRT)
+
+#define T0ROOT SUN_RCONST(1.2)
+#define T1ROOT SUN_RCONST(1.5)
+
+typedef struct
+{
+  sunrealtype c[NRT]; /* crossing levels                      */
+  long int ncomp;     /* number of evaluated root components */
+} UserData;
+
+/* y1' = y2, y2' = -y1 */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+
+  yddata[0] = ydata[1];
+  yddata[1] = -ydata[0];
+
+  return 0;
+}
+
+/* g_i = y1 - c_i */
+static int g(sunrealtype t, N_Vector y, sunrealtype* gout, void* user_data)
+{
+  UserData* data = (UserData*)user_data;
+  sunrealtype yv = N_VGetArrayPointer(y)[0];
+  int i;
+
+  for (i = 0; i < NRT; i++) { gout[i] = yv - data->c[i]; }
+  data->ncomp += NRT;
+
+  return 0;
+}
+
+/* g_i = y1 - c_i for the requested components only */
+static int gsub(sunrealtype t, N_Vector y, int nsub, const int* isub,
+                sunrealtype* gout, void* user_data)
+{
+  UserData* data = (UserData*)user_data;
+  sunrealtype yv = N_VGetArrayPointer(y)[0];
+  int k;
+
+  for (k = 0; k < nsub; k++) { gout[isub[k]] = yv - data->c[isub[k]]; }
+  data->ncomp += nsub;
+
+  return 0;
+}
+
+/* y' = 0 */
+static int fzero(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  N_VConst(ZERO, ydot);
+  return 0;
+}
+
+/* g_0 = t - 1.2 and g_1 = 0 for t < 1 and t - 1.5 otherwise, so g_1 is
+   inactive from the initial time until it becomes nonzero */
+static sunrealtype ginact_comp(sunrealtype t, int i)
+{
+  if (i == 0) { return t - T0ROOT; }
+  return (t < ONE) ? ZERO : t - T1ROOT;
+}
+
+static int ginact(sunrealtype t, N_Vector y, sunrealtype* gout, void* user_data)
+{
+  gout[0] = ginact_comp(t, 0);
+  gout[1] = ginact_comp(t, 1);
+
+  return 0;
+}
+
+static int ginact_sub(sunrealtype t, N_Vector y, int nsub, const int* isub,
+                      sunrealtype* gout, void* user_data)
+{
+  int k;
+
+  for (k = 0; k < nsub; k++) { gout[isub[k]] = ginact_comp(t, isub[k]); }
+
+  return 0;
+}
+
+/* Integrate to TF and record the root times and a checksum of the roots found
+   at each return. The mode is 0 for the full search, 1 for the scalable search
+   and 2 for the scalable search with the subset function. */
+static int run_roots(SUNContext sunctx, int mode, int* nroots,
+                     sunrealtype* troot, long int* rsum, long int* ncomp)
+{
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y;
+  UserData data;
+  sunrealtype tret;
+  int flag, i, rootsfound[NRT];
+
+  for (i = 0; i < NRT; i++)
+  {
+    data.c[i] = SUN_RCONST(-0.95) + SUN_RCONST(1.9) * i / (NRT - 1);
+  }
+  data.ncomp = 0;
+
+  y = N_VNew_Serial(2, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ZERO, y);
+  N_VGetArrayPointer(y)[1] = ONE;
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetUserData(cvode_mem, &data);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(2, 2, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeRootInit(cvode_mem, NRT, g);
+  if (flag) { return 1; }
+
+  if (mode > 0)
+  {
+    flag = CVodeSetScalableRootfinding(cvode_mem, SUNTRUE);
+    if (flag) { return 1; }
+  }
+
+  if (mode > 1)
+  {
+    flag = CVodeSetRootSubsetFn(cvode_mem, gsub);
+    if (flag) { return 1; }
+  }
+
+  *nroots = 0;
+  for (;;)
+  {
+    flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+    if (flag < 0) { return 1; }
+    if (flag != CV_ROOT_RETURN) { break; }
+    if (*nroots == MAXRT) { return 1; }
+
+    flag = CVodeGetRootInfo(cvode_mem, rootsfound);
+    if (flag) { return 1; }
+
+    troot[*nroots] = tret;
+    rsum[*nroots]  = 0;
+    for (i = 0; i < NRT; i++) { rsum[*nroots] += (i + 1) * rootsfound[i]; }
+    (*nroots)++;
+  }
+
+  *ncomp = data.ncomp;
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+/* Integrate y' = 0 to TF with the root functions ginact and record the root
+   times and the index of the root found at each return. The first step covers
+   t = 1, 1.2 and 1.5, so g_1 is still inactive when the root of g_0 is found
+   and must be reactivated there. The mode is as in run_roots. */
+static int run_reactivation(SUNContext sunctx, int mode, int* nroots,
+                            sunrealtype* troot, int* iroot)
+{
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y;
+  sunrealtype tret;
+  int flag, rootsfound[2];
+
+  y = N_VNew_Serial(1, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, fzero, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetInitStep(cvode_mem, SUN_RCONST(2.0));
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(1, 1, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeRootInit(cvode_mem, 2, ginact);
+  if (flag) { return 1; }
+
+  if (mode > 0)
+  {
+    flag = CVodeSetScalableRootfinding(cvode_mem, SUNTRUE);
+    if (flag) { return 1; }
+  }
+
+  if (mode > 1)
+  {
+    flag = CVodeSetRootSubsetFn(cvode_mem, ginact_sub);
+    if (flag) { return 1; }
+  }
+
+  *nroots = 0;
+  for (;;)
+  {
+    flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+    if (flag < 0) { return 1; }
+    if (flag != CV_ROOT_RETURN) { break; }
+    if (*nroots == 2) { return 1; }
+
+    flag = CVodeGetRootInfo(cvode_mem, rootsfound);
+    if (flag) { return 1; }
+
+    troot[*nroots] = tret;
+    iroot[*nroots] = rootsfound[0] ? 0 : 1;
+    (*nroots)++;
+  }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int mode, i, nref, nroots;
+  SUNContext sunctx = NULL;
+  sunrealtype *tref, *troot, diff;
+  long int *rref, *rsum, ncref, ncomp;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  tref  = (sunrealtype*)malloc(MAXRT * sizeof(sunrealtype));
+  troot = (sunrealtype*)malloc(MAXRT * sizeof(sunrealtype));
+  rref  = (long int*)malloc(MAXRT * sizeof(long int));
+  rsum  = (long int*)malloc(MAXRT * sizeof(long int));
+  if (!tref || !troot || !rref || !rsum) { return 1; }
+
+  /* full root search */
+  if (run_roots(sunctx, 0, &nref, tref, rref, &ncref)) { return 1; }
+  printf("full search: %d roots, %ld components evaluated\n", nref, ncref);
+  if (nref < 2 * NRT)
+  {
+    printf("ERROR: expected at least %d roots\n", 2 * NRT);
+    fails++;
+  }
+
+  /* scalable root search without and with the subset function */
+  for (mode = 1; mode < 3; mode++)
+  {
+    if (run_roots(sunctx, mode, &nroots, troot, rsum, &ncomp)) { return 1; }
+    printf("scalable search%s: %d roots, %ld components evaluated\n",
+           mode > 1 ? " with subsets" : "", nroots, ncomp);
+
+    if (nroots != nref)
+    {
+      printf("ERROR: %d roots instead of %d\n", nroots, nref);
+      fails++;
+      continue;
+    }
+
+    diff = ZERO;
+    for (i = 0; i < nroots; i++)
+    {
+      if (rsum[i] != rref[i])
+      {
+        printf("ERROR: different roots found at return %d\n", i);
+        fails++;
+        break;
+      }
+      diff = SUNMAX(diff, SUNRabs(troot[i] - tref[i]));
+    }
+    printf("difference in root times %" GSYM "\n", diff);
+    if (diff > SUN_RCONST(1.0e-12))
+    {
+      printf("ERROR: difference %" GSYM "\n", diff);
+      fails++;
+    }
+
+    if (mode > 1 && 2 * ncomp > ncref)
+    {
+      printf("ERROR: the subset search is not cheaper than the full search\n");
+      fails++;
+    }
+  }
+
+  /* reactivation of a root function at a root of another one */
+  for (mode = 0; mode < 3; mode++)
+  {
+    sunrealtype tinact[2];
+    int iinact[2];
+
+    if (run_reactivation(sunctx, mode, &nroots, tinact, iinact)) { return 1; }
+    printf("reactivation with mode %d: %d roots\n", mode, nroots);
+
+    if (nroots != 2 || iinact[0] != 0 || iinact[1] != 1 ||
+        SUNRabs(tinact[0] - T0ROOT) > SUN_RCONST(1.0e-10) ||
+        SUNRabs(tinact[1] - T1ROOT) > SUN_RCONST(1.0e-10))
+    {
+      printf("ERROR: the roots at %" GSYM " and %" GSYM " were not found\n",
+             T0ROOT, T1ROOT);
+      fails++;
+    }
+  }
+
+  free(tref);
+  free(troot);
+  free(rref);
+  free(rsum);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
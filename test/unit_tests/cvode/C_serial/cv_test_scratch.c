@@ -0,0 +1,169 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the SUNContext scratch vector pool. Two CVODE + SPGMR
+ * instances sharing a context integrate the same problem one after the other
+ * and the results are compared to an integration with private workspaces.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_spgmr.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+
+#define NEQ  20
+#define MAXL 5
+
+/* Diagonal problem y_i' = -(i + 1) * y_i */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  sunindextype i;
+
+  for (i = 0; i < NEQ; i++) { yddata[i] = -(i + 1) * ydata[i]; }
+
+  return 0;
+}
+
+/* Create CVODE with SPGMR and integrate to tout, the solution is returned in
+   y and the workspace sizes in lenrw and lenrwls */
+static int integrate(SUNContext sunctx, N_Vector y, long int* lenrw,
+                     long int* lenrwls)
+{
+  int flag;
+  void* cvode_mem    = NULL;
+  SUNLinearSolver LS = NULL;
+  sunrealtype tret   = ZERO;
+  long int leniw, leniwls;
+
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  LS = SUNLinSol_SPGMR(y, SUN_PREC_NONE, MAXL, sunctx);
+  if (!LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, NULL);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, ONE, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetWorkSpace(cvode_mem, lenrw, &leniw);
+  if (flag) { return 1; }
+
+  flag = SUNLinSolSpace(LS, lenrwls, &leniwls);
+  if (flag) { return 1; }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  SUNContext sunctx     = NULL;
+  SUNContext sunctx_ref = NULL;
+  N_Vector y            = NULL;
+  N_Vector y_ref        = NULL;
+  int flag              = 0;
+  int fails             = 0;
+  int k;
+  long int nvectors, lenrw_pool, leniw_pool;
+  long int lenrw, lenrwls, lenrw_ref, lenrwls_ref;
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &sunctx);
+  if (flag) { return 1; }
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &sunctx_ref);
+  if (flag) { return 1; }
+
+  flag = SUNContext_SetScratchSharing(sunctx, SUNTRUE);
+  if (flag) { return 1; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+
+  y_ref = N_VNew_Serial(NEQ, sunctx_ref);
+  if (!y_ref) { return 1; }
+
+  /* reference solution with private workspaces */
+  if (integrate(sunctx_ref, y_ref, &lenrw_ref, &lenrwls_ref)) { return 1; }
+
+  /* integrate twice with the shared pool, the second instance must reuse the
+     vectors created for the first */
+  for (k = 0; k < 2; k++)
+  {
+    if (integrate(sunctx, y, &lenrw, &lenrwls)) { return 1; }
+
+    N_VLinearSum(ONE, y, -ONE, y_ref, y);
+    if (N_VMaxNorm(y) > ZERO)
+    {
+      printf("ERROR: solution %d differs from the reference\n", k);
+      fails++;
+    }
+
+    flag = SUNContext_GetScratchSpace(sunctx, &nvectors, &lenrw_pool,
+                                      &leniw_pool);
+    if (flag) { return 1; }
+
+    /* three CVODE temporaries plus the SPGMR Krylov basis */
+    if (nvectors != 3 + MAXL + 1 || lenrw_pool != (3 + MAXL + 1) * NEQ)
+    {
+      printf("ERROR: pool has %ld vectors after instance %d\n", nvectors, k);
+      fails++;
+    }
+
+    /* the borrowed vectors are not counted in the object workspaces */
+    if (lenrw != lenrw_ref - 3 * NEQ ||
+        lenrwls != lenrwls_ref - (MAXL + 1) * NEQ)
+    {
+      printf("ERROR: workspace sizes do not account for the pool\n");
+      fails++;
+    }
+  }
+
+  flag = SUNContext_FreeScratchVectors(sunctx);
+  if (flag) { return 1; }
+
+  flag = SUNContext_GetScratchSpace(sunctx, &nvectors, &lenrw_pool,
+                                    &leniw_pool);
+  if (flag || nvectors != 0)
+  {
+    printf("ERROR: pool is not empty after freeing the scratch vectors\n");
+    fails++;
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  N_VDestroy(y);
+  N_VDestroy(y_ref);
+  SUNContext_Free(&sunctx);
+  SUNContext_Free(&sunctx_ref);
+
+  return fails;
+}
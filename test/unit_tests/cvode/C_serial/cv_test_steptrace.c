@@ -0,0 +1,226 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the binary step trace. The per-step records written by CVODE
+ * are read back from the trace file and compared to the integrator statistics.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cvode/cvode.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_steptrace.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+
+#define TRACE_FILE "cv_test_steptrace.bin"
+
+/* Size of the trace file header */
+#define HEADER_SIZE 64
+
+/* Dahlquist problem y' = lambda * y */
+static int ode_rhs(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype lambda = *((sunrealtype*)user_data);
+  N_VScale(lambda, y, ydot);
+  return 0;
+}
+
+static int ode_jac(sunrealtype t, N_Vector y, N_Vector f, SUNMatrix J,
+                   void* user_data, N_Vector tempv1, N_Vector tempv2,
+                   N_Vector tempv3)
+{
+  sunrealtype lambda = *((sunrealtype*)user_data);
+  SUNDenseMatrix_Data(J)[0] = lambda;
+  return 0;
+}
+
+/* Read the records from the trace file and accumulate the counters */
+static int check_trace(const char* fname, int64_t capacity, long int nst,
+                       long int nni, long int netf, long int nsetups,
+                       long int nje)
+{
+  FILE* fp = NULL;
+  char header[HEADER_SIZE];
+  int64_t nrecords, i;
+  SUNStepTraceRecord record;
+  long int sum_nni = 0, sum_netf = 0, sum_nsetups = 0, sum_nje = 0;
+
+  fp = fopen(fname, "rb");
+  if (!fp)
+  {
+    printf("ERROR: could not open %s\n", fname);
+    return 1;
+  }
+
+  if (fread(header, 1, HEADER_SIZE, fp) != HEADER_SIZE)
+  {
+    printf("ERROR: could not read trace header\n");
+    fclose(fp);
+    return 1;
+  }
+
+  if (strncmp(header, "SUNTRACE", 8))
+  {
+    printf("ERROR: trace header magic is incorrect\n");
+    fclose(fp);
+    return 1;
+  }
+
+  /* total number of records written is stored after the capacity */
+  memcpy(&nrecords, header + 24, sizeof(int64_t));
+  if (nrecords != nst || nrecords > capacity)
+  {
+    printf("ERROR: trace has %lld records, expected %ld\n",
+           (long long)nrecords, nst);
+    fclose(fp);
+    return 1;
+  }
+
+  for (i = 0; i < nrecords; i++)
+  {
+    if (fread(&record, sizeof(SUNStepTraceRecord), 1, fp) != 1)
+    {
+      printf("ERROR: could not read record %lld\n", (long long)i);
+      fclose(fp);
+      return 1;
+    }
+    if (record.solver != SUN_STEPTRACE_CVODE || record.step != i + 1 ||
+        record.flag != CV_SUCCESS || record.order < 1 || record.h <= 0.0)
+    {
+      printf("ERROR: record %lld is incorrect\n", (long long)i);
+      fclose(fp);
+      return 1;
+    }
+    sum_nni += record.nni;
+    sum_netf += record.netf;
+    sum_nsetups += record.nsetups;
+    sum_nje += record.njevals;
+  }
+  fclose(fp);
+
+  printf("nst = %ld, nni = %ld, netf = %ld, nsetups = %ld, nje = %ld\n", nst,
+         sum_nni, sum_netf, sum_nsetups, sum_nje);
+
+  if (sum_nni != nni || sum_netf != netf || sum_nsetups != nsetups ||
+      sum_nje != nje)
+  {
+    printf("ERROR: trace counters do not match the integrator statistics\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  SUNContext sunctx  = NULL;
+  SUNStepTrace trace = NULL;
+  N_Vector y         = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  void* cvode_mem    = NULL;
+
+  int flag           = 0;
+  int64_t capacity   = 10000;
+  sunrealtype lambda = SUN_RCONST(-100.0);
+  sunrealtype tout   = SUN_RCONST(10.0);
+  sunrealtype tret   = ZERO;
+  long int nst       = 0;
+  long int nni       = 0;
+  long int netf      = 0;
+  long int nsetups   = 0;
+  long int nje       = 0;
+
+  flag = SUNContext_Create(SUN_COMM_NULL, &sunctx);
+  if (flag) { return 1; }
+
+  flag = SUNStepTrace_Create(TRACE_FILE, capacity, &trace);
+  if (flag)
+  {
+    fprintf(stderr, "SUNStepTrace_Create returned %i\n", flag);
+    return 1;
+  }
+
+  flag = SUNContext_SetStepTrace(sunctx, trace);
+  if (flag) { return 1; }
+
+  y = N_VNew_Serial(1, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, ode_rhs, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSetUserData(cvode_mem, &lambda);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-6), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  A = SUNDenseMatrix(1, 1, sunctx);
+  if (!A) { return 1; }
+
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeSetJacFn(cvode_mem, ode_jac);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, tout, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetNumSteps(cvode_mem, &nst);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumErrTestFails(cvode_mem, &netf);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumLinSolvSetups(cvode_mem, &nsetups);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumJacEvals(cvode_mem, &nje);
+  if (flag) { return 1; }
+
+  /* detach and close the trace before reading the file */
+  flag = SUNContext_SetStepTrace(sunctx, NULL);
+  if (flag) { return 1; }
+
+  flag = SUNStepTrace_Destroy(&trace);
+  if (flag) { return 1; }
+
+  flag = check_trace(TRACE_FILE, capacity, nst, nni, netf, nsetups, nje);
+
+  if (flag) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  N_VDestroy(y);
+  SUNMatDestroy(A);
+  SUNLinSolFree(LS);
+  CVodeFree(&cvode_mem);
+  SUNContext_Free(&sunctx);
+
+  return flag;
+}
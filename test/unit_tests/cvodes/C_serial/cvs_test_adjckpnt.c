@@ -0,0 +1,261 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the adjoint check point budget. The adjoint of the
+ * Lotka-Volterra problem is computed with all check points and with a budget
+ * of a few check points. The budget must be respected after the forward run,
+ * and the adjoint solution must match the one with all check points, also in
+ * a second backward sweep.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvodes/cvodes.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(20.0)
+
+#define NSTEPS 5
+#define MAXCK  4
+
+/* y1' = y1 - y1 y2, y2' = -y2 + y1 y2 */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+
+  yddata[0] = ydata[0] - ydata[0] * ydata[1];
+  yddata[1] = -ydata[1] + ydata[0] * ydata[1];
+
+  return 0;
+}
+
+/* yB' = -J^T yB */
+static int fB(sunrealtype t, N_Vector y, N_Vector yB, N_Vector yBdot,
+              void* user_dataB)
+{
+  sunrealtype* ydata   = N_VGetArrayPointer(y);
+  sunrealtype* yBdata  = N_VGetArrayPointer(yB);
+  sunrealtype* yBddata = N_VGetArrayPointer(yBdot);
+
+  yBddata[0] = -((ONE - ydata[1]) * yBdata[0] + ydata[1] * yBdata[1]);
+  yBddata[1] = -(-ydata[0] * yBdata[0] + (ydata[0] - ONE) * yBdata[1]);
+
+  return 0;
+}
+
+/* Solve the forward problem and two backward sweeps for the gradient of
+   y1(TF) with at most maxck check points (0 = all), the results of the two
+   sweeps are returned in yB1 and yB2 */
+static int run_adjoint(SUNContext sunctx, int maxck, N_Vector yB1, N_Vector yB2)
+{
+  void* cvode_mem     = NULL;
+  SUNMatrix A         = NULL;
+  SUNMatrix AB        = NULL;
+  SUNLinearSolver LS  = NULL;
+  SUNLinearSolver LSB = NULL;
+  CVadjCheckPointRec* ckpnt;
+  N_Vector y, yB;
+  sunrealtype tret;
+  int flag, ncheck, nck, which, sweep;
+
+  y  = N_VNew_Serial(2, sunctx);
+  yB = N_VNew_Serial(2, sunctx);
+  if (!y || !yB) { return 1; }
+  N_VConst(ONE, y);
+  N_VGetArrayPointer(y)[1] = SUN_RCONST(0.5);
+
+  /* forward problem */
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetMaxNumSteps(cvode_mem, 5000);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(2, 2, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeAdjInit(cvode_mem, NSTEPS, CV_HERMITE);
+  if (flag) { return 1; }
+
+  flag = CVodeSetAdjMaxCheckpoints(cvode_mem, maxck);
+  if (flag) { return 1; }
+
+  flag = CVodeF(cvode_mem, TF, y, &tret, CV_NORMAL, &ncheck);
+  if (flag < 0) { return 1; }
+
+  /* count the stored check points */
+  ckpnt = (CVadjCheckPointRec*)malloc((ncheck + 1) * sizeof(CVadjCheckPointRec));
+  if (!ckpnt) { return 1; }
+
+  flag = CVodeGetAdjCheckPointsInfo(cvode_mem, ckpnt);
+  if (flag) { return 1; }
+
+  nck = 1;
+  while (ckpnt[nck - 1].next_addr != NULL) { nck++; }
+  free(ckpnt);
+
+  printf("maxck %d: %d check points created, %d stored\n", maxck, ncheck, nck);
+
+  if (maxck > 0 && (nck > maxck || ncheck < 2 * maxck))
+  {
+    printf("ERROR: %d check points stored with a budget of %d\n", nck, maxck);
+    return 1;
+  }
+
+  /* backward problem */
+  flag = CVodeCreateB(cvode_mem, CV_BDF, &which);
+  if (flag) { return 1; }
+
+  N_VConst(ZERO, yB);
+  N_VGetArrayPointer(yB)[0] = ONE;
+
+  flag = CVodeInitB(cvode_mem, which, fB, TF, yB);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerancesB(cvode_mem, which, SUN_RCONST(1.0e-8),
+                            SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  AB  = SUNDenseMatrix(2, 2, sunctx);
+  LSB = SUNLinSol_Dense(yB, AB, sunctx);
+  if (!AB || !LSB) { return 1; }
+
+  flag = CVodeSetLinearSolverB(cvode_mem, which, LSB, AB);
+  if (flag) { return 1; }
+
+  for (sweep = 0; sweep < 2; sweep++)
+  {
+    if (sweep > 0)
+    {
+      N_VConst(ZERO, yB);
+      N_VGetArrayPointer(yB)[0] = ONE;
+
+      flag = CVodeReInitB(cvode_mem, which, TF, yB);
+      if (flag) { return 1; }
+    }
+
+    /* stop halfway once to resume within an interval */
+    flag = CVodeB(cvode_mem, SUN_RCONST(7.3), CV_NORMAL);
+    if (flag < 0) { return 1; }
+
+    flag = CVodeB(cvode_mem, ZERO, CV_NORMAL);
+    if (flag < 0) { return 1; }
+
+    flag = CVodeGetB(cvode_mem, which, &tret, (sweep == 0) ? yB1 : yB2);
+    if (flag) { return 1; }
+  }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNLinSolFree(LSB);
+  SUNMatDestroy(A);
+  SUNMatDestroy(AB);
+  N_VDestroy(y);
+  N_VDestroy(yB);
+
+  return 0;
+}
+
+/* Max difference between two vectors */
+static sunrealtype max_diff(N_Vector x, N_Vector y)
+{
+  sunrealtype* xdata = N_VGetArrayPointer(x);
+  sunrealtype* ydata = N_VGetArrayPointer(y);
+
+  return SUNMAX(SUNRabs(xdata[0] - ydata[0]), SUNRabs(xdata[1] - ydata[1]));
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  SUNContext sunctx = NULL;
+  N_Vector yB1, yB2, yBref;
+  sunrealtype diff;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  yBref = N_VNew_Serial(2, sunctx);
+  yB1   = N_VNew_Serial(2, sunctx);
+  yB2   = N_VNew_Serial(2, sunctx);
+  if (!yBref || !yB1 || !yB2) { return 1; }
+
+  /* all check points */
+  if (run_adjoint(sunctx, 0, yBref, yB2)) { return 1; }
+  printf("yB(0) = %" GSYM " %" GSYM "\n", N_VGetArrayPointer(yBref)[0],
+         N_VGetArrayPointer(yBref)[1]);
+
+  /* check point budget */
+  if (run_adjoint(sunctx, MAXCK, yB1, yB2)) { return 1; }
+
+  diff = max_diff(yB1, yBref);
+  printf("difference to all check points %" GSYM "\n", diff);
+  if (diff > SUN_RCONST(1.0e-10))
+  {
+    printf("ERROR: difference %" GSYM "\n", diff);
+    fails++;
+  }
+
+  diff = max_diff(yB2, yBref);
+  printf("second sweep difference to all check points %" GSYM "\n", diff);
+  if (diff > SUN_RCONST(1.0e-10))
+  {
+    printf("ERROR: second sweep difference %" GSYM "\n", diff);
+    fails++;
+  }
+
+  /* a budget of two check points is illegal */
+  {
+    void* cvode_mem = CVodeCreate(CV_BDF, sunctx);
+    if (!cvode_mem) { return 1; }
+    if (CVodeInit(cvode_mem, f, ZERO, yB1)) { return 1; }
+    if (CVodeAdjInit(cvode_mem, NSTEPS, CV_HERMITE)) { return 1; }
+    if (CVodeSetAdjMaxCheckpoints(cvode_mem, 2) != CV_ILL_INPUT)
+    {
+      printf("ERROR: budget of two check points accepted\n");
+      fails++;
+    }
+    CVodeFree(&cvode_mem);
+  }
+
+  N_VDestroy(yBref);
+  N_VDestroy(yB1);
+  N_VDestroy(yB2);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
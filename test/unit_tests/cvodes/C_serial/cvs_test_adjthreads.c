@@ -0,0 +1,287 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for integrating several backward problems concurrently. Adjoints
+ * of the Lotka-Volterra problem for different final conditions, with backward
+ * quadratures, are computed one after another and concurrently with Hermite
+ * (interp 0) or polynomial (interp 1) interpolation. The results must be the
+ * same. Without OpenMP, the concurrent mode must be rejected.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvodes/cvodes.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(20.0)
+
+#define NSTEPS   20
+#define NB       4
+#define NTHREADS 3
+
+/* y1' = y1 - y1 y2, y2' = -y2 + y1 y2 */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+
+  yddata[0] = ydata[0] - ydata[0] * ydata[1];
+  yddata[1] = -ydata[1] + ydata[0] * ydata[1];
+
+  return 0;
+}
+
+/* yB' = -J^T yB */
+static int fB(sunrealtype t, N_Vector y, N_Vector yB, N_Vector yBdot,
+              void* user_dataB)
+{
+  sunrealtype* ydata   = N_VGetArrayPointer(y);
+  sunrealtype* yBdata  = N_VGetArrayPointer(yB);
+  sunrealtype* yBddata = N_VGetArrayPointer(yBdot);
+
+  yBddata[0] = -((ONE - ydata[1]) * yBdata[0] + ydata[1] * yBdata[1]);
+  yBddata[1] = -(-ydata[0] * yBdata[0] + (ydata[0] - ONE) * yBdata[1]);
+
+  return 0;
+}
+
+/* qB' = -(y1 yB1 - y2 yB2), the gradient with respect to a common scaling of
+   the linear terms */
+static int fQB(sunrealtype t, N_Vector y, N_Vector yB, N_Vector qBdot,
+               void* user_dataB)
+{
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yBdata = N_VGetArrayPointer(yB);
+
+  N_VGetArrayPointer(qBdot)[0] = -(ydata[0] * yBdata[0] - ydata[1] * yBdata[1]);
+
+  return 0;
+}
+
+/* Solve the forward problem and NB backward problems with nthreads threads,
+   the adjoints and quadratures at t = 0 are returned in yB and qB */
+static int run_adjoint(SUNContext sunctx, int interp, int nthreads,
+                       N_Vector* yB, N_Vector* qB)
+{
+  void* cvode_mem = NULL;
+  SUNMatrix A     = NULL;
+  SUNMatrix AB[NB];
+  SUNLinearSolver LS = NULL;
+  SUNLinearSolver LSB[NB];
+  N_Vector y;
+  sunrealtype tret;
+  sunrealtype w[NB][2] = {{ONE, ZERO},
+                          {ZERO, ONE},
+                          {ONE, ONE},
+                          {SUN_RCONST(2.0), -ONE}};
+  int flag, ncheck, which[NB], i;
+
+  y = N_VNew_Serial(2, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+  N_VGetArrayPointer(y)[1] = SUN_RCONST(0.5);
+
+  /* forward problem */
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetMaxNumSteps(cvode_mem, 5000);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(2, 2, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeAdjInit(cvode_mem, NSTEPS, interp ? CV_POLYNOMIAL : CV_HERMITE);
+  if (flag) { return 1; }
+
+  flag = CVodeSetAdjNumThreads(cvode_mem, nthreads);
+  if (flag) { return 1; }
+
+  flag = CVodeF(cvode_mem, TF, y, &tret, CV_NORMAL, &ncheck);
+  if (flag < 0) { return 1; }
+
+  /* backward problems, alternating between BDF and Adams methods */
+  for (i = 0; i < NB; i++)
+  {
+    flag = CVodeCreateB(cvode_mem, (i % 2) ? CV_ADAMS : CV_BDF, &which[i]);
+    if (flag) { return 1; }
+
+    N_VGetArrayPointer(yB[i])[0] = w[i][0];
+    N_VGetArrayPointer(yB[i])[1] = w[i][1];
+
+    flag = CVodeInitB(cvode_mem, which[i], fB, TF, yB[i]);
+    if (flag) { return 1; }
+
+    flag = CVodeSStolerancesB(cvode_mem, which[i], SUN_RCONST(1.0e-8),
+                              SUN_RCONST(1.0e-10));
+    if (flag) { return 1; }
+
+    /* use difference quotient Jacobians to evaluate fB through the wrappers */
+    AB[i]  = SUNDenseMatrix(2, 2, sunctx);
+    LSB[i] = SUNLinSol_Dense(yB[i], AB[i], sunctx);
+    if (!AB[i] || !LSB[i]) { return 1; }
+
+    flag = CVodeSetLinearSolverB(cvode_mem, which[i], LSB[i], AB[i]);
+    if (flag) { return 1; }
+
+    N_VConst(ZERO, qB[i]);
+
+    flag = CVodeQuadInitB(cvode_mem, which[i], fQB, qB[i]);
+    if (flag) { return 1; }
+
+    flag = CVodeQuadSStolerancesB(cvode_mem, which[i], SUN_RCONST(1.0e-8),
+                                  SUN_RCONST(1.0e-10));
+    if (flag) { return 1; }
+
+    flag = CVodeSetQuadErrConB(cvode_mem, which[i], SUNTRUE);
+    if (flag) { return 1; }
+  }
+
+  /* the number of threads cannot change after creating backward problems */
+  if (CVodeSetAdjNumThreads(cvode_mem, 1) != CV_ILL_INPUT)
+  {
+    printf("ERROR: number of threads changed after CVodeCreateB\n");
+    return 1;
+  }
+
+  /* stop halfway once to resume within an interval */
+  flag = CVodeB(cvode_mem, SUN_RCONST(7.3), CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeB(cvode_mem, ZERO, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  for (i = 0; i < NB; i++)
+  {
+    flag = CVodeGetB(cvode_mem, which[i], &tret, yB[i]);
+    if (flag) { return 1; }
+
+    flag = CVodeGetQuadB(cvode_mem, which[i], &tret, qB[i]);
+    if (flag) { return 1; }
+  }
+
+  CVodeFree(&cvode_mem);
+  for (i = 0; i < NB; i++)
+  {
+    SUNLinSolFree(LSB[i]);
+    SUNMatDestroy(AB[i]);
+  }
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int interp        = 0;
+  int i;
+  SUNContext sunctx = NULL;
+  N_Vector yB[NB], qB[NB], yBref[NB], qBref[NB];
+  sunrealtype diff;
+
+  if (argc > 1) { interp = atoi(argv[1]); }
+  printf("Concurrent backward problems with %s interpolation\n",
+         interp ? "polynomial" : "Hermite");
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  for (i = 0; i < NB; i++)
+  {
+    yB[i]    = N_VNew_Serial(2, sunctx);
+    yBref[i] = N_VNew_Serial(2, sunctx);
+    qB[i]    = N_VNew_Serial(1, sunctx);
+    qBref[i] = N_VNew_Serial(1, sunctx);
+    if (!yB[i] || !yBref[i] || !qB[i] || !qBref[i]) { return 1; }
+  }
+
+  /* backward problems one after another */
+  if (run_adjoint(sunctx, interp, 1, yBref, qBref)) { return 1; }
+  for (i = 0; i < NB; i++)
+  {
+    printf("problem %d: yB(0) = %" GSYM " %" GSYM ", qB(0) = %" GSYM "\n", i,
+           N_VGetArrayPointer(yBref[i])[0], N_VGetArrayPointer(yBref[i])[1],
+           N_VGetArrayPointer(qBref[i])[0]);
+  }
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* concurrent backward problems */
+  if (run_adjoint(sunctx, interp, NTHREADS, yB, qB)) { return 1; }
+
+  diff = ZERO;
+  for (i = 0; i < NB; i++)
+  {
+    N_VLinearSum(ONE, yB[i], -ONE, yBref[i], yB[i]);
+    N_VLinearSum(ONE, qB[i], -ONE, qBref[i], qB[i]);
+    diff = SUNMAX(diff, SUNMAX(N_VMaxNorm(yB[i]), N_VMaxNorm(qB[i])));
+  }
+  printf("difference to sequential integration %" GSYM "\n", diff);
+  if (diff > SUN_RCONST(1.0e-14))
+  {
+    printf("ERROR: difference %" GSYM "\n", diff);
+    fails++;
+  }
+#else
+  /* without OpenMP only one thread is allowed */
+  {
+    void* cvode_mem = CVodeCreate(CV_BDF, sunctx);
+    if (!cvode_mem) { return 1; }
+    if (CVodeInit(cvode_mem, f, ZERO, yB[0])) { return 1; }
+    if (CVodeAdjInit(cvode_mem, NSTEPS, CV_HERMITE)) { return 1; }
+    if (CVodeSetAdjNumThreads(cvode_mem, NTHREADS) != CV_ILL_INPUT)
+    {
+      printf("ERROR: concurrent backward problems accepted without OpenMP\n");
+      fails++;
+    }
+    CVodeFree(&cvode_mem);
+  }
+  (void)diff;
+#endif
+
+  for (i = 0; i < NB; i++)
+  {
+    N_VDestroy(yB[i]);
+    N_VDestroy(yBref[i]);
+    N_VDestroy(qB[i]);
+    N_VDestroy(qBref[i]);
+  }
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,359 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for solving the sensitivity systems with a block Krylov method.
+ * The forward sensitivities of a chain of decaying components with respect to
+ * the first decay rates are computed with the simultaneous (method 0) or
+ * staggered (method 1) corrector and preconditioned SPGMR, once solving the
+ * systems one at a time, once with block GMRES, and once with a block solve
+ * that always fails so the systems are solved one at a time after all. The
+ * results must agree, the block solves must start from zero initial guesses,
+ * and they must not cause more steps or nonlinear convergence failures.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvodes/cvodes.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_spgmr.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define C    SUN_RCONST(0.5)
+#define TF   SUN_RCONST(4.0)
+
+#define NEQ 60
+#define NS  4
+
+/* block solve modes */
+#define SOLVE_SINGLE   0
+#define SOLVE_BLOCK    1
+#define SOLVE_FALLBACK 2
+
+typedef struct
+{
+  sunrealtype p[NEQ];
+  sunrealtype d[NEQ]; /* inverse of the preconditioner diagonal */
+} UserData;
+
+typedef struct
+{
+  long int nst, ncfn, ncfnS, ncfl, nblock, nguess;
+} Stats;
+
+/* block solves of the SPGMR solver, replaced to count or fail them */
+static int (*spgmr_solvemulti)(SUNLinearSolver, SUNMatrix, int, N_Vector*,
+                               N_Vector*, sunrealtype);
+static int block_mode    = SOLVE_SINGLE;
+static long int n_blocks = 0;
+static long int n_guess  = 0;
+
+static int solvemulti(SUNLinearSolver S, SUNMatrix A, int nrhs, N_Vector* X,
+                      N_Vector* B, sunrealtype tol)
+{
+  int i;
+
+  /* the solves use a zero initial guess */
+  n_blocks++;
+  for (i = 0; i < nrhs; i++)
+  {
+    if (N_VMaxNorm(X[i]) != ZERO) { n_guess++; }
+  }
+
+  if (block_mode == SOLVE_FALLBACK) { return SUNLS_CONV_FAIL; }
+  return spgmr_solvemulti(S, A, nrhs, X, B, tol);
+}
+
+/* y_i' = -p_i y_i + c y_{i-1} */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* p      = ((UserData*)user_data)->p;
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  int i;
+
+  yddata[0] = -p[0] * ydata[0];
+  for (i = 1; i < NEQ; i++) { yddata[i] = -p[i] * ydata[i] + C * ydata[i - 1]; }
+
+  return 0;
+}
+
+/* s_is' = J s_is - y_is e_is */
+static int fS(int Ns, sunrealtype t, N_Vector y, N_Vector ydot, N_Vector* yS,
+              N_Vector* ySdot, void* user_data, N_Vector tmp1, N_Vector tmp2)
+{
+  sunrealtype* p     = ((UserData*)user_data)->p;
+  sunrealtype* ydata = N_VGetArrayPointer(y);
+  sunrealtype *sdata, *sddata;
+  int i, is;
+
+  for (is = 0; is < Ns; is++)
+  {
+    sdata  = N_VGetArrayPointer(yS[is]);
+    sddata = N_VGetArrayPointer(ySdot[is]);
+
+    sddata[0] = -p[0] * sdata[0];
+    for (i = 1; i < NEQ; i++)
+    {
+      sddata[i] = -p[i] * sdata[i] + C * sdata[i - 1];
+    }
+    sddata[is] -= ydata[is];
+  }
+
+  return 0;
+}
+
+/* Jacobi preconditioner, P = I - gamma diag(J) */
+static int psetup(sunrealtype t, N_Vector y, N_Vector fy, sunbooleantype jok,
+                  sunbooleantype* jcurPtr, sunrealtype gamma, void* user_data)
+{
+  UserData* data = (UserData*)user_data;
+  int i;
+
+  for (i = 0; i < NEQ; i++) { data->d[i] = ONE / (ONE + gamma * data->p[i]); }
+  *jcurPtr = SUNTRUE;
+
+  return 0;
+}
+
+static int psolve(sunrealtype t, N_Vector y, N_Vector fy, N_Vector r,
+                  N_Vector z, sunrealtype gamma, sunrealtype delta, int lr,
+                  void* user_data)
+{
+  UserData* data     = (UserData*)user_data;
+  sunrealtype* rdata = N_VGetArrayPointer(r);
+  sunrealtype* zdata = N_VGetArrayPointer(z);
+  int i;
+
+  for (i = 0; i < NEQ; i++) { zdata[i] = data->d[i] * rdata[i]; }
+
+  return 0;
+}
+
+/* Solve the problem and its sensitivities, the sensitivities at TF are
+   returned in yS */
+static int run_sens(SUNContext sunctx, int method, int mode, N_Vector* yS,
+                    Stats* stats)
+{
+  void* cvode_mem    = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y;
+  UserData data;
+  sunrealtype pbar[NS], tret;
+  int flag, i;
+
+  for (i = 0; i < NEQ; i++)
+  {
+    data.p[i] = ONE + SUN_RCONST(0.1) * i;
+    data.d[i] = ONE;
+  }
+  for (i = 0; i < NS; i++) { pbar[i] = data.p[i]; }
+
+  y = N_VNew_Serial(NEQ, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetUserData(cvode_mem, &data);
+  if (flag) { return 1; }
+
+  LS = SUNLinSol_SPGMR(y, SUN_PREC_LEFT, 0, sunctx);
+  if (!LS) { return 1; }
+
+  /* count the block solves or make them fail */
+  spgmr_solvemulti    = LS->ops->solvemulti;
+  LS->ops->solvemulti = solvemulti;
+  block_mode          = mode;
+  n_blocks            = 0;
+  n_guess             = 0;
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, NULL);
+  if (flag) { return 1; }
+
+  flag = CVodeSetPreconditioner(cvode_mem, psetup, psolve);
+  if (flag) { return 1; }
+
+  for (i = 0; i < NS; i++) { N_VConst(ZERO, yS[i]); }
+
+  flag = CVodeSensInit(cvode_mem, NS, method ? CV_STAGGERED : CV_SIMULTANEOUS,
+                       fS, yS);
+  if (flag) { return 1; }
+
+  flag = CVodeSensEEtolerances(cvode_mem);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensErrCon(cvode_mem, SUNTRUE);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensParams(cvode_mem, data.p, pbar, NULL);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensBlockKrylov(cvode_mem, mode != SOLVE_SINGLE);
+  if (flag) { return 1; }
+
+  flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetSens(cvode_mem, &tret, yS);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumSteps(cvode_mem, &stats->nst);
+  if (flag) { return 1; }
+
+  flag = CVodeGetNumNonlinSolvConvFails(cvode_mem, &stats->ncfn);
+  if (flag) { return 1; }
+
+  stats->ncfnS = 0;
+  if (method)
+  {
+    flag = CVodeGetSensNumNonlinSolvConvFails(cvode_mem, &stats->ncfnS);
+    if (flag) { return 1; }
+  }
+
+  flag = CVodeGetNumLinConvFails(cvode_mem, &stats->ncfl);
+  if (flag) { return 1; }
+
+  stats->nblock = n_blocks;
+  stats->nguess = n_guess;
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+/* Largest difference between the sensitivities relative to their size */
+static sunrealtype sens_diff(N_Vector* yS, N_Vector* ySref)
+{
+  sunrealtype diff = ZERO;
+  sunrealtype smax = ZERO;
+  int i;
+
+  for (i = 0; i < NS; i++)
+  {
+    smax = SUNMAX(smax, N_VMaxNorm(ySref[i]));
+    N_VLinearSum(ONE, yS[i], -ONE, ySref[i], yS[i]);
+    diff = SUNMAX(diff, N_VMaxNorm(yS[i]));
+  }
+
+  return diff / smax;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int method        = 0;
+  SUNContext sunctx = NULL;
+  N_Vector *yS, *ySref;
+  Stats stats, sref;
+  sunrealtype diff;
+
+  if (argc > 1) { method = atoi(argv[1]); }
+  printf("Block Krylov sensitivity solves with the %s corrector\n",
+         method ? "staggered" : "simultaneous");
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  {
+    N_Vector tmpl = N_VNew_Serial(NEQ, sunctx);
+    if (!tmpl) { return 1; }
+    yS    = N_VCloneVectorArray(NS, tmpl);
+    ySref = N_VCloneVectorArray(NS, tmpl);
+    N_VDestroy(tmpl);
+    if (!yS || !ySref) { return 1; }
+  }
+
+  /* one system at a time */
+  if (run_sens(sunctx, method, SOLVE_SINGLE, ySref, &sref)) { return 1; }
+  printf("single: nst = %ld, ncfn = %ld, ncfnS = %ld, ncfl = %ld\n", sref.nst,
+         sref.ncfn, sref.ncfnS, sref.ncfl);
+  if (sref.nblock)
+  {
+    printf("ERROR: %ld block solves without block Krylov\n", sref.nblock);
+    fails++;
+  }
+
+  /* block GMRES */
+  if (run_sens(sunctx, method, SOLVE_BLOCK, yS, &stats)) { return 1; }
+  diff = sens_diff(yS, ySref);
+  printf("block: nst = %ld, ncfn = %ld, ncfnS = %ld, ncfl = %ld, "
+         "block solves = %ld, difference = %" GSYM "\n",
+         stats.nst, stats.ncfn, stats.ncfnS, stats.ncfl, stats.nblock, diff);
+  if (stats.nblock == 0)
+  {
+    printf("ERROR: no block solves\n");
+    fails++;
+  }
+  if (stats.nguess)
+  {
+    printf("ERROR: %ld nonzero initial guesses\n", stats.nguess);
+    fails++;
+  }
+  if (diff > SUN_RCONST(1.0e-5))
+  {
+    printf("ERROR: difference %" GSYM "\n", diff);
+    fails++;
+  }
+  if (stats.ncfn > sref.ncfn || stats.ncfnS > sref.ncfnS)
+  {
+    printf("ERROR: more nonlinear convergence failures with block solves\n");
+    fails++;
+  }
+  if (stats.nst > sref.nst + sref.nst / 10)
+  {
+    printf("ERROR: more steps with block solves\n");
+    fails++;
+  }
+
+  /* failed block solves, the systems are solved one at a time */
+  if (run_sens(sunctx, method, SOLVE_FALLBACK, yS, &stats)) { return 1; }
+  diff = sens_diff(yS, ySref);
+  printf("fallback: nst = %ld, ncfn = %ld, ncfnS = %ld, ncfl = %ld, "
+         "block solves = %ld, difference = %" GSYM "\n",
+         stats.nst, stats.ncfn, stats.ncfnS, stats.ncfl, stats.nblock, diff);
+  if (stats.nblock == 0 || stats.ncfl < sref.ncfl + stats.nblock)
+  {
+    printf("ERROR: block solve failures not counted\n");
+    fails++;
+  }
+  if (diff > SUN_RCONST(1.0e-10) || stats.nst != sref.nst)
+  {
+    printf("ERROR: fallback differs from solving one system at a time\n");
+    fails++;
+  }
+
+  N_VDestroyVectorArray(yS, NS);
+  N_VDestroyVectorArray(ySref, NS);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,249 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for storing the sensitivities in contiguous blocks. The forward
+ * sensitivities of a chain of decaying components with respect to the decay
+ * rates are computed with the simultaneous (method 0) or staggered (method 1)
+ * corrector, once with separate sensitivity vectors and once with contiguous
+ * storage and fused vector operations. The sensitivity right-hand side checks
+ * that the sensitivities form one block and the results must agree.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvodes/cvodes.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define C    SUN_RCONST(0.5)
+#define TF   SUN_RCONST(4.0)
+
+#define NP 12
+
+typedef struct
+{
+  sunrealtype p[NP];
+  sunbooleantype contiguous; /* check the layout of yS in fS    */
+  int nbad;                  /* number of non-contiguous arrays */
+} UserData;
+
+/* y_i' = -p_i y_i + c y_{i-1} */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* p      = ((UserData*)user_data)->p;
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  int i;
+
+  yddata[0] = -p[0] * ydata[0];
+  for (i = 1; i < NP; i++) { yddata[i] = -p[i] * ydata[i] + C * ydata[i - 1]; }
+
+  return 0;
+}
+
+/* s_is' = J s_is - y_is e_is, with yS accessed as an NP x Ns block when the
+   sensitivities are contiguous */
+static int fS(int Ns, sunrealtype t, N_Vector y, N_Vector ydot, N_Vector* yS,
+              N_Vector* ySdot, void* user_data, N_Vector tmp1, N_Vector tmp2)
+{
+  UserData* data     = (UserData*)user_data;
+  sunrealtype* p     = data->p;
+  sunrealtype* ydata = N_VGetArrayPointer(y);
+  sunrealtype* sdata = N_VGetArrayPointer(yS[0]);
+  sunrealtype* sddata;
+  int i, is;
+
+  if (data->contiguous)
+  {
+    for (is = 1; is < Ns; is++)
+    {
+      if (N_VGetArrayPointer(yS[is]) != sdata + is * NP) { data->nbad++; }
+    }
+  }
+
+  for (is = 0; is < Ns; is++)
+  {
+    sdata  = N_VGetArrayPointer(yS[is]);
+    sddata = N_VGetArrayPointer(ySdot[is]);
+
+    sddata[0] = -p[0] * sdata[0];
+    for (i = 1; i < NP; i++)
+    {
+      sddata[i] = -p[i] * sdata[i] + C * sdata[i - 1];
+    }
+    sddata[is] -= ydata[is];
+  }
+
+  return 0;
+}
+
+/* Solve the problem and its sensitivities, the sensitivities at TF are
+   returned in yS */
+static int run_sens(SUNContext sunctx, int method, sunbooleantype contiguous,
+                    N_Vector* yS, int* nbad)
+{
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y;
+  UserData data;
+  sunrealtype pbar[NP], tret;
+  int flag, i;
+
+  for (i = 0; i < NP; i++)
+  {
+    data.p[i] = ONE + SUN_RCONST(0.1) * i;
+    pbar[i]   = data.p[i];
+  }
+  data.contiguous = contiguous;
+  data.nbad       = 0;
+
+  y = N_VNew_Serial(NP, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  /* the sensitivity vectors are cloned from y */
+  flag = N_VEnableFusedOps_Serial(y, contiguous);
+  if (flag) { return 1; }
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetUserData(cvode_mem, &data);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(NP, NP, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensContiguous(cvode_mem, contiguous);
+  if (flag) { return 1; }
+
+  for (i = 0; i < NP; i++) { N_VConst(ZERO, yS[i]); }
+
+  flag = CVodeSensInit(cvode_mem, NP, method ? CV_STAGGERED : CV_SIMULTANEOUS,
+                       fS, yS);
+  if (flag) { return 1; }
+
+  flag = CVodeSensEEtolerances(cvode_mem);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensErrCon(cvode_mem, SUNTRUE);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensParams(cvode_mem, data.p, pbar, NULL);
+  if (flag) { return 1; }
+
+  /* the storage cannot change after CVodeSensInit */
+  if (CVodeSetSensContiguous(cvode_mem, !contiguous) != CV_ILL_INPUT)
+  {
+    printf("ERROR: sensitivity storage changed after CVodeSensInit\n");
+    return 1;
+  }
+
+  flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetSens(cvode_mem, &tret, yS);
+  if (flag) { return 1; }
+
+  *nbad = data.nbad;
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int method        = 0;
+  int nbad          = 0;
+  int i;
+  SUNContext sunctx = NULL;
+  N_Vector *yS, *ySref;
+  sunrealtype diff;
+
+  if (argc > 1) { method = atoi(argv[1]); }
+  printf("Contiguous sensitivities with the %s corrector\n",
+         method ? "staggered" : "simultaneous");
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  {
+    N_Vector tmpl = N_VNew_Serial(NP, sunctx);
+    if (!tmpl) { return 1; }
+    yS    = N_VCloneVectorArray(NP, tmpl);
+    ySref = N_VCloneVectorArray(NP, tmpl);
+    N_VDestroy(tmpl);
+    if (!yS || !ySref) { return 1; }
+  }
+
+  /* separate sensitivity vectors */
+  if (run_sens(sunctx, method, SUNFALSE, ySref, &nbad)) { return 1; }
+  printf("s_0(TF) = %" GSYM ", s_%d(TF) = %" GSYM "\n",
+         N_VGetArrayPointer(ySref[0])[0], NP - 1,
+         N_VGetArrayPointer(ySref[NP - 1])[NP - 1]);
+
+  /* contiguous sensitivity vectors */
+  if (run_sens(sunctx, method, SUNTRUE, yS, &nbad)) { return 1; }
+  if (nbad)
+  {
+    printf("ERROR: %d non-contiguous sensitivity arrays\n", nbad);
+    fails++;
+  }
+
+  diff = ZERO;
+  for (i = 0; i < NP; i++)
+  {
+    N_VLinearSum(ONE, yS[i], -ONE, ySref[i], yS[i]);
+    diff = SUNMAX(diff, N_VMaxNorm(yS[i]));
+  }
+  printf("difference to separate vectors %" GSYM "\n", diff);
+  if (diff > SUN_RCONST(1.0e-12))
+  {
+    printf("ERROR: difference %" GSYM "\n", diff);
+    fails++;
+  }
+
+  N_VDestroyVectorArray(yS, NP);
+  N_VDestroyVectorArray(ySref, NP);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
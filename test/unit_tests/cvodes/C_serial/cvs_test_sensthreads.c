@@ -0,0 +1,270 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for evaluating the sensitivity right-hand sides with several
+ * threads. The forward sensitivities of a chain of decaying components with
+ * respect to the decay rates are computed with a user-supplied sensitivity
+ * right-hand side (method 0) or with the internal difference quotients using
+ * per-thread copies of the user data (method 1), once serially and once with
+ * threads. The results must be the same. Without OpenMP, threads must be
+ * rejected.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cvodes/cvodes.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define ONE  SUN_RCONST(1.0)
+#define C    SUN_RCONST(0.5)
+#define TF   SUN_RCONST(4.0)
+
+#define NP       12
+#define NTHREADS 3
+
+typedef struct
+{
+  sunrealtype p[NP];
+} UserData;
+
+/* y_i' = -p_i y_i + c y_{i-1} */
+static int f(sunrealtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  sunrealtype* p      = ((UserData*)user_data)->p;
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* yddata = N_VGetArrayPointer(ydot);
+  int i;
+
+  yddata[0] = -p[0] * ydata[0];
+  for (i = 1; i < NP; i++) { yddata[i] = -p[i] * ydata[i] + C * ydata[i - 1]; }
+
+  return 0;
+}
+
+/* s_i' = J s_i - y_is e_is */
+static int fS1(int Ns, sunrealtype t, N_Vector y, N_Vector ydot, int is,
+               N_Vector yS, N_Vector ySdot, void* user_data, N_Vector tmp1,
+               N_Vector tmp2)
+{
+  sunrealtype* p      = ((UserData*)user_data)->p;
+  sunrealtype* ydata  = N_VGetArrayPointer(y);
+  sunrealtype* sdata  = N_VGetArrayPointer(yS);
+  sunrealtype* sddata = N_VGetArrayPointer(ySdot);
+  int i;
+
+  sddata[0] = -p[0] * sdata[0];
+  for (i = 1; i < NP; i++) { sddata[i] = -p[i] * sdata[i] + C * sdata[i - 1]; }
+  sddata[is] -= ydata[is];
+
+  return 0;
+}
+
+/* Solve the problem and its sensitivities with nthreads threads, the
+   sensitivities at TF are returned in yS */
+static int run_sens(SUNContext sunctx, int method, int nthreads, N_Vector* yS,
+                    long int* nfeS)
+{
+  void* cvode_mem    = NULL;
+  SUNMatrix A        = NULL;
+  SUNLinearSolver LS = NULL;
+  N_Vector y;
+  UserData data, dataT[NTHREADS];
+  void* user_dataT[NTHREADS];
+  sunrealtype* pT[NTHREADS];
+  sunrealtype pbar[NP], tret;
+  int flag, i;
+
+  for (i = 0; i < NP; i++)
+  {
+    data.p[i] = ONE + SUN_RCONST(0.1) * i;
+    pbar[i]   = data.p[i];
+  }
+
+  y = N_VNew_Serial(NP, sunctx);
+  if (!y) { return 1; }
+  N_VConst(ONE, y);
+
+  cvode_mem = CVodeCreate(CV_BDF, sunctx);
+  if (!cvode_mem) { return 1; }
+
+  flag = CVodeInit(cvode_mem, f, ZERO, y);
+  if (flag) { return 1; }
+
+  flag = CVodeSStolerances(cvode_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = CVodeSetUserData(cvode_mem, &data);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(NP, NP, sunctx);
+  LS = SUNLinSol_Dense(y, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = CVodeSetLinearSolver(cvode_mem, LS, A);
+  if (flag) { return 1; }
+
+  for (i = 0; i < NP; i++) { N_VConst(ZERO, yS[i]); }
+
+  if (method == 0)
+  {
+    flag = CVodeSensInit1(cvode_mem, NP, CV_STAGGERED1, fS1, yS);
+  }
+  else { flag = CVodeSensInit(cvode_mem, NP, CV_SIMULTANEOUS, NULL, yS); }
+  if (flag) { return 1; }
+
+  flag = CVodeSensEEtolerances(cvode_mem);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensParams(cvode_mem, data.p, pbar, NULL);
+  if (flag) { return 1; }
+
+  flag = CVodeSetSensNumThreads(cvode_mem, nthreads);
+  if (flag) { return 1; }
+
+  if (method == 1 && nthreads > 1)
+  {
+    /* each thread perturbs its own copy of the parameters */
+    for (i = 0; i < nthreads; i++)
+    {
+      dataT[i]      = data;
+      user_dataT[i] = &dataT[i];
+      pT[i]         = dataT[i].p;
+    }
+
+    flag = CVodeSetSensDQThreadData(cvode_mem, user_dataT, pT);
+    if (flag) { return 1; }
+  }
+
+  flag = CVode(cvode_mem, TF, y, &tret, CV_NORMAL);
+  if (flag < 0) { return 1; }
+
+  flag = CVodeGetSens(cvode_mem, &tret, yS);
+  if (flag) { return 1; }
+
+  flag = CVodeGetSensNumRhsEvals(cvode_mem, nfeS);
+  if (flag) { return 1; }
+
+  CVodeFree(&cvode_mem);
+  SUNLinSolFree(LS);
+  SUNMatDestroy(A);
+  N_VDestroy(y);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int method        = 0;
+  int i;
+  long int nfeS     = 0;
+  long int nfeSref  = 0;
+  SUNContext sunctx = NULL;
+  N_Vector *yS, *ySref;
+  sunrealtype diff;
+
+  if (argc > 1) { method = atoi(argv[1]); }
+  printf("Threaded sensitivity right-hand sides with %s\n",
+         method ? "difference quotients" : "a user function");
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  {
+    N_Vector tmpl = N_VNew_Serial(NP, sunctx);
+    if (!tmpl) { return 1; }
+    yS    = N_VCloneVectorArray(NP, tmpl);
+    ySref = N_VCloneVectorArray(NP, tmpl);
+    N_VDestroy(tmpl);
+    if (!yS || !ySref) { return 1; }
+  }
+
+  /* serial sensitivity right-hand sides */
+  if (run_sens(sunctx, method, 1, ySref, &nfeSref)) { return 1; }
+  printf("s_0(TF) = %" GSYM ", s_%d(TF) = %" GSYM ", nfeS = %ld\n",
+         N_VGetArrayPointer(ySref[0])[0], NP - 1,
+         N_VGetArrayPointer(ySref[NP - 1])[NP - 1], nfeSref);
+
+#if defined(SUNDIALS_OPENMP_ENABLED)
+  /* threaded sensitivity right-hand sides */
+  if (run_sens(sunctx, method, NTHREADS, yS, &nfeS)) { return 1; }
+
+  diff = ZERO;
+  for (i = 0; i < NP; i++)
+  {
+    N_VLinearSum(ONE, yS[i], -ONE, ySref[i], yS[i]);
+    diff = SUNMAX(diff, N_VMaxNorm(yS[i]));
+  }
+  printf("difference to serial evaluation %" GSYM "\n", diff);
+  if (diff > SUN_RCONST(1.0e-14))
+  {
+    printf("ERROR: difference %" GSYM "\n", diff);
+    fails++;
+  }
+  if (nfeS != nfeSref)
+  {
+    printf("ERROR: %ld sensitivity evaluations instead of %ld\n", nfeS,
+           nfeSref);
+    fails++;
+  }
+#else
+  /* without OpenMP only one thread is allowed */
+  {
+    void* cvode_mem = CVodeCreate(CV_BDF, sunctx);
+    if (!cvode_mem) { return 1; }
+    if (CVodeInit(cvode_mem, f, ZERO, yS[0])) { return 1; }
+    if (CVodeSetSensNumThreads(cvode_mem, NTHREADS) != CV_ILL_INPUT)
+    {
+      printf("ERROR: threaded sensitivities accepted without OpenMP\n");
+      fails++;
+    }
+    CVodeFree(&cvode_mem);
+  }
+  (void)i;
+  (void)diff;
+  (void)nfeS;
+#endif
+
+  /* per-thread data requires threads */
+  {
+    void* data[1]   = {NULL};
+    sunrealtype* p[1];
+    void* cvode_mem = CVodeCreate(CV_BDF, sunctx);
+    if (!cvode_mem) { return 1; }
+    p[0] = NULL;
+    if (CVodeSetSensDQThreadData(cvode_mem, data, p) != CV_ILL_INPUT)
+    {
+      printf("ERROR: per-thread data accepted without threads\n");
+      fails++;
+    }
+    CVodeFree(&cvode_mem);
+  }
+
+  N_VDestroyVectorArray(yS, NP);
+  N_VDestroyVectorArray(ySref, NP);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
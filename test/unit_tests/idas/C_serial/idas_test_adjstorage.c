@@ -0,0 +1,291 @@
+/* -----------------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ * -----------------------------------------------------------------------------
+ * Unit test for the disk storage of adjoint data. The adjoint of a
+ * Lotka-Volterra DAE is computed with all data in memory and with the data
+ * written to a (compressed) storage file with a small cache, for both
+ * interpolation types. The adjoint solutions must be identical, also in a
+ * second backward sweep.
+ * ---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "idas/idas.h"
+#include "nvector/nvector_serial.h"
+#include "sundials/sundials_math.h"
+#include "sunlinsol/sunlinsol_dense.h"
+#include "sunmatrix/sunmatrix_dense.h"
+
+#if defined(SUNDIALS_EXTENDED_PRECISION)
+#define GSYM "Lg"
+#else
+#define GSYM "g"
+#endif
+
+#define ZERO SUN_RCONST(0.0)
+#define HALF SUN_RCONST(0.5)
+#define ONE  SUN_RCONST(1.0)
+#define TF   SUN_RCONST(20.0)
+
+#define NSTEPS 25
+#define NCACHE 6
+
+/* y1' = y1 - y1 y2, y2' = -y2 + y1 y2, 0 = y3 - y1 y2 */
+static int res(sunrealtype t, N_Vector yy, N_Vector yp, N_Vector rr,
+               void* user_data)
+{
+  sunrealtype* y  = N_VGetArrayPointer(yy);
+  sunrealtype* dy = N_VGetArrayPointer(yp);
+  sunrealtype* r  = N_VGetArrayPointer(rr);
+
+  r[0] = dy[0] - (y[0] - y[0] * y[1]);
+  r[1] = dy[1] - (-y[1] + y[0] * y[1]);
+  r[2] = y[2] - y[0] * y[1];
+
+  return 0;
+}
+
+/* Adjoint DAE: F_y^T yB - (F_y'^T yB)' = 0 */
+static int resB(sunrealtype t, N_Vector yy, N_Vector yp, N_Vector yyB,
+                N_Vector ypB, N_Vector rrB, void* user_dataB)
+{
+  sunrealtype* y  = N_VGetArrayPointer(yy);
+  sunrealtype* l  = N_VGetArrayPointer(yyB);
+  sunrealtype* dl = N_VGetArrayPointer(ypB);
+  sunrealtype* rB = N_VGetArrayPointer(rrB);
+
+  rB[0] = -dl[0] - (ONE - y[1]) * l[0] - y[1] * l[1] - y[1] * l[2];
+  rB[1] = -dl[1] + y[0] * l[0] - (y[0] - ONE) * l[1] - y[0] * l[2];
+  rB[2] = l[2];
+
+  return 0;
+}
+
+/* Solve the forward problem and two backward sweeps for the gradient of
+   y1(TF), with the data in memory (dir = NULL) or in a storage file, the
+   results of the two sweeps are returned in yB1 and yB2 */
+static int run_adjoint(SUNContext sunctx, int interp, const char* dir,
+                       N_Vector yB1, N_Vector yB2)
+{
+  void* ida_mem       = NULL;
+  SUNMatrix A         = NULL;
+  SUNMatrix AB        = NULL;
+  SUNLinearSolver LS  = NULL;
+  SUNLinearSolver LSB = NULL;
+  N_Vector yy, yp, yB, ypB;
+  sunrealtype tret, *y;
+  int flag, ncheck, which, sweep;
+
+  yy  = N_VNew_Serial(3, sunctx);
+  yp  = N_VNew_Serial(3, sunctx);
+  yB  = N_VNew_Serial(3, sunctx);
+  ypB = N_VNew_Serial(3, sunctx);
+  if (!yy || !yp || !yB || !ypB) { return 1; }
+
+  y    = N_VGetArrayPointer(yy);
+  y[0] = ONE;
+  y[1] = HALF;
+  y[2] = HALF;
+  N_VConst(ZERO, yp);
+  N_VGetArrayPointer(yp)[0] = HALF;
+  N_VGetArrayPointer(yp)[2] = SUN_RCONST(0.25);
+
+  /* forward problem */
+  ida_mem = IDACreate(sunctx);
+  if (!ida_mem) { return 1; }
+
+  flag = IDAInit(ida_mem, res, ZERO, yy, yp);
+  if (flag) { return 1; }
+
+  flag = IDASStolerances(ida_mem, SUN_RCONST(1.0e-8), SUN_RCONST(1.0e-10));
+  if (flag) { return 1; }
+
+  flag = IDASetMaxNumSteps(ida_mem, 5000);
+  if (flag) { return 1; }
+
+  A  = SUNDenseMatrix(3, 3, sunctx);
+  LS = SUNLinSol_Dense(yy, A, sunctx);
+  if (!A || !LS) { return 1; }
+
+  flag = IDASetLinearSolver(ida_mem, LS, A);
+  if (flag) { return 1; }
+
+  flag = IDAAdjInit(ida_mem, NSTEPS, interp);
+  if (flag) { return 1; }
+
+  if (dir != NULL)
+  {
+    flag = IDAAdjSetStorageDirectory(ida_mem, dir);
+    if (flag) { return 1; }
+
+    flag = IDAAdjSetStorageCompression(ida_mem, SUNTRUE);
+    if (flag) { return 1; }
+
+    flag = IDAAdjSetStorageCacheSize(ida_mem, NCACHE);
+    if (flag) { return 1; }
+  }
+
+  flag = IDASolveF(ida_mem, TF, &tret, yy, yp, IDA_NORMAL, &ncheck);
+  if (flag < 0) { return 1; }
+
+  printf("interp %d, %s: %d check points\n", interp,
+         dir ? "disk storage" : "in memory", ncheck);
+
+  /* storage options cannot be changed after the forward run */
+  if (IDAAdjSetStorageDirectory(ida_mem, dir) != IDA_ILL_INPUT)
+  {
+    printf("ERROR: storage directory changed after IDASolveF\n");
+    return 1;
+  }
+
+  /* backward problem */
+  flag = IDACreateB(ida_mem, &which);
+  if (flag) { return 1; }
+
+  AB  = SUNDenseMatrix(3, 3, sunctx);
+  LSB = SUNLinSol_Dense(yB, AB, sunctx);
+  if (!AB || !LSB) { return 1; }
+
+  for (sweep = 0; sweep < 2; sweep++)
+  {
+    /* final condition and consistent derivative */
+    N_VConst(ZERO, yB);
+    N_VGetArrayPointer(yB)[0] = ONE;
+    N_VConst(ZERO, ypB);
+    N_VGetArrayPointer(ypB)[0] = -(ONE - y[1]);
+    N_VGetArrayPointer(ypB)[1] = y[0];
+
+    if (sweep == 0)
+    {
+      flag = IDAInitB(ida_mem, which, resB, TF, yB, ypB);
+      if (flag) { return 1; }
+
+      flag = IDASStolerancesB(ida_mem, which, SUN_RCONST(1.0e-8),
+                              SUN_RCONST(1.0e-10));
+      if (flag) { return 1; }
+
+      flag = IDASetLinearSolverB(ida_mem, which, LSB, AB);
+      if (flag) { return 1; }
+    }
+    else
+    {
+      flag = IDAReInitB(ida_mem, which, TF, yB, ypB);
+      if (flag) { return 1; }
+    }
+
+    /* stop halfway once to resume within an interval */
+    flag = IDASolveB(ida_mem, SUN_RCONST(7.3), IDA_NORMAL);
+    if (flag < 0) { return 1; }
+
+    flag = IDASolveB(ida_mem, ZERO, IDA_NORMAL);
+    if (flag < 0) { return 1; }
+
+    flag = IDAGetB(ida_mem, which, &tret, (sweep == 0) ? yB1 : yB2, ypB);
+    if (flag) { return 1; }
+  }
+
+  IDAFree(&ida_mem);
+  SUNLinSolFree(LS);
+  SUNLinSolFree(LSB);
+  SUNMatDestroy(A);
+  SUNMatDestroy(AB);
+  N_VDestroy(yy);
+  N_VDestroy(yp);
+  N_VDestroy(yB);
+  N_VDestroy(ypB);
+
+  return 0;
+}
+
+/* Max difference between two vectors */
+static sunrealtype max_diff(N_Vector x, N_Vector y)
+{
+  sunrealtype* xdata = N_VGetArrayPointer(x);
+  sunrealtype* ydata = N_VGetArrayPointer(y);
+  sunrealtype diff   = ZERO;
+  int i;
+
+  for (i = 0; i < 3; i++)
+  {
+    diff = SUNMAX(diff, SUNRabs(xdata[i] - ydata[i]));
+  }
+
+  return diff;
+}
+
+int main(int argc, char* argv[])
+{
+  int fails         = 0;
+  int interp[2]     = {IDA_HERMITE, IDA_POLYNOMIAL};
+  int k;
+  SUNContext sunctx = NULL;
+  N_Vector yB1, yB2, yBref;
+  sunrealtype diff;
+
+  if (SUNContext_Create(SUN_COMM_NULL, &sunctx)) { return 1; }
+
+  yBref = N_VNew_Serial(3, sunctx);
+  yB1   = N_VNew_Serial(3, sunctx);
+  yB2   = N_VNew_Serial(3, sunctx);
+  if (!yBref || !yB1 || !yB2) { return 1; }
+
+  for (k = 0; k < 2; k++)
+  {
+    /* all data in memory */
+    if (run_adjoint(sunctx, interp[k], NULL, yBref, yB2)) { return 1; }
+    printf("yB(0) = %" GSYM " %" GSYM "\n", N_VGetArrayPointer(yBref)[0],
+           N_VGetArrayPointer(yBref)[1]);
+
+    /* disk storage */
+    if (run_adjoint(sunctx, interp[k], ".", yB1, yB2)) { return 1; }
+
+    diff = max_diff(yB1, yBref);
+    printf("difference to in memory data %" GSYM "\n", diff);
+    if (diff > ZERO)
+    {
+      printf("ERROR: difference %" GSYM "\n", diff);
+      fails++;
+    }
+
+    diff = max_diff(yB2, yBref);
+    printf("second sweep difference to in memory data %" GSYM "\n", diff);
+    if (diff > ZERO)
+    {
+      printf("ERROR: second sweep difference %" GSYM "\n", diff);
+      fails++;
+    }
+  }
+
+  /* a cache smaller than the polynomial interpolation needs is illegal */
+  {
+    void* ida_mem = IDACreate(sunctx);
+    if (!ida_mem) { return 1; }
+    if (IDAAdjInit(ida_mem, NSTEPS, IDA_POLYNOMIAL)) { return 1; }
+    if (IDAAdjSetStorageCacheSize(ida_mem, 3) != IDA_ILL_INPUT)
+    {
+      printf("ERROR: cache of three data points accepted\n");
+      fails++;
+    }
+    IDAFree(&ida_mem);
+  }
+
+  N_VDestroy(yBref);
+  N_VDestroy(yB1);
+  N_VDestroy(yB2);
+
+  if (fails) { printf("FAIL\n"); }
+  else { printf("SUCCESS\n"); }
+
+  SUNContext_Free(&sunctx);
+
+  return fails;
+}
@@ -0,0 +1,198 @@
+/*------------------------------------------------------------------
+ * SUNDIALS Copyright Start
+ * Copyright (c) 2002-2024, Lawrence Livermore National Security
+ * and Southern Methodist University.
+ * All rights reserved.
+ *
+ * See the top-level LICENSE and NOTICE files for details.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * SUNDIALS Copyright End
+ *-----------------------------------------------------------------*/
+
+#include <cstdint>
+#include <iostream>
+#include <sundials/sundials_core.hpp>
+#include <sunmemory/sunmemory_system.h>
+
+static int check(bool passed, const char* name)
+{
+  std::cout << "  " << name << "... " << (passed ? "PASSED" : "FAILED") << "\n";
+  return passed ? 0 : 1;
+}
+
+static void get_stats(SUNMemoryHelper helper, unsigned long& num_allocations,
+                      unsigned long& num_deallocations,
+                      unsigned long& num_hits, unsigned long& num_misses,
+                      size_t& bytes_cached)
+{
+  size_t bytes_allocated, bytes_high_watermark;
+  SUNMemoryHelper_GetAllocStats(helper, SUNMEMTYPE_HOST, &num_allocations,
+                                &num_deallocations, &bytes_allocated,
+                                &bytes_high_watermark);
+  SUNMemoryHelper_GetPoolStats_SysPool(helper, &num_hits, &num_misses,
+                                       &bytes_cached);
+}
+
+// Allocate and free the same workspaces several times, only the first round
+// should reach the system allocator
+static int test_reuse(SUNMemoryHelper helper)
+{
+  const size_t sizes[]       = {8, 100, 1000, 12345, 3 * 1024 * 1024};
+  const unsigned long nsizes = 5;
+  SUNMemory mem[5];
+
+  unsigned long num_allocations, num_deallocations, num_hits, num_misses;
+  unsigned long num_allocations0, num_deallocations0, num_hits0, num_misses0;
+  size_t bytes_cached;
+  get_stats(helper, num_allocations0, num_deallocations0, num_hits0,
+            num_misses0, bytes_cached);
+
+  for (int round = 0; round < 5; round++)
+  {
+    for (unsigned long i = 0; i < nsizes; i++)
+    {
+      if (SUNMemoryHelper_Alloc(helper, &mem[i], sizes[i], SUNMEMTYPE_HOST,
+                                nullptr))
+      {
+        return 1;
+      }
+      // write to the whole requested size
+      unsigned char* data = static_cast<unsigned char*>(mem[i]->ptr);
+      for (size_t j = 0; j < sizes[i]; j++) { data[j] = 1; }
+    }
+    for (unsigned long i = 0; i < nsizes; i++)
+    {
+      if (SUNMemoryHelper_Dealloc(helper, mem[i], nullptr)) { return 1; }
+    }
+  }
+
+  get_stats(helper, num_allocations, num_deallocations, num_hits, num_misses,
+            bytes_cached);
+
+  num_allocations -= num_allocations0;
+  num_deallocations -= num_deallocations0;
+  num_hits -= num_hits0;
+  num_misses -= num_misses0;
+
+  std::cout << "\tnum_allocations = " << num_allocations
+            << " num_deallocations = " << num_deallocations
+            << " num_hits = " << num_hits << " num_misses = " << num_misses
+            << " bytes_cached = " << bytes_cached << "\n";
+
+  return num_allocations != nsizes || num_deallocations != 0 ||
+         num_misses != nsizes || num_hits != 4 * nsizes || bytes_cached == 0;
+}
+
+// Sizes rounded to the same class share cached blocks
+static int test_size_class(SUNMemoryHelper helper)
+{
+  SUNMemory mem;
+  unsigned long num_allocations, num_deallocations, num_hits, num_misses;
+  size_t bytes_cached;
+
+  if (SUNMemoryHelper_Alloc(helper, &mem, 65, SUNMEMTYPE_HOST, nullptr))
+  {
+    return 1;
+  }
+  if (SUNMemoryHelper_Dealloc(helper, mem, nullptr)) { return 1; }
+
+  get_stats(helper, num_allocations, num_deallocations, num_hits, num_misses,
+            bytes_cached);
+  unsigned long hits_before = num_hits;
+
+  if (SUNMemoryHelper_Alloc(helper, &mem, 80, SUNMEMTYPE_HOST, nullptr))
+  {
+    return 1;
+  }
+  if (SUNMemoryHelper_Dealloc(helper, mem, nullptr)) { return 1; }
+
+  get_stats(helper, num_allocations, num_deallocations, num_hits, num_misses,
+            bytes_cached);
+
+  return num_hits != hits_before + 1;
+}
+
+// Blocks are aligned to the requested boundary
+static int test_alignment(SUNMemoryHelper helper, size_t alignment)
+{
+  if (SUNMemoryHelper_SetAlignment_SysPool(helper, alignment)) { return 1; }
+
+  int fails = 0;
+  for (size_t size = 1; size < 10000; size = 3 * size + 1)
+  {
+    SUNMemory mem;
+    if (SUNMemoryHelper_Alloc(helper, &mem, size, SUNMEMTYPE_HOST, nullptr))
+    {
+      return 1;
+    }
+    if (reinterpret_cast<std::uintptr_t>(mem->ptr) % alignment) { fails++; }
+    if (SUNMemoryHelper_Dealloc(helper, mem, nullptr)) { return 1; }
+  }
+
+  return fails;
+}
+
+// Blocks beyond the high-water limit are returned to the system
+static int test_limit(SUNMemoryHelper helper)
+{
+  SUNMemory mem[2];
+  unsigned long num_allocations, num_deallocations, num_hits, num_misses;
+  size_t bytes_cached;
+
+  if (SUNMemoryHelper_Trim_SysPool(helper)) { return 1; }
+  if (SUNMemoryHelper_SetMaxCachedBytes_SysPool(helper, 1024)) { return 1; }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (SUNMemoryHelper_Alloc(helper, &mem[i], 1024, SUNMEMTYPE_HOST, nullptr))
+    {
+      return 1;
+    }
+  }
+  for (int i = 0; i < 2; i++)
+  {
+    if (SUNMemoryHelper_Dealloc(helper, mem[i], nullptr)) { return 1; }
+  }
+
+  get_stats(helper, num_allocations, num_deallocations, num_hits, num_misses,
+            bytes_cached);
+
+  if (bytes_cached != 1024) { return 1; }
+
+  if (SUNMemoryHelper_SetMaxCachedBytes_SysPool(helper, 0)) { return 1; }
+
+  get_stats(helper, num_allocations, num_deallocations, num_hits, num_misses,
+            bytes_cached);
+
+  return bytes_cached != 0 || num_allocations != num_deallocations;
+}
+
+int main(int argc, char* argv[])
+{
+  sundials::Context sunctx;
+  int fails = 0;
+
+  std::cout << "Testing the SUNMemoryHelper_SysPool module... \n";
+
+  SUNMemoryHelper helper = SUNMemoryHelper_SysPool(sunctx);
+  if (check(helper != nullptr, "SUNMemoryHelper_SysPool")) { return 1; }
+
+  fails += check(!test_reuse(helper), "cached reuse");
+  fails += check(!test_size_class(helper), "size classes");
+  fails += check(!test_alignment(helper, 64), "64 byte alignment");
+  fails += check(!test_alignment(helper, 4096), "4096 byte alignment");
+  fails += check(!SUNMemoryHelper_SetHugePages_SysPool(helper, SUNTRUE),
+                 "huge pages");
+  fails += check(!test_reuse(helper), "cached reuse with huge pages");
+  fails += check(!test_limit(helper), "high-water limit");
+
+  SUNMemoryHelper helper2 = SUNMemoryHelper_Clone(helper);
+  fails += check(helper2 != nullptr, "SUNMemoryHelper_Clone");
+
+  fails += check(!SUNMemoryHelper_Destroy(helper) &&
+                   !SUNMemoryHelper_Destroy(helper2),
+                 "SUNMemoryHelper_Destroy");
+
+  return fails;
+}
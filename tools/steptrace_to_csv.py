@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# -----------------------------------------------------------------------------
+# SUNDIALS Copyright Start
+# Copyright (c) 2002-2024, Lawrence Livermore National Security
+# and Southern Methodist University.
+# All rights reserved.
+#
+# See the top-level LICENSE and NOTICE files for details.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+# SUNDIALS Copyright End
+# -----------------------------------------------------------------------------
+# Script to convert a binary step trace written by SUNStepTrace to CSV.
+# -----------------------------------------------------------------------------
+
+def main():
+
+    import argparse
+
+    from suntools import steptrace
+
+    parser = argparse.ArgumentParser(description='Convert a step trace to CSV')
+
+    parser.add_argument('tracefile', type=str,
+                        help='Binary step trace file')
+
+    parser.add_argument('csvfile', type=str, nargs='?', default=None,
+                        help='Output CSV file (default: tracefile.csv)')
+
+    # parse command line args
+    args = parser.parse_args()
+
+    csvfile = args.csvfile if args.csvfile else args.tracefile + '.csv'
+
+    records = steptrace.read_trace(args.tracefile)
+    steptrace.write_csv(records, csvfile)
+
+    print(f'Wrote {len(records)} records to {csvfile}')
+
+
+# run the main routine
+if __name__ == '__main__':
+    import sys
+    sys.exit(main())
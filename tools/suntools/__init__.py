@@ -4,5 +4,8 @@ This is a Python library of utilities SUNDIALS developer may find useful.
 Right now it consists of the following modules:
 
 - `logs`: this module has functions for parsing logs produced by `SUNLogger`.
+- `csv`: this module has functions for parsing SUNDIALS CSV output files.
+- `steptrace`: this module has functions for reading step traces written by
+  `SUNStepTrace`.
 
 """
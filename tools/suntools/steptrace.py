@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# -----------------------------------------------------------------------------
+# SUNDIALS Copyright Start
+# Copyright (c) 2002-2024, Lawrence Livermore National Security
+# and Southern Methodist University.
+# All rights reserved.
+#
+# See the top-level LICENSE and NOTICE files for details.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+# SUNDIALS Copyright End
+# -----------------------------------------------------------------------------
+# Functions to read binary step trace files written by SUNStepTrace
+# -----------------------------------------------------------------------------
+
+import struct
+
+# header: magic, version, record size, capacity, number of records, padding
+HEADER_FORMAT = '<8sIIqq32x'
+
+# record: t, h, step, solver, flag, order, netf, ncfn, nni, nli, nsetups,
+# njevals, reserved
+RECORD_FORMAT = '<ddq10i'
+
+FIELDS = ['t', 'h', 'step', 'solver', 'flag', 'order', 'netf', 'ncfn', 'nni',
+          'nli', 'nsetups', 'njevals']
+
+SOLVERS = ['ARKODE', 'CVODE', 'CVODES', 'IDA', 'IDAS', 'KINSOL']
+
+
+def read_header(fp):
+    """Reads and checks the header of a step trace file
+
+    Parameters
+    ----------
+    fp : file object
+        Binary file object positioned at the start of the trace file
+
+    Returns
+    -------
+    dict
+        The header entries: version, record_size, capacity, and nrecords
+    """
+
+    size = struct.calcsize(HEADER_FORMAT)
+    magic, version, record_size, capacity, nrecords = \
+        struct.unpack(HEADER_FORMAT, fp.read(size))
+
+    if magic != b'SUNTRACE':
+        raise ValueError('not a SUNDIALS step trace file')
+
+    if record_size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError(f'unsupported record size {record_size}')
+
+    return {'version': version, 'record_size': record_size,
+            'capacity': capacity, 'nrecords': nrecords}
+
+
+def read_trace(filename):
+    """Reads the records of a step trace file in the order they were written
+
+    Once the ring buffer has wrapped around only the last capacity records are
+    available in the file.
+
+    Parameters
+    ----------
+    filename : str
+        The file location of the step trace
+
+    Returns
+    -------
+    list
+        A list of dictionaries, one per record, with keys given by FIELDS
+    """
+
+    with open(filename, 'rb') as fp:
+        header = read_header(fp)
+        data = fp.read()
+
+    capacity = header['capacity']
+    nrecords = header['nrecords']
+    size = header['record_size']
+
+    # oldest record is at the start of the ring until it wraps around
+    nstored = min(nrecords, capacity)
+    first = nrecords % capacity if nrecords > capacity else 0
+
+    records = []
+    for i in range(nstored):
+        slot = (first + i) % capacity
+        values = struct.unpack_from(RECORD_FORMAT, data, slot * size)
+        records.append(dict(zip(FIELDS, values)))
+
+    return records
+
+
+def write_csv(records, filename):
+    """Writes step trace records to a CSV file
+
+    Parameters
+    ----------
+    records : list
+        List of records returned by read_trace
+    filename : str
+        The location of the CSV file to write
+    """
+
+    with open(filename, 'w') as fp:
+        fp.write(','.join(FIELDS) + '\n')
+        for rec in records:
+            row = dict(rec)
+            if 0 <= row['solver'] < len(SOLVERS):
+                row['solver'] = SOLVERS[row['solver']]
+            fp.write(','.join(str(row[key]) for key in FIELDS) + '\n')